@@ -11,28 +11,61 @@
  */
 
 #include "agx_monitor.h"
+#include "agx_monitor_binary.h"
+#include "agx_monitor_history.h"
+#include "agx_monitor_parser.h"
+#include "agx_monitor_reassembly.h"
+#include "agx_monitor_snapshot.h"
+#include "agx_monitor_subscribe.h"
 #include "config_manager.h"
 #include "console_core.h"
 #include "event_manager.h"
 
 #include "cJSON.h"
+#include "esp_eth.h"
 #include "esp_log.h"
+#include "esp_netif.h"
+#include "esp_random.h"
 #include "esp_timer.h"
 #include "esp_websocket_client.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
+#include "sdkconfig.h"
+#include <ctype.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#if CONFIG_AGX_MONITOR_PARSER_CJSON || CONFIG_AGX_MONITOR_PARSER_VALIDATE
+#define AGX_MONITOR_USE_CJSON 1
+#endif
+
 static const char *TAG = "agx_monitor";
 
+#define AGX_MONITOR_LINK_QUEUE_LENGTH (8)
+#define AGX_MONITOR_STABLE_CONNECTION_MS (30000) ///< Online time that resets
+                                                 ///< the reconnect backoff
+#define AGX_MONITOR_STOP_TIMEOUT_MS (3000)
+#define AGX_MONITOR_CLOSE_TIMEOUT_MS (1000)
+#define AGX_MONITOR_STATS_INTERVAL_MS (5000)
+#define AGX_MONITOR_TEMP_HANDOFF_DEADBAND (10)     ///< 0.1 °C
+#define AGX_MONITOR_TEMP_HANDOFF_REFRESH_MS (5000) ///< Console stale after 10 s
+
 /* ============================================================================
  * Internal State Management
  * ============================================================================
  */
 
+/**
+ * @brief Event for the monitor task
+ */
+typedef struct {
+  agx_link_event_t event; ///< Link event
+  uint32_t attempt;       ///< Connection the event belongs to (client events)
+} agx_link_message_t;
+
 /**
  * @brief Internal AGX monitor state structure
  */
@@ -44,14 +77,38 @@ typedef struct {
 
   // WebSocket client
   esp_websocket_client_handle_t ws_client; ///< WebSocket client handle
+  agx_monitor_reassembly_t reassembly;     ///< Fragmented message buffers
 
   // Data storage
-  agx_monitor_data_t latest_data; ///< Latest monitoring data
-  SemaphoreHandle_t data_mutex;   ///< Data access mutex
+  agx_monitor_snapshot_t snapshot; ///< Latest data, read without locking
+#if CONFIG_AGX_MONITOR_PARSER_VALIDATE
+  agx_monitor_data_t validate_buffer; ///< Same frame parsed with cJSON
+  uint32_t parser_mismatches;         ///< Frames where both parsers differ
+#endif
+  SemaphoreHandle_t data_mutex; ///< Serializes snapshot writers and stats
+
+  // History
+  agx_monitor_history_t history;   ///< 1 s, 1 min and 10 min metric history
+  SemaphoreHandle_t history_mutex; ///< Protects history, NULL if disabled
+
+  // Change-driven subscribers
+  agx_monitor_subscribers_t subscribers; ///< Subscriptions and last values
+  SemaphoreHandle_t subscribe_mutex;     ///< Serializes subscribers
+  uint32_t subscribe_parsed; ///< Parsed fields of the update being delivered
+  int temperature_handoff;   ///< Subscription feeding console_core
 
   // Task management
-  TaskHandle_t monitor_task_handle;   ///< Monitor task handle
-  TaskHandle_t reconnect_task_handle; ///< Reconnect task handle
+  TaskHandle_t monitor_task_handle; ///< Monitor task handle
+
+  // Connection state machine, owned by the monitor task
+  agx_monitor_link_t link;  ///< Link state and reconnect metrics
+  QueueHandle_t link_queue; ///< Events for the monitor task
+  uint32_t link_attempt;    ///< Tags client events with their connection
+
+  // Telemetry format of the current connection, owned by the WebSocket task
+  bool binary_active;      ///< Server agreed to send binary records
+  uint16_t binary_fields;  ///< Sections the server sends
+  uint32_t binary_records; ///< Updates received as binary records
 
   // Statistics and error tracking
   uint32_t total_reconnects;     ///< Total reconnection attempts
@@ -60,6 +117,7 @@ typedef struct {
   uint64_t last_message_time_us; ///< Last message timestamp
   uint64_t start_time_us;        ///< Component start time
   uint64_t connected_time_us;    ///< Total connected time
+  uint64_t connected_since_us;   ///< Entry into CONNECTED status
   char last_error[AGX_MONITOR_MAX_ERROR_MSG_LENGTH]; ///< Last error message
 
   // Event callback
@@ -83,7 +141,13 @@ static esp_err_t agx_monitor_disconnect(void);
 
 // Task functions
 static void agx_monitor_task(void *pvParameters);
-static void agx_monitor_reconnect_task(void *pvParameters);
+static void agx_monitor_post_link_event(agx_link_event_t event,
+                                        uint32_t attempt);
+static void agx_monitor_link_dispatch(agx_link_event_t event);
+static void agx_monitor_network_event_handler(void *handler_args,
+                                              esp_event_base_t base,
+                                              int32_t event_id,
+                                              void *event_data);
 
 // WebSocket event handlers
 static void agx_monitor_websocket_event_handler(void *handler_args,
@@ -92,7 +156,22 @@ static void agx_monitor_websocket_event_handler(void *handler_args,
                                                 void *event_data);
 
 // Data processing
-static esp_err_t agx_monitor_parse_data(const char *json_data, size_t data_len);
+static void agx_monitor_handle_message(agx_monitor_state_t *state,
+                                       const char *message, int message_len,
+                                       uint8_t opcode);
+static void agx_monitor_request_binary(agx_monitor_state_t *state);
+static void agx_monitor_update_received(agx_monitor_state_t *state,
+                                        esp_err_t parse_ret,
+                                        const char *message, int message_len);
+static esp_err_t agx_monitor_process_event(const char *frame, size_t len,
+                                           bool binary);
+static esp_err_t agx_monitor_parse_json(const char *frame, size_t len,
+                                        agx_monitor_data_t *parsed_data,
+                                        uint32_t *parsed_out);
+#ifdef AGX_MONITOR_USE_CJSON
+static esp_err_t agx_monitor_parse_frame_cjson(const char *frame, size_t len,
+                                               agx_monitor_data_t *data,
+                                               uint32_t *parsed);
 static esp_err_t agx_monitor_parse_cpu_data(cJSON *cpu_json,
                                             agx_monitor_data_t *data);
 static esp_err_t agx_monitor_parse_memory_data(cJSON *memory_json,
@@ -103,6 +182,7 @@ static esp_err_t agx_monitor_parse_power_data(cJSON *power_json,
                                               agx_monitor_data_t *data);
 static esp_err_t agx_monitor_parse_gpu_data(cJSON *gpu_json,
                                             agx_monitor_data_t *data);
+#endif
 
 // Utility functions
 static void agx_monitor_update_status(agx_monitor_status_t new_status);
@@ -110,6 +190,11 @@ static void agx_monitor_trigger_event(agx_monitor_event_type_t event_type,
                                       void *event_data);
 static void agx_monitor_update_statistics(void);
 static void agx_monitor_set_error(const char *error_msg);
+static void agx_monitor_history_start(void);
+static void agx_monitor_history_stop(void);
+static void agx_monitor_temperature_handoff(
+    const agx_monitor_notification_t *notification, void *user_data);
+static void agx_monitor_subscribe_carry(int32_t *values, uint32_t parsed);
 
 // Console command handlers
 static esp_err_t cmd_agx_status(int argc, char **argv);
@@ -118,6 +203,7 @@ static esp_err_t cmd_agx_stop(int argc, char **argv);
 static esp_err_t cmd_agx_data(int argc, char **argv);
 static esp_err_t cmd_agx_config(int argc, char **argv);
 static esp_err_t cmd_agx_stats(int argc, char **argv);
+static esp_err_t cmd_agx_history(int argc, char **argv);
 static esp_err_t cmd_agx_debug(int argc, char **argv);
 
 // Console command registration
@@ -142,11 +228,16 @@ esp_err_t agx_monitor_get_default_config(agx_monitor_config_t *config) {
           AGX_MONITOR_MAX_URL_LENGTH - 1);
   config->server_port = AGX_MONITOR_DEFAULT_SERVER_PORT;
   config->reconnect_interval_ms = AGX_MONITOR_DEFAULT_RECONNECT_INTERVAL_MS;
+  config->reconnect_max_interval_ms =
+      AGX_MONITOR_DEFAULT_RECONNECT_MAX_INTERVAL_MS;
+  config->reconnect_jitter_percent =
+      AGX_MONITOR_DEFAULT_RECONNECT_JITTER_PERCENT;
   config->fast_retry_count = AGX_MONITOR_DEFAULT_FAST_RETRY_COUNT;
   config->fast_retry_interval_ms = AGX_MONITOR_DEFAULT_FAST_RETRY_INTERVAL_MS;
   config->heartbeat_timeout_ms = AGX_MONITOR_DEFAULT_HEARTBEAT_TIMEOUT_MS;
   config->enable_ssl = false;
   config->auto_start = true;
+  config->binary_telemetry = AGX_MONITOR_DEFAULT_BINARY_TELEMETRY;
   config->startup_delay_ms = AGX_MONITOR_DEFAULT_STARTUP_DELAY_MS;
   config->task_stack_size = AGX_MONITOR_DEFAULT_TASK_STACK_SIZE;
   config->task_priority = AGX_MONITOR_DEFAULT_TASK_PRIORITY;
@@ -189,6 +280,12 @@ esp_err_t agx_monitor_init(const agx_monitor_config_t *config) {
     return ESP_ERR_INVALID_ARG;
   }
 
+  if (config->reconnect_jitter_percent > 100) {
+    ESP_LOGE(TAG, "Reconnect jitter too high: %d%% (maximum: 100%%)",
+             config->reconnect_jitter_percent);
+    return ESP_ERR_INVALID_ARG;
+  }
+
   ESP_LOGI(TAG, "Initializing AGX monitor v%s", AGX_MONITOR_VERSION);
 
   // Completely silence ESP-IDF WebSocket library logs to prevent console
@@ -210,9 +307,45 @@ esp_err_t agx_monitor_init(const agx_monitor_config_t *config) {
     return ESP_ERR_NO_MEM;
   }
 
+  // Create link event queue
+  s_agx_monitor.link_queue =
+      xQueueCreate(AGX_MONITOR_LINK_QUEUE_LENGTH, sizeof(agx_link_message_t));
+  if (s_agx_monitor.link_queue == NULL) {
+    ESP_LOGE(TAG, "Failed to create link event queue");
+    vSemaphoreDelete(s_agx_monitor.data_mutex);
+    s_agx_monitor.data_mutex = NULL;
+    return ESP_ERR_NO_MEM;
+  }
+
+  // Create subscriber mutex
+  s_agx_monitor.subscribe_mutex = xSemaphoreCreateMutex();
+  if (s_agx_monitor.subscribe_mutex == NULL) {
+    ESP_LOGE(TAG, "Failed to create subscriber mutex");
+    vSemaphoreDelete(s_agx_monitor.data_mutex);
+    s_agx_monitor.data_mutex = NULL;
+    vQueueDelete(s_agx_monitor.link_queue);
+    s_agx_monitor.link_queue = NULL;
+    return ESP_ERR_NO_MEM;
+  }
+
+  // CPU temperature for fan control goes to console_core only when it moves,
+  // refreshed often enough that the console does not treat it as stale
+  const agx_subscription_t temperature_handoff = {
+      .channels = AGX_SUBSCRIBE_CHANNEL(AGX_HISTORY_CH_TEMP_CPU),
+      .trigger = AGX_SUBSCRIBE_CHANGE,
+      .deadband = AGX_MONITOR_TEMP_HANDOFF_DEADBAND,
+      .max_interval_ms = AGX_MONITOR_TEMP_HANDOFF_REFRESH_MS,
+  };
+  agx_monitor_subscribers_init(&s_agx_monitor.subscribers);
+  agx_monitor_subscribers_add(&s_agx_monitor.subscribers, &temperature_handoff,
+                              agx_monitor_temperature_handoff, NULL,
+                              &s_agx_monitor.temperature_handoff);
+
   // Initialize data structure
-  memset(&s_agx_monitor.latest_data, 0, sizeof(agx_monitor_data_t));
-  s_agx_monitor.latest_data.is_valid = false;
+  agx_monitor_snapshot_init(&s_agx_monitor.snapshot);
+
+  // History is optional: the monitor runs without it if memory is short
+  agx_monitor_history_start();
 
   // Initialize status and timing
   s_agx_monitor.connection_status = AGX_MONITOR_STATUS_INITIALIZED;
@@ -229,7 +362,6 @@ esp_err_t agx_monitor_init(const agx_monitor_config_t *config) {
 
   // Initialize task handles to NULL
   s_agx_monitor.monitor_task_handle = NULL;
-  s_agx_monitor.reconnect_task_handle = NULL;
   s_agx_monitor.ws_client = NULL;
   s_agx_monitor.event_callback = NULL;
   s_agx_monitor.callback_user_data = NULL;
@@ -241,6 +373,11 @@ esp_err_t agx_monitor_init(const agx_monitor_config_t *config) {
              esp_err_to_name(ret));
     vSemaphoreDelete(s_agx_monitor.data_mutex);
     s_agx_monitor.data_mutex = NULL;
+    vQueueDelete(s_agx_monitor.link_queue);
+    s_agx_monitor.link_queue = NULL;
+    vSemaphoreDelete(s_agx_monitor.subscribe_mutex);
+    s_agx_monitor.subscribe_mutex = NULL;
+    agx_monitor_history_stop();
     return ret;
   }
 
@@ -315,6 +452,21 @@ esp_err_t agx_monitor_deinit(void) {
     s_agx_monitor.data_mutex = NULL;
   }
 
+  if (s_agx_monitor.link_queue) {
+    vQueueDelete(s_agx_monitor.link_queue);
+    s_agx_monitor.link_queue = NULL;
+  }
+
+  if (s_agx_monitor.subscribe_mutex) {
+    if (xSemaphoreTake(s_agx_monitor.subscribe_mutex, pdMS_TO_TICKS(1000))) {
+      xSemaphoreGive(s_agx_monitor.subscribe_mutex);
+    }
+    vSemaphoreDelete(s_agx_monitor.subscribe_mutex);
+    s_agx_monitor.subscribe_mutex = NULL;
+  }
+
+  agx_monitor_history_stop();
+
   // Unregister console commands
   agx_monitor_unregister_commands();
 
@@ -342,17 +494,43 @@ esp_err_t agx_monitor_start(void) {
 
   ESP_LOGD(TAG, "Starting AGX monitor");
 
-  // Update status to indicate we're starting
-  agx_monitor_update_status(AGX_MONITOR_STATUS_CONNECTING);
-
   // Reset runtime statistics
   s_agx_monitor.running = true;
   s_agx_monitor.start_time_us = esp_timer_get_time();
 
+  // Connection state machine, driven by the monitor task
+  const agx_link_config_t link_config = {
+      .startup_delay_ms = s_agx_monitor.config.startup_delay_ms,
+      .connect_timeout_ms = s_agx_monitor.config.heartbeat_timeout_ms,
+      .liveness_timeout_ms = s_agx_monitor.config.heartbeat_timeout_ms,
+      .fast_retry_count = s_agx_monitor.config.fast_retry_count,
+      .fast_retry_interval_ms = s_agx_monitor.config.fast_retry_interval_ms,
+      .backoff_initial_ms = s_agx_monitor.config.reconnect_interval_ms,
+      .backoff_max_ms = s_agx_monitor.config.reconnect_max_interval_ms,
+      .stable_ms = AGX_MONITOR_STABLE_CONNECTION_MS,
+      .jitter_percent = s_agx_monitor.config.reconnect_jitter_percent,
+  };
+  agx_monitor_link_init(&s_agx_monitor.link, &link_config, esp_random());
+  xQueueReset(s_agx_monitor.link_queue);
+
+  // Ethernet link and DHCP lease events cut any pending retry delay short.
+  // Without them the backoff timers alone still reconnect.
+  if (esp_event_handler_register(ETH_EVENT, ESP_EVENT_ANY_ID,
+                                 agx_monitor_network_event_handler,
+                                 NULL) != ESP_OK ||
+      esp_event_handler_register(IP_EVENT, IP_EVENT_AP_STAIPASSIGNED,
+                                 agx_monitor_network_event_handler,
+                                 NULL) != ESP_OK) {
+    ESP_LOGW(TAG, "Network events unavailable, relying on retry timers");
+  }
+
   // Invalidate any old data
   if (xSemaphoreTake(s_agx_monitor.data_mutex, pdMS_TO_TICKS(1000))) {
-    s_agx_monitor.latest_data.is_valid = false;
-    s_agx_monitor.latest_data.update_time_us = 0;
+    agx_monitor_data_t *data =
+        agx_monitor_snapshot_begin(&s_agx_monitor.snapshot, true);
+    data->is_valid = false;
+    data->update_time_us = 0;
+    agx_monitor_snapshot_publish(&s_agx_monitor.snapshot);
     xSemaphoreGive(s_agx_monitor.data_mutex);
   } else {
     ESP_LOGW(TAG, "Failed to acquire mutex during start");
@@ -367,14 +545,15 @@ esp_err_t agx_monitor_start(void) {
   if (ret != pdPASS) {
     ESP_LOGE(TAG, "Failed to create monitor task: %d", ret);
     s_agx_monitor.running = false;
+    esp_event_handler_unregister(ETH_EVENT, ESP_EVENT_ANY_ID,
+                                 agx_monitor_network_event_handler);
+    esp_event_handler_unregister(IP_EVENT, IP_EVENT_AP_STAIPASSIGNED,
+                                 agx_monitor_network_event_handler);
     agx_monitor_update_status(AGX_MONITOR_STATUS_ERROR);
     agx_monitor_set_error("Failed to create monitor task");
     return ESP_ERR_NO_MEM;
   }
 
-  // Trigger connected event
-  agx_monitor_trigger_event(AGX_MONITOR_EVENT_CONNECTED, NULL);
-
   ESP_LOGD(TAG, "AGX monitor started successfully");
   ESP_LOGD(TAG, "Monitor task created with stack size: %lu bytes",
            s_agx_monitor.config.task_stack_size);
@@ -395,54 +574,27 @@ esp_err_t agx_monitor_stop(void) {
 
   ESP_LOGD(TAG, "Stopping AGX monitor");
 
-  // Set running flag to false first to signal tasks to stop
-  s_agx_monitor.running = false;
+  esp_event_handler_unregister(ETH_EVENT, ESP_EVENT_ANY_ID,
+                               agx_monitor_network_event_handler);
+  esp_event_handler_unregister(IP_EVENT, IP_EVENT_AP_STAIPASSIGNED,
+                               agx_monitor_network_event_handler);
 
-  // Disconnect WebSocket to stop data reception
-  esp_err_t ret = agx_monitor_disconnect();
-  if (ret != ESP_OK) {
-    ESP_LOGW(TAG, "Error disconnecting WebSocket: %s", esp_err_to_name(ret));
+  // Let the monitor task stop the client and exit on its own
+  s_agx_monitor.running = false;
+  agx_monitor_post_link_event(AGX_LINK_EVENT_STOP, 0);
+  for (uint32_t waited = 0; s_agx_monitor.monitor_task_handle != NULL &&
+                            waited < AGX_MONITOR_STOP_TIMEOUT_MS;
+       waited += 10) {
+    vTaskDelay(pdMS_TO_TICKS(10));
   }
 
-  // Give tasks time to finish gracefully
-  vTaskDelay(pdMS_TO_TICKS(200));
-
-  // Clean up monitor task
   if (s_agx_monitor.monitor_task_handle) {
-    ESP_LOGD(TAG, "Deleting monitor task");
+    ESP_LOGW(TAG, "Monitor task did not exit, deleting it");
     vTaskDelete(s_agx_monitor.monitor_task_handle);
     s_agx_monitor.monitor_task_handle = NULL;
+    agx_monitor_link_dispatch(AGX_LINK_EVENT_STOP);
   }
 
-  // Clean up reconnect task if it exists
-  if (s_agx_monitor.reconnect_task_handle) {
-    ESP_LOGD(TAG, "Deleting reconnect task");
-    vTaskDelete(s_agx_monitor.reconnect_task_handle);
-    s_agx_monitor.reconnect_task_handle = NULL;
-  }
-
-  // Update connection status
-  agx_monitor_update_status(AGX_MONITOR_STATUS_INITIALIZED);
-
-  // Invalidate data and update statistics
-  if (xSemaphoreTake(s_agx_monitor.data_mutex, pdMS_TO_TICKS(1000))) {
-    s_agx_monitor.latest_data.is_valid = false;
-
-    // Update connected time statistics
-    uint64_t current_time = esp_timer_get_time();
-    if (s_agx_monitor.connection_status == AGX_MONITOR_STATUS_CONNECTED) {
-      s_agx_monitor.connected_time_us +=
-          (current_time - s_agx_monitor.start_time_us);
-    }
-
-    xSemaphoreGive(s_agx_monitor.data_mutex);
-  } else {
-    ESP_LOGW(TAG, "Failed to acquire mutex during stop");
-  }
-
-  // Trigger disconnected event
-  agx_monitor_trigger_event(AGX_MONITOR_EVENT_DISCONNECTED, NULL);
-
   ESP_LOGD(TAG, "AGX monitor stopped successfully");
   ESP_LOGI(
       TAG,
@@ -474,11 +626,24 @@ esp_err_t agx_monitor_get_status(agx_monitor_status_info_t *status) {
     status->total_reconnects = s_agx_monitor.total_reconnects;
     status->messages_received = s_agx_monitor.messages_received;
     status->parse_errors = s_agx_monitor.parse_errors;
+    status->frames_reassembled = s_agx_monitor.reassembly.frames_reassembled;
+    status->frames_oversized = s_agx_monitor.reassembly.frames_oversized;
+    status->frames_dropped = s_agx_monitor.reassembly.frames_dropped;
+    status->binary_telemetry = s_agx_monitor.binary_active;
+    status->binary_records = s_agx_monitor.binary_records;
     status->last_message_time_us = s_agx_monitor.last_message_time_us;
 
     uint64_t current_time = esp_timer_get_time();
     status->uptime_ms = (current_time - s_agx_monitor.start_time_us) / 1000;
     status->connected_time_ms = s_agx_monitor.connected_time_us / 1000;
+    if (s_agx_monitor.connection_status == AGX_MONITOR_STATUS_CONNECTED) {
+      status->connected_time_ms +=
+          (current_time - s_agx_monitor.connected_since_us) / 1000;
+    }
+
+    // Written by the monitor task only; counters may be one event apart
+    status->link_state = s_agx_monitor.link.state;
+    status->link = s_agx_monitor.link.stats;
 
     // Calculate connection reliability
     if (status->uptime_ms > 0) {
@@ -509,41 +674,35 @@ esp_err_t agx_monitor_get_latest_data(agx_monitor_data_t *data) {
     return ESP_ERR_INVALID_ARG;
   }
 
-  // Take mutex and copy data
-  if (xSemaphoreTake(s_agx_monitor.data_mutex, pdMS_TO_TICKS(1000))) {
-    memcpy(data, &s_agx_monitor.latest_data, sizeof(agx_monitor_data_t));
-    xSemaphoreGive(s_agx_monitor.data_mutex);
-  } else {
-    ESP_LOGW(TAG, "Failed to acquire mutex for data access");
-    return ESP_ERR_TIMEOUT;
-  }
-
+  // Lock-free copy, never waits for the WebSocket task
+  agx_monitor_snapshot_read(&s_agx_monitor.snapshot, data);
   return ESP_OK;
 }
 
+uint32_t agx_monitor_get_data_generation(void) {
+  if (!s_agx_monitor.initialized) {
+    return 0;
+  }
+  return agx_monitor_snapshot_generation(&s_agx_monitor.snapshot);
+}
+
 bool agx_monitor_is_data_valid(void) {
   if (!s_agx_monitor.initialized) {
     return false;
   }
 
-  bool is_valid = false;
-  if (xSemaphoreTake(s_agx_monitor.data_mutex, pdMS_TO_TICKS(100))) {
-    is_valid = s_agx_monitor.latest_data.is_valid;
+  agx_monitor_data_t data;
+  agx_monitor_snapshot_read(&s_agx_monitor.snapshot, &data);
+  bool is_valid = data.is_valid;
 
-    // Check if data is recent (within last 30 seconds)
-    if (is_valid) {
-      uint64_t current_time = esp_timer_get_time();
-      uint64_t data_age =
-          current_time - s_agx_monitor.latest_data.update_time_us;
-      if (data_age > 30000000) { // 30 seconds in microseconds
-        ESP_LOGD(TAG, "Data expired: age=%llu us", data_age);
-        is_valid = false;
-      }
+  // Check if data is recent (within last 30 seconds)
+  if (is_valid) {
+    uint64_t current_time = esp_timer_get_time();
+    uint64_t data_age = current_time - data.update_time_us;
+    if (data_age > 30000000) { // 30 seconds in microseconds
+      ESP_LOGD(TAG, "Data expired: age=%llu us", data_age);
+      is_valid = false;
     }
-
-    xSemaphoreGive(s_agx_monitor.data_mutex);
-  } else {
-    ESP_LOGD(TAG, "Failed to acquire mutex for data validity check");
   }
 
   return is_valid;
@@ -554,13 +713,9 @@ uint64_t agx_monitor_get_last_update_time(void) {
     return 0;
   }
 
-  uint64_t update_time = 0;
-  if (xSemaphoreTake(s_agx_monitor.data_mutex, pdMS_TO_TICKS(100))) {
-    update_time = s_agx_monitor.latest_data.update_time_us;
-    xSemaphoreGive(s_agx_monitor.data_mutex);
-  }
-
-  return update_time;
+  agx_monitor_data_t data;
+  agx_monitor_snapshot_read(&s_agx_monitor.snapshot, &data);
+  return data.update_time_us;
 }
 
 esp_err_t agx_monitor_register_callback(agx_monitor_event_callback_t callback,
@@ -592,6 +747,83 @@ esp_err_t agx_monitor_unregister_callback(void) {
   return ESP_OK;
 }
 
+size_t agx_monitor_get_history(agx_history_tier_t tier,
+                               agx_history_channel_t channel, uint32_t since,
+                               agx_history_point_t *points, size_t max_points) {
+  size_t count = 0;
+
+  if (s_agx_monitor.history_mutex != NULL &&
+      xSemaphoreTake(s_agx_monitor.history_mutex, pdMS_TO_TICKS(1000))) {
+    count = agx_monitor_history_query(&s_agx_monitor.history, tier, channel,
+                                      since, points, max_points);
+    xSemaphoreGive(s_agx_monitor.history_mutex);
+  }
+  return count;
+}
+
+esp_err_t agx_monitor_get_history_stats(agx_history_tier_t tier,
+                                        agx_history_tier_stats_t *stats) {
+  if (s_agx_monitor.history_mutex == NULL) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!xSemaphoreTake(s_agx_monitor.history_mutex, pdMS_TO_TICKS(1000))) {
+    return ESP_ERR_TIMEOUT;
+  }
+  agx_monitor_history_get_stats(&s_agx_monitor.history, tier, stats);
+  xSemaphoreGive(s_agx_monitor.history_mutex);
+  return ESP_OK;
+}
+
+esp_err_t agx_monitor_save_history(const char *path) {
+  if (s_agx_monitor.history_mutex == NULL) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!xSemaphoreTake(s_agx_monitor.history_mutex, pdMS_TO_TICKS(1000))) {
+    return ESP_ERR_TIMEOUT;
+  }
+  esp_err_t ret =
+      agx_monitor_history_save(&s_agx_monitor.history, path,
+                               (uint32_t)(esp_timer_get_time() / 1000000));
+  xSemaphoreGive(s_agx_monitor.history_mutex);
+  return ret;
+}
+
+esp_err_t agx_monitor_subscribe(const agx_subscription_t *sub,
+                                agx_monitor_subscriber_t callback,
+                                void *user_data, int *handle) {
+  if (!s_agx_monitor.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (!xSemaphoreTake(s_agx_monitor.subscribe_mutex, pdMS_TO_TICKS(1000))) {
+    return ESP_ERR_TIMEOUT;
+  }
+  esp_err_t ret = agx_monitor_subscribers_add(&s_agx_monitor.subscribers, sub,
+                                              callback, user_data, handle);
+  xSemaphoreGive(s_agx_monitor.subscribe_mutex);
+
+  if (ret == ESP_OK) {
+    ESP_LOGI(TAG, "Subscriber %d added (channels 0x%08lx)", *handle,
+             sub->channels);
+  }
+  return ret;
+}
+
+esp_err_t agx_monitor_unsubscribe(int handle) {
+  if (!s_agx_monitor.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (handle == s_agx_monitor.temperature_handoff) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  if (!xSemaphoreTake(s_agx_monitor.subscribe_mutex, pdMS_TO_TICKS(1000))) {
+    return ESP_ERR_TIMEOUT;
+  }
+  esp_err_t ret =
+      agx_monitor_subscribers_remove(&s_agx_monitor.subscribers, handle);
+  xSemaphoreGive(s_agx_monitor.subscribe_mutex);
+  return ret;
+}
+
 /* ============================================================================
  * Private Function Stubs (To be implemented in subsequent phases)
  * ============================================================================
@@ -615,6 +847,16 @@ static esp_err_t agx_monitor_websocket_init(void) {
 
   ESP_LOGI(TAG, "WebSocket URL: %s", ws_url);
 
+  // Reassembly buffers are allocated once here, never per message
+  esp_err_t ret = agx_monitor_reassembly_init(
+      &s_agx_monitor.reassembly, CONFIG_AGX_MONITOR_MESSAGE_BUFFER_SIZE,
+      CONFIG_AGX_MONITOR_MESSAGE_BUFFERS);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to allocate message buffers: %s",
+             esp_err_to_name(ret));
+    return ret;
+  }
+
   // Configure WebSocket client
   esp_websocket_client_config_t ws_config = {
       .uri = ws_url,
@@ -625,7 +867,7 @@ static esp_err_t agx_monitor_websocket_init(void) {
       .ping_interval_sec =
           0, // Disable WebSocket ping (Socket.IO handles heartbeat)
       .pingpong_timeout_sec = 0,   // Disable WebSocket ping timeout
-      .network_timeout_ms = 30000, // 30 second network timeout
+      .network_timeout_ms = s_agx_monitor.config.heartbeat_timeout_ms,
       .user_agent = "ESP32-robOS-AGX-Monitor/1.0",
       .headers = NULL,
       .cert_pem = NULL, // TODO: Add SSL certificate if needed
@@ -636,19 +878,21 @@ static esp_err_t agx_monitor_websocket_init(void) {
       .keep_alive_idle = 0,
       .keep_alive_interval = 0,
       .keep_alive_count = 0,
-      .reconnect_timeout_ms =
-          0, // Disable automatic reconnection (we handle it manually)
+      .reconnect_timeout_ms = 0,
+      // Reconnection is driven by the link state machine
+      .disable_auto_reconnect = true,
       .if_name = NULL};
 
   // Create WebSocket client
   s_agx_monitor.ws_client = esp_websocket_client_init(&ws_config);
   if (s_agx_monitor.ws_client == NULL) {
     ESP_LOGE(TAG, "Failed to create WebSocket client");
+    agx_monitor_reassembly_deinit(&s_agx_monitor.reassembly);
     return ESP_ERR_NO_MEM;
   }
 
   // Register event handler
-  esp_err_t ret = esp_websocket_register_events(
+  ret = esp_websocket_register_events(
       s_agx_monitor.ws_client, WEBSOCKET_EVENT_ANY,
       agx_monitor_websocket_event_handler, &s_agx_monitor);
   if (ret != ESP_OK) {
@@ -656,12 +900,16 @@ static esp_err_t agx_monitor_websocket_init(void) {
              esp_err_to_name(ret));
     esp_websocket_client_destroy(s_agx_monitor.ws_client);
     s_agx_monitor.ws_client = NULL;
+    agx_monitor_reassembly_deinit(&s_agx_monitor.reassembly);
     return ret;
   }
 
   ESP_LOGI(TAG, "WebSocket client initialized successfully");
   ESP_LOGI(TAG, "Buffer size: 4096 bytes, Ping interval: 10s, Timeout: %lu ms",
            s_agx_monitor.config.heartbeat_timeout_ms);
+  ESP_LOGI(TAG, "Message buffers: %d x %d bytes",
+           CONFIG_AGX_MONITOR_MESSAGE_BUFFERS,
+           CONFIG_AGX_MONITOR_MESSAGE_BUFFER_SIZE);
 
   return ESP_OK;
 }
@@ -691,6 +939,7 @@ static esp_err_t agx_monitor_websocket_deinit(void) {
   }
 
   s_agx_monitor.ws_client = NULL;
+  agx_monitor_reassembly_deinit(&s_agx_monitor.reassembly);
 
   ESP_LOGI(TAG, "WebSocket client deinitialized");
   return ESP_OK;
@@ -704,14 +953,10 @@ static esp_err_t agx_monitor_connect(void) {
     return ESP_ERR_INVALID_STATE;
   }
 
-  // Update status to connecting
-  agx_monitor_update_status(AGX_MONITOR_STATUS_CONNECTING);
-
   // Start WebSocket client
   esp_err_t ret = esp_websocket_client_start(s_agx_monitor.ws_client);
   if (ret != ESP_OK) {
     ESP_LOGE(TAG, "Failed to start WebSocket client: %s", esp_err_to_name(ret));
-    agx_monitor_update_status(AGX_MONITOR_STATUS_ERROR);
     agx_monitor_set_error("WebSocket start failed");
     return ret;
   }
@@ -736,8 +981,8 @@ static esp_err_t agx_monitor_disconnect(void) {
     ESP_LOGD(TAG, "Closing WebSocket connection");
 
     // Send close frame
-    esp_err_t ret =
-        esp_websocket_client_close(s_agx_monitor.ws_client, portMAX_DELAY);
+    esp_err_t ret = esp_websocket_client_close(
+        s_agx_monitor.ws_client, pdMS_TO_TICKS(AGX_MONITOR_CLOSE_TIMEOUT_MS));
     if (ret != ESP_OK) {
       ESP_LOGW(TAG, "Error sending close frame: %s", esp_err_to_name(ret));
     }
@@ -749,9 +994,6 @@ static esp_err_t agx_monitor_disconnect(void) {
     ESP_LOGW(TAG, "Error stopping WebSocket client: %s", esp_err_to_name(ret));
   }
 
-  // Update status
-  agx_monitor_update_status(AGX_MONITOR_STATUS_DISCONNECTED);
-
   ESP_LOGD(TAG, "WebSocket disconnected");
   return ESP_OK;
 }
@@ -761,147 +1003,43 @@ static void agx_monitor_task(void *pvParameters) {
            s_agx_monitor.config.task_stack_size,
            s_agx_monitor.config.task_priority);
 
-  uint32_t loop_count = 0;
-  uint32_t connection_check_counter = 0;
-  bool connection_attempted = false;
-  bool startup_delay_completed = false;
-  uint64_t task_start_time = esp_timer_get_time();
-
-  // Apply startup delay if configured
   if (s_agx_monitor.config.startup_delay_ms > 0) {
-    ESP_LOGD(TAG, "Waiting %lu ms for AGX system to boot up...",
+    ESP_LOGD(TAG, "Waiting up to %lu ms for AGX system to boot up...",
              s_agx_monitor.config.startup_delay_ms);
   }
 
+  uint64_t stats_time_us = esp_timer_get_time();
+  agx_monitor_link_dispatch(AGX_LINK_EVENT_START);
+
+  // Sleep until the next link event or state machine deadline; nothing is
+  // polled while the connection is healthy
   while (s_agx_monitor.running) {
-    loop_count++;
-    connection_check_counter++;
-
-    // Check if startup delay period has passed
-    if (!startup_delay_completed && s_agx_monitor.config.startup_delay_ms > 0) {
-      uint64_t elapsed_ms = (esp_timer_get_time() - task_start_time) / 1000;
-      if (elapsed_ms < s_agx_monitor.config.startup_delay_ms) {
-        // Still in startup delay period, wait and continue
-        vTaskDelay(pdMS_TO_TICKS(5000)); // Check every 5 seconds
-        continue;
-      } else {
-        startup_delay_completed = true;
-        ESP_LOGD(TAG, "AGX startup delay completed, ready to connect");
-      }
+    uint32_t timeout_ms = agx_monitor_link_timeout(
+        &s_agx_monitor.link, esp_timer_get_time() / 1000);
+    TickType_t ticks = timeout_ms == AGX_LINK_NO_TIMEOUT
+                           ? portMAX_DELAY
+                           : pdMS_TO_TICKS(timeout_ms) + 1;
+    agx_link_message_t message;
+
+    if (xQueueReceive(s_agx_monitor.link_queue, &message, ticks) != pdTRUE) {
+      agx_monitor_link_dispatch(AGX_LINK_EVENT_TIMER);
+    } else if (message.attempt != 0 &&
+               message.attempt != s_agx_monitor.link_attempt) {
+      ESP_LOGD(TAG, "Ignoring %s from connection #%lu",
+               agx_monitor_link_event_name(message.event), message.attempt);
     } else {
-      startup_delay_completed = true; // No delay configured
+      agx_monitor_link_dispatch(message.event);
     }
 
-    // Try to establish connection if not connected
-    if (!connection_attempted ||
-        (s_agx_monitor.connection_status == AGX_MONITOR_STATUS_DISCONNECTED ||
-         s_agx_monitor.connection_status == AGX_MONITOR_STATUS_ERROR)) {
-
-      if (!connection_attempted) {
-        ESP_LOGD(TAG, "Attempting initial connection to AGX server");
-      } else {
-        ESP_LOGD(TAG, "Attempting to reconnect to AGX server (attempt #%lu)",
-                 s_agx_monitor.total_reconnects + 1);
-        s_agx_monitor.total_reconnects++;
-        agx_monitor_trigger_event(AGX_MONITOR_EVENT_RECONNECTING, NULL);
-      }
-
-      esp_err_t ret = agx_monitor_connect();
-      if (ret != ESP_OK) {
-        ESP_LOGD(TAG, "Connection attempt failed: %s", esp_err_to_name(ret));
-        agx_monitor_set_error("Connection failed");
-
-        // Wait before next attempt - use fast retry initially, then fixed
-        // interval
-        uint32_t delay_ms;
-        if (s_agx_monitor.total_reconnects <
-            s_agx_monitor.config.fast_retry_count) {
-          delay_ms = s_agx_monitor.config.fast_retry_interval_ms;
-          ESP_LOGD(TAG, "Fast retry mode: waiting %lu ms", delay_ms);
-        } else {
-          delay_ms = s_agx_monitor.config.reconnect_interval_ms;
-          ESP_LOGD(TAG, "Fixed interval mode: waiting %lu ms", delay_ms);
-        }
-
-        vTaskDelay(pdMS_TO_TICKS(delay_ms));
-      } else {
-        connection_attempted = true;
-        ESP_LOGD(TAG, "Connection attempt initiated successfully");
-      }
-    }
-
-    // Update statistics periodically
-    if (connection_check_counter % 12 == 0) { // Every 60 seconds (12 * 5s)
+    uint64_t now_us = esp_timer_get_time();
+    if (now_us - stats_time_us >= AGX_MONITOR_STATS_INTERVAL_MS * 1000ULL) {
+      stats_time_us = now_us;
       agx_monitor_update_statistics();
     }
-
-    // Connection health check every 6 loops (30 seconds)
-    if (loop_count % 6 == 0) {
-      const char *status_names[] = {
-          "UNINITIALIZED", "INITIALIZED",  "CONNECTING", "CONNECTED",
-          "DISCONNECTED",  "RECONNECTING", "ERROR"};
-      const char *status_name =
-          (s_agx_monitor.connection_status < 7)
-              ? status_names[s_agx_monitor.connection_status]
-              : "UNKNOWN";
-
-      ESP_LOGD(
-          TAG,
-          "Health check - Loop: %lu, Status: %s, Messages: %lu, Errors: %lu",
-          loop_count, status_name, s_agx_monitor.messages_received,
-          s_agx_monitor.parse_errors);
-
-      // Check if we have recent data
-      if (s_agx_monitor.connection_status == AGX_MONITOR_STATUS_CONNECTED) {
-        uint64_t current_time = esp_timer_get_time();
-        uint64_t last_data_age =
-            current_time - s_agx_monitor.last_message_time_us;
-
-        if (last_data_age >
-            45000000) { // 45 seconds - trigger reconnect (reduced from 90s)
-          ESP_LOGW(
-              TAG,
-              "⚠️  No data received for %llu seconds - triggering reconnect",
-              last_data_age / 1000000);
-
-          // Disconnect immediately
-          if (s_agx_monitor.ws_client != NULL) {
-            ESP_LOGI(TAG, "🔌 Stopping WebSocket client due to data timeout");
-            esp_websocket_client_stop(s_agx_monitor.ws_client);
-            agx_monitor_update_status(AGX_MONITOR_STATUS_DISCONNECTED);
-            agx_monitor_set_error("Data reception timeout");
-          }
-
-          // Wait a bit before reconnecting
-          vTaskDelay(pdMS_TO_TICKS(3000));
-
-          // Attempt reconnect
-          ESP_LOGD(TAG, "Attempting reconnect after data timeout");
-          esp_err_t reconnect_ret = agx_monitor_connect();
-          if (reconnect_ret != ESP_OK) {
-            ESP_LOGW(TAG, "Reconnect failed after timeout: %s",
-                     esp_err_to_name(reconnect_ret));
-          }
-        } else if (last_data_age > 30000000) { // 30 seconds - warning only
-          ESP_LOGW(TAG, "No data received for %llu seconds",
-                   last_data_age / 1000000);
-        } else {
-          ESP_LOGD(TAG, "Last data received %llu seconds ago",
-                   last_data_age / 1000000);
-        }
-      }
-    }
-
-    // Main loop delay
-    vTaskDelay(pdMS_TO_TICKS(5000)); // 5 second intervals
   }
 
-  ESP_LOGI(TAG, "AGX monitor task finishing after %lu loops", loop_count);
-
-  // Disconnect before exiting
-  if (s_agx_monitor.connection_status == AGX_MONITOR_STATUS_CONNECTED) {
-    agx_monitor_disconnect();
-  }
+  // Stopped by agx_monitor_stop: close the connection if still open
+  agx_monitor_link_dispatch(AGX_LINK_EVENT_STOP);
 
   ESP_LOGI(TAG,
            "AGX monitor task finished - Final stats: Messages: %lu, "
@@ -914,13 +1052,135 @@ static void agx_monitor_task(void *pvParameters) {
   vTaskDelete(NULL);
 }
 
-static void agx_monitor_reconnect_task(void *pvParameters) {
-  ESP_LOGD(TAG, "AGX reconnect task started");
+/**
+ * @brief Queue a link event for the monitor task
+ *
+ * Safe from the WebSocket and default event loop tasks. Client events carry
+ * the connection they belong to so that late events of a connection the
+ * task has already stopped are dropped; 0 matches any connection.
+ */
+static void agx_monitor_post_link_event(agx_link_event_t event,
+                                        uint32_t attempt) {
+  agx_link_message_t message = {.event = event, .attempt = attempt};
 
-  // TODO: Implement reconnection logic in phase 6
-  ESP_LOGD(TAG, "Reconnect task - TODO: implement in phase 6");
+  if (s_agx_monitor.link_queue == NULL) {
+    return;
+  }
+  if (xQueueSend(s_agx_monitor.link_queue, &message, 0) != pdTRUE) {
+    // Only DATA can flood the queue, and the next one arrives in a second
+    ESP_LOGD(TAG, "Link event queue full, dropping %s",
+             agx_monitor_link_event_name(event));
+  }
+}
 
-  vTaskDelete(NULL);
+static agx_monitor_status_t agx_monitor_link_status(agx_link_state_t state) {
+  switch (state) {
+  case AGX_LINK_STATE_STOPPED:
+    return AGX_MONITOR_STATUS_INITIALIZED;
+  case AGX_LINK_STATE_STARTUP:
+  case AGX_LINK_STATE_CONNECTING:
+    return AGX_MONITOR_STATUS_CONNECTING;
+  case AGX_LINK_STATE_HANDSHAKE:
+  case AGX_LINK_STATE_ONLINE:
+    return AGX_MONITOR_STATUS_CONNECTED;
+  case AGX_LINK_STATE_BACKOFF:
+    return AGX_MONITOR_STATUS_RECONNECTING;
+  default:
+    return AGX_MONITOR_STATUS_DISCONNECTED;
+  }
+}
+
+/**
+ * @brief Feed an event to the state machine and perform its actions
+ *
+ * Runs on the monitor task only (or in agx_monitor_stop once the task is
+ * gone), so the WebSocket client is never started or stopped from its own
+ * event handler.
+ */
+static void agx_monitor_link_dispatch(agx_link_event_t event) {
+  agx_monitor_link_t *link = &s_agx_monitor.link;
+  agx_link_state_t old_state = link->state;
+  uint32_t reconnects = link->stats.reconnects;
+  uint32_t actions =
+      agx_monitor_link_handle(link, event, esp_timer_get_time() / 1000);
+
+  if (actions & AGX_LINK_ACTION_DISCONNECT) {
+    agx_monitor_disconnect();
+  }
+
+  if (actions & AGX_LINK_ACTION_INVALIDATE) {
+    uint32_t generation = 0;
+    if (xSemaphoreTake(s_agx_monitor.data_mutex, pdMS_TO_TICKS(1000))) {
+      agx_monitor_snapshot_begin(&s_agx_monitor.snapshot, true)->is_valid =
+          false;
+      generation = agx_monitor_snapshot_publish(&s_agx_monitor.snapshot);
+      xSemaphoreGive(s_agx_monitor.data_mutex);
+    } else {
+      ESP_LOGW(TAG, "Failed to acquire mutex to invalidate data");
+    }
+    if (xSemaphoreTake(s_agx_monitor.subscribe_mutex, pdMS_TO_TICKS(1000))) {
+      agx_monitor_subscribers_invalidate(&s_agx_monitor.subscribers,
+                                         generation,
+                                         esp_timer_get_time() / 1000);
+      xSemaphoreGive(s_agx_monitor.subscribe_mutex);
+    }
+  }
+
+  while (actions & AGX_LINK_ACTION_CONNECT) {
+    s_agx_monitor.link_attempt++;
+    if (link->stats.attempts > 1) {
+      s_agx_monitor.total_reconnects++;
+      agx_monitor_trigger_event(AGX_MONITOR_EVENT_RECONNECTING, NULL);
+    }
+    ESP_LOGD(TAG, "Connecting to AGX server (attempt #%lu, %lu failures)",
+             link->stats.attempts, link->failures);
+
+    if (agx_monitor_connect() == ESP_OK) {
+      break;
+    }
+    // Could not even start the client: count it as a failed attempt
+    actions = agx_monitor_link_handle(link, AGX_LINK_EVENT_WS_ERROR,
+                                      esp_timer_get_time() / 1000);
+    if (actions & AGX_LINK_ACTION_DISCONNECT) {
+      agx_monitor_disconnect();
+    }
+  }
+
+  if (link->state != old_state) {
+    ESP_LOGD(TAG, "Link %s -> %s (%s), next timeout %lu ms",
+             agx_monitor_link_state_name(old_state),
+             agx_monitor_link_state_name(link->state),
+             agx_monitor_link_event_name(event),
+             agx_monitor_link_timeout(link, esp_timer_get_time() / 1000));
+    agx_monitor_update_status(agx_monitor_link_status(link->state));
+
+    if (link->state == AGX_LINK_STATE_ONLINE) {
+      if (link->stats.reconnects != reconnects) {
+        ESP_LOGI(TAG, "AGX data restored after %lu ms (gap %lu ms)",
+                 link->stats.last_reconnect_ms, link->stats.last_gap_ms);
+      }
+      agx_monitor_trigger_event(AGX_MONITOR_EVENT_CONNECTED, NULL);
+    } else if (old_state == AGX_LINK_STATE_ONLINE) {
+      agx_monitor_trigger_event(AGX_MONITOR_EVENT_DISCONNECTED, NULL);
+    }
+  }
+}
+
+/**
+ * @brief Ethernet link and DHCP lease events (default event loop)
+ */
+static void agx_monitor_network_event_handler(void *handler_args,
+                                              esp_event_base_t base,
+                                              int32_t event_id,
+                                              void *event_data) {
+  if (base == ETH_EVENT && event_id == ETHERNET_EVENT_CONNECTED) {
+    agx_monitor_post_link_event(AGX_LINK_EVENT_LINK_UP, 0);
+  } else if (base == ETH_EVENT && event_id == ETHERNET_EVENT_DISCONNECTED) {
+    agx_monitor_post_link_event(AGX_LINK_EVENT_LINK_DOWN, 0);
+  } else if (base == IP_EVENT && event_id == IP_EVENT_AP_STAIPASSIGNED) {
+    // The AGX has just obtained its address: its server is coming up
+    agx_monitor_post_link_event(AGX_LINK_EVENT_LINK_UP, 0);
+  }
 }
 
 static void agx_monitor_websocket_event_handler(void *handler_args,
@@ -935,12 +1195,14 @@ static void agx_monitor_websocket_event_handler(void *handler_args,
     ESP_LOGD(TAG, "Connected to AGX server successfully");
     ESP_LOGD(TAG, "    Server: %s:%d", state->config.server_url,
              state->config.server_port);
-    ESP_LOGD(TAG, "    Connection attempts: %lu", state->total_reconnects);
+    ESP_LOGD(TAG, "    Connection attempt: #%lu", state->link.stats.attempts);
+
+    // Online (and CONNECTED) only once tegrastats data arrives
+    agx_monitor_post_link_event(AGX_LINK_EVENT_WS_CONNECTED,
+                                state->link_attempt);
 
-    agx_monitor_update_status(AGX_MONITOR_STATUS_CONNECTED);
-    state->total_reconnects =
-        0; // Reset reconnect counter on successful connection
-    agx_monitor_trigger_event(AGX_MONITOR_EVENT_CONNECTED, NULL);
+    // Every connection starts with JSON until the server accepts records
+    state->binary_active = false;
 
     // Send Socket.IO connection message
     const char *socketio_connect =
@@ -962,191 +1224,47 @@ static void agx_monitor_websocket_event_handler(void *handler_args,
     ESP_LOGW(TAG, "    Total messages received: %lu", state->messages_received);
     ESP_LOGW(TAG, "    Parse errors: %lu", state->parse_errors);
 
-    agx_monitor_update_status(AGX_MONITOR_STATUS_DISCONNECTED);
-
-    // Invalidate data on disconnection
-    if (xSemaphoreTake(state->data_mutex, pdMS_TO_TICKS(1000))) {
-      state->latest_data.is_valid = false;
-      xSemaphoreGive(state->data_mutex);
-    }
-
-    agx_monitor_trigger_event(AGX_MONITOR_EVENT_DISCONNECTED, NULL);
+    // A message cut off by the disconnect can never be completed
+    agx_monitor_reassembly_reset(&state->reassembly);
+    state->binary_active = false;
 
-    // Schedule automatic reconnection
-    ESP_LOGD(TAG, "Scheduling automatic reconnection in 3 seconds");
-    // Note: The main monitor task will handle reconnection attempts
+    // The monitor task invalidates the data and schedules the reconnect
+    agx_monitor_post_link_event(AGX_LINK_EVENT_WS_DISCONNECTED,
+                                state->link_attempt);
     break;
 
-  case WEBSOCKET_EVENT_DATA:
-    if (data->data_len > 0 && data->data_ptr != NULL) {
-      ESP_LOGD(TAG, "Received WebSocket data: %d bytes", data->data_len);
-
-      // Create null-terminated string for processing
-      char *message = malloc(data->data_len + 1);
-      if (message) {
-        memcpy(message, data->data_ptr, data->data_len);
-        message[data->data_len] = '\0';
-
-        ESP_LOGD(TAG, "=== WebSocket Raw Message ===");
-        ESP_LOGD(TAG, "Length: %d bytes", data->data_len);
-        ESP_LOGD(TAG, "Content: %s", message);
-        ESP_LOGD(TAG, "============================="); // Handle Socket.IO
-                                                        // protocol messages
-        if (message[0] == '0') {
-          // Socket.IO connection response (type 0)
-          ESP_LOGD(TAG, "Socket.IO connection response received");
-          ESP_LOGD(TAG, "Connection response: %s", message);
-        } else if (message[0] == '4' && message[1] == '0') {
-          // Socket.IO connection established (type 40)
-          ESP_LOGD(TAG, "Socket.IO connection established");
-          ESP_LOGD(TAG, "Connection acknowledgment: %s", message);
-        } else if (message[0] == '4' && message[1] == '2') {
-          // Socket.IO event message (42 prefix)
-          ESP_LOGD(TAG, "📨 Detected Socket.IO event message (42 prefix)");
-
-          // Parse the JSON data after the "42" prefix
-          const char *json_start = strchr(message + 2, '[');
-          if (json_start) {
-            ESP_LOGD(TAG, "Found JSON array start: %s", json_start);
-
-            // Find the event name and data
-            // Expected format: 42["tegrastats_update",{data}]
-            if (strstr(json_start, "tegrastats_update")) {
-              ESP_LOGD(TAG, "*** TEGRASTATS_UPDATE EVENT DETECTED ***");
-
-              const char *data_start = strchr(json_start, '{');
-              if (data_start) {
-                // Find the end of the JSON object
-                const char *data_end = strrchr(message, '}');
-                if (data_end) {
-                  size_t json_len = data_end - data_start + 1;
-
-                  ESP_LOGD(TAG, "=== TEGRASTATS JSON DATA ===");
-                  ESP_LOGD(TAG, "JSON Length: %zu bytes", json_len);
-                  ESP_LOGD(TAG, "JSON Content: %.*s", (int)json_len,
-                           data_start);
-                  ESP_LOGD(TAG, "============================");
-
-                  esp_err_t parse_ret =
-                      agx_monitor_parse_data(data_start, json_len);
-                  if (parse_ret == ESP_OK) {
-                    state->messages_received++;
-                    state->last_message_time_us = esp_timer_get_time();
-                    ESP_LOGD(TAG, "✅ Processed tegrastats data (msg #%lu)",
-                             state->messages_received);
-                  } else {
-                    state->parse_errors++;
-                    ESP_LOGW(TAG, "❌ Failed to parse tegrastats data: %s",
-                             esp_err_to_name(parse_ret));
-                  }
-                } else {
-                  ESP_LOGW(TAG, "Could not find JSON object end");
-                }
-              } else {
-                ESP_LOGW(TAG, "Could not find JSON object start");
-              }
-            } else {
-              ESP_LOGD(TAG, "Socket.IO event (not tegrastats_update): %s",
-                       json_start);
-            }
-          } else {
-            ESP_LOGW(TAG, "Could not find JSON array in Socket.IO message");
-          }
-        } else if (message[0] == '4' && message[1] == '0') {
-          // Socket.IO connect acknowledgment
-          ESP_LOGD(TAG, "Socket.IO connection established");
-        } else if (message[0] == '3') {
-          // Socket.IO heartbeat/ping - respond with pong
-          ESP_LOGD(TAG, "💓 Received Socket.IO ping, sending pong");
-          esp_err_t pong_ret = esp_websocket_client_send_text(
-              state->ws_client, "3", 1, portMAX_DELAY);
-          if (pong_ret == ESP_OK) {
-            ESP_LOGD(TAG, "💓 Pong sent successfully");
-          } else {
-            ESP_LOGW(TAG, "💓 Failed to send pong: %s",
-                     esp_err_to_name(pong_ret));
-          }
-        } else if (message[0] == '2') {
-          // Socket.IO ping
-          ESP_LOGD(TAG, "Socket.IO ping (type 2)");
-        } else {
-          // Handle unknown or binary data more gracefully
-          if (data->data_len <= 0 || data->data_len > 1024) {
-            ESP_LOGW(TAG, "Received invalid message length: %d bytes",
-                     data->data_len);
-          } else if (data->data_len <= 2) {
-            // Short messages (1-2 bytes) could be abnormal data
-            bool is_abnormal = false;
-
-            // Check if this is abnormal binary data (non-printable characters)
-            for (int i = 0; i < data->data_len; i++) {
-              unsigned char byte = (unsigned char)message[i];
-              if (byte < 32 && byte != '\n' && byte != '\r' && byte != '\t') {
-                is_abnormal = true;
-                break;
-              }
-            }
-
-            if (is_abnormal) {
-              ESP_LOGD(TAG, "ABNORMAL DATA DETECTED: %d bytes", data->data_len);
-              for (int i = 0; i < data->data_len; i++) {
-                unsigned char byte_val = (unsigned char)message[i];
-                ESP_LOGD(TAG, "   Byte %d: 0x%02X ('%c')", i, byte_val,
-                         isprint(byte_val) ? byte_val : '?');
-              }
-              ESP_LOGD(TAG, "Connection appears unstable - forcing reconnect");
-
-              // Force immediate disconnect and reconnect
-              esp_websocket_client_stop(state->ws_client);
-              agx_monitor_update_status(AGX_MONITOR_STATUS_DISCONNECTED);
-              agx_monitor_set_error("Abnormal data received");
-
-              // The monitor task will handle reconnection
-              free(message);
-              return;
-            } else {
-              ESP_LOGD(TAG,
-                       "🏓 Short message (%d bytes) - likely control frame",
-                       data->data_len);
-            }
-          } else if (data->data_len < 10 && (unsigned char)message[0] < 32) {
-            // Likely binary data or control frames - but could be abnormal
-            ESP_LOGW(TAG,
-                     "⚠️  SUSPICIOUS BINARY DATA: %d bytes, first byte: 0x%02X",
-                     data->data_len, (unsigned char)message[0]);
-            ESP_LOGW(TAG, "� Potential connection issue - forcing reconnect");
-
-            // Force immediate disconnect and reconnect for suspicious binary
-            // data
-            esp_websocket_client_stop(state->ws_client);
-            agx_monitor_update_status(AGX_MONITOR_STATUS_DISCONNECTED);
-            agx_monitor_set_error("Suspicious binary data received");
-
-            free(message);
-            return;
-          } else {
-            ESP_LOGW(TAG, "❓ Unknown Socket.IO message type: %s", message);
-            ESP_LOGW(TAG, "   First char: '%c' (0x%02X)", message[0],
-                     (unsigned char)message[0]);
-            if (strlen(message) > 1) {
-              ESP_LOGW(TAG, "   Second char: '%c' (0x%02X)", message[1],
-                       (unsigned char)message[1]);
-            }
-          }
-        }
-
-        free(message);
-      } else {
-        ESP_LOGE(TAG, "Failed to allocate memory for WebSocket message");
-      }
+  case WEBSOCKET_EVENT_DATA: {
+    agx_ws_chunk_t chunk = {
+        .data = data->data_ptr,
+        .len = data->data_len > 0 ? (size_t)data->data_len : 0,
+        .opcode = data->op_code,
+        .fin = data->fin,
+        .payload_len = data->payload_len > 0 ? (size_t)data->payload_len : 0,
+        .payload_offset =
+            data->payload_offset > 0 ? (size_t)data->payload_offset : 0,
+    };
+    agx_ws_message_t message;
+    esp_err_t feed_ret =
+        agx_monitor_reassembly_feed(&state->reassembly, &chunk, &message);
+    if (feed_ret == ESP_OK) {
+      agx_monitor_handle_message(state, message.data, (int)message.len,
+                                 message.opcode);
+      agx_monitor_reassembly_release(&state->reassembly, &message);
+    } else if (feed_ret == ESP_ERR_INVALID_SIZE) {
+      ESP_LOGW(TAG, "Discarding oversized message (frame payload %d bytes)",
+               data->payload_len);
+    } else if (feed_ret != ESP_ERR_NOT_FINISHED) {
+      ESP_LOGD(TAG, "Dropped WebSocket message: %s",
+               esp_err_to_name(feed_ret));
     }
     break;
+  }
 
   case WEBSOCKET_EVENT_ERROR:
     ESP_LOGE(TAG, "WebSocket error occurred");
-    agx_monitor_update_status(AGX_MONITOR_STATUS_ERROR);
     agx_monitor_set_error("WebSocket error");
     agx_monitor_trigger_event(AGX_MONITOR_EVENT_ERROR, data);
+    agx_monitor_post_link_event(AGX_LINK_EVENT_WS_ERROR, state->link_attempt);
     break;
 
   case WEBSOCKET_EVENT_BEFORE_CONNECT:
@@ -1159,126 +1277,377 @@ static void agx_monitor_websocket_event_handler(void *handler_args,
   }
 }
 
-static esp_err_t agx_monitor_parse_data(const char *json_data,
-                                        size_t data_len) {
-  if (json_data == NULL || data_len == 0) {
-    ESP_LOGE(TAG, "Invalid JSON data parameters");
-    return ESP_ERR_INVALID_ARG;
-  }
-
-  ESP_LOGD(TAG, "Parsing JSON data (%zu bytes): %.100s%s", data_len, json_data,
-           data_len > 100 ? "..." : "");
+/**
+ * @brief Handle one complete WebSocket message
+ *
+ * The message is either the client's receive buffer or a reassembly buffer;
+ * it is not NUL-terminated, so every access is bounded by message_len.
+ */
+static void agx_monitor_handle_message(agx_monitor_state_t *state,
+                                       const char *message, int message_len,
+                                       uint8_t opcode) {
+  if (message == NULL || message_len <= 0) {
+    return;
+  }
+
+  // Negotiated binary records carry the same updates as the 42 frames
+  if (opcode == AGX_WS_OPCODE_BINARY && state->binary_active) {
+    esp_err_t parse_ret =
+        agx_monitor_process_event(message, (size_t)message_len, true);
+    if (parse_ret == ESP_OK) {
+      state->binary_records++;
+    }
+    agx_monitor_update_received(state, parse_ret, message, message_len);
+    return;
+  }
+
+  ESP_LOGD(TAG, "=== WebSocket Raw Message ===");
+  ESP_LOGD(TAG, "Length: %d bytes", message_len);
+  ESP_LOGD(TAG, "Content: %.*s", message_len, message);
+  ESP_LOGD(TAG, "============================="); // Handle Socket.IO
+                                                  // protocol messages
+  if (message[0] == '0') {
+    // Socket.IO connection response (type 0)
+    ESP_LOGD(TAG, "Socket.IO connection response received");
+    ESP_LOGD(TAG, "Connection response: %.*s", message_len, message);
+  } else if (message_len >= 2 && message[0] == '4' && message[1] == '0') {
+    // Socket.IO connection established (type 40)
+    ESP_LOGD(TAG, "Socket.IO connection established");
+    ESP_LOGD(TAG, "Connection acknowledgment: %.*s", message_len, message);
+    if (state->config.binary_telemetry) {
+      agx_monitor_request_binary(state);
+    }
+  } else if (message_len >= 2 && message[0] == '4' && message[1] == '2') {
+    // Socket.IO event message (42 prefix)
+    // Expected format: 42["tegrastats_update",{data}]
+    ESP_LOGD(TAG, "📨 Detected Socket.IO event message (42 prefix)");
+
+    esp_err_t parse_ret =
+        agx_monitor_process_event(message, (size_t)message_len, false);
+    agx_binary_ack_t ack;
+    if (parse_ret == ESP_ERR_NOT_FOUND &&
+        agx_monitor_binary_parse_ack(message, (size_t)message_len, &ack) ==
+            ESP_OK) {
+      // JSON stays accepted, so a refused or unknown version needs nothing
+      state->binary_active = state->config.binary_telemetry && ack.binary &&
+                             ack.version == AGX_BINARY_VERSION;
+      state->binary_fields = ack.fields;
+      ESP_LOGI(TAG, "AGX telemetry format: %s",
+               state->binary_active ? "binary records" : "JSON");
+      return;
+    }
+    agx_monitor_update_received(state, parse_ret, message, message_len);
+  } else if (message_len >= 2 && message[0] == '4' && message[1] == '5') {
+    // Socket.IO binary event (451-[...]): the record follows as a binary
+    // message, the placeholder itself carries no data
+    ESP_LOGD(TAG, "Socket.IO binary event placeholder: %.*s", message_len,
+             message);
+  } else if (message[0] == '2') {
+    // Engine.IO ping (type 2) from the server - respond with pong (type 3)
+    ESP_LOGD(TAG, "💓 Received Socket.IO ping, sending pong");
+    esp_err_t pong_ret = esp_websocket_client_send_text(
+        state->ws_client, "3", 1, portMAX_DELAY);
+    if (pong_ret == ESP_OK) {
+      ESP_LOGD(TAG, "💓 Pong sent successfully");
+    } else {
+      ESP_LOGW(TAG, "💓 Failed to send pong: %s",
+               esp_err_to_name(pong_ret));
+    }
+  } else if (message[0] == '3') {
+    // Engine.IO pong (type 3)
+    ESP_LOGD(TAG, "Socket.IO pong (type 3)");
+  } else {
+    // Handle unknown or binary data more gracefully
+    if (message_len > 1024) {
+      ESP_LOGW(TAG, "Received invalid message length: %d bytes",
+               message_len);
+    } else if (message_len <= 2) {
+      // Short messages (1-2 bytes) could be abnormal data
+      bool is_abnormal = false;
+
+      // Check if this is abnormal binary data (non-printable characters)
+      for (int i = 0; i < message_len; i++) {
+        unsigned char byte = (unsigned char)message[i];
+        if (byte < 32 && byte != '\n' && byte != '\r' && byte != '\t') {
+          is_abnormal = true;
+          break;
+        }
+      }
 
-  // Parse JSON data using cJSON
-  cJSON *root = cJSON_Parse(json_data);
-  if (root == NULL) {
-    const char *error_ptr = cJSON_GetErrorPtr();
-    if (error_ptr != NULL) {
-      ESP_LOGE(TAG, "JSON parse error before: %s", error_ptr);
+      if (is_abnormal) {
+        ESP_LOGD(TAG, "ABNORMAL DATA DETECTED: %d bytes", message_len);
+        for (int i = 0; i < message_len; i++) {
+          unsigned char byte_val = (unsigned char)message[i];
+          ESP_LOGD(TAG, "   Byte %d: 0x%02X ('%c')", i, byte_val,
+                   isprint(byte_val) ? byte_val : '?');
+        }
+        ESP_LOGD(TAG, "Connection appears unstable - forcing reconnect");
+
+        // The client cannot be stopped from its own task: the monitor task
+        // closes the connection and reconnects
+        agx_monitor_set_error("Abnormal data received");
+        agx_monitor_post_link_event(AGX_LINK_EVENT_WS_ERROR,
+                                    state->link_attempt);
+        return;
+      } else {
+        ESP_LOGD(TAG, "🏓 Short message (%d bytes) - likely control frame",
+                 message_len);
+      }
+    } else if (message_len < 10 && (unsigned char)message[0] < 32) {
+      // Likely binary data or control frames - but could be abnormal
+      ESP_LOGW(TAG,
+               "⚠️  SUSPICIOUS BINARY DATA: %d bytes, first byte: 0x%02X",
+               message_len, (unsigned char)message[0]);
+      ESP_LOGW(TAG, "� Potential connection issue - forcing reconnect");
+
+      // Force immediate disconnect and reconnect for suspicious binary
+      // data
+      agx_monitor_set_error("Suspicious binary data received");
+      agx_monitor_post_link_event(AGX_LINK_EVENT_WS_ERROR,
+                                  state->link_attempt);
+      return;
     } else {
-      ESP_LOGE(TAG, "Failed to parse JSON data");
+      ESP_LOGW(TAG, "❓ Unknown Socket.IO message type: %.*s", message_len,
+               message);
+      ESP_LOGW(TAG, "   First char: '%c' (0x%02X)", message[0],
+               (unsigned char)message[0]);
+      ESP_LOGW(TAG, "   Second char: '%c' (0x%02X)", message[1],
+               (unsigned char)message[1]);
     }
-    return ESP_ERR_INVALID_ARG;
   }
+}
 
-  esp_err_t ret = ESP_OK;
+/**
+ * @brief Ask the server for binary records instead of JSON frames
+ *
+ * Sent once the namespace is connected; a server without record support
+ * ignores the unknown event and keeps sending JSON.
+ */
+static void agx_monitor_request_binary(agx_monitor_state_t *state) {
+  char request[96];
+  int len = snprintf(request, sizeof(request),
+                     "42[\"" AGX_BINARY_EVENT "\",{\"format\":\"binary\","
+                     "\"version\":%d,\"fields\":%d}]",
+                     AGX_BINARY_VERSION, AGX_BINARY_FIELDS_ALL);
+  esp_err_t ret = esp_websocket_client_send_text(state->ws_client, request,
+                                                 len, portMAX_DELAY);
+  if (ret != ESP_OK) {
+    ESP_LOGD(TAG, "Failed to request binary telemetry: %s",
+             esp_err_to_name(ret));
+  } else {
+    ESP_LOGD(TAG, "Requested binary telemetry: %s", request);
+  }
+}
 
-  // Acquire mutex for data update
-  if (xSemaphoreTake(s_agx_monitor.data_mutex, pdMS_TO_TICKS(1000))) {
-    // Clear previous data
-    memset(&s_agx_monitor.latest_data, 0, sizeof(agx_monitor_data_t));
-    s_agx_monitor.latest_data.update_time_us = esp_timer_get_time();
-
-    // Parse timestamp
-    cJSON *timestamp = cJSON_GetObjectItem(root, "timestamp");
-    if (cJSON_IsString(timestamp) && (timestamp->valuestring != NULL)) {
-      strncpy(s_agx_monitor.latest_data.timestamp, timestamp->valuestring,
-              sizeof(s_agx_monitor.latest_data.timestamp) - 1);
-      ESP_LOGD(TAG, "Parsed timestamp: %s",
-               s_agx_monitor.latest_data.timestamp);
-    }
+/**
+ * @brief Account for one update, JSON frame or binary record
+ */
+static void agx_monitor_update_received(agx_monitor_state_t *state,
+                                        esp_err_t parse_ret,
+                                        const char *message, int message_len) {
+  if (parse_ret == ESP_OK) {
+    state->messages_received++;
+    state->last_message_time_us = esp_timer_get_time();
+    agx_monitor_post_link_event(AGX_LINK_EVENT_DATA, state->link_attempt);
+    ESP_LOGD(TAG, "✅ Processed tegrastats data (msg #%lu)",
+             state->messages_received);
+  } else if (parse_ret == ESP_ERR_NOT_FOUND) {
+    ESP_LOGD(TAG, "Socket.IO event (not tegrastats_update): %.*s",
+             message_len, message);
+  } else {
+    state->parse_errors++;
+    ESP_LOGW(TAG, "❌ Failed to parse tegrastats data: %s",
+             esp_err_to_name(parse_ret));
+  }
+}
 
-    // Parse CPU data
-    cJSON *cpu = cJSON_GetObjectItem(root, "cpu");
-    if (cpu != NULL) {
-      ret = agx_monitor_parse_cpu_data(cpu, &s_agx_monitor.latest_data);
-      if (ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to parse CPU data: %s", esp_err_to_name(ret));
-      }
+/**
+ * @brief Parse one tegrastats_update frame with the configured parser
+ *
+ * Called with data_mutex held.
+ */
+static esp_err_t agx_monitor_parse_json(const char *frame, size_t len,
+                                        agx_monitor_data_t *parsed_data,
+                                        uint32_t *parsed_out) {
+  uint32_t parsed = 0;
+#if CONFIG_AGX_MONITOR_PARSER_CJSON
+  esp_err_t ret =
+      agx_monitor_parse_frame_cjson(frame, len, parsed_data, &parsed);
+#else
+  esp_err_t ret = agx_monitor_parse_frame(frame, len, parsed_data, &parsed);
+#if CONFIG_AGX_MONITOR_PARSER_VALIDATE
+  if (ret != ESP_ERR_NOT_FOUND) {
+    uint32_t cjson_parsed = 0;
+    esp_err_t cjson_ret = agx_monitor_parse_frame_cjson(
+        frame, len, &s_agx_monitor.validate_buffer, &cjson_parsed);
+    bool same = (ret == ESP_OK) == (cjson_ret == ESP_OK);
+    if (same && ret == ESP_OK) {
+      same = parsed == cjson_parsed &&
+             memcmp(parsed_data, &s_agx_monitor.validate_buffer,
+                    sizeof(agx_monitor_data_t)) == 0;
     }
-
-    // Parse memory data
-    cJSON *memory = cJSON_GetObjectItem(root, "memory");
-    if (memory != NULL) {
-      esp_err_t mem_ret =
-          agx_monitor_parse_memory_data(memory, &s_agx_monitor.latest_data);
-      if (mem_ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to parse memory data: %s",
-                 esp_err_to_name(mem_ret));
-        if (ret == ESP_OK)
-          ret = mem_ret;
-      }
+    if (!same) {
+      s_agx_monitor.parser_mismatches++;
+      ESP_LOGW(TAG,
+               "Streaming parser and cJSON disagree (%s/%s, 0x%02lx/0x%02lx, "
+               "%lu mismatches): %.*s",
+               esp_err_to_name(ret), esp_err_to_name(cjson_ret), parsed,
+               cjson_parsed, s_agx_monitor.parser_mismatches, (int)len, frame);
     }
+  }
+#endif
+#endif
+  *parsed_out = parsed;
+  return ret;
+}
 
-    // Parse temperature data
-    cJSON *temperature = cJSON_GetObjectItem(root, "temperature");
-    if (temperature != NULL) {
-      esp_err_t temp_ret = agx_monitor_parse_temperature_data(
-          temperature, &s_agx_monitor.latest_data);
-      if (temp_ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to parse temperature data: %s",
-                 esp_err_to_name(temp_ret));
-        if (ret == ESP_OK)
-          ret = temp_ret;
-      }
-    }
+static esp_err_t agx_monitor_process_event(const char *frame, size_t len,
+                                           bool binary) {
+  uint32_t parsed = 0;
 
-    // Parse power data
-    cJSON *power = cJSON_GetObjectItem(root, "power");
-    if (power != NULL) {
-      esp_err_t power_ret =
-          agx_monitor_parse_power_data(power, &s_agx_monitor.latest_data);
-      if (power_ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to parse power data: %s",
-                 esp_err_to_name(power_ret));
-        if (ret == ESP_OK)
-          ret = power_ret;
-      }
-    }
+  // The mutex only serializes writers; readers copy the published snapshot
+  // without locking, so a slow parse never delays them
+  if (!xSemaphoreTake(s_agx_monitor.data_mutex, pdMS_TO_TICKS(1000))) {
+    ESP_LOGE(TAG, "Failed to acquire mutex for data update");
+    return ESP_ERR_TIMEOUT;
+  }
 
-    // Parse GPU data
-    cJSON *gpu = cJSON_GetObjectItem(root, "gpu");
-    if (gpu != NULL) {
-      esp_err_t gpu_ret =
-          agx_monitor_parse_gpu_data(gpu, &s_agx_monitor.latest_data);
-      if (gpu_ret != ESP_OK) {
-        ESP_LOGW(TAG, "Failed to parse GPU data: %s", esp_err_to_name(gpu_ret));
-        if (ret == ESP_OK)
-          ret = gpu_ret;
-      }
-    }
+  // Parse straight into the unpublished back slot: a malformed frame is
+  // simply never published and the last good data stays current
+  agx_monitor_data_t *parsed_data =
+      agx_monitor_snapshot_begin(&s_agx_monitor.snapshot, false);
+  esp_err_t ret =
+      binary ? agx_monitor_binary_decode((const uint8_t *)frame, len,
+                                         parsed_data, &parsed)
+             : agx_monitor_parse_json(frame, len, parsed_data, &parsed);
+  if (ret != ESP_OK) {
+    xSemaphoreGive(s_agx_monitor.data_mutex);
+    return ret;
+  }
 
-    // Mark data as valid if parsing was successful
-    if (ret == ESP_OK) {
-      s_agx_monitor.latest_data.is_valid = true;
-      ESP_LOGD(TAG, "JSON data parsing completed successfully");
-    } else {
-      s_agx_monitor.latest_data.is_valid = false;
-      ESP_LOGW(TAG, "JSON data parsing completed with errors");
-    }
+  parsed_data->update_time_us = esp_timer_get_time();
+  parsed_data->is_valid = true;
+  float cpu_temp = parsed_data->temperature.cpu;
+  uint8_t core_count = parsed_data->cpu.core_count;
+  uint32_t time_s = (uint32_t)(parsed_data->update_time_us / 1000000);
+  int32_t values[AGX_HISTORY_CHANNELS];
+  agx_monitor_history_sample(parsed_data, values);
+  uint32_t generation = agx_monitor_snapshot_publish(&s_agx_monitor.snapshot);
+  xSemaphoreGive(s_agx_monitor.data_mutex);
 
-    xSemaphoreGive(s_agx_monitor.data_mutex);
-  } else {
-    ESP_LOGE(TAG, "Failed to acquire mutex for data update");
-    ret = ESP_ERR_TIMEOUT;
+  // A second frame within the same second is not recorded
+  if (s_agx_monitor.history_mutex != NULL &&
+      xSemaphoreTake(s_agx_monitor.history_mutex, pdMS_TO_TICKS(100))) {
+    agx_monitor_history_add(&s_agx_monitor.history, time_s, values);
+    xSemaphoreGive(s_agx_monitor.history_mutex);
   }
 
-  // Clean up JSON object
-  cJSON_Delete(root);
+  ESP_LOGD(TAG,
+           "Published tegrastats frame #%lu (%zu bytes): %d cores, CPU %.1f°C",
+           generation, len, core_count, cpu_temp);
+
+  // Wake only the subscribers whose channels moved, including the CPU
+  // temperature handoff to console_core for fan control
+  if (xSemaphoreTake(s_agx_monitor.subscribe_mutex, pdMS_TO_TICKS(100))) {
+    agx_monitor_subscribe_carry(values, parsed);
+    s_agx_monitor.subscribe_parsed = parsed;
+    agx_monitor_subscribers_update(&s_agx_monitor.subscribers, values,
+                                   generation, esp_timer_get_time() / 1000);
+    xSemaphoreGive(s_agx_monitor.subscribe_mutex);
+  }
 
   // Trigger data received event
   agx_monitor_trigger_event(AGX_MONITOR_EVENT_DATA_RECEIVED, NULL);
 
+  return ESP_OK;
+}
+
+#ifdef AGX_MONITOR_USE_CJSON
+/**
+ * @brief Reference parser: builds a cJSON tree of the event array
+ *
+ * Allocates the whole tree on the heap for every frame. Kept for validating
+ * agx_monitor_parse_frame and as a fallback (CONFIG_AGX_MONITOR_PARSER_CJSON).
+ */
+static esp_err_t agx_monitor_parse_frame_cjson(const char *frame, size_t len,
+                                               agx_monitor_data_t *data,
+                                               uint32_t *parsed) {
+  *parsed = 0;
+  if (len < 2 || frame[0] != '4' || frame[1] != '2') {
+    return ESP_ERR_NOT_FOUND;
+  }
+  const char *array = memchr(frame + 2, '[', len - 2);
+  if (array == NULL) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  cJSON *event = cJSON_ParseWithLength(array, len - (size_t)(array - frame));
+  if (event == NULL) {
+    ESP_LOGD(TAG, "JSON parse error");
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  esp_err_t ret = ESP_OK;
+  cJSON *name = cJSON_GetArrayItem(event, 0);
+  cJSON *root = cJSON_GetArrayItem(event, 1);
+  if (!cJSON_IsArray(event) || !cJSON_IsString(name) ||
+      strcmp(name->valuestring, "tegrastats_update") != 0) {
+    ret = ESP_ERR_NOT_FOUND;
+    goto cleanup;
+  }
+  if (!cJSON_IsObject(root)) {
+    ret = ESP_ERR_INVALID_RESPONSE;
+    goto cleanup;
+  }
+
+  memset(data, 0, sizeof(agx_monitor_data_t));
+
+  cJSON *timestamp = cJSON_GetObjectItem(root, "timestamp");
+  if (cJSON_IsString(timestamp) && (timestamp->valuestring != NULL)) {
+    strncpy(data->timestamp, timestamp->valuestring,
+            sizeof(data->timestamp) - 1);
+    *parsed |= AGX_MONITOR_PARSED_TIMESTAMP;
+  }
+
+  // A "cpu" member without a "cores" array fails the whole frame
+  cJSON *cpu = cJSON_GetObjectItem(root, "cpu");
+  if (cpu != NULL) {
+    if (agx_monitor_parse_cpu_data(cpu, data) != ESP_OK) {
+      ret = ESP_ERR_INVALID_RESPONSE;
+      goto cleanup;
+    }
+    *parsed |= AGX_MONITOR_PARSED_CPU;
+  }
+
+  cJSON *memory = cJSON_GetObjectItem(root, "memory");
+  if (cJSON_IsObject(memory)) {
+    agx_monitor_parse_memory_data(memory, data);
+    *parsed |= AGX_MONITOR_PARSED_MEMORY;
+  }
+
+  cJSON *temperature = cJSON_GetObjectItem(root, "temperature");
+  if (cJSON_IsObject(temperature)) {
+    agx_monitor_parse_temperature_data(temperature, data);
+    *parsed |= AGX_MONITOR_PARSED_TEMPERATURE;
+    if (cJSON_IsNumber(cJSON_GetObjectItem(temperature, "cpu"))) {
+      *parsed |= AGX_MONITOR_PARSED_CPU_TEMP;
+    }
+  }
+
+  cJSON *power = cJSON_GetObjectItem(root, "power");
+  if (cJSON_IsObject(power)) {
+    agx_monitor_parse_power_data(power, data);
+    *parsed |= AGX_MONITOR_PARSED_POWER;
+  }
+
+  cJSON *gpu = cJSON_GetObjectItem(root, "gpu");
+  if (cJSON_IsObject(gpu)) {
+    agx_monitor_parse_gpu_data(gpu, data);
+    *parsed |= AGX_MONITOR_PARSED_GPU;
+  }
+
+cleanup:
+  cJSON_Delete(event);
   return ret;
 }
 
@@ -1399,13 +1768,6 @@ static esp_err_t agx_monitor_parse_temperature_data(cJSON *temp_json,
   if (cJSON_IsNumber(cpu)) {
     data->temperature.cpu = (float)cpu->valuedouble;
     ESP_LOGD(TAG, "CPU temperature: %.1f°C", data->temperature.cpu);
-
-    // Push CPU temperature to console temperature system for fan control
-    esp_err_t temp_ret = console_set_agx_temperature(data->temperature.cpu);
-    if (temp_ret != ESP_OK) {
-      ESP_LOGD(TAG, "Failed to update AGX temperature: %s",
-               esp_err_to_name(temp_ret));
-    }
   }
 
   cJSON *soc0 = cJSON_GetObjectItem(temp_json, "soc0");
@@ -1600,6 +1962,7 @@ static esp_err_t agx_monitor_parse_gpu_data(cJSON *gpu_json,
   ESP_LOGD(TAG, "Parsed GPU data successfully");
   return ESP_OK;
 }
+#endif
 
 static void agx_monitor_update_status(agx_monitor_status_t new_status) {
   agx_monitor_status_t old_status = s_agx_monitor.connection_status;
@@ -1621,10 +1984,11 @@ static void agx_monitor_update_status(agx_monitor_status_t new_status) {
 
     // Update connected time statistics
     uint64_t current_time = esp_timer_get_time();
-    if (old_status == AGX_MONITOR_STATUS_CONNECTED &&
-        new_status != AGX_MONITOR_STATUS_CONNECTED) {
+    if (new_status == AGX_MONITOR_STATUS_CONNECTED) {
+      s_agx_monitor.connected_since_us = current_time;
+    } else if (old_status == AGX_MONITOR_STATUS_CONNECTED) {
       s_agx_monitor.connected_time_us +=
-          (current_time - s_agx_monitor.start_time_us);
+          current_time - s_agx_monitor.connected_since_us;
     }
   }
 }
@@ -1669,6 +2033,85 @@ static void agx_monitor_set_error(const char *error_msg) {
   }
 }
 
+static void agx_monitor_history_start(void) {
+  static const size_t tier_bytes[AGX_HISTORY_TIER_COUNT] = {
+      CONFIG_AGX_MONITOR_HISTORY_RAW_KB * 1024,
+      CONFIG_AGX_MONITOR_HISTORY_1MIN_KB * 1024,
+      CONFIG_AGX_MONITOR_HISTORY_10MIN_KB * 1024,
+  };
+
+  esp_err_t ret = agx_monitor_history_init(&s_agx_monitor.history, tier_bytes);
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "History disabled: %s", esp_err_to_name(ret));
+    return;
+  }
+
+  s_agx_monitor.history_mutex = xSemaphoreCreateMutex();
+  if (s_agx_monitor.history_mutex == NULL) {
+    ESP_LOGW(TAG, "History disabled: failed to create mutex");
+    agx_monitor_history_deinit(&s_agx_monitor.history);
+  }
+}
+
+static void agx_monitor_history_stop(void) {
+  if (s_agx_monitor.history_mutex == NULL) {
+    return;
+  }
+  if (xSemaphoreTake(s_agx_monitor.history_mutex, pdMS_TO_TICKS(1000))) {
+    xSemaphoreGive(s_agx_monitor.history_mutex);
+  }
+  vSemaphoreDelete(s_agx_monitor.history_mutex);
+  s_agx_monitor.history_mutex = NULL;
+  agx_monitor_history_deinit(&s_agx_monitor.history);
+}
+
+static void agx_monitor_temperature_handoff(
+    const agx_monitor_notification_t *notification, void *user_data) {
+  // Invalid data or a frame without temperature.cpu: leave the console
+  // value to go stale, which makes the fan controller fall back safely
+  if (!notification->valid ||
+      !(s_agx_monitor.subscribe_parsed & AGX_MONITOR_PARSED_CPU_TEMP)) {
+    return;
+  }
+
+  float cpu_temp = notification->values[AGX_HISTORY_CH_TEMP_CPU] / 100.0f;
+  esp_err_t ret = console_set_agx_temperature(cpu_temp);
+  if (ret != ESP_OK) {
+    ESP_LOGD(TAG, "Failed to update AGX temperature: %s",
+             esp_err_to_name(ret));
+  }
+}
+
+/**
+ * @brief Keep the previous values of groups missing from a frame
+ *
+ * The parser leaves them zero; for subscribers a missing group means
+ * unchanged rather than a drop to 0 (a 0 °C CPU, a 0 mW rail).
+ */
+static void agx_monitor_subscribe_carry(int32_t *values, uint32_t parsed) {
+  static const struct {
+    uint32_t parsed;
+    uint8_t first;
+    uint8_t count;
+  } groups[] = {
+      {AGX_MONITOR_PARSED_CPU, AGX_HISTORY_CH_CPU_USAGE,
+       AGX_MONITOR_MAX_CPU_CORES},
+      {AGX_MONITOR_PARSED_CPU_TEMP, AGX_HISTORY_CH_TEMP_CPU, 1},
+      {AGX_MONITOR_PARSED_TEMPERATURE, AGX_HISTORY_CH_TEMP_SOC0, 4},
+      {AGX_MONITOR_PARSED_POWER, AGX_HISTORY_CH_POWER_GPU_SOC, 3},
+      {AGX_MONITOR_PARSED_GPU, AGX_HISTORY_CH_GPU_LOAD, 1},
+      {AGX_MONITOR_PARSED_MEMORY, AGX_HISTORY_CH_RAM_USED, 1},
+  };
+
+  for (size_t i = 0; i < sizeof(groups) / sizeof(groups[0]); i++) {
+    if (!(parsed & groups[i].parsed)) {
+      memcpy(values + groups[i].first,
+             s_agx_monitor.subscribers.last + groups[i].first,
+             groups[i].count * sizeof(int32_t));
+    }
+  }
+}
+
 /* ============================================================================
  * Console Commands Implementation (Phase 7)
  * ============================================================================
@@ -1700,6 +2143,11 @@ static esp_err_t cmd_agx_status(int argc, char **argv) {
   printf("Initialized: %s\n", status.initialized ? "Yes" : "No");
   printf("Running: %s\n", status.running ? "Yes" : "No");
   printf("Connection Status: %s\n", status_name);
+  printf("Link State: %s\n", agx_monitor_link_state_name(status.link_state));
+  if (status.link.reconnects > 0) {
+    printf("Last Reconnect: %lu ms (data gap %lu ms)\n",
+           status.link.last_reconnect_ms, status.link.last_gap_ms);
+  }
   printf("Messages Received: %lu\n", status.messages_received);
   printf("Parse Errors: %lu\n", status.parse_errors);
   printf("Total Reconnects: %lu\n", status.total_reconnects);
@@ -1766,6 +2214,7 @@ static esp_err_t cmd_agx_data(int argc, char **argv) {
 
   printf("\n=== Latest AGX Data ===\n");
   printf("Timestamp: %s\n", data.timestamp);
+  printf("Generation: %lu\n", data.generation);
 
   // CPU Information
   printf("\n--- CPU Information ---\n");
@@ -1832,6 +2281,8 @@ static esp_err_t cmd_agx_config(int argc, char **argv) {
          s_agx_monitor.config.heartbeat_timeout_ms);
   printf("SSL Enabled: %s\n", s_agx_monitor.config.enable_ssl ? "Yes" : "No");
   printf("Auto Start: %s\n", s_agx_monitor.config.auto_start ? "Yes" : "No");
+  printf("Binary Telemetry: %s\n",
+         s_agx_monitor.config.binary_telemetry ? "Requested" : "No");
   printf("Startup Delay: %lu ms\n", s_agx_monitor.config.startup_delay_ms);
   printf("Task Stack Size: %lu bytes\n", s_agx_monitor.config.task_stack_size);
   printf("Task Priority: %d\n", s_agx_monitor.config.task_priority);
@@ -1857,6 +2308,20 @@ static esp_err_t cmd_agx_stats(int argc, char **argv) {
              ? (float)(status.messages_received - status.parse_errors) /
                    status.messages_received * 100
              : 0);
+#if CONFIG_AGX_MONITOR_PARSER_VALIDATE
+  printf("Parser Mismatches (vs cJSON): %lu\n",
+         s_agx_monitor.parser_mismatches);
+#endif
+  if (status.binary_telemetry) {
+    printf("Telemetry Format: binary v%d (fields 0x%02x)\n",
+           AGX_BINARY_VERSION, s_agx_monitor.binary_fields);
+  } else {
+    printf("Telemetry Format: JSON\n");
+  }
+  printf("Binary Records: %lu\n", status.binary_records);
+  printf("Reassembled Messages: %lu\n", status.frames_reassembled);
+  printf("Oversized Messages: %lu\n", status.frames_oversized);
+  printf("Dropped Messages: %lu\n", status.frames_dropped);
   printf("Total Reconnection Attempts: %lu\n", status.total_reconnects);
   printf("System Uptime: %.1f seconds\n", status.uptime_ms / 1000.0f);
   printf("Connected Time: %.1f seconds\n", status.connected_time_ms / 1000.0f);
@@ -1874,10 +2339,134 @@ static esp_err_t cmd_agx_stats(int argc, char **argv) {
     printf("Reconnection Rate: %.2f reconnects/min\n", reconnect_rate);
   }
 
+  if (xSemaphoreTake(s_agx_monitor.subscribe_mutex, pdMS_TO_TICKS(100))) {
+    const agx_monitor_subscribers_t *subs = &s_agx_monitor.subscribers;
+    printf("Subscriber Notifications: %lu (%lu skipped by change mask, %lu "
+           "updates)\n",
+           subs->notifications, subs->skipped, subs->updates);
+    xSemaphoreGive(s_agx_monitor.subscribe_mutex);
+  }
+
+  const agx_link_stats_t *link = &status.link;
+  printf("\nConnection Attempts: %lu (%lu failed, %lu timed out)\n",
+         link->attempts, link->failures, link->connect_timeouts);
+  printf("Liveness Timeouts: %lu\n", link->liveness_timeouts);
+  printf("Ethernet Link Losses: %lu\n", link->link_losses);
+  if (link->reconnects > 0) {
+    printf("Time to Reconnect: last %lu ms, avg %llu ms, max %lu ms\n",
+           link->last_reconnect_ms,
+           link->total_reconnect_ms / link->reconnects, link->max_reconnect_ms);
+    printf("Data Gap: last %lu ms, avg %llu ms, max %lu ms\n",
+           link->last_gap_ms, link->total_gap_ms / link->reconnects,
+           link->max_gap_ms);
+  }
+
   printf("=============================\n\n");
   return ESP_OK;
 }
 
+#define AGX_HISTORY_DEFAULT_PATH "/sdcard/agx_history.bin"
+#define AGX_HISTORY_MAX_POINTS (120)
+
+// history [raw|1m|10m] [channel] [count] | history stats | history save [path]
+static esp_err_t cmd_agx_history(int argc, char **argv) {
+  static const char *const tier_names[AGX_HISTORY_TIER_COUNT] = {"raw", "1m",
+                                                                 "10m"};
+  agx_history_tier_t tier = AGX_HISTORY_TIER_RAW;
+  agx_history_channel_t channel = AGX_HISTORY_CH_TEMP_CPU;
+  size_t count = 20;
+  char name[16];
+
+  if (argc > 1 && strcmp(argv[1], "stats") == 0) {
+    printf("\n=== AGX Monitor History ===\n");
+    for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+      agx_history_tier_stats_t stats;
+      esp_err_t ret =
+          agx_monitor_get_history_stats((agx_history_tier_t)t, &stats);
+      if (ret != ESP_OK) {
+        printf("History not available: %s\n", esp_err_to_name(ret));
+        return ret;
+      }
+      printf("%-4s %6lu records, %6lu/%6lu bytes, %lu..%lu s\n",
+             tier_names[t], stats.records, stats.bytes_used, stats.capacity,
+             stats.oldest_time, stats.newest_time);
+    }
+    printf("===========================\n\n");
+    return ESP_OK;
+  }
+
+  if (argc > 1 && strcmp(argv[1], "save") == 0) {
+    const char *path = argc > 2 ? argv[2] : AGX_HISTORY_DEFAULT_PATH;
+    esp_err_t ret = agx_monitor_save_history(path);
+    if (ret != ESP_OK) {
+      printf("Failed to save history to %s: %s\n", path,
+             esp_err_to_name(ret));
+      return ret;
+    }
+    printf("History saved to %s\n", path);
+    return ESP_OK;
+  }
+
+  int arg = 1;
+  if (arg < argc) {
+    for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+      if (strcmp(argv[arg], tier_names[t]) == 0) {
+        tier = (agx_history_tier_t)t;
+        arg++;
+        break;
+      }
+    }
+  }
+  if (arg < argc && !isdigit((unsigned char)argv[arg][0])) {
+    if (agx_monitor_history_channel_from_name(argv[arg], &channel) != ESP_OK) {
+      printf("Unknown channel: %s\n", argv[arg]);
+      printf("Channels: cpu0..cpu%d", AGX_MONITOR_MAX_CPU_CORES - 1);
+      for (int ch = AGX_HISTORY_CH_TEMP_CPU; ch < AGX_HISTORY_CHANNELS; ch++) {
+        printf(" %s", agx_monitor_history_channel_name(
+                          (agx_history_channel_t)ch, name, sizeof(name)));
+      }
+      printf("\n");
+      return ESP_ERR_INVALID_ARG;
+    }
+    arg++;
+  }
+  if (arg < argc) {
+    count = (size_t)atoi(argv[arg]);
+    if (count == 0 || count > AGX_HISTORY_MAX_POINTS) {
+      printf("Count must be 1-%d\n", AGX_HISTORY_MAX_POINTS);
+      return ESP_ERR_INVALID_ARG;
+    }
+  }
+
+  agx_history_point_t *points = malloc(count * sizeof(*points));
+  if (points == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+  size_t n = agx_monitor_get_history(tier, channel, 0, points, count);
+  int scale = agx_monitor_history_channel_scale(channel);
+
+  printf("\n=== AGX History: %s, %s ===\n",
+         agx_monitor_history_channel_name(channel, name, sizeof(name)),
+         tier_names[tier]);
+  for (size_t i = 0; i < n; i++) {
+    if (tier == AGX_HISTORY_TIER_RAW) {
+      printf("%8lu s  %8.2f\n", points[i].time,
+             (double)points[i].avg / scale);
+    } else {
+      printf("%8lu s  min %8.2f  avg %8.2f  max %8.2f\n", points[i].time,
+             (double)points[i].min / scale, (double)points[i].avg / scale,
+             (double)points[i].max / scale);
+    }
+  }
+  if (n == 0) {
+    printf("No data\n");
+  }
+  printf("\n");
+
+  free(points);
+  return ESP_OK;
+}
+
 // Main AGX monitor command handler with subcommands
 static esp_err_t cmd_agx_monitor(int argc, char **argv) {
   if (argc < 2) {
@@ -1890,6 +2479,8 @@ static esp_err_t cmd_agx_monitor(int argc, char **argv) {
     printf("  data       - Display latest AGX system data\n");
     printf("  config     - Display AGX monitor configuration\n");
     printf("  stats      - Display detailed AGX monitor statistics\n");
+    printf("  history    - Metric history ([raw|1m|10m] [channel] [count], "
+           "stats, save [path])\n");
     printf("  debug      - Debug commands (verbose|quiet|normal|reconnect)\n");
     return ESP_ERR_INVALID_ARG;
   }
@@ -1908,6 +2499,8 @@ static esp_err_t cmd_agx_monitor(int argc, char **argv) {
     return cmd_agx_config(argc - 1, argv + 1);
   } else if (strcmp(subcmd, "stats") == 0) {
     return cmd_agx_stats(argc - 1, argv + 1);
+  } else if (strcmp(subcmd, "history") == 0) {
+    return cmd_agx_history(argc - 1, argv + 1);
   } else if (strcmp(subcmd, "debug") == 0) {
     return cmd_agx_debug(argc - 1, argv + 1);
   } else {
@@ -1934,9 +2527,10 @@ static esp_err_t cmd_agx_debug(int argc, char **argv) {
       return ESP_OK;
     } else if (strcmp(argv[1], "reconnect") == 0) {
       printf("Forcing reconnection...\n");
-      if (s_agx_monitor.ws_client != NULL) {
-        esp_websocket_client_stop(s_agx_monitor.ws_client);
-        agx_monitor_update_status(AGX_MONITOR_STATUS_DISCONNECTED);
+      if (s_agx_monitor.running) {
+        // Handled like a client error of the current connection
+        agx_monitor_post_link_event(AGX_LINK_EVENT_WS_ERROR,
+                                    s_agx_monitor.link_attempt);
         printf("Reconnection triggered.\n");
       } else {
         printf("No active connection to reconnect.\n");
@@ -1961,10 +2555,10 @@ static esp_err_t agx_monitor_register_commands(void) {
   static const console_cmd_t agx_commands[] = {
       {.command = "agx_monitor",
        .help = "AGX monitor control and status commands",
-       .hint = "<status|start|stop|data|config|stats|debug> [args]",
+       .hint = "<status|start|stop|data|config|stats|history|debug> [args]",
        .func = cmd_agx_monitor,
        .min_args = 0,
-       .max_args = 2}};
+       .max_args = 4}};
 
   // Register all commands
   size_t cmd_count = sizeof(agx_commands) / sizeof(agx_commands[0]);
@@ -1978,7 +2572,7 @@ static esp_err_t agx_monitor_register_commands(void) {
   }
 
   ESP_LOGD(TAG, "Registered AGX monitor console command with %zu subcommands",
-           7);
+           8);
   return ESP_OK;
 }
 
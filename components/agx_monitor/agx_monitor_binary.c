@@ -0,0 +1,478 @@
+/**
+ * @file agx_monitor_binary.c
+ * @brief Compact binary tegrastats records
+ *
+ * Sections are read with bounds-checked little-endian loads straight into
+ * agx_monitor_data_t; nothing is allocated and the record is not copied.
+ * Temperatures are converted through double like the JSON parsers, so a
+ * record and the equivalent JSON frame decode to identical data.
+ *
+ * @version 1.0.0
+ * @date 2025-10-04
+ * @author robOS Team
+ */
+
+#include "agx_monitor_binary.h"
+#include "agx_monitor_parser.h"
+
+#include <string.h>
+
+#define AGX_BINARY_DAY_S (86400)
+#define AGX_BINARY_MAX_TIME_S (253402300800LL) ///< 10000-01-01T00:00:00Z
+
+/**
+ * @brief Record reader
+ */
+typedef struct {
+  const uint8_t *p;   ///< Next byte
+  const uint8_t *end; ///< End of record
+} agx_reader_t;
+
+/* ============================================================================
+ * Little-endian Access
+ * ============================================================================
+ */
+
+static bool can_read(const agx_reader_t *r, size_t n) {
+  return (size_t)(r->end - r->p) >= n;
+}
+
+static uint8_t read_u8(agx_reader_t *r) { return *r->p++; }
+
+static uint16_t read_u16(agx_reader_t *r) {
+  uint16_t v = (uint16_t)(r->p[0] | (r->p[1] << 8));
+  r->p += 2;
+  return v;
+}
+
+static uint32_t read_u32(agx_reader_t *r) {
+  uint32_t v = (uint32_t)r->p[0] | ((uint32_t)r->p[1] << 8) |
+               ((uint32_t)r->p[2] << 16) | ((uint32_t)r->p[3] << 24);
+  r->p += 4;
+  return v;
+}
+
+static uint8_t *put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+  return p + 4;
+}
+
+/* ============================================================================
+ * Timestamps
+ * ============================================================================
+ */
+
+/* Days since 1970-01-01 of a proleptic Gregorian date */
+static int64_t days_from_civil(int64_t y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  int64_t era = (y >= 0 ? y : y - 399) / 400;
+  unsigned yoe = (unsigned)(y - era * 400);
+  unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + (int64_t)doe - 719468;
+}
+
+static void civil_from_days(int64_t z, int *year, unsigned *month,
+                            unsigned *day) {
+  z += 719468;
+  int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  unsigned doe = (unsigned)(z - era * 146097);
+  unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  unsigned mp = (5 * doy + 2) / 153;
+  *day = doy - (153 * mp + 2) / 5 + 1;
+  *month = mp < 10 ? mp + 3 : mp - 9;
+  *year = (int)(yoe + era * 400 + (*month <= 2));
+}
+
+static char *put_digits(char *p, unsigned value, int count, char separator) {
+  for (int i = count - 1; i >= 0; i--) {
+    p[i] = (char)('0' + value % 10);
+    value /= 10;
+  }
+  p[count] = separator;
+  return p + count + 1;
+}
+
+/* Same form as the tegrastats service: 2025-10-04T12:00:00.123456Z */
+static bool format_time(int64_t time_us,
+                        char out[AGX_MONITOR_MAX_TIMESTAMP_LENGTH]) {
+  if (time_us < 0 || time_us / 1000000 >= AGX_BINARY_MAX_TIME_S) {
+    return false;
+  }
+  int64_t secs = time_us / 1000000;
+  unsigned sod = (unsigned)(secs % AGX_BINARY_DAY_S);
+  int year;
+  unsigned month, day;
+  civil_from_days(secs / AGX_BINARY_DAY_S, &year, &month, &day);
+
+  char *p = put_digits(out, (unsigned)year, 4, '-');
+  p = put_digits(p, month, 2, '-');
+  p = put_digits(p, day, 2, 'T');
+  p = put_digits(p, sod / 3600, 2, ':');
+  p = put_digits(p, sod / 60 % 60, 2, ':');
+  p = put_digits(p, sod % 60, 2, '.');
+  p = put_digits(p, (unsigned)(time_us % 1000000), 6, 'Z');
+  *p = '\0';
+  return true;
+}
+
+static bool read_digits(const char **p, int count, unsigned *value) {
+  *value = 0;
+  for (int i = 0; i < count; i++) {
+    if (**p < '0' || **p > '9') {
+      return false;
+    }
+    *value = *value * 10 + (unsigned)(*(*p)++ - '0');
+  }
+  return true;
+}
+
+static bool parse_time(const char *text, int64_t *time_us) {
+  const char *p = text;
+  unsigned y, mo, d, h, mi, s;
+  if (!read_digits(&p, 4, &y) || *p++ != '-' || !read_digits(&p, 2, &mo) ||
+      *p++ != '-' || !read_digits(&p, 2, &d) || *p++ != 'T' ||
+      !read_digits(&p, 2, &h) || *p++ != ':' || !read_digits(&p, 2, &mi) ||
+      *p++ != ':' || !read_digits(&p, 2, &s)) {
+    return false;
+  }
+  if (y < 1970 || mo < 1 || mo > 12 || d < 1 || d > 31 || h > 23 ||
+      mi > 59 || s > 59) {
+    return false;
+  }
+
+  // Fraction digits beyond microseconds are dropped
+  unsigned us = 0;
+  if (*p == '.') {
+    p++;
+    int digits = 0;
+    for (; *p >= '0' && *p <= '9'; p++, digits++) {
+      if (digits < 6) {
+        us = us * 10 + (unsigned)(*p - '0');
+      }
+    }
+    if (digits == 0) {
+      return false;
+    }
+    for (; digits < 6; digits++) {
+      us *= 10;
+    }
+  }
+  if (*p == 'Z') {
+    p++;
+  }
+  if (*p != '\0') {
+    return false;
+  }
+
+  int64_t secs = days_from_civil(y, mo, d) * AGX_BINARY_DAY_S + h * 3600 +
+                 mi * 60 + s;
+  *time_us = secs * 1000000 + us;
+  return true;
+}
+
+/* ============================================================================
+ * Records
+ * ============================================================================
+ */
+
+static void set_unit(char *unit, const char *text) {
+  memset(unit, 0, 4);
+  memcpy(unit, text, strlen(text));
+}
+
+static float read_temperature(agx_reader_t *r, bool *present) {
+  int16_t v = (int16_t)read_u16(r);
+  *present = v != AGX_BINARY_TEMP_MISSING;
+  return *present ? (float)(v / 100.0) : 0.0f;
+}
+
+static int16_t encode_temperature(float celsius) {
+  double centi = (double)celsius * 100.0;
+  centi += centi < 0 ? -0.5 : 0.5;
+  if (centi <= AGX_BINARY_TEMP_MISSING) {
+    return AGX_BINARY_TEMP_MISSING + 1;
+  }
+  if (centi >= INT16_MAX) {
+    return INT16_MAX;
+  }
+  return (int16_t)centi;
+}
+
+esp_err_t agx_monitor_binary_decode(const uint8_t *record, size_t len,
+                                    agx_monitor_data_t *data,
+                                    uint32_t *parsed) {
+  if (record == NULL || data == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (parsed != NULL) {
+    *parsed = 0;
+  }
+  memset(data, 0, sizeof(*data));
+
+  agx_reader_t r = {.p = record, .end = record + len};
+  if (!can_read(&r, AGX_BINARY_HEADER_SIZE)) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+  if (read_u8(&r) != AGX_BINARY_MAGIC || read_u8(&r) != AGX_BINARY_VERSION) {
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+  uint16_t fields = read_u16(&r);
+  uint32_t found = 0;
+
+  if (fields & AGX_BINARY_FIELD_TIMESTAMP) {
+    if (!can_read(&r, 8)) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    uint64_t low = read_u32(&r);
+    uint64_t high = read_u32(&r);
+    if (!format_time((int64_t)(low | (high << 32)), data->timestamp)) {
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+    found |= AGX_MONITOR_PARSED_TIMESTAMP;
+  }
+
+  if (fields & AGX_BINARY_FIELD_CPU) {
+    if (!can_read(&r, 1)) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    uint8_t count = read_u8(&r);
+    if (count > AGX_MONITOR_MAX_CPU_CORES) {
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+    if (!can_read(&r, (size_t)count * 3)) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    data->cpu.core_count = count;
+    for (uint8_t i = 0; i < count; i++) {
+      data->cpu.cores[i].id = i;
+      data->cpu.cores[i].usage = read_u8(&r);
+      data->cpu.cores[i].freq = read_u16(&r);
+    }
+    found |= AGX_MONITOR_PARSED_CPU;
+  }
+
+  if (fields & AGX_BINARY_FIELD_MEMORY) {
+    if (!can_read(&r, 20)) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    data->memory.ram.used = read_u32(&r);
+    data->memory.ram.total = read_u32(&r);
+    set_unit(data->memory.ram.unit, "MB");
+    data->memory.swap.used = read_u32(&r);
+    data->memory.swap.total = read_u32(&r);
+    data->memory.swap.cached = read_u32(&r);
+    set_unit(data->memory.swap.unit, "MB");
+    found |= AGX_MONITOR_PARSED_MEMORY;
+  }
+
+  if (fields & AGX_BINARY_FIELD_TEMPERATURE) {
+    if (!can_read(&r, 10)) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    bool cpu_present, present;
+    data->temperature.cpu = read_temperature(&r, &cpu_present);
+    data->temperature.soc0 = read_temperature(&r, &present);
+    data->temperature.soc1 = read_temperature(&r, &present);
+    data->temperature.soc2 = read_temperature(&r, &present);
+    data->temperature.tj = read_temperature(&r, &present);
+    found |= AGX_MONITOR_PARSED_TEMPERATURE;
+    if (cpu_present) {
+      found |= AGX_MONITOR_PARSED_CPU_TEMP;
+    }
+  }
+
+  if (fields & AGX_BINARY_FIELD_POWER) {
+    if (!can_read(&r, 40)) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    agx_power_info_t *rails[] = {&data->power.gpu_soc, &data->power.cpu_cv,
+                                 &data->power.sys_5v, &data->power.ram,
+                                 &data->power.swap};
+    for (size_t i = 0; i < sizeof(rails) / sizeof(rails[0]); i++) {
+      rails[i]->current = read_u32(&r);
+      rails[i]->average = read_u32(&r);
+      set_unit(rails[i]->unit, "mW");
+    }
+    found |= AGX_MONITOR_PARSED_POWER;
+  }
+
+  if (fields & AGX_BINARY_FIELD_GPU) {
+    if (!can_read(&r, 1)) {
+      return ESP_ERR_INVALID_SIZE;
+    }
+    data->gpu.gr3d_freq = read_u8(&r);
+    found |= AGX_MONITOR_PARSED_GPU;
+  }
+
+  // Sections of newer fields follow and are skipped; otherwise the record
+  // must end here, which catches most truncated or concatenated messages
+  if ((fields & ~AGX_BINARY_FIELDS_ALL) == 0 && r.p != r.end) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  if (parsed != NULL) {
+    *parsed = found;
+  }
+  return ESP_OK;
+}
+
+size_t agx_monitor_binary_encode(const agx_monitor_data_t *data,
+                                 uint16_t fields, uint8_t *record,
+                                 size_t size) {
+  int64_t time_us = 0;
+  fields &= AGX_BINARY_FIELDS_ALL;
+  if ((fields & AGX_BINARY_FIELD_TIMESTAMP) &&
+      !parse_time(data->timestamp, &time_us)) {
+    fields &= (uint16_t)~AGX_BINARY_FIELD_TIMESTAMP;
+  }
+  uint8_t cores = data->cpu.core_count <= AGX_MONITOR_MAX_CPU_CORES
+                      ? data->cpu.core_count
+                      : AGX_MONITOR_MAX_CPU_CORES;
+
+  size_t need = AGX_BINARY_HEADER_SIZE;
+  need += (fields & AGX_BINARY_FIELD_TIMESTAMP) ? 8 : 0;
+  need += (fields & AGX_BINARY_FIELD_CPU) ? 1 + (size_t)cores * 3 : 0;
+  need += (fields & AGX_BINARY_FIELD_MEMORY) ? 20 : 0;
+  need += (fields & AGX_BINARY_FIELD_TEMPERATURE) ? 10 : 0;
+  need += (fields & AGX_BINARY_FIELD_POWER) ? 40 : 0;
+  need += (fields & AGX_BINARY_FIELD_GPU) ? 1 : 0;
+  if (record == NULL || need > size) {
+    return 0;
+  }
+
+  uint8_t *p = record;
+  *p++ = AGX_BINARY_MAGIC;
+  *p++ = AGX_BINARY_VERSION;
+  p = put_u16(p, fields);
+
+  if (fields & AGX_BINARY_FIELD_TIMESTAMP) {
+    p = put_u32(p, (uint32_t)time_us);
+    p = put_u32(p, (uint32_t)((uint64_t)time_us >> 32));
+  }
+  if (fields & AGX_BINARY_FIELD_CPU) {
+    *p++ = cores;
+    for (uint8_t i = 0; i < cores; i++) {
+      *p++ = data->cpu.cores[i].usage;
+      p = put_u16(p, data->cpu.cores[i].freq);
+    }
+  }
+  if (fields & AGX_BINARY_FIELD_MEMORY) {
+    p = put_u32(p, data->memory.ram.used);
+    p = put_u32(p, data->memory.ram.total);
+    p = put_u32(p, data->memory.swap.used);
+    p = put_u32(p, data->memory.swap.total);
+    p = put_u32(p, data->memory.swap.cached);
+  }
+  if (fields & AGX_BINARY_FIELD_TEMPERATURE) {
+    p = put_u16(p, (uint16_t)encode_temperature(data->temperature.cpu));
+    p = put_u16(p, (uint16_t)encode_temperature(data->temperature.soc0));
+    p = put_u16(p, (uint16_t)encode_temperature(data->temperature.soc1));
+    p = put_u16(p, (uint16_t)encode_temperature(data->temperature.soc2));
+    p = put_u16(p, (uint16_t)encode_temperature(data->temperature.tj));
+  }
+  if (fields & AGX_BINARY_FIELD_POWER) {
+    const agx_power_info_t *rails[] = {
+        &data->power.gpu_soc, &data->power.cpu_cv, &data->power.sys_5v,
+        &data->power.ram, &data->power.swap};
+    for (size_t i = 0; i < sizeof(rails) / sizeof(rails[0]); i++) {
+      p = put_u32(p, rails[i]->current);
+      p = put_u32(p, rails[i]->average);
+    }
+  }
+  if (fields & AGX_BINARY_FIELD_GPU) {
+    *p++ = data->gpu.gr3d_freq;
+  }
+  return (size_t)(p - record);
+}
+
+/* ============================================================================
+ * Negotiation
+ * ============================================================================
+ */
+
+static const char *skip_space(const char *p, const char *end) {
+  while (p < end && (unsigned char)*p <= 32) {
+    p++;
+  }
+  return p;
+}
+
+/* Position after `"key":` in [p, end), NULL if the key is not there */
+static const char *find_member(const char *p, const char *end,
+                               const char *key) {
+  size_t key_len = strlen(key);
+  for (; p + key_len + 2 <= end; p++) {
+    if (*p == '"' && memcmp(p + 1, key, key_len) == 0 &&
+        p[key_len + 1] == '"') {
+      const char *v = skip_space(p + key_len + 2, end);
+      if (v < end && *v == ':') {
+        return skip_space(v + 1, end);
+      }
+    }
+  }
+  return NULL;
+}
+
+static bool read_uint(const char *p, const char *end, uint32_t *value) {
+  if (p == NULL || p >= end || *p < '0' || *p > '9') {
+    return false;
+  }
+  *value = 0;
+  for (; p < end && *p >= '0' && *p <= '9' && *value <= 0xFFFF; p++) {
+    *value = *value * 10 + (uint32_t)(*p - '0');
+  }
+  return true;
+}
+
+esp_err_t agx_monitor_binary_parse_ack(const char *frame, size_t len,
+                                       agx_binary_ack_t *ack) {
+  static const char prefix[] = "\"" AGX_BINARY_EVENT "\"";
+  if (frame == NULL || ack == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  const char *end = frame + len;
+  if (len < 3 || frame[0] != '4' || frame[1] != '2') {
+    return ESP_ERR_NOT_FOUND;
+  }
+  const char *p = skip_space(frame + 2, end);
+  if (p >= end || *p != '[') {
+    return ESP_ERR_NOT_FOUND;
+  }
+  p = skip_space(p + 1, end);
+  if ((size_t)(end - p) < sizeof(prefix) - 1 ||
+      memcmp(p, prefix, sizeof(prefix) - 1) != 0) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  p += sizeof(prefix) - 1;
+
+  const char *format = find_member(p, end, "format");
+  if (format == NULL || format >= end || *format != '"') {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  static const char binary[] = "\"binary\"";
+  memset(ack, 0, sizeof(*ack));
+  ack->binary = (size_t)(end - format) >= sizeof(binary) - 1 &&
+                memcmp(format, binary, sizeof(binary) - 1) == 0;
+
+  uint32_t value;
+  if (read_uint(find_member(p, end, "version"), end, &value) &&
+      value <= UINT8_MAX) {
+    ack->version = (uint8_t)value;
+  }
+  if (read_uint(find_member(p, end, "fields"), end, &value) &&
+      value <= UINT16_MAX) {
+    ack->fields = (uint16_t)value;
+  }
+  return ESP_OK;
+}
@@ -0,0 +1,657 @@
+/**
+ * @file agx_monitor_history.c
+ * @brief Fixed-memory time-series store for AGX metrics
+ *
+ * Block layout (little endian):
+ *
+ *   u32 base_time   time of the first record
+ *   u16 count       records in the block
+ *   record[count]   varint  time step from the previous record (0 first)
+ *                   u8[(values + 7) / 8]  bitmap of changed values
+ *                   varint  zigzag delta of each changed value
+ *
+ * Deltas are taken from the previous record of the same block, the first
+ * record from all zeros, so every block decodes on its own and dropping
+ * the oldest block needs no re-encoding.
+ *
+ * Saved file (little endian):
+ *
+ *   "AGXH" u16 version, u16 channels, u16 block_size, u16 tiers,
+ *   u32 time, u32 samples
+ *   per tier: u8 values, u8 reserved, u16 used, u16 capacity, u16 reserved,
+ *             u32 period, u32 records, u32 last_time,
+ *             used blocks, oldest first
+ *
+ * @version 1.0.0
+ * @date 2025-10-04
+ * @author robOS Team
+ */
+
+#include "agx_monitor_history.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HISTORY_FILE_MAGIC "AGXH"
+#define HISTORY_FILE_VERSION (1)
+#define HISTORY_FILE_HEADER_SIZE (20)
+#define HISTORY_TIER_HEADER_SIZE (20)
+
+#define BLOCK_HEADER_SIZE (6)
+#define MAX_VALUES (AGX_HISTORY_CHANNELS * 3)
+#define MAX_BITMAP ((MAX_VALUES + 7) / 8)
+#define VARINT_MAX (5) ///< 33-bit zigzag deltas of int32 values
+
+static const uint32_t k_tier_period[AGX_HISTORY_TIER_COUNT] = {1, 60, 600};
+
+static const char *const k_channel_names[] = {
+    [AGX_HISTORY_CH_TEMP_CPU] = "temp_cpu",
+    [AGX_HISTORY_CH_TEMP_SOC0] = "temp_soc0",
+    [AGX_HISTORY_CH_TEMP_SOC1] = "temp_soc1",
+    [AGX_HISTORY_CH_TEMP_SOC2] = "temp_soc2",
+    [AGX_HISTORY_CH_TEMP_TJ] = "temp_tj",
+    [AGX_HISTORY_CH_POWER_GPU_SOC] = "power_gpu_soc",
+    [AGX_HISTORY_CH_POWER_CPU_CV] = "power_cpu_cv",
+    [AGX_HISTORY_CH_POWER_SYS_5V] = "power_sys_5v",
+    [AGX_HISTORY_CH_GPU_LOAD] = "gpu",
+    [AGX_HISTORY_CH_RAM_USED] = "ram",
+};
+
+/* ============================================================================
+ * Encoding Helpers
+ * ============================================================================
+ */
+
+static inline void put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void put_u32(uint8_t *p, uint32_t v) {
+  put_u16(p, (uint16_t)v);
+  put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static inline uint16_t get_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t get_u32(const uint8_t *p) {
+  return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static size_t put_varint(uint8_t *p, uint64_t v) {
+  size_t n = 0;
+  while (v >= 0x80) {
+    p[n++] = (uint8_t)(v | 0x80);
+    v >>= 7;
+  }
+  p[n++] = (uint8_t)v;
+  return n;
+}
+
+static bool get_varint(const uint8_t **p, const uint8_t *end, uint64_t *v) {
+  uint64_t result = 0;
+  for (int shift = 0; shift < 7 * VARINT_MAX; shift += 7) {
+    if (*p >= end) {
+      return false;
+    }
+    uint8_t byte = *(*p)++;
+    result |= (uint64_t)(byte & 0x7f) << shift;
+    if (!(byte & 0x80)) {
+      *v = result;
+      return true;
+    }
+  }
+  return false;
+}
+
+static inline uint64_t zigzag(int64_t v) {
+  return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+}
+
+static inline int64_t unzigzag(uint64_t v) {
+  return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+}
+
+static inline int32_t clamp_i32(int64_t v) {
+  return v > INT32_MAX ? INT32_MAX : v < INT32_MIN ? INT32_MIN : (int32_t)v;
+}
+
+/* ============================================================================
+ * Block Reader
+ * ============================================================================
+ */
+
+typedef struct {
+  const uint8_t *p;
+  const uint8_t *end;
+  uint8_t values;
+  uint16_t remaining;
+  uint32_t time;
+  int32_t v[MAX_VALUES];
+} block_reader_t;
+
+static void reader_init(block_reader_t *r, const uint8_t *block,
+                        uint8_t values) {
+  r->p = block + BLOCK_HEADER_SIZE;
+  r->end = block + AGX_HISTORY_BLOCK_SIZE;
+  r->values = values;
+  r->remaining = get_u16(block + 4);
+  r->time = get_u32(block);
+  memset(r->v, 0, sizeof(r->v));
+}
+
+/**
+ * @brief Decode the next record, false at the end or on corrupt data
+ */
+static bool reader_next(block_reader_t *r) {
+  uint64_t step;
+  size_t bitmap_len = (r->values + 7u) / 8u;
+
+  if (r->remaining == 0 || !get_varint(&r->p, r->end, &step) ||
+      step > UINT32_MAX - r->time || (size_t)(r->end - r->p) < bitmap_len) {
+    return false;
+  }
+  const uint8_t *bitmap = r->p;
+  r->p += bitmap_len;
+  for (uint8_t i = 0; i < r->values; i++) {
+    if (bitmap[i / 8] & (1u << (i % 8))) {
+      uint64_t delta;
+      if (!get_varint(&r->p, r->end, &delta)) {
+        return false;
+      }
+      r->v[i] = clamp_i32((int64_t)r->v[i] + unzigzag(delta));
+    }
+  }
+  r->time += (uint32_t)step;
+  r->remaining--;
+  return true;
+}
+
+static inline uint8_t *block_at(const agx_history_series_t *s, uint16_t n) {
+  return s->blocks + (size_t)((s->head + n) % s->block_count) *
+                         AGX_HISTORY_BLOCK_SIZE;
+}
+
+/* ============================================================================
+ * Series
+ * ============================================================================
+ */
+
+static void series_clear(agx_history_series_t *s) {
+  s->head = 0;
+  s->used = 0;
+  s->fill = 0;
+  s->records = 0;
+  s->last_time = 0;
+  memset(s->last, 0, sizeof(s->last));
+}
+
+/**
+ * @brief Encode a record against base into out, returns its length
+ */
+static size_t encode_record(uint8_t *out, uint32_t step, const int32_t *base,
+                            const int32_t *values, uint8_t count) {
+  size_t bitmap_len = (count + 7u) / 8u;
+  size_t n = put_varint(out, step);
+  uint8_t *bitmap = out + n;
+
+  memset(bitmap, 0, bitmap_len);
+  n += bitmap_len;
+  for (uint8_t i = 0; i < count; i++) {
+    if (values[i] != base[i]) {
+      bitmap[i / 8] |= (uint8_t)(1u << (i % 8));
+      n += put_varint(out + n, zigzag((int64_t)values[i] - base[i]));
+    }
+  }
+  return n;
+}
+
+static void series_append(agx_history_series_t *s, uint32_t time,
+                          const int32_t *values) {
+  static const int32_t zeros[MAX_VALUES] = {0};
+  uint8_t record[VARINT_MAX + MAX_BITMAP + MAX_VALUES * VARINT_MAX];
+  size_t len = 0;
+
+  if (s->used > 0) {
+    len = encode_record(record, time - s->last_time, s->last, values,
+                        s->values);
+  }
+  if (s->used == 0 || s->fill + len > AGX_HISTORY_BLOCK_SIZE) {
+    // Start a new block, dropping the oldest one when the ring is full
+    if (s->used == s->block_count) {
+      s->records -= get_u16(block_at(s, 0) + 4);
+      s->head = (uint16_t)((s->head + 1) % s->block_count);
+      s->used--;
+    }
+    s->used++;
+    uint8_t *block = block_at(s, s->used - 1);
+    put_u32(block, time);
+    put_u16(block + 4, 0);
+    s->fill = BLOCK_HEADER_SIZE;
+    len = encode_record(record, 0, zeros, values, s->values);
+  }
+
+  uint8_t *block = block_at(s, s->used - 1);
+  memcpy(block + s->fill, record, len);
+  s->fill = (uint16_t)(s->fill + len);
+  put_u16(block + 4, (uint16_t)(get_u16(block + 4) + 1));
+  s->records++;
+  s->last_time = time;
+  memcpy(s->last, values, s->values * sizeof(int32_t));
+}
+
+/* ============================================================================
+ * Aggregation
+ * ============================================================================
+ */
+
+static inline int32_t div_round(int64_t sum, uint32_t count) {
+  return (int32_t)(sum >= 0 ? (sum + count / 2) / count
+                            : -((-sum + count / 2) / count));
+}
+
+static void bucket_flush(agx_monitor_history_t *history, int tier) {
+  agx_history_bucket_t *b = &history->buckets[tier - 1];
+  int32_t values[MAX_VALUES];
+
+  for (int ch = 0; ch < AGX_HISTORY_CHANNELS; ch++) {
+    values[ch * 3] = b->min[ch];
+    values[ch * 3 + 1] = div_round(b->sum[ch], b->count);
+    values[ch * 3 + 2] = b->max[ch];
+  }
+  series_append(&history->tiers[tier], b->bucket * k_tier_period[tier],
+                values);
+  b->count = 0;
+}
+
+static void bucket_add(agx_monitor_history_t *history, int tier, uint32_t time,
+                       const int32_t *values) {
+  agx_history_bucket_t *b = &history->buckets[tier - 1];
+  uint32_t bucket = time / k_tier_period[tier];
+
+  if (b->count > 0 && bucket != b->bucket) {
+    bucket_flush(history, tier);
+  }
+  if (b->count == 0) {
+    b->bucket = bucket;
+    for (int ch = 0; ch < AGX_HISTORY_CHANNELS; ch++) {
+      b->min[ch] = values[ch];
+      b->max[ch] = values[ch];
+      b->sum[ch] = 0;
+    }
+  }
+  for (int ch = 0; ch < AGX_HISTORY_CHANNELS; ch++) {
+    if (values[ch] < b->min[ch]) {
+      b->min[ch] = values[ch];
+    }
+    if (values[ch] > b->max[ch]) {
+      b->max[ch] = values[ch];
+    }
+    b->sum[ch] += values[ch];
+  }
+  b->count++;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+static esp_err_t history_alloc(agx_monitor_history_t *history,
+                               const uint16_t blocks[AGX_HISTORY_TIER_COUNT]) {
+  memset(history, 0, sizeof(*history));
+  for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+    agx_history_series_t *s = &history->tiers[t];
+    s->blocks = malloc((size_t)blocks[t] * AGX_HISTORY_BLOCK_SIZE);
+    if (s->blocks == NULL) {
+      agx_monitor_history_deinit(history);
+      return ESP_ERR_NO_MEM;
+    }
+    s->block_count = blocks[t];
+    s->values = t == AGX_HISTORY_TIER_RAW ? AGX_HISTORY_CHANNELS : MAX_VALUES;
+    s->period = k_tier_period[t];
+  }
+  return ESP_OK;
+}
+
+esp_err_t
+agx_monitor_history_init(agx_monitor_history_t *history,
+                         const size_t tier_bytes[AGX_HISTORY_TIER_COUNT]) {
+  uint16_t blocks[AGX_HISTORY_TIER_COUNT];
+
+  if (history == NULL || tier_bytes == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+    size_t n = tier_bytes[t] / AGX_HISTORY_BLOCK_SIZE;
+    if (n < AGX_HISTORY_MIN_BLOCKS || n > UINT16_MAX) {
+      return ESP_ERR_INVALID_ARG;
+    }
+    blocks[t] = (uint16_t)n;
+  }
+  return history_alloc(history, blocks);
+}
+
+void agx_monitor_history_deinit(agx_monitor_history_t *history) {
+  if (history == NULL) {
+    return;
+  }
+  for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+    free(history->tiers[t].blocks);
+  }
+  memset(history, 0, sizeof(*history));
+}
+
+void agx_monitor_history_clear(agx_monitor_history_t *history) {
+  for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+    series_clear(&history->tiers[t]);
+  }
+  memset(history->buckets, 0, sizeof(history->buckets));
+  history->samples = 0;
+}
+
+void agx_monitor_history_sample(const agx_monitor_data_t *data,
+                                int32_t values[AGX_HISTORY_CHANNELS]) {
+  memset(values, 0, AGX_HISTORY_CHANNELS * sizeof(int32_t));
+  for (int i = 0; i < data->cpu.core_count && i < AGX_MONITOR_MAX_CPU_CORES;
+       i++) {
+    values[AGX_HISTORY_CH_CPU_USAGE + i] = data->cpu.cores[i].usage;
+  }
+
+  const float temps[] = {data->temperature.cpu, data->temperature.soc0,
+                         data->temperature.soc1, data->temperature.soc2,
+                         data->temperature.tj};
+  for (int i = 0; i < 5; i++) {
+    float centi = temps[i] * 100.0f;
+    if (centi >= (float)INT32_MAX) {
+      values[AGX_HISTORY_CH_TEMP_CPU + i] = INT32_MAX;
+    } else if (centi <= (float)INT32_MIN) {
+      values[AGX_HISTORY_CH_TEMP_CPU + i] = INT32_MIN;
+    } else if (centi == centi) { // NaN stays 0
+      values[AGX_HISTORY_CH_TEMP_CPU + i] =
+          (int32_t)(centi + (centi >= 0 ? 0.5f : -0.5f));
+    }
+  }
+
+  values[AGX_HISTORY_CH_POWER_GPU_SOC] =
+      clamp_i32(data->power.gpu_soc.current);
+  values[AGX_HISTORY_CH_POWER_CPU_CV] = clamp_i32(data->power.cpu_cv.current);
+  values[AGX_HISTORY_CH_POWER_SYS_5V] = clamp_i32(data->power.sys_5v.current);
+  values[AGX_HISTORY_CH_GPU_LOAD] = data->gpu.gr3d_freq;
+  values[AGX_HISTORY_CH_RAM_USED] = clamp_i32(data->memory.ram.used);
+}
+
+esp_err_t agx_monitor_history_add(agx_monitor_history_t *history, uint32_t time,
+                                  const int32_t values[AGX_HISTORY_CHANNELS]) {
+  if (history == NULL || values == NULL ||
+      history->tiers[AGX_HISTORY_TIER_RAW].blocks == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  agx_history_series_t *raw = &history->tiers[AGX_HISTORY_TIER_RAW];
+  if (raw->records > 0 && time <= raw->last_time) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  series_append(raw, time, values);
+  for (int t = AGX_HISTORY_TIER_1MIN; t < AGX_HISTORY_TIER_COUNT; t++) {
+    bucket_add(history, t, time, values);
+  }
+  history->samples++;
+  return ESP_OK;
+}
+
+size_t agx_monitor_history_query(const agx_monitor_history_t *history,
+                                 agx_history_tier_t tier,
+                                 agx_history_channel_t channel, uint32_t since,
+                                 agx_history_point_t *points,
+                                 size_t max_points) {
+  if (history == NULL || points == NULL || max_points == 0 ||
+      tier >= AGX_HISTORY_TIER_COUNT || channel >= AGX_HISTORY_CHANNELS) {
+    return 0;
+  }
+
+  const agx_history_series_t *s = &history->tiers[tier];
+  block_reader_t r;
+  size_t matching = 0;
+
+  // First pass counts matches so only the newest max_points are kept
+  for (uint16_t b = 0; b < s->used; b++) {
+    reader_init(&r, block_at(s, b), s->values);
+    while (reader_next(&r)) {
+      matching += r.time >= since;
+    }
+  }
+
+  size_t skip = matching > max_points ? matching - max_points : 0;
+  size_t n = 0;
+  for (uint16_t b = 0; b < s->used && n < max_points; b++) {
+    reader_init(&r, block_at(s, b), s->values);
+    while (reader_next(&r) && n < max_points) {
+      if (r.time < since) {
+        continue;
+      }
+      if (skip > 0) {
+        skip--;
+        continue;
+      }
+      agx_history_point_t *pt = &points[n++];
+      pt->time = r.time;
+      if (tier == AGX_HISTORY_TIER_RAW) {
+        pt->min = pt->avg = pt->max = r.v[channel];
+      } else {
+        pt->min = r.v[channel * 3];
+        pt->avg = r.v[channel * 3 + 1];
+        pt->max = r.v[channel * 3 + 2];
+      }
+    }
+  }
+  return n;
+}
+
+void agx_monitor_history_get_stats(const agx_monitor_history_t *history,
+                                   agx_history_tier_t tier,
+                                   agx_history_tier_stats_t *stats) {
+  memset(stats, 0, sizeof(*stats));
+  if (history == NULL || tier >= AGX_HISTORY_TIER_COUNT) {
+    return;
+  }
+
+  const agx_history_series_t *s = &history->tiers[tier];
+  stats->records = s->records;
+  stats->capacity = (uint32_t)s->block_count * AGX_HISTORY_BLOCK_SIZE;
+  if (s->used > 0) {
+    stats->bytes_used =
+        (uint32_t)(s->used - 1) * AGX_HISTORY_BLOCK_SIZE + s->fill;
+    stats->oldest_time = get_u32(block_at(s, 0));
+    stats->newest_time = s->last_time;
+  }
+}
+
+const char *agx_monitor_history_channel_name(agx_history_channel_t channel,
+                                             char *buf, size_t size) {
+  if (channel < AGX_HISTORY_CH_TEMP_CPU) {
+    snprintf(buf, size, "cpu%d", (int)channel);
+  } else if (channel < AGX_HISTORY_CHANNELS) {
+    snprintf(buf, size, "%s", k_channel_names[channel]);
+  } else {
+    snprintf(buf, size, "?");
+  }
+  return buf;
+}
+
+esp_err_t
+agx_monitor_history_channel_from_name(const char *name,
+                                      agx_history_channel_t *channel) {
+  char buf[16];
+  for (int ch = 0; ch < AGX_HISTORY_CHANNELS; ch++) {
+    if (strcmp(name, agx_monitor_history_channel_name(
+                         (agx_history_channel_t)ch, buf, sizeof(buf))) == 0) {
+      *channel = (agx_history_channel_t)ch;
+      return ESP_OK;
+    }
+  }
+  return ESP_ERR_NOT_FOUND;
+}
+
+int agx_monitor_history_channel_scale(agx_history_channel_t channel) {
+  return (channel >= AGX_HISTORY_CH_TEMP_CPU &&
+          channel <= AGX_HISTORY_CH_TEMP_TJ)
+             ? 100
+             : 1;
+}
+
+/* ============================================================================
+ * File Format
+ * ============================================================================
+ */
+
+esp_err_t agx_monitor_history_save(const agx_monitor_history_t *history,
+                                   const char *path, uint32_t time) {
+  uint8_t header[HISTORY_FILE_HEADER_SIZE];
+  bool ok = true;
+
+  if (history == NULL || path == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  FILE *f = fopen(path, "wb");
+  if (f == NULL) {
+    return ESP_FAIL;
+  }
+
+  memcpy(header, HISTORY_FILE_MAGIC, 4);
+  put_u16(header + 4, HISTORY_FILE_VERSION);
+  put_u16(header + 6, AGX_HISTORY_CHANNELS);
+  put_u16(header + 8, AGX_HISTORY_BLOCK_SIZE);
+  put_u16(header + 10, AGX_HISTORY_TIER_COUNT);
+  put_u32(header + 12, time);
+  put_u32(header + 16, history->samples);
+  ok = fwrite(header, sizeof(header), 1, f) == 1;
+
+  for (int t = 0; t < AGX_HISTORY_TIER_COUNT && ok; t++) {
+    const agx_history_series_t *s = &history->tiers[t];
+    uint8_t tier[HISTORY_TIER_HEADER_SIZE] = {0};
+    tier[0] = s->values;
+    put_u16(tier + 2, s->used);
+    put_u16(tier + 4, s->block_count);
+    put_u32(tier + 8, s->period);
+    put_u32(tier + 12, s->records);
+    put_u32(tier + 16, s->last_time);
+    ok = fwrite(tier, sizeof(tier), 1, f) == 1;
+    for (uint16_t b = 0; b < s->used && ok; b++) {
+      ok = fwrite(block_at(s, b), AGX_HISTORY_BLOCK_SIZE, 1, f) == 1;
+    }
+  }
+
+  if (fclose(f) != 0) {
+    ok = false;
+  }
+  return ok ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t agx_monitor_history_load(agx_monitor_history_t *history,
+                                   const char *path, uint32_t *time) {
+  uint8_t header[HISTORY_FILE_HEADER_SIZE];
+  uint8_t tiers[AGX_HISTORY_TIER_COUNT][HISTORY_TIER_HEADER_SIZE];
+  uint16_t blocks[AGX_HISTORY_TIER_COUNT];
+  esp_err_t ret = ESP_OK;
+
+  if (history == NULL || path == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  memset(history, 0, sizeof(*history));
+
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  if (fread(header, sizeof(header), 1, f) != 1 ||
+      memcmp(header, HISTORY_FILE_MAGIC, 4) != 0 ||
+      get_u16(header + 4) != HISTORY_FILE_VERSION ||
+      get_u16(header + 6) != AGX_HISTORY_CHANNELS ||
+      get_u16(header + 8) != AGX_HISTORY_BLOCK_SIZE ||
+      get_u16(header + 10) != AGX_HISTORY_TIER_COUNT) {
+    ret = ESP_ERR_INVALID_VERSION;
+    goto cleanup;
+  }
+
+  // Tier headers are interleaved with the blocks: read all headers first to
+  // size the allocation, then rewind to the first block
+  long offset = HISTORY_FILE_HEADER_SIZE;
+  for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+    if (fseek(f, offset, SEEK_SET) != 0 ||
+        fread(tiers[t], HISTORY_TIER_HEADER_SIZE, 1, f) != 1) {
+      ret = ESP_ERR_INVALID_SIZE;
+      goto cleanup;
+    }
+    uint16_t used = get_u16(tiers[t] + 2);
+    uint16_t capacity = get_u16(tiers[t] + 4);
+    uint8_t values =
+        t == AGX_HISTORY_TIER_RAW ? AGX_HISTORY_CHANNELS : MAX_VALUES;
+    if (tiers[t][0] != values || get_u32(tiers[t] + 8) != k_tier_period[t] ||
+        used > capacity) {
+      ret = ESP_ERR_INVALID_SIZE;
+      goto cleanup;
+    }
+    blocks[t] = capacity < AGX_HISTORY_MIN_BLOCKS ? AGX_HISTORY_MIN_BLOCKS
+                                                  : capacity;
+    offset += HISTORY_TIER_HEADER_SIZE + (long)used * AGX_HISTORY_BLOCK_SIZE;
+  }
+
+  ret = history_alloc(history, blocks);
+  if (ret != ESP_OK) {
+    goto cleanup;
+  }
+  history->samples = get_u32(header + 16);
+
+  offset = HISTORY_FILE_HEADER_SIZE;
+  for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+    agx_history_series_t *s = &history->tiers[t];
+    uint16_t used = get_u16(tiers[t] + 2);
+
+    offset += HISTORY_TIER_HEADER_SIZE;
+    if (fseek(f, offset, SEEK_SET) != 0 ||
+        (used > 0 &&
+         fread(s->blocks, AGX_HISTORY_BLOCK_SIZE, used, f) != used)) {
+      ret = ESP_ERR_INVALID_SIZE;
+      goto cleanup;
+    }
+    offset += (long)used * AGX_HISTORY_BLOCK_SIZE;
+
+    // Rebuild the append state from the blocks rather than trusting the
+    // header, and stop at the first corrupt record
+    uint32_t records = 0;
+    for (uint16_t b = 0; b < used; b++) {
+      block_reader_t r;
+      reader_init(&r, block_at(s, b), s->values);
+      uint16_t count = 0;
+      while (reader_next(&r)) {
+        count++;
+      }
+      put_u16(s->blocks + (size_t)b * AGX_HISTORY_BLOCK_SIZE + 4, count);
+      records += count;
+      s->used = (uint16_t)(b + 1);
+      s->fill = (uint16_t)(r.p - block_at(s, b));
+      s->last_time = r.time;
+      memcpy(s->last, r.v, sizeof(s->last));
+    }
+    s->records = records;
+  }
+
+  if (time != NULL) {
+    *time = get_u32(header + 12);
+  }
+
+cleanup:
+  fclose(f);
+  if (ret != ESP_OK) {
+    agx_monitor_history_deinit(history);
+  }
+  return ret;
+}
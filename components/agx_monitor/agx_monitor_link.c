@@ -0,0 +1,307 @@
+/**
+ * @file agx_monitor_link.c
+ * @brief Connection state machine for the AGX WebSocket link
+ *
+ * @version 1.0.0
+ * @date 2025-10-04
+ * @author robOS Team
+ */
+
+#include "agx_monitor_link.h"
+
+#include <string.h>
+
+#define NO_DEADLINE UINT64_MAX
+
+static const char *const k_state_names[AGX_LINK_STATE_COUNT] = {
+    "STOPPED", "STARTUP", "CONNECTING", "HANDSHAKE",
+    "ONLINE",  "BACKOFF", "NO_LINK",
+};
+
+static const char *const k_event_names[AGX_LINK_EVENT_COUNT] = {
+    "START",           "STOP", "TIMER",   "WS_CONNECTED",
+    "WS_DISCONNECTED", "WS_ERROR", "DATA", "LINK_UP",
+    "LINK_DOWN",
+};
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================
+ */
+
+static inline bool client_active(agx_link_state_t state) {
+  return state == AGX_LINK_STATE_CONNECTING ||
+         state == AGX_LINK_STATE_HANDSHAKE || state == AGX_LINK_STATE_ONLINE;
+}
+
+static inline uint32_t clamp_ms(uint64_t ms) {
+  return ms > UINT32_MAX ? UINT32_MAX : (uint32_t)ms;
+}
+
+static uint32_t next_random(agx_monitor_link_t *link) {
+  // xorshift32: cheap and good enough to spread retries
+  uint32_t x = link->rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  link->rng = x;
+  return x;
+}
+
+/**
+ * @brief Delay before the next attempt after link->failures failures
+ */
+static uint32_t retry_delay(agx_monitor_link_t *link) {
+  const agx_link_config_t *c = &link->config;
+  uint64_t base;
+
+  if (link->failures <= c->fast_retry_count) {
+    base = c->fast_retry_interval_ms;
+  } else {
+    base = c->backoff_initial_ms;
+    for (uint32_t n = link->failures - c->fast_retry_count - 1;
+         n > 0 && base < c->backoff_max_ms; n--) {
+      base *= 2;
+    }
+    if (base > c->backoff_max_ms) {
+      base = c->backoff_max_ms;
+    }
+  }
+
+  uint64_t jitter = base * c->jitter_percent / 100;
+  if (jitter > 0) {
+    base -= next_random(link) % (jitter + 1);
+  }
+  return (uint32_t)base;
+}
+
+static uint32_t connect_now(agx_monitor_link_t *link, uint64_t now_ms) {
+  link->state = AGX_LINK_STATE_CONNECTING;
+  link->deadline_ms = now_ms + link->config.connect_timeout_ms;
+  link->stats.attempts++;
+  return AGX_LINK_ACTION_CONNECT;
+}
+
+/**
+ * @brief Schedule the next attempt after a failure
+ */
+static uint32_t retry(agx_monitor_link_t *link, uint64_t now_ms) {
+  link->failures++;
+  uint32_t delay = retry_delay(link);
+  if (delay == 0) {
+    return connect_now(link, now_ms);
+  }
+  link->state = AGX_LINK_STATE_BACKOFF;
+  link->deadline_ms = now_ms + delay;
+  return AGX_LINK_ACTION_NONE;
+}
+
+/**
+ * @brief Start an outage: remember when data stopped for the metrics
+ */
+static void begin_outage(agx_monitor_link_t *link, uint64_t now_ms) {
+  if (link->lost_ms == 0) {
+    link->lost_ms = now_ms;
+    link->lost_data_ms = link->data_ms;
+  }
+}
+
+/**
+ * @brief Leave ONLINE after a disconnect or missing data
+ *
+ * A connection that was stable is retried at once: the server was up a
+ * moment ago, so the first attempt is the most likely to succeed.
+ */
+static uint32_t lose(agx_monitor_link_t *link, uint64_t now_ms) {
+  begin_outage(link, now_ms);
+  if (now_ms - link->online_ms >= link->config.stable_ms) {
+    link->failures = 0;
+    return AGX_LINK_ACTION_INVALIDATE | connect_now(link, now_ms);
+  }
+  return AGX_LINK_ACTION_INVALIDATE | retry(link, now_ms);
+}
+
+static uint32_t fail_attempt(agx_monitor_link_t *link, uint64_t now_ms) {
+  link->stats.failures++;
+  return retry(link, now_ms);
+}
+
+static uint32_t go_online(agx_monitor_link_t *link, uint64_t now_ms) {
+  agx_link_stats_t *s = &link->stats;
+
+  if (link->lost_ms != 0) {
+    uint32_t outage = clamp_ms(now_ms - link->lost_ms);
+    uint32_t gap = clamp_ms(now_ms - link->lost_data_ms);
+    s->reconnects++;
+    s->last_reconnect_ms = outage;
+    s->total_reconnect_ms += outage;
+    if (outage > s->max_reconnect_ms) {
+      s->max_reconnect_ms = outage;
+    }
+    s->last_gap_ms = gap;
+    s->total_gap_ms += gap;
+    if (gap > s->max_gap_ms) {
+      s->max_gap_ms = gap;
+    }
+    link->lost_ms = 0;
+  }
+  link->state = AGX_LINK_STATE_ONLINE;
+  link->online_ms = now_ms;
+  return AGX_LINK_ACTION_NONE;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+void agx_monitor_link_init(agx_monitor_link_t *link,
+                           const agx_link_config_t *config, uint32_t seed) {
+  memset(link, 0, sizeof(*link));
+  link->config = *config;
+  if (link->config.jitter_percent > 100) {
+    link->config.jitter_percent = 100;
+  }
+  link->state = AGX_LINK_STATE_STOPPED;
+  link->deadline_ms = NO_DEADLINE;
+  link->rng = seed != 0 ? seed : 0x9e3779b9u;
+  link->link_up = true;
+}
+
+uint32_t agx_monitor_link_handle(agx_monitor_link_t *link,
+                                 agx_link_event_t event, uint64_t now_ms) {
+  agx_link_state_t state = link->state;
+  uint32_t actions = AGX_LINK_ACTION_NONE;
+
+  // Keep the outage start distinct from "no outage"
+  if (now_ms == 0) {
+    now_ms = 1;
+  }
+
+  switch (event) {
+  case AGX_LINK_EVENT_START:
+    if (state != AGX_LINK_STATE_STOPPED) {
+      break;
+    }
+    link->failures = 0;
+    if (!link->link_up) {
+      link->state = AGX_LINK_STATE_NO_LINK;
+    } else if (link->config.startup_delay_ms > 0) {
+      link->state = AGX_LINK_STATE_STARTUP;
+      link->deadline_ms = now_ms + link->config.startup_delay_ms;
+    } else {
+      actions = connect_now(link, now_ms);
+    }
+    break;
+
+  case AGX_LINK_EVENT_STOP:
+    if (state == AGX_LINK_STATE_STOPPED) {
+      break;
+    }
+    actions = AGX_LINK_ACTION_INVALIDATE;
+    if (client_active(state)) {
+      actions |= AGX_LINK_ACTION_DISCONNECT;
+    }
+    link->state = AGX_LINK_STATE_STOPPED;
+    link->deadline_ms = NO_DEADLINE;
+    link->lost_ms = 0;
+    break;
+
+  case AGX_LINK_EVENT_TIMER:
+    if (now_ms < link->deadline_ms) {
+      break;
+    }
+    link->deadline_ms = NO_DEADLINE;
+    if (state == AGX_LINK_STATE_STARTUP || state == AGX_LINK_STATE_BACKOFF) {
+      actions = connect_now(link, now_ms);
+    } else if (state == AGX_LINK_STATE_CONNECTING ||
+               state == AGX_LINK_STATE_HANDSHAKE) {
+      link->stats.connect_timeouts++;
+      actions = AGX_LINK_ACTION_DISCONNECT | fail_attempt(link, now_ms);
+    } else if (state == AGX_LINK_STATE_ONLINE) {
+      link->stats.liveness_timeouts++;
+      actions = AGX_LINK_ACTION_DISCONNECT | lose(link, now_ms);
+    }
+    break;
+
+  case AGX_LINK_EVENT_WS_CONNECTED:
+    if (state == AGX_LINK_STATE_CONNECTING) {
+      link->state = AGX_LINK_STATE_HANDSHAKE;
+    }
+    break;
+
+  case AGX_LINK_EVENT_WS_DISCONNECTED:
+  case AGX_LINK_EVENT_WS_ERROR:
+    // Events from a client that was already stopped are ignored
+    if (state == AGX_LINK_STATE_CONNECTING ||
+        state == AGX_LINK_STATE_HANDSHAKE) {
+      actions = AGX_LINK_ACTION_DISCONNECT | fail_attempt(link, now_ms);
+    } else if (state == AGX_LINK_STATE_ONLINE) {
+      actions = AGX_LINK_ACTION_DISCONNECT | lose(link, now_ms);
+    }
+    break;
+
+  case AGX_LINK_EVENT_DATA:
+    if (state == AGX_LINK_STATE_CONNECTING ||
+        state == AGX_LINK_STATE_HANDSHAKE) {
+      actions = go_online(link, now_ms);
+    } else if (state != AGX_LINK_STATE_ONLINE) {
+      break;
+    }
+    link->data_ms = now_ms;
+    link->deadline_ms = now_ms + link->config.liveness_timeout_ms;
+    break;
+
+  case AGX_LINK_EVENT_LINK_UP:
+    link->link_up = true;
+    // Skip whatever delay is pending: the AGX has just become reachable
+    if (state == AGX_LINK_STATE_STARTUP || state == AGX_LINK_STATE_BACKOFF ||
+        state == AGX_LINK_STATE_NO_LINK) {
+      link->failures = 0;
+      actions = connect_now(link, now_ms);
+    }
+    break;
+
+  case AGX_LINK_EVENT_LINK_DOWN:
+    link->link_up = false;
+    if (state == AGX_LINK_STATE_STOPPED || state == AGX_LINK_STATE_NO_LINK) {
+      break;
+    }
+    link->stats.link_losses++;
+    if (client_active(state)) {
+      actions = AGX_LINK_ACTION_DISCONNECT;
+    }
+    if (state == AGX_LINK_STATE_ONLINE) {
+      begin_outage(link, now_ms);
+      actions |= AGX_LINK_ACTION_INVALIDATE;
+    }
+    link->state = AGX_LINK_STATE_NO_LINK;
+    link->deadline_ms = NO_DEADLINE;
+    break;
+
+  default:
+    break;
+  }
+  return actions;
+}
+
+uint32_t agx_monitor_link_timeout(const agx_monitor_link_t *link,
+                                  uint64_t now_ms) {
+  if (link->deadline_ms == NO_DEADLINE) {
+    return AGX_LINK_NO_TIMEOUT;
+  }
+  if (now_ms >= link->deadline_ms) {
+    return 0;
+  }
+  uint64_t remaining = link->deadline_ms - now_ms;
+  return remaining >= AGX_LINK_NO_TIMEOUT ? AGX_LINK_NO_TIMEOUT - 1
+                                          : (uint32_t)remaining;
+}
+
+const char *agx_monitor_link_state_name(agx_link_state_t state) {
+  return state < AGX_LINK_STATE_COUNT ? k_state_names[state] : "UNKNOWN";
+}
+
+const char *agx_monitor_link_event_name(agx_link_event_t event) {
+  return event < AGX_LINK_EVENT_COUNT ? k_event_names[event] : "UNKNOWN";
+}
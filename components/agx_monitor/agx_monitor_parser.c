@@ -0,0 +1,960 @@
+/**
+ * @file agx_monitor_parser.c
+ * @brief Allocation-free parser for tegrastats_update Socket.IO frames
+ *
+ * A cursor walks the frame once. Known members are decoded directly into
+ * the output structure, everything else is validated and skipped. The
+ * grammar mirrors cJSON (whitespace is any byte <= 32, numbers are
+ * whatever strtod accepts from the cJSON number alphabet, string escapes
+ * are decoded the same way) so both parsers accept the same frames.
+ *
+ * @version 1.0.0
+ * @date 2025-10-04
+ * @author robOS Team
+ */
+
+#include "agx_monitor_parser.h"
+
+#include <limits.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define AGX_EVENT_NAME "tegrastats_update"
+#define AGX_EVENT_NAME_LENGTH (sizeof(AGX_EVENT_NAME) - 1)
+
+#define AGX_KEY_MAX_LENGTH (16) ///< Longer keys are never known keys
+#define AGX_NUMBER_MAX_LENGTH (63) ///< cJSON copies at most 63 number chars
+#define AGX_NUMBER_MAX_DIGITS (19) ///< Significant digits kept in uint64_t
+
+#define KEY_END (-1)
+#define KEY_ERROR (-2)
+#define KEY_UNKNOWN (-3)
+
+/**
+ * @brief Parser state
+ */
+typedef struct {
+  const char *p;            ///< Current position
+  const char *end;          ///< End of frame
+  agx_monitor_data_t *data; ///< Output data
+  uint32_t parsed;          ///< agx_monitor_parsed_t bits
+  bool schema_error;        ///< "cpu" present without a "cores" array
+} agx_parser_t;
+
+/**
+ * @brief Number as cJSON stores it
+ */
+typedef struct {
+  double value;
+  int valueint;
+} agx_number_t;
+
+static const double k_pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,
+                                 1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                 1e12, 1e13, 1e14, 1e15, 1e16, 1e17,
+                                 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/* ============================================================================
+ * Lexical Helpers
+ * ============================================================================
+ */
+
+static inline void skip_ws(agx_parser_t *ps) {
+  while (ps->p < ps->end && (unsigned char)*ps->p <= 32) {
+    ps->p++;
+  }
+}
+
+static inline int peek(const agx_parser_t *ps) {
+  return ps->p < ps->end ? (unsigned char)*ps->p : -1;
+}
+
+static inline bool is_digit(int ch) { return ch >= '0' && ch <= '9'; }
+
+static inline char ascii_lower(char ch) {
+  return (ch >= 'A' && ch <= 'Z') ? (char)(ch - 'A' + 'a') : ch;
+}
+
+static bool key_equal(const char *key, const char *name) {
+  for (; ascii_lower(*key) == ascii_lower(*name); key++, name++) {
+    if (*key == '\0') {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Invalid digits decode as 0, as in cJSON */
+static uint32_t parse_hex4(const char *in) {
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    char ch = in[i];
+    value <<= 4;
+    if (ch >= '0' && ch <= '9') {
+      value |= (uint32_t)(ch - '0');
+    } else if (ch >= 'a' && ch <= 'f') {
+      value |= (uint32_t)(ch - 'a' + 10);
+    } else if (ch >= 'A' && ch <= 'F') {
+      value |= (uint32_t)(ch - 'A' + 10);
+    } else {
+      return 0;
+    }
+  }
+  return value;
+}
+
+/**
+ * @brief Append a decoded byte with strncpy semantics
+ *
+ * Stops at the first NUL byte and keeps room for the terminator that the
+ * (pre-cleared) output already holds.
+ */
+static inline void emit_byte(char *out, size_t out_size, size_t *length,
+                             bool *stopped, char ch) {
+  if (*stopped) {
+    return;
+  }
+  if (ch == '\0') {
+    *stopped = true;
+    return;
+  }
+  if (out != NULL && *length + 1 < out_size) {
+    out[*length] = ch;
+  }
+  (*length)++;
+}
+
+/**
+ * @brief Parse a string at the cursor
+ *
+ * @param out Output buffer (may be NULL to skip), must be zero-filled
+ * @param out_size Size of @p out
+ * @param length Optional output, decoded length up to the first NUL byte
+ */
+static bool parse_string(agx_parser_t *ps, char *out, size_t out_size,
+                         size_t *length) {
+  // Find the closing quote first, exactly like cJSON does
+  const char *start = ps->p + 1;
+  const char *close = start;
+  while (close < ps->end && *close != '"') {
+    if (*close == '\\') {
+      if (close + 1 >= ps->end) {
+        return false;
+      }
+      close++;
+    }
+    close++;
+  }
+  if (close >= ps->end) {
+    return false;
+  }
+
+  size_t n = 0;
+  bool stopped = false;
+  const char *in = start;
+  while (in < close) {
+    if (*in != '\\') {
+      emit_byte(out, out_size, &n, &stopped, *in++);
+      continue;
+    }
+
+    switch (in[1]) {
+    case 'b':
+      emit_byte(out, out_size, &n, &stopped, '\b');
+      break;
+    case 'f':
+      emit_byte(out, out_size, &n, &stopped, '\f');
+      break;
+    case 'n':
+      emit_byte(out, out_size, &n, &stopped, '\n');
+      break;
+    case 'r':
+      emit_byte(out, out_size, &n, &stopped, '\r');
+      break;
+    case 't':
+      emit_byte(out, out_size, &n, &stopped, '\t');
+      break;
+    case '"':
+    case '\\':
+    case '/':
+      emit_byte(out, out_size, &n, &stopped, in[1]);
+      break;
+    case 'u': {
+      if (close - in < 6) {
+        return false;
+      }
+      uint32_t code = parse_hex4(in + 2);
+      if (code >= 0xDC00 && code <= 0xDFFF) {
+        return false;
+      }
+      if (code >= 0xD800 && code <= 0xDBFF) {
+        const char *low = in + 6;
+        if (close - low < 6 || low[0] != '\\' || low[1] != 'u') {
+          return false;
+        }
+        uint32_t low_code = parse_hex4(low + 2);
+        if (low_code < 0xDC00 || low_code > 0xDFFF) {
+          return false;
+        }
+        code = 0x10000 + (((code & 0x3FF) << 10) | (low_code & 0x3FF));
+        in += 6;
+      }
+
+      // UTF-8 encode
+      if (code < 0x80) {
+        emit_byte(out, out_size, &n, &stopped, (char)code);
+      } else if (code < 0x800) {
+        emit_byte(out, out_size, &n, &stopped, (char)(0xC0 | (code >> 6)));
+        emit_byte(out, out_size, &n, &stopped, (char)(0x80 | (code & 0x3F)));
+      } else if (code < 0x10000) {
+        emit_byte(out, out_size, &n, &stopped, (char)(0xE0 | (code >> 12)));
+        emit_byte(out, out_size, &n, &stopped,
+                  (char)(0x80 | ((code >> 6) & 0x3F)));
+        emit_byte(out, out_size, &n, &stopped, (char)(0x80 | (code & 0x3F)));
+      } else {
+        emit_byte(out, out_size, &n, &stopped, (char)(0xF0 | (code >> 18)));
+        emit_byte(out, out_size, &n, &stopped,
+                  (char)(0x80 | ((code >> 12) & 0x3F)));
+        emit_byte(out, out_size, &n, &stopped,
+                  (char)(0x80 | ((code >> 6) & 0x3F)));
+        emit_byte(out, out_size, &n, &stopped, (char)(0x80 | (code & 0x3F)));
+      }
+      in += 4;
+      break;
+    }
+    default:
+      return false;
+    }
+    in += 2;
+  }
+
+  if (length != NULL) {
+    *length = n;
+  }
+  ps->p = close + 1;
+  return true;
+}
+
+/**
+ * @brief Parse a number at the cursor (first char is '-' or a digit)
+ *
+ * Accepts what strtod accepts from the first 63 characters of the cJSON
+ * number alphabet. Values with up to 15 significant digits and decimal
+ * exponents within +-22 are converted exactly (correctly rounded), which
+ * covers everything tegrastats sends.
+ */
+static bool parse_number(agx_parser_t *ps, agx_number_t *number) {
+  const char *p = ps->p;
+  const char *end = ps->end;
+  if (end - p > AGX_NUMBER_MAX_LENGTH) {
+    end = p + AGX_NUMBER_MAX_LENGTH;
+  }
+
+  bool negative = false;
+  if (p < end && *p == '-') {
+    negative = true;
+    p++;
+  }
+
+  uint64_t mantissa = 0;
+  int digits = 0;
+  int exponent = 0;
+  bool any_digit = false;
+
+  while (p < end && is_digit(*p)) {
+    if (digits < AGX_NUMBER_MAX_DIGITS) {
+      mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+      if (mantissa != 0) {
+        digits++;
+      }
+    } else {
+      exponent++;
+    }
+    any_digit = true;
+    p++;
+  }
+  if (p < end && *p == '.') {
+    const char *dot = p++;
+    bool frac_digit = false;
+    while (p < end && is_digit(*p)) {
+      if (digits < AGX_NUMBER_MAX_DIGITS) {
+        mantissa = mantissa * 10 + (uint64_t)(*p - '0');
+        exponent--;
+        if (mantissa != 0) {
+          digits++;
+        }
+      }
+      frac_digit = true;
+      p++;
+    }
+    if (!any_digit && !frac_digit) {
+      p = dot;
+    }
+    any_digit = any_digit || frac_digit;
+  }
+  if (!any_digit) {
+    return false;
+  }
+
+  if (p < end && (*p == 'e' || *p == 'E')) {
+    const char *q = p + 1;
+    bool exp_negative = false;
+    if (q < end && (*q == '-' || *q == '+')) {
+      exp_negative = (*q == '-');
+      q++;
+    }
+    if (q < end && is_digit(*q)) {
+      int exp_value = 0;
+      while (q < end && is_digit(*q)) {
+        if (exp_value < 100000) {
+          exp_value = exp_value * 10 + (*q - '0');
+        }
+        q++;
+      }
+      exponent += exp_negative ? -exp_value : exp_value;
+      p = q;
+    }
+  }
+
+  double value = (double)mantissa;
+  if (mantissa != 0) {
+    if (exponent >= 0) {
+      while (exponent > 22 && value < 1e308) {
+        value *= 1e22;
+        exponent -= 22;
+      }
+      value *= k_pow10[exponent > 22 ? 22 : exponent];
+    } else {
+      while (exponent < -22 && value > 0.0) {
+        value /= 1e22;
+        exponent += 22;
+      }
+      value /= k_pow10[exponent < -22 ? 22 : -exponent];
+    }
+  }
+  if (negative) {
+    value = -value;
+  }
+
+  number->value = value;
+  if (value >= INT_MAX) {
+    number->valueint = INT_MAX;
+  } else if (value <= (double)INT_MIN) {
+    number->valueint = INT_MIN;
+  } else {
+    number->valueint = (int)value;
+  }
+  ps->p = p;
+  return true;
+}
+
+static bool parse_literal(agx_parser_t *ps, const char *literal, size_t len) {
+  if ((size_t)(ps->end - ps->p) < len || memcmp(ps->p, literal, len) != 0) {
+    return false;
+  }
+  ps->p += len;
+  return true;
+}
+
+/* ============================================================================
+ * Structural Helpers
+ * ============================================================================
+ */
+
+/**
+ * @brief Advance to the next member of an object
+ *
+ * The opening brace must already be consumed. On return the cursor is at
+ * the member value.
+ *
+ * @return Index into @p keys, KEY_UNKNOWN, KEY_END or KEY_ERROR. Repeated
+ *         keys are reported as KEY_UNKNOWN so the first occurrence wins.
+ */
+static int object_next(agx_parser_t *ps, bool *first, const char *const *keys,
+                       int key_count, uint32_t *seen) {
+  skip_ws(ps);
+  if (ps->p >= ps->end) {
+    return KEY_ERROR;
+  }
+  if (*ps->p == '}') {
+    ps->p++;
+    return KEY_END;
+  }
+  if (!*first) {
+    if (*ps->p != ',') {
+      return KEY_ERROR;
+    }
+    ps->p++;
+    skip_ws(ps);
+  }
+  *first = false;
+
+  if (peek(ps) != '"') {
+    return KEY_ERROR;
+  }
+  char key[AGX_KEY_MAX_LENGTH] = {0};
+  size_t key_length = 0;
+  if (!parse_string(ps, key, sizeof(key), &key_length)) {
+    return KEY_ERROR;
+  }
+  skip_ws(ps);
+  if (peek(ps) != ':') {
+    return KEY_ERROR;
+  }
+  ps->p++;
+  skip_ws(ps);
+  if (ps->p >= ps->end) {
+    return KEY_ERROR;
+  }
+
+  if (key_length >= sizeof(key)) {
+    return KEY_UNKNOWN;
+  }
+  for (int i = 0; i < key_count; i++) {
+    if (key_equal(key, keys[i])) {
+      if (*seen & (1u << i)) {
+        return KEY_UNKNOWN;
+      }
+      *seen |= (1u << i);
+      return i;
+    }
+  }
+  return KEY_UNKNOWN;
+}
+
+/**
+ * @brief Advance to the next array element
+ *
+ * The opening bracket must already be consumed.
+ *
+ * @return 1 at an element, 0 at the end of the array, -1 on error
+ */
+static int array_next(agx_parser_t *ps, bool *first) {
+  skip_ws(ps);
+  if (ps->p >= ps->end) {
+    return -1;
+  }
+  if (*ps->p == ']') {
+    ps->p++;
+    return 0;
+  }
+  if (!*first) {
+    if (*ps->p != ',') {
+      return -1;
+    }
+    ps->p++;
+    skip_ws(ps);
+    if (ps->p >= ps->end) {
+      return -1;
+    }
+  }
+  *first = false;
+  return 1;
+}
+
+/**
+ * @brief Validate and skip any value
+ *
+ * @param depth Nesting depth of the value
+ */
+static bool skip_value(agx_parser_t *ps, int depth) {
+  switch (peek(ps)) {
+  case '"':
+    return parse_string(ps, NULL, 0, NULL);
+  case '{': {
+    if (depth >= AGX_MONITOR_PARSER_MAX_DEPTH) {
+      return false;
+    }
+    ps->p++;
+    bool first = true;
+    uint32_t seen = 0;
+    int key;
+    while ((key = object_next(ps, &first, NULL, 0, &seen)) != KEY_END) {
+      if (key == KEY_ERROR || !skip_value(ps, depth + 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  case '[': {
+    if (depth >= AGX_MONITOR_PARSER_MAX_DEPTH) {
+      return false;
+    }
+    ps->p++;
+    bool first = true;
+    int ret;
+    while ((ret = array_next(ps, &first)) > 0) {
+      if (!skip_value(ps, depth + 1)) {
+        return false;
+      }
+    }
+    return ret == 0;
+  }
+  case 't':
+    return parse_literal(ps, "true", 4);
+  case 'f':
+    return parse_literal(ps, "false", 5);
+  case 'n':
+    return parse_literal(ps, "null", 4);
+  default: {
+    int ch = peek(ps);
+    if (ch == '-' || is_digit(ch)) {
+      agx_number_t number;
+      return parse_number(ps, &number);
+    }
+    return false;
+  }
+  }
+}
+
+/**
+ * @brief Read a number member, skipping values of any other type
+ *
+ * @return 1 if a number was read, 0 if skipped, -1 on error
+ */
+static int read_number(agx_parser_t *ps, int depth, agx_number_t *number) {
+  int ch = peek(ps);
+  if (ch == '-' || is_digit(ch)) {
+    return parse_number(ps, number) ? 1 : -1;
+  }
+  return skip_value(ps, depth) ? 0 : -1;
+}
+
+/**
+ * @brief Read a string member into a zero-filled buffer, skipping other types
+ *
+ * @return 1 if a string was read, 0 if skipped, -1 on error
+ */
+static int read_string(agx_parser_t *ps, int depth, char *out,
+                       size_t out_size) {
+  if (peek(ps) == '"') {
+    return parse_string(ps, out, out_size, NULL) ? 1 : -1;
+  }
+  return skip_value(ps, depth) ? 0 : -1;
+}
+
+/* ============================================================================
+ * Schema
+ * ============================================================================
+ */
+
+static bool parse_core(agx_parser_t *ps, int depth, agx_cpu_core_t *core) {
+  static const char *const keys[] = {"id", "usage", "freq"};
+  bool first = true;
+  uint32_t seen = 0;
+  int key;
+  agx_number_t number;
+
+  ps->p++;
+  while ((key = object_next(ps, &first, keys, 3, &seen)) != KEY_END) {
+    if (key == KEY_ERROR) {
+      return false;
+    }
+    if (key == KEY_UNKNOWN) {
+      if (!skip_value(ps, depth + 1)) {
+        return false;
+      }
+      continue;
+    }
+    int ret = read_number(ps, depth + 1, &number);
+    if (ret < 0) {
+      return false;
+    }
+    if (ret == 0) {
+      continue;
+    }
+    if (key == 0) {
+      core->id = (uint8_t)number.valueint;
+    } else if (key == 1) {
+      core->usage = (uint8_t)number.valueint;
+    } else {
+      core->freq = (uint16_t)number.valueint;
+    }
+  }
+  return true;
+}
+
+static bool parse_cores(agx_parser_t *ps, int depth) {
+  agx_monitor_data_t *data = ps->data;
+  bool first = true;
+  int count = 0;
+  int ret;
+
+  ps->p++;
+  while ((ret = array_next(ps, &first)) > 0) {
+    bool ok;
+    if (count < AGX_MONITOR_MAX_CPU_CORES && peek(ps) == '{') {
+      ok = parse_core(ps, depth + 1, &data->cpu.cores[count]);
+    } else {
+      ok = skip_value(ps, depth + 1);
+    }
+    if (!ok) {
+      return false;
+    }
+    count++;
+  }
+  data->cpu.core_count = (uint8_t)(count < AGX_MONITOR_MAX_CPU_CORES
+                                       ? count
+                                       : AGX_MONITOR_MAX_CPU_CORES);
+  return ret == 0;
+}
+
+static bool parse_cpu(agx_parser_t *ps, int depth) {
+  static const char *const keys[] = {"cores"};
+  bool first = true;
+  uint32_t seen = 0;
+  bool has_cores = false;
+  int key;
+
+  ps->p++;
+  while ((key = object_next(ps, &first, keys, 1, &seen)) != KEY_END) {
+    bool ok;
+    if (key == KEY_ERROR) {
+      return false;
+    }
+    if (key == 0 && peek(ps) == '[') {
+      ok = parse_cores(ps, depth + 1);
+      has_cores = true;
+    } else {
+      ok = skip_value(ps, depth + 1);
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+
+  if (has_cores) {
+    ps->parsed |= AGX_MONITOR_PARSED_CPU;
+  } else {
+    ps->schema_error = true;
+  }
+  return true;
+}
+
+static bool parse_memory_info(agx_parser_t *ps, int depth,
+                              agx_memory_info_t *info, bool with_cached) {
+  static const char *const keys[] = {"used", "total", "cached", "unit"};
+  bool first = true;
+  uint32_t seen = with_cached ? 0 : (1u << 2);
+  int key;
+  agx_number_t number;
+
+  ps->p++;
+  while ((key = object_next(ps, &first, keys, 4, &seen)) != KEY_END) {
+    int ret;
+    if (key == KEY_ERROR) {
+      return false;
+    }
+    if (key == KEY_UNKNOWN) {
+      ret = skip_value(ps, depth + 1) ? 0 : -1;
+    } else if (key == 3) {
+      ret = read_string(ps, depth + 1, info->unit, sizeof(info->unit));
+    } else {
+      ret = read_number(ps, depth + 1, &number);
+      if (ret > 0) {
+        uint32_t value = (uint32_t)number.valueint;
+        if (key == 0) {
+          info->used = value;
+        } else if (key == 1) {
+          info->total = value;
+        } else {
+          info->cached = value;
+        }
+      }
+    }
+    if (ret < 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool parse_memory(agx_parser_t *ps, int depth) {
+  static const char *const keys[] = {"ram", "swap"};
+  bool first = true;
+  uint32_t seen = 0;
+  int key;
+
+  ps->p++;
+  while ((key = object_next(ps, &first, keys, 2, &seen)) != KEY_END) {
+    bool ok;
+    if (key == KEY_ERROR) {
+      return false;
+    }
+    if (key >= 0 && peek(ps) == '{') {
+      ok = (key == 0) ? parse_memory_info(ps, depth + 1,
+                                          &ps->data->memory.ram, false)
+                      : parse_memory_info(ps, depth + 1,
+                                          &ps->data->memory.swap, true);
+    } else {
+      ok = skip_value(ps, depth + 1);
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  ps->parsed |= AGX_MONITOR_PARSED_MEMORY;
+  return true;
+}
+
+static bool parse_temperature(agx_parser_t *ps, int depth) {
+  static const char *const keys[] = {"cpu", "soc0", "soc1", "soc2", "tj"};
+  float *const targets[] = {
+      &ps->data->temperature.cpu,  &ps->data->temperature.soc0,
+      &ps->data->temperature.soc1, &ps->data->temperature.soc2,
+      &ps->data->temperature.tj};
+  bool first = true;
+  uint32_t seen = 0;
+  int key;
+  agx_number_t number;
+
+  ps->p++;
+  while ((key = object_next(ps, &first, keys, 5, &seen)) != KEY_END) {
+    int ret;
+    if (key == KEY_ERROR) {
+      return false;
+    }
+    if (key == KEY_UNKNOWN) {
+      ret = skip_value(ps, depth + 1) ? 0 : -1;
+    } else {
+      ret = read_number(ps, depth + 1, &number);
+      if (ret > 0) {
+        *targets[key] = (float)number.value;
+        if (key == 0) {
+          ps->parsed |= AGX_MONITOR_PARSED_CPU_TEMP;
+        }
+      }
+    }
+    if (ret < 0) {
+      return false;
+    }
+  }
+  ps->parsed |= AGX_MONITOR_PARSED_TEMPERATURE;
+  return true;
+}
+
+/**
+ * @brief Parse one power rail
+ *
+ * @param average_limit Averages above this are memory sizes sent by a buggy
+ *                      AGX server and are replaced by the current value
+ *                      (0 disables the check)
+ */
+static bool parse_power_info(agx_parser_t *ps, int depth,
+                             agx_power_info_t *info, int average_limit) {
+  static const char *const keys[] = {"current", "average", "unit"};
+  bool first = true;
+  uint32_t seen = 0;
+  bool has_average = false;
+  int average = 0;
+  int key;
+  agx_number_t number;
+
+  ps->p++;
+  while ((key = object_next(ps, &first, keys, 3, &seen)) != KEY_END) {
+    int ret;
+    if (key == KEY_ERROR) {
+      return false;
+    }
+    if (key == KEY_UNKNOWN) {
+      ret = skip_value(ps, depth + 1) ? 0 : -1;
+    } else if (key == 2) {
+      ret = read_string(ps, depth + 1, info->unit, sizeof(info->unit));
+    } else {
+      ret = read_number(ps, depth + 1, &number);
+      if (ret > 0 && key == 0) {
+        info->current = (uint32_t)number.valueint;
+      } else if (ret > 0) {
+        has_average = true;
+        average = number.valueint;
+      }
+    }
+    if (ret < 0) {
+      return false;
+    }
+  }
+
+  if (has_average) {
+    info->average = (average_limit > 0 && average > average_limit)
+                        ? info->current
+                        : (uint32_t)average;
+  }
+  return true;
+}
+
+static bool parse_power(agx_parser_t *ps, int depth) {
+  static const char *const keys[] = {"gpu_soc", "cpu_cv", "sys_5v", "ram",
+                                     "swap"};
+  static const int average_limits[] = {0, 0, 0, 50000, 30000};
+  agx_power_info_t *const targets[] = {
+      &ps->data->power.gpu_soc, &ps->data->power.cpu_cv,
+      &ps->data->power.sys_5v, &ps->data->power.ram, &ps->data->power.swap};
+  bool first = true;
+  uint32_t seen = 0;
+  int key;
+
+  ps->p++;
+  while ((key = object_next(ps, &first, keys, 5, &seen)) != KEY_END) {
+    bool ok;
+    if (key == KEY_ERROR) {
+      return false;
+    }
+    if (key >= 0 && peek(ps) == '{') {
+      ok = parse_power_info(ps, depth + 1, targets[key], average_limits[key]);
+    } else {
+      ok = skip_value(ps, depth + 1);
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  ps->parsed |= AGX_MONITOR_PARSED_POWER;
+  return true;
+}
+
+static bool parse_gpu(agx_parser_t *ps, int depth) {
+  static const char *const keys[] = {"gr3d_freq"};
+  bool first = true;
+  uint32_t seen = 0;
+  int key;
+  agx_number_t number;
+
+  ps->p++;
+  while ((key = object_next(ps, &first, keys, 1, &seen)) != KEY_END) {
+    int ret;
+    if (key == KEY_ERROR) {
+      return false;
+    }
+    if (key == 0) {
+      ret = read_number(ps, depth + 1, &number);
+      if (ret > 0) {
+        ps->data->gpu.gr3d_freq = (uint8_t)number.valueint;
+      }
+    } else {
+      ret = skip_value(ps, depth + 1) ? 0 : -1;
+    }
+    if (ret < 0) {
+      return false;
+    }
+  }
+  ps->parsed |= AGX_MONITOR_PARSED_GPU;
+  return true;
+}
+
+static bool parse_root(agx_parser_t *ps, int depth) {
+  static const char *const keys[] = {"timestamp",   "cpu",   "memory",
+                                     "temperature", "power", "gpu"};
+  bool first = true;
+  uint32_t seen = 0;
+  int key;
+
+  ps->p++;
+  while ((key = object_next(ps, &first, keys, 6, &seen)) != KEY_END) {
+    bool ok;
+    if (key == KEY_ERROR) {
+      return false;
+    }
+    if (key == 0) {
+      int ret = read_string(ps, depth + 1, ps->data->timestamp,
+                            sizeof(ps->data->timestamp));
+      if (ret > 0) {
+        ps->parsed |= AGX_MONITOR_PARSED_TIMESTAMP;
+      }
+      ok = (ret >= 0);
+    } else if (key == 1) {
+      // Any "cpu" value without a "cores" array is a schema error
+      if (peek(ps) == '{') {
+        ok = parse_cpu(ps, depth + 1);
+      } else {
+        ps->schema_error = true;
+        ok = skip_value(ps, depth + 1);
+      }
+    } else if (key > 1 && peek(ps) == '{') {
+      if (key == 2) {
+        ok = parse_memory(ps, depth + 1);
+      } else if (key == 3) {
+        ok = parse_temperature(ps, depth + 1);
+      } else if (key == 4) {
+        ok = parse_power(ps, depth + 1);
+      } else {
+        ok = parse_gpu(ps, depth + 1);
+      }
+    } else {
+      ok = skip_value(ps, depth + 1);
+    }
+    if (!ok) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+esp_err_t agx_monitor_parse_frame(const char *frame, size_t len,
+                                  agx_monitor_data_t *data, uint32_t *parsed) {
+  if (frame == NULL || data == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (parsed != NULL) {
+    *parsed = 0;
+  }
+
+  // Socket.IO event packet: 42[/namespace,][ack id]["name",args...]
+  if (len < 2 || frame[0] != '4' || frame[1] != '2') {
+    return ESP_ERR_NOT_FOUND;
+  }
+  const char *array = memchr(frame + 2, '[', len - 2);
+  if (array == NULL) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  agx_parser_t ps = {.p = array + 1, .end = frame + len, .data = data};
+
+  skip_ws(&ps);
+  if (peek(&ps) != '"') {
+    return ESP_ERR_NOT_FOUND;
+  }
+  char name[AGX_EVENT_NAME_LENGTH + 2] = {0};
+  size_t name_length = 0;
+  if (!parse_string(&ps, name, sizeof(name), &name_length)) {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  if (name_length != AGX_EVENT_NAME_LENGTH ||
+      memcmp(name, AGX_EVENT_NAME, AGX_EVENT_NAME_LENGTH) != 0) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  memset(data, 0, sizeof(*data));
+
+  skip_ws(&ps);
+  if (peek(&ps) != ',') {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+  ps.p++;
+  skip_ws(&ps);
+  if (peek(&ps) != '{' || !parse_root(&ps, 1)) {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  // Extra event arguments are validated and ignored, trailing bytes after
+  // the array are ignored like cJSON_ParseWithLength does
+  bool first = false;
+  int ret;
+  while ((ret = array_next(&ps, &first)) > 0) {
+    if (!skip_value(&ps, 1)) {
+      return ESP_ERR_INVALID_RESPONSE;
+    }
+  }
+  if (ret < 0 || ps.schema_error) {
+    return ESP_ERR_INVALID_RESPONSE;
+  }
+
+  if (parsed != NULL) {
+    *parsed = ps.parsed;
+  }
+  return ESP_OK;
+}
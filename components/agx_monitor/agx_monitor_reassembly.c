@@ -0,0 +1,253 @@
+/**
+ * @file agx_monitor_reassembly.c
+ * @brief WebSocket message reassembly into a preallocated buffer pool
+ *
+ * A message is assembled into one pool buffer in arrival order. Each chunk
+ * must continue exactly where the previous one ended: same frame at the
+ * next payload_offset, or a new continuation frame at offset 0 once the
+ * previous frame (without fin) is complete. Anything else abandons the
+ * message. A rejected message is skipped up to the chunk that ends it, or
+ * up to the start of the next message if that chunk never arrives.
+ *
+ * @version 1.0.0
+ * @date 2025-10-04
+ * @author robOS Team
+ */
+
+#include "agx_monitor_reassembly.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================
+ */
+
+static inline bool is_control(const agx_ws_chunk_t *chunk) {
+  return chunk->opcode >= AGX_WS_OPCODE_CLOSE;
+}
+
+static inline bool starts_message(const agx_ws_chunk_t *chunk) {
+  return (chunk->opcode == AGX_WS_OPCODE_TEXT ||
+          chunk->opcode == AGX_WS_OPCODE_BINARY) &&
+         chunk->payload_offset == 0;
+}
+
+static inline bool ends_frame(const agx_ws_chunk_t *chunk) {
+  return chunk->payload_offset + chunk->len >= chunk->payload_len;
+}
+
+static inline bool ends_message(const agx_ws_chunk_t *chunk) {
+  return chunk->fin && ends_frame(chunk);
+}
+
+static inline char *buffer_at(const agx_monitor_reassembly_t *r, int8_t index) {
+  return r->pool + (size_t)index * r->buffer_size;
+}
+
+static int8_t acquire_buffer(agx_monitor_reassembly_t *r) {
+  for (uint8_t i = 0; i < r->buffer_count; i++) {
+    if (r->free_mask & (1U << i)) {
+      r->free_mask &= (uint8_t)~(1U << i);
+      return (int8_t)i;
+    }
+  }
+  return -1;
+}
+
+static void release_buffer(agx_monitor_reassembly_t *r, int8_t index) {
+  if (index >= 0 && index < r->buffer_count) {
+    r->free_mask |= (uint8_t)(1U << index);
+  }
+}
+
+/**
+ * @brief Abandon the active message and skip the rest of it
+ */
+static void abandon(agx_monitor_reassembly_t *r, const agx_ws_chunk_t *chunk) {
+  release_buffer(r, r->active);
+  r->active = -1;
+  r->discarding = !ends_message(chunk);
+}
+
+/**
+ * @brief Check that a chunk continues the active message
+ */
+static bool in_sequence(const agx_monitor_reassembly_t *r,
+                        const agx_ws_chunk_t *chunk) {
+  size_t frame_pos = r->length - r->frame_start;
+
+  if (chunk->payload_offset + chunk->len > chunk->payload_len) {
+    return false;
+  }
+  if (frame_pos >= r->frame_len) {
+    // Previous frame complete without fin: a continuation frame must follow
+    return chunk->opcode == AGX_WS_OPCODE_CONTINUATION &&
+           chunk->payload_offset == 0;
+  }
+  uint8_t opcode =
+      r->frame_start == 0 ? r->opcode : (uint8_t)AGX_WS_OPCODE_CONTINUATION;
+  return chunk->opcode == opcode && chunk->payload_offset == frame_pos &&
+         chunk->payload_len == r->frame_len;
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+esp_err_t agx_monitor_reassembly_init(agx_monitor_reassembly_t *r,
+                                      size_t buffer_size,
+                                      uint8_t buffer_count) {
+  if (r == NULL || buffer_size == 0 || buffer_count == 0 ||
+      buffer_count > AGX_MONITOR_REASSEMBLY_MAX_BUFFERS) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(r, 0, sizeof(*r));
+  r->pool = calloc(buffer_count, buffer_size);
+  if (r->pool == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+
+  r->buffer_size = buffer_size;
+  r->buffer_count = buffer_count;
+  r->free_mask = (uint8_t)((1U << buffer_count) - 1);
+  r->active = -1;
+  return ESP_OK;
+}
+
+void agx_monitor_reassembly_deinit(agx_monitor_reassembly_t *r) {
+  if (r == NULL) {
+    return;
+  }
+  free(r->pool);
+  memset(r, 0, sizeof(*r));
+  r->active = -1;
+}
+
+esp_err_t agx_monitor_reassembly_feed(agx_monitor_reassembly_t *r,
+                                      const agx_ws_chunk_t *chunk,
+                                      agx_ws_message_t *message) {
+  if (r == NULL || r->pool == NULL || chunk == NULL || message == NULL ||
+      (chunk->data == NULL && chunk->len > 0)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Control frames may appear between fragments and are never fragmented
+  if (is_control(chunk)) {
+    message->data = chunk->data;
+    message->len = chunk->len;
+    message->opcode = chunk->opcode;
+    message->buffer = -1;
+    return ESP_OK;
+  }
+
+  if (r->discarding) {
+    if (!starts_message(chunk)) {
+      r->discarding = !ends_message(chunk);
+      return ESP_ERR_NOT_FINISHED;
+    }
+    // The end of the rejected message was lost, a new one begins here
+    r->discarding = false;
+  }
+
+  if (r->active >= 0) {
+    if (!in_sequence(r, chunk)) {
+      r->frames_dropped++;
+      release_buffer(r, r->active);
+      r->active = -1;
+      if (!starts_message(chunk)) {
+        r->discarding = !ends_message(chunk);
+        return ESP_ERR_INVALID_STATE;
+      }
+      // Fall through and start the new message
+    } else {
+      if (r->length - r->frame_start >= r->frame_len) {
+        r->frame_start = r->length;
+        r->frame_len = chunk->payload_len;
+      }
+      if (r->frame_start + r->frame_len > r->buffer_size) {
+        r->frames_oversized++;
+        abandon(r, chunk);
+        return ESP_ERR_INVALID_SIZE;
+      }
+
+      memcpy(buffer_at(r, r->active) + r->length, chunk->data, chunk->len);
+      r->length += chunk->len;
+      if (!ends_message(chunk)) {
+        return ESP_ERR_NOT_FINISHED;
+      }
+
+      message->data = buffer_at(r, r->active);
+      message->len = r->length;
+      message->opcode = r->opcode;
+      message->buffer = r->active;
+      r->active = -1;
+      r->frames_reassembled++;
+      return ESP_OK;
+    }
+  }
+
+  if (!starts_message(chunk)) {
+    r->frames_dropped++;
+    r->discarding = !ends_message(chunk);
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  // Common case: the whole message in one chunk, hand it out in place
+  if (ends_message(chunk)) {
+    message->data = chunk->data;
+    message->len = chunk->len;
+    message->opcode = chunk->opcode;
+    message->buffer = -1;
+    return ESP_OK;
+  }
+
+  if (chunk->len > chunk->payload_len) {
+    r->frames_dropped++;
+    r->discarding = true;
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (chunk->payload_len > r->buffer_size) {
+    r->frames_oversized++;
+    r->discarding = true;
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  int8_t index = acquire_buffer(r);
+  if (index < 0) {
+    r->frames_dropped++;
+    r->discarding = true;
+    return ESP_ERR_NO_MEM;
+  }
+
+  r->active = index;
+  r->opcode = chunk->opcode;
+  r->frame_start = 0;
+  r->frame_len = chunk->payload_len;
+  memcpy(buffer_at(r, index), chunk->data, chunk->len);
+  r->length = chunk->len;
+  return ESP_ERR_NOT_FINISHED;
+}
+
+void agx_monitor_reassembly_release(agx_monitor_reassembly_t *r,
+                                    const agx_ws_message_t *message) {
+  if (r == NULL || message == NULL) {
+    return;
+  }
+  release_buffer(r, message->buffer);
+}
+
+void agx_monitor_reassembly_reset(agx_monitor_reassembly_t *r) {
+  if (r == NULL) {
+    return;
+  }
+  if (r->active >= 0) {
+    r->frames_dropped++;
+    release_buffer(r, r->active);
+    r->active = -1;
+  }
+  r->discarding = false;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file agx_monitor_snapshot.c
+ * @brief Lock-free publication of agx_monitor_data_t
+ *
+ * Publication g lives in slot g % 3. Filling publication g + 1 only
+ * touches slot (g + 1) % 3, and slot g % 3 is next written for publication
+ * g + 3, which starts after g + 2 has been published. A reader that saw
+ * generation g before its copy and at most g + 1 after it therefore copied
+ * an untouched slot.
+ *
+ * @version 1.0.0
+ * @date 2025-10-04
+ * @author robOS Team
+ */
+
+#include "agx_monitor_snapshot.h"
+
+#include <string.h>
+
+static inline agx_monitor_data_t *slot_of(agx_monitor_snapshot_t *snapshot,
+                                          uint32_t generation) {
+  return &snapshot->slots[generation % AGX_MONITOR_SNAPSHOT_SLOTS];
+}
+
+void agx_monitor_snapshot_init(agx_monitor_snapshot_t *snapshot) {
+  memset(snapshot, 0, sizeof(*snapshot));
+}
+
+agx_monitor_data_t *agx_monitor_snapshot_begin(agx_monitor_snapshot_t *snapshot,
+                                               bool copy_current) {
+  uint32_t generation =
+      __atomic_load_n(&snapshot->generation, __ATOMIC_RELAXED);
+  agx_monitor_data_t *back = slot_of(snapshot, generation + 1);
+
+  // Order the previous publication before any write to the back slot, which
+  // a slow reader of generation - 2 may still be copying
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  if (copy_current) {
+    memcpy(back, slot_of(snapshot, generation), sizeof(*back));
+  }
+  return back;
+}
+
+uint32_t agx_monitor_snapshot_publish(agx_monitor_snapshot_t *snapshot) {
+  uint32_t generation =
+      __atomic_load_n(&snapshot->generation, __ATOMIC_RELAXED) + 1;
+  slot_of(snapshot, generation)->generation = generation;
+  __atomic_store_n(&snapshot->generation, generation, __ATOMIC_RELEASE);
+  return generation;
+}
+
+uint32_t agx_monitor_snapshot_read(agx_monitor_snapshot_t *snapshot,
+                                   agx_monitor_data_t *data) {
+  for (;;) {
+    uint32_t before = __atomic_load_n(&snapshot->generation, __ATOMIC_ACQUIRE);
+    memcpy(data, slot_of(snapshot, before), sizeof(*data));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    uint32_t after = __atomic_load_n(&snapshot->generation, __ATOMIC_RELAXED);
+    if (after - before <= 1) {
+      return before;
+    }
+    __atomic_fetch_add(&snapshot->retries, 1, __ATOMIC_RELAXED);
+  }
+}
+
+uint32_t
+agx_monitor_snapshot_generation(const agx_monitor_snapshot_t *snapshot) {
+  return __atomic_load_n(&snapshot->generation, __ATOMIC_ACQUIRE);
+}
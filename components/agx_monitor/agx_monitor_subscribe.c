@@ -0,0 +1,190 @@
+/**
+ * @file agx_monitor_subscribe.c
+ * @brief Change-driven notifications of AGX metrics
+ *
+ * @version 1.0.0
+ * @date 2025-10-04
+ * @author robOS Team
+ */
+
+#include "agx_monitor_subscribe.h"
+
+#include <string.h>
+
+_Static_assert(AGX_HISTORY_CHANNELS <= 32, "channel masks hold 32 channels");
+
+/* ============================================================================
+ * Helpers
+ * ============================================================================
+ */
+
+static uint32_t above_mask(const agx_subscriber_slot_t *slot,
+                           const int32_t *values) {
+  uint32_t above = 0;
+  for (uint32_t m = slot->sub.channels; m != 0; m &= m - 1) {
+    int ch = __builtin_ctz(m);
+    if (values[ch] >= slot->sub.threshold) {
+      above |= AGX_SUBSCRIBE_CHANNEL(ch);
+    }
+  }
+  return above;
+}
+
+/**
+ * @brief Channels of changed that pass the subscriber's trigger
+ *
+ * Updates the delivered reference or the threshold state of those channels.
+ */
+static uint32_t evaluate(agx_subscriber_slot_t *slot, uint32_t changed,
+                         const int32_t *values) {
+  uint32_t fired = 0;
+
+  for (uint32_t m = changed & slot->sub.channels; m != 0; m &= m - 1) {
+    int ch = __builtin_ctz(m);
+    uint32_t bit = AGX_SUBSCRIBE_CHANNEL(ch);
+
+    if (slot->sub.trigger == AGX_SUBSCRIBE_CHANGE) {
+      int64_t delta = (int64_t)values[ch] - slot->delivered[ch];
+      if (delta >= slot->sub.deadband || -delta >= slot->sub.deadband) {
+        slot->delivered[ch] = values[ch];
+        fired |= bit;
+      }
+    } else if (slot->above & bit) {
+      if ((int64_t)values[ch] <
+          (int64_t)slot->sub.threshold - slot->sub.deadband) {
+        slot->above &= ~bit;
+        fired |= bit;
+      }
+    } else if (values[ch] >= slot->sub.threshold) {
+      slot->above |= bit;
+      fired |= bit;
+    }
+  }
+  return fired;
+}
+
+static void notify(agx_monitor_subscribers_t *set, agx_subscriber_slot_t *slot,
+                   uint32_t changed, uint32_t generation, uint64_t now_ms) {
+  const agx_monitor_notification_t notification = {
+      .changed = changed,
+      .above = slot->sub.trigger == AGX_SUBSCRIBE_THRESHOLD ? slot->above : 0,
+      .values = set->last,
+      .generation = generation,
+      .valid = set->valid,
+  };
+  slot->notified_ms = now_ms;
+  slot->notifications++;
+  set->notifications++;
+  slot->callback(&notification, slot->user_data);
+}
+
+/* ============================================================================
+ * Public API
+ * ============================================================================
+ */
+
+void agx_monitor_subscribers_init(agx_monitor_subscribers_t *set) {
+  memset(set, 0, sizeof(*set));
+}
+
+esp_err_t agx_monitor_subscribers_add(agx_monitor_subscribers_t *set,
+                                      const agx_subscription_t *sub,
+                                      agx_monitor_subscriber_t callback,
+                                      void *user_data, int *handle) {
+  if (set == NULL || sub == NULL || callback == NULL || handle == NULL ||
+      sub->deadband < 0 || sub->trigger > AGX_SUBSCRIBE_THRESHOLD) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  uint32_t all = (uint32_t)((1ULL << AGX_HISTORY_CHANNELS) - 1);
+  if (sub->channels == 0 || (sub->channels & ~all) != 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  for (int i = 0; i < AGX_SUBSCRIBE_MAX_SUBSCRIBERS; i++) {
+    agx_subscriber_slot_t *slot = &set->slots[i];
+    if (slot->callback != NULL) {
+      continue;
+    }
+    memset(slot, 0, sizeof(*slot));
+    slot->sub = *sub;
+    slot->callback = callback;
+    slot->user_data = user_data;
+    *handle = i;
+    return ESP_OK;
+  }
+  return ESP_ERR_NO_MEM;
+}
+
+esp_err_t agx_monitor_subscribers_remove(agx_monitor_subscribers_t *set,
+                                         int handle) {
+  if (set == NULL || handle < 0 || handle >= AGX_SUBSCRIBE_MAX_SUBSCRIBERS ||
+      set->slots[handle].callback == NULL) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  set->slots[handle].callback = NULL;
+  return ESP_OK;
+}
+
+uint32_t agx_monitor_subscribers_update(agx_monitor_subscribers_t *set,
+                                        const int32_t *values,
+                                        uint32_t generation, uint64_t now_ms) {
+  uint32_t changed = 0;
+
+  // The one per-update pass over the values; subscribers only look at the
+  // channels in this mask
+  for (int ch = 0; ch < AGX_HISTORY_CHANNELS; ch++) {
+    if (values[ch] != set->last[ch]) {
+      changed |= AGX_SUBSCRIBE_CHANNEL(ch);
+    }
+  }
+  memcpy(set->last, values, sizeof(set->last));
+  set->valid = true;
+  set->updates++;
+
+  for (int i = 0; i < AGX_SUBSCRIBE_MAX_SUBSCRIBERS; i++) {
+    agx_subscriber_slot_t *slot = &set->slots[i];
+    if (slot->callback == NULL) {
+      continue;
+    }
+
+    bool keep_alive = slot->sub.max_interval_ms > 0 &&
+                      now_ms - slot->notified_ms >= slot->sub.max_interval_ms;
+    uint32_t fired;
+
+    if (!slot->primed) {
+      // First valid data for this subscriber: everything is news
+      memcpy(slot->delivered, values, sizeof(slot->delivered));
+      slot->above = above_mask(slot, values);
+      slot->primed = true;
+      fired = slot->sub.channels;
+    } else if ((changed & slot->sub.channels) == 0 && !keep_alive) {
+      set->skipped++;
+      continue;
+    } else {
+      fired = evaluate(slot, changed, values);
+    }
+
+    if (fired != 0 || keep_alive) {
+      notify(set, slot, fired, generation, now_ms);
+    }
+  }
+  return changed;
+}
+
+void agx_monitor_subscribers_invalidate(agx_monitor_subscribers_t *set,
+                                        uint32_t generation, uint64_t now_ms) {
+  if (!set->valid) {
+    return;
+  }
+  set->valid = false;
+
+  for (int i = 0; i < AGX_SUBSCRIBE_MAX_SUBSCRIBERS; i++) {
+    agx_subscriber_slot_t *slot = &set->slots[i];
+    if (slot->callback == NULL || !slot->primed) {
+      continue;
+    }
+    slot->primed = false;
+    slot->above = 0;
+    notify(set, slot, 0, generation, now_ms);
+  }
+}
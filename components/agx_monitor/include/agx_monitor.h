@@ -10,7 +10,7 @@
  * Features:
  * - WebSocket connection to AGX server using Socket.IO protocol
  * - Real-time tegrastats data reception and parsing
- * - Automatic reconnection with fixed interval strategy
+ * - Event-driven reconnection with exponential backoff and jitter
  * - Thread-safe data access with mutex protection
  * - Event callback system for data updates
  * - Console interface for debugging and status monitoring
@@ -31,6 +31,7 @@
 #ifndef AGX_MONITOR_H
 #define AGX_MONITOR_H
 
+#include "agx_monitor_link.h"
 #include "esp_err.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
@@ -62,7 +63,10 @@ extern "C" {
 #define AGX_MONITOR_DEFAULT_RECONNECT_INTERVAL_MS (3000)
 #define AGX_MONITOR_DEFAULT_FAST_RETRY_COUNT (3)
 #define AGX_MONITOR_DEFAULT_FAST_RETRY_INTERVAL_MS (1000)
+#define AGX_MONITOR_DEFAULT_RECONNECT_MAX_INTERVAL_MS (10000)
+#define AGX_MONITOR_DEFAULT_RECONNECT_JITTER_PERCENT (25)
 #define AGX_MONITOR_DEFAULT_HEARTBEAT_TIMEOUT_MS (10000)
+#define AGX_MONITOR_DEFAULT_BINARY_TELEMETRY (true)
 #define AGX_MONITOR_DEFAULT_STARTUP_DELAY_MS                                   \
   (45000) // AGX needs 45 seconds to boot
 
@@ -184,6 +188,7 @@ typedef struct {
 
   bool is_valid;           ///< Data validity flag
   uint64_t update_time_us; ///< Update timestamp in microseconds
+  uint32_t generation;     ///< Publication counter, changes with every update
 } agx_monitor_data_t;
 
 /**
@@ -192,12 +197,15 @@ typedef struct {
 typedef struct {
   char server_url[AGX_MONITOR_MAX_URL_LENGTH]; ///< WebSocket server URL
   uint16_t server_port;                        ///< Server port number
-  uint32_t reconnect_interval_ms;              ///< Fixed reconnection interval
-  uint32_t fast_retry_count;       ///< Number of fast retry attempts
-  uint32_t fast_retry_interval_ms; ///< Fast retry interval
-  uint32_t heartbeat_timeout_ms;   ///< Heartbeat timeout
-  bool enable_ssl;                 ///< Enable SSL/TLS
-  bool auto_start;                 ///< Auto start monitoring
+  uint32_t reconnect_interval_ms;     ///< Backoff start after fast retries
+  uint32_t reconnect_max_interval_ms; ///< Backoff upper bound
+  uint8_t reconnect_jitter_percent;   ///< Random reduction of each delay (%)
+  uint32_t fast_retry_count;          ///< Number of fast retry attempts
+  uint32_t fast_retry_interval_ms;    ///< Fast retry interval
+  uint32_t heartbeat_timeout_ms;      ///< Longest gap between updates
+  bool enable_ssl;                    ///< Enable SSL/TLS
+  bool auto_start;                    ///< Auto start monitoring
+  bool binary_telemetry;              ///< Ask for binary records over JSON
   uint32_t startup_delay_ms; ///< Startup delay before first connection attempt
   uint32_t task_stack_size;  ///< Task stack size
   uint8_t task_priority;     ///< Task priority
@@ -213,6 +221,13 @@ typedef struct {
   uint32_t total_reconnects;              ///< Total reconnection attempts
   uint32_t messages_received;             ///< Total messages received
   uint32_t parse_errors;                  ///< Total parsing errors
+  uint32_t frames_reassembled;            ///< Messages joined from fragments
+  uint32_t frames_oversized;              ///< Messages over the buffer size
+  uint32_t frames_dropped;                ///< Incomplete messages dropped
+  bool binary_telemetry;                  ///< Connection sends binary records
+  uint32_t binary_records;                ///< Updates received as records
+  agx_link_state_t link_state;            ///< Connection state machine state
+  agx_link_stats_t link;                  ///< Reconnect and data gap metrics
   uint64_t last_message_time_us;          ///< Last message timestamp
   uint64_t uptime_ms;                     ///< Component uptime
   uint64_t connected_time_ms;             ///< Total connected time
@@ -313,13 +328,26 @@ esp_err_t agx_monitor_get_status(agx_monitor_status_info_t *status);
  * @brief Get latest AGX monitoring data
  *
  * Retrieves the most recent monitoring data received from the AGX server.
- * This function is thread-safe and can be called from any task.
+ * This function is thread-safe and can be called from any task. It never
+ * blocks: the copy is taken from a lock-free snapshot and always comes from
+ * a single update. data->generation identifies the update.
  *
  * @param data Pointer to data structure to fill
  * @return esp_err_t ESP_OK on success, error code on failure
  */
 esp_err_t agx_monitor_get_latest_data(agx_monitor_data_t *data);
 
+/**
+ * @brief Get generation of the latest data
+ *
+ * Increases by one whenever the latest data changes (new update or
+ * invalidation). Cheap to poll: compare with the generation of the last
+ * copy to decide whether agx_monitor_get_latest_data is worth calling.
+ *
+ * @return uint32_t Current generation, 0 before the first update
+ */
+uint32_t agx_monitor_get_data_generation(void);
+
 /**
  * @brief Check if monitoring data is valid
  *
@@ -0,0 +1,140 @@
+/**
+ * @file agx_monitor_binary.h
+ * @brief Compact binary tegrastats records
+ *
+ * Optional replacement for the tegrastats_update JSON frames, negotiated
+ * per connection. After the Socket.IO namespace is connected the client
+ * emits
+ *
+ *     42["telemetry_format",{"format":"binary","version":1,"fields":63}]
+ *
+ * and a server that supports records answers with the same event, giving
+ * the version and field mask it will send. From then on every update is a
+ * binary WebSocket message holding one record, either as a raw Engine.IO
+ * binary message or as the attachment of a Socket.IO binary event (the
+ * `451-[...]` placeholder text is ignored). A server that does not answer,
+ * or answers with "format":"json", keeps sending JSON, which is accepted in
+ * either case.
+ *
+ * Record layout, all integers little-endian:
+ *
+ *     u8  magic (0xA7)
+ *     u8  version (1)
+ *     u16 fields (agx_binary_field_t)
+ *     then one section per set bit, in bit order:
+ *     TIMESTAMP   i64 microseconds since the Unix epoch (UTC)
+ *     CPU         u8 core count, then per core u8 usage and u16 freq (MHz)
+ *     MEMORY      u32 RAM used, RAM total, swap used, swap total, swap
+ *                 cached (MB)
+ *     TEMPERATURE i16 cpu, soc0, soc1, soc2, tj (0.01 °C, INT16_MIN = no
+ *                 sensor)
+ *     POWER       u32 current and average (mW) for gpu_soc, cpu_cv, sys_5v,
+ *                 ram and swap
+ *     GPU         u8 gr3d_freq (%)
+ *
+ * A 12 core update is 120 bytes against about 940 bytes of JSON. Sections
+ * for field bits this decoder does not know must follow the known ones and
+ * are skipped, so a server may add fields without a version change.
+ *
+ * This module does not depend on FreeRTOS or the WebSocket client and can
+ * be compiled on the host (see tests/host/bench_agx_binary.c).
+ */
+
+#ifndef AGX_MONITOR_BINARY_H
+#define AGX_MONITOR_BINARY_H
+
+#include "agx_monitor.h"
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AGX_BINARY_MAGIC (0xA7)             ///< First byte of every record
+#define AGX_BINARY_VERSION (1)              ///< Record layout version
+#define AGX_BINARY_HEADER_SIZE (4)          ///< Magic, version and field mask
+#define AGX_BINARY_MAX_SIZE (132)           ///< All fields, 16 cores
+#define AGX_BINARY_TEMP_MISSING INT16_MIN   ///< Temperature without a sensor
+#define AGX_BINARY_EVENT "telemetry_format" ///< Negotiation event name
+
+/**
+ * @brief Record sections
+ */
+typedef enum {
+  AGX_BINARY_FIELD_TIMESTAMP = (1u << 0),   ///< Sample time
+  AGX_BINARY_FIELD_CPU = (1u << 1),         ///< Per-core usage and frequency
+  AGX_BINARY_FIELD_MEMORY = (1u << 2),      ///< RAM and swap
+  AGX_BINARY_FIELD_TEMPERATURE = (1u << 3), ///< Thermal zones
+  AGX_BINARY_FIELD_POWER = (1u << 4),       ///< Power rails
+  AGX_BINARY_FIELD_GPU = (1u << 5),         ///< GPU load
+} agx_binary_field_t;
+
+#define AGX_BINARY_FIELDS_ALL (0x3F) ///< Every section of version 1
+
+/**
+ * @brief Format chosen by the server in its telemetry_format answer
+ */
+typedef struct {
+  bool binary;     ///< "format":"binary"
+  uint8_t version; ///< Record version the server sends
+  uint16_t fields; ///< Sections the server sends
+} agx_binary_ack_t;
+
+/**
+ * @brief Decode a record into agx_monitor_data_t
+ *
+ * @p data is cleared first; sections missing from the record stay zero.
+ * is_valid and update_time_us are left for the caller to set, as with
+ * agx_monitor_parse_frame.
+ *
+ * @param record Binary WebSocket message
+ * @param len Message length in bytes
+ * @param data Output data
+ * @param parsed Optional output, bitmask of agx_monitor_parsed_t
+ * @return
+ *     - ESP_OK: record decoded
+ *     - ESP_ERR_INVALID_ARG: NULL record or data
+ *     - ESP_ERR_NOT_SUPPORTED: wrong magic or unknown version
+ *     - ESP_ERR_INVALID_SIZE: record length does not match its sections
+ *     - ESP_ERR_INVALID_RESPONSE: more CPU cores than supported or a
+ *       timestamp outside years 1970-9999
+ */
+esp_err_t agx_monitor_binary_decode(const uint8_t *record, size_t len,
+                                    agx_monitor_data_t *data,
+                                    uint32_t *parsed);
+
+/**
+ * @brief Encode agx_monitor_data_t as a record
+ *
+ * Reference for the AGX side. The timestamp section is written only if
+ * data->timestamp is an ISO 8601 UTC time ("2025-10-04T12:00:00.123456Z",
+ * the fraction and the 'Z' are optional); units are not transmitted.
+ *
+ * @param fields Sections to write, bitmask of agx_binary_field_t
+ * @return Record length, 0 if @p size is too small
+ */
+size_t agx_monitor_binary_encode(const agx_monitor_data_t *data,
+                                 uint16_t fields, uint8_t *record,
+                                 size_t size);
+
+/**
+ * @brief Parse the server's telemetry_format answer
+ *
+ * @param frame Text message, starting with the "42" packet type; does not
+ *              have to be NUL-terminated
+ * @return
+ *     - ESP_OK: @p ack filled in
+ *     - ESP_ERR_NOT_FOUND: not a telemetry_format event
+ *     - ESP_ERR_INVALID_RESPONSE: no "format" member
+ */
+esp_err_t agx_monitor_binary_parse_ack(const char *frame, size_t len,
+                                       agx_binary_ack_t *ack);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AGX_MONITOR_BINARY_H */
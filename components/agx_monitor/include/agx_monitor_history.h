@@ -0,0 +1,325 @@
+/**
+ * @file agx_monitor_history.h
+ * @brief Fixed-memory time-series store for AGX metrics
+ *
+ * Every sample holds per-core CPU usage, the temperature sensors, the main
+ * power rails, GPU load and RAM usage as integers. Three tiers are kept:
+ *
+ * - RAW: one record per second
+ * - 1MIN: min/avg/max of each minute
+ * - 10MIN: min/avg/max of each ten minutes
+ *
+ * Each tier is a ring of fixed-size blocks allocated once at init. A block
+ * starts from an all-zero reference and stores every record as the time
+ * step plus a bitmap of the values that changed and their zigzag varint
+ * deltas, so a steady metric costs one bit per record. When a tier is full
+ * its oldest block is dropped.
+ *
+ * The aggregated tiers are fed from the raw samples; the bucket being
+ * filled is written when the first sample of the next bucket arrives.
+ *
+ * The store can be saved to a file (format described in
+ * agx_monitor_history.c) and loaded back with the same query API, on the
+ * device or on a Linux host (see tests/host/agx_history_replay.c).
+ *
+ * Not thread-safe: the caller serializes add, query and save.
+ */
+
+#ifndef AGX_MONITOR_HISTORY_H
+#define AGX_MONITOR_HISTORY_H
+
+#include "agx_monitor.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AGX_HISTORY_BLOCK_SIZE (512) ///< Bytes per storage block
+#define AGX_HISTORY_MIN_BLOCKS (2)   ///< Minimum blocks per tier
+
+/**
+ * @brief Storage tiers
+ */
+typedef enum {
+  AGX_HISTORY_TIER_RAW = 0, ///< 1 s samples
+  AGX_HISTORY_TIER_1MIN,    ///< 1 min min/avg/max
+  AGX_HISTORY_TIER_10MIN,   ///< 10 min min/avg/max
+  AGX_HISTORY_TIER_COUNT
+} agx_history_tier_t;
+
+/**
+ * @brief Recorded channels
+ */
+typedef enum {
+  AGX_HISTORY_CH_CPU_USAGE = 0, ///< Core 0 usage (%), one channel per core
+  AGX_HISTORY_CH_TEMP_CPU = AGX_MONITOR_MAX_CPU_CORES, ///< 0.01 °C
+  AGX_HISTORY_CH_TEMP_SOC0,                            ///< 0.01 °C
+  AGX_HISTORY_CH_TEMP_SOC1,                            ///< 0.01 °C
+  AGX_HISTORY_CH_TEMP_SOC2,                            ///< 0.01 °C
+  AGX_HISTORY_CH_TEMP_TJ,                              ///< 0.01 °C
+  AGX_HISTORY_CH_POWER_GPU_SOC,                        ///< mW
+  AGX_HISTORY_CH_POWER_CPU_CV,                         ///< mW
+  AGX_HISTORY_CH_POWER_SYS_5V,                         ///< mW
+  AGX_HISTORY_CH_GPU_LOAD,                             ///< %
+  AGX_HISTORY_CH_RAM_USED,                             ///< MB
+  AGX_HISTORY_CHANNELS
+} agx_history_channel_t;
+
+/**
+ * @brief One point of a query result
+ *
+ * Raw points have min == avg == max.
+ */
+typedef struct {
+  uint32_t time; ///< Seconds since boot (bucket start for aggregates)
+  int32_t min;   ///< Minimum over the period
+  int32_t avg;   ///< Average over the period (rounded)
+  int32_t max;   ///< Maximum over the period
+} agx_history_point_t;
+
+/**
+ * @brief Block ring of one tier
+ */
+typedef struct {
+  uint8_t *blocks;                        ///< block_count * BLOCK_SIZE bytes
+  uint16_t block_count;                   ///< Capacity in blocks
+  uint16_t head;                          ///< Oldest block
+  uint16_t used;                          ///< Blocks holding records
+  uint16_t fill;                          ///< Bytes used in the newest block
+  uint8_t values;                         ///< Values per record
+  uint32_t period;                        ///< Seconds per record
+  uint32_t records;                       ///< Records currently stored
+  uint32_t last_time;                     ///< Time of the newest record
+  int32_t last[AGX_HISTORY_CHANNELS * 3]; ///< Newest record
+} agx_history_series_t;
+
+/**
+ * @brief Running min/avg/max of the bucket being filled
+ */
+typedef struct {
+  uint32_t bucket; ///< time / period of the bucket
+  uint32_t count;  ///< Samples in the bucket
+  int32_t min[AGX_HISTORY_CHANNELS];
+  int32_t max[AGX_HISTORY_CHANNELS];
+  int64_t sum[AGX_HISTORY_CHANNELS];
+} agx_history_bucket_t;
+
+/**
+ * @brief History store
+ */
+typedef struct {
+  agx_history_series_t tiers[AGX_HISTORY_TIER_COUNT]; ///< Block rings
+  agx_history_bucket_t buckets[AGX_HISTORY_TIER_COUNT - 1]; ///< 1MIN, 10MIN
+  uint32_t samples; ///< Samples accepted since init or clear
+} agx_monitor_history_t;
+
+/**
+ * @brief Per-tier usage
+ */
+typedef struct {
+  uint32_t records;     ///< Records stored
+  uint32_t bytes_used;  ///< Encoded bytes in use
+  uint32_t capacity;    ///< Allocated bytes
+  uint32_t oldest_time; ///< Time of the oldest record
+  uint32_t newest_time; ///< Time of the newest record
+} agx_history_tier_stats_t;
+
+/**
+ * @brief Allocate the store
+ *
+ * @param history Store
+ * @param tier_bytes Bytes for each tier, rounded down to whole blocks
+ * @return
+ *     - ESP_OK: success
+ *     - ESP_ERR_INVALID_ARG: a tier smaller than AGX_HISTORY_MIN_BLOCKS blocks
+ *     - ESP_ERR_NO_MEM: allocation failed
+ */
+esp_err_t
+agx_monitor_history_init(agx_monitor_history_t *history,
+                         const size_t tier_bytes[AGX_HISTORY_TIER_COUNT]);
+
+/**
+ * @brief Free the store
+ *
+ * @param history Store
+ */
+void agx_monitor_history_deinit(agx_monitor_history_t *history);
+
+/**
+ * @brief Drop all records, keeping the allocation
+ *
+ * @param history Store
+ */
+void agx_monitor_history_clear(agx_monitor_history_t *history);
+
+/**
+ * @brief Convert monitoring data into channel values
+ *
+ * @param data Monitoring data
+ * @param values Output, AGX_HISTORY_CHANNELS values
+ */
+void agx_monitor_history_sample(const agx_monitor_data_t *data,
+                                int32_t values[AGX_HISTORY_CHANNELS]);
+
+/**
+ * @brief Add a sample
+ *
+ * Only the first sample of each second is stored; samples older than the
+ * newest one are rejected.
+ *
+ * @param history Store
+ * @param time Seconds since boot
+ * @param values AGX_HISTORY_CHANNELS values
+ * @return
+ *     - ESP_OK: stored
+ *     - ESP_ERR_INVALID_STATE: a sample for this second already exists, or
+ *       time went backwards
+ *     - ESP_ERR_INVALID_ARG: NULL arguments
+ */
+esp_err_t agx_monitor_history_add(agx_monitor_history_t *history, uint32_t time,
+                                  const int32_t values[AGX_HISTORY_CHANNELS]);
+
+/**
+ * @brief Read one channel of a tier
+ *
+ * Returns the newest points with time >= since, oldest first. When more
+ * than max_points match, the oldest ones are skipped.
+ *
+ * @param history Store
+ * @param tier Tier
+ * @param channel Channel
+ * @param since Earliest time to return
+ * @param points Output array
+ * @param max_points Capacity of points
+ * @return Number of points written
+ */
+size_t agx_monitor_history_query(const agx_monitor_history_t *history,
+                                 agx_history_tier_t tier,
+                                 agx_history_channel_t channel, uint32_t since,
+                                 agx_history_point_t *points,
+                                 size_t max_points);
+
+/**
+ * @brief Get usage of a tier
+ *
+ * @param history Store
+ * @param tier Tier
+ * @param stats Output
+ */
+void agx_monitor_history_get_stats(const agx_monitor_history_t *history,
+                                   agx_history_tier_t tier,
+                                   agx_history_tier_stats_t *stats);
+
+/**
+ * @brief Channel name ("cpu3", "temp_cpu", "power_sys_5v", ...)
+ *
+ * @param channel Channel
+ * @param buf Output buffer
+ * @param size Size of buf
+ * @return buf
+ */
+const char *agx_monitor_history_channel_name(agx_history_channel_t channel,
+                                             char *buf, size_t size);
+
+/**
+ * @brief Parse a channel name
+ *
+ * @param name Name as returned by agx_monitor_history_channel_name
+ * @param channel Output
+ * @return
+ *     - ESP_OK: success
+ *     - ESP_ERR_NOT_FOUND: unknown name
+ */
+esp_err_t agx_monitor_history_channel_from_name(const char *name,
+                                                agx_history_channel_t *channel);
+
+/**
+ * @brief Divisor to convert channel values to display units
+ *
+ * @param channel Channel
+ * @return 100 for temperatures, 1 otherwise
+ */
+int agx_monitor_history_channel_scale(agx_history_channel_t channel);
+
+/**
+ * @brief Write all tiers to a file
+ *
+ * @param history Store
+ * @param path File path
+ * @param time Current time (seconds since boot), stored in the header
+ * @return
+ *     - ESP_OK: success
+ *     - ESP_FAIL: file could not be written
+ */
+esp_err_t agx_monitor_history_save(const agx_monitor_history_t *history,
+                                   const char *path, uint32_t time);
+
+/**
+ * @brief Load a file written by agx_monitor_history_save
+ *
+ * Allocates the store with the sizes found in the file. Pending
+ * (unfinished) aggregation buckets are not saved.
+ *
+ * @param history Store (uninitialized)
+ * @param path File path
+ * @param time Output, time stored in the header (may be NULL)
+ * @return
+ *     - ESP_OK: success
+ *     - ESP_ERR_NOT_FOUND: file could not be opened
+ *     - ESP_ERR_INVALID_VERSION: not a history file or unsupported version
+ *     - ESP_ERR_INVALID_SIZE: truncated or inconsistent file
+ *     - ESP_ERR_NO_MEM: allocation failed
+ */
+esp_err_t agx_monitor_history_load(agx_monitor_history_t *history,
+                                   const char *path, uint32_t *time);
+
+/* ============================================================================
+ * AGX Monitor History
+ * ============================================================================
+ */
+
+/**
+ * @brief Query the history recorded by the running monitor
+ *
+ * Thread-safe. See agx_monitor_history_query.
+ *
+ * @return Number of points written, 0 when history is disabled
+ */
+size_t agx_monitor_get_history(agx_history_tier_t tier,
+                               agx_history_channel_t channel, uint32_t since,
+                               agx_history_point_t *points, size_t max_points);
+
+/**
+ * @brief Get usage of a tier of the monitor history
+ *
+ * @param tier Tier
+ * @param stats Output
+ * @return
+ *     - ESP_OK: success
+ *     - ESP_ERR_INVALID_STATE: history not allocated
+ *     - ESP_ERR_TIMEOUT: history busy
+ */
+esp_err_t agx_monitor_get_history_stats(agx_history_tier_t tier,
+                                        agx_history_tier_stats_t *stats);
+
+/**
+ * @brief Save the monitor history to a file (e.g. on the SD card)
+ *
+ * @param path File path
+ * @return
+ *     - ESP_OK: success
+ *     - ESP_ERR_INVALID_STATE: history not allocated
+ *     - ESP_ERR_TIMEOUT: history busy
+ *     - ESP_FAIL: file could not be written
+ */
+esp_err_t agx_monitor_save_history(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AGX_MONITOR_HISTORY_H */
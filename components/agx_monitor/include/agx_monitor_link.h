@@ -0,0 +1,181 @@
+/**
+ * @file agx_monitor_link.h
+ * @brief Connection state machine for the AGX WebSocket link
+ *
+ * The monitor task feeds WebSocket, data, Ethernet and timer events
+ * into agx_monitor_link_handle() and performs the returned actions (start
+ * or stop the WebSocket client, invalidate the published data). Between
+ * events it sleeps until agx_monitor_link_timeout() expires, so nothing is
+ * polled:
+ *
+ *   STOPPED --start--> STARTUP --delay/link up--> CONNECTING
+ *   CONNECTING --ws connected--> HANDSHAKE --first data--> ONLINE
+ *   CONNECTING/HANDSHAKE --error/timeout--> BACKOFF --delay--> CONNECTING
+ *   ONLINE --disconnect/no data--> CONNECTING (stable) or BACKOFF
+ *   any --link down--> NO_LINK --link up--> CONNECTING
+ *
+ * Retry delays start at fast_retry_interval_ms for fast_retry_count
+ * failures, then double from backoff_initial_ms up to backoff_max_ms. Each
+ * delay is reduced by a random fraction of up to jitter_percent so that
+ * several clients do not retry in lockstep. A connection that stayed online
+ * for stable_ms is retried immediately when it drops, and an Ethernet link
+ * or DHCP lease event skips any pending delay.
+ *
+ * Time is passed in by the caller, so the module does not depend on
+ * FreeRTOS and can be driven by a simulation on the host (see
+ * tests/host/bench_agx_link.c). Not thread-safe.
+ */
+
+#ifndef AGX_MONITOR_LINK_H
+#define AGX_MONITOR_LINK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AGX_LINK_NO_TIMEOUT (UINT32_MAX) ///< No timer pending
+
+/**
+ * @brief Link states
+ */
+typedef enum {
+  AGX_LINK_STATE_STOPPED = 0, ///< Not running
+  AGX_LINK_STATE_STARTUP,     ///< Waiting for the AGX to boot
+  AGX_LINK_STATE_CONNECTING,  ///< WebSocket client started
+  AGX_LINK_STATE_HANDSHAKE,   ///< WebSocket open, waiting for data
+  AGX_LINK_STATE_ONLINE,      ///< Receiving data
+  AGX_LINK_STATE_BACKOFF,     ///< Waiting before the next attempt
+  AGX_LINK_STATE_NO_LINK,     ///< Ethernet link down
+  AGX_LINK_STATE_COUNT
+} agx_link_state_t;
+
+/**
+ * @brief Link events
+ */
+typedef enum {
+  AGX_LINK_EVENT_START = 0,       ///< Monitoring started
+  AGX_LINK_EVENT_STOP,            ///< Monitoring stopped
+  AGX_LINK_EVENT_TIMER,           ///< agx_monitor_link_timeout() expired
+  AGX_LINK_EVENT_WS_CONNECTED,    ///< WebSocket connection open
+  AGX_LINK_EVENT_WS_DISCONNECTED, ///< WebSocket connection closed
+  AGX_LINK_EVENT_WS_ERROR,        ///< Client error or unusable data
+  AGX_LINK_EVENT_DATA,            ///< tegrastats update received
+  AGX_LINK_EVENT_LINK_UP,         ///< Ethernet link up or lease handed out
+  AGX_LINK_EVENT_LINK_DOWN,       ///< Ethernet link down
+  AGX_LINK_EVENT_COUNT
+} agx_link_event_t;
+
+/**
+ * @brief Actions returned by agx_monitor_link_handle (bit mask)
+ */
+typedef enum {
+  AGX_LINK_ACTION_NONE = 0,
+  AGX_LINK_ACTION_CONNECT = 1 << 0,    ///< Start the WebSocket client
+  AGX_LINK_ACTION_DISCONNECT = 1 << 1, ///< Stop the WebSocket client
+  AGX_LINK_ACTION_INVALIDATE = 1 << 2, ///< Published data is stale
+} agx_link_action_t;
+
+/**
+ * @brief Timing parameters
+ */
+typedef struct {
+  uint32_t startup_delay_ms;       ///< Wait before the first attempt
+  uint32_t connect_timeout_ms;     ///< Limit from start to first data
+  uint32_t liveness_timeout_ms;    ///< Longest gap between updates online
+  uint32_t fast_retry_count;       ///< Failures retried at the fast interval
+  uint32_t fast_retry_interval_ms; ///< Delay of the fast retries
+  uint32_t backoff_initial_ms;     ///< First delay after the fast retries
+  uint32_t backoff_max_ms;         ///< Upper bound of the delay
+  uint32_t stable_ms;              ///< Online time that resets the backoff
+  uint8_t jitter_percent;          ///< Random reduction of each delay (0-100)
+} agx_link_config_t;
+
+/**
+ * @brief Connection metrics
+ *
+ * A reconnect is measured from the moment a connection that delivered data
+ * is lost (disconnect, no data or link down) until data arrives again. The
+ * data gap of the same outage runs from the last data before the loss.
+ */
+typedef struct {
+  uint32_t attempts;           ///< WebSocket client starts
+  uint32_t failures;           ///< Attempts that did not deliver data
+  uint32_t connect_timeouts;   ///< Attempts that hit connect_timeout_ms
+  uint32_t liveness_timeouts;  ///< Online connections without data
+  uint32_t link_losses;        ///< Ethernet link down events while running
+  uint32_t reconnects;         ///< Outages ended by new data
+  uint32_t last_reconnect_ms;  ///< Duration of the last outage
+  uint32_t max_reconnect_ms;   ///< Longest outage
+  uint64_t total_reconnect_ms; ///< Sum of outages (average = total / count)
+  uint32_t last_gap_ms;        ///< Data gap of the last outage
+  uint32_t max_gap_ms;         ///< Longest data gap
+  uint64_t total_gap_ms;       ///< Sum of data gaps
+} agx_link_stats_t;
+
+/**
+ * @brief Link state machine
+ */
+typedef struct {
+  agx_link_config_t config;
+  agx_link_state_t state;
+  uint64_t deadline_ms;    ///< Pending timer, UINT64_MAX if none
+  uint64_t online_ms;      ///< Entry into ONLINE
+  uint64_t data_ms;        ///< Last tegrastats update
+  uint64_t lost_ms;        ///< Start of the current outage, 0 if none
+  uint64_t lost_data_ms;   ///< data_ms when the outage started
+  uint32_t failures;       ///< Consecutive failed attempts
+  uint32_t rng;            ///< Jitter generator state
+  bool link_up;            ///< Last known Ethernet link state
+  agx_link_stats_t stats;  ///< Metrics
+} agx_monitor_link_t;
+
+/**
+ * @brief Initialize in STOPPED state
+ *
+ * @param link State machine
+ * @param config Timing parameters (copied)
+ * @param seed Jitter seed, e.g. esp_random()
+ */
+void agx_monitor_link_init(agx_monitor_link_t *link,
+                           const agx_link_config_t *config, uint32_t seed);
+
+/**
+ * @brief Process an event
+ *
+ * @param link State machine
+ * @param event Event
+ * @param now_ms Current time in milliseconds (monotonic)
+ * @return Mask of agx_link_action_t to perform, in the order DISCONNECT,
+ *         INVALIDATE, CONNECT
+ */
+uint32_t agx_monitor_link_handle(agx_monitor_link_t *link,
+                                 agx_link_event_t event, uint64_t now_ms);
+
+/**
+ * @brief Time until AGX_LINK_EVENT_TIMER is due
+ *
+ * @param link State machine
+ * @param now_ms Current time in milliseconds
+ * @return Milliseconds (0 if overdue), AGX_LINK_NO_TIMEOUT if none pending
+ */
+uint32_t agx_monitor_link_timeout(const agx_monitor_link_t *link,
+                                  uint64_t now_ms);
+
+/**
+ * @brief State name for logs and the console
+ */
+const char *agx_monitor_link_state_name(agx_link_state_t state);
+
+/**
+ * @brief Event name for logs
+ */
+const char *agx_monitor_link_event_name(agx_link_event_t event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AGX_MONITOR_LINK_H */
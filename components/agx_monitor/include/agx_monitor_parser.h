@@ -0,0 +1,74 @@
+/**
+ * @file agx_monitor_parser.h
+ * @brief Allocation-free parser for tegrastats_update Socket.IO frames
+ *
+ * Parses a `42["tegrastats_update",{...}]` frame in a single pass and writes
+ * the known fields straight into an agx_monitor_data_t. The frame does not
+ * have to be NUL-terminated and is never copied or modified, so the
+ * WebSocket payload buffer can be handed over as-is.
+ *
+ * The accepted grammar and field semantics follow the cJSON based parser it
+ * replaces: keys are matched case-insensitively and the first occurrence
+ * wins, fields of the wrong type are ignored, unknown members are validated
+ * and skipped, and numbers are converted the way cJSON's valueint and
+ * valuedouble are. The cJSON path can still be selected with
+ * CONFIG_AGX_MONITOR_PARSER_CJSON or run side by side for validation with
+ * CONFIG_AGX_MONITOR_PARSER_VALIDATE.
+ *
+ * This module does not depend on FreeRTOS or the WebSocket client and can
+ * be compiled on the host (see tests/host/bench_agx_parser.c).
+ */
+
+#ifndef AGX_MONITOR_PARSER_H
+#define AGX_MONITOR_PARSER_H
+
+#include "agx_monitor.h"
+#include "esp_err.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AGX_MONITOR_PARSER_MAX_DEPTH (16) ///< Maximum nesting of skipped values
+
+/**
+ * @brief Sections found in a parsed frame
+ */
+typedef enum {
+  AGX_MONITOR_PARSED_TIMESTAMP = (1u << 0),   ///< "timestamp" string
+  AGX_MONITOR_PARSED_CPU = (1u << 1),         ///< "cpu.cores" array
+  AGX_MONITOR_PARSED_MEMORY = (1u << 2),      ///< "memory" object
+  AGX_MONITOR_PARSED_TEMPERATURE = (1u << 3), ///< "temperature" object
+  AGX_MONITOR_PARSED_CPU_TEMP = (1u << 4),    ///< "temperature.cpu" number
+  AGX_MONITOR_PARSED_POWER = (1u << 5),       ///< "power" object
+  AGX_MONITOR_PARSED_GPU = (1u << 6),         ///< "gpu" object
+} agx_monitor_parsed_t;
+
+/**
+ * @brief Parse a Socket.IO tegrastats_update event frame
+ *
+ * @p data is cleared first; fields missing from the frame stay zero.
+ * is_valid and update_time_us are left for the caller to set. On failure
+ * other than ESP_ERR_NOT_FOUND the contents of @p data are unspecified.
+ *
+ * @param frame Frame payload, starting with the "42" packet type
+ * @param len Payload length in bytes
+ * @param data Output data
+ * @param parsed Optional output, bitmask of agx_monitor_parsed_t
+ * @return
+ *     - ESP_OK: frame parsed
+ *     - ESP_ERR_INVALID_ARG: NULL frame or data
+ *     - ESP_ERR_NOT_FOUND: not a tegrastats_update event
+ *     - ESP_ERR_INVALID_RESPONSE: malformed JSON or "cpu" without a
+ *       "cores" array
+ */
+esp_err_t agx_monitor_parse_frame(const char *frame, size_t len,
+                                  agx_monitor_data_t *data, uint32_t *parsed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AGX_MONITOR_PARSER_H */
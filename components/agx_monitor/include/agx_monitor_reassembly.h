@@ -0,0 +1,158 @@
+/**
+ * @file agx_monitor_reassembly.h
+ * @brief WebSocket message reassembly into a preallocated buffer pool
+ *
+ * The WebSocket client delivers a message as one or more data events: a
+ * frame larger than the client buffer (or split across TCP segments) arrives
+ * in chunks at increasing payload_offset, and a fragmented message is a
+ * text/binary frame with fin cleared followed by continuation frames.
+ *
+ * The reassembler joins these chunks into one contiguous message. Buffers
+ * come from a fixed pool allocated once at init, so nothing is allocated
+ * per message. A message that arrives complete in a single chunk is handed
+ * out in place without copying. Control frames (close/ping/pong) may be
+ * interleaved with fragments and are passed through unchanged.
+ *
+ * Messages larger than a pool buffer are discarded up to their last chunk
+ * and counted as oversized. Broken sequences (missing start, offset gaps,
+ * no free buffer, connection reset mid-message) are counted as dropped.
+ *
+ * Not thread-safe: feed, release and reset must be called from the task
+ * that receives WebSocket events. The counters may be read from any task.
+ *
+ * This module does not depend on FreeRTOS or the WebSocket client and can
+ * be compiled on the host (see tests/host/bench_agx_reassembly.c).
+ */
+
+#ifndef AGX_MONITOR_REASSEMBLY_H
+#define AGX_MONITOR_REASSEMBLY_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AGX_MONITOR_REASSEMBLY_MAX_BUFFERS (8) ///< Maximum pool size
+
+/**
+ * @brief WebSocket opcodes
+ */
+typedef enum {
+  AGX_WS_OPCODE_CONTINUATION = 0x0,
+  AGX_WS_OPCODE_TEXT = 0x1,
+  AGX_WS_OPCODE_BINARY = 0x2,
+  AGX_WS_OPCODE_CLOSE = 0x8,
+  AGX_WS_OPCODE_PING = 0x9,
+  AGX_WS_OPCODE_PONG = 0xA,
+} agx_ws_opcode_t;
+
+/**
+ * @brief One WebSocket data event
+ */
+typedef struct {
+  const char *data;      ///< Chunk data
+  size_t len;            ///< Chunk length
+  uint8_t opcode;        ///< Opcode of the frame the chunk belongs to
+  bool fin;              ///< Frame is the last one of its message
+  size_t payload_len;    ///< Total payload length of the frame
+  size_t payload_offset; ///< Offset of this chunk within the frame payload
+} agx_ws_chunk_t;
+
+/**
+ * @brief A complete message
+ */
+typedef struct {
+  const char *data; ///< Message data (pool buffer or the chunk itself)
+  size_t len;       ///< Message length
+  uint8_t opcode;   ///< TEXT, BINARY or a control opcode
+  int8_t buffer;    ///< Pool buffer index, -1 when handed out in place
+} agx_ws_message_t;
+
+/**
+ * @brief Reassembler state
+ */
+typedef struct {
+  char *pool;                  ///< buffer_count * buffer_size bytes
+  size_t buffer_size;          ///< Capacity of one buffer
+  uint8_t buffer_count;        ///< Number of buffers
+  uint8_t free_mask;           ///< Bit n set when buffer n is free
+  int8_t active;               ///< Buffer being assembled, -1 if none
+  bool discarding;             ///< Skipping the rest of a rejected message
+  uint8_t opcode;              ///< Opcode of the message being assembled
+  size_t length;               ///< Bytes assembled so far
+  size_t frame_start;          ///< Message offset of the current frame
+  size_t frame_len;            ///< Payload length of the current frame
+  uint32_t frames_reassembled; ///< Messages joined from several chunks
+  uint32_t frames_oversized;   ///< Messages larger than a buffer
+  uint32_t frames_dropped;     ///< Incomplete or out-of-sequence messages
+} agx_monitor_reassembly_t;
+
+/**
+ * @brief Allocate the buffer pool
+ *
+ * @param r Reassembler
+ * @param buffer_size Capacity of each buffer (largest accepted message)
+ * @param buffer_count Number of buffers (1 - AGX_MONITOR_REASSEMBLY_MAX_BUFFERS)
+ * @return
+ *     - ESP_OK: success
+ *     - ESP_ERR_INVALID_ARG: invalid parameters
+ *     - ESP_ERR_NO_MEM: pool allocation failed
+ */
+esp_err_t agx_monitor_reassembly_init(agx_monitor_reassembly_t *r,
+                                      size_t buffer_size, uint8_t buffer_count);
+
+/**
+ * @brief Free the buffer pool
+ *
+ * @param r Reassembler
+ */
+void agx_monitor_reassembly_deinit(agx_monitor_reassembly_t *r);
+
+/**
+ * @brief Feed one WebSocket data event
+ *
+ * @param r Reassembler
+ * @param chunk Data event
+ * @param message Output, valid when ESP_OK is returned. A message held in a
+ *                pool buffer must be returned with
+ *                agx_monitor_reassembly_release.
+ * @return
+ *     - ESP_OK: a complete message is available
+ *     - ESP_ERR_NOT_FINISHED: chunk consumed, message not complete yet
+ *     - ESP_ERR_INVALID_SIZE: message exceeds the buffer size and is discarded
+ *     - ESP_ERR_NO_MEM: no free buffer, message dropped
+ *     - ESP_ERR_INVALID_STATE: chunk out of sequence, message dropped
+ *     - ESP_ERR_INVALID_ARG: NULL arguments
+ */
+esp_err_t agx_monitor_reassembly_feed(agx_monitor_reassembly_t *r,
+                                      const agx_ws_chunk_t *chunk,
+                                      agx_ws_message_t *message);
+
+/**
+ * @brief Return a message's buffer to the pool
+ *
+ * @param r Reassembler
+ * @param message Message returned by agx_monitor_reassembly_feed
+ */
+void agx_monitor_reassembly_release(agx_monitor_reassembly_t *r,
+                                    const agx_ws_message_t *message);
+
+/**
+ * @brief Abandon the message being assembled (connection lost)
+ *
+ * A partially assembled message is counted as dropped. Buffers of
+ * messages the caller has not released yet are not affected.
+ *
+ * @param r Reassembler
+ */
+void agx_monitor_reassembly_reset(agx_monitor_reassembly_t *r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AGX_MONITOR_REASSEMBLY_H */
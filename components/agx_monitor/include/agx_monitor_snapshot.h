@@ -0,0 +1,101 @@
+/**
+ * @file agx_monitor_snapshot.h
+ * @brief Lock-free publication of agx_monitor_data_t
+ *
+ * Three slots rotate between the writer and any number of readers. The
+ * writer fills the slot after the published one and then advances the
+ * generation counter with a single atomic store, so the published slot is
+ * never modified while it is current. A reader copies the published slot
+ * and checks the generation afterwards: the copy is only overwritten once
+ * two more generations have been published, in which case the reader
+ * retries. Readers never wait for the writer and never take a lock.
+ *
+ * The generation counter increases by one with every publication (new
+ * data or invalidation), so consumers can tell whether anything changed
+ * without copying the data.
+ *
+ * Writers must be serialized by the caller. Readers may run on any task
+ * or core.
+ *
+ * This module does not depend on FreeRTOS and can be compiled on the host
+ * (see tests/host/bench_agx_snapshot.c).
+ */
+
+#ifndef AGX_MONITOR_SNAPSHOT_H
+#define AGX_MONITOR_SNAPSHOT_H
+
+#include "agx_monitor.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AGX_MONITOR_SNAPSHOT_SLOTS (3) ///< Published, previous and back slot
+
+/**
+ * @brief Snapshot publication state
+ */
+typedef struct {
+  agx_monitor_data_t slots[AGX_MONITOR_SNAPSHOT_SLOTS]; ///< Data slots
+  uint32_t generation; ///< Published generation, slot = generation % 3
+  uint32_t retries;    ///< Reads repeated because the writer lapped them
+} agx_monitor_snapshot_t;
+
+/**
+ * @brief Initialize with an invalid, zeroed generation 0
+ *
+ * @param snapshot Snapshot state
+ */
+void agx_monitor_snapshot_init(agx_monitor_snapshot_t *snapshot);
+
+/**
+ * @brief Get the slot for the next publication (writer only)
+ *
+ * The slot is private to the writer until agx_monitor_snapshot_publish.
+ * Calling begin again without publishing returns the same slot.
+ *
+ * @param snapshot Snapshot state
+ * @param copy_current Start from a copy of the published data
+ * @return Slot to fill
+ */
+agx_monitor_data_t *agx_monitor_snapshot_begin(agx_monitor_snapshot_t *snapshot,
+                                               bool copy_current);
+
+/**
+ * @brief Publish the slot returned by agx_monitor_snapshot_begin (writer only)
+ *
+ * Stores the new generation in the slot's generation field and makes it the
+ * current snapshot.
+ *
+ * @param snapshot Snapshot state
+ * @return New generation
+ */
+uint32_t agx_monitor_snapshot_publish(agx_monitor_snapshot_t *snapshot);
+
+/**
+ * @brief Copy the current snapshot without blocking
+ *
+ * @param snapshot Snapshot state
+ * @param data Output copy, consistent with a single publication
+ * @return Generation of the copy
+ */
+uint32_t agx_monitor_snapshot_read(agx_monitor_snapshot_t *snapshot,
+                                   agx_monitor_data_t *data);
+
+/**
+ * @brief Current generation
+ *
+ * @param snapshot Snapshot state
+ * @return Generation of the published snapshot
+ */
+uint32_t
+agx_monitor_snapshot_generation(const agx_monitor_snapshot_t *snapshot);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AGX_MONITOR_SNAPSHOT_H */
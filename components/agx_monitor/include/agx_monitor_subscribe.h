@@ -0,0 +1,199 @@
+/**
+ * @file agx_monitor_subscribe.h
+ * @brief Change-driven notifications of AGX metrics
+ *
+ * A subscriber names the channels it cares about (the channels of the
+ * metrics history, in the same integer units: 0.01 °C, mW, %, MB) and how
+ * much a value has to move before it is told:
+ *
+ * - CHANGE: the value moved by at least deadband since the last value
+ *   delivered to this subscriber, e.g. CPU temperature by 50 (0.5 °C)
+ * - THRESHOLD: the value rose to threshold or above, or fell below
+ *   threshold - deadband again (hysteresis), e.g. sys_5v power > 15000 mW
+ *
+ * For every update the mask of channels that differ from the previous
+ * update is computed once; subscribers whose channels did not change are
+ * skipped without looking at their values. A subscriber is also called
+ * when the data becomes invalid, on the first update after that, and
+ * optionally every max_interval_ms as a keep-alive for consumers that
+ * treat silence as stale data.
+ *
+ * Time is passed in by the caller, so the module can run on the host (see
+ * tests/host/bench_agx_subscribe.c). Not thread-safe: the caller
+ * serializes all calls, and callbacks run inside
+ * agx_monitor_subscribers_update/invalidate.
+ */
+
+#ifndef AGX_MONITOR_SUBSCRIBE_H
+#define AGX_MONITOR_SUBSCRIBE_H
+
+#include "agx_monitor_history.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AGX_SUBSCRIBE_MAX_SUBSCRIBERS (8) ///< Subscription slots
+
+/// Mask bit of a channel
+#define AGX_SUBSCRIBE_CHANNEL(ch) (1UL << (ch))
+/// All per-core CPU usage channels
+#define AGX_SUBSCRIBE_CPU_USAGE                                                \
+  (((1UL << AGX_MONITOR_MAX_CPU_CORES) - 1) << AGX_HISTORY_CH_CPU_USAGE)
+/// All temperature channels
+#define AGX_SUBSCRIBE_TEMPERATURES                                             \
+  (((1UL << 5) - 1) << AGX_HISTORY_CH_TEMP_CPU)
+/// All power rails
+#define AGX_SUBSCRIBE_POWER (((1UL << 3) - 1) << AGX_HISTORY_CH_POWER_GPU_SOC)
+
+/**
+ * @brief When a subscriber is notified
+ */
+typedef enum {
+  AGX_SUBSCRIBE_CHANGE = 0, ///< Moved by >= deadband since last delivery
+  AGX_SUBSCRIBE_THRESHOLD,  ///< Crossed threshold (deadband = hysteresis)
+} agx_subscribe_trigger_t;
+
+/**
+ * @brief Subscription parameters
+ */
+typedef struct {
+  uint32_t channels;               ///< AGX_SUBSCRIBE_CHANNEL() bits
+  agx_subscribe_trigger_t trigger; ///< Trigger type
+  int32_t deadband;                ///< Minimum change or hysteresis (>= 0)
+  int32_t threshold;               ///< THRESHOLD: level in channel units
+  uint32_t max_interval_ms; ///< Notify at least this often, 0 = only changes
+} agx_subscription_t;
+
+/**
+ * @brief Passed to the subscriber callback
+ *
+ * changed is 0 for keep-alive and invalidation notifications.
+ */
+typedef struct {
+  uint32_t changed;      ///< Watched channels that triggered
+  uint32_t above;        ///< THRESHOLD: watched channels >= threshold
+  const int32_t *values; ///< All AGX_HISTORY_CHANNELS values
+  uint32_t generation;   ///< Data generation of the update
+  bool valid;            ///< false once the data has been invalidated
+} agx_monitor_notification_t;
+
+/**
+ * @brief Subscriber callback
+ *
+ * @param notification What changed; only valid during the call
+ * @param user_data User data from agx_monitor_subscribe
+ */
+typedef void (*agx_monitor_subscriber_t)(
+    const agx_monitor_notification_t *notification, void *user_data);
+
+/**
+ * @brief One subscription slot
+ */
+typedef struct {
+  agx_subscription_t sub;
+  agx_monitor_subscriber_t callback; ///< NULL if the slot is free
+  void *user_data;
+  int32_t delivered[AGX_HISTORY_CHANNELS]; ///< Reference of CHANGE
+  uint32_t above;                          ///< Threshold state
+  uint64_t notified_ms;                    ///< Last notification
+  bool primed;            ///< Got valid data since the last invalidation
+  uint32_t notifications; ///< Callbacks made
+} agx_subscriber_slot_t;
+
+/**
+ * @brief Subscriber set
+ */
+typedef struct {
+  agx_subscriber_slot_t slots[AGX_SUBSCRIBE_MAX_SUBSCRIBERS];
+  int32_t last[AGX_HISTORY_CHANNELS]; ///< Values of the previous update
+  bool valid;                         ///< last holds valid data
+  uint32_t updates;                   ///< Updates processed
+  uint32_t notifications;             ///< Callbacks made
+  uint32_t skipped;                   ///< Subscribers skipped by the mask
+} agx_monitor_subscribers_t;
+
+/**
+ * @brief Initialize an empty set
+ */
+void agx_monitor_subscribers_init(agx_monitor_subscribers_t *set);
+
+/**
+ * @brief Add a subscriber
+ *
+ * @param set Subscriber set
+ * @param sub Parameters (copied)
+ * @param callback Called on the updating task
+ * @param user_data Passed to callback
+ * @param[out] handle Slot to pass to agx_monitor_subscribers_remove
+ * @return ESP_OK, ESP_ERR_INVALID_ARG for an empty channel mask or negative
+ *         deadband, ESP_ERR_NO_MEM if all slots are used
+ */
+esp_err_t agx_monitor_subscribers_add(agx_monitor_subscribers_t *set,
+                                      const agx_subscription_t *sub,
+                                      agx_monitor_subscriber_t callback,
+                                      void *user_data, int *handle);
+
+/**
+ * @brief Remove a subscriber
+ *
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the slot is not in use
+ */
+esp_err_t agx_monitor_subscribers_remove(agx_monitor_subscribers_t *set,
+                                         int handle);
+
+/**
+ * @brief Process one update and notify the affected subscribers
+ *
+ * @param set Subscriber set
+ * @param values Channel values (agx_monitor_history_sample)
+ * @param generation Data generation
+ * @param now_ms Current time in milliseconds
+ * @return Mask of channels that differ from the previous update
+ */
+uint32_t agx_monitor_subscribers_update(agx_monitor_subscribers_t *set,
+                                        const int32_t *values,
+                                        uint32_t generation, uint64_t now_ms);
+
+/**
+ * @brief The data has become invalid: notify every primed subscriber once
+ *
+ * The next update is delivered to all subscribers as if every watched
+ * channel had changed.
+ */
+void agx_monitor_subscribers_invalidate(agx_monitor_subscribers_t *set,
+                                        uint32_t generation, uint64_t now_ms);
+
+/**
+ * @brief Subscribe to changes of the AGX metrics
+ *
+ * Callbacks run on the WebSocket task (updates) or the monitor task
+ * (invalidation) with the subscription lock held: keep them short and do
+ * not subscribe or unsubscribe from them.
+ *
+ * @param sub Subscription parameters
+ * @param callback Subscriber callback
+ * @param user_data Passed to callback
+ * @param[out] handle Handle for agx_monitor_unsubscribe
+ * @return esp_err_t ESP_OK on success, error code on failure
+ */
+esp_err_t agx_monitor_subscribe(const agx_subscription_t *sub,
+                                agx_monitor_subscriber_t callback,
+                                void *user_data, int *handle);
+
+/**
+ * @brief Remove a subscription
+ *
+ * @param handle Handle from agx_monitor_subscribe
+ * @return esp_err_t ESP_OK on success, error code on failure
+ */
+esp_err_t agx_monitor_unsubscribe(int handle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AGX_MONITOR_SUBSCRIBE_H */
@@ -14,6 +14,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
+#include "led_kernel.h"
 #include "led_strip.h"
 #include <math.h>
 #include <stdlib.h>
@@ -123,9 +124,9 @@ static void apply_brightness(board_led_color_t *color, uint8_t brightness) {
     return; // No scaling needed
   }
 
-  color->red = (color->red * brightness) / 255;
-  color->green = (color->green * brightness) / 255;
-  color->blue = (color->blue * brightness) / 255;
+  color->red = led_kernel_scale8(color->red, brightness);
+  color->green = led_kernel_scale8(color->green, brightness);
+  color->blue = led_kernel_scale8(color->blue, brightness);
 }
 
 /* ============================================================================
@@ -571,13 +572,10 @@ static void animation_task(void *arg) {
  * @brief Fade animation implementation
  */
 static void animate_fade(void) {
-  uint8_t fade_value =
-      (uint8_t)((sin(s_board_led.animation_step * 0.1) + 1) * 127);
+  uint8_t fade_value = led_kernel_wave8(
+      (uint16_t)(s_board_led.animation_step * LED_KERNEL_RADIANS(0.1f)));
   board_led_color_t color = s_board_led.animation_primary_color;
-
-  color.red = (color.red * fade_value) / 255;
-  color.green = (color.green * fade_value) / 255;
-  color.blue = (color.blue * fade_value) / 255;
+  apply_brightness(&color, fade_value);
 
   for (uint16_t i = 0; i < BOARD_LED_COUNT; i++) {
     board_led_set_pixel_internal(i, color);
@@ -600,13 +598,10 @@ static void animate_rainbow(void) {
  * @brief Breathe animation implementation
  */
 static void animate_breathe(void) {
-  uint8_t breath_value =
-      (uint8_t)((sin(s_board_led.animation_step * 0.2) + 1) * 127);
+  uint8_t breath_value = led_kernel_wave8(
+      (uint16_t)(s_board_led.animation_step * LED_KERNEL_RADIANS(0.2f)));
   board_led_color_t color = s_board_led.animation_primary_color;
-
-  color.red = (color.red * breath_value) / 255;
-  color.green = (color.green * breath_value) / 255;
-  color.blue = (color.blue * breath_value) / 255;
+  apply_brightness(&color, breath_value);
 
   for (uint16_t i = 0; i < BOARD_LED_COUNT; i++) {
     board_led_set_pixel_internal(i, color);
@@ -618,8 +613,8 @@ static void animate_breathe(void) {
  */
 static void animate_wave(void) {
   for (uint16_t i = 0; i < BOARD_LED_COUNT; i++) {
-    uint8_t wave_value =
-        (uint8_t)((sin((s_board_led.animation_step + i * 5) * 0.3) + 1) * 127);
+    uint8_t wave_value = led_kernel_wave8((uint16_t)(
+        (s_board_led.animation_step + i * 5) * LED_KERNEL_RADIANS(0.3f)));
     board_led_color_t color =
         board_led_blend_colors(s_board_led.animation_secondary_color,
                                s_board_led.animation_primary_color, wave_value);
@@ -706,54 +701,10 @@ static void animate_pulse(void) {
 
 board_led_color_t board_led_hsv_to_rgb(uint16_t hue, uint8_t saturation,
                                        uint8_t value) {
-  board_led_color_t color = {0, 0, 0};
-
-  if (saturation == 0) {
-    color.red = color.green = color.blue = value * 255 / 100;
-    return color;
-  }
-
-  hue = hue % 360;
-  uint8_t region = hue / 60;
-  uint8_t remainder = (hue - (region * 60)) * 6;
-
-  uint8_t p = (value * (100 - saturation)) / 100;
-  uint8_t q = (value * (100 - ((saturation * remainder) / 255))) / 100;
-  uint8_t t = (value * (100 - ((saturation * (255 - remainder)) / 255))) / 100;
-
-  switch (region) {
-  case 0:
-    color.red = value * 255 / 100;
-    color.green = t * 255 / 100;
-    color.blue = p * 255 / 100;
-    break;
-  case 1:
-    color.red = q * 255 / 100;
-    color.green = value * 255 / 100;
-    color.blue = p * 255 / 100;
-    break;
-  case 2:
-    color.red = p * 255 / 100;
-    color.green = value * 255 / 100;
-    color.blue = t * 255 / 100;
-    break;
-  case 3:
-    color.red = p * 255 / 100;
-    color.green = q * 255 / 100;
-    color.blue = value * 255 / 100;
-    break;
-  case 4:
-    color.red = t * 255 / 100;
-    color.green = p * 255 / 100;
-    color.blue = value * 255 / 100;
-    break;
-  default:
-    color.red = value * 255 / 100;
-    color.green = p * 255 / 100;
-    color.blue = q * 255 / 100;
-    break;
-  }
-
+  led_kernel_rgb_t rgb = led_kernel_hsv_to_rgb(
+      LED_KERNEL_DEGREES(hue % 360), led_kernel_percent_to_u8(saturation),
+      led_kernel_percent_to_u8(value));
+  board_led_color_t color = {rgb.r, rgb.g, rgb.b};
   return color;
 }
 
@@ -762,10 +713,9 @@ board_led_color_t board_led_blend_colors(board_led_color_t color1,
                                          uint8_t ratio) {
   board_led_color_t result;
 
-  result.red = ((color1.red * (255 - ratio)) + (color2.red * ratio)) / 255;
-  result.green =
-      ((color1.green * (255 - ratio)) + (color2.green * ratio)) / 255;
-  result.blue = ((color1.blue * (255 - ratio)) + (color2.blue * ratio)) / 255;
+  result.red = led_kernel_lerp8(color1.red, color2.red, ratio);
+  result.green = led_kernel_lerp8(color1.green, color2.green, ratio);
+  result.blue = led_kernel_lerp8(color1.blue, color2.blue, ratio);
 
   return result;
 }
@@ -805,15 +755,16 @@ static void animate_rainbow_wave(void) {
  */
 static void animate_brightness_wave(void) {
   for (uint16_t i = 0; i < BOARD_LED_COUNT; i++) {
-    // Create a sine wave pattern for brightness
-    float position = (float)i / (BOARD_LED_COUNT - 1) * 2 * M_PI;
-    float wave_offset = (float)s_board_led.animation_step * 0.1;
-    uint8_t brightness = (uint8_t)((sin(position + wave_offset) + 1) * 127);
+    // Create a sine wave pattern for brightness (one full period across the
+    // strip)
+    uint32_t position = i * LED_KERNEL_ANGLE_FULL / (BOARD_LED_COUNT - 1);
+    uint32_t wave_offset =
+        s_board_led.animation_step * LED_KERNEL_RADIANS(0.1f);
+    uint8_t brightness =
+        led_kernel_wave8((uint16_t)(position + wave_offset));
 
     board_led_color_t color = s_board_led.animation_primary_color;
-    color.red = (color.red * brightness) / 255;
-    color.green = (color.green * brightness) / 255;
-    color.blue = (color.blue * brightness) / 255;
+    apply_brightness(&color, brightness);
 
     board_led_set_pixel_internal(i, color);
   }
@@ -323,6 +323,10 @@ esp_err_t color_correction_set_config(const color_correction_config_t *config) {
     }
     
     ESP_LOGI(TAG, "Configuration updated");
+    
+    // Notify about the change
+    notify_config_change();
+    
     return ESP_OK;
 }
 
@@ -7,6 +7,7 @@
  */
 
 #include "event_manager.h"
+#include "event_manager_queue.h"
 #include "esp_log.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
@@ -16,11 +17,22 @@
 
 static const char *TAG = "EVENT_MANAGER";
 
+#define EVENT_MANAGER_STOP_TIMEOUT_MS 1000
+
+static const char *const s_lane_names[EVENT_MANAGER_PRIORITY_COUNT] = {
+    "high", "normal", "low"
+};
+
 // Define the event manager's own event base
 ESP_EVENT_DEFINE_BASE(EVENT_MANAGER_EVENTS);
 
 /**
  * @brief Event statistics entry
+ *
+ * Only the dispatch task adds entries, at the head of the list, and only
+ * deinit frees them; readers traverse under the mutex, which the dispatch
+ * task never takes. Fields that change after an entry is published are
+ * accessed with relaxed atomics.
  */
 typedef struct event_stats_entry {
     esp_event_base_t event_base;
@@ -28,6 +40,7 @@ typedef struct event_stats_entry {
     uint32_t send_count;
     uint32_t handler_count;
     uint64_t last_sent_time;
+    event_manager_priority_t priority;
     struct event_stats_entry *next;
 } event_stats_entry_t;
 
@@ -41,7 +54,13 @@ typedef struct {
     esp_event_loop_handle_t event_loop;
     SemaphoreHandle_t mutex;
     
-    // Statistics
+    // Priority lanes, drained into event_loop by the dispatch task
+    event_queue_t lanes[EVENT_MANAGER_PRIORITY_COUNT];
+    TaskHandle_t dispatch_task;
+    SemaphoreHandle_t dispatch_done;
+    bool dispatch_stop;                 ///< Atomic
+    
+    // Statistics (counters are atomic, posting and dispatch never take the mutex)
     uint32_t total_events_sent;
     uint32_t total_events_received;
     uint32_t active_handlers;
@@ -57,6 +76,9 @@ static event_manager_state_t s_event_manager = {
     .running = false,
     .event_loop = NULL,
     .mutex = NULL,
+    .dispatch_task = NULL,
+    .dispatch_done = NULL,
+    .dispatch_stop = false,
     .total_events_sent = 0,
     .total_events_received = 0,
     .active_handlers = 0,
@@ -71,10 +93,7 @@ static event_manager_state_t s_event_manager = {
 static void event_handler_wrapper(void *handler_args, esp_event_base_t event_base, 
                                  int32_t event_id, void *event_data)
 {
-    if (xSemaphoreTake(s_event_manager.mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
-        s_event_manager.total_events_received++;
-        xSemaphoreGive(s_event_manager.mutex);
-    }
+    __atomic_fetch_add(&s_event_manager.total_events_received, 1, __ATOMIC_RELAXED);
     
     if (s_event_manager.logging_enabled) {
         ESP_LOGI(TAG, "Event received - Base: %s, ID: %" PRId32, event_base, event_id);
@@ -88,19 +107,16 @@ static void event_handler_wrapper(void *handler_args, esp_event_base_t event_bas
 }
 
 /**
- * @brief Update event statistics
+ * @brief Update event statistics (dispatch task, never waits for a reader)
  */
-static void update_event_stats(esp_event_base_t event_base, int32_t event_id)
+static void update_event_stats(esp_event_base_t event_base, int32_t event_id,
+                               event_manager_priority_t priority)
 {
     if (!s_event_manager.config.enable_statistics) {
         return;
     }
     
-    if (xSemaphoreTake(s_event_manager.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-        return;
-    }
-    
-    // Find existing entry or create new one
+    // Find existing entry or create new one; this task is the only writer
     event_stats_entry_t *entry = s_event_manager.stats_list;
     while (entry) {
         if (entry->event_base == event_base && entry->event_id == event_id) {
@@ -118,17 +134,115 @@ static void update_event_stats(esp_event_base_t event_base, int32_t event_id)
             entry->send_count = 0;
             entry->handler_count = 1; // This will be updated separately
             entry->last_sent_time = 0;
+            entry->priority = priority;
             entry->next = s_event_manager.stats_list;
-            s_event_manager.stats_list = entry;
+            __atomic_store_n(&s_event_manager.stats_list, entry, __ATOMIC_RELEASE);
         }
     }
     
     if (entry) {
-        entry->send_count++;
-        entry->last_sent_time = esp_timer_get_time();
+        __atomic_fetch_add(&entry->send_count, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&entry->last_sent_time, (uint64_t)esp_timer_get_time(),
+                         __ATOMIC_RELAXED);
+        __atomic_store_n(&entry->priority, priority, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Free the statistics list (mutex held, dispatch task not running)
+ */
+static void free_event_stats(void)
+{
+    event_stats_entry_t *entry = s_event_manager.stats_list;
+    while (entry) {
+        event_stats_entry_t *next = entry->next;
+        free(entry);
+        entry = next;
+    }
+    s_event_manager.stats_list = NULL;
+}
+
+/**
+ * @brief Deliver the oldest event of the highest non-empty lane
+ * @param busy Set if a lane could not be read right now
+ * @return true if an event was delivered
+ */
+static bool dispatch_one(event_queue_event_t *event, bool *busy)
+{
+    for (int lane = 0; lane < EVENT_MANAGER_PRIORITY_COUNT; lane++) {
+        esp_err_t ret = event_queue_pop(&s_event_manager.lanes[lane], event);
+        if (ret == ESP_ERR_NOT_FINISHED) {
+            // A coalescing post is rewriting the oldest event of this lane;
+            // keep the lane order and come back once it had time to finish
+            *busy = true;
+            return false;
+        }
+        if (ret != ESP_OK) {
+            continue;
+        }
+        
+        // The loop has no task of its own: post and run it right here, so its
+        // queue holds one event at most and posting to it never waits
+        ret = esp_event_post_to(s_event_manager.event_loop, event->base, event->id,
+                                event->size ? event->data.bytes : NULL, event->size, 0);
+        if (ret == ESP_OK) {
+            esp_event_loop_run(s_event_manager.event_loop, 0);
+        } else {
+            ESP_LOGW(TAG, "Failed to deliver event: %s", esp_err_to_name(ret));
+        }
+        
+        update_event_stats(event->base, event->id, (event_manager_priority_t)lane);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Dispatch task: drains the lanes, high priority first
+ */
+static void event_dispatch_task(void *pvParameters)
+{
+    event_queue_event_t event;
+    
+    for (;;) {
+        // Read before draining, so everything posted before deinit is delivered
+        bool stopping = __atomic_load_n(&s_event_manager.dispatch_stop, __ATOMIC_ACQUIRE);
+        bool busy = false;
+        
+        while (dispatch_one(&event, &busy)) {
+        }
+        if (stopping) {
+            break;
+        }
+        
+        // Every post notifies; when busy, let the coalescing post run
+        ulTaskNotifyTake(pdTRUE, busy ? 1 : portMAX_DELAY);
     }
     
-    xSemaphoreGive(s_event_manager.mutex);
+    xSemaphoreGive(s_event_manager.dispatch_done);
+    vTaskDelete(NULL);
+}
+
+/**
+ * @brief Free everything init allocated, the dispatch task must not be running
+ */
+static void release_resources(void)
+{
+    if (s_event_manager.event_loop) {
+        esp_event_loop_delete(s_event_manager.event_loop);
+        s_event_manager.event_loop = NULL;
+    }
+    for (int lane = 0; lane < EVENT_MANAGER_PRIORITY_COUNT; lane++) {
+        event_queue_deinit(&s_event_manager.lanes[lane]);
+    }
+    if (s_event_manager.dispatch_done) {
+        vSemaphoreDelete(s_event_manager.dispatch_done);
+        s_event_manager.dispatch_done = NULL;
+    }
+    if (s_event_manager.mutex) {
+        vSemaphoreDelete(s_event_manager.mutex);
+        s_event_manager.mutex = NULL;
+    }
 }
 
 event_manager_config_t event_manager_get_default_config(void)
@@ -138,7 +252,12 @@ event_manager_config_t event_manager_get_default_config(void)
         .event_task_stack_size = 4096,
         .event_task_priority = 5,
         .enable_statistics = true,
-        .enable_logging = false
+        .enable_logging = false,
+        .lanes = {
+            [EVENT_MANAGER_PRIORITY_HIGH] = { 16, EVENT_MANAGER_OVERFLOW_DROP_NEWEST },
+            [EVENT_MANAGER_PRIORITY_NORMAL] = { 32, EVENT_MANAGER_OVERFLOW_COALESCE },
+            [EVENT_MANAGER_PRIORITY_LOW] = { 16, EVENT_MANAGER_OVERFLOW_DROP_OLDEST },
+        }
     };
     return config;
 }
@@ -159,29 +278,61 @@ esp_err_t event_manager_init(const event_manager_config_t *config)
         s_event_manager.config = event_manager_get_default_config();
     }
     
+    // Lanes left at capacity 0 take their default
+    event_manager_config_t defaults = event_manager_get_default_config();
+    for (int lane = 0; lane < EVENT_MANAGER_PRIORITY_COUNT; lane++) {
+        if (s_event_manager.config.lanes[lane].capacity == 0) {
+            s_event_manager.config.lanes[lane] = defaults.lanes[lane];
+        }
+    }
+    
     // Create mutex
     s_event_manager.mutex = xSemaphoreCreateMutex();
-    if (!s_event_manager.mutex) {
+    s_event_manager.dispatch_done = xSemaphoreCreateBinary();
+    if (!s_event_manager.mutex || !s_event_manager.dispatch_done) {
         ESP_LOGE(TAG, "Failed to create mutex");
+        release_resources();
         return ESP_ERR_NO_MEM;
     }
     
-    // Create event loop
+    // Create priority lanes
+    esp_err_t ret = ESP_OK;
+    for (int lane = 0; lane < EVENT_MANAGER_PRIORITY_COUNT; lane++) {
+        const event_manager_lane_config_t *lane_config = &s_event_manager.config.lanes[lane];
+        ret = event_queue_init(&s_event_manager.lanes[lane], (uint32_t)lane_config->capacity,
+                               lane_config->overflow);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create %s priority lane of %u events: %s",
+                     s_lane_names[lane], (unsigned)lane_config->capacity, esp_err_to_name(ret));
+            release_resources();
+            return ret;
+        }
+    }
+    
+    // Create event loop, run by the dispatch task
     esp_event_loop_args_t loop_args = {
         .queue_size = s_event_manager.config.event_queue_size,
-        .task_name = "event_mgr",
-        .task_priority = s_event_manager.config.event_task_priority,
-        .task_stack_size = s_event_manager.config.event_task_stack_size,
-        .task_core_id = tskNO_AFFINITY
+        .task_name = NULL
     };
     
-    esp_err_t ret = esp_event_loop_create(&loop_args, &s_event_manager.event_loop);
+    ret = esp_event_loop_create(&loop_args, &s_event_manager.event_loop);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to create event loop: %s", esp_err_to_name(ret));
-        vSemaphoreDelete(s_event_manager.mutex);
+        release_resources();
         return ret;
     }
     
+    __atomic_store_n(&s_event_manager.dispatch_stop, false, __ATOMIC_RELAXED);
+    if (xTaskCreate(event_dispatch_task, "event_mgr",
+                    s_event_manager.config.event_task_stack_size, NULL,
+                    s_event_manager.config.event_task_priority,
+                    &s_event_manager.dispatch_task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create dispatch task");
+        s_event_manager.dispatch_task = NULL;
+        release_resources();
+        return ESP_ERR_NO_MEM;
+    }
+    
     s_event_manager.logging_enabled = s_event_manager.config.enable_logging;
     s_event_manager.initialized = true;
     
@@ -203,29 +354,25 @@ esp_err_t event_manager_deinit(void)
         event_manager_stop();
     }
     
-    // Clean up event loop
-    if (s_event_manager.event_loop) {
-        esp_event_loop_delete(s_event_manager.event_loop);
-        s_event_manager.event_loop = NULL;
+    // Deliver what is still queued and end the dispatch task
+    __atomic_store_n(&s_event_manager.dispatch_stop, true, __ATOMIC_RELEASE);
+    xTaskNotifyGive(s_event_manager.dispatch_task);
+    if (xSemaphoreTake(s_event_manager.dispatch_done,
+                       pdMS_TO_TICKS(EVENT_MANAGER_STOP_TIMEOUT_MS)) != pdTRUE) {
+        // A handler is still running; nothing is freed under it
+        ESP_LOGW(TAG, "Dispatch task did not finish in time");
+        return ESP_ERR_TIMEOUT;
     }
+    s_event_manager.dispatch_task = NULL;
     
     // Clean up statistics
     if (xSemaphoreTake(s_event_manager.mutex, pdMS_TO_TICKS(1000)) == pdTRUE) {
-        event_stats_entry_t *entry = s_event_manager.stats_list;
-        while (entry) {
-            event_stats_entry_t *next = entry->next;
-            free(entry);
-            entry = next;
-        }
-        s_event_manager.stats_list = NULL;
+        free_event_stats();
         xSemaphoreGive(s_event_manager.mutex);
     }
     
-    // Clean up mutex
-    if (s_event_manager.mutex) {
-        vSemaphoreDelete(s_event_manager.mutex);
-        s_event_manager.mutex = NULL;
-    }
+    // Clean up event loop, lanes and mutexes
+    release_resources();
     
     // Reset state
     memset(&s_event_manager, 0, sizeof(s_event_manager));
@@ -279,10 +426,13 @@ esp_err_t event_manager_get_status(event_manager_status_t *status)
     
     status->initialized = s_event_manager.initialized;
     status->running = s_event_manager.running;
-    status->total_events_sent = s_event_manager.total_events_sent;
-    status->total_events_received = s_event_manager.total_events_received;
+    status->total_events_sent = __atomic_load_n(&s_event_manager.total_events_sent, __ATOMIC_RELAXED);
+    status->total_events_received = __atomic_load_n(&s_event_manager.total_events_received, __ATOMIC_RELAXED);
     status->active_handlers = s_event_manager.active_handlers;
     status->registered_bases = s_event_manager.registered_bases;
+    for (int lane = 0; lane < EVENT_MANAGER_PRIORITY_COUNT; lane++) {
+        event_queue_get_stats(&s_event_manager.lanes[lane], &status->lanes[lane]);
+    }
     
     xSemaphoreGive(s_event_manager.mutex);
     return ESP_OK;
@@ -373,31 +523,44 @@ esp_err_t event_manager_post_event(esp_event_base_t event_base,
                                    const void *event_data,
                                    size_t event_data_size,
                                    uint32_t timeout_ms)
+{
+    // Posting never waits, timeout_ms only remains for existing callers
+    (void)timeout_ms;
+    
+    return event_manager_post_event_with_priority(event_base, event_id,
+                                                  event_data, event_data_size,
+                                                  EVENT_MANAGER_PRIORITY_NORMAL);
+}
+
+esp_err_t event_manager_post_event_with_priority(esp_event_base_t event_base,
+                                                 int32_t event_id,
+                                                 const void *event_data,
+                                                 size_t event_data_size,
+                                                 event_manager_priority_t priority)
 {
     if (!s_event_manager.initialized) {
         return ESP_ERR_INVALID_STATE;
     }
     
-    TickType_t timeout_ticks = (timeout_ms == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    if ((unsigned)priority >= EVENT_MANAGER_PRIORITY_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
     
-    esp_err_t ret = esp_event_post_to(s_event_manager.event_loop,
-                                     event_base,
-                                     event_id,
-                                     event_data,
-                                     event_data_size,
-                                     timeout_ticks);
+    esp_err_t ret = event_queue_push(&s_event_manager.lanes[priority], event_base, event_id,
+                                     event_data, event_data_size);
     
     if (ret == ESP_OK) {
-        if (xSemaphoreTake(s_event_manager.mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
-            s_event_manager.total_events_sent++;
-            xSemaphoreGive(s_event_manager.mutex);
-        }
-        
-        update_event_stats(event_base, event_id);
+        __atomic_fetch_add(&s_event_manager.total_events_sent, 1, __ATOMIC_RELAXED);
+        xTaskNotifyGive(s_event_manager.dispatch_task);
         
         if (s_event_manager.logging_enabled) {
-            ESP_LOGI(TAG, "Event posted - Base: %s, ID: %" PRId32, event_base, event_id);
+            ESP_LOGI(TAG, "Event posted - Base: %s, ID: %" PRId32 ", lane: %s",
+                     event_base, event_id, s_lane_names[priority]);
         }
+    } else if (ret == ESP_ERR_TIMEOUT) {
+        // Counted in the lane statistics; a storm must not also flood the log
+        ESP_LOGD(TAG, "Event dropped, %s priority lane full - Base: %s, ID: %" PRId32,
+                 s_lane_names[priority], event_base, event_id);
     } else {
         ESP_LOGW(TAG, "Failed to post event: %s", esp_err_to_name(ret));
     }
@@ -405,6 +568,93 @@ esp_err_t event_manager_post_event(esp_event_base_t event_base,
     return ret;
 }
 
+esp_err_t event_manager_post_event_isr(esp_event_base_t event_base,
+                                       int32_t event_id,
+                                       const void *event_data,
+                                       size_t event_data_size,
+                                       BaseType_t *higher_priority_task_woken)
+{
+    if (!s_event_manager.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    esp_err_t ret = event_queue_push(&s_event_manager.lanes[EVENT_MANAGER_PRIORITY_NORMAL],
+                                     event_base, event_id, event_data, event_data_size);
+    
+    if (ret == ESP_OK) {
+        __atomic_fetch_add(&s_event_manager.total_events_sent, 1, __ATOMIC_RELAXED);
+        vTaskNotifyGiveFromISR(s_event_manager.dispatch_task, higher_priority_task_woken);
+    }
+    
+    return ret;
+}
+
+esp_err_t event_manager_get_statistics(event_manager_stats_t *stats,
+                                       size_t max_stats,
+                                       size_t *actual_stats)
+{
+    if (!stats || !actual_stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (!s_event_manager.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (xSemaphoreTake(s_event_manager.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    
+    // The dispatch task may add entries at the head and bump counters while
+    // this copies; the mutex only keeps deinit from freeing the list
+    size_t count = 0;
+    for (event_stats_entry_t *entry = __atomic_load_n(&s_event_manager.stats_list,
+                                                      __ATOMIC_ACQUIRE);
+         entry && count < max_stats; entry = entry->next) {
+        uint32_t send_count = __atomic_load_n(&entry->send_count, __ATOMIC_RELAXED);
+        if (send_count == 0) {
+            continue; // Cleared by event_manager_reset_statistics
+        }
+        stats[count].event_base = entry->event_base;
+        stats[count].event_id = entry->event_id;
+        stats[count].send_count = send_count;
+        stats[count].handler_count = entry->handler_count;
+        stats[count].last_sent_time = __atomic_load_n(&entry->last_sent_time, __ATOMIC_RELAXED);
+        stats[count].priority = __atomic_load_n(&entry->priority, __ATOMIC_RELAXED);
+        count++;
+    }
+    
+    xSemaphoreGive(s_event_manager.mutex);
+    *actual_stats = count;
+    return ESP_OK;
+}
+
+esp_err_t event_manager_reset_statistics(void)
+{
+    if (!s_event_manager.initialized) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    if (xSemaphoreTake(s_event_manager.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+    
+    // The dispatch task may be walking the list, so entries are cleared in
+    // place rather than freed; cleared entries are not reported
+    for (event_stats_entry_t *entry = __atomic_load_n(&s_event_manager.stats_list,
+                                                      __ATOMIC_ACQUIRE);
+         entry; entry = entry->next) {
+        __atomic_store_n(&entry->send_count, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&entry->last_sent_time, 0, __ATOMIC_RELAXED);
+    }
+    for (int lane = 0; lane < EVENT_MANAGER_PRIORITY_COUNT; lane++) {
+        event_queue_reset_stats(&s_event_manager.lanes[lane]);
+    }
+    
+    xSemaphoreGive(s_event_manager.mutex);
+    return ESP_OK;
+}
+
 esp_err_t event_manager_set_logging(bool enable)
 {
     s_event_manager.logging_enabled = enable;
@@ -427,5 +677,12 @@ void event_manager_print_status(void)
     ESP_LOGI(TAG, "Events received: %" PRIu32, status.total_events_received);
     ESP_LOGI(TAG, "Active handlers: %" PRIu32, status.active_handlers);
     ESP_LOGI(TAG, "Registered bases: %" PRIu32, status.registered_bases);
+    for (int lane = 0; lane < EVENT_MANAGER_PRIORITY_COUNT; lane++) {
+        const event_manager_lane_stats_t *stats = &status.lanes[lane];
+        ESP_LOGI(TAG, "Lane %s: %" PRIu32 "/%" PRIu32 " queued, high water %" PRIu32
+                 ", delivered %" PRIu32 ", dropped %" PRIu32 ", coalesced %" PRIu32,
+                 s_lane_names[lane], stats->depth, stats->capacity, stats->high_water,
+                 stats->delivered, stats->dropped, stats->coalesced);
+    }
     ESP_LOGI(TAG, "Free heap: %" PRIu32 " bytes", esp_get_free_heap_size());
 }
\ No newline at end of file
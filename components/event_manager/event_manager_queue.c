@@ -0,0 +1,272 @@
+/**
+ * @file event_manager_queue.c
+ * @brief Bounded lock-free multi-producer event queue (one priority lane)
+ *
+ * @author robOS Team
+ * @date 2025
+ */
+
+#include "event_manager_queue.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* ============================================================================
+ * Private Helpers
+ * ============================================================================
+ */
+
+static bool cell_try_lock(event_queue_cell_t *cell)
+{
+    return __atomic_exchange_n(&cell->busy, 1, __ATOMIC_ACQUIRE) == 0;
+}
+
+static void cell_unlock(event_queue_cell_t *cell)
+{
+    __atomic_store_n(&cell->busy, 0, __ATOMIC_RELEASE);
+}
+
+static void note_depth(event_queue_t *queue, int32_t depth)
+{
+    if (depth <= 0) {
+        return; // The consumer was faster than this producer
+    }
+    uint32_t value = (uint32_t)depth > queue->capacity ? queue->capacity : (uint32_t)depth;
+    uint32_t high = __atomic_load_n(&queue->high_water, __ATOMIC_RELAXED);
+    while (value > high &&
+           !__atomic_compare_exchange_n(&queue->high_water, &high, value, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+/**
+ * @brief Take the event at the tail, copying it to event unless NULL
+ */
+static esp_err_t queue_take(event_queue_t *queue, event_queue_event_t *event)
+{
+    uint32_t mask = queue->capacity - 1;
+
+    for (;;) {
+        uint32_t pos = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+        event_queue_cell_t *cell = &queue->cells[pos & mask];
+        int32_t diff = (int32_t)(__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - (pos + 1));
+
+        if (diff < 0) {
+            return ESP_ERR_NOT_FOUND; // Empty, or the producer is still copying
+        }
+        if (diff > 0) {
+            continue; // Taken by someone else since tail was read
+        }
+        if (!cell_try_lock(cell)) {
+            return ESP_ERR_NOT_FINISHED;
+        }
+
+        // With the flag held nobody else can take or overwrite the cell, and
+        // if tail is still pos the cell still holds position pos
+        bool taken = __atomic_compare_exchange_n(&queue->tail, &pos, pos + 1, false,
+                                                 __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+        if (taken) {
+            if (event) {
+                event->base = cell->event.base;
+                event->id = cell->event.id;
+                event->size = cell->event.size;
+                memcpy(event->data.bytes, cell->event.data.bytes, cell->event.size);
+            }
+            __atomic_store_n(&cell->sequence, pos + queue->capacity, __ATOMIC_RELEASE);
+        }
+        cell_unlock(cell);
+
+        if (taken) {
+            return ESP_OK;
+        }
+    }
+}
+
+/**
+ * @brief Overwrite the newest pending event with the same base and ID
+ */
+static bool queue_coalesce(event_queue_t *queue, esp_event_base_t base, int32_t id,
+                           const void *data, size_t size)
+{
+    uint32_t mask = queue->capacity - 1;
+    uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    uint32_t pending = head - tail;
+
+    if ((int32_t)pending <= 0) {
+        return false;
+    }
+    if (pending > queue->capacity) {
+        pending = queue->capacity;
+    }
+
+    // Newest first: overwriting an older one would deliver the new data
+    // before the data of the newer pending event
+    for (uint32_t i = 1; i <= pending; i++) {
+        uint32_t pos = head - i;
+        event_queue_cell_t *cell = &queue->cells[pos & mask];
+
+        if (__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) != pos + 1 ||
+            __atomic_load_n(&cell->event.base, __ATOMIC_RELAXED) != base ||
+            __atomic_load_n(&cell->event.id, __ATOMIC_RELAXED) != id) {
+            continue;
+        }
+        if (!cell_try_lock(cell)) {
+            return false; // Being taken or overwritten, never wait for it
+        }
+
+        // The sequence only grows, so this means the cell was not taken
+        bool still_pending = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) == pos + 1;
+        if (still_pending) {
+            cell->event.size = (uint32_t)size;
+            if (size > 0) {
+                memcpy(cell->event.data.bytes, data, size);
+            }
+        }
+        cell_unlock(cell);
+
+        // If it was taken, so were all older events with this ID
+        return still_pending;
+    }
+    return false;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ============================================================================
+ */
+
+esp_err_t event_queue_init(event_queue_t *queue, uint32_t capacity,
+                           event_manager_overflow_t overflow)
+{
+    if (!queue || capacity < 2 || (capacity & (capacity - 1)) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    memset(queue, 0, sizeof(*queue));
+    queue->cells = calloc(capacity, sizeof(*queue->cells));
+    if (!queue->cells) {
+        return ESP_ERR_NO_MEM;
+    }
+    for (uint32_t i = 0; i < capacity; i++) {
+        queue->cells[i].sequence = i;
+    }
+    queue->capacity = capacity;
+    queue->overflow = overflow;
+    return ESP_OK;
+}
+
+void event_queue_deinit(event_queue_t *queue)
+{
+    if (!queue) {
+        return;
+    }
+    free(queue->cells);
+    queue->cells = NULL;
+    queue->capacity = 0;
+}
+
+esp_err_t event_queue_push(event_queue_t *queue, esp_event_base_t base,
+                           int32_t id, const void *data, size_t size)
+{
+    if (!queue || !queue->cells || (!data && size > 0)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (size > EVENT_MANAGER_EVENT_DATA_MAX) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    uint32_t mask = queue->capacity - 1;
+    uint32_t evictions = 0;
+
+    for (;;) {
+        uint32_t pos = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+        event_queue_cell_t *cell = &queue->cells[pos & mask];
+        int32_t diff = (int32_t)(__atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE) - pos);
+
+        if (diff == 0) {
+            if (!__atomic_compare_exchange_n(&queue->head, &pos, pos + 1, true,
+                                             __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                continue; // Another producer claimed this position
+            }
+
+            // The cell is ours until its sequence is published
+            __atomic_store_n(&cell->event.base, base, __ATOMIC_RELAXED);
+            __atomic_store_n(&cell->event.id, id, __ATOMIC_RELAXED);
+            cell->event.size = (uint32_t)size;
+            if (size > 0) {
+                memcpy(cell->event.data.bytes, data, size);
+            }
+            __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_RELEASE);
+
+            __atomic_fetch_add(&queue->posted, 1, __ATOMIC_RELAXED);
+            note_depth(queue, (int32_t)(pos + 1 - __atomic_load_n(&queue->tail, __ATOMIC_RELAXED)));
+            return ESP_OK;
+        }
+        if (diff > 0) {
+            continue; // head moved on since it was read
+        }
+
+        // Full: the cell still holds the event from one lap ago
+        if (queue->overflow == EVENT_MANAGER_OVERFLOW_DROP_OLDEST && evictions < queue->capacity) {
+            evictions++;
+            if (queue_take(queue, NULL) == ESP_OK) {
+                __atomic_fetch_add(&queue->dropped, 1, __ATOMIC_RELAXED);
+            }
+            continue;
+        }
+        if (queue->overflow == EVENT_MANAGER_OVERFLOW_COALESCE &&
+            queue_coalesce(queue, base, id, data, size)) {
+            __atomic_fetch_add(&queue->coalesced, 1, __ATOMIC_RELAXED);
+            return ESP_OK;
+        }
+
+        __atomic_fetch_add(&queue->dropped, 1, __ATOMIC_RELAXED);
+        return ESP_ERR_TIMEOUT;
+    }
+}
+
+esp_err_t event_queue_pop(event_queue_t *queue, event_queue_event_t *event)
+{
+    if (!queue || !queue->cells || !event) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = queue_take(queue, event);
+    if (ret == ESP_OK) {
+        __atomic_fetch_add(&queue->delivered, 1, __ATOMIC_RELAXED);
+    }
+    return ret;
+}
+
+uint32_t event_queue_depth(const event_queue_t *queue)
+{
+    uint32_t tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    uint32_t head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    int32_t depth = (int32_t)(head - tail);
+
+    if (depth <= 0) {
+        return 0;
+    }
+    return (uint32_t)depth > queue->capacity ? queue->capacity : (uint32_t)depth;
+}
+
+void event_queue_get_stats(const event_queue_t *queue,
+                           event_manager_lane_stats_t *stats)
+{
+    stats->capacity = queue->capacity;
+    stats->depth = event_queue_depth(queue);
+    stats->high_water = __atomic_load_n(&queue->high_water, __ATOMIC_RELAXED);
+    stats->posted = __atomic_load_n(&queue->posted, __ATOMIC_RELAXED);
+    stats->delivered = __atomic_load_n(&queue->delivered, __ATOMIC_RELAXED);
+    stats->dropped = __atomic_load_n(&queue->dropped, __ATOMIC_RELAXED);
+    stats->coalesced = __atomic_load_n(&queue->coalesced, __ATOMIC_RELAXED);
+}
+
+void event_queue_reset_stats(event_queue_t *queue)
+{
+    __atomic_store_n(&queue->posted, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->delivered, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->dropped, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->coalesced, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&queue->high_water, event_queue_depth(queue), __ATOMIC_RELAXED);
+}
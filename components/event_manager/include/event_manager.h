@@ -11,6 +11,13 @@
  * - Event logging and debugging support
  * - Component lifecycle event tracking
  * - Performance monitoring and statistics
+ * - Non-blocking posting through bounded lock-free priority lanes
+ *
+ * Posting never waits: the event is copied into the lane of its priority
+ * (a bounded multi-producer queue, see event_manager_queue.h) and a dispatch
+ * task hands it to the handlers, high lane first. When a lane is full its
+ * overflow policy decides which event is lost, and the loss is counted in
+ * the lane statistics instead of stalling the posting task.
  * 
  * @author robOS Team
  * @date 2025
@@ -37,15 +44,64 @@ extern "C" {
  */
 #define EVENT_MANAGER_MAX_EVENT_BASES 20
 
+/**
+ * @brief Largest event data carried by a lane (bytes)
+ *
+ * Lane slots hold the data inline; matrix_led_event_data_t is 72 bytes.
+ */
+#define EVENT_MANAGER_EVENT_DATA_MAX 80
+
+/**
+ * @brief Event priority, one lane each
+ */
+typedef enum {
+    EVENT_MANAGER_PRIORITY_HIGH,        ///< Delivered before the other lanes
+    EVENT_MANAGER_PRIORITY_NORMAL,      ///< Lane of event_manager_post_event()
+    EVENT_MANAGER_PRIORITY_LOW,         ///< Delivered when the other lanes are empty
+    EVENT_MANAGER_PRIORITY_COUNT,
+} event_manager_priority_t;
+
+/**
+ * @brief What a post does when its lane is full
+ */
+typedef enum {
+    EVENT_MANAGER_OVERFLOW_DROP_NEWEST, ///< Refuse the new event (ESP_ERR_TIMEOUT)
+    EVENT_MANAGER_OVERFLOW_DROP_OLDEST, ///< Discard the oldest pending event to make room
+    EVENT_MANAGER_OVERFLOW_COALESCE,    ///< Overwrite the data of the newest pending event
+                                        ///< with the same base and ID, else drop the new one
+} event_manager_overflow_t;
+
+/**
+ * @brief Lane configuration
+ */
+typedef struct {
+    size_t capacity;                    ///< Events the lane holds, a power of two (0: default)
+    event_manager_overflow_t overflow;  ///< Overflow policy
+} event_manager_lane_config_t;
+
+/**
+ * @brief Lane statistics
+ */
+typedef struct {
+    uint32_t capacity;                  ///< Events the lane holds
+    uint32_t depth;                     ///< Events waiting now
+    uint32_t high_water;                ///< Highest depth since the last reset
+    uint32_t posted;                    ///< Events queued
+    uint32_t delivered;                 ///< Events handed to the handlers
+    uint32_t dropped;                   ///< Events lost to overflow (refused or discarded)
+    uint32_t coalesced;                 ///< Posts merged into a pending event
+} event_manager_lane_stats_t;
+
 /**
  * @brief Event Manager Configuration
  */
 typedef struct {
-    size_t event_queue_size;        ///< Size of the event queue (default: 32)
+    size_t event_queue_size;        ///< Size of the esp_event queue behind the lanes (default: 32)
     size_t event_task_stack_size;   ///< Stack size for event task (default: 4096)
     int event_task_priority;        ///< Priority of event task (default: 5)
     bool enable_statistics;         ///< Enable event statistics collection
     bool enable_logging;            ///< Enable event logging
+    event_manager_lane_config_t lanes[EVENT_MANAGER_PRIORITY_COUNT]; ///< Priority lanes
 } event_manager_config_t;
 
 /**
@@ -58,6 +114,7 @@ typedef struct {
     uint32_t total_events_received; ///< Total events received
     uint32_t active_handlers;       ///< Number of active event handlers
     uint32_t registered_bases;      ///< Number of registered event bases
+    event_manager_lane_stats_t lanes[EVENT_MANAGER_PRIORITY_COUNT]; ///< Depth, high-water mark and losses per lane
 } event_manager_status_t;
 
 /**
@@ -92,6 +149,7 @@ typedef struct {
     uint32_t send_count;            ///< Number of times this event was sent
     uint32_t handler_count;         ///< Number of handlers for this event
     uint64_t last_sent_time;        ///< Last time this event was sent (microseconds)
+    event_manager_priority_t priority; ///< Lane the event last came through
 } event_manager_stats_t;
 
 // Declare the event manager's own event base
@@ -99,6 +157,10 @@ ESP_EVENT_DECLARE_BASE(EVENT_MANAGER_EVENTS);
 
 /**
  * @brief Get default configuration for event manager
+ *
+ * Lanes: high 16 events dropping the newest (a lost error is reported to
+ * its poster), normal 32 coalescing, low 16 dropping the oldest.
+ *
  * @return Default configuration structure
  */
 event_manager_config_t event_manager_get_default_config(void);
@@ -186,12 +248,15 @@ esp_err_t event_manager_unregister_handler(esp_event_base_t event_base,
                                            event_manager_handler_t event_handler);
 
 /**
- * @brief Post an event
+ * @brief Post an event to the normal priority lane
+ *
+ * Never blocks, see event_manager_post_event_with_priority().
+ *
  * @param event_base Event base
  * @param event_id Event ID
  * @param event_data Event data (will be copied)
- * @param event_data_size Size of event data
- * @param timeout_ms Timeout in milliseconds (portMAX_DELAY for no timeout)
+ * @param event_data_size Size of event data (at most EVENT_MANAGER_EVENT_DATA_MAX)
+ * @param timeout_ms Unused, kept for existing callers; posting does not wait
  * @return ESP_OK on success
  */
 esp_err_t event_manager_post_event(esp_event_base_t event_base,
@@ -201,7 +266,29 @@ esp_err_t event_manager_post_event(esp_event_base_t event_base,
                                    uint32_t timeout_ms);
 
 /**
- * @brief Post an event from ISR context
+ * @brief Post an event to a priority lane
+ *
+ * Copies the event into the lane and wakes the dispatch task; it never
+ * blocks, whatever the handlers or other posting tasks are doing. When the
+ * lane is full the lane's overflow policy applies.
+ *
+ * @param event_base Event base
+ * @param event_id Event ID
+ * @param event_data Event data (will be copied)
+ * @param event_data_size Size of event data (at most EVENT_MANAGER_EVENT_DATA_MAX)
+ * @param priority Lane
+ * @return ESP_OK if queued, coalesced, or queued after discarding the oldest event;
+ *         ESP_ERR_TIMEOUT if the lane was full and the event was dropped;
+ *         ESP_ERR_INVALID_SIZE if the data is too large
+ */
+esp_err_t event_manager_post_event_with_priority(esp_event_base_t event_base,
+                                                 int32_t event_id,
+                                                 const void *event_data,
+                                                 size_t event_data_size,
+                                                 event_manager_priority_t priority);
+
+/**
+ * @brief Post an event from ISR context to the normal priority lane
  * @param event_base Event base
  * @param event_id Event ID
  * @param event_data Event data (will be copied)
@@ -228,6 +315,10 @@ esp_err_t event_manager_get_statistics(event_manager_stats_t *stats,
 
 /**
  * @brief Reset event statistics
+ *
+ * Clears the per-event statistics and the lane counters; lane high-water
+ * marks restart from the current depth.
+ *
  * @return ESP_OK on success
  */
 esp_err_t event_manager_reset_statistics(void);
@@ -0,0 +1,161 @@
+/**
+ * @file event_manager_queue.h
+ * @brief Bounded lock-free multi-producer event queue (one priority lane)
+ *
+ * A ring of fixed-size cells, each with its own sequence number (Vyukov's
+ * bounded queue). A producer claims a position with one compare-and-swap
+ * on head, copies the event into the cell and publishes it by advancing
+ * the cell's sequence; no producer ever waits for another producer or for
+ * the consumer, so posting from any task or ISR takes a bounded time.
+ *
+ * When the ring is full the overflow policy applies:
+ * - DROP_NEWEST refuses the new event.
+ * - DROP_OLDEST takes the oldest pending event off the ring (the same way
+ *   the consumer does) and retries, at most capacity times.
+ * - COALESCE looks for the newest pending event with the same base and ID
+ *   and overwrites its data, so a burst of updates is delivered as the
+ *   latest value without reordering; without one the new event is refused.
+ *
+ * Overwriting a pending cell, and taking one, is guarded by a per-cell busy
+ * flag that is only ever tried, never waited on. A producer that finds it
+ * set falls back to dropping its event; the consumer gets ESP_ERR_NOT_FINISHED
+ * and retries later, which only happens while a coalescing post is copying
+ * its data.
+ *
+ * Counters are updated with relaxed atomics and may be read from any task.
+ *
+ * This module does not depend on FreeRTOS and can be compiled on the host
+ * (see tests/host/bench_event_queue.c).
+ *
+ * @author robOS Team
+ * @date 2025
+ */
+
+#pragma once
+
+#include "event_manager.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief One event taken from a queue
+ */
+typedef struct {
+    esp_event_base_t base;              ///< Event base
+    int32_t id;                         ///< Event ID
+    uint32_t size;                      ///< Bytes of data
+    union {
+        uint8_t bytes[EVENT_MANAGER_EVENT_DATA_MAX];
+        uint64_t align;                 ///< Handlers cast the data to their structs
+    } data;                             ///< Event data
+} event_queue_event_t;
+
+/**
+ * @brief Queue cell
+ */
+typedef struct {
+    uint32_t sequence;                  ///< Position this cell is ready for (see file comment)
+    uint32_t busy;                      ///< Payload being overwritten or taken
+    event_queue_event_t event;          ///< Event
+} event_queue_cell_t;
+
+/**
+ * @brief Bounded multi-producer queue
+ *
+ * head and tail are free-running positions; a cell is ready for producers
+ * at position p when its sequence is p, and holds the event of position p
+ * when its sequence is p + 1.
+ */
+typedef struct {
+    event_queue_cell_t *cells;          ///< Storage
+    uint32_t capacity;                  ///< Cells (power of two)
+    event_manager_overflow_t overflow;  ///< Overflow policy
+    uint32_t head;                      ///< Next position to fill (producers)
+    uint32_t tail;                      ///< Next position to take (consumer, evicting producers)
+
+    // Counters
+    uint32_t posted;                    ///< Events queued
+    uint32_t delivered;                 ///< Events taken by the consumer
+    uint32_t dropped;                   ///< Events refused or discarded
+    uint32_t coalesced;                 ///< Posts merged into a pending event
+    uint32_t high_water;                ///< Highest depth seen
+} event_queue_t;
+
+/**
+ * @brief Allocate a queue
+ *
+ * @param queue Queue
+ * @param capacity Cells, a power of two (at least 2)
+ * @param overflow Overflow policy
+ * @return ESP_OK, ESP_ERR_INVALID_ARG or ESP_ERR_NO_MEM
+ */
+esp_err_t event_queue_init(event_queue_t *queue, uint32_t capacity,
+                           event_manager_overflow_t overflow);
+
+/**
+ * @brief Free a queue
+ *
+ * No producer or consumer may be using it.
+ *
+ * @param queue Queue
+ */
+void event_queue_deinit(event_queue_t *queue);
+
+/**
+ * @brief Add an event (any number of producers, never blocks)
+ *
+ * @param queue Queue
+ * @param base Event base
+ * @param id Event ID
+ * @param data Event data (copied), may be NULL if size is 0
+ * @param size Bytes of data, at most EVENT_MANAGER_EVENT_DATA_MAX
+ * @return ESP_OK if queued, coalesced or queued after discarding the oldest
+ *         event; ESP_ERR_TIMEOUT if the queue was full and the event was
+ *         dropped; ESP_ERR_INVALID_SIZE or ESP_ERR_INVALID_ARG
+ */
+esp_err_t event_queue_push(event_queue_t *queue, esp_event_base_t base,
+                           int32_t id, const void *data, size_t size);
+
+/**
+ * @brief Take the oldest event (one consumer)
+ *
+ * @param queue Queue
+ * @param event Output
+ * @return ESP_OK, ESP_ERR_NOT_FOUND if the queue is empty, or
+ *         ESP_ERR_NOT_FINISHED if a coalescing post is overwriting the oldest
+ *         event right now (try again after letting it run)
+ */
+esp_err_t event_queue_pop(event_queue_t *queue, event_queue_event_t *event);
+
+/**
+ * @brief Events waiting (any task)
+ *
+ * @param queue Queue
+ * @return Depth, at most the capacity
+ */
+uint32_t event_queue_depth(const event_queue_t *queue);
+
+/**
+ * @brief Read the counters (any task)
+ *
+ * @param queue Queue
+ * @param stats Output
+ */
+void event_queue_get_stats(const event_queue_t *queue,
+                           event_manager_lane_stats_t *stats);
+
+/**
+ * @brief Clear the counters; the high-water mark restarts from the depth
+ *
+ * @param queue Queue
+ */
+void event_queue_reset_stats(event_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
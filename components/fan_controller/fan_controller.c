@@ -7,9 +7,11 @@
  */
 
 #include "fan_controller.h"
+#include "agx_monitor.h"
 #include "config_manager.h"
 #include "console_core.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
@@ -33,6 +35,7 @@ static const char *TAG = "FAN_CONTROLLER";
 #define DEFAULT_PWM_FREQUENCY 25000 // 25kHz
 #define DEFAULT_PWM_RESOLUTION 10   // 10-bit resolution (0-1023)
 #define FAN_CONFIG_NAMESPACE "fan_config"
+#define FAN_AGX_STALE_TIME_US (10 * 1000000ULL) // Same limit as console_core
 
 /* ============================================================================
  * Private Type Definitions
@@ -45,17 +48,18 @@ typedef struct {
   fan_curve_point_t *curve_points;
   uint8_t num_curve_points;
   bool curve_enabled;
+  fan_curve_lut_t curve_lut;     ///< curve_points compiled for the tick
+  fan_temp_source_t temp_source; ///< Temperature the fan follows
+  float source_temperature;      ///< Last reading from temp_source (°C)
 
   // Temperature hysteresis and rate limiting
-  float
-      last_stable_temperature; ///< Last temperature that triggered speed change
-  uint8_t target_speed_percent;       ///< Target speed from curve calculation
-  uint8_t last_applied_speed;         ///< Last actually applied speed
-  uint32_t last_speed_change_time;    ///< Timestamp of last speed change (ms)
-  float temperature_hysteresis;       ///< Temperature dead zone (default 3.0°C)
-  uint32_t min_speed_change_interval; ///< Minimum interval between speed
-                                      ///< changes (default 2000ms)
+  fan_curve_state_t curve_state; ///< Curve law state
   bool speed_changing; ///< Flag indicating gradual speed change in progress
+
+  // Predictive PID control
+  fan_pid_gains_t pid_gains; ///< PID tuning (persisted as fan_X_pid)
+  fan_pid_state_t pid_state; ///< PID integral and slope
+  uint32_t pid_last_time;    ///< Time of the last PID step (ms)
 } fan_instance_t;
 
 typedef struct {
@@ -68,6 +72,13 @@ typedef struct {
   bool enable_tachometer;
 } fan_controller_context_t;
 
+// Inputs read once per control tick and shared by all fans
+typedef struct {
+  float global_temperature; ///< console_get_effective_temperature()
+  bool agx_fresh;           ///< agx is valid and not older than the limit
+  agx_monitor_data_t agx;   ///< AGX snapshot
+} fan_tick_inputs_t;
+
 /* ============================================================================
  * Private Variables
  * ============================================================================
@@ -75,6 +86,13 @@ typedef struct {
 
 static fan_controller_context_t s_fan_ctx = {0};
 
+// Console names, indexed by fan_temp_source_t
+static const char *const s_temp_source_names[FAN_TEMP_SOURCE_MAX] = {
+    [FAN_TEMP_SOURCE_GLOBAL] = "global", [FAN_TEMP_SOURCE_AGX_CPU] = "cpu",
+    [FAN_TEMP_SOURCE_AGX_SOC0] = "soc0", [FAN_TEMP_SOURCE_AGX_SOC1] = "soc1",
+    [FAN_TEMP_SOURCE_AGX_SOC2] = "soc2", [FAN_TEMP_SOURCE_AGX_TJ] = "tj",
+    [FAN_TEMP_SOURCE_MANUAL] = "manual"};
+
 /* ============================================================================
  * Private Function Declarations
  * ============================================================================
@@ -84,9 +102,9 @@ static void fan_controller_task(void *pvParameters);
 static esp_err_t fan_controller_update_pwm(uint8_t fan_id,
                                            uint8_t speed_percent);
 static esp_err_t fan_controller_apply_curve(uint8_t fan_id, float temperature);
-static uint8_t fan_controller_interpolate_speed(const fan_curve_point_t *curve,
-                                                uint8_t num_points,
-                                                float temperature);
+static esp_err_t fan_controller_apply_pid(uint8_t fan_id, float temperature,
+                                          const fan_tick_inputs_t *inputs);
+static const char *fan_temp_source_to_string(fan_temp_source_t source);
 
 // Console command functions
 static esp_err_t cmd_fan_status(int argc, char **argv);
@@ -100,6 +118,10 @@ static esp_err_t save_fan_config(uint8_t fan_id);
 static esp_err_t save_fan_full_config(uint8_t fan_id);
 static esp_err_t load_fan_config(uint8_t fan_id);
 static esp_err_t load_fan_full_config(uint8_t fan_id);
+static esp_err_t save_fan_pid_config(uint8_t fan_id);
+static esp_err_t load_fan_pid_config(uint8_t fan_id);
+static esp_err_t save_fan_source_config(uint8_t fan_id);
+static esp_err_t load_fan_source_config(uint8_t fan_id);
 static esp_err_t load_all_fan_configs(void);
 
 // Full configuration structure for saving runtime state
@@ -117,6 +139,22 @@ typedef struct {
   uint32_t version;              // Configuration version for compatibility
 } fan_full_config_t;
 
+// PID tuning, stored under its own key so fan_full_config_t keeps its layout
+typedef struct {
+  fan_pid_gains_t gains; // PID tuning
+  uint32_t version;      // Configuration version for compatibility
+} fan_pid_config_t;
+
+#define FAN_PID_CONFIG_VERSION 1
+
+// Temperature source binding, stored as fan_X_src
+typedef struct {
+  uint8_t temp_source; // fan_temp_source_t
+  uint32_t version;    // Configuration version for compatibility
+} fan_source_config_t;
+
+#define FAN_SOURCE_CONFIG_VERSION 1
+
 /* ============================================================================
  * Public Function Implementations
  * ============================================================================
@@ -208,16 +246,26 @@ esp_err_t fan_controller_init(const fan_controller_config_t *config) {
     fan->curve_points = NULL;
     fan->num_curve_points = 0;
     fan->curve_enabled = false;
+    fan_curve_compile(NULL, 0, &fan->curve_lut);
+    fan->temp_source = FAN_TEMP_SOURCE_GLOBAL;
+    fan->source_temperature = 25.0f;
 
     // Initialize temperature hysteresis and rate limiting
-    fan->last_stable_temperature = 25.0f;
-    fan->target_speed_percent = fan->config.default_speed;
-    fan->last_applied_speed = fan->config.default_speed;
-    fan->last_speed_change_time = 0;
-    fan->temperature_hysteresis = FAN_CONTROLLER_DEFAULT_TEMP_HYSTERESIS;
-    fan->min_speed_change_interval = FAN_CONTROLLER_MIN_SPEED_CHANGE_INTERVAL;
+    fan->curve_state.last_stable_temperature = 25.0f;
+    fan->curve_state.target_speed_percent = fan->config.default_speed;
+    fan->curve_state.last_applied_speed = fan->config.default_speed;
+    fan->curve_state.last_speed_change_time = 0;
+    fan->curve_state.temperature_hysteresis =
+        FAN_CONTROLLER_DEFAULT_TEMP_HYSTERESIS;
+    fan->curve_state.min_speed_change_interval =
+        FAN_CONTROLLER_MIN_SPEED_CHANGE_INTERVAL;
     fan->speed_changing = false;
 
+    // Initialize PID control, continuing from the default speed
+    fan->pid_gains = fan_pid_get_default_gains();
+    fan_pid_reset(&fan->pid_state, fan->config.default_speed);
+    fan->pid_last_time = 0;
+
     // Do NOT configure PWM here - it will be done after loading saved config
   }
 
@@ -348,7 +396,12 @@ esp_err_t fan_controller_set_mode(uint8_t fan_id, fan_mode_t mode) {
     return ESP_ERR_TIMEOUT;
   }
 
-  s_fan_ctx.fans[fan_id].status.mode = mode;
+  fan_instance_t *fan = &s_fan_ctx.fans[fan_id];
+  if (mode == FAN_MODE_AUTO_PID && fan->status.mode != FAN_MODE_AUTO_PID) {
+    // Continue from the current speed instead of jumping
+    fan_pid_reset(&fan->pid_state, fan->status.speed_percent);
+  }
+  fan->status.mode = mode;
 
   xSemaphoreGive(s_fan_ctx.mutex);
 
@@ -558,8 +611,8 @@ fan_controller_configure_hysteresis(uint8_t fan_id,
   }
 
   fan_instance_t *fan = &s_fan_ctx.fans[fan_id];
-  fan->temperature_hysteresis = temperature_hysteresis;
-  fan->min_speed_change_interval = min_speed_change_interval;
+  fan->curve_state.temperature_hysteresis = temperature_hysteresis;
+  fan->curve_state.min_speed_change_interval = min_speed_change_interval;
 
   ESP_LOGI(TAG, "Fan %d hysteresis configured: %.1f°C, %ldms", fan_id,
            temperature_hysteresis, (long)min_speed_change_interval);
@@ -571,6 +624,96 @@ fan_controller_configure_hysteresis(uint8_t fan_id,
   return ESP_OK;
 }
 
+esp_err_t fan_controller_set_pid_gains(uint8_t fan_id,
+                                       const fan_pid_gains_t *gains) {
+  if (!s_fan_ctx.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (fan_id >= s_fan_ctx.num_fans || !fan_pid_gains_valid(gains)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (xSemaphoreTake(s_fan_ctx.mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+
+  fan_instance_t *fan = &s_fan_ctx.fans[fan_id];
+  fan->pid_gains = *gains;
+  // Re-prime so the new gains take over from the current speed
+  fan_pid_reset(&fan->pid_state, fan->status.speed_percent);
+
+  ESP_LOGI(TAG,
+           "Fan %d PID configured: setpoint %.1f°C, kp %.2f, ki %.3f, kd %.1f",
+           fan_id, gains->setpoint, gains->kp, gains->ki, gains->kd);
+
+  // Save configuration to NVS
+  save_fan_pid_config(fan_id);
+
+  xSemaphoreGive(s_fan_ctx.mutex);
+  return ESP_OK;
+}
+
+esp_err_t fan_controller_get_pid_gains(uint8_t fan_id,
+                                       fan_pid_gains_t *gains) {
+  if (!s_fan_ctx.initialized || gains == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (fan_id >= s_fan_ctx.num_fans) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (xSemaphoreTake(s_fan_ctx.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+
+  *gains = s_fan_ctx.fans[fan_id].pid_gains;
+
+  xSemaphoreGive(s_fan_ctx.mutex);
+  return ESP_OK;
+}
+
+esp_err_t fan_controller_set_temp_source(uint8_t fan_id,
+                                         fan_temp_source_t source) {
+  if (!s_fan_ctx.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (fan_id >= s_fan_ctx.num_fans || source >= FAN_TEMP_SOURCE_MAX) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (xSemaphoreTake(s_fan_ctx.mutex, pdMS_TO_TICKS(1000)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+
+  s_fan_ctx.fans[fan_id].temp_source = source;
+
+  ESP_LOGI(TAG, "Fan %d temperature source set to %s", fan_id,
+           fan_temp_source_to_string(source));
+
+  // Save configuration to NVS
+  save_fan_source_config(fan_id);
+
+  xSemaphoreGive(s_fan_ctx.mutex);
+  return ESP_OK;
+}
+
+esp_err_t fan_controller_get_temp_source(uint8_t fan_id,
+                                         fan_temp_source_t *source) {
+  if (!s_fan_ctx.initialized || source == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (fan_id >= s_fan_ctx.num_fans) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  *source = s_fan_ctx.fans[fan_id].temp_source;
+  return ESP_OK;
+}
+
 esp_err_t fan_controller_set_curve(uint8_t fan_id,
                                    const fan_curve_point_t *curve_points,
                                    uint8_t num_points) {
@@ -604,6 +747,7 @@ esp_err_t fan_controller_set_curve(uint8_t fan_id,
       (fan_curve_point_t *)malloc(sizeof(fan_curve_point_t) * num_points);
   if (fan->curve_points == NULL) {
     ESP_LOGE(TAG, "Failed to allocate memory for curve points");
+    fan_curve_compile(NULL, 0, &fan->curve_lut);
     xSemaphoreGive(s_fan_ctx.mutex);
     return ESP_ERR_NO_MEM;
   }
@@ -626,6 +770,9 @@ esp_err_t fan_controller_set_curve(uint8_t fan_id,
     }
   }
 
+  // Compile once here so the control tick only indexes a table
+  fan_curve_compile(fan->curve_points, num_points, &fan->curve_lut);
+
   ESP_LOGI(TAG, "Fan %d curve configured with %d points", fan_id, num_points);
   xSemaphoreGive(s_fan_ctx.mutex);
 
@@ -674,22 +821,63 @@ esp_err_t fan_controller_register_commands(void) {
  * ============================================================================
  */
 
-static float get_fan_temperature_for_mode(uint8_t fan_id) {
+static void fan_controller_read_tick_inputs(fan_tick_inputs_t *inputs) {
   // Use smart temperature source selection with priority system
-  float temperature = 25.0f;
   temp_source_type_t source;
+  if (console_get_effective_temperature(&inputs->global_temperature,
+                                        &source) != ESP_OK) {
+    inputs->global_temperature = 25.0f;
+  }
 
-  if (console_get_effective_temperature(&temperature, &source) == ESP_OK) {
-    return temperature;
+  // One lock-free snapshot serves every fan bound to an AGX sensor and the
+  // PID feed-forward
+  inputs->agx_fresh = false;
+  if (agx_monitor_get_latest_data(&inputs->agx) == ESP_OK &&
+      inputs->agx.is_valid) {
+    uint64_t age = esp_timer_get_time() - inputs->agx.update_time_us;
+    inputs->agx_fresh = age <= FAN_AGX_STALE_TIME_US;
   }
+}
 
-  // Fallback: use current status temperature if fan is valid
-  if (fan_id < s_fan_ctx.num_fans) {
-    return s_fan_ctx.fans[fan_id].status.temperature;
+static float agx_temperature_for_source(const agx_monitor_data_t *agx,
+                                       fan_temp_source_t source) {
+  switch (source) {
+  case FAN_TEMP_SOURCE_AGX_CPU:
+    return agx->temperature.cpu;
+  case FAN_TEMP_SOURCE_AGX_SOC0:
+    return agx->temperature.soc0;
+  case FAN_TEMP_SOURCE_AGX_SOC1:
+    return agx->temperature.soc1;
+  case FAN_TEMP_SOURCE_AGX_SOC2:
+    return agx->temperature.soc2;
+  case FAN_TEMP_SOURCE_AGX_TJ:
+    return agx->temperature.tj;
+  default:
+    return NAN;
   }
+}
 
-  // Final fallback
-  return 25.0f;
+static float get_fan_temperature_for_mode(uint8_t fan_id,
+                                          const fan_tick_inputs_t *inputs) {
+  fan_instance_t *fan = &s_fan_ctx.fans[fan_id];
+  float temperature = inputs->global_temperature;
+  int test_temperature;
+
+  if (fan->temp_source == FAN_TEMP_SOURCE_MANUAL) {
+    if (console_get_test_temperature(&test_temperature) == ESP_OK) {
+      temperature = (float)test_temperature;
+    }
+  } else if (fan->temp_source != FAN_TEMP_SOURCE_GLOBAL && inputs->agx_fresh) {
+    // Without fresh AGX data the shared temperature applies its startup,
+    // offline and stale fallbacks
+    float reading = agx_temperature_for_source(&inputs->agx, fan->temp_source);
+    if (reading >= -50.0f && reading <= 150.0f) {
+      temperature = reading;
+    }
+  }
+
+  fan->source_temperature = temperature;
+  return temperature;
 }
 
 static void fan_controller_task(void *pvParameters) {
@@ -699,7 +887,11 @@ static void fan_controller_task(void *pvParameters) {
   vTaskDelay(pdMS_TO_TICKS(500));
   ESP_LOGI(TAG, "Fan controller task ready, starting PWM operations");
 
+  // Static: the snapshot is too large for the task stack
+  static fan_tick_inputs_t inputs;
+
   while (1) {
+    fan_controller_read_tick_inputs(&inputs);
     for (uint8_t i = 0; i < s_fan_ctx.num_fans; i++) {
       fan_instance_t *fan = &s_fan_ctx.fans[i];
       if (fan->status.enabled) {
@@ -713,7 +905,12 @@ static void fan_controller_task(void *pvParameters) {
           break;
         case FAN_MODE_AUTO_CURVE:
           // Use test temperature for debugging
-          fan_controller_apply_curve(i, get_fan_temperature_for_mode(i));
+          fan_controller_apply_curve(i,
+                                     get_fan_temperature_for_mode(i, &inputs));
+          break;
+        case FAN_MODE_AUTO_PID:
+          fan_controller_apply_pid(i, get_fan_temperature_for_mode(i, &inputs),
+                                   &inputs);
           break;
         case FAN_MODE_OFF:
         default:
@@ -810,83 +1007,104 @@ static esp_err_t fan_controller_apply_curve(uint8_t fan_id, float temperature) {
 
   // Get current time for rate limiting
   uint32_t current_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
+  uint32_t last_change = fan->curve_state.last_speed_change_time;
 
-  // Calculate target speed based on current temperature
-  uint8_t target_speed = fan_controller_interpolate_speed(
-      fan->curve_points, fan->num_curve_points, temperature);
-
-  // Apply temperature hysteresis control
-  float temp_diff = fabsf(temperature - fan->last_stable_temperature);
-  bool significant_temp_change = temp_diff >= fan->temperature_hysteresis;
-
-  // Check if enough time has passed since last speed change
-  bool enough_time_passed = (current_time - fan->last_speed_change_time) >=
-                            fan->min_speed_change_interval;
-
-  // Update target speed
-  fan->target_speed_percent = target_speed;
-
-  // Decide whether to change speed
-  bool should_change_speed = false;
-  uint8_t new_speed = fan->last_applied_speed;
-
-  if (significant_temp_change && enough_time_passed) {
-    // Temperature changed significantly and enough time has passed
-    should_change_speed = true;
-    new_speed = target_speed;
-    fan->last_stable_temperature = temperature;
-    fan->last_speed_change_time = current_time;
-  } else if (!significant_temp_change) {
-    // Temperature is stable, keep current speed
-    new_speed = fan->last_applied_speed;
-  } else {
-    // Temperature changed but not enough time passed, keep current speed
-    new_speed = fan->last_applied_speed;
-  }
+  // Follow the curve outside the hysteresis dead zone, rate limited
+  uint8_t new_speed = fan_curve_step(&fan->curve_lut, &fan->curve_state,
+                                     temperature, current_time);
 
-  // Apply the speed if it changed
-  if (should_change_speed || new_speed != fan->last_applied_speed) {
-    fan->last_applied_speed = new_speed;
+  // Apply the speed if the curve law changed it
+  if (fan->curve_state.last_speed_change_time != last_change) {
     return fan_controller_update_pwm(fan_id, new_speed);
   }
 
   return ESP_OK;
 }
 
-static uint8_t fan_controller_interpolate_speed(const fan_curve_point_t *curve,
-                                                uint8_t num_points,
-                                                float temperature) {
-  if (curve == NULL || num_points == 0) {
-    return 0;
+static bool fan_controller_get_feedforward(const fan_tick_inputs_t *inputs,
+                                           fan_pid_feedforward_t *ff) {
+  if (!inputs->agx_fresh) {
+    return false;
   }
 
-  if (num_points == 1) {
-    return curve[0].speed_percent;
+  const agx_monitor_data_t *data = &inputs->agx;
+  ff->power_w = (data->power.gpu_soc.current + data->power.cpu_cv.current +
+                 data->power.sys_5v.current) /
+                1000.0f;
+  ff->gpu_load = data->gpu.gr3d_freq;
+  return true;
+}
+
+static esp_err_t fan_controller_apply_pid(uint8_t fan_id, float temperature,
+                                          const fan_tick_inputs_t *inputs) {
+  if (fan_id >= s_fan_ctx.num_fans) {
+    return ESP_ERR_INVALID_ARG;
   }
 
-  // Find the appropriate range for interpolation
-  if (temperature <= curve[0].temperature) {
-    return curve[0].speed_percent;
+  fan_instance_t *fan = &s_fan_ctx.fans[fan_id];
+  uint32_t current_time = xTaskGetTickCount() * portTICK_PERIOD_MS;
+  uint32_t elapsed = current_time - fan->pid_last_time;
+  fan->pid_last_time = current_time;
+
+  // After a long gap (fan disabled, task stalled) the integral would jump;
+  // restart from the current speed instead
+  if (elapsed > 5 * s_fan_ctx.update_interval_ms) {
+    fan_pid_reset(&fan->pid_state, fan->status.speed_percent);
   }
 
-  if (temperature >= curve[num_points - 1].temperature) {
-    return curve[num_points - 1].speed_percent;
+  // AGX power and GPU load change seconds before the heat reaches the
+  // sensor; without AGX data the law runs on temperature alone
+  fan_pid_feedforward_t feedforward;
+  bool have_feedforward = fan_controller_get_feedforward(inputs, &feedforward);
+
+  float output =
+      fan_pid_step(&fan->pid_gains, &fan->pid_state, temperature,
+                   have_feedforward ? &feedforward : NULL, elapsed / 1000.0f);
+  uint8_t new_speed = (uint8_t)lroundf(output);
+
+  if (new_speed != fan->status.speed_percent) {
+    return fan_controller_update_pwm(fan_id, new_speed);
   }
 
-  // Linear interpolation between two points
-  for (uint8_t i = 0; i < num_points - 1; i++) {
-    if (temperature >= curve[i].temperature &&
-        temperature <= curve[i + 1].temperature) {
-      float temp_range = curve[i + 1].temperature - curve[i].temperature;
-      float speed_range = curve[i + 1].speed_percent - curve[i].speed_percent;
-      float temp_offset = temperature - curve[i].temperature;
-
-      return curve[i].speed_percent +
-             (uint8_t)((temp_offset / temp_range) * speed_range);
-    }
+  return ESP_OK;
+}
+
+static const char *fan_mode_to_string(fan_mode_t mode) {
+  switch (mode) {
+  case FAN_MODE_MANUAL:
+    return "Manual";
+  case FAN_MODE_AUTO_TEMP:
+    return "Auto-Temp";
+  case FAN_MODE_AUTO_CURVE:
+    return "Auto-Curve";
+  case FAN_MODE_OFF:
+    return "Off";
+  case FAN_MODE_AUTO_PID:
+    return "Auto-PID";
+  default:
+    return "Unknown";
   }
+}
 
-  return curve[num_points - 1].speed_percent;
+static const char *fan_temp_source_to_string(fan_temp_source_t source) {
+  return source < FAN_TEMP_SOURCE_MAX ? s_temp_source_names[source]
+                                      : "unknown";
+}
+
+static void print_pid_control(const fan_instance_t *fan) {
+  const fan_pid_gains_t *g = &fan->pid_gains;
+  printf("  PID Control:\n");
+  printf("    Setpoint: %.1f°C\n", g->setpoint);
+  printf("    Gains: kp=%.2f ki=%.3f kd=%.1f\n", g->kp, g->ki, g->kd);
+  printf("    Feed-forward: %.2f%%/W, %.2f%%/%% GPU\n", g->kff_power,
+         g->kff_gpu);
+  printf("    Slope Filter: %.1fs\n", g->slope_filter);
+  printf("    Output Range: %d-%d%%\n", g->min_speed, g->max_speed);
+  if (fan->status.mode == FAN_MODE_AUTO_PID && fan->pid_state.primed) {
+    printf("    Slope: %+.3f°C/s, Integral: %.1f%%, Feed-forward: %.1f%%\n",
+           fan->pid_state.slope, fan->pid_state.integral,
+           fan->pid_state.feedforward);
+  }
 }
 
 /* ============================================================================
@@ -904,24 +1122,7 @@ static esp_err_t cmd_fan_status(int argc, char **argv) {
       fan_status_t status;
       esp_err_t ret = fan_controller_get_status(i, &status);
       if (ret == ESP_OK) {
-        const char *mode_str;
-        switch (status.mode) {
-        case FAN_MODE_MANUAL:
-          mode_str = "Manual";
-          break;
-        case FAN_MODE_AUTO_TEMP:
-          mode_str = "Auto-Temp";
-          break;
-        case FAN_MODE_AUTO_CURVE:
-          mode_str = "Auto-Curve";
-          break;
-        case FAN_MODE_OFF:
-          mode_str = "Off";
-          break;
-        default:
-          mode_str = "Unknown";
-          break;
-        }
+        const char *mode_str = fan_mode_to_string(status.mode);
 
         printf("Fan %d: %s, %s, Speed: %d%%, Temp: %.1f°C%s\n", status.fan_id,
                status.enabled ? "Enabled" : "Disabled", mode_str,
@@ -940,11 +1141,7 @@ static esp_err_t cmd_fan_status(int argc, char **argv) {
     }
 
     fan_instance_t *fan = &s_fan_ctx.fans[fan_id];
-    const char *mode_str =
-        (fan->status.mode == FAN_MODE_MANUAL)       ? "Manual"
-        : (fan->status.mode == FAN_MODE_AUTO_TEMP)  ? "Auto-Temp"
-        : (fan->status.mode == FAN_MODE_AUTO_CURVE) ? "Auto-Curve"
-                                                    : "Off";
+    const char *mode_str = fan_mode_to_string(fan->status.mode);
 
     printf("Fan %d Detailed Status:\n", fan_id);
     printf("======================\n");
@@ -969,11 +1166,17 @@ static esp_err_t cmd_fan_status(int argc, char **argv) {
       printf("    Enabled: No\n");
     }
     printf("  Temperature Control:\n");
-    printf("    Hysteresis: %.1f°C\n", fan->temperature_hysteresis);
+    printf("    Source: %s (%.1f°C)\n",
+           fan_temp_source_to_string(fan->temp_source),
+           fan->source_temperature);
+    printf("    Hysteresis: %.1f°C\n",
+           fan->curve_state.temperature_hysteresis);
     printf("    Min Change Interval: %ldms\n",
-           (long)fan->min_speed_change_interval);
-    printf("    Target Speed: %d%%\n", fan->target_speed_percent);
-    printf("    Last Applied Speed: %d%%\n", fan->last_applied_speed);
+           (long)fan->curve_state.min_speed_change_interval);
+    printf("    Target Speed: %d%%\n", fan->curve_state.target_speed_percent);
+    printf("    Last Applied Speed: %d%%\n",
+           fan->curve_state.last_applied_speed);
+    print_pid_control(fan);
 
     return ESP_OK;
   }
@@ -1021,7 +1224,7 @@ static esp_err_t cmd_fan_set(int argc, char **argv) {
 
 static esp_err_t cmd_fan_mode(int argc, char **argv) {
   if (argc < 3) {
-    printf("Usage: fan mode <fan_id> <manual|auto|curve|off>\n");
+    printf("Usage: fan mode <fan_id> <manual|auto|curve|pid|off>\n");
     return ESP_ERR_INVALID_ARG;
   }
 
@@ -1034,6 +1237,8 @@ static esp_err_t cmd_fan_mode(int argc, char **argv) {
     mode = FAN_MODE_AUTO_TEMP;
   } else if (strcmp(argv[2], "curve") == 0) {
     mode = FAN_MODE_AUTO_CURVE;
+  } else if (strcmp(argv[2], "pid") == 0) {
+    mode = FAN_MODE_AUTO_PID;
   } else if (strcmp(argv[2], "off") == 0) {
     mode = FAN_MODE_OFF;
   } else {
@@ -1158,6 +1363,8 @@ static esp_err_t cmd_fan_config(int argc, char **argv) {
            "temperature curve\n");
     printf("  hysteresis <fan_id> <temp_hysteresis> <interval_ms> - Configure "
            "temperature control\n");
+    printf("  source <fan_id> [name] - Show or set the temperature source\n");
+    printf("  pid <fan_id> [name=value] ... - Show or configure PID control\n");
     printf("Examples:\n");
     printf("  fan config save     # Save all fan configurations with runtime "
            "state\n");
@@ -1193,11 +1400,7 @@ static esp_err_t cmd_fan_config(int argc, char **argv) {
         // Show what was saved
         fan_status_t status;
         if (fan_controller_get_status(fan_id, &status) == ESP_OK) {
-          const char *mode_str =
-              (status.mode == FAN_MODE_MANUAL)       ? "Manual"
-              : (status.mode == FAN_MODE_AUTO_TEMP)  ? "Auto-Temp"
-              : (status.mode == FAN_MODE_AUTO_CURVE) ? "Auto-Curve"
-                                                     : "Off";
+          const char *mode_str = fan_mode_to_string(status.mode);
           printf("  Saved: Mode=%s, Speed=%d%%, Enabled=%s\n", mode_str,
                  status.speed_percent, status.enabled ? "Yes" : "No");
         }
@@ -1235,11 +1438,7 @@ static esp_err_t cmd_fan_config(int argc, char **argv) {
         // Show what was loaded
         fan_status_t status;
         if (fan_controller_get_status(fan_id, &status) == ESP_OK) {
-          const char *mode_str =
-              (status.mode == FAN_MODE_MANUAL)       ? "Manual"
-              : (status.mode == FAN_MODE_AUTO_TEMP)  ? "Auto-Temp"
-              : (status.mode == FAN_MODE_AUTO_CURVE) ? "Auto-Curve"
-                                                     : "Off";
+          const char *mode_str = fan_mode_to_string(status.mode);
           printf("  Loaded: Mode=%s, Speed=%d%%, Enabled=%s\n", mode_str,
                  status.speed_percent, status.enabled ? "Yes" : "No");
         }
@@ -1279,11 +1478,7 @@ static esp_err_t cmd_fan_config(int argc, char **argv) {
       printf("    PWM Timer: %d\n", fan->config.pwm_timer);
       printf("    PWM Inverted: %s\n", fan->config.invert_pwm ? "Yes" : "No");
       printf("  Current Status:\n");
-      const char *mode_str =
-          (fan->status.mode == FAN_MODE_MANUAL)       ? "Manual"
-          : (fan->status.mode == FAN_MODE_AUTO_TEMP)  ? "Auto-Temp"
-          : (fan->status.mode == FAN_MODE_AUTO_CURVE) ? "Auto-Curve"
-                                                      : "Off";
+      const char *mode_str = fan_mode_to_string(fan->status.mode);
       printf("    Mode: %s\n", mode_str);
       printf("    Speed: %d%%\n", fan->status.speed_percent);
       printf("    Enabled: %s\n", fan->status.enabled ? "Yes" : "No");
@@ -1300,20 +1495,21 @@ static esp_err_t cmd_fan_config(int argc, char **argv) {
         printf("    Enabled: No\n");
       }
       printf("  Temperature Control:\n");
-      printf("    Hysteresis: %.1f°C\n", fan->temperature_hysteresis);
+      printf("    Source: %s\n", fan_temp_source_to_string(fan->temp_source));
+      printf("    Hysteresis: %.1f°C\n",
+             fan->curve_state.temperature_hysteresis);
       printf("    Min Change Interval: %ldms\n",
-             (long)fan->min_speed_change_interval);
-      printf("    Target Speed: %d%%\n", fan->target_speed_percent);
-      printf("    Last Applied Speed: %d%%\n", fan->last_applied_speed);
+             (long)fan->curve_state.min_speed_change_interval);
+      printf("    Target Speed: %d%%\n",
+             fan->curve_state.target_speed_percent);
+      printf("    Last Applied Speed: %d%%\n",
+             fan->curve_state.last_applied_speed);
+      print_pid_control(fan);
     } else {
       // Show all fans with summary information
       for (uint8_t i = 0; i < s_fan_ctx.num_fans; i++) {
         fan_instance_t *fan = &s_fan_ctx.fans[i];
-        const char *mode_str =
-            (fan->status.mode == FAN_MODE_MANUAL)       ? "Manual"
-            : (fan->status.mode == FAN_MODE_AUTO_TEMP)  ? "Auto-Temp"
-            : (fan->status.mode == FAN_MODE_AUTO_CURVE) ? "Auto-Curve"
-                                                        : "Off";
+        const char *mode_str = fan_mode_to_string(fan->status.mode);
         printf("Fan %d: GPIO%d, Ch%d, %s, Speed%d%%, %s\n", i,
                fan->config.pwm_pin, fan->config.pwm_channel, mode_str,
                fan->status.speed_percent,
@@ -1447,9 +1643,121 @@ static esp_err_t cmd_fan_config(int argc, char **argv) {
 
     return ret;
 
+  } else if (strcmp(action, "source") == 0) {
+    if (argc < 3) {
+      printf("Usage: fan config source <fan_id> "
+             "[global|cpu|soc0|soc1|soc2|tj|manual]\n");
+      printf("Example: fan config source 1 tj\n");
+      printf("  Fan 1 follows the AGX junction temperature in curve and PID "
+             "mode\n");
+      return ESP_ERR_INVALID_ARG;
+    }
+
+    fan_instance_t *fan = &s_fan_ctx.fans[fan_id];
+    if (argc == 3) {
+      printf("Fan %d temperature source: %s (%.1f°C)\n", fan_id,
+             fan_temp_source_to_string(fan->temp_source),
+             fan->source_temperature);
+      return ESP_OK;
+    }
+
+    fan_temp_source_t source = FAN_TEMP_SOURCE_MAX;
+    for (int i = 0; i < FAN_TEMP_SOURCE_MAX; i++) {
+      if (strcmp(argv[3], s_temp_source_names[i]) == 0) {
+        source = (fan_temp_source_t)i;
+        break;
+      }
+    }
+    if (source == FAN_TEMP_SOURCE_MAX) {
+      printf("Invalid temperature source: %s\n", argv[3]);
+      return ESP_ERR_INVALID_ARG;
+    }
+
+    esp_err_t ret = fan_controller_set_temp_source(fan_id, source);
+    if (ret == ESP_OK) {
+      printf("Fan %d temperature source set to %s\n", fan_id, argv[3]);
+    } else {
+      printf("Failed to set fan %d temperature source: %s\n", fan_id,
+             esp_err_to_name(ret));
+    }
+
+    return ret;
+
+  } else if (strcmp(action, "pid") == 0) {
+    if (argc < 3) {
+      printf("Usage: fan config pid <fan_id> [name=value] ...\n");
+      printf("Names: setpoint kp ki kd kff_power kff_gpu tau min max\n");
+      printf("Example: fan config pid 0 setpoint=65 kp=10 ki=0.3 kd=150\n");
+      printf("  Without values shows the current PID settings\n");
+      return ESP_ERR_INVALID_ARG;
+    }
+
+    fan_pid_gains_t gains;
+    esp_err_t ret = fan_controller_get_pid_gains(fan_id, &gains);
+    if (ret != ESP_OK) {
+      printf("Failed to get fan %d PID settings: %s\n", fan_id,
+             esp_err_to_name(ret));
+      return ret;
+    }
+
+    if (argc == 3) {
+      print_pid_control(&s_fan_ctx.fans[fan_id]);
+      return ESP_OK;
+    }
+
+    for (int i = 3; i < argc; i++) {
+      char *eq_pos = strchr(argv[i], '=');
+      if (eq_pos == NULL) {
+        printf("Invalid PID setting: %s (expected name=value)\n", argv[i]);
+        return ESP_ERR_INVALID_ARG;
+      }
+
+      *eq_pos = '\0'; // Split the string
+      const char *name = argv[i];
+      float value = atof(eq_pos + 1);
+
+      if (strcmp(name, "setpoint") == 0) {
+        gains.setpoint = value;
+      } else if (strcmp(name, "kp") == 0) {
+        gains.kp = value;
+      } else if (strcmp(name, "ki") == 0) {
+        gains.ki = value;
+      } else if (strcmp(name, "kd") == 0) {
+        gains.kd = value;
+      } else if (strcmp(name, "kff_power") == 0) {
+        gains.kff_power = value;
+      } else if (strcmp(name, "kff_gpu") == 0) {
+        gains.kff_gpu = value;
+      } else if (strcmp(name, "tau") == 0) {
+        gains.slope_filter = value;
+      } else if (strcmp(name, "min") == 0 && value >= 0.0f &&
+                 value <= 100.0f) {
+        gains.min_speed = (uint8_t)value;
+      } else if (strcmp(name, "max") == 0 && value >= 0.0f &&
+                 value <= 100.0f) {
+        gains.max_speed = (uint8_t)value;
+      } else {
+        printf("Invalid PID setting: %s=%s\n", name, eq_pos + 1);
+        return ESP_ERR_INVALID_ARG;
+      }
+    }
+
+    ret = fan_controller_set_pid_gains(fan_id, &gains);
+    if (ret == ESP_OK) {
+      printf("Fan %d PID configured:\n", fan_id);
+      print_pid_control(&s_fan_ctx.fans[fan_id]);
+      printf("Set fan mode to 'pid' to activate: fan mode %d pid\n", fan_id);
+    } else {
+      printf("Failed to configure fan %d PID: %s\n", fan_id,
+             esp_err_to_name(ret));
+    }
+
+    return ret;
+
   } else {
     printf("Unknown config action: %s\n", action);
-    printf("Valid actions: save, load, show, curve, hysteresis\n");
+    printf("Valid actions: save, load, show, curve, hysteresis, source, "
+           "pid\n");
     return ESP_ERR_INVALID_ARG;
   }
 }
@@ -1485,6 +1793,7 @@ static esp_err_t cmd_fan_help(void) {
   printf("    mode:   manual  - Manual speed control\n");
   printf("            auto    - Temperature-based automatic control\n");
   printf("            curve   - Custom temperature curve control\n");
+  printf("            pid     - Predictive PID control to a setpoint\n");
   printf("            off     - Fan disabled\n");
   printf("\n");
   printf("  enable <fan_id> <state>\n");
@@ -1529,6 +1838,24 @@ static esp_err_t cmd_fan_help(void) {
          "(100-60000ms)\n");
   printf("                      Reduces fan noise and extends lifespan\n");
   printf("\n");
+  printf("    source <fan_id> [global|cpu|soc0|soc1|soc2|tj|manual]\n");
+  printf("                    - Bind the fan to a temperature source\n");
+  printf("                      global: Shared temperature (temp command)\n");
+  printf("                      cpu, soc0-2, tj: AGX sensor, falls back to "
+         "global\n");
+  printf("                      manual: Test temperature (temp set)\n");
+  printf("\n");
+  printf("    pid <fan_id> [name=value] ...\n");
+  printf("                    - Configure predictive PID control\n");
+  printf("                      setpoint: Target temperature (20-110°C)\n");
+  printf("                      kp, ki, kd: Gains on error, integral and "
+         "slope\n");
+  printf("                      kff_power, kff_gpu: AGX power and GPU load "
+         "feed-forward\n");
+  printf("                      tau: Slope filter time constant (0-120s)\n");
+  printf("                      min, max: Speed limits (0-100)\n");
+  printf("                      Without values shows the current settings\n");
+  printf("\n");
   printf("  help\n");
   printf("    Display this help information\n");
   printf("\n");
@@ -1555,6 +1882,13 @@ static esp_err_t cmd_fan_help(void) {
   printf("  # Configure temperature hysteresis for fan 0\n");
   printf("  fan config hysteresis 0 3.0 2000  # 3°C dead zone, 2s interval\n");
   printf("\n");
+  printf("  # Let fan 1 follow the AGX junction temperature\n");
+  printf("  fan config source 1 tj\n");
+  printf("\n");
+  printf("  # Regulate fan 0 to 65°C with PID control\n");
+  printf("  fan config pid 0 setpoint=65\n");
+  printf("  fan mode 0 pid\n");
+  printf("\n");
   printf("  # Save all fan configurations\n");
   printf("  fan config save\n");
   printf("\n");
@@ -1574,6 +1908,7 @@ static esp_err_t cmd_fan_help(void) {
          "Default\n");
   printf(
       "  • Use 'temp' commands to control temperature input for curve mode\n");
+  printf("  • 'fan config source' binds a fan to its own AGX sensor\n");
   printf("  • GPIO pins must support PWM output (check ESP32-S3 datasheet)\n");
   printf("\n");
 
@@ -1624,9 +1959,10 @@ static esp_err_t save_fan_full_config(uint8_t fan_id) {
       .enabled = s_fan_ctx.fans[fan_id].status.enabled,
       .num_curve_points = s_fan_ctx.fans[fan_id].num_curve_points,
       .curve_enabled = s_fan_ctx.fans[fan_id].curve_enabled,
-      .temperature_hysteresis = s_fan_ctx.fans[fan_id].temperature_hysteresis,
+      .temperature_hysteresis =
+          s_fan_ctx.fans[fan_id].curve_state.temperature_hysteresis,
       .min_speed_change_interval =
-          s_fan_ctx.fans[fan_id].min_speed_change_interval,
+          s_fan_ctx.fans[fan_id].curve_state.min_speed_change_interval,
       .version = 3 // Configuration version for future compatibility (updated
                    // for hysteresis)
   };
@@ -1652,6 +1988,10 @@ static esp_err_t save_fan_full_config(uint8_t fan_id) {
         fan_id, full_config.current_mode, full_config.current_speed,
         full_config.enabled ? "Yes" : "No");
     config_manager_commit();
+    ret = save_fan_pid_config(fan_id);
+    if (ret == ESP_OK) {
+      ret = save_fan_source_config(fan_id);
+    }
   } else {
     ESP_LOGE(TAG, "Failed to save fan %d full config: %s", fan_id,
              esp_err_to_name(ret));
@@ -1805,20 +2145,31 @@ static esp_err_t load_fan_full_config(uint8_t fan_id) {
       }
     }
 
+    // The table must follow curve_points, including when they were freed
+    fan_curve_compile(s_fan_ctx.fans[fan_id].curve_points,
+                      s_fan_ctx.fans[fan_id].num_curve_points,
+                      &s_fan_ctx.fans[fan_id].curve_lut);
+
     // Load hysteresis configuration if version 3 or higher
     if (full_config.version >= 3) {
-      s_fan_ctx.fans[fan_id].temperature_hysteresis =
+      s_fan_ctx.fans[fan_id].curve_state.temperature_hysteresis =
           full_config.temperature_hysteresis;
-      s_fan_ctx.fans[fan_id].min_speed_change_interval =
+      s_fan_ctx.fans[fan_id].curve_state.min_speed_change_interval =
           full_config.min_speed_change_interval;
     } else {
       // Use defaults for older versions
-      s_fan_ctx.fans[fan_id].temperature_hysteresis =
+      s_fan_ctx.fans[fan_id].curve_state.temperature_hysteresis =
           FAN_CONTROLLER_DEFAULT_TEMP_HYSTERESIS;
-      s_fan_ctx.fans[fan_id].min_speed_change_interval =
+      s_fan_ctx.fans[fan_id].curve_state.min_speed_change_interval =
           FAN_CONTROLLER_MIN_SPEED_CHANGE_INTERVAL;
     }
 
+    // PID tuning lives under its own key; the law restarts from the loaded
+    // speed
+    load_fan_pid_config(fan_id);
+    load_fan_source_config(fan_id);
+    fan_pid_reset(&s_fan_ctx.fans[fan_id].pid_state, full_config.current_speed);
+
     ESP_LOGI(
         TAG,
         "Fan %d full configuration loaded: GPIO%d, Mode:%d, Speed:%d%%, "
@@ -1826,8 +2177,8 @@ static esp_err_t load_fan_full_config(uint8_t fan_id) {
         fan_id, full_config.hardware_config.pwm_pin, full_config.current_mode,
         full_config.current_speed, full_config.enabled ? "Yes" : "No",
         full_config.curve_enabled ? "Yes" : "No", full_config.num_curve_points,
-        s_fan_ctx.fans[fan_id].temperature_hysteresis,
-        (long)s_fan_ctx.fans[fan_id].min_speed_change_interval);
+        s_fan_ctx.fans[fan_id].curve_state.temperature_hysteresis,
+        (long)s_fan_ctx.fans[fan_id].curve_state.min_speed_change_interval);
 
     // Re-configure PWM with loaded settings
     if (s_fan_ctx.fans[fan_id].config.pwm_pin >= 0) {
@@ -1860,6 +2211,8 @@ static esp_err_t load_fan_full_config(uint8_t fan_id) {
         TAG,
         "No saved full configuration found for fan %d, trying hardware config",
         fan_id);
+    load_fan_pid_config(fan_id);
+    load_fan_source_config(fan_id);
     return load_fan_config(fan_id); // Fallback to hardware config which will
                                     // init defaults if needed
   } else {
@@ -1870,6 +2223,131 @@ static esp_err_t load_fan_full_config(uint8_t fan_id) {
   return ret;
 }
 
+static esp_err_t save_fan_pid_config(uint8_t fan_id) {
+  if (fan_id >= s_fan_ctx.num_fans) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  fan_pid_config_t pid_config = {.gains = s_fan_ctx.fans[fan_id].pid_gains,
+                                 .version = FAN_PID_CONFIG_VERSION};
+
+  char key[32];
+  snprintf(key, sizeof(key), "fan_%d_pid", fan_id);
+
+  esp_err_t ret = config_manager_set(FAN_CONFIG_NAMESPACE, key,
+                                     CONFIG_TYPE_BLOB, &pid_config,
+                                     sizeof(fan_pid_config_t));
+
+  if (ret == ESP_OK) {
+    ESP_LOGI(TAG, "Fan %d PID configuration saved", fan_id);
+    config_manager_commit();
+  } else {
+    ESP_LOGE(TAG, "Failed to save fan %d PID config: %s", fan_id,
+             esp_err_to_name(ret));
+  }
+
+  return ret;
+}
+
+static esp_err_t load_fan_pid_config(uint8_t fan_id) {
+  if (fan_id >= s_fan_ctx.num_fans) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  char key[32];
+  snprintf(key, sizeof(key), "fan_%d_pid", fan_id);
+
+  fan_pid_config_t pid_config;
+  size_t config_size = sizeof(fan_pid_config_t);
+  esp_err_t ret = config_manager_get(
+      FAN_CONFIG_NAMESPACE, key, CONFIG_TYPE_BLOB, &pid_config, &config_size);
+
+  if (ret == ESP_OK) {
+    if (pid_config.version != FAN_PID_CONFIG_VERSION ||
+        !fan_pid_gains_valid(&pid_config.gains)) {
+      ESP_LOGW(TAG, "Fan %d PID config invalid, using defaults", fan_id);
+      s_fan_ctx.fans[fan_id].pid_gains = fan_pid_get_default_gains();
+      return ESP_ERR_INVALID_VERSION;
+    }
+
+    s_fan_ctx.fans[fan_id].pid_gains = pid_config.gains;
+    ESP_LOGI(TAG, "Fan %d PID configuration loaded: setpoint %.1f°C", fan_id,
+             pid_config.gains.setpoint);
+  } else if (ret == ESP_ERR_NOT_FOUND) {
+    // Not an error, keep the default gains
+    ret = ESP_OK;
+  } else {
+    ESP_LOGE(TAG, "Failed to load fan %d PID config: %s", fan_id,
+             esp_err_to_name(ret));
+  }
+
+  return ret;
+}
+
+static esp_err_t save_fan_source_config(uint8_t fan_id) {
+  if (fan_id >= s_fan_ctx.num_fans) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  fan_source_config_t source_config = {
+      .temp_source = (uint8_t)s_fan_ctx.fans[fan_id].temp_source,
+      .version = FAN_SOURCE_CONFIG_VERSION};
+
+  char key[32];
+  snprintf(key, sizeof(key), "fan_%d_src", fan_id);
+
+  esp_err_t ret = config_manager_set(FAN_CONFIG_NAMESPACE, key,
+                                     CONFIG_TYPE_BLOB, &source_config,
+                                     sizeof(fan_source_config_t));
+
+  if (ret == ESP_OK) {
+    ESP_LOGI(TAG, "Fan %d temperature source saved", fan_id);
+    config_manager_commit();
+  } else {
+    ESP_LOGE(TAG, "Failed to save fan %d temperature source: %s", fan_id,
+             esp_err_to_name(ret));
+  }
+
+  return ret;
+}
+
+static esp_err_t load_fan_source_config(uint8_t fan_id) {
+  if (fan_id >= s_fan_ctx.num_fans) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  char key[32];
+  snprintf(key, sizeof(key), "fan_%d_src", fan_id);
+
+  fan_source_config_t source_config;
+  size_t config_size = sizeof(fan_source_config_t);
+  esp_err_t ret =
+      config_manager_get(FAN_CONFIG_NAMESPACE, key, CONFIG_TYPE_BLOB,
+                         &source_config, &config_size);
+
+  if (ret == ESP_OK) {
+    if (source_config.version != FAN_SOURCE_CONFIG_VERSION ||
+        source_config.temp_source >= FAN_TEMP_SOURCE_MAX) {
+      ESP_LOGW(TAG, "Fan %d temperature source invalid, using global", fan_id);
+      s_fan_ctx.fans[fan_id].temp_source = FAN_TEMP_SOURCE_GLOBAL;
+      return ESP_ERR_INVALID_VERSION;
+    }
+
+    s_fan_ctx.fans[fan_id].temp_source =
+        (fan_temp_source_t)source_config.temp_source;
+    ESP_LOGI(TAG, "Fan %d temperature source loaded: %s", fan_id,
+             fan_temp_source_to_string(s_fan_ctx.fans[fan_id].temp_source));
+  } else if (ret == ESP_ERR_NOT_FOUND) {
+    // Not an error, keep the shared temperature
+    ret = ESP_OK;
+  } else {
+    ESP_LOGE(TAG, "Failed to load fan %d temperature source: %s", fan_id,
+             esp_err_to_name(ret));
+  }
+
+  return ret;
+}
+
 static esp_err_t load_all_fan_configs(void) {
   esp_err_t ret = ESP_OK;
 
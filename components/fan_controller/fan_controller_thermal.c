@@ -0,0 +1,209 @@
+/**
+ * @file fan_controller_thermal.c
+ * @brief Fan control laws: temperature curve and predictive PID
+ *
+ * @author robOS Team
+ * @date 2025
+ */
+
+#include "fan_controller_thermal.h"
+#include <math.h>
+#include <string.h>
+
+/* ============================================================================
+ * Private Helpers
+ * ============================================================================
+ */
+
+static float clampf(float value, float lo, float hi) {
+  return value < lo ? lo : (value > hi ? hi : value);
+}
+
+static bool in_range(float value, float lo, float hi) {
+  return isfinite(value) && value >= lo && value <= hi;
+}
+
+/* ============================================================================
+ * Curve Law
+ * ============================================================================
+ */
+
+uint8_t fan_curve_interpolate(const fan_curve_point_t *curve,
+                              uint8_t num_points, float temperature) {
+  if (curve == NULL || num_points == 0) {
+    return 0;
+  }
+
+  if (num_points == 1) {
+    return curve[0].speed_percent;
+  }
+
+  // Find the appropriate range for interpolation
+  if (temperature <= curve[0].temperature) {
+    return curve[0].speed_percent;
+  }
+
+  if (temperature >= curve[num_points - 1].temperature) {
+    return curve[num_points - 1].speed_percent;
+  }
+
+  // Linear interpolation between two points
+  for (uint8_t i = 0; i < num_points - 1; i++) {
+    if (temperature >= curve[i].temperature &&
+        temperature <= curve[i + 1].temperature) {
+      float temp_range = curve[i + 1].temperature - curve[i].temperature;
+      float speed_range = curve[i + 1].speed_percent - curve[i].speed_percent;
+      float temp_offset = temperature - curve[i].temperature;
+
+      return curve[i].speed_percent +
+             (uint8_t)((temp_offset / temp_range) * speed_range);
+    }
+  }
+
+  return curve[num_points - 1].speed_percent;
+}
+
+void fan_curve_compile(const fan_curve_point_t *curve, uint8_t num_points,
+                       fan_curve_lut_t *lut) {
+  memset(lut, 0, sizeof(*lut));
+  if (curve == NULL || num_points == 0) {
+    return;
+  }
+
+  const float scale = (float)(1 << FAN_CURVE_LUT_FRAC_BITS);
+  int32_t first = (int32_t)floorf(curve[0].temperature * scale);
+  int32_t span =
+      (int32_t)ceilf(curve[num_points - 1].temperature * scale) - first;
+
+  // Smallest spacing that still reaches the last point
+  uint8_t shift = 0;
+  while ((span >> shift) >= FAN_CURVE_LUT_SIZE - 1) {
+    shift++;
+  }
+
+  lut->base = first;
+  lut->shift = shift;
+  lut->last = (uint16_t)((span + (1 << shift) - 1) >> shift);
+  for (uint16_t i = 0; i <= lut->last; i++) {
+    float temperature = (float)(first + ((int32_t)i << shift)) / scale;
+    lut->speed[i] = fan_curve_interpolate(curve, num_points, temperature);
+  }
+}
+
+uint8_t fan_curve_lookup(const fan_curve_lut_t *lut, float temperature) {
+  float t = temperature * (float)(1 << FAN_CURVE_LUT_FRAC_BITS);
+
+  // The negated compare also sends NaN to the first entry
+  if (!(t > (float)lut->base)) {
+    return lut->speed[0];
+  }
+
+  int32_t end = lut->base + ((int32_t)lut->last << lut->shift);
+  if (t >= (float)end) {
+    return lut->speed[lut->last];
+  }
+
+  // Positive offset, so the conversion floors
+  return lut->speed[(uint32_t)(t - (float)lut->base) >> lut->shift];
+}
+
+uint8_t fan_curve_step(const fan_curve_lut_t *lut, fan_curve_state_t *state,
+                       float temperature, uint32_t now_ms) {
+  // Calculate target speed based on current temperature
+  state->target_speed_percent = fan_curve_lookup(lut, temperature);
+
+  // Follow the curve only after the temperature left the dead zone and the
+  // minimum interval since the last change has passed
+  float temp_diff = fabsf(temperature - state->last_stable_temperature);
+  bool significant_temp_change = temp_diff >= state->temperature_hysteresis;
+  bool enough_time_passed = (now_ms - state->last_speed_change_time) >=
+                            state->min_speed_change_interval;
+
+  if (significant_temp_change && enough_time_passed) {
+    state->last_applied_speed = state->target_speed_percent;
+    state->last_stable_temperature = temperature;
+    state->last_speed_change_time = now_ms;
+  }
+
+  return state->last_applied_speed;
+}
+
+/* ============================================================================
+ * PID Law
+ * ============================================================================
+ */
+
+fan_pid_gains_t fan_pid_get_default_gains(void) {
+  fan_pid_gains_t gains = {.setpoint = FAN_PID_DEFAULT_SETPOINT,
+                           .kp = FAN_PID_DEFAULT_KP,
+                           .ki = FAN_PID_DEFAULT_KI,
+                           .kd = FAN_PID_DEFAULT_KD,
+                           .kff_power = FAN_PID_DEFAULT_KFF_POWER,
+                           .kff_gpu = FAN_PID_DEFAULT_KFF_GPU,
+                           .slope_filter = FAN_PID_DEFAULT_SLOPE_FILTER,
+                           .min_speed = FAN_PID_DEFAULT_MIN_SPEED,
+                           .max_speed = FAN_PID_DEFAULT_MAX_SPEED};
+  return gains;
+}
+
+bool fan_pid_gains_valid(const fan_pid_gains_t *gains) {
+  return gains != NULL && in_range(gains->setpoint, 20.0f, 110.0f) &&
+         in_range(gains->kp, 0.0f, 100.0f) &&
+         in_range(gains->ki, 0.0f, 10.0f) &&
+         in_range(gains->kd, 0.0f, 1000.0f) &&
+         in_range(gains->kff_power, 0.0f, 10.0f) &&
+         in_range(gains->kff_gpu, 0.0f, 1.0f) &&
+         in_range(gains->slope_filter, 0.0f, 120.0f) &&
+         gains->min_speed <= gains->max_speed && gains->max_speed <= 100;
+}
+
+void fan_pid_reset(fan_pid_state_t *state, float speed_percent) {
+  memset(state, 0, sizeof(*state));
+  state->output = speed_percent;
+}
+
+float fan_pid_step(const fan_pid_gains_t *gains, fan_pid_state_t *state,
+                   float temperature, const fan_pid_feedforward_t *feedforward,
+                   float dt_s) {
+  float lo = gains->min_speed;
+  float hi = gains->max_speed;
+  float error = temperature - gains->setpoint; // Positive when too hot
+
+  float ff = 0.0f;
+  if (feedforward != NULL) {
+    ff = gains->kff_power * feedforward->power_w +
+         gains->kff_gpu * feedforward->gpu_load;
+  }
+
+  if (!state->primed) {
+    // Bumpless start: the integral takes whatever the other terms leave of
+    // the speed the fan is already running at
+    state->primed = true;
+    state->last_temperature = temperature;
+    state->slope = 0.0f;
+    state->integral = clampf(state->output - ff - gains->kp * error, -hi, hi);
+    dt_s = 0.0f;
+  } else if (dt_s > 0.0f) {
+    float raw_slope = (temperature - state->last_temperature) / dt_s;
+    float alpha = dt_s / (gains->slope_filter + dt_s);
+    state->slope += alpha * (raw_slope - state->slope);
+    state->last_temperature = temperature;
+  } else {
+    dt_s = 0.0f;
+  }
+
+  float pd = gains->kp * error + gains->kd * state->slope;
+  float integral = state->integral + gains->ki * error * dt_s;
+  float output = ff + pd + integral;
+
+  // Anti-windup: hold the integral while the output is saturated and the
+  // error would push it further out
+  if ((output > hi && error > 0.0f) || (output < lo && error < 0.0f)) {
+    integral = state->integral;
+  }
+  state->integral = clampf(integral, -hi, hi);
+  state->feedforward = ff;
+  state->output = clampf(ff + pd + state->integral, lo, hi);
+
+  return state->output;
+}
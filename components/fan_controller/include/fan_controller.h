@@ -5,6 +5,7 @@
  * This component provides comprehensive fan control functionality including:
  * - PWM-based speed control
  * - Temperature-based automatic control
+ * - Predictive PID control with AGX load feed-forward
  * - Manual speed override
  * - Fan status monitoring
  * - Multiple fan support
@@ -18,6 +19,7 @@
 
 #include "driver/ledc.h"
 #include "esp_err.h"
+#include "fan_controller_thermal.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -56,9 +58,24 @@ typedef enum {
   FAN_MODE_MANUAL = 0, ///< Manual speed control
   FAN_MODE_AUTO_TEMP,  ///< Automatic temperature-based control
   FAN_MODE_AUTO_CURVE, ///< Custom curve-based control
-  FAN_MODE_OFF         ///< Fan disabled
+  FAN_MODE_OFF,        ///< Fan disabled
+  FAN_MODE_AUTO_PID    ///< Predictive PID control to a setpoint
 } fan_mode_t;
 
+/**
+ * @brief Temperature a fan follows in curve and PID mode
+ */
+typedef enum {
+  FAN_TEMP_SOURCE_GLOBAL = 0, ///< Shared temperature (manual > AGX CPU)
+  FAN_TEMP_SOURCE_AGX_CPU,    ///< AGX CPU sensor
+  FAN_TEMP_SOURCE_AGX_SOC0,   ///< AGX SoC sensor 0
+  FAN_TEMP_SOURCE_AGX_SOC1,   ///< AGX SoC sensor 1
+  FAN_TEMP_SOURCE_AGX_SOC2,   ///< AGX SoC sensor 2
+  FAN_TEMP_SOURCE_AGX_TJ,     ///< AGX junction (hottest sensor)
+  FAN_TEMP_SOURCE_MANUAL,     ///< Test temperature (temp set)
+  FAN_TEMP_SOURCE_MAX         ///< Number of sources
+} fan_temp_source_t;
+
 /**
  * @brief Fan configuration structure
  */
@@ -86,14 +103,6 @@ typedef struct {
   bool fault;            ///< Fault status
 } fan_status_t;
 
-/**
- * @brief Temperature curve point for automatic control
- */
-typedef struct {
-  float temperature;     ///< Temperature in Celsius
-  uint8_t speed_percent; ///< Fan speed percentage (0-100%)
-} fan_curve_point_t;
-
 /**
  * @brief Fan controller configuration
  */
@@ -251,6 +260,44 @@ fan_controller_configure_hysteresis(uint8_t fan_id,
                                     float temperature_hysteresis,
                                     uint32_t min_speed_change_interval);
 
+/**
+ * @brief Set the PID tuning for a fan
+ * @param fan_id Fan ID (0-3)
+ * @param gains PID tuning, checked with fan_pid_gains_valid()
+ * @return ESP_OK on success, error code on failure
+ * @note The tuning is saved to NVS and the law restarts from the current speed
+ */
+esp_err_t fan_controller_set_pid_gains(uint8_t fan_id,
+                                       const fan_pid_gains_t *gains);
+
+/**
+ * @brief Get the PID tuning of a fan
+ * @param fan_id Fan ID (0-3)
+ * @param gains Pointer to store the tuning
+ * @return ESP_OK on success, error code on failure
+ */
+esp_err_t fan_controller_get_pid_gains(uint8_t fan_id, fan_pid_gains_t *gains);
+
+/**
+ * @brief Bind a fan to a temperature source
+ * @param fan_id Fan ID (0-3)
+ * @param source Temperature the fan follows in curve and PID mode
+ * @return ESP_OK on success, error code on failure
+ * @note AGX sources fall back to the shared temperature while AGX data is
+ *       missing or stale; the binding is saved to NVS
+ */
+esp_err_t fan_controller_set_temp_source(uint8_t fan_id,
+                                         fan_temp_source_t source);
+
+/**
+ * @brief Get the temperature source of a fan
+ * @param fan_id Fan ID (0-3)
+ * @param source Pointer to store the source
+ * @return ESP_OK on success, error code on failure
+ */
+esp_err_t fan_controller_get_temp_source(uint8_t fan_id,
+                                         fan_temp_source_t *source);
+
 /**
  * @brief Register fan control commands with console
  * @return ESP_OK on success, error code on failure
@@ -0,0 +1,212 @@
+/**
+ * @file fan_controller_thermal.h
+ * @brief Fan control laws: temperature curve and predictive PID
+ *
+ * The curve law maps the current temperature to a speed and only follows
+ * it after the temperature has moved by the hysteresis and the minimum
+ * change interval has passed. It reacts late to load spikes: the sensor
+ * trails the die, and the dead zone adds another few degrees.
+ *
+ * The PID law regulates the temperature to a setpoint. The derivative acts
+ * on the filtered temperature slope, so a rising temperature raises the
+ * speed before the error is large, and AGX power and GPU load are added as
+ * feed-forward so the fans start to ramp when the load changes rather than
+ * when the heat reaches the sensor. The integral stops while the output is
+ * saturated in the direction of the error (anti-windup), and the first
+ * step after a reset continues from the current speed.
+ *
+ * A curve is compiled once, when it is configured, into a lookup table
+ * indexed by fixed-point temperature, so the control tick does one
+ * multiply and one table read instead of walking the curve with float
+ * divisions.
+ *
+ * Both laws are pure functions of their state and inputs and can be
+ * compiled on the host (see tests/host/bench_fan_thermal.c).
+ */
+
+#ifndef FAN_CONTROLLER_THERMAL_H
+#define FAN_CONTROLLER_THERMAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ============================================================================
+ * Constants and Macros
+ * ============================================================================
+ */
+
+#define FAN_PID_DEFAULT_SETPOINT 65.0f    ///< Target temperature (°C)
+#define FAN_PID_DEFAULT_KP 10.0f          ///< %/°C
+#define FAN_PID_DEFAULT_KI 0.3f           ///< %/(°C·s)
+#define FAN_PID_DEFAULT_KD 150.0f         ///< %/(°C/s)
+#define FAN_PID_DEFAULT_KFF_POWER 2.5f    ///< %/W
+#define FAN_PID_DEFAULT_KFF_GPU 0.1f      ///< %/% GPU load
+#define FAN_PID_DEFAULT_SLOPE_FILTER 4.0f ///< Slope filter time constant (s)
+#define FAN_PID_DEFAULT_MIN_SPEED 20      ///< Lowest speed while running (%)
+#define FAN_PID_DEFAULT_MAX_SPEED 100     ///< Highest speed (%)
+
+#define FAN_CURVE_LUT_SIZE 256    ///< Entries per compiled curve
+#define FAN_CURVE_LUT_FRAC_BITS 4 ///< Temperature fixed point (1/16 °C)
+
+/* ============================================================================
+ * Type Definitions
+ * ============================================================================
+ */
+
+/**
+ * @brief Temperature curve point for automatic control
+ */
+typedef struct {
+  float temperature;     ///< Temperature in Celsius
+  uint8_t speed_percent; ///< Fan speed percentage (0-100%)
+} fan_curve_point_t;
+
+/**
+ * @brief Curve compiled into a lookup table
+ *
+ * Entry i holds the curve speed at base + (i << shift), in 1/16 °C. The
+ * spacing is the smallest power of two that fits the curve span into the
+ * table: 1/4 °C for a 30-80 °C curve, 1 °C for the full -50-150 °C range.
+ */
+typedef struct {
+  int32_t base;                      ///< Temperature of entry 0 (1/16 °C)
+  uint8_t shift;                     ///< log2 of the entry spacing
+  uint16_t last;                     ///< Index of the last entry
+  uint8_t speed[FAN_CURVE_LUT_SIZE]; ///< Speed per entry (%)
+} fan_curve_lut_t;
+
+/**
+ * @brief Curve law state (hysteresis and rate limiting)
+ */
+typedef struct {
+  float last_stable_temperature;      ///< Temperature of the last speed change
+  uint8_t target_speed_percent;       ///< Target speed from curve calculation
+  uint8_t last_applied_speed;         ///< Last actually applied speed
+  uint32_t last_speed_change_time;    ///< Time of the last speed change (ms)
+  float temperature_hysteresis;       ///< Temperature dead zone (°C)
+  uint32_t min_speed_change_interval; ///< Minimum interval between speed
+                                      ///< changes (ms)
+} fan_curve_state_t;
+
+/**
+ * @brief PID law tuning
+ */
+typedef struct {
+  float setpoint;     ///< Target temperature (°C)
+  float kp;           ///< Proportional gain (%/°C)
+  float ki;           ///< Integral gain (%/(°C·s))
+  float kd;           ///< Gain on the temperature slope (%/(°C/s))
+  float kff_power;    ///< Feed-forward on AGX power (%/W)
+  float kff_gpu;      ///< Feed-forward on GPU load (%/%)
+  float slope_filter; ///< Slope low-pass time constant (s, 0 = none)
+  uint8_t min_speed;  ///< Output lower limit (%)
+  uint8_t max_speed;  ///< Output upper limit (%)
+} fan_pid_gains_t;
+
+/**
+ * @brief Load measured on the AGX, used as feed-forward
+ */
+typedef struct {
+  float power_w;  ///< GPU/SoC, CPU/CV and SYS 5V rails (W)
+  float gpu_load; ///< GR3D load (%)
+} fan_pid_feedforward_t;
+
+/**
+ * @brief PID law state
+ */
+typedef struct {
+  bool primed;            ///< A temperature has been seen since the reset
+  float last_temperature; ///< Previous temperature (°C)
+  float slope;            ///< Filtered temperature slope (°C/s)
+  float integral;         ///< Integral term (%)
+  float feedforward;      ///< Last feed-forward term (%)
+  float output;           ///< Last output (%)
+} fan_pid_state_t;
+
+/* ============================================================================
+ * Public Functions
+ * ============================================================================
+ */
+
+/**
+ * @brief Interpolate the curve speed for a temperature
+ * @param curve Curve points sorted by temperature
+ * @param num_points Number of curve points
+ * @param temperature Temperature in Celsius
+ * @return Speed percentage, clamped to the first and last point
+ */
+uint8_t fan_curve_interpolate(const fan_curve_point_t *curve,
+                              uint8_t num_points, float temperature);
+
+/**
+ * @brief Compile a curve into a lookup table
+ * @param curve Curve points sorted by temperature, -50 to 150 °C
+ * @param num_points Number of curve points (0 gives a table of 0%)
+ * @param lut Table to fill
+ */
+void fan_curve_compile(const fan_curve_point_t *curve, uint8_t num_points,
+                       fan_curve_lut_t *lut);
+
+/**
+ * @brief Look up the curve speed for a temperature
+ * @param lut Compiled curve
+ * @param temperature Temperature in Celsius
+ * @return Speed of the entry at or below the temperature, clamped to the
+ *         first and last point (at most one entry spacing behind
+ *         fan_curve_interpolate())
+ */
+uint8_t fan_curve_lookup(const fan_curve_lut_t *lut, float temperature);
+
+/**
+ * @brief Run the curve law for one temperature sample
+ * @param lut Compiled curve
+ * @param state Hysteresis and rate limiting state
+ * @param temperature Temperature in Celsius
+ * @param now_ms Current time (ms)
+ * @return Speed to apply (state->last_applied_speed)
+ */
+uint8_t fan_curve_step(const fan_curve_lut_t *lut, fan_curve_state_t *state,
+                       float temperature, uint32_t now_ms);
+
+/**
+ * @brief Get default PID tuning
+ * @return Default gains
+ */
+fan_pid_gains_t fan_pid_get_default_gains(void);
+
+/**
+ * @brief Check PID tuning for usable values
+ * @param gains Gains to check
+ * @return true if all values are finite and in range
+ */
+bool fan_pid_gains_valid(const fan_pid_gains_t *gains);
+
+/**
+ * @brief Reset the PID law
+ * @param state State to reset
+ * @param speed_percent Speed the next step continues from
+ */
+void fan_pid_reset(fan_pid_state_t *state, float speed_percent);
+
+/**
+ * @brief Run the PID law for one temperature sample
+ * @param gains Tuning
+ * @param state Controller state
+ * @param temperature Temperature in Celsius
+ * @param feedforward AGX load, NULL if not available
+ * @param dt_s Time since the previous step (s)
+ * @return Speed percentage within [min_speed, max_speed]
+ */
+float fan_pid_step(const fan_pid_gains_t *gains, fan_pid_state_t *state,
+                   float temperature, const fan_pid_feedforward_t *feedforward,
+                   float dt_s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FAN_CONTROLLER_THERMAL_H
@@ -0,0 +1,199 @@
+/**
+ * @file led_kernel.h
+ * @brief LED 定点颜色/三角函数内核
+ *
+ * 供 matrix_led、board_led、touch_led 的动画共用的整数内核：
+ * - 16位色相的 HSV -> RGB（色相 0-65535 对应 0-360°，饱和度/亮度 0-255）
+ * - 查表+线性插值的正弦/余弦（角度 0-65535 对应一整圈，输出 Q15）
+ * - 8位缩放和线性插值
+ *
+ * 热路径函数均为头文件内联，不使用浮点运算，也不做参数检查。
+ * 本组件不依赖FreeRTOS和驱动，可以在主机上编译用于基准测试。
+ */
+
+#ifndef LED_KERNEL_H
+#define LED_KERNEL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ==================== 常量定义 ====================
+
+#define LED_KERNEL_ANGLE_FULL       65536u      ///< 一整圈对应的角度单位
+#define LED_KERNEL_ANGLE_QUARTER    16384u      ///< 90° 对应的角度单位
+#define LED_KERNEL_ANGLE_PER_RADIAN 10430.378f  ///< 每弧度对应的角度单位（仅用于常量换算）
+#define LED_KERNEL_SIN_MAX          32767       ///< 正弦输出的最大值 (Q15)
+
+/**
+ * @brief 角度(度)转换为内核角度/色相单位，输入需在 0-359 范围内
+ */
+#define LED_KERNEL_DEGREES(deg) ((uint16_t)(((uint32_t)(deg) * LED_KERNEL_ANGLE_FULL) / 360u))
+
+/**
+ * @brief 弧度常量转换为内核角度单位（编译期换算）
+ */
+#define LED_KERNEL_RADIANS(rad) ((uint32_t)((rad) * LED_KERNEL_ANGLE_PER_RADIAN + 0.5f))
+
+// ==================== 类型定义 ====================
+
+/**
+ * @brief RGB颜色（与 matrix_led_color_t 内存布局一致）
+ */
+typedef struct {
+    uint8_t r;          ///< 红色分量 (0-255)
+    uint8_t g;          ///< 绿色分量 (0-255)
+    uint8_t b;          ///< 蓝色分量 (0-255)
+} led_kernel_rgb_t;
+
+/**
+ * @brief 正弦表：一整圈256段，末尾重复首项便于插值 (Q15)
+ */
+extern const int16_t led_kernel_sin_table[257];
+
+// ==================== 8位运算 ====================
+
+/**
+ * @brief 计算 a * b / 255（四舍五入，结果精确）
+ */
+static inline uint8_t led_kernel_scale8(uint8_t a, uint8_t b)
+{
+    uint32_t x = (uint32_t)a * b + 128;
+    return (uint8_t)((x + (x >> 8)) >> 8);
+}
+
+/**
+ * @brief 8位线性插值，t = 0 返回 a，t = 255 返回 b
+ */
+static inline uint8_t led_kernel_lerp8(uint8_t a, uint8_t b, uint8_t t)
+{
+    return (uint8_t)(a + led_kernel_scale8(b, t) - led_kernel_scale8(a, t));
+}
+
+/**
+ * @brief RGB线性插值，t = 0 返回 a，t = 255 返回 b
+ */
+static inline led_kernel_rgb_t led_kernel_lerp_rgb(led_kernel_rgb_t a, led_kernel_rgb_t b,
+                                                   uint8_t t)
+{
+    led_kernel_rgb_t out = {
+        led_kernel_lerp8(a.r, b.r, t),
+        led_kernel_lerp8(a.g, b.g, t),
+        led_kernel_lerp8(a.b, b.b, t),
+    };
+    return out;
+}
+
+/**
+ * @brief RGB整体缩放，scale = 255 时不变
+ */
+static inline led_kernel_rgb_t led_kernel_scale_rgb(led_kernel_rgb_t c, uint8_t scale)
+{
+    led_kernel_rgb_t out = {
+        led_kernel_scale8(c.r, scale),
+        led_kernel_scale8(c.g, scale),
+        led_kernel_scale8(c.b, scale),
+    };
+    return out;
+}
+
+// ==================== 三角函数 ====================
+
+/**
+ * @brief 正弦
+ *
+ * @param angle 角度 (0-65535 对应 0-2π，自然回绕)
+ * @return sin(angle) * 32767
+ */
+static inline int16_t led_kernel_sin16(uint16_t angle)
+{
+    uint8_t index = (uint8_t)(angle >> 8);
+    int32_t frac = angle & 0xFF;
+    int32_t a = led_kernel_sin_table[index];
+    int32_t b = led_kernel_sin_table[index + 1];
+    return (int16_t)(a + (((b - a) * frac) >> 8));
+}
+
+/**
+ * @brief 余弦
+ *
+ * @param angle 角度 (0-65535 对应 0-2π，自然回绕)
+ * @return cos(angle) * 32767
+ */
+static inline int16_t led_kernel_cos16(uint16_t angle)
+{
+    return led_kernel_sin16((uint16_t)(angle + LED_KERNEL_ANGLE_QUARTER));
+}
+
+/**
+ * @brief 计算 sin * amplitude / 32767（四舍五入，对称于0）
+ *
+ * @param sin_q15 led_kernel_sin16/cos16 的返回值
+ * @param amplitude 幅度
+ * @return 缩放后的整数
+ */
+static inline int32_t led_kernel_mul_sin(int16_t sin_q15, int32_t amplitude)
+{
+    int32_t product = (int32_t)sin_q15 * amplitude;
+    return product >= 0 ? (product + LED_KERNEL_SIN_MAX / 2) / LED_KERNEL_SIN_MAX
+                        : (product - LED_KERNEL_SIN_MAX / 2) / LED_KERNEL_SIN_MAX;
+}
+
+/**
+ * @brief 无符号正弦波，等价于 (sin(angle) + 1) / 2 * 255
+ *
+ * @param angle 角度 (0-65535 对应 0-2π)
+ * @return 0-255
+ */
+static inline uint8_t led_kernel_wave8(uint16_t angle)
+{
+    return (uint8_t)(((int32_t)led_kernel_sin16(angle) + 32768) >> 8);
+}
+
+// ==================== 颜色空间 ====================
+
+/**
+ * @brief HSV 转 RGB
+ *
+ * @param hue 色相 (0-65535 对应 0-360°)
+ * @param sat 饱和度 (0-255)
+ * @param val 亮度 (0-255)
+ * @return RGB颜色
+ */
+static inline led_kernel_rgb_t led_kernel_hsv_to_rgb(uint16_t hue, uint8_t sat, uint8_t val)
+{
+    uint32_t h6 = (uint32_t)hue * 6;
+    uint8_t sector = (uint8_t)(h6 >> 16);
+    uint8_t frac = (uint8_t)(h6 >> 8);
+
+    uint8_t p = led_kernel_scale8(val, 255 - sat);
+    uint8_t q = led_kernel_scale8(val, 255 - led_kernel_scale8(sat, frac));
+    uint8_t t = led_kernel_scale8(val, 255 - led_kernel_scale8(sat, 255 - frac));
+
+    led_kernel_rgb_t out;
+    switch (sector) {
+    case 0:  out.r = val; out.g = t;   out.b = p;   break;
+    case 1:  out.r = q;   out.g = val; out.b = p;   break;
+    case 2:  out.r = p;   out.g = val; out.b = t;   break;
+    case 3:  out.r = p;   out.g = q;   out.b = val; break;
+    case 4:  out.r = t;   out.g = p;   out.b = val; break;
+    default: out.r = val; out.g = p;   out.b = q;   break;
+    }
+    return out;
+}
+
+/**
+ * @brief 百分比 (0-100) 转换为 0-255
+ */
+static inline uint8_t led_kernel_percent_to_u8(uint8_t percent)
+{
+    return percent >= 100 ? 255 : (uint8_t)(((uint32_t)percent * 255 + 50) / 100);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LED_KERNEL_H
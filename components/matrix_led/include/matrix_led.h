@@ -51,6 +51,9 @@ ESP_EVENT_DECLARE_BASE(MATRIX_LED_EVENTS);
 #define MATRIX_LED_MAX_ANIMATIONS    16                                      ///< 最大动画数量
 #define MATRIX_LED_MAX_NAME_LEN      32                                      ///< 动画名称最大长度
 
+#define MATRIX_LED_DEFAULT_FPS       50                                      ///< 默认动画目标帧率
+#define MATRIX_LED_MAX_FPS           100                                     ///< 最大动画目标帧率
+
 // ==================== 类型定义 ====================
 
 /**
@@ -138,9 +141,35 @@ typedef struct {
     uint8_t brightness;                       ///< 当前亮度 (0-100)
     char current_animation[MATRIX_LED_MAX_NAME_LEN];  ///< 当前动画名称
     uint32_t pixel_count;                     ///< 像素总数
-    uint32_t frame_count;                     ///< 帧计数器
+    uint32_t frame_count;                     ///< 帧计数器（已发送到LED的帧）
+    uint32_t presented_frames;                ///< 已提交帧数
+    uint32_t dropped_frames;                  ///< 发送前被新帧覆盖的帧数
+    uint32_t late_frames;                     ///< 提交后未能及时发送的帧数
+    uint32_t skipped_frames;                  ///< 内容未变化而跳过的帧数
+    uint32_t corrected_pixels;                ///< 累计执行色彩校正的像素数
+    uint32_t stream_underruns;                ///< 流式动画到期时预取缓冲区为空的次数
+    uint32_t stream_buffered_frames;          ///< 流式动画当前已预取的帧数
+    uint8_t layer_count;                      ///< 图层数（0表示未使用图层合成）
+    uint32_t composed_rows;                   ///< 图层合成累计重新合成的行数
 } matrix_led_status_t;
 
+/**
+ * @brief 帧调度耗时统计
+ */
+typedef struct {
+    uint8_t target_fps;                       ///< 目标帧率
+    uint32_t rendered_frames;                 ///< 已渲染的动画帧数
+    uint32_t missed_frames;                   ///< 因错过截止时间而跳过的帧数
+    uint32_t render_samples;                  ///< 渲染耗时样本数
+    uint32_t render_p50_us;                   ///< 渲染耗时 P50 (微秒)
+    uint32_t render_p99_us;                   ///< 渲染耗时 P99 (微秒)
+    uint32_t render_max_us;                   ///< 渲染耗时最大值 (微秒)
+    uint32_t transmit_samples;                ///< 发送耗时样本数
+    uint32_t transmit_p50_us;                 ///< 发送耗时 P50 (微秒)
+    uint32_t transmit_p99_us;                 ///< 发送耗时 P99 (微秒)
+    uint32_t transmit_max_us;                 ///< 发送耗时最大值 (微秒)
+} matrix_led_timing_stats_t;
+
 /**
  * @brief 事件类型枚举
  */
@@ -300,9 +329,31 @@ esp_err_t matrix_led_clear(void);
  */
 esp_err_t matrix_led_fill(matrix_led_color_t color);
 
+/**
+ * @brief 提交后台缓冲区
+ * 
+ * 所有绘制操作都写入后台缓冲区，不做逐像素加锁。提交时后台缓冲区与
+ * 待显示缓冲区原子交换，并唤醒刷新任务完成校正和RMT发送，因此绘制
+ * 下一帧与发送当前帧可以重叠进行。新的后台缓冲区会继承刚提交的内容。
+ * 
+ * 如果上一帧在被刷新任务取走之前被新帧覆盖，计入 dropped_frames。
+ * 
+ * 绘制操作按行记录脏区域：自上次提交以来没有任何修改且校正参数未变时，
+ * 本次提交直接返回并计入 skipped_frames；刷新任务只对脏行重新校正，
+ * 校正结果与上次发送完全相同时跳过RMT发送。
+ * 
+ * @return 
+ *     - ESP_OK: 提交成功
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ *     - ESP_ERR_TIMEOUT: 其他任务正在提交
+ */
+esp_err_t matrix_led_present(void);
+
 /**
  * @brief 刷新显示（将缓冲区内容输出到LED）
  * 
+ * 等同于 matrix_led_present()，发送由刷新任务异步完成。
+ * 
  * @return 
  *     - ESP_OK: 刷新成功
  *     - ESP_ERR_INVALID_STATE: 组件未初始化
@@ -355,7 +406,9 @@ esp_err_t matrix_led_draw_rect(const matrix_led_rect_t* rect, matrix_led_color_t
 esp_err_t matrix_led_draw_circle(uint8_t center_x, uint8_t center_y, uint8_t radius, matrix_led_color_t color, bool filled);
 
 /**
- * @brief 绘制文本（简单字符）
+ * @brief 绘制文本（5x7字体，透明背景）
+ *
+ * 超出屏幕的部分被裁掉。其他字体、裁剪区域和滚动文本见 matrix_led_font.h。
  * 
  * @param x 起始X坐标
  * @param y 起始Y坐标
@@ -432,27 +485,81 @@ esp_err_t matrix_led_stop_animation(void);
 /**
  * @brief 加载自定义动画从文件
  * 
+ * 打开二进制动画容器（见 matrix_led_anim.h）并定位到指定动画，只保留
+ * 固定大小的解码状态，替换之前加载的自定义动画。
+ * 
  * @param filename 动画文件名
- * @param animation_name 动画名称
+ * @param animation_name 动画名称，为NULL时加载第一个动画
  * @return 
  *     - ESP_OK: 加载成功
- *     - ESP_ERR_NOT_FOUND: 文件不存在
+ *     - ESP_ERR_NOT_FOUND: 文件或动画不存在
  *     - ESP_ERR_INVALID_ARG: 参数无效
  *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ *     - ESP_ERR_INVALID_VERSION: 文件格式版本不支持
+ *     - ESP_FAIL: 文件损坏或读取失败
  */
 esp_err_t matrix_led_load_animation_from_file(const char* filename, const char* animation_name);
 
 /**
  * @brief 播放已加载的自定义动画
  * 
- * @param animation_name 动画名称
+ * 独立的读取任务把帧记录预取到环形缓冲区，动画任务在帧截止时间到达时只做
+ * 内存解码，按每帧记录的显示时间推进。动画长度不受内存限制；缓冲区为空时
+ * 计入 matrix_led_status_t::stream_underruns。
+ * 
+ * @param animation_name 动画名称，为NULL时播放当前加载的动画
  * @return 
  *     - ESP_OK: 播放成功
  *     - ESP_ERR_NOT_FOUND: 动画不存在
  *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ *     - ESP_ERR_NO_MEM: 预取缓冲区或读取任务创建失败
+ *     - ESP_FAIL: 首帧读取失败
  */
 esp_err_t matrix_led_play_custom_animation(const char* animation_name);
 
+/**
+ * @brief 设置动画目标帧率
+ * 
+ * 动画任务按绝对截止时间调度，动画相位按固定帧步长推进。
+ * 渲染跟不上时跳过已错过截止时间的帧，不会积压。
+ * 启动动画时非零的 frame_delay_ms 也会设置目标帧率。
+ * 
+ * @param fps 目标帧率 (1 - MATRIX_LED_MAX_FPS)
+ * @return 
+ *     - ESP_OK: 设置成功
+ *     - ESP_ERR_INVALID_ARG: 帧率超出范围
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ */
+esp_err_t matrix_led_set_target_fps(uint8_t fps);
+
+/**
+ * @brief 获取动画目标帧率
+ * 
+ * @return 目标帧率，未初始化时返回0
+ */
+uint8_t matrix_led_get_target_fps(void);
+
+/**
+ * @brief 获取帧调度耗时统计
+ * 
+ * 渲染耗时为动画绘制加提交，发送耗时为色彩校正加RMT发送。
+ * 
+ * @param stats 输出的统计信息
+ * @return 
+ *     - ESP_OK: 获取成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效或组件未初始化
+ */
+esp_err_t matrix_led_get_timing_stats(matrix_led_timing_stats_t* stats);
+
+/**
+ * @brief 清空帧调度耗时统计
+ * 
+ * @return 
+ *     - ESP_OK: 清空成功
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ */
+esp_err_t matrix_led_reset_timing_stats(void);
+
 // ==================== 特效API ====================
 
 /**
@@ -623,6 +730,7 @@ esp_err_t matrix_led_import_image(const char* filepath);
  * @brief 从JSON文件按名称加载图像到LED矩阵
  * 
  * 支持按动画名称选择加载JSON文件中的特定动画，如果animation_name为NULL则加载第一个动画。
+ * 文件为二进制动画容器时转交 matrix_led_import_animation 处理。
  * 
  * @param filepath JSON文件路径
  * @param animation_name 动画名称，为NULL时加载第一个动画
@@ -638,6 +746,8 @@ esp_err_t matrix_led_import_image_by_name(const char* filepath, const char* anim
 /**
  * @brief 列出JSON文件中的所有动画名称
  * 
+ * 同时支持二进制动画容器。
+ * 
  * @param filepath JSON文件路径
  * @return 
  *     - ESP_OK: 列出成功
@@ -648,14 +758,17 @@ esp_err_t matrix_led_import_image_by_name(const char* filepath, const char* anim
 esp_err_t matrix_led_list_animations(const char* filepath);
 
 /**
- * @brief 保存自定义动画到SD卡
+ * @brief 保存当前静态内容到SD卡（二进制动画格式）
+ * 
+ * 与 matrix_led_export_image 对应，写出只有一帧的二进制动画容器。
  * 
  * @param animation_name 动画名称
- * @param filepath SD卡上的文件路径 (例如: "/sdcard/animations/custom.bin")
+ * @param filepath SD卡上的文件路径 (例如: "/sdcard/animations/custom.mla")
  * @return 
  *     - ESP_OK: 保存成功
  *     - ESP_ERR_INVALID_ARG: 参数无效
  *     - ESP_ERR_INVALID_STATE: 组件未初始化或SD卡不可用
+ *     - ESP_ERR_NO_MEM: 内存不足
  *     - ESP_FAIL: 文件写入失败
  */
 esp_err_t matrix_led_export_animation(const char* animation_name, const char* filepath);
@@ -663,17 +776,38 @@ esp_err_t matrix_led_export_animation(const char* animation_name, const char* fi
 /**
  * @brief 从SD卡加载自定义动画
  * 
- * @param filepath SD卡上的文件路径 (例如: "/sdcard/animations/custom.bin")
- * @param animation_name 加载后的动画名称
+ * 单帧动画作为静态图像显示，多帧动画开始播放。
+ * 
+ * @param filepath SD卡上的文件路径 (例如: "/sdcard/animations/custom.mla")
+ * @param animation_name 动画名称，为NULL时加载第一个动画
  * @return 
  *     - ESP_OK: 加载成功
  *     - ESP_ERR_INVALID_ARG: 参数无效
  *     - ESP_ERR_INVALID_STATE: 组件未初始化
- *     - ESP_ERR_NOT_FOUND: 文件不存在
+ *     - ESP_ERR_NOT_FOUND: 文件或动画不存在
  *     - ESP_FAIL: 文件读取或解析失败
  */
 esp_err_t matrix_led_import_animation(const char* filepath, const char* animation_name);
 
+/**
+ * @brief 将JSON动画文件转换为二进制动画容器
+ * 
+ * 每个动画的 "points" 转换为单帧；动画包含 "frames" 数组（每项含
+ * "points" 和可选的 "delay_ms"）时转换为多帧动画。可选字段
+ * "frame_delay_ms"（默认100）和 "loop"（默认true）写入动画索引。
+ * 颜色不超过256种时使用调色板。
+ * 
+ * @param json_path JSON文件路径
+ * @param anim_path 输出文件路径 (例如: "/sdcard/matrix.mla")
+ * @return 
+ *     - ESP_OK: 转换成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效或文件中无动画
+ *     - ESP_ERR_NOT_FOUND: JSON文件不存在
+ *     - ESP_ERR_NO_MEM: 内存不足
+ *     - ESP_FAIL: 文件读取、解析或写入失败
+ */
+esp_err_t matrix_led_convert_animation_file(const char* json_path, const char* anim_path);
+
 /**
  * @brief 检查SD卡存储是否可用
  * 
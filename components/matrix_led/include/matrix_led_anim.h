@@ -0,0 +1,394 @@
+/**
+ * @file matrix_led_anim.h
+ * @brief Matrix LED 二进制动画容器
+ *
+ * 取代逐像素JSON对象的紧凑动画格式：文件头 + 帧数据 + 调色板 + 命名动画
+ * 索引。帧以游程/增量编码存储，读取端只保留一帧像素和固定大小的读缓冲，
+ * 内存占用与动画长度无关。
+ *
+ * 文件布局（所有多字节字段均为小端）:
+ * @code
+ *   [文件头 32B] [帧数据 ...] [调色板 N*3B] [动画索引 M*48B]
+ * @endcode
+ *
+ * 每帧由6字节帧头（类型、延迟、负载长度）和操作码序列组成：
+ * - 0x00-0x3F: 跳过 n+1 个像素（保持上一帧内容）
+ * - 0x40-0x7F: 其后 n+1 个颜色逐个写入
+ * - 0x80-0xFF: 其后 1 个颜色重复 n+1 次
+ * 颜色在有调色板时为1字节索引，否则为3字节RGB。关键帧相对全黑画面编码，
+ * 增量帧相对上一帧编码。
+ *
+ * 本模块不依赖FreeRTOS和驱动，可以在主机上编译。
+ */
+
+#ifndef MATRIX_LED_ANIM_H
+#define MATRIX_LED_ANIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "esp_err.h"
+#include "matrix_led.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ==================== 格式常量 ====================
+
+#define MATRIX_LED_ANIM_MAGIC           "MLAN"  ///< 文件魔数
+#define MATRIX_LED_ANIM_VERSION         1       ///< 当前格式版本
+#define MATRIX_LED_ANIM_HEADER_SIZE     32      ///< 文件头长度
+#define MATRIX_LED_ANIM_INDEX_ENTRY_SIZE 48     ///< 索引项长度
+#define MATRIX_LED_ANIM_FRAME_HEADER_SIZE 6     ///< 帧头长度
+#define MATRIX_LED_ANIM_MAX_PALETTE     256     ///< 调色板最大颜色数
+#define MATRIX_LED_ANIM_MAX_ANIMATIONS  32      ///< 单个文件的最大动画数（写入端）
+#define MATRIX_LED_ANIM_CHUNK_SIZE      256     ///< 读取端缓冲区大小
+
+/** 单帧编码后的最大负载（每像素最多1个操作码+3字节颜色） */
+#define MATRIX_LED_ANIM_MAX_PAYLOAD     (MATRIX_LED_COUNT * 4)
+
+/** 单帧记录（帧头+负载）的最大长度 */
+#define MATRIX_LED_ANIM_MAX_RECORD      (MATRIX_LED_ANIM_FRAME_HEADER_SIZE + MATRIX_LED_ANIM_MAX_PAYLOAD)
+
+/** 预取环形缓冲区大小（2的幂） */
+#define MATRIX_LED_ANIM_RING_SIZE       16384
+
+/**
+ * @brief 帧类型
+ */
+typedef enum {
+    MATRIX_LED_ANIM_FRAME_KEY = 0,      ///< 关键帧（相对全黑画面）
+    MATRIX_LED_ANIM_FRAME_DELTA = 1,    ///< 增量帧（相对上一帧）
+} matrix_led_anim_frame_type_t;
+
+/**
+ * @brief 动画索引信息
+ */
+typedef struct {
+    char name[MATRIX_LED_MAX_NAME_LEN]; ///< 动画名称
+    uint32_t data_offset;               ///< 首帧在文件中的偏移
+    uint32_t data_size;                 ///< 全部帧数据长度
+    uint16_t frame_count;               ///< 帧数
+    uint16_t frame_delay_ms;            ///< 默认帧间延迟 (毫秒)
+    bool loop;                          ///< 是否循环播放
+} matrix_led_anim_info_t;
+
+/**
+ * @brief 动画读取器（流式解码，内存占用固定）
+ */
+typedef struct {
+    FILE *file;                                         ///< 文件句柄
+    uint16_t palette_count;                             ///< 调色板颜色数（0表示直接RGB）
+    uint16_t animation_count;                           ///< 动画数量
+    uint32_t index_offset;                              ///< 动画索引偏移
+    matrix_led_color_t palette[MATRIX_LED_ANIM_MAX_PALETTE]; ///< 调色板
+    matrix_led_anim_info_t info;                        ///< 当前选中的动画
+    uint16_t next_frame;                                ///< 下一帧序号
+    uint32_t read_offset;                               ///< 下一次读取的文件偏移
+    uint8_t chunk[MATRIX_LED_ANIM_CHUNK_SIZE];          ///< 读缓冲区
+    uint16_t chunk_len;                                 ///< 缓冲区有效字节数
+    uint16_t chunk_pos;                                 ///< 缓冲区读取位置
+} matrix_led_anim_reader_t;
+
+/**
+ * @brief 动画写入器
+ *
+ * 结构体较大（约8KB），调用方应在堆上分配。
+ */
+typedef struct {
+    FILE *file;                                         ///< 文件句柄
+    uint16_t palette_count;                             ///< 调色板颜色数（0表示直接RGB）
+    uint16_t animation_count;                           ///< 已写入的动画数量
+    uint32_t offset;                                    ///< 当前写入偏移
+    bool in_animation;                                  ///< 正在写入动画
+    matrix_led_color_t palette[MATRIX_LED_ANIM_MAX_PALETTE]; ///< 调色板
+    matrix_led_anim_info_t index[MATRIX_LED_ANIM_MAX_ANIMATIONS]; ///< 动画索引
+    matrix_led_color_t previous[MATRIX_LED_COUNT];      ///< 上一帧（增量编码参考）
+    uint8_t payload[MATRIX_LED_ANIM_MAX_PAYLOAD];       ///< 编码缓冲区
+} matrix_led_anim_writer_t;
+
+/**
+ * @brief 帧记录预取环（单生产者/单消费者）
+ *
+ * 生产者（读取任务）把原始帧记录按 [u16长度][记录] 依次写入，消费者（渲染任务）
+ * 就地解码后释放。head/tail 为自由递增的字节计数，各自只由一端写入，因此不需要
+ * 加锁。记录不跨越缓冲区末尾，末尾空间不足时写入回绕标记。
+ */
+typedef struct {
+    uint8_t buffer[MATRIX_LED_ANIM_RING_SIZE];          ///< 记录存储区
+    uint32_t head;                                      ///< 写入位置（生产者）
+    uint32_t tail;                                      ///< 读取位置（消费者）
+    uint32_t frames_pushed;                             ///< 已写入帧数（生产者）
+    uint32_t frames_popped;                             ///< 已取出帧数（消费者）
+    bool finished;                                      ///< 非循环动画已全部写入
+} matrix_led_anim_ring_t;
+
+// ==================== 调色板 ====================
+
+/**
+ * @brief 向调色板添加颜色（已存在时返回原索引）
+ *
+ * @param palette 调色板（容量 MATRIX_LED_ANIM_MAX_PALETTE）
+ * @param count 当前颜色数，添加成功时递增
+ * @param color 颜色
+ * @return 颜色索引，调色板已满时返回-1
+ */
+int matrix_led_anim_palette_add(matrix_led_color_t *palette, uint16_t *count,
+                                matrix_led_color_t color);
+
+// ==================== 写入接口 ====================
+
+/**
+ * @brief 创建动画文件
+ *
+ * @param writer 写入器
+ * @param filepath 文件路径
+ * @param palette 调色板，为NULL时以直接RGB存储颜色
+ * @param palette_count 调色板颜色数 (1-256)
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_FAIL: 文件创建失败
+ */
+esp_err_t matrix_led_anim_writer_open(matrix_led_anim_writer_t *writer,
+                                      const char *filepath,
+                                      const matrix_led_color_t *palette,
+                                      uint16_t palette_count);
+
+/**
+ * @brief 开始写入一个命名动画
+ *
+ * @param writer 写入器
+ * @param name 动画名称
+ * @param frame_delay_ms 默认帧间延迟 (毫秒)
+ * @param loop 是否循环播放
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_INVALID_STATE: 上一个动画未结束
+ *     - ESP_ERR_NO_MEM: 动画数量超过上限
+ */
+esp_err_t matrix_led_anim_writer_begin(matrix_led_anim_writer_t *writer,
+                                       const char *name,
+                                       uint16_t frame_delay_ms, bool loop);
+
+/**
+ * @brief 追加一帧（自动选择关键帧或增量帧中较小者）
+ *
+ * @param writer 写入器
+ * @param pixels 整帧像素 (MATRIX_LED_COUNT)
+ * @param delay_ms 本帧显示时间，0表示使用动画默认值
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_STATE: 未开始动画
+ *     - ESP_ERR_NOT_FOUND: 颜色不在调色板中
+ *     - ESP_FAIL: 文件写入失败
+ */
+esp_err_t matrix_led_anim_writer_add_frame(matrix_led_anim_writer_t *writer,
+                                           const matrix_led_color_t *pixels,
+                                           uint16_t delay_ms);
+
+/**
+ * @brief 结束当前动画
+ *
+ * @param writer 写入器
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_STATE: 未开始动画
+ *     - ESP_ERR_INVALID_SIZE: 动画没有帧
+ */
+esp_err_t matrix_led_anim_writer_end(matrix_led_anim_writer_t *writer);
+
+/**
+ * @brief 写入调色板和索引并关闭文件
+ *
+ * 无论成功与否文件都会被关闭。
+ *
+ * @param writer 写入器
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_FAIL: 文件写入失败
+ */
+esp_err_t matrix_led_anim_writer_close(matrix_led_anim_writer_t *writer);
+
+// ==================== 读取接口 ====================
+
+/**
+ * @brief 检查文件是否为二进制动画容器
+ *
+ * @param filepath 文件路径
+ * @return true 文件以动画魔数开头
+ */
+bool matrix_led_anim_is_container(const char *filepath);
+
+/**
+ * @brief 打开动画文件并加载调色板
+ *
+ * @param reader 读取器
+ * @param filepath 文件路径
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_NOT_FOUND: 文件不存在
+ *     - ESP_ERR_INVALID_VERSION: 格式版本不支持
+ *     - ESP_ERR_INVALID_SIZE: 矩阵尺寸不匹配
+ *     - ESP_FAIL: 文件损坏或读取失败
+ */
+esp_err_t matrix_led_anim_open(matrix_led_anim_reader_t *reader,
+                               const char *filepath);
+
+/**
+ * @brief 读取第 index 个动画的索引信息
+ *
+ * @param reader 读取器
+ * @param index 动画序号
+ * @param info 输出索引信息
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_NOT_FOUND: 序号超出范围
+ *     - ESP_FAIL: 文件损坏或读取失败
+ */
+esp_err_t matrix_led_anim_get_info(matrix_led_anim_reader_t *reader,
+                                   uint16_t index,
+                                   matrix_led_anim_info_t *info);
+
+/**
+ * @brief 按名称选择动画并定位到首帧
+ *
+ * @param reader 读取器
+ * @param name 动画名称，为NULL时选择第一个动画
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_NOT_FOUND: 动画不存在
+ *     - ESP_FAIL: 文件损坏或读取失败
+ */
+esp_err_t matrix_led_anim_select(matrix_led_anim_reader_t *reader,
+                                 const char *name);
+
+/**
+ * @brief 回到当前动画的首帧
+ *
+ * @param reader 读取器
+ */
+void matrix_led_anim_rewind(matrix_led_anim_reader_t *reader);
+
+/**
+ * @brief 解码下一帧
+ *
+ * 增量帧在 frame 现有内容上就地更新，因此调用方需要保留上一帧的输出。
+ *
+ * @param reader 读取器
+ * @param frame 帧缓冲区 (MATRIX_LED_COUNT)
+ * @param delay_ms 输出本帧显示时间 (毫秒)，可以为NULL
+ * @param dirty_rows 输出被修改的行掩码（每行一位），可以为NULL
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_NOT_FOUND: 已经没有更多帧
+ *     - ESP_FAIL: 帧数据损坏或读取失败
+ */
+esp_err_t matrix_led_anim_read_frame(matrix_led_anim_reader_t *reader,
+                                     matrix_led_color_t *frame,
+                                     uint16_t *delay_ms,
+                                     uint32_t *dirty_rows);
+
+/**
+ * @brief 读取下一帧的原始记录（帧头+负载），不解码
+ *
+ * @param reader 读取器
+ * @param record 输出缓冲区
+ * @param capacity 缓冲区大小，至少 MATRIX_LED_ANIM_MAX_RECORD
+ * @param length 输出记录长度
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_NOT_FOUND: 已经没有更多帧
+ *     - ESP_FAIL: 帧数据损坏或读取失败
+ */
+esp_err_t matrix_led_anim_read_record(matrix_led_anim_reader_t *reader,
+                                      uint8_t *record, size_t capacity,
+                                      size_t *length);
+
+/**
+ * @brief 解码一条原始帧记录
+ *
+ * 只使用读取器的调色板和默认延迟，不访问文件，可以与读取任务并发调用。
+ *
+ * @param reader 读取器
+ * @param record 帧记录
+ * @param length 记录长度
+ * @param frame 帧缓冲区 (MATRIX_LED_COUNT)
+ * @param delay_ms 输出本帧显示时间 (毫秒)，可以为NULL
+ * @param dirty_rows 输出被修改的行掩码，可以为NULL
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_FAIL: 帧数据损坏
+ */
+esp_err_t matrix_led_anim_decode_record(const matrix_led_anim_reader_t *reader,
+                                        const uint8_t *record, size_t length,
+                                        matrix_led_color_t *frame,
+                                        uint16_t *delay_ms,
+                                        uint32_t *dirty_rows);
+
+/**
+ * @brief 关闭动画文件
+ *
+ * @param reader 读取器
+ */
+void matrix_led_anim_close(matrix_led_anim_reader_t *reader);
+
+// ==================== 预取环 ====================
+
+/**
+ * @brief 清空预取环
+ *
+ * @param ring 预取环
+ */
+void matrix_led_anim_ring_init(matrix_led_anim_ring_t *ring);
+
+/**
+ * @brief 从读取器读取帧记录填充预取环（生产者端）
+ *
+ * 持续写入直到环满或动画结束；循环动画到达末尾时自动回到首帧。
+ *
+ * @param ring 预取环
+ * @param reader 读取器
+ * @return
+ *     - ESP_ERR_NO_MEM: 环已满，稍后再填充
+ *     - ESP_ERR_NOT_FOUND: 非循环动画已全部写入
+ *     - ESP_FAIL: 帧数据损坏或读取失败
+ */
+esp_err_t matrix_led_anim_ring_fill(matrix_led_anim_ring_t *ring,
+                                    matrix_led_anim_reader_t *reader);
+
+/**
+ * @brief 查看最早的一条帧记录（消费者端）
+ *
+ * @param ring 预取环
+ * @param length 输出记录长度
+ * @return 记录地址，环为空时返回NULL
+ */
+const uint8_t *matrix_led_anim_ring_peek(matrix_led_anim_ring_t *ring,
+                                         size_t *length);
+
+/**
+ * @brief 释放 matrix_led_anim_ring_peek 返回的记录（消费者端）
+ *
+ * @param ring 预取环
+ */
+void matrix_led_anim_ring_pop(matrix_led_anim_ring_t *ring);
+
+/**
+ * @brief 环中已缓冲的帧数
+ *
+ * @param ring 预取环
+ * @return 帧数
+ */
+uint32_t matrix_led_anim_ring_frames(const matrix_led_anim_ring_t *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATRIX_LED_ANIM_H
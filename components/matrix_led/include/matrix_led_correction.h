@@ -0,0 +1,91 @@
+/**
+ * @file matrix_led_correction.h
+ * @brief Matrix LED 融合色彩校正引擎
+ *
+ * 将亮度、白点校正和Gamma校正折叠为三张每通道256项的查找表，
+ * HSL亮度/饱和度增强使用整数快速路径。查找表只在色彩校正配置
+ * 或亮度发生变化时重建，刷新路径上每个像素只需三次查表。
+ *
+ * 本模块不依赖FreeRTOS和驱动，可以在主机上编译用于基准测试。
+ */
+
+#ifndef MATRIX_LED_CORRECTION_H
+#define MATRIX_LED_CORRECTION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "matrix_led.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief 校正参数（构建查找表的输入）
+ */
+typedef struct {
+    uint8_t brightness;             ///< 矩阵亮度 (0-100)
+    bool enabled;                   ///< 色彩校正总开关
+    bool white_point_enabled;       ///< 白点校正开关
+    float red_scale;                ///< 红色通道缩放 (0.0-2.0)
+    float green_scale;              ///< 绿色通道缩放 (0.0-2.0)
+    float blue_scale;               ///< 蓝色通道缩放 (0.0-2.0)
+    bool gamma_enabled;             ///< Gamma校正开关
+    float gamma;                    ///< Gamma值 (0.1-4.0)
+    bool lightness_enabled;         ///< HSL亮度增强开关
+    float lightness_factor;         ///< HSL亮度系数 (0.0-2.0)
+    bool saturation_enabled;        ///< HSL饱和度增强开关
+    float saturation_factor;        ///< HSL饱和度系数 (0.0-2.0)
+} matrix_led_correction_params_t;
+
+/**
+ * @brief 预计算的校正表
+ */
+typedef struct {
+    uint8_t lut_r[256];             ///< 红色通道查找表
+    uint8_t lut_g[256];             ///< 绿色通道查找表
+    uint8_t lut_b[256];             ///< 蓝色通道查找表
+    bool hsl_enabled;               ///< 是否需要执行HSL整数路径
+    uint16_t lightness_q8;          ///< HSL亮度系数 (Q8定点, 256 = 1.0)
+    uint16_t saturation_q8;         ///< HSL饱和度系数 (Q8定点, 256 = 1.0)
+    uint8_t brightness;             ///< 构建时使用的亮度
+    uint32_t generation;            ///< 重建次数
+} matrix_led_correction_t;
+
+/**
+ * @brief 根据参数重建校正查找表
+ *
+ * @param corr 校正表
+ * @param params 校正参数
+ */
+void matrix_led_correction_build(matrix_led_correction_t *corr,
+                                 const matrix_led_correction_params_t *params);
+
+/**
+ * @brief 对单个像素应用校正
+ *
+ * @param corr 校正表
+ * @param color 输入颜色
+ * @return 校正后的颜色
+ */
+matrix_led_color_t matrix_led_correction_apply_pixel(const matrix_led_correction_t *corr,
+                                                     matrix_led_color_t color);
+
+/**
+ * @brief 对像素数组应用校正
+ *
+ * @param corr 校正表
+ * @param input 输入像素
+ * @param output 输出像素（可以与输入相同）
+ * @param count 像素数量
+ */
+void matrix_led_correction_apply(const matrix_led_correction_t *corr,
+                                 const matrix_led_color_t *input,
+                                 matrix_led_color_t *output, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATRIX_LED_CORRECTION_H
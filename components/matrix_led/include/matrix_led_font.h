@@ -0,0 +1,216 @@
+/**
+ * @file matrix_led_font.h
+ * @brief Matrix LED 点阵字体和文本排版
+ *
+ * 字体以1bpp按行打包（每行一个字节，bit7为最左列），内置5x7比例字体和8x8
+ * 等宽粗体。绘制时先把一行文字拼成每行一个32位的位掩码，再按行写入帧缓冲区，
+ * 不再逐字形逐像素调用 set_pixel。
+ *
+ * 文本对象（matrix_led_text_t）在内容变化时把整行文字光栅化到位图缓存中，
+ * 之后的绘制和滚动只读取缓存。水平滚动按增量进行：区域内已有像素整体左移，
+ * 只绘制新露出的列，内容没有变化的行不会被标记为脏行。
+ *
+ * 除“组件接入”部分外，本模块不依赖FreeRTOS和驱动，可以在主机上编译。
+ */
+
+#ifndef MATRIX_LED_FONT_H
+#define MATRIX_LED_FONT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "matrix_led.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MATRIX_LED_FONT_MAX_HEIGHT  8       ///< 字体最大高度
+#define MATRIX_LED_FONT_MAX_WIDTH   8       ///< 字形最大宽度
+#define MATRIX_LED_FONT_DEGREE      "\x7f"  ///< 度数符号（内置字体的0x7F字形）
+#define MATRIX_LED_TEXT_MAX_LEN     64      ///< 文本对象的最大字符数
+
+/** 文本位图缓存每行的字数（最宽字形加1列间距，另留1字防止越界读取） */
+#define MATRIX_LED_TEXT_STRIP_WORDS \
+    ((MATRIX_LED_TEXT_MAX_LEN * (MATRIX_LED_FONT_MAX_WIDTH + 1) + 31) / 32 + 1)
+
+/**
+ * @brief 点阵字体
+ */
+typedef struct {
+    const uint8_t *bitmap;      ///< 字形数据，每个字形 height 字节
+    const uint8_t *widths;      ///< 每个字形的宽度（比例字体），NULL表示等宽
+    uint8_t width;              ///< 字形单元宽度 (1-8)
+    uint8_t height;             ///< 字形高度 (1-8)
+    uint8_t spacing;            ///< 字符间距
+    uint8_t first;              ///< 第一个字符
+    uint8_t last;               ///< 最后一个字符
+    const char *name;           ///< 字体名称
+} matrix_led_font_t;
+
+extern const matrix_led_font_t matrix_led_font_5x7;    ///< 5x7比例字体（数字等宽）
+extern const matrix_led_font_t matrix_led_font_8x8;    ///< 8x8等宽粗体
+
+/**
+ * @brief 文本对象（排版、位图缓存和滚动状态）
+ *
+ * 结构体约0.7KB，可以静态分配或放在堆上。
+ */
+typedef struct {
+    const matrix_led_font_t *font;  ///< 字体
+    matrix_led_rect_t area;         ///< 显示区域（裁剪范围）
+    matrix_led_color_t color;       ///< 文字颜色
+    matrix_led_color_t background;  ///< 背景颜色
+    char text[MATRIX_LED_TEXT_MAX_LEN + 1]; ///< 当前文本
+    uint16_t text_width;            ///< 文本像素宽度
+    uint16_t period;                ///< 滚动周期（文本宽度 + 区域宽度的间隔）
+    uint16_t offset;                ///< 区域左边缘对应的文本列
+    bool drawn;                     ///< 帧缓冲区中的区域内容与当前状态一致
+    uint32_t strip[MATRIX_LED_FONT_MAX_HEIGHT][MATRIX_LED_TEXT_STRIP_WORDS]; ///< 文本位图缓存
+} matrix_led_text_t;
+
+// ==================== 字体 ====================
+
+/**
+ * @brief 字符串的像素宽度
+ *
+ * @param font 字体
+ * @param text 文本
+ * @return 像素宽度（不含末尾间距）
+ */
+uint16_t matrix_led_font_text_width(const matrix_led_font_t *font,
+                                    const char *text);
+
+/**
+ * @brief 把文本绘制到帧缓冲区（透明背景）
+ *
+ * @param frame 帧缓冲区 (MATRIX_LED_COUNT)
+ * @param font 字体
+ * @param x 左上角X坐标，可以为负数或超出屏幕
+ * @param y 左上角Y坐标，可以为负数或超出屏幕
+ * @param text 文本
+ * @param color 文字颜色
+ * @param clip 裁剪区域，为NULL时裁剪到整个屏幕
+ * @return 被修改的行掩码
+ */
+uint32_t matrix_led_font_draw(matrix_led_color_t *frame,
+                              const matrix_led_font_t *font, int16_t x,
+                              int16_t y, const char *text,
+                              matrix_led_color_t color,
+                              const matrix_led_rect_t *clip);
+
+// ==================== 文本对象 ====================
+
+/**
+ * @brief 初始化文本对象
+ *
+ * @param text 文本对象
+ * @param font 字体
+ * @param area 显示区域（超出屏幕的部分被裁掉）
+ * @param color 文字颜色
+ * @param background 背景颜色
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效或区域为空
+ */
+esp_err_t matrix_led_text_init(matrix_led_text_t *text,
+                               const matrix_led_font_t *font,
+                               const matrix_led_rect_t *area,
+                               matrix_led_color_t color,
+                               matrix_led_color_t background);
+
+/**
+ * @brief 设置文本内容
+ *
+ * 内容与当前相同时不做任何工作；否则重新光栅化位图缓存，滚动回到起点，
+ * 下一次绘制整体重绘。
+ *
+ * @param text 文本对象
+ * @param str 文本，超过 MATRIX_LED_TEXT_MAX_LEN 的部分被截断
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ */
+esp_err_t matrix_led_text_set(matrix_led_text_t *text, const char *str);
+
+/**
+ * @brief 按当前滚动位置重绘整个区域
+ *
+ * @param text 文本对象
+ * @param frame 帧缓冲区 (MATRIX_LED_COUNT)
+ * @return 被修改的行掩码
+ */
+uint32_t matrix_led_text_render(matrix_led_text_t *text,
+                                matrix_led_color_t *frame);
+
+/**
+ * @brief 向左滚动 step 列（增量绘制）
+ *
+ * 帧缓冲区必须保留上一次绘制的区域内容（matrix_led_present 会把已提交的帧
+ * 复制到新的后台缓冲区）。区域被其他绘制覆盖后应先调用
+ * matrix_led_text_invalidate。
+ *
+ * @param text 文本对象
+ * @param frame 帧缓冲区 (MATRIX_LED_COUNT)
+ * @param step 滚动列数
+ * @return 被修改的行掩码
+ */
+uint32_t matrix_led_text_scroll(matrix_led_text_t *text,
+                                matrix_led_color_t *frame, uint16_t step);
+
+/**
+ * @brief 标记区域内容已失效，下一次滚动整体重绘
+ *
+ * @param text 文本对象
+ */
+void matrix_led_text_invalidate(matrix_led_text_t *text);
+
+// ==================== 组件接入 ====================
+
+/**
+ * @brief 用指定字体绘制文本到后台缓冲区
+ *
+ * @param x 左上角X坐标
+ * @param y 左上角Y坐标
+ * @param text 文本
+ * @param font 字体，为NULL时使用5x7字体
+ * @param color 文字颜色
+ * @param clip 裁剪区域，为NULL时裁剪到整个屏幕
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ */
+esp_err_t matrix_led_draw_text_font(int16_t x, int16_t y, const char *text,
+                                    const matrix_led_font_t *font,
+                                    matrix_led_color_t color,
+                                    const matrix_led_rect_t *clip);
+
+/**
+ * @brief 在后台缓冲区重绘文本对象
+ *
+ * @param text 文本对象
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ */
+esp_err_t matrix_led_draw_text_layout(matrix_led_text_t *text);
+
+/**
+ * @brief 在后台缓冲区增量滚动文本对象
+ *
+ * @param text 文本对象
+ * @param step 滚动列数
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ */
+esp_err_t matrix_led_scroll_text(matrix_led_text_t *text, uint16_t step);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATRIX_LED_FONT_H
@@ -0,0 +1,64 @@
+/**
+ * @file matrix_led_histogram.h
+ * @brief Matrix LED 帧耗时直方图
+ *
+ * 对数-线性分桶（每个二进制数量级4个子桶，相对误差不超过25%），
+ * 覆盖 0 ~ 131ms，更大的值计入最后一个桶。记录操作只有几次整数
+ * 运算，可以在动画任务和刷新任务的热路径上使用。
+ *
+ * 本模块不依赖FreeRTOS和驱动，可以在主机上编译。
+ */
+
+#ifndef MATRIX_LED_HISTOGRAM_H
+#define MATRIX_LED_HISTOGRAM_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MATRIX_LED_HISTOGRAM_BUCKETS 64 ///< 桶数量
+
+/**
+ * @brief 耗时直方图（单位：微秒）
+ */
+typedef struct {
+    uint32_t buckets[MATRIX_LED_HISTOGRAM_BUCKETS]; ///< 各桶计数
+    uint32_t count;                                 ///< 样本总数
+    uint32_t max_us;                                ///< 最大值
+    uint64_t total_us;                              ///< 累计值
+} matrix_led_histogram_t;
+
+/**
+ * @brief 清空直方图
+ *
+ * @param hist 直方图
+ */
+void matrix_led_histogram_reset(matrix_led_histogram_t *hist);
+
+/**
+ * @brief 记录一个样本
+ *
+ * @param hist 直方图
+ * @param value_us 耗时（微秒）
+ */
+void matrix_led_histogram_record(matrix_led_histogram_t *hist, uint32_t value_us);
+
+/**
+ * @brief 计算百分位数
+ *
+ * 返回样本所在桶的上界（不超过记录到的最大值）。
+ *
+ * @param hist 直方图
+ * @param percentile 百分位 (1-100)
+ * @return 百分位耗时（微秒），没有样本时返回0
+ */
+uint32_t matrix_led_histogram_percentile(const matrix_led_histogram_t *hist,
+                                         uint8_t percentile);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATRIX_LED_HISTOGRAM_H
@@ -0,0 +1,287 @@
+/**
+ * @file matrix_led_layer.h
+ * @brief Matrix LED 图层合成
+ *
+ * 画面由最多 MATRIX_LED_LAYER_MAX 个图层按 z 顺序叠加而成。每个图层有自己的
+ * 像素缓冲区、位置、不透明度和像素格式：
+ *   - OPAQUE: 整个图层覆盖下方内容（不透明度小于255时按比例混合）
+ *   - KEYED:  黑色像素透明，适合文字和图标
+ *   - ALPHA:  逐像素8位alpha，适合带半透明边缘的精灵
+ *
+ * 图层内容修改后只标记该图层的脏行；合成时仅重新混合脏行，并从该行最上方的
+ * 完整不透明图层开始，下方被完全遮挡的图层不参与计算。KEYED/ALPHA 图层按行
+ * 缓存非透明像素的位掩码（只在脏行上重新计算），混合时只处理这些像素。
+ *
+ * 图层像素写入和脏行标记是无锁的，可以在任意任务中进行；增删图层和修改图层
+ * 属性需要与合成串行执行（组件接入函数内部使用提交锁）。
+ *
+ * 除“组件接入”部分外，本模块不依赖FreeRTOS和驱动，可以在主机上编译。
+ */
+
+#ifndef MATRIX_LED_LAYER_H
+#define MATRIX_LED_LAYER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "matrix_led.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MATRIX_LED_LAYER_MAX  4     ///< 最大图层数
+
+/**
+ * @brief 图层像素格式
+ */
+typedef enum {
+    MATRIX_LED_LAYER_OPAQUE = 0,    ///< 不透明
+    MATRIX_LED_LAYER_KEYED,         ///< 黑色为透明
+    MATRIX_LED_LAYER_ALPHA,         ///< 逐像素alpha
+} matrix_led_layer_format_t;
+
+/**
+ * @brief 图层配置
+ */
+typedef struct {
+    int16_t x;                          ///< 左上角在屏幕上的X坐标（可以部分移出屏幕）
+    int16_t y;                          ///< 左上角在屏幕上的Y坐标
+    uint8_t width;                      ///< 宽度，0表示与屏幕相同（创建后不可修改）
+    uint8_t height;                     ///< 高度，0表示与屏幕相同（创建后不可修改）
+    matrix_led_layer_format_t format;   ///< 像素格式（创建后不可修改）
+    int8_t z;                           ///< z顺序，大的在上；相同时后创建的在上
+    uint8_t opacity;                    ///< 整体不透明度 (0-255)
+    bool visible;                       ///< 是否显示
+} matrix_led_layer_config_t;
+
+/**
+ * @brief 图层
+ *
+ * pixels/alpha 按行存储（width * height）。直接写入缓冲区后必须调用
+ * matrix_led_layer_mark_dirty 标记被修改的行。
+ */
+typedef struct {
+    matrix_led_color_t *pixels;         ///< 像素缓冲区
+    uint8_t *alpha;                     ///< alpha缓冲区（仅ALPHA格式，其他为NULL）
+    matrix_led_layer_config_t config;   ///< 当前配置
+    uint32_t dirty_rows;                ///< 自上次合成以来的脏行（图层坐标，原子访问）
+    uint32_t coverage_rows;             ///< 含有非透明像素的行（图层坐标，合成时更新）
+    uint32_t masks[MATRIX_LED_HEIGHT];  ///< 每行非透明像素的位掩码，bit31为第0列（KEYED/ALPHA）
+} matrix_led_layer_t;
+
+/**
+ * @brief 合成器
+ */
+typedef struct {
+    matrix_led_layer_t *layers[MATRIX_LED_LAYER_MAX]; ///< 按z顺序从下到上排列
+    uint8_t count;                      ///< 图层数
+    matrix_led_color_t background;      ///< 所有图层下方的底色
+    uint32_t damage_rows;               ///< 因图层增删/移动等需要重新合成的屏幕行（原子访问）
+    uint32_t compositions;              ///< 合成次数（有脏行的）
+    uint32_t composed_rows;             ///< 累计重新合成的行数
+    uint32_t blended_pixels;            ///< 累计参与混合的图层像素数
+} matrix_led_compositor_t;
+
+// ==================== 图层像素操作 ====================
+
+/**
+ * @brief 设置图层像素
+ *
+ * @param layer 图层
+ * @param x 图层内X坐标
+ * @param y 图层内Y坐标
+ * @param color 颜色
+ * @param alpha alpha值（仅ALPHA格式使用）
+ */
+void matrix_led_layer_set_pixel(matrix_led_layer_t *layer, uint8_t x,
+                                uint8_t y, matrix_led_color_t color,
+                                uint8_t alpha);
+
+/**
+ * @brief 用同一颜色填充整个图层
+ *
+ * @param layer 图层
+ * @param color 颜色（KEYED格式下黑色即透明）
+ * @param alpha alpha值（仅ALPHA格式使用，0为透明）
+ */
+void matrix_led_layer_fill(matrix_led_layer_t *layer, matrix_led_color_t color,
+                           uint8_t alpha);
+
+/**
+ * @brief 把图像块复制到图层（超出图层的部分被裁掉）
+ *
+ * @param layer 图层
+ * @param x 目标X坐标（图层内，可以为负数）
+ * @param y 目标Y坐标（图层内，可以为负数）
+ * @param width 图像宽度
+ * @param height 图像高度
+ * @param pixels 图像像素（width * height）
+ * @param alpha 图像alpha（width * height），为NULL时视为全不透明；非ALPHA格式忽略
+ */
+void matrix_led_layer_blit(matrix_led_layer_t *layer, int16_t x, int16_t y,
+                           uint8_t width, uint8_t height,
+                           const matrix_led_color_t *pixels,
+                           const uint8_t *alpha);
+
+/**
+ * @brief 标记图层中被修改的行（直接写入 pixels/alpha 后调用）
+ *
+ * @param layer 图层
+ * @param rows 行掩码（图层坐标，bit n 为第 n 行）
+ */
+void matrix_led_layer_mark_dirty(matrix_led_layer_t *layer, uint32_t rows);
+
+// ==================== 合成器 ====================
+
+/**
+ * @brief 初始化合成器
+ *
+ * @param compositor 合成器
+ * @param background 底色
+ */
+void matrix_led_compositor_init(matrix_led_compositor_t *compositor,
+                                matrix_led_color_t background);
+
+/**
+ * @brief 释放合成器中的所有图层
+ *
+ * @param compositor 合成器
+ */
+void matrix_led_compositor_deinit(matrix_led_compositor_t *compositor);
+
+/**
+ * @brief 创建图层（内容初始化为透明/黑色）
+ *
+ * @param compositor 合成器
+ * @param config 图层配置
+ * @param layer 输出图层
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_NO_MEM: 图层数已满或内存不足
+ */
+esp_err_t matrix_led_compositor_add_layer(
+    matrix_led_compositor_t *compositor,
+    const matrix_led_layer_config_t *config, matrix_led_layer_t **layer);
+
+/**
+ * @brief 删除并释放图层
+ *
+ * @param compositor 合成器
+ * @param layer 图层
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_NOT_FOUND: 图层不属于该合成器
+ */
+esp_err_t matrix_led_compositor_remove_layer(matrix_led_compositor_t *compositor,
+                                             matrix_led_layer_t *layer);
+
+/**
+ * @brief 修改图层的位置、z顺序、不透明度和可见性
+ *
+ * 宽度、高度和格式不能修改，config 中对应字段被忽略。
+ *
+ * @param compositor 合成器
+ * @param layer 图层
+ * @param config 新配置
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_NOT_FOUND: 图层不属于该合成器
+ */
+esp_err_t matrix_led_compositor_update_layer(
+    matrix_led_compositor_t *compositor, matrix_led_layer_t *layer,
+    const matrix_led_layer_config_t *config);
+
+/**
+ * @brief 把脏行重新合成到帧缓冲区
+ *
+ * 只写入需要重新合成的行，其余行保持不变，因此帧缓冲区必须保留上一次合成的
+ * 结果（matrix_led_present 会把已提交的帧复制到新的后台缓冲区）。
+ *
+ * @param compositor 合成器
+ * @param frame 帧缓冲区 (MATRIX_LED_COUNT)
+ * @return 被重新合成的屏幕行掩码
+ */
+uint32_t matrix_led_compositor_compose(matrix_led_compositor_t *compositor,
+                                       matrix_led_color_t *frame);
+
+// ==================== 组件接入 ====================
+
+/**
+ * @brief 在组件的合成器中创建图层
+ *
+ * 存在图层时，每次 matrix_led_present 先把脏行合成到后台缓冲区再提交。
+ *
+ * @param config 图层配置
+ * @param layer 输出图层
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ *     - ESP_ERR_NO_MEM: 图层数已满或内存不足
+ */
+esp_err_t matrix_led_add_layer(const matrix_led_layer_config_t *config,
+                               matrix_led_layer_t **layer);
+
+/**
+ * @brief 删除图层（同时解除其绘制目标和动画目标身份）
+ *
+ * @param layer 图层
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ *     - ESP_ERR_NOT_FOUND: 图层不存在
+ */
+esp_err_t matrix_led_remove_layer(matrix_led_layer_t *layer);
+
+/**
+ * @brief 修改图层的位置、z顺序、不透明度和可见性
+ *
+ * @param layer 图层
+ * @param config 新配置
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ *     - ESP_ERR_NOT_FOUND: 图层不存在
+ */
+esp_err_t matrix_led_update_layer(matrix_led_layer_t *layer,
+                                  const matrix_led_layer_config_t *config);
+
+/**
+ * @brief 选择绘制API（像素、填充、图形、文字）的目标图层
+ *
+ * 只能选择与屏幕同尺寸的图层。为NULL时绘制API直接写入后台缓冲区，写入的行
+ * 在下一次有图层变化时可能被合成结果覆盖。
+ *
+ * @param layer 图层，NULL表示后台缓冲区
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 图层尺寸与屏幕不同
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ *     - ESP_ERR_NOT_FOUND: 图层不存在
+ */
+esp_err_t matrix_led_select_layer(matrix_led_layer_t *layer);
+
+/**
+ * @brief 让 matrix_led_play_animation 播放的动画绘制到指定图层
+ *
+ * 只能选择与屏幕同尺寸的图层。其他图层上的静态内容保持不变，每帧只重新合成
+ * 动画修改的行。
+ *
+ * @param layer 图层，NULL表示后台缓冲区
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 图层尺寸与屏幕不同
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ *     - ESP_ERR_NOT_FOUND: 图层不存在
+ */
+esp_err_t matrix_led_set_animation_layer(matrix_led_layer_t *layer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATRIX_LED_LAYER_H
@@ -0,0 +1,169 @@
+/**
+ * @file matrix_led_output.h
+ * @brief Matrix LED 输出后端
+ *
+ * 刷新任务只通过本接口把校正后的像素写到输出设备：RMT后端驱动WS2812灯板，
+ * 内存后端把帧保存在RAM中（可导出为PPM图像），用于主机端基准测试和无硬件
+ * 的渲染路径验证。后端以函数指针结构体实现，与 led_strip 驱动的组织方式相同。
+ *
+ * 除 matrix_led_output_new_rmt 外，本模块不依赖FreeRTOS和驱动，可以在主机上编译。
+ */
+
+#ifndef MATRIX_LED_OUTPUT_H
+#define MATRIX_LED_OUTPUT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "esp_err.h"
+#include "matrix_led.h"
+#include "matrix_led_correction.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct matrix_led_output matrix_led_output_t;
+
+/**
+ * @brief 输出后端接口
+ */
+struct matrix_led_output {
+    /** 设置一个像素（校正后的颜色，写入后端的发送缓冲区） */
+    esp_err_t (*set_pixel)(matrix_led_output_t *output, uint32_t index,
+                           matrix_led_color_t color);
+    /** 把发送缓冲区输出到设备 */
+    esp_err_t (*refresh)(matrix_led_output_t *output);
+    /** 熄灭全部像素 */
+    esp_err_t (*clear)(matrix_led_output_t *output);
+    /** 释放后端 */
+    esp_err_t (*del)(matrix_led_output_t *output);
+    const char *name; ///< 后端名称
+};
+
+/**
+ * @brief 帧写入统计
+ */
+typedef struct {
+    uint32_t corrected_pixels;  ///< 执行色彩校正的像素数
+    uint32_t written_pixels;    ///< 实际写入后端的像素数
+} matrix_led_output_stats_t;
+
+// ==================== 通用接口 ====================
+
+/**
+ * @brief 校正脏行并把与上次发送不同的像素写入后端
+ *
+ * 不调用 refresh，由调用方在返回 true 后决定何时输出。
+ *
+ * @param output 输出后端
+ * @param correction 校正查找表
+ * @param frame 待发送的帧 (MATRIX_LED_COUNT)
+ * @param sent 上次发送的校正后像素，写入后同步更新
+ * @param dirty_rows 需要重新校正的行掩码
+ * @param stats 累加统计，可以为NULL
+ * @param changed 输出是否有像素被写入
+ * @return
+ *     - ESP_OK: 成功
+ *     - 其他: 后端 set_pixel 返回的错误
+ */
+esp_err_t matrix_led_output_write_frame(matrix_led_output_t *output,
+                                        const matrix_led_correction_t *correction,
+                                        const matrix_led_color_t *frame,
+                                        matrix_led_color_t *sent,
+                                        uint32_t dirty_rows,
+                                        matrix_led_output_stats_t *stats,
+                                        bool *changed);
+
+/**
+ * @brief 释放后端
+ *
+ * @param output 输出后端，可以为NULL
+ */
+void matrix_led_output_del(matrix_led_output_t *output);
+
+// ==================== RMT后端 ====================
+
+/**
+ * @brief 创建驱动WS2812矩阵的RMT后端
+ *
+ * @param gpio_num 数据引脚
+ * @param resolution_hz RMT分辨率
+ * @param output 输出后端
+ * @return
+ *     - ESP_OK: 成功
+ *     - 其他: led_strip 驱动返回的错误
+ */
+esp_err_t matrix_led_output_new_rmt(int gpio_num, uint32_t resolution_hz,
+                                    matrix_led_output_t **output);
+
+// ==================== 内存后端 ====================
+
+/**
+ * @brief 创建内存后端
+ *
+ * 每次 refresh 把发送缓冲区锁存为一帧，可通过
+ * matrix_led_output_memory_get_frame 读取或导出为PPM图像。
+ *
+ * @param output 输出后端
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_NO_MEM: 内存不足
+ */
+esp_err_t matrix_led_output_new_memory(matrix_led_output_t **output);
+
+/**
+ * @brief 最近一次 refresh 锁存的帧
+ *
+ * @param output 内存后端
+ * @param refresh_count 输出累计 refresh 次数，可以为NULL
+ * @return 帧像素 (MATRIX_LED_COUNT)，不是内存后端时返回NULL
+ */
+const matrix_led_color_t *matrix_led_output_memory_get_frame(
+    const matrix_led_output_t *output, uint32_t *refresh_count);
+
+/**
+ * @brief 把最近一次锁存的帧保存为二进制PPM (P6) 图像
+ *
+ * @param output 内存后端
+ * @param filepath 文件路径
+ * @param scale 每个LED放大的像素数 (1-32)
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效或不是内存后端
+ *     - ESP_FAIL: 文件写入失败
+ */
+esp_err_t matrix_led_output_memory_dump_ppm(const matrix_led_output_t *output,
+                                            const char *filepath,
+                                            uint8_t scale);
+
+// ==================== 组件接入 ====================
+
+/**
+ * @brief 切换 matrix_led 组件的输出后端
+ *
+ * 新后端先被清空，随后整帧（包括当前的静态画面）重新校正并发送。
+ * 后端由调用方创建和释放，正在使用的后端不能释放。返回ESP_OK时刷新任务
+ * 已不再访问旧后端，可以立即释放它。
+ *
+ * @param output 输出后端，为NULL时恢复默认的RMT后端
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_STATE: 组件未初始化
+ *     - ESP_ERR_TIMEOUT: 获取锁超时，或等待当前帧发送完成超时
+ *       （已切换，但旧后端可能仍在使用，不能释放）
+ */
+esp_err_t matrix_led_set_output(matrix_led_output_t *output);
+
+/**
+ * @brief 当前使用的输出后端
+ *
+ * @return 输出后端，组件未初始化时返回NULL
+ */
+matrix_led_output_t *matrix_led_get_output(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATRIX_LED_OUTPUT_H
@@ -0,0 +1,49 @@
+/**
+ * @file matrix_led_render.h
+ * @brief Matrix LED 内置动画渲染
+ *
+ * 彩虹、波浪、呼吸、旋转和渐变动画的逐帧绘制。渲染只依赖动画配置和动画时钟，
+ * 直接写入调用方提供的帧缓冲区并返回脏行掩码，动画任务和主机端基准测试共用
+ * 同一份实现。
+ *
+ * 本模块不依赖FreeRTOS和驱动，可以在主机上编译。
+ */
+
+#ifndef MATRIX_LED_RENDER_H
+#define MATRIX_LED_RENDER_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "matrix_led.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 动画相位的时间单位（与 CONFIG_FREERTOS_HZ=100 时的一个tick相同，保持原有动画速度） */
+#define MATRIX_LED_RENDER_PHASE_US 10000
+
+/**
+ * @brief 绘制一帧内置动画
+ *
+ * @param type 动画类型
+ * @param config 动画配置（颜色、速度）
+ * @param elapsed_us 动画时钟 (微秒)
+ * @param frame 帧缓冲区 (MATRIX_LED_COUNT)
+ * @param dirty_rows 输出被修改的行掩码，可以为NULL
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_NOT_SUPPORTED: 不是内置动画（如自定义动画）
+ */
+esp_err_t matrix_led_render_builtin(matrix_led_animation_type_t type,
+                                    const matrix_led_animation_config_t *config,
+                                    uint64_t elapsed_us,
+                                    matrix_led_color_t *frame,
+                                    uint32_t *dirty_rows);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATRIX_LED_RENDER_H
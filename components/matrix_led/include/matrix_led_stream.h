@@ -0,0 +1,84 @@
+/**
+ * @file matrix_led_stream.h
+ * @brief Matrix LED 动画流式播放（SD卡预取）
+ *
+ * 独立的读取任务把二进制动画的帧记录预先读入环形缓冲区，渲染任务在帧截止时间
+ * 到达时只做内存解码，不再直接访问文件系统。SD卡的偶发延迟由缓冲区吸收，
+ * 长动画也能保持稳定帧率。
+ */
+
+#ifndef MATRIX_LED_STREAM_H
+#define MATRIX_LED_STREAM_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "matrix_led_anim.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MATRIX_LED_STREAM_TASK_STACK_SIZE 4096 ///< 读取任务栈大小
+#define MATRIX_LED_STREAM_TASK_PRIORITY   2    ///< 读取任务优先级（低于动画任务）
+#define MATRIX_LED_STREAM_PRIME_TIMEOUT_MS 1000 ///< 启动时等待缓冲区填满的时间
+
+/**
+ * @brief 流式播放句柄
+ */
+typedef struct matrix_led_stream matrix_led_stream_t;
+
+/**
+ * @brief 启动读取任务并预填缓冲区
+ *
+ * 读取器在播放期间由读取任务独占访问文件，调用方在 matrix_led_stream_stop
+ * 之前不能再读取、定位或关闭它。
+ *
+ * @param reader 已选中动画的读取器
+ * @param stream 输出句柄
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_INVALID_ARG: 参数无效
+ *     - ESP_ERR_NO_MEM: 内存不足或任务创建失败
+ *     - ESP_FAIL: 首帧读取失败
+ */
+esp_err_t matrix_led_stream_start(matrix_led_anim_reader_t *reader,
+                                  matrix_led_stream_t **stream);
+
+/**
+ * @brief 取出并解码下一帧（渲染任务调用，不阻塞）
+ *
+ * @param stream 句柄
+ * @param frame 帧缓冲区 (MATRIX_LED_COUNT)，增量帧在现有内容上更新
+ * @param delay_ms 输出本帧显示时间 (毫秒)，可以为NULL
+ * @param dirty_rows 输出被修改的行掩码，可以为NULL
+ * @return
+ *     - ESP_OK: 成功
+ *     - ESP_ERR_TIMEOUT: 缓冲区为空（欠载），稍后重试
+ *     - ESP_ERR_NOT_FOUND: 非循环动画已播放完毕
+ *     - ESP_FAIL: 帧数据损坏或读取失败
+ */
+esp_err_t matrix_led_stream_next_frame(matrix_led_stream_t *stream,
+                                       matrix_led_color_t *frame,
+                                       uint16_t *delay_ms,
+                                       uint32_t *dirty_rows);
+
+/**
+ * @brief 当前已缓冲的帧数
+ *
+ * @param stream 句柄，可以为NULL
+ * @return 帧数
+ */
+uint32_t matrix_led_stream_buffered_frames(matrix_led_stream_t *stream);
+
+/**
+ * @brief 停止读取任务并释放句柄
+ *
+ * @param stream 句柄，可以为NULL
+ */
+void matrix_led_stream_stop(matrix_led_stream_t *stream);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MATRIX_LED_STREAM_H
@@ -9,6 +9,15 @@
 #include "console_core.h"
 #include "event_manager.h"
 #include "hardware_hal.h"
+#include "led_kernel.h"
+#include "matrix_led_anim.h"
+#include "matrix_led_correction.h"
+#include "matrix_led_font.h"
+#include "matrix_led_histogram.h"
+#include "matrix_led_layer.h"
+#include "matrix_led_output.h"
+#include "matrix_led_render.h"
+#include "matrix_led_stream.h"
 
 #include "cJSON.h"
 #include "esp_err.h"
@@ -18,8 +27,6 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
-#include "freertos/timers.h"
-#include "led_strip.h"
 #include "nvs.h"
 #include <dirent.h>
 #include <errno.h>
@@ -39,7 +46,28 @@ static const char *TAG = "matrix_led";
 
 #define MATRIX_LED_TASK_STACK_SIZE 4096
 #define MATRIX_LED_TASK_PRIORITY 3
-#define MATRIX_LED_ANIMATION_TASK_DELAY_MS 20
+// 等待动画任务退出的时间，须长于最低帧率下的一个帧周期
+#define MATRIX_LED_TASK_EXIT_TIMEOUT_MS 2000
+
+// 刷新任务（负责校正和RMT发送），优先级高于动画任务以便绘制与发送重叠
+#define MATRIX_LED_REFRESH_TASK_STACK_SIZE 3072
+#define MATRIX_LED_REFRESH_TASK_PRIORITY 4
+
+// 帧缓冲：后台(绘制) / 待显示(已提交) / 前台(发送中)
+#define MATRIX_LED_FRAMEBUFFER_COUNT 3
+#define MATRIX_LED_FLIP_INDEX_MASK 0x03
+#define MATRIX_LED_FLIP_PENDING 0x04
+
+// 从提交到开始发送超过该时间的帧计为迟到帧
+#define MATRIX_LED_LATE_FRAME_US 20000
+
+// 脏行跟踪：每行一位，按提交序号记录最近若干帧的脏行掩码
+#define MATRIX_LED_ALL_ROWS_DIRTY                                              \
+  ((uint32_t)(((uint64_t)1 << MATRIX_LED_HEIGHT) - 1))
+#define MATRIX_LED_DIRTY_HISTORY 16
+#define MATRIX_LED_DIRTY_HISTORY_MASK (MATRIX_LED_DIRTY_HISTORY - 1)
+
+_Static_assert(MATRIX_LED_HEIGHT <= 32, "dirty row mask holds 32 rows");
 
 #define MATRIX_LED_CONFIG_NAMESPACE "matrix_led"
 #define MATRIX_LED_CONFIG_KEY_BRIGHTNESS "brightness"
@@ -75,9 +103,11 @@ typedef struct {
   matrix_led_animation_config_t config; ///< 动画配置
   uint32_t frame_counter;               ///< 帧计数器
   uint32_t start_time;                  ///< 开始时间
-  uint8_t *custom_frames;               ///< 自定义动画帧数据
-  size_t custom_frame_count;            ///< 自定义动画帧数量
-  size_t current_frame;                 ///< 当前帧索引
+  uint64_t elapsed_us;                  ///< 动画时钟（按固定帧步长推进）
+  matrix_led_anim_reader_t *custom_reader; ///< 已加载的二进制动画（流式解码）
+  matrix_led_stream_t *custom_stream;   ///< 自定义动画的SD卡预取流
+  uint64_t custom_next_us;              ///< 下一帧自定义动画的显示时刻
+  bool custom_starved;                  ///< 上一次到期时缓冲区为空
 } matrix_led_animation_state_t;
 
 /**
@@ -91,22 +121,68 @@ typedef struct {
   uint8_t brightness;     ///< 亮度设置
 
   // LED硬件
-  led_strip_handle_t led_strip;     ///< LED条带句柄
-  matrix_led_color_t *pixel_buffer; ///< 像素缓冲区
+  matrix_led_output_t *output;      ///< 当前输出后端（刷新任务使用）
+  matrix_led_output_t *rmt_output;  ///< 默认的RMT后端
+  matrix_led_output_t *sent_output; ///< 上次写入的后端（刷新任务独占）
+  matrix_led_color_t *pixel_buffer; ///< 后台缓冲区（绘制目标）
+
+  // 帧缓冲翻页
+  matrix_led_color_t *framebuffer_pool; ///< 帧缓冲内存池
+  matrix_led_color_t
+      *framebuffers[MATRIX_LED_FRAMEBUFFER_COUNT]; ///< 帧缓冲数组
+  uint8_t back_index;              ///< 后台缓冲索引（生产者独占）
+  uint8_t front_index;             ///< 前台缓冲索引（刷新任务独占）
+  uint32_t flip_state;             ///< 待显示缓冲索引 | 待显示标志（原子访问）
+  int64_t present_time_us[MATRIX_LED_FRAMEBUFFER_COUNT]; ///< 提交时间
+  bool transmitting;               ///< 正在使用输出后端（原子访问）
+
+  // 脏行跟踪
+  uint32_t back_dirty_rows; ///< 后台缓冲区自上次提交以来的脏行（原子访问）
+  uint32_t present_seq;     ///< 最近一次提交的帧序号（生产者）
+  uint32_t frame_seq[MATRIX_LED_FRAMEBUFFER_COUNT]; ///< 各缓冲区的帧序号
+  uint32_t dirty_history[MATRIX_LED_DIRTY_HISTORY]; ///< 按帧序号记录的脏行
+  uint32_t sent_seq;                ///< 最近发送帧的序号（刷新任务独占）
+  matrix_led_color_t *sent_buffer;  ///< 最近发送到LED的校正后像素
+
+  // 图层合成
+  matrix_led_compositor_t compositor;     ///< 合成器（有图层时在提交前合成）
+  matrix_led_layer_t *draw_layer;         ///< 绘制API的目标图层，NULL为后台缓冲区
+  matrix_led_layer_t *animation_layer;    ///< 动画的目标图层，NULL为后台缓冲区
+
+  // 色彩校正
+  matrix_led_correction_t correction; ///< 融合校正查找表
+  volatile bool correction_dirty;     ///< 查找表需要重建
 
   // 动画管理
   matrix_led_animation_state_t animation; ///< 动画状态
   TaskHandle_t animation_task_handle;     ///< 动画任务句柄
-  TimerHandle_t animation_timer;          ///< 动画定时器
+  TaskHandle_t refresh_task_handle;       ///< 刷新任务句柄
+  volatile bool animation_task_exit;      ///< 动画任务应退出
+  SemaphoreHandle_t animation_task_done;  ///< 动画任务退出时释放
+
+  // 帧调度
+  uint8_t target_fps;                    ///< 目标帧率
+  volatile bool schedule_reset;          ///< 需要重新建立调度基准
+  uint32_t rendered_frames;              ///< 已渲染的动画帧数
+  uint32_t missed_frames;                ///< 因错过截止时间而跳过的帧数
+  matrix_led_histogram_t render_hist;    ///< 渲染耗时（绘制+提交）
+  matrix_led_histogram_t transmit_hist;  ///< 发送耗时（校正+RMT）
 
   // 同步控制
   SemaphoreHandle_t mutex;               ///< 互斥锁
+  SemaphoreHandle_t present_mutex;       ///< 提交互斥锁（串行化多个生产者）
   SemaphoreHandle_t refresh_semaphore;   ///< 刷新信号量
   SemaphoreHandle_t animation_semaphore; ///< 动画信号量
 
   // 统计信息
   uint32_t frame_count;       ///< 总帧数计数
   uint32_t last_refresh_time; ///< 上次刷新时间
+  uint32_t presented_frames;  ///< 已提交帧数
+  uint32_t dropped_frames;    ///< 未发送即被覆盖的帧数
+  uint32_t late_frames;       ///< 迟到帧数
+  uint32_t skipped_frames;    ///< 内容未变化而跳过发送的帧数
+  uint32_t corrected_pixels;  ///< 累计执行色彩校正的像素数
+  uint32_t stream_underruns;  ///< 流式播放到期时缓冲区为空的次数
 } matrix_led_context_t;
 
 // 全局上下文
@@ -117,7 +193,20 @@ static matrix_led_context_t s_context = {0};
 static esp_err_t matrix_led_init_hardware(void);
 static esp_err_t matrix_led_deinit_hardware(void);
 static void matrix_led_animation_task(void *pvParameters);
-static void matrix_led_animation_timer_callback(TimerHandle_t xTimer);
+static void matrix_led_render_animation_frame(void);
+static esp_err_t
+matrix_led_begin_animation(matrix_led_animation_type_t animation_type,
+                           const matrix_led_animation_config_t *config);
+static void matrix_led_stop_animation_locked(void);
+static void matrix_led_refresh_task(void *pvParameters);
+static esp_err_t matrix_led_transmit_pending_frame(void);
+static bool matrix_led_wait_transmit_idle(void);
+static uint32_t matrix_led_collect_dirty_rows(uint32_t seq, bool force_all);
+static inline void matrix_led_mark_dirty_rows(uint32_t rows);
+static inline matrix_led_color_t *
+matrix_led_target_buffer(matrix_led_layer_t *layer);
+static inline void matrix_led_mark_target_rows(matrix_led_layer_t *layer,
+                                               uint32_t rows);
 static esp_err_t matrix_led_load_default_config(void);
 static esp_err_t matrix_led_validate_coordinates(uint8_t x, uint8_t y);
 static uint32_t matrix_led_xy_to_index(uint8_t x, uint8_t y);
@@ -126,11 +215,8 @@ static esp_err_t matrix_led_send_event(matrix_led_event_type_t type,
                                        const matrix_led_event_data_t *data);
 
 // 动画函数
-static void matrix_led_animate_rainbow(void);
-static void matrix_led_animate_wave(void);
-static void matrix_led_animate_breathe(void);
-static void matrix_led_animate_rotate(void);
-static void matrix_led_animate_fade(void);
+static void matrix_led_animate_custom(void);
+static void matrix_led_stop_stream_playback(void);
 
 // 图形绘制辅助函数
 static void matrix_led_draw_pixel_safe(uint8_t x, uint8_t y,
@@ -141,9 +227,7 @@ static void matrix_led_draw_vertical_line(uint8_t x, uint8_t y0, uint8_t y1,
                                           matrix_led_color_t color);
 
 // 色彩校正函数
-static esp_err_t matrix_led_apply_all_corrections(matrix_led_color_t color,
-                                                  uint8_t brightness,
-                                                  matrix_led_color_t *result);
+static void matrix_led_rebuild_correction(void);
 static void matrix_led_color_correction_changed(void);
 
 // 控制台命令函数
@@ -186,22 +270,54 @@ esp_err_t matrix_led_init(void) {
     return ESP_ERR_NO_MEM;
   }
 
-  // 分配像素缓冲区
-  s_context.pixel_buffer = calloc(MATRIX_LED_COUNT, sizeof(matrix_led_color_t));
-  if (s_context.pixel_buffer == NULL) {
-    ESP_LOGE(TAG, "Failed to allocate pixel buffer");
+  // 创建提交互斥锁
+  s_context.present_mutex = xSemaphoreCreateMutex();
+  if (s_context.present_mutex == NULL) {
+    ESP_LOGE(TAG, "Failed to create present mutex");
     vSemaphoreDelete(s_context.mutex);
     vSemaphoreDelete(s_context.refresh_semaphore);
     vSemaphoreDelete(s_context.animation_semaphore);
     return ESP_ERR_NO_MEM;
   }
 
+  // 分配帧缓冲区（后台/待显示/前台）
+  // 额外一块用于保存最近发送的校正结果，与LED当前显示内容一致
+  s_context.framebuffer_pool =
+      calloc((MATRIX_LED_FRAMEBUFFER_COUNT + 1) * MATRIX_LED_COUNT,
+             sizeof(matrix_led_color_t));
+  if (s_context.framebuffer_pool == NULL) {
+    ESP_LOGE(TAG, "Failed to allocate frame buffers");
+    vSemaphoreDelete(s_context.mutex);
+    vSemaphoreDelete(s_context.present_mutex);
+    vSemaphoreDelete(s_context.refresh_semaphore);
+    vSemaphoreDelete(s_context.animation_semaphore);
+    return ESP_ERR_NO_MEM;
+  }
+  for (int i = 0; i < MATRIX_LED_FRAMEBUFFER_COUNT; i++) {
+    s_context.framebuffers[i] =
+        s_context.framebuffer_pool + (size_t)i * MATRIX_LED_COUNT;
+  }
+  s_context.sent_buffer = s_context.framebuffer_pool +
+                          (size_t)MATRIX_LED_FRAMEBUFFER_COUNT *
+                              MATRIX_LED_COUNT;
+  s_context.back_index = 0;
+  s_context.flip_state = 1;
+  s_context.front_index = 2;
+  s_context.pixel_buffer = s_context.framebuffers[s_context.back_index];
+  s_context.back_dirty_rows = 0;
+  s_context.present_seq = 0;
+  s_context.sent_seq = 0;
+  memset(s_context.frame_seq, 0, sizeof(s_context.frame_seq));
+  memset(s_context.dirty_history, 0, sizeof(s_context.dirty_history));
+  matrix_led_compositor_init(&s_context.compositor, MATRIX_LED_COLOR_BLACK);
+
   // 初始化硬件
   esp_err_t ret = matrix_led_init_hardware();
   if (ret != ESP_OK) {
     ESP_LOGE(TAG, "Failed to initialize hardware: %s", esp_err_to_name(ret));
-    free(s_context.pixel_buffer);
+    free(s_context.framebuffer_pool);
     vSemaphoreDelete(s_context.mutex);
+    vSemaphoreDelete(s_context.present_mutex);
     vSemaphoreDelete(s_context.refresh_semaphore);
     vSemaphoreDelete(s_context.animation_semaphore);
     return ret;
@@ -237,34 +353,51 @@ esp_err_t matrix_led_init(void) {
   s_context.brightness = MATRIX_LED_DEFAULT_BRIGHTNESS;
   s_context.mode = MATRIX_LED_MODE_STATIC;
   s_context.enabled = true;
+  s_context.correction_dirty = true;
+  s_context.target_fps = MATRIX_LED_DEFAULT_FPS;
+  s_context.schedule_reset = true;
+  matrix_led_histogram_reset(&s_context.render_hist);
+  matrix_led_histogram_reset(&s_context.transmit_hist);
 
-  // 创建动画定时器
-  s_context.animation_timer = xTimerCreate(
-      "matrix_led_timer", pdMS_TO_TICKS(MATRIX_LED_ANIMATION_TASK_DELAY_MS),
-      pdTRUE, // 自动重载
-      NULL, matrix_led_animation_timer_callback);
+  // 创建动画任务
+  s_context.animation_task_done = xSemaphoreCreateBinary();
+  BaseType_t task_ret =
+      s_context.animation_task_done == NULL
+          ? pdFAIL
+          : xTaskCreate(matrix_led_animation_task, "matrix_led_anim",
+                        MATRIX_LED_TASK_STACK_SIZE, NULL,
+                        MATRIX_LED_TASK_PRIORITY,
+                        &s_context.animation_task_handle);
 
-  if (s_context.animation_timer == NULL) {
-    ESP_LOGE(TAG, "Failed to create animation timer");
+  if (task_ret != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create animation task");
+    if (s_context.animation_task_done) {
+      vSemaphoreDelete(s_context.animation_task_done);
+    }
     matrix_led_deinit_hardware();
-    free(s_context.pixel_buffer);
+    free(s_context.framebuffer_pool);
     vSemaphoreDelete(s_context.mutex);
+    vSemaphoreDelete(s_context.present_mutex);
     vSemaphoreDelete(s_context.refresh_semaphore);
     vSemaphoreDelete(s_context.animation_semaphore);
     return ESP_ERR_NO_MEM;
   }
 
-  // 创建动画任务
-  BaseType_t task_ret = xTaskCreate(
-      matrix_led_animation_task, "matrix_led_anim", MATRIX_LED_TASK_STACK_SIZE,
-      NULL, MATRIX_LED_TASK_PRIORITY, &s_context.animation_task_handle);
+  // 创建刷新任务
+  task_ret = xTaskCreate(matrix_led_refresh_task, "matrix_led_refresh",
+                         MATRIX_LED_REFRESH_TASK_STACK_SIZE, NULL,
+                         MATRIX_LED_REFRESH_TASK_PRIORITY,
+                         &s_context.refresh_task_handle);
 
   if (task_ret != pdPASS) {
-    ESP_LOGE(TAG, "Failed to create animation task");
-    xTimerDelete(s_context.animation_timer, 0);
+    ESP_LOGE(TAG, "Failed to create refresh task");
+    // 此时动画任务仍在等待初始化完成，未持有任何锁
+    vTaskDelete(s_context.animation_task_handle);
+    vSemaphoreDelete(s_context.animation_task_done);
     matrix_led_deinit_hardware();
-    free(s_context.pixel_buffer);
+    free(s_context.framebuffer_pool);
     vSemaphoreDelete(s_context.mutex);
+    vSemaphoreDelete(s_context.present_mutex);
     vSemaphoreDelete(s_context.refresh_semaphore);
     vSemaphoreDelete(s_context.animation_semaphore);
     return ESP_ERR_NO_MEM;
@@ -304,21 +437,30 @@ esp_err_t matrix_led_deinit(void) {
   // 停止动画
   matrix_led_stop_animation();
 
-  // 删除任务和定时器
+  // 通知动画任务退出并等待其结束，不能在绘制中途（持有提交锁时）删除它
   if (s_context.animation_task_handle) {
-    vTaskDelete(s_context.animation_task_handle);
+    s_context.animation_task_exit = true;
+    xSemaphoreGive(s_context.animation_semaphore);
+    if (xSemaphoreTake(s_context.animation_task_done,
+                       pdMS_TO_TICKS(MATRIX_LED_TASK_EXIT_TIMEOUT_MS)) !=
+        pdTRUE) {
+      ESP_LOGW(TAG, "Animation task did not exit in time");
+      return ESP_ERR_TIMEOUT;
+    }
     s_context.animation_task_handle = NULL;
   }
 
-  if (s_context.animation_timer) {
-    xTimerDelete(s_context.animation_timer, 0);
-    s_context.animation_timer = NULL;
-  }
-
   // 清空显示
   matrix_led_clear();
   matrix_led_refresh();
 
+  // 等待当前帧发送完成后停止刷新任务
+  matrix_led_wait_transmit_idle();
+  if (s_context.refresh_task_handle) {
+    vTaskDelete(s_context.refresh_task_handle);
+    s_context.refresh_task_handle = NULL;
+  }
+
   // 反初始化硬件
   matrix_led_deinit_hardware();
 
@@ -330,14 +472,20 @@ esp_err_t matrix_led_deinit(void) {
   }
 
   // 释放资源
-  if (s_context.pixel_buffer) {
-    free(s_context.pixel_buffer);
+  if (s_context.framebuffer_pool) {
+    free(s_context.framebuffer_pool);
+    s_context.framebuffer_pool = NULL;
     s_context.pixel_buffer = NULL;
   }
+  s_context.draw_layer = NULL;
+  s_context.animation_layer = NULL;
+  matrix_led_compositor_deinit(&s_context.compositor);
 
-  if (s_context.animation.custom_frames) {
-    free(s_context.animation.custom_frames);
-    s_context.animation.custom_frames = NULL;
+  matrix_led_stop_stream_playback();
+  if (s_context.animation.custom_reader) {
+    matrix_led_anim_close(s_context.animation.custom_reader);
+    free(s_context.animation.custom_reader);
+    s_context.animation.custom_reader = NULL;
   }
 
   if (s_context.mutex) {
@@ -345,6 +493,11 @@ esp_err_t matrix_led_deinit(void) {
     s_context.mutex = NULL;
   }
 
+  if (s_context.present_mutex) {
+    vSemaphoreDelete(s_context.present_mutex);
+    s_context.present_mutex = NULL;
+  }
+
   if (s_context.refresh_semaphore) {
     vSemaphoreDelete(s_context.refresh_semaphore);
     s_context.refresh_semaphore = NULL;
@@ -355,6 +508,11 @@ esp_err_t matrix_led_deinit(void) {
     s_context.animation_semaphore = NULL;
   }
 
+  if (s_context.animation_task_done) {
+    vSemaphoreDelete(s_context.animation_task_done);
+    s_context.animation_task_done = NULL;
+  }
+
   s_context.initialized = false;
 
   ESP_LOGI(TAG, "Matrix LED deinitialized successfully");
@@ -369,6 +527,11 @@ esp_err_t matrix_led_set_enable(bool enable) {
     return ESP_ERR_INVALID_STATE;
   }
 
+  // 流式播放须在取得互斥锁之前停止
+  if (!enable && s_context.enabled) {
+    matrix_led_stop_stream_playback();
+  }
+
   if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
     return ESP_ERR_TIMEOUT;
   }
@@ -381,7 +544,9 @@ esp_err_t matrix_led_set_enable(bool enable) {
       matrix_led_clear();
       matrix_led_refresh();
       // 停止动画
-      matrix_led_stop_animation();
+      if (s_context.animation.is_running) {
+        matrix_led_stop_animation_locked();
+      }
     }
 
     ESP_LOGI(TAG, "Matrix LED %s", enable ? "enabled" : "disabled");
@@ -410,6 +575,16 @@ esp_err_t matrix_led_get_status(matrix_led_status_t *status) {
   status->brightness = s_context.brightness;
   status->pixel_count = MATRIX_LED_COUNT;
   status->frame_count = s_context.frame_count;
+  status->presented_frames = s_context.presented_frames;
+  status->dropped_frames = s_context.dropped_frames;
+  status->late_frames = s_context.late_frames;
+  status->skipped_frames = s_context.skipped_frames;
+  status->corrected_pixels = s_context.corrected_pixels;
+  status->stream_underruns = s_context.stream_underruns;
+  status->stream_buffered_frames =
+      matrix_led_stream_buffered_frames(s_context.animation.custom_stream);
+  status->layer_count = s_context.compositor.count;
+  status->composed_rows = s_context.compositor.composed_rows;
 
   if (s_context.animation.is_running) {
     strncpy(status->current_animation, s_context.animation.config.name,
@@ -435,14 +610,12 @@ esp_err_t matrix_led_set_pixel(uint8_t x, uint8_t y, matrix_led_color_t color) {
     return ret;
   }
 
-  if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-    return ESP_ERR_TIMEOUT;
-  }
-
+  // 直接写入后台缓冲区（或选中的图层），无需逐像素加锁
+  matrix_led_layer_t *layer = s_context.draw_layer;
   uint32_t index = matrix_led_xy_to_index(x, y);
-  s_context.pixel_buffer[index] = color;
+  matrix_led_target_buffer(layer)[index] = color;
+  matrix_led_mark_target_rows(layer, 1u << y);
 
-  xSemaphoreGive(s_context.mutex);
   return ESP_OK;
 }
 
@@ -457,14 +630,9 @@ esp_err_t matrix_led_get_pixel(uint8_t x, uint8_t y,
     return ret;
   }
 
-  if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-    return ESP_ERR_TIMEOUT;
-  }
-
   uint32_t index = matrix_led_xy_to_index(x, y);
-  *color = s_context.pixel_buffer[index];
+  *color = matrix_led_target_buffer(s_context.draw_layer)[index];
 
-  xSemaphoreGive(s_context.mutex);
   return ESP_OK;
 }
 
@@ -474,19 +642,19 @@ esp_err_t matrix_led_set_pixels(const matrix_led_pixel_t *pixels,
     return ESP_ERR_INVALID_ARG;
   }
 
-  if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-    return ESP_ERR_TIMEOUT;
-  }
-
+  matrix_led_layer_t *layer = s_context.draw_layer;
+  matrix_led_color_t *buffer = matrix_led_target_buffer(layer);
+  uint32_t dirty_rows = 0;
   for (size_t i = 0; i < count; i++) {
     esp_err_t ret = matrix_led_validate_coordinates(pixels[i].x, pixels[i].y);
     if (ret == ESP_OK) {
       uint32_t index = matrix_led_xy_to_index(pixels[i].x, pixels[i].y);
-      s_context.pixel_buffer[index] = pixels[i].color;
+      buffer[index] = pixels[i].color;
+      dirty_rows |= 1u << pixels[i].y;
     }
   }
+  matrix_led_mark_target_rows(layer, dirty_rows);
 
-  xSemaphoreGive(s_context.mutex);
   return ESP_OK;
 }
 
@@ -495,14 +663,11 @@ esp_err_t matrix_led_clear(void) {
     return ESP_ERR_INVALID_STATE;
   }
 
-  if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-    return ESP_ERR_TIMEOUT;
-  }
-
-  memset(s_context.pixel_buffer, 0,
+  matrix_led_layer_t *layer = s_context.draw_layer;
+  memset(matrix_led_target_buffer(layer), 0,
          MATRIX_LED_COUNT * sizeof(matrix_led_color_t));
+  matrix_led_mark_target_rows(layer, MATRIX_LED_ALL_ROWS_DIRTY);
 
-  xSemaphoreGive(s_context.mutex);
   return ESP_OK;
 }
 
@@ -511,56 +676,80 @@ esp_err_t matrix_led_fill(matrix_led_color_t color) {
     return ESP_ERR_INVALID_STATE;
   }
 
-  if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
-    return ESP_ERR_TIMEOUT;
-  }
-
+  matrix_led_layer_t *layer = s_context.draw_layer;
+  matrix_led_color_t *buffer = matrix_led_target_buffer(layer);
   for (uint32_t i = 0; i < MATRIX_LED_COUNT; i++) {
-    s_context.pixel_buffer[i] = color;
+    buffer[i] = color;
   }
+  matrix_led_mark_target_rows(layer, MATRIX_LED_ALL_ROWS_DIRTY);
 
-  xSemaphoreGive(s_context.mutex);
   return ESP_OK;
 }
 
-esp_err_t matrix_led_refresh(void) {
+esp_err_t matrix_led_present(void) {
   if (!s_context.initialized) {
     return ESP_ERR_INVALID_STATE;
   }
 
   if (!s_context.enabled) {
-    return ESP_OK; // 已禁用时不刷新
+    return ESP_OK; // 已禁用时不提交
   }
 
-  if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+  if (xSemaphoreTake(s_context.present_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
     return ESP_ERR_TIMEOUT;
   }
 
-  // 应用亮度和色彩校正并发送到LED
-  for (uint32_t i = 0; i < MATRIX_LED_COUNT; i++) {
-    matrix_led_color_t corrected_color;
-    matrix_led_apply_all_corrections(s_context.pixel_buffer[i],
-                                     s_context.brightness, &corrected_color);
-
-    esp_err_t ret =
-        led_strip_set_pixel(s_context.led_strip, i, corrected_color.r,
-                            corrected_color.g, corrected_color.b);
-    if (ret != ESP_OK) {
-      xSemaphoreGive(s_context.mutex);
-      return ret;
-    }
+  // 有图层时先把各图层的脏行合成到后台缓冲区
+  if (s_context.compositor.count > 0 || s_context.compositor.damage_rows) {
+    matrix_led_mark_dirty_rows(matrix_led_compositor_compose(
+        &s_context.compositor, s_context.pixel_buffer));
   }
 
-  esp_err_t ret = led_strip_refresh(s_context.led_strip);
-  if (ret == ESP_OK) {
-    s_context.frame_count++;
-    s_context.last_refresh_time = xTaskGetTickCount();
+  // 没有绘制且校正参数未变化时无需提交，静态画面不再占用刷新任务
+  uint32_t dirty_rows =
+      __atomic_exchange_n(&s_context.back_dirty_rows, 0, __ATOMIC_ACQ_REL);
+  if (dirty_rows == 0 && !s_context.correction_dirty &&
+      s_context.correction.brightness == s_context.brightness) {
+    s_context.skipped_frames++;
+    xSemaphoreGive(s_context.present_mutex);
+    return ESP_OK;
   }
 
-  xSemaphoreGive(s_context.mutex);
-  return ret;
+  // 记录本帧脏行，刷新任务据此合并被覆盖帧的变化
+  uint32_t seq = s_context.present_seq + 1;
+  s_context.dirty_history[seq & MATRIX_LED_DIRTY_HISTORY_MASK] = dirty_rows;
+  s_context.present_seq = seq;
+
+  // 将后台缓冲区与待显示缓冲区原子交换
+  uint8_t presented = s_context.back_index;
+  s_context.frame_seq[presented] = seq;
+  s_context.present_time_us[presented] = esp_timer_get_time();
+  uint32_t previous =
+      __atomic_exchange_n(&s_context.flip_state,
+                          (uint32_t)presented | MATRIX_LED_FLIP_PENDING,
+                          __ATOMIC_ACQ_REL);
+  if (previous & MATRIX_LED_FLIP_PENDING) {
+    // 上一帧尚未被刷新任务取走就被覆盖
+    s_context.dropped_frames++;
+  }
+
+  // 新的后台缓冲区继承刚提交的内容，保证增量绘制语义不变
+  s_context.back_index = previous & MATRIX_LED_FLIP_INDEX_MASK;
+  memcpy(s_context.framebuffers[s_context.back_index],
+         s_context.framebuffers[presented],
+         MATRIX_LED_COUNT * sizeof(matrix_led_color_t));
+  s_context.pixel_buffer = s_context.framebuffers[s_context.back_index];
+  s_context.presented_frames++;
+
+  xSemaphoreGive(s_context.present_mutex);
+
+  // 唤醒刷新任务
+  xSemaphoreGive(s_context.refresh_semaphore);
+  return ESP_OK;
 }
 
+esp_err_t matrix_led_refresh(void) { return matrix_led_present(); }
+
 // ==================== 图形绘制API实现 ====================
 
 esp_err_t matrix_led_draw_line(uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1,
@@ -678,17 +867,180 @@ esp_err_t matrix_led_draw_circle(uint8_t center_x, uint8_t center_y,
 
 esp_err_t matrix_led_draw_text(uint8_t x, uint8_t y, const char *text,
                                matrix_led_color_t color) {
-  if (!s_context.initialized || text == NULL) {
+  return matrix_led_draw_text_font(x, y, text, NULL, color, NULL);
+}
+
+esp_err_t matrix_led_draw_text_font(int16_t x, int16_t y, const char *text,
+                                    const matrix_led_font_t *font,
+                                    matrix_led_color_t color,
+                                    const matrix_led_rect_t *clip) {
+  if (text == NULL) {
     return ESP_ERR_INVALID_ARG;
   }
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
 
-  // 简单的8x8字体实现（仅支持基本ASCII字符）
-  // 这里简化实现，实际项目中可以使用更完整的字体库
-  ESP_LOGW(TAG, "Text rendering not fully implemented yet");
+  matrix_led_layer_t *layer = s_context.draw_layer;
+  uint32_t dirty_rows =
+      matrix_led_font_draw(matrix_led_target_buffer(layer),
+                           font ? font : &matrix_led_font_5x7, x, y, text,
+                           color, clip);
+  matrix_led_mark_target_rows(layer, dirty_rows);
 
   return ESP_OK;
 }
 
+esp_err_t matrix_led_draw_text_layout(matrix_led_text_t *text) {
+  if (text == NULL || text->font == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  matrix_led_layer_t *layer = s_context.draw_layer;
+  matrix_led_mark_target_rows(
+      layer, matrix_led_text_render(text, matrix_led_target_buffer(layer)));
+
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_scroll_text(matrix_led_text_t *text, uint16_t step) {
+  if (text == NULL || text->font == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  matrix_led_layer_t *layer = s_context.draw_layer;
+  matrix_led_mark_target_rows(
+      layer,
+      matrix_led_text_scroll(text, matrix_led_target_buffer(layer), step));
+
+  return ESP_OK;
+}
+
+// ==================== 图层API实现 ====================
+
+esp_err_t matrix_led_add_layer(const matrix_led_layer_config_t *config,
+                               matrix_led_layer_t **layer) {
+  if (config == NULL || layer == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  // 合成在提交时进行，增删图层与提交串行化
+  if (xSemaphoreTake(s_context.present_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+  esp_err_t ret =
+      matrix_led_compositor_add_layer(&s_context.compositor, config, layer);
+  xSemaphoreGive(s_context.present_mutex);
+
+  if (ret == ESP_OK) {
+    ESP_LOGI(TAG, "Layer added: %ux%u at (%d,%d) z=%d, %u layer(s)",
+             (*layer)->config.width, (*layer)->config.height, config->x,
+             config->y, config->z, s_context.compositor.count);
+  }
+  return ret;
+}
+
+esp_err_t matrix_led_remove_layer(matrix_led_layer_t *layer) {
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (xSemaphoreTake(s_context.present_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+  if (s_context.draw_layer == layer) {
+    s_context.draw_layer = NULL;
+  }
+  if (s_context.animation_layer == layer) {
+    s_context.animation_layer = NULL;
+  }
+  esp_err_t ret =
+      matrix_led_compositor_remove_layer(&s_context.compositor, layer);
+  xSemaphoreGive(s_context.present_mutex);
+
+  return ret;
+}
+
+esp_err_t matrix_led_update_layer(matrix_led_layer_t *layer,
+                                  const matrix_led_layer_config_t *config) {
+  if (config == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (xSemaphoreTake(s_context.present_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+  esp_err_t ret =
+      matrix_led_compositor_update_layer(&s_context.compositor, layer, config);
+  xSemaphoreGive(s_context.present_mutex);
+
+  return ret;
+}
+
+/**
+ * @brief 检查图层可以作为全屏绘制目标（调用方持有提交锁）
+ */
+static esp_err_t matrix_led_check_target_layer(matrix_led_layer_t *layer) {
+  if (layer == NULL) {
+    return ESP_OK;
+  }
+  for (int i = 0; i < s_context.compositor.count; i++) {
+    if (s_context.compositor.layers[i] == layer) {
+      return (layer->config.width == MATRIX_LED_WIDTH &&
+              layer->config.height == MATRIX_LED_HEIGHT)
+                 ? ESP_OK
+                 : ESP_ERR_INVALID_ARG;
+    }
+  }
+  return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t matrix_led_select_layer(matrix_led_layer_t *layer) {
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (xSemaphoreTake(s_context.present_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+  esp_err_t ret = matrix_led_check_target_layer(layer);
+  if (ret == ESP_OK) {
+    s_context.draw_layer = layer;
+  }
+  xSemaphoreGive(s_context.present_mutex);
+
+  return ret;
+}
+
+esp_err_t matrix_led_set_animation_layer(matrix_led_layer_t *layer) {
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (xSemaphoreTake(s_context.present_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+  esp_err_t ret = matrix_led_check_target_layer(layer);
+  if (ret == ESP_OK) {
+    s_context.animation_layer = layer;
+  }
+  xSemaphoreGive(s_context.present_mutex);
+
+  return ret;
+}
+
 // ==================== 亮度控制API实现 ====================
 
 esp_err_t matrix_led_set_brightness(uint8_t brightness) {
@@ -706,6 +1058,7 @@ esp_err_t matrix_led_set_brightness(uint8_t brightness) {
 
   uint8_t old_brightness = s_context.brightness;
   s_context.brightness = brightness;
+  s_context.correction_dirty = true;
 
   // 发送亮度变更事件
   matrix_led_event_data_t event_data = {
@@ -733,6 +1086,11 @@ esp_err_t matrix_led_set_mode(matrix_led_mode_t mode) {
     return ESP_ERR_INVALID_STATE;
   }
 
+  // 流式播放须在取得互斥锁之前停止
+  if (mode != MATRIX_LED_MODE_ANIMATION) {
+    matrix_led_stop_stream_playback();
+  }
+
   if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
     return ESP_ERR_TIMEOUT;
   }
@@ -742,7 +1100,7 @@ esp_err_t matrix_led_set_mode(matrix_led_mode_t mode) {
 
   // 根据模式切换停止或启动动画
   if (mode != MATRIX_LED_MODE_ANIMATION && s_context.animation.is_running) {
-    matrix_led_stop_animation();
+    matrix_led_stop_animation_locked();
   }
 
   // 发送模式变更事件
@@ -773,19 +1131,48 @@ matrix_led_play_animation(matrix_led_animation_type_t animation_type,
     return ESP_ERR_INVALID_ARG;
   }
 
+  return matrix_led_begin_animation(animation_type, config);
+}
+
+/**
+ * @brief 切换到指定动画并唤醒动画任务（内置动画和自定义动画共用）
+ */
+static esp_err_t
+matrix_led_begin_animation(matrix_led_animation_type_t animation_type,
+                           const matrix_led_animation_config_t *config) {
+  // 读取任务独占读取器，必须在回到首帧之前停止旧的流
+  matrix_led_stop_stream_playback();
+
+  matrix_led_stream_t *stream = NULL;
+  if (animation_type == MATRIX_LED_ANIM_CUSTOM) {
+    matrix_led_anim_rewind(s_context.animation.custom_reader);
+    esp_err_t ret =
+        matrix_led_stream_start(s_context.animation.custom_reader, &stream);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to start animation stream: %s",
+               esp_err_to_name(ret));
+      return ret;
+    }
+  }
+
   if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    matrix_led_stream_stop(stream);
     return ESP_ERR_TIMEOUT;
   }
 
-  // 停止当前动画
+  // 停止当前动画（流已在上面停止，这里只清理状态）
   if (s_context.animation.is_running) {
-    matrix_led_stop_animation();
+    matrix_led_stop_animation_locked();
   }
 
   // 设置动画参数
   s_context.animation.type = animation_type;
   s_context.animation.frame_counter = 0;
   s_context.animation.start_time = xTaskGetTickCount();
+  s_context.animation.elapsed_us = 0;
+  s_context.animation.custom_next_us = 0;
+  s_context.animation.custom_starved = false;
+  s_context.animation.custom_stream = stream;
   s_context.animation.is_running = true;
 
   // 使用提供的配置或默认配置
@@ -809,11 +1196,21 @@ matrix_led_play_animation(matrix_led_animation_type_t animation_type,
   // 切换到动画模式
   s_context.mode = MATRIX_LED_MODE_ANIMATION;
 
-  // 启动动画定时器
-  xTimerChangePeriod(s_context.animation_timer,
-                     pdMS_TO_TICKS(s_context.animation.config.frame_delay_ms),
-                     0);
-  xTimerStart(s_context.animation_timer, 0);
+  // 帧间延迟决定目标帧率，为0时沿用当前帧率
+  uint16_t frame_delay_ms = s_context.animation.config.frame_delay_ms;
+  if (frame_delay_ms > 0) {
+    uint32_t fps = 1000 / frame_delay_ms;
+    if (fps < 1) {
+      fps = 1;
+    } else if (fps > MATRIX_LED_MAX_FPS) {
+      fps = MATRIX_LED_MAX_FPS;
+    }
+    s_context.target_fps = (uint8_t)fps;
+  }
+
+  // 唤醒动画任务，从当前时刻开始建立帧截止时间
+  s_context.schedule_reset = true;
+  xSemaphoreGive(s_context.animation_semaphore);
 
   // 发送动画开始事件
   matrix_led_event_data_t event_data = {
@@ -840,13 +1237,27 @@ esp_err_t matrix_led_stop_animation(void) {
     return ESP_ERR_INVALID_STATE;
   }
 
+  matrix_led_stop_stream_playback();
+
   if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
     return ESP_ERR_TIMEOUT;
   }
 
-  // 停止动画定时器
-  xTimerStop(s_context.animation_timer, 0);
+  if (s_context.animation.is_running) {
+    matrix_led_stop_animation_locked();
+  }
+
+  xSemaphoreGive(s_context.mutex);
+
+  return ESP_OK;
+}
 
+/**
+ * @brief 清空动画状态并发送停止事件
+ *
+ * 调用者须持有 s_context.mutex，并已停止流式播放。
+ */
+static void matrix_led_stop_animation_locked(void) {
   char animation_name[MATRIX_LED_MAX_NAME_LEN];
   strncpy(animation_name, s_context.animation.config.name,
           sizeof(animation_name));
@@ -865,35 +1276,147 @@ esp_err_t matrix_led_stop_animation(void) {
           MATRIX_LED_MAX_NAME_LEN - 1);
   matrix_led_send_event(MATRIX_LED_EVENT_ANIMATION_STOPPED, &event_data);
 
-  xSemaphoreGive(s_context.mutex);
-
   ESP_LOGI(TAG, "Animation stopped: %s", animation_name);
-
-  return ESP_OK;
 }
 
 esp_err_t matrix_led_load_animation_from_file(const char *filename,
                                               const char *animation_name) {
-  if (!s_context.initialized || filename == NULL || animation_name == NULL) {
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (filename == NULL) {
     return ESP_ERR_INVALID_ARG;
   }
 
-  // TODO: 实现从文件加载动画的功能
-  ESP_LOGW(TAG, "Load animation from file not implemented yet: %s", filename);
+  // 读取器只保留一帧大小以内的缓冲，内存占用与动画长度无关
+  matrix_led_anim_reader_t *reader = malloc(sizeof(matrix_led_anim_reader_t));
+  if (reader == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+
+  esp_err_t ret = matrix_led_anim_open(reader, filename);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to open animation file %s: %s", filename,
+             esp_err_to_name(ret));
+    free(reader);
+    return ret;
+  }
+
+  ret = matrix_led_anim_select(reader, animation_name);
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "Animation '%s' not found in %s",
+             animation_name ? animation_name : "(first)", filename);
+    matrix_led_anim_close(reader);
+    free(reader);
+    return ret;
+  }
+
+  // 旧读取器即将释放，先停止正在读取它的预取任务
+  matrix_led_stop_stream_playback();
+
+  if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    matrix_led_anim_close(reader);
+    free(reader);
+    return ESP_ERR_TIMEOUT;
+  }
+
+  // 正在播放旧的自定义动画时先停止，动画任务解码时持有互斥锁
+  if (s_context.animation.type == MATRIX_LED_ANIM_CUSTOM) {
+    s_context.animation.is_running = false;
+  }
+  matrix_led_anim_reader_t *old_reader = s_context.animation.custom_reader;
+  s_context.animation.custom_reader = reader;
+
+  xSemaphoreGive(s_context.mutex);
+
+  if (old_reader != NULL) {
+    matrix_led_anim_close(old_reader);
+    free(old_reader);
+  }
 
-  return ESP_ERR_NOT_SUPPORTED;
+  ESP_LOGI(TAG, "Animation '%s' loaded from %s (%u frames, %u ms)",
+           reader->info.name, filename, reader->info.frame_count,
+           reader->info.frame_delay_ms);
+  return ESP_OK;
 }
 
 esp_err_t matrix_led_play_custom_animation(const char *animation_name) {
-  if (!s_context.initialized || animation_name == NULL) {
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  const matrix_led_anim_reader_t *reader = s_context.animation.custom_reader;
+  if (reader == NULL ||
+      (animation_name != NULL && strcmp(reader->info.name, animation_name))) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  matrix_led_animation_config_t config = {0};
+  strncpy(config.name, reader->info.name, MATRIX_LED_MAX_NAME_LEN - 1);
+  config.type = MATRIX_LED_ANIM_CUSTOM;
+  config.frame_delay_ms = reader->info.frame_delay_ms;
+  config.loop = reader->info.loop;
+  config.speed = 50;
+
+  return matrix_led_begin_animation(MATRIX_LED_ANIM_CUSTOM, &config);
+}
+
+esp_err_t matrix_led_set_target_fps(uint8_t fps) {
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (fps == 0 || fps > MATRIX_LED_MAX_FPS) {
     return ESP_ERR_INVALID_ARG;
   }
 
-  // TODO: 实现播放自定义动画的功能
-  ESP_LOGW(TAG, "Play custom animation not implemented yet: %s",
-           animation_name);
+  s_context.target_fps = fps;
+  s_context.schedule_reset = true;
 
-  return ESP_ERR_NOT_SUPPORTED;
+  ESP_LOGI(TAG, "Target frame rate set to %d fps", fps);
+  return ESP_OK;
+}
+
+uint8_t matrix_led_get_target_fps(void) {
+  return s_context.initialized ? s_context.target_fps : 0;
+}
+
+esp_err_t matrix_led_get_timing_stats(matrix_led_timing_stats_t *stats) {
+  if (!s_context.initialized || stats == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // 直方图由动画任务和刷新任务单独写入，这里读取快照即可
+  matrix_led_histogram_t render = s_context.render_hist;
+  matrix_led_histogram_t transmit = s_context.transmit_hist;
+
+  stats->target_fps = s_context.target_fps;
+  stats->rendered_frames = s_context.rendered_frames;
+  stats->missed_frames = s_context.missed_frames;
+  stats->render_samples = render.count;
+  stats->render_p50_us = matrix_led_histogram_percentile(&render, 50);
+  stats->render_p99_us = matrix_led_histogram_percentile(&render, 99);
+  stats->render_max_us = render.max_us;
+  stats->transmit_samples = transmit.count;
+  stats->transmit_p50_us = matrix_led_histogram_percentile(&transmit, 50);
+  stats->transmit_p99_us = matrix_led_histogram_percentile(&transmit, 99);
+  stats->transmit_max_us = transmit.max_us;
+
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_reset_timing_stats(void) {
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  matrix_led_histogram_reset(&s_context.render_hist);
+  matrix_led_histogram_reset(&s_context.transmit_hist);
+  s_context.rendered_frames = 0;
+  s_context.missed_frames = 0;
+
+  return ESP_OK;
 }
 
 // ==================== 特效API实现 ====================
@@ -1020,45 +1543,12 @@ esp_err_t matrix_led_hsv_to_rgb(matrix_led_hsv_t hsv, matrix_led_color_t *rgb) {
     return ESP_ERR_INVALID_ARG;
   }
 
-  float h = hsv.h;
-  float s = hsv.s / 100.0f;
-  float v = hsv.v / 100.0f;
-
-  float c = v * s;
-  float x = c * (1 - fabsf(fmodf(h / 60.0f, 2) - 1));
-  float m = v - c;
-
-  float r, g, b;
-
-  if (h >= 0 && h < 60) {
-    r = c;
-    g = x;
-    b = 0;
-  } else if (h >= 60 && h < 120) {
-    r = x;
-    g = c;
-    b = 0;
-  } else if (h >= 120 && h < 180) {
-    r = 0;
-    g = c;
-    b = x;
-  } else if (h >= 180 && h < 240) {
-    r = 0;
-    g = x;
-    b = c;
-  } else if (h >= 240 && h < 300) {
-    r = x;
-    g = 0;
-    b = c;
-  } else {
-    r = c;
-    g = 0;
-    b = x;
-  }
-
-  rgb->r = (uint8_t)((r + m) * 255);
-  rgb->g = (uint8_t)((g + m) * 255);
-  rgb->b = (uint8_t)((b + m) * 255);
+  led_kernel_rgb_t c = led_kernel_hsv_to_rgb(
+      LED_KERNEL_DEGREES(hsv.h % 360), led_kernel_percent_to_u8(hsv.s),
+      led_kernel_percent_to_u8(hsv.v));
+  rgb->r = c.r;
+  rgb->g = c.g;
+  rgb->b = c.b;
 
   return ESP_OK;
 }
@@ -1093,52 +1583,44 @@ esp_err_t matrix_led_apply_brightness(matrix_led_color_t color,
 }
 
 /**
- * @brief 应用亮度和色彩校正
+ * @brief 重建融合校正查找表（仅在刷新任务中调用）
  */
-static esp_err_t matrix_led_apply_all_corrections(matrix_led_color_t color,
-                                                  uint8_t brightness,
-                                                  matrix_led_color_t *result) {
-  if (result == NULL || brightness > 100) {
-    return ESP_ERR_INVALID_ARG;
-  }
-
-  // 第一步：应用亮度调整
-  matrix_led_color_t brightness_adjusted;
-  esp_err_t ret =
-      matrix_led_apply_brightness(color, brightness, &brightness_adjusted);
-  if (ret != ESP_OK) {
-    return ret;
-  }
-
-  // 第二步：应用色彩校正（如果已初始化并启用）
-  if (color_correction_is_enabled()) {
-    // 将matrix_led_color_t转换为color_rgb_t
-    color_rgb_t input = {.r = brightness_adjusted.r,
-                         .g = brightness_adjusted.g,
-                         .b = brightness_adjusted.b};
-
-    color_rgb_t output;
-    ret = color_correction_apply_pixel(&input, &output);
-    if (ret == ESP_OK) {
-      result->r = output.r;
-      result->g = output.g;
-      result->b = output.b;
-    } else {
-      // 如果色彩校正失败，使用亮度调整后的结果
-      *result = brightness_adjusted;
-    }
-  } else {
-    // 色彩校正未启用，只使用亮度调整结果
-    *result = brightness_adjusted;
-  }
-
-  return ESP_OK;
+static void matrix_led_rebuild_correction(void) {
+  matrix_led_correction_params_t params = {
+      .brightness = s_context.brightness,
+      .enabled = false,
+  };
+
+  color_correction_config_t cc_config;
+  if (color_correction_get_config(&cc_config) == ESP_OK) {
+    params.enabled = cc_config.enabled;
+    params.white_point_enabled = cc_config.white_point.enabled;
+    params.red_scale = cc_config.white_point.red_scale;
+    params.green_scale = cc_config.white_point.green_scale;
+    params.blue_scale = cc_config.white_point.blue_scale;
+    params.gamma_enabled = cc_config.gamma.enabled;
+    params.gamma = cc_config.gamma.gamma;
+    params.lightness_enabled = cc_config.brightness.enabled;
+    params.lightness_factor = cc_config.brightness.factor;
+    params.saturation_enabled = cc_config.saturation.enabled;
+    params.saturation_factor = cc_config.saturation.factor;
+  }
+
+  s_context.correction_dirty = false;
+  matrix_led_correction_build(&s_context.correction, &params);
+
+  ESP_LOGD(TAG, "Correction LUT rebuilt (brightness: %d%%, generation: %lu)",
+           s_context.brightness,
+           (unsigned long)s_context.correction.generation);
 }
 
 /**
  * @brief 色彩校正配置改变时的回调函数
  */
 static void matrix_led_color_correction_changed(void) {
+  // 标记查找表失效，下一次刷新时重建
+  s_context.correction_dirty = true;
+
   if (s_context.initialized && s_context.enabled) {
     ESP_LOGI(TAG, "Color correction changed, refreshing LED matrix");
     matrix_led_refresh();
@@ -1378,6 +1860,7 @@ esp_err_t matrix_led_load_config(void) {
           MATRIX_LED_CONFIG_NAMESPACE, MATRIX_LED_CONFIG_KEY_STATIC_DATA,
           CONFIG_TYPE_BLOB, s_context.pixel_buffer, &static_data_size);
       if (ret == ESP_OK) {
+        matrix_led_mark_dirty_rows(MATRIX_LED_ALL_ROWS_DIRTY);
         matrix_led_refresh();
         ESP_LOGI(TAG, "Static LED content restored (%zu bytes)",
                  static_data_size);
@@ -1434,61 +1917,60 @@ esp_err_t matrix_led_reset_config(void) {
 static esp_err_t matrix_led_init_hardware(void) {
   ESP_LOGI(TAG, "Initializing LED strip hardware...");
 
-  // LED条带配置
-  led_strip_config_t strip_config = {.strip_gpio_num = MATRIX_LED_GPIO,
-                                     .max_leds = MATRIX_LED_COUNT,
-                                     .led_pixel_format = LED_PIXEL_FORMAT_GRB,
-                                     .led_model = LED_MODEL_WS2812,
-                                     .flags = {
-                                         .invert_out = false,
-                                     }};
-
-  // RMT后端配置 - Matrix LED需要更多资源用于1024个LED
-  led_strip_rmt_config_t rmt_config = {
-      .clk_src = RMT_CLK_SRC_DEFAULT,
-      .resolution_hz = MATRIX_LED_RMT_RESOLUTION,
-      .mem_block_symbols = 96, // 为Matrix LED分配更多内存(2个通道的内存)
-      .flags = {
-          .with_dma = true, // 使用DMA提高性能
-      }};
-
-  esp_err_t ret = led_strip_new_rmt_device(&strip_config, &rmt_config,
-                                           &s_context.led_strip);
+  esp_err_t ret = matrix_led_output_new_rmt(
+      MATRIX_LED_GPIO, MATRIX_LED_RMT_RESOLUTION, &s_context.rmt_output);
   if (ret != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to create LED strip: %s", esp_err_to_name(ret));
-    ESP_LOGE(
-        TAG,
-        "This may be due to RMT resource conflicts with other LED components");
-    ESP_LOGE(TAG,
-             "Try adjusting initialization order or RMT channel allocation");
-    return ret;
-  }
-
-  // 清空LED条带
-  ret = led_strip_clear(s_context.led_strip);
-  if (ret != ESP_OK) {
-    ESP_LOGE(TAG, "Failed to clear LED strip: %s", esp_err_to_name(ret));
-    led_strip_del(s_context.led_strip);
-    s_context.led_strip = NULL;
     return ret;
   }
+  s_context.output = s_context.rmt_output;
+  s_context.sent_output = s_context.rmt_output;
 
   ESP_LOGI(TAG, "LED strip hardware initialized successfully");
   return ESP_OK;
 }
 
 static esp_err_t matrix_led_deinit_hardware(void) {
-  if (s_context.led_strip) {
-    led_strip_clear(s_context.led_strip);
-    led_strip_refresh(s_context.led_strip);
-    led_strip_del(s_context.led_strip);
-    s_context.led_strip = NULL;
+  s_context.output = NULL;
+  if (s_context.rmt_output) {
+    matrix_led_output_del(s_context.rmt_output);
+    s_context.rmt_output = NULL;
   }
 
   ESP_LOGI(TAG, "LED strip hardware deinitialized");
   return ESP_OK;
 }
 
+esp_err_t matrix_led_set_output(matrix_led_output_t *output) {
+  if (!s_context.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (output == NULL) {
+    output = s_context.rmt_output;
+  }
+
+  if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+
+  // 先发布新后端再等待发送空闲：与刷新任务置位 transmitting 后读取后端
+  // 构成一对顺序一致的访问，等待结束后旧后端不会再被访问
+  __atomic_store_n(&s_context.output, output, __ATOMIC_SEQ_CST);
+  bool idle = matrix_led_wait_transmit_idle();
+
+  xSemaphoreGive(s_context.mutex);
+
+  // 刷新任务发现后端变化时清空新后端并整帧重发，静态画面也要重新提交
+  ESP_LOGI(TAG, "Output backend: %s", output->name);
+  matrix_led_mark_dirty_rows(MATRIX_LED_ALL_ROWS_DIRTY);
+  matrix_led_refresh();
+  return idle ? ESP_OK : ESP_ERR_TIMEOUT;
+}
+
+matrix_led_output_t *matrix_led_get_output(void) {
+  return __atomic_load_n(&s_context.output, __ATOMIC_ACQUIRE);
+}
+
 static void matrix_led_animation_task(void *pvParameters) {
   ESP_LOGI(TAG, "Matrix LED animation task started");
 
@@ -1497,53 +1979,269 @@ static void matrix_led_animation_task(void *pvParameters) {
     vTaskDelay(pdMS_TO_TICKS(10));
   }
 
+  const uint32_t tick_us = portTICK_PERIOD_MS * 1000;
+  TickType_t base_tick = 0;     // 调度基准时刻（第0帧的截止时间）
+  TickType_t last_wake = 0;     // 上一次唤醒的绝对时刻
+  uint32_t frame_index = 0;     // 相对调度基准的帧序号
+  uint32_t frame_period_us = 0; // 固定帧步长
+
+  while (s_context.initialized && !s_context.animation_task_exit) {
+    if (!s_context.animation.is_running || !s_context.enabled) {
+      // 没有动画时阻塞等待，由 matrix_led_start_animation 唤醒
+      xSemaphoreTake(s_context.animation_semaphore, pdMS_TO_TICKS(1000));
+      s_context.schedule_reset = true;
+      continue;
+    }
+
+    if (s_context.schedule_reset) {
+      s_context.schedule_reset = false;
+      frame_period_us = 1000000 / s_context.target_fps;
+      base_tick = xTaskGetTickCount();
+      last_wake = base_tick;
+      frame_index = 0;
+    }
+
+    // 渲染当前帧并提交到刷新任务，下一帧的绘制与本帧的发送重叠
+    int64_t render_start = esp_timer_get_time();
+    matrix_led_render_animation_frame();
+    matrix_led_present();
+    matrix_led_histogram_record(
+        &s_context.render_hist,
+        (uint32_t)(esp_timer_get_time() - render_start));
+    s_context.rendered_frames++;
+
+    // 按绝对截止时间推进；过载时跳过已经错过的帧，而不是逐帧追赶
+    TickType_t now = xTaskGetTickCount();
+    uint32_t next = frame_index + 1;
+    uint32_t due =
+        (uint32_t)((uint64_t)(now - base_tick) * tick_us / frame_period_us);
+    if (due > next) {
+      s_context.missed_frames += due - next;
+      next = due;
+    }
+
+    s_context.animation.elapsed_us +=
+        (uint64_t)(next - frame_index) * frame_period_us;
+    s_context.animation.frame_counter += next - frame_index;
+    frame_index = next;
+
+    TickType_t deadline =
+        base_tick + (TickType_t)((uint64_t)frame_index * frame_period_us /
+                                 tick_us);
+    if (deadline != last_wake) {
+      xTaskDelayUntil(&last_wake, deadline - last_wake);
+    } else {
+      // 帧周期短于一个tick时至少让出一次CPU
+      taskYIELD();
+    }
+  }
+
+  ESP_LOGI(TAG, "Matrix LED animation task ended");
+  xSemaphoreGive(s_context.animation_task_done);
+  vTaskDelete(NULL);
+}
+
+/**
+ * @brief 绘制当前动画帧到后台缓冲区
+ */
+static void matrix_led_render_animation_frame(void) {
+  // 绘制期间持有提交锁，动画目标图层不会被删除，后台缓冲区也不会被翻页
+  if (xSemaphoreTake(s_context.present_mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    return;
+  }
+
+  if (s_context.animation.type == MATRIX_LED_ANIM_CUSTOM) {
+    matrix_led_animate_custom();
+  } else {
+    matrix_led_layer_t *layer = s_context.animation_layer;
+    uint32_t dirty_rows = 0;
+    if (matrix_led_render_builtin(
+            s_context.animation.type, &s_context.animation.config,
+            s_context.animation.elapsed_us, matrix_led_target_buffer(layer),
+            &dirty_rows) == ESP_OK) {
+      matrix_led_mark_target_rows(layer, dirty_rows);
+    }
+  }
+
+  xSemaphoreGive(s_context.present_mutex);
+}
+
+static void matrix_led_refresh_task(void *pvParameters) {
+  ESP_LOGI(TAG, "Matrix LED refresh task started");
+
+  // 等待初始化完成
+  while (!s_context.initialized) {
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+
   while (s_context.initialized) {
-    // 等待动画信号量或超时
-    if (xSemaphoreTake(s_context.animation_semaphore, pdMS_TO_TICKS(1000)) ==
+    if (xSemaphoreTake(s_context.refresh_semaphore, pdMS_TO_TICKS(1000)) ==
         pdTRUE) {
-      // 执行动画更新
-      if (s_context.animation.is_running && s_context.enabled) {
-        switch (s_context.animation.type) {
-        case MATRIX_LED_ANIM_RAINBOW:
-          matrix_led_animate_rainbow();
-          break;
-        case MATRIX_LED_ANIM_WAVE:
-          matrix_led_animate_wave();
-          break;
-        case MATRIX_LED_ANIM_BREATHE:
-          matrix_led_animate_breathe();
-          break;
-        case MATRIX_LED_ANIM_ROTATE:
-          matrix_led_animate_rotate();
-          break;
-        case MATRIX_LED_ANIM_FADE:
-          matrix_led_animate_fade();
-          break;
-        default:
-          break;
-        }
+      esp_err_t ret = matrix_led_transmit_pending_frame();
+      if (ret != ESP_OK) {
+        ESP_LOGW(TAG, "Frame transmit failed: %s", esp_err_to_name(ret));
+      }
+    }
+  }
 
-        // 刷新显示
-        matrix_led_refresh();
+  ESP_LOGI(TAG, "Matrix LED refresh task ended");
+  vTaskDelete(NULL);
+}
 
-        s_context.animation.frame_counter++;
-      }
+/**
+ * @brief 标记后台缓冲区中被修改的行
+ */
+static inline void matrix_led_mark_dirty_rows(uint32_t rows) {
+  if (rows != 0) {
+    __atomic_fetch_or(&s_context.back_dirty_rows, rows, __ATOMIC_RELAXED);
+  }
+}
+
+/**
+ * @brief 绘制目标的像素缓冲区（图层为NULL时是后台缓冲区）
+ */
+static inline matrix_led_color_t *
+matrix_led_target_buffer(matrix_led_layer_t *layer) {
+  return layer ? layer->pixels : s_context.pixel_buffer;
+}
+
+/**
+ * @brief 标记绘制目标中被修改的行
+ */
+static inline void matrix_led_mark_target_rows(matrix_led_layer_t *layer,
+                                               uint32_t rows) {
+  if (layer != NULL) {
+    matrix_led_layer_mark_dirty(layer, rows);
+  } else {
+    matrix_led_mark_dirty_rows(rows);
+  }
+}
+
+/**
+ * @brief 计算自上次发送以来需要重新校正的行（仅在刷新任务中调用）
+ *
+ * 被覆盖（未发送）的帧的脏行需要合并进来；历史记录不足以覆盖
+ * 这段区间，或查找表刚刚重建时，整帧都视为脏。
+ */
+static uint32_t matrix_led_collect_dirty_rows(uint32_t seq, bool force_all) {
+  uint32_t last = s_context.sent_seq;
+  s_context.sent_seq = seq;
+
+  if (force_all || seq - last >= MATRIX_LED_DIRTY_HISTORY) {
+    return MATRIX_LED_ALL_ROWS_DIRTY;
+  }
+
+  uint32_t rows = 0;
+  for (uint32_t s = last + 1; s != seq + 1; s++) {
+    rows |= s_context.dirty_history[s & MATRIX_LED_DIRTY_HISTORY_MASK];
+  }
+
+  // 读取期间生产者可能已经绕回并覆盖了历史记录
+  uint32_t newest = __atomic_load_n(&s_context.present_seq, __ATOMIC_ACQUIRE);
+  if (newest - last >= MATRIX_LED_DIRTY_HISTORY) {
+    return MATRIX_LED_ALL_ROWS_DIRTY;
+  }
+  return rows;
+}
+
+/**
+ * @brief 取走待显示帧并发送到LED（仅在刷新任务中调用）
+ */
+static esp_err_t matrix_led_transmit_pending_frame(void) {
+  uint32_t state = __atomic_load_n(&s_context.flip_state, __ATOMIC_ACQUIRE);
+  if (!(state & MATRIX_LED_FLIP_PENDING)) {
+    return ESP_OK; // 没有新帧
+  }
+
+  // 将前台缓冲区与待显示缓冲区原子交换
+  state = __atomic_exchange_n(&s_context.flip_state,
+                              (uint32_t)s_context.front_index,
+                              __ATOMIC_ACQ_REL);
+  s_context.front_index = state & MATRIX_LED_FLIP_INDEX_MASK;
+  const matrix_led_color_t *frame =
+      s_context.framebuffers[s_context.front_index];
+
+  if (esp_timer_get_time() - s_context.present_time_us[s_context.front_index] >
+      MATRIX_LED_LATE_FRAME_US) {
+    s_context.late_frames++;
+  }
+
+  if (!s_context.enabled) {
+    return ESP_OK;
+  }
+
+  __atomic_store_n(&s_context.transmitting, true, __ATOMIC_SEQ_CST);
+  int64_t transmit_start = esp_timer_get_time();
+
+  // 亮度或色彩校正配置变化后才重建查找表
+  bool rebuilt = false;
+  if (s_context.correction_dirty ||
+      s_context.correction.brightness != s_context.brightness) {
+    matrix_led_rebuild_correction();
+    rebuilt = true;
+  }
+
+  // 切换后端后新设备从全黑开始，整帧重新校正并发送
+  matrix_led_output_t *output =
+      __atomic_load_n(&s_context.output, __ATOMIC_SEQ_CST);
+  if (output != s_context.sent_output) {
+    s_context.sent_output = output;
+    output->clear(output);
+    memset(s_context.sent_buffer, 0,
+           MATRIX_LED_COUNT * sizeof(matrix_led_color_t));
+    rebuilt = true;
+  }
+
+  // 只对脏行重新校正，并且只把与上次发送结果不同的像素写入后端
+  uint32_t dirty_rows = matrix_led_collect_dirty_rows(
+      s_context.frame_seq[s_context.front_index], rebuilt);
+  matrix_led_output_stats_t stats = {0};
+  bool changed = false;
+  esp_err_t ret = matrix_led_output_write_frame(
+      output, &s_context.correction, frame, s_context.sent_buffer, dirty_rows,
+      &stats, &changed);
+  s_context.corrected_pixels += stats.corrected_pixels;
+  if (ret != ESP_OK) {
+    __atomic_store_n(&s_context.transmitting, false, __ATOMIC_RELEASE);
+    return ret;
+  }
+
+  if (!changed) {
+    // 与上次发送的内容完全相同，不占用输出总线
+    s_context.skipped_frames++;
+    __atomic_store_n(&s_context.transmitting, false, __ATOMIC_RELEASE);
+    return ESP_OK;
+  }
+
+  ret = output->refresh(output);
+  if (ret == ESP_OK) {
+    s_context.frame_count++;
+    s_context.last_refresh_time = xTaskGetTickCount();
+    matrix_led_histogram_record(
+        &s_context.transmit_hist,
+        (uint32_t)(esp_timer_get_time() - transmit_start));
+  }
+
+  __atomic_store_n(&s_context.transmitting, false, __ATOMIC_RELEASE);
+  return ret;
+}
+
+/**
+ * @brief 等待刷新任务完成当前帧发送
+ *
+ * @return 超时返回false
+ */
+static bool matrix_led_wait_transmit_idle(void) {
+  for (int i = 0; i < 100; i++) {
+    uint32_t state = __atomic_load_n(&s_context.flip_state, __ATOMIC_ACQUIRE);
+    if (!__atomic_load_n(&s_context.transmitting, __ATOMIC_SEQ_CST) &&
+        !(state & MATRIX_LED_FLIP_PENDING)) {
+      return true;
     }
-
-    // 休眠一段时间
     vTaskDelay(pdMS_TO_TICKS(1));
   }
-
-  ESP_LOGI(TAG, "Matrix LED animation task ended");
-  vTaskDelete(NULL);
-}
-
-static void matrix_led_animation_timer_callback(TimerHandle_t xTimer) {
-  // 发送动画信号量触发动画更新
-  BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-  xSemaphoreGiveFromISR(s_context.animation_semaphore,
-                        &xHigherPriorityTaskWoken);
-  portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+  ESP_LOGW(TAG, "Timed out waiting for frame transmit to finish");
+  return false;
 }
 
 static esp_err_t __attribute__((unused)) matrix_led_load_default_config(void) {
@@ -1604,101 +2302,69 @@ static esp_err_t matrix_led_send_event(matrix_led_event_type_t type,
 
 // ==================== 动画函数实现 ====================
 
-static void matrix_led_animate_rainbow(void) {
-  uint32_t time_offset =
-      (xTaskGetTickCount() - s_context.animation.start_time) *
-      s_context.animation.config.speed / 10;
-
-  for (uint8_t y = 0; y < MATRIX_LED_HEIGHT; y++) {
-    for (uint8_t x = 0; x < MATRIX_LED_WIDTH; x++) {
-      uint16_t hue = ((x + y) * 360 / (MATRIX_LED_WIDTH + MATRIX_LED_HEIGHT) +
-                      time_offset) %
-                     360;
-      matrix_led_hsv_t hsv = {hue, 100, 100};
-      matrix_led_color_t rgb;
-
-      if (matrix_led_hsv_to_rgb(hsv, &rgb) == ESP_OK) {
-        uint32_t index = matrix_led_xy_to_index(x, y);
-        s_context.pixel_buffer[index] = rgb;
-      }
-    }
+/**
+ * @brief 从预取流中解码到期的帧
+ *
+ * 增量帧直接在后台缓冲区上更新（提交时新的后台缓冲区继承上一帧内容），
+ * 动画时钟落后时连续解码多帧以保持节奏。缓冲区为空时不推进帧时刻，
+ * 读取任务追上后立即补齐，每次连续欠载计为一次。
+ */
+static void matrix_led_animate_custom(void) {
+  // 加载新动画时持有互斥锁，此时跳过本帧
+  if (xSemaphoreTake(s_context.mutex, 0) != pdTRUE) {
+    return;
   }
-}
-
-static void matrix_led_animate_wave(void) {
-  uint32_t time_offset =
-      (xTaskGetTickCount() - s_context.animation.start_time) *
-      s_context.animation.config.speed / 20;
-
-  matrix_led_color_t primary = s_context.animation.config.primary_color;
-  matrix_led_color_t secondary = s_context.animation.config.secondary_color;
-
-  for (uint8_t y = 0; y < MATRIX_LED_HEIGHT; y++) {
-    for (uint8_t x = 0; x < MATRIX_LED_WIDTH; x++) {
-      float wave = sinf((x + time_offset) * 0.2f) * 0.5f + 0.5f;
-      matrix_led_color_t result;
 
-      if (matrix_led_color_interpolate(secondary, primary, wave, &result) ==
-          ESP_OK) {
-        uint32_t index = matrix_led_xy_to_index(x, y);
-        s_context.pixel_buffer[index] = result;
+  bool finished = false;
+  matrix_led_layer_t *layer = s_context.animation_layer;
+  matrix_led_stream_t *stream = s_context.animation.custom_stream;
+  while (stream != NULL && s_context.animation.is_running &&
+         s_context.animation.elapsed_us >= s_context.animation.custom_next_us) {
+    uint16_t delay_ms = 0;
+    uint32_t dirty_rows = 0;
+    esp_err_t ret = matrix_led_stream_next_frame(
+        stream, matrix_led_target_buffer(layer), &delay_ms, &dirty_rows);
+    if (ret == ESP_ERR_TIMEOUT) {
+      if (!s_context.animation.custom_starved) {
+        s_context.animation.custom_starved = true;
+        s_context.stream_underruns++;
       }
+      break;
+    }
+    if (ret != ESP_OK) {
+      if (ret != ESP_ERR_NOT_FOUND) {
+        ESP_LOGE(TAG, "Failed to decode frame of '%s'",
+                 s_context.animation.config.name);
+      }
+      finished = true;
+      break;
     }
-  }
-}
-
-static void matrix_led_animate_breathe(void) {
-  uint32_t time_offset =
-      (xTaskGetTickCount() - s_context.animation.start_time) *
-      s_context.animation.config.speed / 50;
-  float breathe = (sinf(time_offset * 0.1f) + 1.0f) / 2.0f;
-
-  matrix_led_color_t base_color = s_context.animation.config.primary_color;
-  matrix_led_color_t result;
 
-  if (matrix_led_apply_brightness(base_color, (uint8_t)(breathe * 100),
-                                  &result) == ESP_OK) {
-    matrix_led_fill(result);
+    s_context.animation.custom_starved = false;
+    matrix_led_mark_target_rows(layer, dirty_rows);
+    s_context.animation.custom_next_us += (uint64_t)(delay_ms ? delay_ms : 1) *
+                                          1000;
   }
-}
-
-static void matrix_led_animate_rotate(void) {
-  // 简单的旋转动画实现
-  uint32_t time_offset =
-      (xTaskGetTickCount() - s_context.animation.start_time) *
-      s_context.animation.config.speed / 30;
-
-  matrix_led_clear();
-
-  uint8_t center_x = MATRIX_LED_WIDTH / 2;
-  uint8_t center_y = MATRIX_LED_HEIGHT / 2;
-  uint8_t radius = 12;
 
-  for (int i = 0; i < 4; i++) {
-    float angle = (time_offset + i * 90) * M_PI / 180.0f;
-    uint8_t x = center_x + (uint8_t)(cosf(angle) * radius);
-    uint8_t y = center_y + (uint8_t)(sinf(angle) * radius);
+  xSemaphoreGive(s_context.mutex);
 
-    if (x < MATRIX_LED_WIDTH && y < MATRIX_LED_HEIGHT) {
-      matrix_led_draw_pixel_safe(x, y,
-                                 s_context.animation.config.primary_color);
-    }
+  // 非循环动画停在最后一帧
+  if (finished) {
+    matrix_led_stop_animation();
   }
 }
 
-static void matrix_led_animate_fade(void) {
-  uint32_t time_offset =
-      (xTaskGetTickCount() - s_context.animation.start_time) *
-      s_context.animation.config.speed / 40;
-  float fade = (sinf(time_offset * 0.05f) + 1.0f) / 2.0f;
-
-  matrix_led_color_t color1 = s_context.animation.config.primary_color;
-  matrix_led_color_t color2 = s_context.animation.config.secondary_color;
-  matrix_led_color_t result;
-
-  if (matrix_led_color_interpolate(color1, color2, fade, &result) == ESP_OK) {
-    matrix_led_fill(result);
-  }
+/**
+ * @brief 停止预取流（不能在持有互斥锁时调用，会等待读取任务退出）
+ */
+static void matrix_led_stop_stream_playback(void) {
+  matrix_led_stream_t *stream = NULL;
+  if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) == pdTRUE) {
+    stream = s_context.animation.custom_stream;
+    s_context.animation.custom_stream = NULL;
+    xSemaphoreGive(s_context.mutex);
+  }
+  matrix_led_stream_stop(stream);
 }
 
 // ==================== 图形绘制辅助函数 ====================
@@ -1762,6 +2428,8 @@ int matrix_led_cmd_handler(int argc, char **argv) {
     printf("  led matrix anim <type> [speed]       - Play animation\n");
     printf("    Types: rainbow, wave, breathe, rotate, fade\n");
     printf("  led matrix stop                      - Stop animation\n");
+    printf("  led matrix fps [1-100]               - Show/set target fps\n");
+    printf("  led matrix timing [reset]            - Frame timing stats\n");
     printf("Drawing Commands:\n");
     printf(
         "  led matrix draw line <x0> <y0> <x1> <y1> <r> <g> <b> - Draw line\n");
@@ -1769,11 +2437,14 @@ int matrix_led_cmd_handler(int argc, char **argv) {
            "rectangle\n");
     printf("  led matrix draw circle <x> <y> <radius> <r> <g> <b> [fill] - "
            "Draw circle\n");
+    printf("  led matrix text <x> <y> <text> [r g b] [5x7|8x8] - Draw text\n");
+    printf("  led matrix layers                    - List compositor layers\n");
     printf("Configuration:\n");
     printf("  led matrix config <save|load|reset|export|import> - Config "
            "management\n");
     printf("Storage Features:\n");
-    printf("  led matrix image <export|import> <filepath> - Image save/load\n");
+    printf("  led matrix image <export|import|list|convert> <filepath> - "
+           "Image save/load\n");
     printf("  led matrix storage status             - Check storage "
            "availability\n");
     printf("  led matrix storage test               - Test file operations\n");
@@ -1797,11 +2468,14 @@ int matrix_led_cmd_handler(int argc, char **argv) {
     printf("  led matrix draw line <x0> <y0> <x1> <y1> <r> <g> <b>\n");
     printf("  led matrix draw rect <x> <y> <w> <h> <r> <g> <b> [fill]\n");
     printf("  led matrix draw circle <x> <y> <radius> <r> <g> <b> [fill]\n");
+    printf("  led matrix text <x> <y> <text> [r g b] [5x7|8x8]\n");
     printf("\nAnimation Commands:\n");
     printf("  led matrix anim <type> [speed]   - Start animation\n");
     printf("    Types: rainbow, wave, breathe, rotate, fade\n");
     printf("    Speed: 1-100 (default: 50)\n");
     printf("  led matrix stop                  - Stop current animation\n");
+    printf("  led matrix fps [1-100]           - Show/set target frame rate\n");
+    printf("  led matrix timing [reset]        - Render/transmit p50/p99\n");
     printf("\nMode Control:\n");
     printf("  led matrix mode <static|animation|off> - Set display mode\n");
     printf("\nConfiguration:\n");
@@ -1835,11 +2509,14 @@ int matrix_led_cmd_handler(int argc, char **argv) {
     printf("  led matrix draw line <x0> <y0> <x1> <y1> <r> <g> <b>\n");
     printf("  led matrix draw rect <x> <y> <w> <h> <r> <g> <b> [fill]\n");
     printf("  led matrix draw circle <x> <y> <radius> <r> <g> <b> [fill]\n");
+    printf("  led matrix text <x> <y> <text> [r g b] [5x7|8x8]\n");
     printf("\nAnimation Commands:\n");
     printf("  led matrix anim <type> [speed]   - Start animation\n");
     printf("    Types: rainbow, wave, breathe, rotate, fade\n");
     printf("    Speed: 1-100 (default: 50)\n");
     printf("  led matrix stop                  - Stop current animation\n");
+    printf("  led matrix fps [1-100]           - Show/set target frame rate\n");
+    printf("  led matrix timing [reset]        - Render/transmit p50/p99\n");
     printf("\nMode Control:\n");
     printf("  led matrix mode <static|animation|off> - Set display mode\n");
     printf("\nConfiguration:\n");
@@ -1854,6 +2531,9 @@ int matrix_led_cmd_handler(int argc, char **argv) {
            "(optionally by name)\n");
     printf(
         "  led matrix image list <file>       - List all animations in file\n");
+    printf("  led matrix image convert <json> <mla> - Convert JSON to binary "
+           "animation\n");
+    printf("    Files ending in .mla use the binary animation format\n");
     printf("  led matrix storage status        - Check SD card status\n");
     printf("  led matrix storage test          - Test file operations\n");
     printf("  led matrix storage testwrite     - Test config file write\n");
@@ -1866,6 +2546,7 @@ int matrix_led_cmd_handler(int argc, char **argv) {
     printf("  led matrix brightness 30         - Set to 30%% brightness\n");
     printf("  led matrix config export /sdcard/config.json\n");
     printf("  led matrix image export /sdcard/matrix.json\n");
+    printf("  led matrix image convert /sdcard/matrix.json /sdcard/matrix.mla\n");
     printf("\nCoordinate System:\n");
     printf("  Origin (0,0) is at top-left corner\n");
     printf("  X-axis: 0-31 (left to right)\n");
@@ -1883,6 +2564,15 @@ int matrix_led_cmd_handler(int argc, char **argv) {
       printf("  Brightness: %d%%\n", status.brightness);
       printf("  Pixel Count: %lu\n", status.pixel_count);
       printf("  Frame Count: %lu\n", status.frame_count);
+      printf("  Presented Frames: %lu\n", status.presented_frames);
+      printf("  Dropped Frames: %lu\n", status.dropped_frames);
+      printf("  Late Frames: %lu\n", status.late_frames);
+      printf("  Skipped Frames: %lu\n", status.skipped_frames);
+      printf("  Corrected Pixels: %lu\n", status.corrected_pixels);
+      printf("  Stream Underruns: %lu\n", status.stream_underruns);
+      printf("  Stream Buffered Frames: %lu\n", status.stream_buffered_frames);
+      printf("  Layers: %u (composed rows: %lu)\n", status.layer_count,
+             status.composed_rows);
       if (strlen(status.current_animation) > 0) {
         printf("  Current Animation: %s\n", status.current_animation);
       }
@@ -2050,6 +2740,42 @@ int matrix_led_cmd_handler(int argc, char **argv) {
     if (ret == ESP_OK) {
       printf("Animation stopped\n");
     }
+  } else if (strcmp(argv[1], "fps") == 0) {
+    if (argc < 3) {
+      printf("Target frame rate: %d fps\n", matrix_led_get_target_fps());
+      return 0;
+    }
+    int fps = atoi(argv[2]);
+    if (fps < 1 || fps > MATRIX_LED_MAX_FPS) {
+      printf("Invalid frame rate. Range: 1-%d\n", MATRIX_LED_MAX_FPS);
+      return 1;
+    }
+    ret = matrix_led_set_target_fps((uint8_t)fps);
+    if (ret == ESP_OK) {
+      printf("Target frame rate set to %d fps\n", fps);
+    }
+  } else if (strcmp(argv[1], "timing") == 0) {
+    if (argc >= 3 && strcmp(argv[2], "reset") == 0) {
+      ret = matrix_led_reset_timing_stats();
+      if (ret == ESP_OK) {
+        printf("Frame timing statistics cleared\n");
+      }
+    } else {
+      matrix_led_timing_stats_t timing;
+      ret = matrix_led_get_timing_stats(&timing);
+      if (ret == ESP_OK) {
+        printf("Matrix LED Frame Timing:\n");
+        printf("  Target FPS: %d\n", timing.target_fps);
+        printf("  Rendered Frames: %lu\n", timing.rendered_frames);
+        printf("  Missed Deadlines: %lu\n", timing.missed_frames);
+        printf("  Render   (%lu samples): p50 %lu us, p99 %lu us, max %lu us\n",
+               timing.render_samples, timing.render_p50_us,
+               timing.render_p99_us, timing.render_max_us);
+        printf("  Transmit (%lu samples): p50 %lu us, p99 %lu us, max %lu us\n",
+               timing.transmit_samples, timing.transmit_p50_us,
+               timing.transmit_p99_us, timing.transmit_max_us);
+      }
+    }
   } else if (strcmp(argv[1], "config") == 0) {
     if (argc < 3) {
       printf("Usage: led matrix config <save|load|reset|export|import>\n");
@@ -2128,19 +2854,35 @@ int matrix_led_cmd_handler(int argc, char **argv) {
     }
   } else if (strcmp(argv[1], "image") == 0) {
     if (argc < 3) {
-      printf("Usage: led matrix image <export|import> <filepath>\n");
-      printf("  export <filepath> - Save current display to file\n");
-      printf("  import <filepath> - Load image from file\n");
+      printf("Usage: led matrix image <export|import|list|convert> "
+             "<filepath>\n");
+      printf("  export <filepath> [name] - Save current display to file\n");
+      printf("  import <filepath> [name] - Load image from file\n");
+      printf("  list <filepath>          - List animations in file\n");
+      printf("  convert <json> <mla>     - Convert JSON to binary animation\n");
       return 1;
     }
 
     if (strcmp(argv[2], "export") == 0) {
       if (argc < 4) {
-        printf("Usage: led matrix image export <filepath>\n");
+        printf("Usage: led matrix image export <filepath> [name]\n");
         printf("Example: led matrix image export /sdcard/matrix.json\n");
+        printf("Example: led matrix image export /sdcard/logo.mla Logo\n");
         return 1;
       }
-      ret = matrix_led_export_image(argv[3]);
+      size_t path_len = strlen(argv[3]);
+      if (path_len > 4 && strcmp(argv[3] + path_len - 4, ".mla") == 0) {
+        char name[MATRIX_LED_MAX_NAME_LEN];
+        if (argc >= 5) {
+          snprintf(name, sizeof(name), "%s", argv[4]);
+        } else {
+          snprintf(name, sizeof(name), "Static_Image_%lu",
+                   (unsigned long)(esp_timer_get_time() / 1000000));
+        }
+        ret = matrix_led_export_animation(name, argv[3]);
+      } else {
+        ret = matrix_led_export_image(argv[3]);
+      }
       if (ret == ESP_OK) {
         printf("Image exported to: %s\n", argv[3]);
       } else if (ret == ESP_ERR_INVALID_STATE &&
@@ -2184,6 +2926,21 @@ int matrix_led_cmd_handler(int argc, char **argv) {
       if (ret != ESP_OK && ret != ESP_ERR_NOT_FOUND) {
         printf("Failed to list animations in file: %s\n", argv[3]);
       }
+    } else if (strcmp(argv[2], "convert") == 0) {
+      if (argc < 5) {
+        printf("Usage: led matrix image convert <json> <mla>\n");
+        printf("Example: led matrix image convert /sdcard/matrix.json "
+               "/sdcard/matrix.mla\n");
+        return 1;
+      }
+      ret = matrix_led_convert_animation_file(argv[3], argv[4]);
+      if (ret == ESP_OK) {
+        printf("Converted %s -> %s\n", argv[3], argv[4]);
+      } else if (ret == ESP_ERR_NOT_FOUND) {
+        printf("File not found: %s\n", argv[3]);
+      } else {
+        printf("Conversion failed: %s\n", esp_err_to_name(ret));
+      }
     } else {
       printf("Invalid image command\n");
       return 1;
@@ -2415,6 +3172,50 @@ int matrix_led_cmd_handler(int argc, char **argv) {
         }
       }
     }
+  } else if (strcmp(argv[1], "layers") == 0) {
+    static const char *formats[] = {"opaque", "keyed", "alpha"};
+    const matrix_led_compositor_t *compositor = &s_context.compositor;
+    printf("Layers (%u/%d, bottom to top):\n", compositor->count,
+           MATRIX_LED_LAYER_MAX);
+    for (int i = 0; i < compositor->count; i++) {
+      const matrix_led_layer_config_t *c = &compositor->layers[i]->config;
+      printf("  [%d] z=%d %ux%u at (%d,%d) %s opacity=%u %s%s%s\n", i, c->z,
+             c->width, c->height, c->x, c->y, formats[c->format], c->opacity,
+             c->visible ? "visible" : "hidden",
+             compositor->layers[i] == s_context.draw_layer ? " [draw]" : "",
+             compositor->layers[i] == s_context.animation_layer ? " [anim]"
+                                                                : "");
+    }
+    printf("Compositions: %lu, composed rows: %lu, blended pixels: %lu\n",
+           compositor->compositions, compositor->composed_rows,
+           compositor->blended_pixels);
+  } else if (strcmp(argv[1], "text") == 0) {
+    if (argc < 5) {
+      printf("Usage: led matrix text <x> <y> <text> [r g b] [5x7|8x8]\n");
+      return 1;
+    }
+    int x = atoi(argv[2]), y = atoi(argv[3]);
+    matrix_led_color_t color = MATRIX_LED_COLOR_WHITE;
+    if (argc >= 8) {
+      int r = atoi(argv[5]), g = atoi(argv[6]), b = atoi(argv[7]);
+      if (r < 0 || r > 255 || g < 0 || g > 255 || b < 0 || b > 255) {
+        printf("Invalid color values. Must be 0-255\n");
+        return 1;
+      }
+      color = (matrix_led_color_t){r, g, b};
+    }
+    const matrix_led_font_t *font = &matrix_led_font_5x7;
+    if ((argc == 6 && strcmp(argv[5], "8x8") == 0) ||
+        (argc >= 9 && strcmp(argv[8], "8x8") == 0)) {
+      font = &matrix_led_font_8x8;
+    }
+
+    ret = matrix_led_draw_text_font(x, y, argv[4], font, color, NULL);
+    if (ret == ESP_OK) {
+      matrix_led_refresh();
+      printf("Text drawn at (%d,%d) with %s font, width %u\n", x, y,
+             font->name, matrix_led_font_text_width(font, argv[4]));
+    }
   } else {
     printf("Unknown matrix LED command: %s\n", argv[1]);
     return 1;
@@ -2817,6 +3618,11 @@ esp_err_t matrix_led_import_image_by_name(const char *filepath,
     return ESP_ERR_NOT_FOUND;
   }
 
+  // 二进制动画容器按帧流式解码，不需要把整个文件读入内存
+  if (matrix_led_anim_is_container(filepath)) {
+    return matrix_led_import_animation(filepath, animation_name);
+  }
+
   // 读取文件内容
   FILE *file = fopen(filepath, "r");
   if (file == NULL) {
@@ -2976,6 +3782,7 @@ esp_err_t matrix_led_import_image_by_name(const char *filepath,
   }
 
   // 刷新显示
+  matrix_led_mark_dirty_rows(MATRIX_LED_ALL_ROWS_DIRTY);
   matrix_led_refresh();
 
   cJSON_Delete(root);
@@ -2987,6 +3794,44 @@ esp_err_t matrix_led_import_image_by_name(const char *filepath,
   return ESP_OK;
 }
 
+/**
+ * @brief 列出二进制动画容器中的动画（逐项读取索引）
+ */
+static esp_err_t matrix_led_list_container_animations(const char *filepath) {
+  matrix_led_anim_reader_t *reader = malloc(sizeof(matrix_led_anim_reader_t));
+  if (reader == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+
+  esp_err_t ret = matrix_led_anim_open(reader, filepath);
+  if (ret != ESP_OK) {
+    printf("Failed to open animation file: %s (%s)\n", filepath,
+           esp_err_to_name(ret));
+    free(reader);
+    return ret;
+  }
+
+  printf("Animations in file: %s\n", filepath);
+  printf("Found %u animation(s), %s colors:\n", reader->animation_count,
+         reader->palette_count ? "palette" : "RGB");
+
+  for (uint16_t i = 0; i < reader->animation_count; i++) {
+    matrix_led_anim_info_t info;
+    ret = matrix_led_anim_get_info(reader, i, &info);
+    if (ret != ESP_OK) {
+      printf("  [%u] <corrupted index entry>\n", i + 1);
+      break;
+    }
+    printf("  [%u] %s (%u frames, %u ms, %s, %lu bytes)\n", i + 1, info.name,
+           info.frame_count, info.frame_delay_ms, info.loop ? "loop" : "once",
+           (unsigned long)info.data_size);
+  }
+
+  matrix_led_anim_close(reader);
+  free(reader);
+  return ret;
+}
+
 esp_err_t matrix_led_list_animations(const char *filepath) {
   if (filepath == NULL) {
     return ESP_ERR_INVALID_ARG;
@@ -2999,6 +3844,10 @@ esp_err_t matrix_led_list_animations(const char *filepath) {
     return ESP_ERR_NOT_FOUND;
   }
 
+  if (matrix_led_anim_is_container(filepath)) {
+    return matrix_led_list_container_animations(filepath);
+  }
+
   // 读取文件内容
   FILE *file = fopen(filepath, "r");
   if (file == NULL) {
@@ -3087,10 +3936,63 @@ esp_err_t matrix_led_export_animation(const char *animation_name,
     return ESP_ERR_INVALID_STATE;
   }
 
-  // TODO: 实现自定义动画导出
-  // 当前版本暂不支持自定义动画录制
-  ESP_LOGW(TAG, "Custom animation export not yet implemented");
-  return ESP_ERR_NOT_SUPPORTED;
+  // 确保目录存在
+  esp_err_t ret = ensure_directory_exists(filepath);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to create directory for: %s", filepath);
+    return ret;
+  }
+
+  // 停止动画以获取当前静态内容
+  if (s_context.animation.is_running) {
+    matrix_led_stop_animation();
+  }
+
+  matrix_led_anim_writer_t *writer = malloc(sizeof(matrix_led_anim_writer_t));
+  if (writer == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+
+  // 不超过256种颜色时使用调色板，否则直接存储RGB
+  uint16_t palette_count = 0;
+  bool use_palette = true;
+  for (int i = 0; i < MATRIX_LED_COUNT && use_palette; i++) {
+    use_palette = matrix_led_anim_palette_add(writer->palette, &palette_count,
+                                              s_context.pixel_buffer[i]) >= 0;
+  }
+
+  ret = matrix_led_anim_writer_open(writer, filepath,
+                                    use_palette ? writer->palette : NULL,
+                                    palette_count);
+  if (ret == ESP_OK) {
+    ret = matrix_led_anim_writer_begin(writer, animation_name, 100, false);
+    if (ret == ESP_OK) {
+      ret = matrix_led_anim_writer_add_frame(writer, s_context.pixel_buffer, 0);
+    }
+    if (ret == ESP_OK) {
+      ret = matrix_led_anim_writer_end(writer);
+    }
+    esp_err_t close_ret = matrix_led_anim_writer_close(writer);
+    if (ret == ESP_OK) {
+      ret = close_ret;
+    }
+    if (ret != ESP_OK) {
+      remove(filepath);
+    }
+  }
+
+  uint32_t written = writer->offset;
+  free(writer);
+
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to export animation to %s: %s", filepath,
+             esp_err_to_name(ret));
+    return ret;
+  }
+
+  ESP_LOGI(TAG, "Animation '%s' exported to: %s (%lu bytes)", animation_name,
+           filepath, (unsigned long)written);
+  return ESP_OK;
 }
 
 esp_err_t matrix_led_import_animation(const char *filepath,
@@ -3099,7 +4001,7 @@ esp_err_t matrix_led_import_animation(const char *filepath,
     return ESP_ERR_INVALID_STATE;
   }
 
-  if (filepath == NULL || animation_name == NULL) {
+  if (filepath == NULL) {
     return ESP_ERR_INVALID_ARG;
   }
 
@@ -3110,8 +4012,273 @@ esp_err_t matrix_led_import_animation(const char *filepath,
     return ESP_ERR_NOT_FOUND;
   }
 
-  // TODO: 实现自定义动画导入
-  // 当前版本暂不支持自定义动画播放
-  ESP_LOGW(TAG, "Custom animation import not yet implemented");
-  return ESP_ERR_NOT_SUPPORTED;
-}
\ No newline at end of file
+  esp_err_t ret = matrix_led_load_animation_from_file(filepath, animation_name);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  // 多帧动画交给动画任务按帧流式解码
+  if (s_context.animation.custom_reader->info.frame_count > 1) {
+    return matrix_led_play_custom_animation(NULL);
+  }
+
+  // 单帧动画作为静态图像显示
+  if (s_context.animation.is_running) {
+    matrix_led_stop_animation();
+  }
+
+  if (xSemaphoreTake(s_context.mutex, pdMS_TO_TICKS(100)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+
+  uint32_t dirty_rows = 0;
+  matrix_led_anim_reader_t *reader = s_context.animation.custom_reader;
+  matrix_led_anim_rewind(reader);
+  ret = matrix_led_anim_read_frame(reader, s_context.pixel_buffer, NULL,
+                                   &dirty_rows);
+
+  xSemaphoreGive(s_context.mutex);
+
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to decode image '%s' from %s", reader->info.name,
+             filepath);
+    return ESP_FAIL;
+  }
+
+  matrix_led_mark_dirty_rows(dirty_rows);
+  matrix_led_refresh();
+
+  ESP_LOGI(TAG, "Image '%s' imported from: %s", reader->info.name, filepath);
+  return ESP_OK;
+}
+
+/**
+ * @brief JSON动画中的帧数（"frames" 数组，或只有 "points" 时为单帧）
+ */
+static int matrix_led_json_frame_count(const cJSON *animation) {
+  const cJSON *frames = cJSON_GetObjectItem(animation, "frames");
+  if (cJSON_IsArray(frames)) {
+    return cJSON_GetArraySize(frames);
+  }
+  return cJSON_IsArray(cJSON_GetObjectItem(animation, "points")) ? 1 : 0;
+}
+
+/**
+ * @brief 取出JSON动画第 index 帧的点数组和显示时间
+ */
+static const cJSON *matrix_led_json_frame_points(const cJSON *animation,
+                                                 int index,
+                                                 uint16_t *delay_ms) {
+  *delay_ms = 0;
+  const cJSON *frames = cJSON_GetObjectItem(animation, "frames");
+  if (!cJSON_IsArray(frames)) {
+    return cJSON_GetObjectItem(animation, "points");
+  }
+
+  const cJSON *frame = cJSON_GetArrayItem(frames, index);
+  const cJSON *delay = cJSON_GetObjectItem(frame, "delay_ms");
+  if (cJSON_IsNumber(delay) && delay->valueint > 0) {
+    *delay_ms = (uint16_t)delay->valueint;
+  }
+  return cJSON_GetObjectItem(frame, "points");
+}
+
+/**
+ * @brief 将JSON点数组绘制到整帧缓冲区（先清空）
+ */
+static void matrix_led_json_points_to_frame(const cJSON *points,
+                                            matrix_led_color_t *frame) {
+  memset(frame, 0, MATRIX_LED_COUNT * sizeof(matrix_led_color_t));
+
+  const cJSON *point;
+  cJSON_ArrayForEach(point, points) {
+    const cJSON *x = cJSON_GetObjectItem(point, "x");
+    const cJSON *y = cJSON_GetObjectItem(point, "y");
+    const cJSON *r = cJSON_GetObjectItem(point, "r");
+    const cJSON *g = cJSON_GetObjectItem(point, "g");
+    const cJSON *b = cJSON_GetObjectItem(point, "b");
+    if (cJSON_IsNumber(x) && cJSON_IsNumber(y) && cJSON_IsNumber(r) &&
+        cJSON_IsNumber(g) && cJSON_IsNumber(b) && x->valueint >= 0 &&
+        x->valueint < MATRIX_LED_WIDTH && y->valueint >= 0 &&
+        y->valueint < MATRIX_LED_HEIGHT) {
+      frame[y->valueint * MATRIX_LED_WIDTH + x->valueint] =
+          (matrix_led_color_t){(uint8_t)r->valueint, (uint8_t)g->valueint,
+                               (uint8_t)b->valueint};
+    }
+  }
+}
+
+/**
+ * @brief 收集JSON文件中所有颜色，超过256种时返回false
+ */
+static bool matrix_led_json_collect_palette(const cJSON *animations,
+                                            matrix_led_color_t *palette,
+                                            uint16_t *count) {
+  // 黑色固定占用索引0，增量帧熄灭像素时需要
+  *count = 0;
+  matrix_led_anim_palette_add(palette, count, MATRIX_LED_COLOR_BLACK);
+
+  const cJSON *animation;
+  cJSON_ArrayForEach(animation, animations) {
+    int frame_count = matrix_led_json_frame_count(animation);
+    for (int f = 0; f < frame_count; f++) {
+      uint16_t delay_ms;
+      const cJSON *points =
+          matrix_led_json_frame_points(animation, f, &delay_ms);
+      const cJSON *point;
+      cJSON_ArrayForEach(point, points) {
+        const cJSON *r = cJSON_GetObjectItem(point, "r");
+        const cJSON *g = cJSON_GetObjectItem(point, "g");
+        const cJSON *b = cJSON_GetObjectItem(point, "b");
+        if (cJSON_IsNumber(r) && cJSON_IsNumber(g) && cJSON_IsNumber(b)) {
+          matrix_led_color_t color = {(uint8_t)r->valueint,
+                                      (uint8_t)g->valueint,
+                                      (uint8_t)b->valueint};
+          if (matrix_led_anim_palette_add(palette, count, color) < 0) {
+            return false;
+          }
+        }
+      }
+    }
+  }
+  return true;
+}
+
+esp_err_t matrix_led_convert_animation_file(const char *json_path,
+                                            const char *anim_path) {
+  if (json_path == NULL || anim_path == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // 检查文件是否存在
+  struct stat st;
+  if (stat(json_path, &st) != 0) {
+    ESP_LOGW(TAG, "Animation file not found: %s", json_path);
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  // 读取文件内容（转换是一次性操作，之后播放只读取二进制文件）
+  FILE *file = fopen(json_path, "r");
+  if (file == NULL) {
+    ESP_LOGE(TAG, "Failed to open animation file: %s", json_path);
+    return ESP_FAIL;
+  }
+
+  char *json_string = malloc(st.st_size + 1);
+  if (json_string == NULL) {
+    fclose(file);
+    return ESP_ERR_NO_MEM;
+  }
+
+  size_t read_size = fread(json_string, 1, st.st_size, file);
+  fclose(file);
+  json_string[read_size] = '\0';
+
+  cJSON *root = cJSON_Parse(json_string);
+  free(json_string);
+
+  if (root == NULL) {
+    ESP_LOGE(TAG, "Failed to parse animation JSON");
+    return ESP_FAIL;
+  }
+
+  cJSON *animations = cJSON_GetObjectItem(root, "animations");
+  if (!cJSON_IsArray(animations) || cJSON_GetArraySize(animations) == 0) {
+    ESP_LOGE(TAG, "No animations array found in file: %s", json_path);
+    cJSON_Delete(root);
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  matrix_led_anim_writer_t *writer = malloc(sizeof(matrix_led_anim_writer_t));
+  matrix_led_color_t *frame =
+      malloc(MATRIX_LED_COUNT * sizeof(matrix_led_color_t));
+  if (writer == NULL || frame == NULL) {
+    free(writer);
+    free(frame);
+    cJSON_Delete(root);
+    return ESP_ERR_NO_MEM;
+  }
+
+  uint16_t palette_count = 0;
+  bool use_palette =
+      matrix_led_json_collect_palette(animations, writer->palette,
+                                      &palette_count);
+
+  esp_err_t ret = matrix_led_anim_writer_open(
+      writer, anim_path, use_palette ? writer->palette : NULL, palette_count);
+
+  int index = 0;
+  const cJSON *animation;
+  cJSON_ArrayForEach(animation, animations) {
+    if (ret != ESP_OK) {
+      break;
+    }
+
+    char name[MATRIX_LED_MAX_NAME_LEN];
+    const cJSON *name_item = cJSON_GetObjectItem(animation, "name");
+    if (cJSON_IsString(name_item)) {
+      snprintf(name, sizeof(name), "%s", name_item->valuestring);
+    } else {
+      snprintf(name, sizeof(name), "Animation_%d", index + 1);
+    }
+
+    uint16_t frame_delay_ms = 100;
+    const cJSON *delay = cJSON_GetObjectItem(animation, "frame_delay_ms");
+    if (cJSON_IsNumber(delay) && delay->valueint > 0) {
+      frame_delay_ms = (uint16_t)delay->valueint;
+    }
+    const cJSON *loop = cJSON_GetObjectItem(animation, "loop");
+
+    int frame_count = matrix_led_json_frame_count(animation);
+    if (frame_count == 0) {
+      ESP_LOGW(TAG, "Skipping animation '%s' without frames", name);
+      index++;
+      continue;
+    }
+
+    ret = matrix_led_anim_writer_begin(writer, name, frame_delay_ms,
+                                       !cJSON_IsFalse(loop));
+    for (int f = 0; f < frame_count && ret == ESP_OK; f++) {
+      uint16_t delay_ms;
+      matrix_led_json_points_to_frame(
+          matrix_led_json_frame_points(animation, f, &delay_ms), frame);
+      ret = matrix_led_anim_writer_add_frame(writer, frame, delay_ms);
+    }
+    if (ret == ESP_OK) {
+      ret = matrix_led_anim_writer_end(writer);
+    }
+    index++;
+  }
+
+  if (ret == ESP_OK && writer->animation_count == 0) {
+    ret = ESP_ERR_INVALID_ARG;
+  }
+
+  if (writer->file != NULL) {
+    esp_err_t close_ret = matrix_led_anim_writer_close(writer);
+    if (ret == ESP_OK) {
+      ret = close_ret;
+    }
+    if (ret != ESP_OK) {
+      remove(anim_path);
+    }
+  }
+  uint16_t animation_count = writer->animation_count;
+  uint32_t written = writer->offset;
+
+  free(writer);
+  free(frame);
+  cJSON_Delete(root);
+
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to convert %s: %s", json_path, esp_err_to_name(ret));
+    return ret;
+  }
+
+  ESP_LOGI(TAG,
+           "Converted %s (%ld bytes) to %s (%lu bytes, %u animation(s), "
+           "%s)",
+           json_path, (long)st.st_size, anim_path, (unsigned long)written,
+           animation_count, use_palette ? "palette" : "rgb");
+  return ESP_OK;
+}
@@ -0,0 +1,905 @@
+/**
+ * @file matrix_led_anim.c
+ * @brief Matrix LED 二进制动画容器实现
+ */
+
+#include "matrix_led_anim.h"
+
+#include <string.h>
+
+_Static_assert(MATRIX_LED_ANIM_MAX_PAYLOAD <= 0xFFFF,
+               "frame payload length is stored as uint16");
+_Static_assert(MATRIX_LED_HEIGHT <= 32, "dirty row mask holds 32 rows");
+
+// 操作码
+#define ANIM_OP_SKIP 0x00
+#define ANIM_OP_LITERAL 0x40
+#define ANIM_OP_FILL 0x80
+#define ANIM_OP_SHORT_MAX 64 // 跳过/逐个写入单次最多64个像素
+#define ANIM_OP_FILL_MAX 128 // 重复写入单次最多128个像素
+
+// 索引项标志
+#define ANIM_FLAG_LOOP 0x01
+
+// ==================== 内部辅助函数 ====================
+
+static inline void anim_put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void anim_put_u32(uint8_t *p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+
+static inline uint16_t anim_get_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t anim_get_u32(const uint8_t *p) {
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+         ((uint32_t)p[3] << 24);
+}
+
+static inline bool anim_color_equal(matrix_led_color_t a,
+                                    matrix_led_color_t b) {
+  return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+static int anim_palette_find(const matrix_led_color_t *palette, uint16_t count,
+                             matrix_led_color_t color) {
+  for (uint16_t i = 0; i < count; i++) {
+    if (anim_color_equal(palette[i], color)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief 像素区间 [start, start + count) 覆盖的行掩码
+ */
+static inline uint32_t anim_rows_mask(uint32_t start, uint32_t count) {
+  uint32_t first = start / MATRIX_LED_WIDTH;
+  uint32_t last = (start + count - 1) / MATRIX_LED_WIDTH;
+  uint32_t upper = last >= 31 ? 0xFFFFFFFFu : ((1u << (last + 1)) - 1);
+  return upper & ~((1u << first) - 1);
+}
+
+/**
+ * @brief 写入一个颜色（调色板索引或RGB），out 为NULL时只计算长度
+ *
+ * @return 写入的字节数，颜色不在调色板中时返回-1
+ */
+static int anim_emit_color(const matrix_led_anim_writer_t *writer,
+                           matrix_led_color_t color, uint8_t *out) {
+  if (writer->palette_count == 0) {
+    if (out != NULL) {
+      out[0] = color.r;
+      out[1] = color.g;
+      out[2] = color.b;
+    }
+    return 3;
+  }
+
+  int index = anim_palette_find(writer->palette, writer->palette_count, color);
+  if (index < 0) {
+    return -1;
+  }
+  if (out != NULL) {
+    out[0] = (uint8_t)index;
+  }
+  return 1;
+}
+
+/**
+ * @brief 编码一帧
+ *
+ * @param reference 参考帧，为NULL时相对全黑画面编码（关键帧）
+ * @param out 输出缓冲区，为NULL时只计算长度
+ * @return 负载长度，颜色不在调色板中时返回-1
+ */
+static int anim_encode_frame(const matrix_led_anim_writer_t *writer,
+                             const matrix_led_color_t *pixels,
+                             const matrix_led_color_t *reference,
+                             uint8_t *out) {
+  static const matrix_led_color_t black = {0, 0, 0};
+  int len = 0;
+  uint32_t i = 0;
+
+#define ANIM_SAME_AS_REF(k)                                                    \
+  anim_color_equal(pixels[k], reference != NULL ? reference[k] : black)
+
+  while (i < MATRIX_LED_COUNT) {
+    // 与参考帧相同的像素直接跳过
+    if (ANIM_SAME_AS_REF(i)) {
+      uint32_t n = 1;
+      while (i + n < MATRIX_LED_COUNT && n < ANIM_OP_SHORT_MAX &&
+             ANIM_SAME_AS_REF(i + n)) {
+        n++;
+      }
+      // 末尾的跳过可以省略
+      if (i + n < MATRIX_LED_COUNT) {
+        if (out != NULL) {
+          out[len] = (uint8_t)(ANIM_OP_SKIP | (n - 1));
+        }
+        len++;
+      }
+      i += n;
+      continue;
+    }
+
+    // 相同颜色的游程
+    uint32_t run = 1;
+    while (i + run < MATRIX_LED_COUNT && run < ANIM_OP_FILL_MAX &&
+           anim_color_equal(pixels[i + run], pixels[i])) {
+      run++;
+    }
+    if (run >= 2) {
+      if (out != NULL) {
+        out[len] = (uint8_t)(ANIM_OP_FILL | (run - 1));
+      }
+      int c = anim_emit_color(writer, pixels[i], out ? out + len + 1 : NULL);
+      if (c < 0) {
+        return -1;
+      }
+      len += 1 + c;
+      i += run;
+      continue;
+    }
+
+    // 逐个写入，直到遇到可跳过的像素或新的游程
+    uint32_t n = 1;
+    while (i + n < MATRIX_LED_COUNT && n < ANIM_OP_SHORT_MAX &&
+           !ANIM_SAME_AS_REF(i + n) &&
+           !(i + n + 1 < MATRIX_LED_COUNT &&
+             anim_color_equal(pixels[i + n], pixels[i + n + 1]))) {
+      n++;
+    }
+    if (out != NULL) {
+      out[len] = (uint8_t)(ANIM_OP_LITERAL | (n - 1));
+    }
+    len++;
+    for (uint32_t k = 0; k < n; k++) {
+      int c = anim_emit_color(writer, pixels[i + k], out ? out + len : NULL);
+      if (c < 0) {
+        return -1;
+      }
+      len += c;
+    }
+    i += n;
+  }
+
+#undef ANIM_SAME_AS_REF
+
+  return len;
+}
+
+static bool anim_write(matrix_led_anim_writer_t *writer, const void *data,
+                       size_t len) {
+  if (fwrite(data, 1, len, writer->file) != len) {
+    return false;
+  }
+  writer->offset += (uint32_t)len;
+  return true;
+}
+
+/**
+ * @brief 从读缓冲区取出 len 个字节（必要时从文件补充）
+ */
+static bool anim_read_bytes(matrix_led_anim_reader_t *reader, uint8_t *out,
+                            size_t len) {
+  while (len > 0) {
+    if (reader->chunk_pos >= reader->chunk_len) {
+      size_t got =
+          fread(reader->chunk, 1, MATRIX_LED_ANIM_CHUNK_SIZE, reader->file);
+      if (got == 0) {
+        return false;
+      }
+      reader->chunk_len = (uint16_t)got;
+      reader->chunk_pos = 0;
+    }
+
+    size_t n = reader->chunk_len - reader->chunk_pos;
+    if (n > len) {
+      n = len;
+    }
+    memcpy(out, &reader->chunk[reader->chunk_pos], n);
+    reader->chunk_pos += (uint16_t)n;
+    out += n;
+    len -= n;
+  }
+  return true;
+}
+
+/**
+ * @brief 帧负载的字节来源（文件读缓冲或内存中的帧记录）
+ */
+typedef struct {
+  matrix_led_anim_reader_t *reader; ///< 非NULL时从文件读取
+  const uint8_t *data;              ///< 否则从内存读取
+  uint32_t remaining;               ///< 负载剩余字节数
+} anim_source_t;
+
+static inline bool anim_source_read(anim_source_t *src, uint8_t *out,
+                                    size_t len) {
+  if (len > src->remaining) {
+    return false;
+  }
+  src->remaining -= (uint32_t)len;
+
+  if (src->reader != NULL) {
+    return anim_read_bytes(src->reader, out, len);
+  }
+  memcpy(out, src->data, len);
+  src->data += len;
+  return true;
+}
+
+/**
+ * @brief 从帧负载中读取一个颜色
+ */
+static inline bool anim_source_color(anim_source_t *src,
+                                     const matrix_led_anim_reader_t *reader,
+                                     matrix_led_color_t *color) {
+  if (reader->palette_count == 0) {
+    uint8_t rgb[3];
+    if (!anim_source_read(src, rgb, 3)) {
+      return false;
+    }
+    color->r = rgb[0];
+    color->g = rgb[1];
+    color->b = rgb[2];
+    return true;
+  }
+
+  uint8_t index;
+  if (!anim_source_read(src, &index, 1) || index >= reader->palette_count) {
+    return false;
+  }
+  *color = reader->palette[index];
+  return true;
+}
+
+/**
+ * @brief 解析帧头
+ */
+static bool anim_parse_frame_header(const uint8_t *header, uint8_t *type,
+                                    uint16_t *delay_ms, uint32_t *length) {
+  *type = header[0];
+  *delay_ms = anim_get_u16(&header[2]);
+  *length = anim_get_u16(&header[4]);
+  return *type <= MATRIX_LED_ANIM_FRAME_DELTA &&
+         *length <= MATRIX_LED_ANIM_MAX_PAYLOAD;
+}
+
+/**
+ * @brief 按操作码序列把负载解码到帧缓冲区
+ */
+static esp_err_t anim_decode_payload(anim_source_t *src,
+                                     const matrix_led_anim_reader_t *reader,
+                                     uint8_t type, matrix_led_color_t *frame,
+                                     uint32_t *dirty_rows) {
+  uint32_t rows = 0;
+  if (type == MATRIX_LED_ANIM_FRAME_KEY) {
+    memset(frame, 0, MATRIX_LED_COUNT * sizeof(matrix_led_color_t));
+    rows = anim_rows_mask(0, MATRIX_LED_COUNT);
+  }
+
+  uint32_t pos = 0;
+  while (src->remaining > 0) {
+    uint8_t op;
+    if (!anim_source_read(src, &op, 1)) {
+      return ESP_FAIL;
+    }
+
+    uint32_t n = (op & ANIM_OP_FILL) ? (op & 0x7F) + 1u : (op & 0x3F) + 1u;
+    if (pos + n > MATRIX_LED_COUNT) {
+      return ESP_FAIL;
+    }
+
+    if (op & ANIM_OP_FILL) {
+      matrix_led_color_t color;
+      if (!anim_source_color(src, reader, &color)) {
+        return ESP_FAIL;
+      }
+      for (uint32_t k = 0; k < n; k++) {
+        frame[pos + k] = color;
+      }
+      rows |= anim_rows_mask(pos, n);
+    } else if (op & ANIM_OP_LITERAL) {
+      for (uint32_t k = 0; k < n; k++) {
+        if (!anim_source_color(src, reader, &frame[pos + k])) {
+          return ESP_FAIL;
+        }
+      }
+      rows |= anim_rows_mask(pos, n);
+    }
+    pos += n;
+  }
+
+  if (dirty_rows != NULL) {
+    *dirty_rows = rows;
+  }
+  return ESP_OK;
+}
+
+// ==================== 调色板 ====================
+
+int matrix_led_anim_palette_add(matrix_led_color_t *palette, uint16_t *count,
+                                matrix_led_color_t color) {
+  if (palette == NULL || count == NULL) {
+    return -1;
+  }
+
+  int index = anim_palette_find(palette, *count, color);
+  if (index >= 0) {
+    return index;
+  }
+  if (*count >= MATRIX_LED_ANIM_MAX_PALETTE) {
+    return -1;
+  }
+
+  palette[*count] = color;
+  return (*count)++;
+}
+
+// ==================== 写入接口 ====================
+
+esp_err_t matrix_led_anim_writer_open(matrix_led_anim_writer_t *writer,
+                                      const char *filepath,
+                                      const matrix_led_color_t *palette,
+                                      uint16_t palette_count) {
+  if (writer == NULL || filepath == NULL ||
+      (palette != NULL &&
+       (palette_count == 0 || palette_count > MATRIX_LED_ANIM_MAX_PALETTE))) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // 调色板可以直接在 writer->palette 中准备好
+  if (palette != NULL && palette != writer->palette) {
+    memcpy(writer->palette, palette, palette_count * sizeof(*palette));
+  }
+  writer->palette_count = palette != NULL ? palette_count : 0;
+  writer->animation_count = 0;
+  writer->offset = 0;
+  writer->in_animation = false;
+
+  writer->file = fopen(filepath, "wb");
+  if (writer->file == NULL) {
+    return ESP_FAIL;
+  }
+
+  // 文件头在关闭时回填
+  uint8_t header[MATRIX_LED_ANIM_HEADER_SIZE] = {0};
+  if (!anim_write(writer, header, sizeof(header))) {
+    fclose(writer->file);
+    writer->file = NULL;
+    return ESP_FAIL;
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_anim_writer_begin(matrix_led_anim_writer_t *writer,
+                                       const char *name,
+                                       uint16_t frame_delay_ms, bool loop) {
+  if (writer == NULL || writer->file == NULL || name == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (writer->in_animation) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (writer->animation_count >= MATRIX_LED_ANIM_MAX_ANIMATIONS) {
+    return ESP_ERR_NO_MEM;
+  }
+
+  matrix_led_anim_info_t *info = &writer->index[writer->animation_count];
+  memset(info, 0, sizeof(*info));
+  strncpy(info->name, name, MATRIX_LED_MAX_NAME_LEN - 1);
+  info->data_offset = writer->offset;
+  info->frame_delay_ms = frame_delay_ms;
+  info->loop = loop;
+
+  writer->in_animation = true;
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_anim_writer_add_frame(matrix_led_anim_writer_t *writer,
+                                           const matrix_led_color_t *pixels,
+                                           uint16_t delay_ms) {
+  if (writer == NULL || pixels == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (!writer->in_animation) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  matrix_led_anim_info_t *info = &writer->index[writer->animation_count];
+  if (info->frame_count == UINT16_MAX) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  // 首帧必须是关键帧，之后选择较小的编码
+  int key_len = anim_encode_frame(writer, pixels, NULL, NULL);
+  if (key_len < 0) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  matrix_led_anim_frame_type_t type = MATRIX_LED_ANIM_FRAME_KEY;
+  if (info->frame_count > 0) {
+    int delta_len = anim_encode_frame(writer, pixels, writer->previous, NULL);
+    if (delta_len < key_len) {
+      type = MATRIX_LED_ANIM_FRAME_DELTA;
+    }
+  }
+
+  int len = anim_encode_frame(
+      writer, pixels,
+      type == MATRIX_LED_ANIM_FRAME_DELTA ? writer->previous : NULL,
+      writer->payload);
+
+  uint8_t header[MATRIX_LED_ANIM_FRAME_HEADER_SIZE];
+  header[0] = (uint8_t)type;
+  header[1] = 0;
+  anim_put_u16(&header[2], delay_ms);
+  anim_put_u16(&header[4], (uint16_t)len);
+  if (!anim_write(writer, header, sizeof(header)) ||
+      !anim_write(writer, writer->payload, (size_t)len)) {
+    return ESP_FAIL;
+  }
+
+  memcpy(writer->previous, pixels, sizeof(writer->previous));
+  info->frame_count++;
+  info->data_size = writer->offset - info->data_offset;
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_anim_writer_end(matrix_led_anim_writer_t *writer) {
+  if (writer == NULL || !writer->in_animation) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  writer->in_animation = false;
+  if (writer->index[writer->animation_count].frame_count == 0) {
+    return ESP_ERR_INVALID_SIZE;
+  }
+
+  writer->animation_count++;
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_anim_writer_close(matrix_led_anim_writer_t *writer) {
+  if (writer == NULL || writer->file == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // 未结束的动画丢弃
+  writer->in_animation = false;
+  bool ok = true;
+
+  uint32_t palette_offset = writer->offset;
+  for (uint16_t i = 0; ok && i < writer->palette_count; i++) {
+    uint8_t rgb[3] = {writer->palette[i].r, writer->palette[i].g,
+                      writer->palette[i].b};
+    ok = anim_write(writer, rgb, sizeof(rgb));
+  }
+
+  uint32_t index_offset = writer->offset;
+  for (uint16_t i = 0; ok && i < writer->animation_count; i++) {
+    const matrix_led_anim_info_t *info = &writer->index[i];
+    uint8_t entry[MATRIX_LED_ANIM_INDEX_ENTRY_SIZE] = {0};
+    memcpy(entry, info->name, MATRIX_LED_MAX_NAME_LEN);
+    anim_put_u32(&entry[32], info->data_offset);
+    anim_put_u32(&entry[36], info->data_size);
+    anim_put_u16(&entry[40], info->frame_count);
+    anim_put_u16(&entry[42], info->frame_delay_ms);
+    entry[44] = info->loop ? ANIM_FLAG_LOOP : 0;
+    ok = anim_write(writer, entry, sizeof(entry));
+  }
+
+  uint8_t header[MATRIX_LED_ANIM_HEADER_SIZE] = {0};
+  memcpy(header, MATRIX_LED_ANIM_MAGIC, 4);
+  anim_put_u16(&header[4], MATRIX_LED_ANIM_VERSION);
+  anim_put_u16(&header[6], MATRIX_LED_ANIM_HEADER_SIZE);
+  header[8] = MATRIX_LED_WIDTH;
+  header[9] = MATRIX_LED_HEIGHT;
+  anim_put_u16(&header[10], writer->palette_count);
+  anim_put_u16(&header[12], writer->animation_count);
+  anim_put_u32(&header[16], palette_offset);
+  anim_put_u32(&header[20], index_offset);
+  anim_put_u32(&header[24], writer->offset);
+
+  if (ok) {
+    ok = fseek(writer->file, 0, SEEK_SET) == 0 &&
+         fwrite(header, 1, sizeof(header), writer->file) == sizeof(header);
+  }
+  if (fclose(writer->file) != 0) {
+    ok = false;
+  }
+  writer->file = NULL;
+
+  return ok ? ESP_OK : ESP_FAIL;
+}
+
+// ==================== 读取接口 ====================
+
+bool matrix_led_anim_is_container(const char *filepath) {
+  if (filepath == NULL) {
+    return false;
+  }
+
+  FILE *file = fopen(filepath, "rb");
+  if (file == NULL) {
+    return false;
+  }
+
+  char magic[4];
+  bool match = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+               memcmp(magic, MATRIX_LED_ANIM_MAGIC, 4) == 0;
+  fclose(file);
+  return match;
+}
+
+esp_err_t matrix_led_anim_open(matrix_led_anim_reader_t *reader,
+                               const char *filepath) {
+  if (reader == NULL || filepath == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(reader, 0, offsetof(matrix_led_anim_reader_t, chunk));
+  reader->file = fopen(filepath, "rb");
+  if (reader->file == NULL) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  esp_err_t ret = ESP_FAIL;
+  uint8_t header[MATRIX_LED_ANIM_HEADER_SIZE];
+  if (fread(header, 1, sizeof(header), reader->file) != sizeof(header) ||
+      memcmp(header, MATRIX_LED_ANIM_MAGIC, 4) != 0) {
+    goto fail;
+  }
+
+  if (anim_get_u16(&header[4]) != MATRIX_LED_ANIM_VERSION) {
+    ret = ESP_ERR_INVALID_VERSION;
+    goto fail;
+  }
+  if (header[8] != MATRIX_LED_WIDTH || header[9] != MATRIX_LED_HEIGHT) {
+    ret = ESP_ERR_INVALID_SIZE;
+    goto fail;
+  }
+
+  uint16_t header_size = anim_get_u16(&header[6]);
+  uint32_t palette_offset = anim_get_u32(&header[16]);
+  uint32_t file_size = anim_get_u32(&header[24]);
+  reader->palette_count = anim_get_u16(&header[10]);
+  reader->animation_count = anim_get_u16(&header[12]);
+  reader->index_offset = anim_get_u32(&header[20]);
+
+  // 截断或字段越界的文件视为损坏
+  if (fseek(reader->file, 0, SEEK_END) != 0 ||
+      ftell(reader->file) < (long)file_size ||
+      header_size < MATRIX_LED_ANIM_HEADER_SIZE ||
+      reader->palette_count > MATRIX_LED_ANIM_MAX_PALETTE ||
+      palette_offset < header_size ||
+      palette_offset + reader->palette_count * 3u > reader->index_offset ||
+      reader->index_offset + (uint32_t)reader->animation_count *
+                                 MATRIX_LED_ANIM_INDEX_ENTRY_SIZE >
+          file_size) {
+    goto fail;
+  }
+
+  if (reader->palette_count > 0) {
+    uint8_t rgb[3];
+    if (fseek(reader->file, (long)palette_offset, SEEK_SET) != 0) {
+      goto fail;
+    }
+    for (uint16_t i = 0; i < reader->palette_count; i++) {
+      if (fread(rgb, 1, sizeof(rgb), reader->file) != sizeof(rgb)) {
+        goto fail;
+      }
+      reader->palette[i].r = rgb[0];
+      reader->palette[i].g = rgb[1];
+      reader->palette[i].b = rgb[2];
+    }
+  }
+
+  return ESP_OK;
+
+fail:
+  fclose(reader->file);
+  reader->file = NULL;
+  return ret;
+}
+
+esp_err_t matrix_led_anim_get_info(matrix_led_anim_reader_t *reader,
+                                   uint16_t index,
+                                   matrix_led_anim_info_t *info) {
+  if (reader == NULL || reader->file == NULL || info == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (index >= reader->animation_count) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  uint8_t entry[MATRIX_LED_ANIM_INDEX_ENTRY_SIZE];
+  long offset = (long)(reader->index_offset +
+                       (uint32_t)index * MATRIX_LED_ANIM_INDEX_ENTRY_SIZE);
+  if (fseek(reader->file, offset, SEEK_SET) != 0 ||
+      fread(entry, 1, sizeof(entry), reader->file) != sizeof(entry)) {
+    return ESP_FAIL;
+  }
+
+  // 读缓冲区内容已经失效
+  reader->chunk_len = 0;
+  reader->chunk_pos = 0;
+
+  memcpy(info->name, entry, MATRIX_LED_MAX_NAME_LEN);
+  info->name[MATRIX_LED_MAX_NAME_LEN - 1] = '\0';
+  info->data_offset = anim_get_u32(&entry[32]);
+  info->data_size = anim_get_u32(&entry[36]);
+  info->frame_count = anim_get_u16(&entry[40]);
+  info->frame_delay_ms = anim_get_u16(&entry[42]);
+  info->loop = (entry[44] & ANIM_FLAG_LOOP) != 0;
+
+  if (info->data_offset < MATRIX_LED_ANIM_HEADER_SIZE ||
+      info->data_offset + info->data_size > reader->index_offset ||
+      info->frame_count == 0) {
+    return ESP_FAIL;
+  }
+
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_anim_select(matrix_led_anim_reader_t *reader,
+                                 const char *name) {
+  if (reader == NULL || reader->file == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // 逐项读取索引，不需要把整个索引装入内存
+  for (uint16_t i = 0; i < reader->animation_count; i++) {
+    matrix_led_anim_info_t info;
+    esp_err_t ret = matrix_led_anim_get_info(reader, i, &info);
+    if (ret != ESP_OK) {
+      return ret;
+    }
+    if (name == NULL || strcmp(info.name, name) == 0) {
+      reader->info = info;
+      matrix_led_anim_rewind(reader);
+      return ESP_OK;
+    }
+  }
+
+  return ESP_ERR_NOT_FOUND;
+}
+
+void matrix_led_anim_rewind(matrix_led_anim_reader_t *reader) {
+  if (reader == NULL || reader->file == NULL) {
+    return;
+  }
+
+  reader->next_frame = 0;
+  reader->read_offset = reader->info.data_offset;
+  reader->chunk_len = 0;
+  reader->chunk_pos = 0;
+  fseek(reader->file, (long)reader->read_offset, SEEK_SET);
+}
+
+esp_err_t matrix_led_anim_read_frame(matrix_led_anim_reader_t *reader,
+                                     matrix_led_color_t *frame,
+                                     uint16_t *delay_ms,
+                                     uint32_t *dirty_rows) {
+  if (reader == NULL || reader->file == NULL || frame == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (reader->next_frame >= reader->info.frame_count) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  uint8_t header[MATRIX_LED_ANIM_FRAME_HEADER_SIZE];
+  uint8_t type;
+  uint16_t frame_delay;
+  uint32_t length;
+  if (!anim_read_bytes(reader, header, sizeof(header)) ||
+      !anim_parse_frame_header(header, &type, &frame_delay, &length)) {
+    return ESP_FAIL;
+  }
+
+  anim_source_t src = {.reader = reader, .remaining = length};
+  if (anim_decode_payload(&src, reader, type, frame, dirty_rows) != ESP_OK) {
+    return ESP_FAIL;
+  }
+
+  reader->next_frame++;
+  reader->read_offset += MATRIX_LED_ANIM_FRAME_HEADER_SIZE + length;
+
+  if (delay_ms != NULL) {
+    *delay_ms = frame_delay != 0 ? frame_delay : reader->info.frame_delay_ms;
+  }
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_anim_read_record(matrix_led_anim_reader_t *reader,
+                                      uint8_t *record, size_t capacity,
+                                      size_t *length) {
+  if (reader == NULL || reader->file == NULL || record == NULL ||
+      length == NULL || capacity < MATRIX_LED_ANIM_MAX_RECORD) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (reader->next_frame >= reader->info.frame_count) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  uint8_t type;
+  uint16_t frame_delay;
+  uint32_t payload;
+  if (!anim_read_bytes(reader, record, MATRIX_LED_ANIM_FRAME_HEADER_SIZE) ||
+      !anim_parse_frame_header(record, &type, &frame_delay, &payload) ||
+      !anim_read_bytes(reader, record + MATRIX_LED_ANIM_FRAME_HEADER_SIZE,
+                       payload)) {
+    return ESP_FAIL;
+  }
+
+  reader->next_frame++;
+  reader->read_offset += MATRIX_LED_ANIM_FRAME_HEADER_SIZE + payload;
+  *length = MATRIX_LED_ANIM_FRAME_HEADER_SIZE + payload;
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_anim_decode_record(const matrix_led_anim_reader_t *reader,
+                                        const uint8_t *record, size_t length,
+                                        matrix_led_color_t *frame,
+                                        uint16_t *delay_ms,
+                                        uint32_t *dirty_rows) {
+  if (reader == NULL || record == NULL || frame == NULL ||
+      length < MATRIX_LED_ANIM_FRAME_HEADER_SIZE) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  uint8_t type;
+  uint16_t frame_delay;
+  uint32_t payload;
+  if (!anim_parse_frame_header(record, &type, &frame_delay, &payload) ||
+      payload != length - MATRIX_LED_ANIM_FRAME_HEADER_SIZE) {
+    return ESP_FAIL;
+  }
+
+  anim_source_t src = {.data = record + MATRIX_LED_ANIM_FRAME_HEADER_SIZE,
+                       .remaining = payload};
+  if (anim_decode_payload(&src, reader, type, frame, dirty_rows) != ESP_OK) {
+    return ESP_FAIL;
+  }
+
+  if (delay_ms != NULL) {
+    *delay_ms = frame_delay != 0 ? frame_delay : reader->info.frame_delay_ms;
+  }
+  return ESP_OK;
+}
+
+void matrix_led_anim_close(matrix_led_anim_reader_t *reader) {
+  if (reader != NULL && reader->file != NULL) {
+    fclose(reader->file);
+    reader->file = NULL;
+  }
+}
+
+// ==================== 预取环 ====================
+
+#define ANIM_RING_MASK (MATRIX_LED_ANIM_RING_SIZE - 1u)
+#define ANIM_RING_WRAP 0xFFFF // 长度字段取该值表示其后直到末尾均为空
+#define ANIM_RING_SLOT_MAX (2u + MATRIX_LED_ANIM_MAX_RECORD)
+
+_Static_assert((MATRIX_LED_ANIM_RING_SIZE & ANIM_RING_MASK) == 0,
+               "ring size must be a power of two");
+_Static_assert(MATRIX_LED_ANIM_RING_SIZE >= 2 * ANIM_RING_SLOT_MAX,
+               "ring must hold at least two worst-case frames");
+
+void matrix_led_anim_ring_init(matrix_led_anim_ring_t *ring) {
+  if (ring == NULL) {
+    return;
+  }
+  ring->head = 0;
+  ring->tail = 0;
+  ring->frames_pushed = 0;
+  ring->frames_popped = 0;
+  ring->finished = false;
+}
+
+esp_err_t matrix_led_anim_ring_fill(matrix_led_anim_ring_t *ring,
+                                    matrix_led_anim_reader_t *reader) {
+  if (ring == NULL || reader == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  while (true) {
+    if (reader->next_frame >= reader->info.frame_count) {
+      if (!reader->info.loop || reader->info.frame_count == 0) {
+        __atomic_store_n(&ring->finished, true, __ATOMIC_RELEASE);
+        return ESP_ERR_NOT_FOUND;
+      }
+      matrix_led_anim_rewind(reader);
+    }
+
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    uint32_t free_bytes = MATRIX_LED_ANIM_RING_SIZE - (head - tail);
+    uint32_t pos = head & ANIM_RING_MASK;
+    uint32_t contiguous = MATRIX_LED_ANIM_RING_SIZE - pos;
+
+    // 末尾放不下最大记录时整段跳过，记录始终连续存放
+    if (contiguous < ANIM_RING_SLOT_MAX) {
+      if (free_bytes < contiguous) {
+        return ESP_ERR_NO_MEM;
+      }
+      if (contiguous >= 2) {
+        anim_put_u16(&ring->buffer[pos], ANIM_RING_WRAP);
+      }
+      __atomic_store_n(&ring->head, head + contiguous, __ATOMIC_RELEASE);
+      continue;
+    }
+
+    if (free_bytes < ANIM_RING_SLOT_MAX) {
+      return ESP_ERR_NO_MEM;
+    }
+
+    size_t length;
+    esp_err_t ret = matrix_led_anim_read_record(
+        reader, &ring->buffer[pos + 2], MATRIX_LED_ANIM_MAX_RECORD, &length);
+    if (ret != ESP_OK) {
+      return ESP_FAIL;
+    }
+    anim_put_u16(&ring->buffer[pos], (uint16_t)length);
+    __atomic_store_n(&ring->frames_pushed, ring->frames_pushed + 1,
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->head, head + 2 + (uint32_t)length,
+                     __ATOMIC_RELEASE);
+  }
+}
+
+const uint8_t *matrix_led_anim_ring_peek(matrix_led_anim_ring_t *ring,
+                                         size_t *length) {
+  if (ring == NULL || length == NULL) {
+    return NULL;
+  }
+
+  while (true) {
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (tail == head) {
+      return NULL;
+    }
+
+    uint32_t pos = tail & ANIM_RING_MASK;
+    uint32_t contiguous = MATRIX_LED_ANIM_RING_SIZE - pos;
+    if (contiguous < 2 ||
+        anim_get_u16(&ring->buffer[pos]) == ANIM_RING_WRAP) {
+      __atomic_store_n(&ring->tail, tail + contiguous, __ATOMIC_RELEASE);
+      continue;
+    }
+
+    *length = anim_get_u16(&ring->buffer[pos]);
+    return &ring->buffer[pos + 2];
+  }
+}
+
+void matrix_led_anim_ring_pop(matrix_led_anim_ring_t *ring) {
+  size_t length;
+  if (matrix_led_anim_ring_peek(ring, &length) == NULL) {
+    return;
+  }
+  __atomic_store_n(&ring->frames_popped, ring->frames_popped + 1,
+                   __ATOMIC_RELAXED);
+  __atomic_store_n(&ring->tail, ring->tail + 2 + (uint32_t)length,
+                   __ATOMIC_RELEASE);
+}
+
+uint32_t matrix_led_anim_ring_frames(const matrix_led_anim_ring_t *ring) {
+  if (ring == NULL) {
+    return 0;
+  }
+  return __atomic_load_n(&ring->frames_pushed, __ATOMIC_RELAXED) -
+         __atomic_load_n(&ring->frames_popped, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,196 @@
+/**
+ * @file matrix_led_correction.c
+ * @brief Matrix LED 融合色彩校正引擎实现
+ */
+
+#include "matrix_led_correction.h"
+
+#include <math.h>
+
+// ==================== 内部辅助函数 ====================
+
+static inline uint8_t correction_clamp_u8(int value) {
+  if (value < 0) {
+    return 0;
+  }
+  if (value > 255) {
+    return 255;
+  }
+  return (uint8_t)value;
+}
+
+static inline int correction_abs(int value) {
+  return value < 0 ? -value : value;
+}
+
+static uint16_t correction_factor_to_q8(float factor) {
+  if (factor <= 0.0f) {
+    return 0;
+  }
+  if (factor >= 2.0f) {
+    return 512;
+  }
+  return (uint16_t)(factor * 256.0f + 0.5f);
+}
+
+/**
+ * @brief 构建单个通道的查找表: 亮度 -> 白点 -> Gamma
+ */
+static void correction_build_channel(uint8_t *lut, uint8_t brightness,
+                                     float scale, const uint8_t *gamma_lut) {
+  for (int v = 0; v < 256; v++) {
+    // 与 matrix_led_apply_brightness 保持一致（截断）
+    int x = v * brightness / 100;
+
+    if (scale >= 0.0f) {
+      x = correction_clamp_u8((int)(x * scale + 0.5f));
+    }
+
+    if (gamma_lut != NULL) {
+      x = gamma_lut[x];
+    }
+
+    lut[v] = (uint8_t)x;
+  }
+}
+
+/**
+ * @brief HSL亮度/饱和度整数路径
+ *
+ * 在色相不变的前提下，通道值相对亮度L的偏移与色度成正比，
+ * 因此缩放L和S可以写成:
+ *   c' = L' + (c - L) * chroma' / chroma
+ * 全程使用 2L = max + min 的整数表示，无需往返HSL浮点转换。
+ */
+static inline matrix_led_color_t
+correction_apply_hsl(const matrix_led_correction_t *corr,
+                     matrix_led_color_t px) {
+  int r = px.r;
+  int g = px.g;
+  int b = px.b;
+
+  int max = r > g ? (r > b ? r : b) : (g > b ? g : b);
+  int min = r < g ? (r < b ? r : b) : (g < b ? g : b);
+  int sum = max + min; // 2L * 255
+  int delta = max - min;
+
+  int sum2 = sum;
+  if (corr->lightness_q8 != 256) {
+    sum2 = (sum * corr->lightness_q8 + 128) >> 8;
+    if (sum2 > 510) {
+      sum2 = 510;
+    }
+  }
+
+  if (delta == 0) {
+    uint8_t v = correction_clamp_u8((sum2 + 1) >> 1);
+    return (matrix_led_color_t){v, v, v};
+  }
+
+  // 当前L下允许的最大色度 (S = 1)
+  int span = 255 - correction_abs(sum - 255);
+  int span2 = 255 - correction_abs(sum2 - 255);
+
+  int chroma = delta;
+  if (corr->saturation_q8 != 256) {
+    chroma = (delta * corr->saturation_q8 + 128) >> 8;
+    if (chroma > span) {
+      chroma = span;
+    }
+  }
+
+  int32_t num = chroma * span2;
+  int32_t den = span * delta;
+
+  matrix_led_color_t out;
+  out.r = correction_clamp_u8((sum2 + (2 * r - sum) * num / den + 1) >> 1);
+  out.g = correction_clamp_u8((sum2 + (2 * g - sum) * num / den + 1) >> 1);
+  out.b = correction_clamp_u8((sum2 + (2 * b - sum) * num / den + 1) >> 1);
+  return out;
+}
+
+// ==================== 公共接口实现 ====================
+
+void matrix_led_correction_build(matrix_led_correction_t *corr,
+                                 const matrix_led_correction_params_t *params) {
+  if (corr == NULL || params == NULL) {
+    return;
+  }
+
+  uint8_t brightness =
+      params->brightness > MATRIX_LED_MAX_BRIGHTNESS ? MATRIX_LED_MAX_BRIGHTNESS
+                                                     : params->brightness;
+
+  uint8_t gamma_lut[256];
+  const uint8_t *gamma_ptr = NULL;
+  if (params->enabled && params->gamma_enabled && params->gamma >= 0.1f) {
+    for (int i = 0; i < 256; i++) {
+      float normalized = i / 255.0f;
+      float corrected = powf(normalized, 1.0f / params->gamma);
+      gamma_lut[i] = (uint8_t)(corrected * 255.0f + 0.5f);
+    }
+    gamma_ptr = gamma_lut;
+  }
+
+  // 负值表示跳过白点校正
+  bool wp = params->enabled && params->white_point_enabled;
+  correction_build_channel(corr->lut_r, brightness,
+                           wp ? params->red_scale : -1.0f, gamma_ptr);
+  correction_build_channel(corr->lut_g, brightness,
+                           wp ? params->green_scale : -1.0f, gamma_ptr);
+  correction_build_channel(corr->lut_b, brightness,
+                           wp ? params->blue_scale : -1.0f, gamma_ptr);
+
+  corr->lightness_q8 = 256;
+  corr->saturation_q8 = 256;
+  if (params->enabled && params->lightness_enabled) {
+    corr->lightness_q8 = correction_factor_to_q8(params->lightness_factor);
+  }
+  if (params->enabled && params->saturation_enabled) {
+    corr->saturation_q8 = correction_factor_to_q8(params->saturation_factor);
+  }
+  corr->hsl_enabled = params->enabled &&
+                      (params->lightness_enabled || params->saturation_enabled);
+
+  corr->brightness = brightness;
+  corr->generation++;
+}
+
+matrix_led_color_t
+matrix_led_correction_apply_pixel(const matrix_led_correction_t *corr,
+                                  matrix_led_color_t color) {
+  matrix_led_color_t out = {corr->lut_r[color.r], corr->lut_g[color.g],
+                            corr->lut_b[color.b]};
+  if (corr->hsl_enabled) {
+    out = correction_apply_hsl(corr, out);
+  }
+  return out;
+}
+
+void matrix_led_correction_apply(const matrix_led_correction_t *corr,
+                                 const matrix_led_color_t *input,
+                                 matrix_led_color_t *output, size_t count) {
+  if (corr == NULL || input == NULL || output == NULL) {
+    return;
+  }
+
+  const uint8_t *lut_r = corr->lut_r;
+  const uint8_t *lut_g = corr->lut_g;
+  const uint8_t *lut_b = corr->lut_b;
+
+  if (!corr->hsl_enabled) {
+    for (size_t i = 0; i < count; i++) {
+      matrix_led_color_t px = input[i];
+      output[i].r = lut_r[px.r];
+      output[i].g = lut_g[px.g];
+      output[i].b = lut_b[px.b];
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    matrix_led_color_t px = input[i];
+    matrix_led_color_t mapped = {lut_r[px.r], lut_g[px.g], lut_b[px.b]};
+    output[i] = correction_apply_hsl(corr, mapped);
+  }
+}
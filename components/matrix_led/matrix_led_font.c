@@ -0,0 +1,310 @@
+/**
+ * @file matrix_led_font.c
+ * @brief Matrix LED 点阵字体和文本排版实现
+ */
+
+#include "matrix_led_font.h"
+
+#include <string.h>
+
+_Static_assert(MATRIX_LED_WIDTH <= 32, "row masks hold 32 columns");
+_Static_assert(MATRIX_LED_HEIGHT <= 32, "dirty row mask holds 32 rows");
+
+// ==================== 内部工具 ====================
+
+/**
+ * @brief 字符对应的字形和宽度，不在字体范围内的字符显示为 '?'
+ */
+static const uint8_t *font_glyph(const matrix_led_font_t *font, uint8_t ch,
+                                 uint8_t *width) {
+  if (ch < font->first || ch > font->last) {
+    ch = (font->first <= '?' && font->last >= '?') ? '?' : font->first;
+  }
+  uint32_t index = ch - font->first;
+  *width = font->widths ? font->widths[index] : font->width;
+  return &font->bitmap[index * font->height];
+}
+
+/**
+ * @brief 宽度为 n 的左对齐（高位）掩码
+ */
+static inline uint32_t font_left_mask(uint32_t n) {
+  return n >= 32 ? 0xFFFFFFFFu : n == 0 ? 0 : ~(0xFFFFFFFFu >> n);
+}
+
+/**
+ * @brief 按行位掩码写入一行像素（bit31对应 x0）
+ */
+static inline void font_blit_row(matrix_led_color_t *row, uint32_t x0,
+                                 uint32_t bits, matrix_led_color_t color) {
+  while (bits != 0) {
+    uint32_t x = (uint32_t)__builtin_clz(bits);
+    row[x0 + x] = color;
+    bits &= ~(0x80000000u >> x);
+  }
+}
+
+/**
+ * @brief 按行位掩码写入 n 个像素，置位为文字颜色，其余为背景
+ */
+static inline void font_fill_row(matrix_led_color_t *row, uint32_t n,
+                                 uint32_t bits, matrix_led_color_t color,
+                                 matrix_led_color_t background) {
+  for (uint32_t x = 0; x < n; x++) {
+    row[x] = (bits & (0x80000000u >> x)) ? color : background;
+  }
+}
+
+/**
+ * @brief 区域裁剪到屏幕范围
+ */
+static bool font_clip_rect(const matrix_led_rect_t *rect, uint32_t *x0,
+                           uint32_t *y0, uint32_t *x1, uint32_t *y1) {
+  if (rect == NULL) {
+    *x0 = 0;
+    *y0 = 0;
+    *x1 = MATRIX_LED_WIDTH;
+    *y1 = MATRIX_LED_HEIGHT;
+    return true;
+  }
+  *x0 = rect->x;
+  *y0 = rect->y;
+  *x1 = (uint32_t)rect->x + rect->width;
+  *y1 = (uint32_t)rect->y + rect->height;
+  if (*x1 > MATRIX_LED_WIDTH) {
+    *x1 = MATRIX_LED_WIDTH;
+  }
+  if (*y1 > MATRIX_LED_HEIGHT) {
+    *y1 = MATRIX_LED_HEIGHT;
+  }
+  return *x0 < *x1 && *y0 < *y1;
+}
+
+// ==================== 字体 ====================
+
+uint16_t matrix_led_font_text_width(const matrix_led_font_t *font,
+                                    const char *text) {
+  if (font == NULL || text == NULL || *text == '\0') {
+    return 0;
+  }
+
+  uint32_t width = 0;
+  for (const char *p = text; *p != '\0'; p++) {
+    uint8_t w;
+    font_glyph(font, (uint8_t)*p, &w);
+    width += w + font->spacing;
+  }
+  width -= font->spacing;
+  return width > 0xFFFF ? 0xFFFF : (uint16_t)width;
+}
+
+uint32_t matrix_led_font_draw(matrix_led_color_t *frame,
+                              const matrix_led_font_t *font, int16_t x,
+                              int16_t y, const char *text,
+                              matrix_led_color_t color,
+                              const matrix_led_rect_t *clip) {
+  uint32_t cx0, cy0, cx1, cy1;
+  if (frame == NULL || font == NULL || text == NULL ||
+      !font_clip_rect(clip, &cx0, &cy0, &cx1, &cy1)) {
+    return 0;
+  }
+
+  // 先把整行文字拼成每行一个位掩码（bit31为第0列），再按行写入
+  uint32_t rows[MATRIX_LED_FONT_MAX_HEIGHT] = {0};
+  int32_t pen = x;
+  for (const char *p = text; *p != '\0' && pen < (int32_t)cx1; p++) {
+    uint8_t w;
+    const uint8_t *glyph = font_glyph(font, (uint8_t)*p, &w);
+    if (pen + w > (int32_t)cx0) {
+      for (uint32_t r = 0; r < font->height; r++) {
+        uint32_t bits = (uint32_t)glyph[r] << 24;
+        if (pen >= 0) {
+          rows[r] |= pen < 32 ? bits >> pen : 0;
+        } else {
+          rows[r] |= -pen < 32 ? bits << -pen : 0;
+        }
+      }
+    }
+    pen += w + font->spacing;
+  }
+
+  uint32_t column_mask = font_left_mask(cx1) & ~font_left_mask(cx0);
+  uint32_t dirty_rows = 0;
+  for (uint32_t r = 0; r < font->height; r++) {
+    int32_t py = y + (int32_t)r;
+    uint32_t bits = rows[r] & column_mask;
+    if (py < (int32_t)cy0 || py >= (int32_t)cy1 || bits == 0) {
+      continue;
+    }
+    font_blit_row(&frame[py * MATRIX_LED_WIDTH], 0, bits, color);
+    dirty_rows |= 1u << py;
+  }
+  return dirty_rows;
+}
+
+// ==================== 文本对象 ====================
+
+/**
+ * @brief 从位图缓存读取从第 column 列开始的 n 列（按滚动周期回绕，n <= 32）
+ */
+static uint32_t text_strip_bits(const matrix_led_text_t *text, uint32_t row,
+                                uint32_t column, uint32_t n) {
+  const uint32_t *words = text->strip[row];
+  uint32_t result = 0;
+  uint32_t filled = 0;
+
+  while (filled < n) {
+    uint32_t c = (column + filled) % text->period;
+    uint32_t run;
+    if (c >= text->text_width) {
+      run = text->period - c; // 文本之间的空白
+    } else {
+      run = text->text_width - c;
+      uint32_t shift = c & 31;
+      uint32_t bits = words[c >> 5] << shift;
+      if (shift != 0) {
+        bits |= words[(c >> 5) + 1] >> (32 - shift);
+      }
+      if (run > 32) {
+        run = 32;
+      }
+      result |= (bits & font_left_mask(run)) >> filled;
+    }
+    filled += run;
+  }
+  return result & font_left_mask(n);
+}
+
+/**
+ * @brief 把整行文本光栅化到位图缓存
+ */
+static void text_rasterize(matrix_led_text_t *text) {
+  const matrix_led_font_t *font = text->font;
+  const uint32_t capacity = (MATRIX_LED_TEXT_STRIP_WORDS - 1) * 32;
+
+  memset(text->strip, 0, sizeof(text->strip));
+  uint32_t pen = 0;
+  for (const char *p = text->text; *p != '\0'; p++) {
+    uint8_t w;
+    const uint8_t *glyph = font_glyph(font, (uint8_t)*p, &w);
+    if (pen + w > capacity) {
+      break;
+    }
+    for (uint32_t r = 0; r < font->height; r++) {
+      uint32_t bits = (uint32_t)glyph[r] << 24;
+      uint32_t shift = pen & 31;
+      text->strip[r][pen >> 5] |= bits >> shift;
+      if (shift != 0) {
+        text->strip[r][(pen >> 5) + 1] |= bits << (32 - shift);
+      }
+    }
+    pen += w + font->spacing;
+  }
+
+  text->text_width = (uint16_t)(pen > 0 ? pen - font->spacing : 0);
+  text->period = text->text_width + text->area.width;
+  text->offset = 0;
+  text->drawn = false;
+}
+
+esp_err_t matrix_led_text_init(matrix_led_text_t *text,
+                               const matrix_led_font_t *font,
+                               const matrix_led_rect_t *area,
+                               matrix_led_color_t color,
+                               matrix_led_color_t background) {
+  uint32_t x0, y0, x1, y1;
+  if (text == NULL || font == NULL || area == NULL ||
+      font->height > MATRIX_LED_FONT_MAX_HEIGHT ||
+      font->width > MATRIX_LED_FONT_MAX_WIDTH ||
+      !font_clip_rect(area, &x0, &y0, &x1, &y1)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(text, 0, sizeof(*text));
+  text->font = font;
+  text->area = (matrix_led_rect_t){(uint8_t)x0, (uint8_t)y0,
+                                   (uint8_t)(x1 - x0), (uint8_t)(y1 - y0)};
+  text->color = color;
+  text->background = background;
+  text_rasterize(text);
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_text_set(matrix_led_text_t *text, const char *str) {
+  if (text == NULL || text->font == NULL || str == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // 内容未变化时沿用缓存和滚动位置
+  if (strncmp(text->text, str, MATRIX_LED_TEXT_MAX_LEN) == 0) {
+    return ESP_OK;
+  }
+
+  strncpy(text->text, str, MATRIX_LED_TEXT_MAX_LEN);
+  text->text[MATRIX_LED_TEXT_MAX_LEN] = '\0';
+  text_rasterize(text);
+  return ESP_OK;
+}
+
+uint32_t matrix_led_text_render(matrix_led_text_t *text,
+                                matrix_led_color_t *frame) {
+  if (text == NULL || text->font == NULL || frame == NULL) {
+    return 0;
+  }
+
+  const matrix_led_rect_t *a = &text->area;
+  uint32_t dirty_rows = 0;
+  for (uint32_t r = 0; r < a->height; r++) {
+    uint32_t bits = r < text->font->height
+                        ? text_strip_bits(text, r, text->offset, a->width)
+                        : 0;
+    font_fill_row(&frame[(a->y + r) * MATRIX_LED_WIDTH + a->x], a->width, bits,
+                  text->color, text->background);
+    dirty_rows |= 1u << (a->y + r);
+  }
+
+  text->drawn = true;
+  return dirty_rows;
+}
+
+uint32_t matrix_led_text_scroll(matrix_led_text_t *text,
+                                matrix_led_color_t *frame, uint16_t step) {
+  if (text == NULL || text->font == NULL || frame == NULL ||
+      text->period == 0) {
+    return 0;
+  }
+
+  const matrix_led_rect_t *a = &text->area;
+  uint16_t old_offset = text->offset;
+  text->offset = (uint16_t)((old_offset + step) % text->period);
+
+  if (!text->drawn || step >= a->width) {
+    return matrix_led_text_render(text, frame);
+  }
+
+  // 区域整体左移 step 列，只绘制右侧新露出的列；前后内容相同的行不动
+  uint32_t rows = text->font->height < a->height ? text->font->height
+                                                 : a->height;
+  uint32_t keep = a->width - step;
+  uint32_t dirty_rows = 0;
+  for (uint32_t r = 0; r < rows; r++) {
+    uint32_t before = text_strip_bits(text, r, old_offset, a->width);
+    uint32_t after = text_strip_bits(text, r, text->offset, a->width);
+    if (before == after) {
+      continue;
+    }
+
+    matrix_led_color_t *row = &frame[(a->y + r) * MATRIX_LED_WIDTH + a->x];
+    memmove(row, row + step, keep * sizeof(matrix_led_color_t));
+    font_fill_row(row + keep, step, after << keep, text->color,
+                  text->background);
+    dirty_rows |= 1u << (a->y + r);
+  }
+  return dirty_rows;
+}
+
+void matrix_led_text_invalidate(matrix_led_text_t *text) {
+  if (text != NULL) {
+    text->drawn = false;
+  }
+}
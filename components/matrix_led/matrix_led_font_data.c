@@ -0,0 +1,436 @@
+/**
+ * @file matrix_led_font_data.c
+ * @brief Matrix LED 内置点阵字体数据
+ *
+ * 字形按行打包为1bpp，每行一个字节，bit7为最左列。字符范围 0x20-0x7F，
+ * 其中 0x7F 为度数符号（MATRIX_LED_FONT_DEGREE）。
+ */
+
+#include "matrix_led_font.h"
+
+// ==================== 5x7 比例字体 ====================
+
+static const uint8_t s_font_5x7_bitmap[] = {
+    // ' ' (0x20)
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '!' (0x21)
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x00, 0x80,
+    // '"' (0x22)
+    0xA0, 0xA0, 0xA0, 0x00, 0x00, 0x00, 0x00,
+    // '#' (0x23)
+    0x50, 0x50, 0xF8, 0x50, 0xF8, 0x50, 0x50,
+    // '$' (0x24)
+    0x20, 0x78, 0xA0, 0x70, 0x28, 0xF0, 0x20,
+    // '%' (0x25)
+    0xC0, 0xC8, 0x10, 0x20, 0x40, 0x98, 0x18,
+    // '&' (0x26)
+    0x60, 0x90, 0xA0, 0x40, 0xA8, 0x90, 0x68,
+    // '\'' (0x27)
+    0x80, 0x80, 0x80, 0x00, 0x00, 0x00, 0x00,
+    // '(' (0x28)
+    0x20, 0x40, 0x80, 0x80, 0x80, 0x40, 0x20,
+    // ')' (0x29)
+    0x80, 0x40, 0x20, 0x20, 0x20, 0x40, 0x80,
+    // '*' (0x2A)
+    0x00, 0x20, 0xA8, 0x70, 0xA8, 0x20, 0x00,
+    // '+' (0x2B)
+    0x00, 0x20, 0x20, 0xF8, 0x20, 0x20, 0x00,
+    // ',' (0x2C)
+    0x00, 0x00, 0x00, 0x00, 0xC0, 0x40, 0x80,
+    // '-' (0x2D)
+    0x00, 0x00, 0x00, 0xF8, 0x00, 0x00, 0x00,
+    // '.' (0x2E)
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xC0, 0xC0,
+    // '/' (0x2F)
+    0x00, 0x08, 0x10, 0x20, 0x40, 0x80, 0x00,
+    // '0' (0x30)
+    0x70, 0x88, 0x98, 0xA8, 0xC8, 0x88, 0x70,
+    // '1' (0x31)
+    0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70,
+    // '2' (0x32)
+    0x70, 0x88, 0x08, 0x10, 0x20, 0x40, 0xF8,
+    // '3' (0x33)
+    0xF8, 0x10, 0x20, 0x10, 0x08, 0x88, 0x70,
+    // '4' (0x34)
+    0x10, 0x30, 0x50, 0x90, 0xF8, 0x10, 0x10,
+    // '5' (0x35)
+    0xF8, 0x80, 0xF0, 0x08, 0x08, 0x88, 0x70,
+    // '6' (0x36)
+    0x30, 0x40, 0x80, 0xF0, 0x88, 0x88, 0x70,
+    // '7' (0x37)
+    0xF8, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40,
+    // '8' (0x38)
+    0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70,
+    // '9' (0x39)
+    0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0x60,
+    // ':' (0x3A)
+    0x00, 0xC0, 0xC0, 0x00, 0xC0, 0xC0, 0x00,
+    // ';' (0x3B)
+    0x00, 0xC0, 0xC0, 0x00, 0xC0, 0x40, 0x80,
+    // '<' (0x3C)
+    0x10, 0x20, 0x40, 0x80, 0x40, 0x20, 0x10,
+    // '=' (0x3D)
+    0x00, 0x00, 0xF8, 0x00, 0xF8, 0x00, 0x00,
+    // '>' (0x3E)
+    0x80, 0x40, 0x20, 0x10, 0x20, 0x40, 0x80,
+    // '?' (0x3F)
+    0x70, 0x88, 0x08, 0x10, 0x20, 0x00, 0x20,
+    // '@' (0x40)
+    0x70, 0x88, 0x08, 0x68, 0xA8, 0xA8, 0x70,
+    // 'A' (0x41)
+    0x70, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88,
+    // 'B' (0x42)
+    0xF0, 0x88, 0x88, 0xF0, 0x88, 0x88, 0xF0,
+    // 'C' (0x43)
+    0x70, 0x88, 0x80, 0x80, 0x80, 0x88, 0x70,
+    // 'D' (0x44)
+    0xE0, 0x90, 0x88, 0x88, 0x88, 0x90, 0xE0,
+    // 'E' (0x45)
+    0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0xF8,
+    // 'F' (0x46)
+    0xF8, 0x80, 0x80, 0xF0, 0x80, 0x80, 0x80,
+    // 'G' (0x47)
+    0x70, 0x88, 0x80, 0xB8, 0x88, 0x88, 0x78,
+    // 'H' (0x48)
+    0x88, 0x88, 0x88, 0xF8, 0x88, 0x88, 0x88,
+    // 'I' (0x49)
+    0xE0, 0x40, 0x40, 0x40, 0x40, 0x40, 0xE0,
+    // 'J' (0x4A)
+    0x38, 0x10, 0x10, 0x10, 0x10, 0x90, 0x60,
+    // 'K' (0x4B)
+    0x88, 0x90, 0xA0, 0xC0, 0xA0, 0x90, 0x88,
+    // 'L' (0x4C)
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xF8,
+    // 'M' (0x4D)
+    0x88, 0xD8, 0xA8, 0xA8, 0x88, 0x88, 0x88,
+    // 'N' (0x4E)
+    0x88, 0x88, 0xC8, 0xA8, 0x98, 0x88, 0x88,
+    // 'O' (0x4F)
+    0x70, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70,
+    // 'P' (0x50)
+    0xF0, 0x88, 0x88, 0xF0, 0x80, 0x80, 0x80,
+    // 'Q' (0x51)
+    0x70, 0x88, 0x88, 0x88, 0xA8, 0x90, 0x68,
+    // 'R' (0x52)
+    0xF0, 0x88, 0x88, 0xF0, 0xA0, 0x90, 0x88,
+    // 'S' (0x53)
+    0x78, 0x80, 0x80, 0x70, 0x08, 0x08, 0xF0,
+    // 'T' (0x54)
+    0xF8, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+    // 'U' (0x55)
+    0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70,
+    // 'V' (0x56)
+    0x88, 0x88, 0x88, 0x88, 0x88, 0x50, 0x20,
+    // 'W' (0x57)
+    0x88, 0x88, 0x88, 0xA8, 0xA8, 0xA8, 0x50,
+    // 'X' (0x58)
+    0x88, 0x88, 0x50, 0x20, 0x50, 0x88, 0x88,
+    // 'Y' (0x59)
+    0x88, 0x88, 0x88, 0x50, 0x20, 0x20, 0x20,
+    // 'Z' (0x5A)
+    0xF8, 0x08, 0x10, 0x20, 0x40, 0x80, 0xF8,
+    // '[' (0x5B)
+    0xE0, 0x80, 0x80, 0x80, 0x80, 0x80, 0xE0,
+    // '\\' (0x5C)
+    0x00, 0x80, 0x40, 0x20, 0x10, 0x08, 0x00,
+    // ']' (0x5D)
+    0xE0, 0x20, 0x20, 0x20, 0x20, 0x20, 0xE0,
+    // '^' (0x5E)
+    0x20, 0x50, 0x88, 0x00, 0x00, 0x00, 0x00,
+    // '_' (0x5F)
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8,
+    // '`' (0x60)
+    0x80, 0x40, 0x20, 0x00, 0x00, 0x00, 0x00,
+    // 'a' (0x61)
+    0x00, 0x00, 0x70, 0x08, 0x78, 0x88, 0x78,
+    // 'b' (0x62)
+    0x80, 0x80, 0xB0, 0xC8, 0x88, 0x88, 0xF0,
+    // 'c' (0x63)
+    0x00, 0x00, 0x70, 0x80, 0x80, 0x88, 0x70,
+    // 'd' (0x64)
+    0x08, 0x08, 0x68, 0x98, 0x88, 0x88, 0x78,
+    // 'e' (0x65)
+    0x00, 0x00, 0x70, 0x88, 0xF8, 0x80, 0x70,
+    // 'f' (0x66)
+    0x30, 0x48, 0x40, 0xE0, 0x40, 0x40, 0x40,
+    // 'g' (0x67)
+    0x00, 0x78, 0x88, 0x88, 0x78, 0x08, 0x70,
+    // 'h' (0x68)
+    0x80, 0x80, 0xB0, 0xC8, 0x88, 0x88, 0x88,
+    // 'i' (0x69)
+    0x40, 0x00, 0xC0, 0x40, 0x40, 0x40, 0xE0,
+    // 'j' (0x6A)
+    0x10, 0x00, 0x30, 0x10, 0x10, 0x90, 0x60,
+    // 'k' (0x6B)
+    0x80, 0x80, 0x90, 0xA0, 0xC0, 0xA0, 0x90,
+    // 'l' (0x6C)
+    0xC0, 0x40, 0x40, 0x40, 0x40, 0x40, 0xE0,
+    // 'm' (0x6D)
+    0x00, 0x00, 0xD0, 0xA8, 0xA8, 0x88, 0x88,
+    // 'n' (0x6E)
+    0x00, 0x00, 0xB0, 0xC8, 0x88, 0x88, 0x88,
+    // 'o' (0x6F)
+    0x00, 0x00, 0x70, 0x88, 0x88, 0x88, 0x70,
+    // 'p' (0x70)
+    0x00, 0x00, 0xF0, 0x88, 0xF0, 0x80, 0x80,
+    // 'q' (0x71)
+    0x00, 0x00, 0x68, 0x98, 0x78, 0x08, 0x08,
+    // 'r' (0x72)
+    0x00, 0x00, 0xB0, 0xC8, 0x80, 0x80, 0x80,
+    // 's' (0x73)
+    0x00, 0x00, 0x70, 0x80, 0x70, 0x08, 0xF0,
+    // 't' (0x74)
+    0x40, 0x40, 0xE0, 0x40, 0x40, 0x48, 0x30,
+    // 'u' (0x75)
+    0x00, 0x00, 0x88, 0x88, 0x88, 0x98, 0x68,
+    // 'v' (0x76)
+    0x00, 0x00, 0x88, 0x88, 0x88, 0x50, 0x20,
+    // 'w' (0x77)
+    0x00, 0x00, 0x88, 0x88, 0xA8, 0xA8, 0x50,
+    // 'x' (0x78)
+    0x00, 0x00, 0x88, 0x50, 0x20, 0x50, 0x88,
+    // 'y' (0x79)
+    0x00, 0x00, 0x88, 0x88, 0x78, 0x08, 0x70,
+    // 'z' (0x7A)
+    0x00, 0x00, 0xF8, 0x10, 0x20, 0x40, 0xF8,
+    // '{' (0x7B)
+    0x20, 0x40, 0x40, 0x80, 0x40, 0x40, 0x20,
+    // '|' (0x7C)
+    0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80,
+    // '}' (0x7D)
+    0x80, 0x40, 0x40, 0x20, 0x40, 0x40, 0x80,
+    // '~' (0x7E)
+    0x00, 0x00, 0x40, 0xA8, 0x10, 0x00, 0x00,
+    // degree (0x7F)
+    0x60, 0x90, 0x90, 0x60, 0x00, 0x00, 0x00,
+};
+
+static const uint8_t s_font_5x7_widths[] = {
+    2, 1, 3, 5, 5, 5, 5, 1, 3, 3, 5, 5, 2, 5, 2, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 2, 2, 4, 5, 4, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 3, 5, 5, 5, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 3, 5, 3, 5, 5,
+    3, 5, 5, 5, 5, 5, 5, 5, 5, 3, 4, 4, 3, 5, 5, 5,
+    5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 3, 1, 3, 5, 4,
+};
+
+const matrix_led_font_t matrix_led_font_5x7 = {
+    .bitmap = s_font_5x7_bitmap,
+    .widths = s_font_5x7_widths,
+    .width = 5,
+    .height = 7,
+    .spacing = 1,
+    .first = 0x20,
+    .last = 0x7F,
+    .name = "5x7",
+};
+
+// ==================== 8x8 等宽粗体 ====================
+
+// 由5x7字形水平加粗为6x7，居中放入8x8单元
+
+static const uint8_t s_font_8x8_bitmap[] = {
+    // ' ' (0x20)
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    // '!' (0x21)
+    0x00, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00, 0x18,
+    // '"' (0x22)
+    0x00, 0x3C, 0x3C, 0x3C, 0x00, 0x00, 0x00, 0x00,
+    // '#' (0x23)
+    0x00, 0x3C, 0x3C, 0x7E, 0x3C, 0x7E, 0x3C, 0x3C,
+    // '$' (0x24)
+    0x00, 0x18, 0x3E, 0x78, 0x3C, 0x1E, 0x7C, 0x18,
+    // '%' (0x25)
+    0x00, 0x70, 0x76, 0x0C, 0x18, 0x30, 0x6E, 0x0E,
+    // '&' (0x26)
+    0x00, 0x38, 0x6C, 0x78, 0x30, 0x7E, 0x6C, 0x3E,
+    // '\'' (0x27)
+    0x00, 0x18, 0x18, 0x18, 0x00, 0x00, 0x00, 0x00,
+    // '(' (0x28)
+    0x00, 0x0C, 0x18, 0x30, 0x30, 0x30, 0x18, 0x0C,
+    // ')' (0x29)
+    0x00, 0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x18, 0x30,
+    // '*' (0x2A)
+    0x00, 0x00, 0x18, 0x7E, 0x3C, 0x7E, 0x18, 0x00,
+    // '+' (0x2B)
+    0x00, 0x00, 0x18, 0x18, 0x7E, 0x18, 0x18, 0x00,
+    // ',' (0x2C)
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x18, 0x30,
+    // '-' (0x2D)
+    0x00, 0x00, 0x00, 0x00, 0x7E, 0x00, 0x00, 0x00,
+    // '.' (0x2E)
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x38,
+    // '/' (0x2F)
+    0x00, 0x00, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x00,
+    // '0' (0x30)
+    0x00, 0x3C, 0x66, 0x6E, 0x7E, 0x76, 0x66, 0x3C,
+    // '1' (0x31)
+    0x00, 0x18, 0x38, 0x18, 0x18, 0x18, 0x18, 0x3C,
+    // '2' (0x32)
+    0x00, 0x3C, 0x66, 0x06, 0x0C, 0x18, 0x30, 0x7E,
+    // '3' (0x33)
+    0x00, 0x7E, 0x0C, 0x18, 0x0C, 0x06, 0x66, 0x3C,
+    // '4' (0x34)
+    0x00, 0x0C, 0x1C, 0x3C, 0x6C, 0x7E, 0x0C, 0x0C,
+    // '5' (0x35)
+    0x00, 0x7E, 0x60, 0x7C, 0x06, 0x06, 0x66, 0x3C,
+    // '6' (0x36)
+    0x00, 0x1C, 0x30, 0x60, 0x7C, 0x66, 0x66, 0x3C,
+    // '7' (0x37)
+    0x00, 0x7E, 0x06, 0x0C, 0x18, 0x30, 0x30, 0x30,
+    // '8' (0x38)
+    0x00, 0x3C, 0x66, 0x66, 0x3C, 0x66, 0x66, 0x3C,
+    // '9' (0x39)
+    0x00, 0x3C, 0x66, 0x66, 0x3E, 0x06, 0x0C, 0x38,
+    // ':' (0x3A)
+    0x00, 0x00, 0x38, 0x38, 0x00, 0x38, 0x38, 0x00,
+    // ';' (0x3B)
+    0x00, 0x00, 0x38, 0x38, 0x00, 0x38, 0x18, 0x30,
+    // '<' (0x3C)
+    0x00, 0x0C, 0x18, 0x30, 0x60, 0x30, 0x18, 0x0C,
+    // '=' (0x3D)
+    0x00, 0x00, 0x00, 0x7E, 0x00, 0x7E, 0x00, 0x00,
+    // '>' (0x3E)
+    0x00, 0x30, 0x18, 0x0C, 0x06, 0x0C, 0x18, 0x30,
+    // '?' (0x3F)
+    0x00, 0x3C, 0x66, 0x06, 0x0C, 0x18, 0x00, 0x18,
+    // '@' (0x40)
+    0x00, 0x3C, 0x66, 0x06, 0x3E, 0x7E, 0x7E, 0x3C,
+    // 'A' (0x41)
+    0x00, 0x3C, 0x66, 0x66, 0x7E, 0x66, 0x66, 0x66,
+    // 'B' (0x42)
+    0x00, 0x7C, 0x66, 0x66, 0x7C, 0x66, 0x66, 0x7C,
+    // 'C' (0x43)
+    0x00, 0x3C, 0x66, 0x60, 0x60, 0x60, 0x66, 0x3C,
+    // 'D' (0x44)
+    0x00, 0x78, 0x6C, 0x66, 0x66, 0x66, 0x6C, 0x78,
+    // 'E' (0x45)
+    0x00, 0x7E, 0x60, 0x60, 0x7C, 0x60, 0x60, 0x7E,
+    // 'F' (0x46)
+    0x00, 0x7E, 0x60, 0x60, 0x7C, 0x60, 0x60, 0x60,
+    // 'G' (0x47)
+    0x00, 0x3C, 0x66, 0x60, 0x7E, 0x66, 0x66, 0x3E,
+    // 'H' (0x48)
+    0x00, 0x66, 0x66, 0x66, 0x7E, 0x66, 0x66, 0x66,
+    // 'I' (0x49)
+    0x00, 0x3C, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3C,
+    // 'J' (0x4A)
+    0x00, 0x1E, 0x0C, 0x0C, 0x0C, 0x0C, 0x6C, 0x38,
+    // 'K' (0x4B)
+    0x00, 0x66, 0x6C, 0x78, 0x70, 0x78, 0x6C, 0x66,
+    // 'L' (0x4C)
+    0x00, 0x60, 0x60, 0x60, 0x60, 0x60, 0x60, 0x7E,
+    // 'M' (0x4D)
+    0x00, 0x66, 0x7E, 0x7E, 0x7E, 0x66, 0x66, 0x66,
+    // 'N' (0x4E)
+    0x00, 0x66, 0x66, 0x76, 0x7E, 0x6E, 0x66, 0x66,
+    // 'O' (0x4F)
+    0x00, 0x3C, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C,
+    // 'P' (0x50)
+    0x00, 0x7C, 0x66, 0x66, 0x7C, 0x60, 0x60, 0x60,
+    // 'Q' (0x51)
+    0x00, 0x3C, 0x66, 0x66, 0x66, 0x7E, 0x6C, 0x3E,
+    // 'R' (0x52)
+    0x00, 0x7C, 0x66, 0x66, 0x7C, 0x78, 0x6C, 0x66,
+    // 'S' (0x53)
+    0x00, 0x3E, 0x60, 0x60, 0x3C, 0x06, 0x06, 0x7C,
+    // 'T' (0x54)
+    0x00, 0x7E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+    // 'U' (0x55)
+    0x00, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C,
+    // 'V' (0x56)
+    0x00, 0x66, 0x66, 0x66, 0x66, 0x66, 0x3C, 0x18,
+    // 'W' (0x57)
+    0x00, 0x66, 0x66, 0x66, 0x7E, 0x7E, 0x7E, 0x3C,
+    // 'X' (0x58)
+    0x00, 0x66, 0x66, 0x3C, 0x18, 0x3C, 0x66, 0x66,
+    // 'Y' (0x59)
+    0x00, 0x66, 0x66, 0x66, 0x3C, 0x18, 0x18, 0x18,
+    // 'Z' (0x5A)
+    0x00, 0x7E, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x7E,
+    // '[' (0x5B)
+    0x00, 0x3C, 0x30, 0x30, 0x30, 0x30, 0x30, 0x3C,
+    // '\\' (0x5C)
+    0x00, 0x00, 0x60, 0x30, 0x18, 0x0C, 0x06, 0x00,
+    // ']' (0x5D)
+    0x00, 0x3C, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x3C,
+    // '^' (0x5E)
+    0x00, 0x18, 0x3C, 0x66, 0x00, 0x00, 0x00, 0x00,
+    // '_' (0x5F)
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x7E,
+    // '`' (0x60)
+    0x00, 0x30, 0x18, 0x0C, 0x00, 0x00, 0x00, 0x00,
+    // 'a' (0x61)
+    0x00, 0x00, 0x00, 0x3C, 0x06, 0x3E, 0x66, 0x3E,
+    // 'b' (0x62)
+    0x00, 0x60, 0x60, 0x7C, 0x76, 0x66, 0x66, 0x7C,
+    // 'c' (0x63)
+    0x00, 0x00, 0x00, 0x3C, 0x60, 0x60, 0x66, 0x3C,
+    // 'd' (0x64)
+    0x00, 0x06, 0x06, 0x3E, 0x6E, 0x66, 0x66, 0x3E,
+    // 'e' (0x65)
+    0x00, 0x00, 0x00, 0x3C, 0x66, 0x7E, 0x60, 0x3C,
+    // 'f' (0x66)
+    0x00, 0x1C, 0x36, 0x30, 0x78, 0x30, 0x30, 0x30,
+    // 'g' (0x67)
+    0x00, 0x00, 0x3E, 0x66, 0x66, 0x3E, 0x06, 0x3C,
+    // 'h' (0x68)
+    0x00, 0x60, 0x60, 0x7C, 0x76, 0x66, 0x66, 0x66,
+    // 'i' (0x69)
+    0x00, 0x18, 0x00, 0x38, 0x18, 0x18, 0x18, 0x3C,
+    // 'j' (0x6A)
+    0x00, 0x0C, 0x00, 0x1C, 0x0C, 0x0C, 0x6C, 0x38,
+    // 'k' (0x6B)
+    0x00, 0x60, 0x60, 0x6C, 0x78, 0x70, 0x78, 0x6C,
+    // 'l' (0x6C)
+    0x00, 0x38, 0x18, 0x18, 0x18, 0x18, 0x18, 0x3C,
+    // 'm' (0x6D)
+    0x00, 0x00, 0x00, 0x7C, 0x7E, 0x7E, 0x66, 0x66,
+    // 'n' (0x6E)
+    0x00, 0x00, 0x00, 0x7C, 0x76, 0x66, 0x66, 0x66,
+    // 'o' (0x6F)
+    0x00, 0x00, 0x00, 0x3C, 0x66, 0x66, 0x66, 0x3C,
+    // 'p' (0x70)
+    0x00, 0x00, 0x00, 0x7C, 0x66, 0x7C, 0x60, 0x60,
+    // 'q' (0x71)
+    0x00, 0x00, 0x00, 0x3E, 0x6E, 0x3E, 0x06, 0x06,
+    // 'r' (0x72)
+    0x00, 0x00, 0x00, 0x7C, 0x76, 0x60, 0x60, 0x60,
+    // 's' (0x73)
+    0x00, 0x00, 0x00, 0x3C, 0x60, 0x3C, 0x06, 0x7C,
+    // 't' (0x74)
+    0x00, 0x30, 0x30, 0x78, 0x30, 0x30, 0x36, 0x1C,
+    // 'u' (0x75)
+    0x00, 0x00, 0x00, 0x66, 0x66, 0x66, 0x6E, 0x3E,
+    // 'v' (0x76)
+    0x00, 0x00, 0x00, 0x66, 0x66, 0x66, 0x3C, 0x18,
+    // 'w' (0x77)
+    0x00, 0x00, 0x00, 0x66, 0x66, 0x7E, 0x7E, 0x3C,
+    // 'x' (0x78)
+    0x00, 0x00, 0x00, 0x66, 0x3C, 0x18, 0x3C, 0x66,
+    // 'y' (0x79)
+    0x00, 0x00, 0x00, 0x66, 0x66, 0x3E, 0x06, 0x3C,
+    // 'z' (0x7A)
+    0x00, 0x00, 0x00, 0x7E, 0x0C, 0x18, 0x30, 0x7E,
+    // '{' (0x7B)
+    0x00, 0x0C, 0x18, 0x18, 0x30, 0x18, 0x18, 0x0C,
+    // '|' (0x7C)
+    0x00, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18,
+    // '}' (0x7D)
+    0x00, 0x30, 0x18, 0x18, 0x0C, 0x18, 0x18, 0x30,
+    // '~' (0x7E)
+    0x00, 0x00, 0x00, 0x30, 0x7E, 0x0C, 0x00, 0x00,
+    // degree (0x7F)
+    0x00, 0x38, 0x6C, 0x6C, 0x38, 0x00, 0x00, 0x00,
+};
+
+const matrix_led_font_t matrix_led_font_8x8 = {
+    .bitmap = s_font_8x8_bitmap,
+    .widths = NULL,
+    .width = 8,
+    .height = 8,
+    .spacing = 0,
+    .first = 0x20,
+    .last = 0x7F,
+    .name = "8x8",
+};
@@ -0,0 +1,92 @@
+/**
+ * @file matrix_led_histogram.c
+ * @brief Matrix LED 帧耗时直方图实现
+ */
+
+#include "matrix_led_histogram.h"
+
+#include <string.h>
+
+// 每个二进制数量级的子桶数 (2^2)
+#define HISTOGRAM_SUB_BITS 2
+#define HISTOGRAM_SUB_COUNT (1u << HISTOGRAM_SUB_BITS)
+
+// ==================== 内部辅助函数 ====================
+
+static inline uint32_t histogram_bucket_index(uint32_t value) {
+  if (value < HISTOGRAM_SUB_COUNT) {
+    return value;
+  }
+
+  uint32_t octave = 31u - (uint32_t)__builtin_clz(value);
+  uint32_t sub = (value >> (octave - HISTOGRAM_SUB_BITS)) &
+                 (HISTOGRAM_SUB_COUNT - 1);
+  uint32_t index = (octave - HISTOGRAM_SUB_BITS + 1) * HISTOGRAM_SUB_COUNT + sub;
+
+  return index < MATRIX_LED_HISTOGRAM_BUCKETS
+             ? index
+             : MATRIX_LED_HISTOGRAM_BUCKETS - 1;
+}
+
+static inline uint32_t histogram_bucket_upper(uint32_t index) {
+  if (index < HISTOGRAM_SUB_COUNT) {
+    return index;
+  }
+
+  uint32_t octave = index / HISTOGRAM_SUB_COUNT + HISTOGRAM_SUB_BITS - 1;
+  uint32_t sub = index % HISTOGRAM_SUB_COUNT;
+  uint32_t width = 1u << (octave - HISTOGRAM_SUB_BITS);
+
+  return ((HISTOGRAM_SUB_COUNT + sub) << (octave - HISTOGRAM_SUB_BITS)) +
+         width - 1;
+}
+
+// ==================== 公共接口实现 ====================
+
+void matrix_led_histogram_reset(matrix_led_histogram_t *hist) {
+  if (hist != NULL) {
+    memset(hist, 0, sizeof(*hist));
+  }
+}
+
+void matrix_led_histogram_record(matrix_led_histogram_t *hist,
+                                 uint32_t value_us) {
+  if (hist == NULL) {
+    return;
+  }
+
+  hist->buckets[histogram_bucket_index(value_us)]++;
+  hist->count++;
+  hist->total_us += value_us;
+  if (value_us > hist->max_us) {
+    hist->max_us = value_us;
+  }
+}
+
+uint32_t matrix_led_histogram_percentile(const matrix_led_histogram_t *hist,
+                                         uint8_t percentile) {
+  if (hist == NULL || hist->count == 0) {
+    return 0;
+  }
+
+  if (percentile > 100) {
+    percentile = 100;
+  }
+
+  // 第 ceil(count * p / 100) 个样本所在的桶
+  uint64_t rank = ((uint64_t)hist->count * percentile + 99) / 100;
+  if (rank == 0) {
+    rank = 1;
+  }
+
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < MATRIX_LED_HISTOGRAM_BUCKETS; i++) {
+    seen += hist->buckets[i];
+    if (seen >= rank) {
+      uint32_t upper = histogram_bucket_upper(i);
+      return upper < hist->max_us ? upper : hist->max_us;
+    }
+  }
+
+  return hist->max_us;
+}
@@ -0,0 +1,466 @@
+/**
+ * @file matrix_led_layer.c
+ * @brief Matrix LED 图层合成实现
+ */
+
+#include "matrix_led_layer.h"
+#include "led_kernel.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define LAYER_ALL_ROWS ((uint32_t)(((uint64_t)1 << MATRIX_LED_HEIGHT) - 1))
+
+_Static_assert(MATRIX_LED_HEIGHT <= 32, "dirty row mask holds 32 rows");
+_Static_assert(MATRIX_LED_WIDTH <= 32, "pixel masks hold 32 columns");
+
+// ==================== 内部工具 ====================
+
+/**
+ * @brief 图层行掩码转换为屏幕行掩码
+ */
+static uint32_t layer_rows_to_screen(const matrix_led_layer_t *layer,
+                                     uint32_t rows) {
+  int32_t y = layer->config.y;
+  if (y >= 32 || y <= -32) {
+    return 0;
+  }
+  uint32_t screen = y >= 0 ? rows << y : rows >> -y;
+  return screen & LAYER_ALL_ROWS;
+}
+
+/**
+ * @brief 图层当前可见时覆盖的屏幕行
+ */
+static uint32_t layer_screen_rows(const matrix_led_layer_t *layer) {
+  const matrix_led_layer_config_t *c = &layer->config;
+  if (!c->visible || c->opacity == 0 || c->x >= MATRIX_LED_WIDTH ||
+      c->x + c->width <= 0) {
+    return 0;
+  }
+  uint32_t rows = c->height >= 32 ? 0xFFFFFFFFu : (1u << c->height) - 1;
+  return layer_rows_to_screen(layer, rows);
+}
+
+/**
+ * @brief 图层在该屏幕行上完全不透明且覆盖整行
+ */
+static bool layer_covers_row(const matrix_led_layer_t *layer, uint32_t row) {
+  const matrix_led_layer_config_t *c = &layer->config;
+  return c->format == MATRIX_LED_LAYER_OPAQUE && c->opacity == 255 &&
+         c->visible && c->x <= 0 && c->x + c->width >= MATRIX_LED_WIDTH &&
+         (int32_t)row >= c->y && (int32_t)row < c->y + c->height;
+}
+
+static inline void blend_pixel(matrix_led_color_t *dst,
+                               const matrix_led_color_t *src, uint8_t alpha) {
+  dst->r = led_kernel_lerp8(dst->r, src->r, alpha);
+  dst->g = led_kernel_lerp8(dst->g, src->g, alpha);
+  dst->b = led_kernel_lerp8(dst->b, src->b, alpha);
+}
+
+/**
+ * @brief 把不透明图层的一段像素混合到目标行
+ */
+static void blend_span(matrix_led_color_t *dst, const matrix_led_color_t *src,
+                       uint32_t n, uint8_t opacity) {
+  if (opacity == 255) {
+    // 整行复制使用常量长度，编译器可以展开为定长拷贝
+    if (n == MATRIX_LED_WIDTH) {
+      memcpy(dst, src, MATRIX_LED_WIDTH * sizeof(matrix_led_color_t));
+    } else {
+      memcpy(dst, src, n * sizeof(matrix_led_color_t));
+    }
+    return;
+  }
+  for (uint32_t i = 0; i < n; i++) {
+    blend_pixel(&dst[i], &src[i], opacity);
+  }
+}
+
+/**
+ * @brief 按位掩码把 KEYED/ALPHA 图层的非透明像素混合到目标行
+ *
+ * @param dst 目标行
+ * @param x_offset 图层第0列在目标行中的X坐标
+ * @param bits 需要混合的图层列（bit31为第0列），必须都在目标行范围内
+ * @return 混合的像素数
+ */
+static uint32_t blend_bits(matrix_led_color_t *dst, int32_t x_offset,
+                           const matrix_led_color_t *src, const uint8_t *alpha,
+                           uint32_t bits, uint8_t opacity) {
+  uint32_t count = 0;
+  while (bits != 0) {
+    uint32_t x = (uint32_t)__builtin_clz(bits);
+    bits &= ~(0x80000000u >> x);
+    count++;
+
+    uint8_t a = opacity;
+    if (alpha != NULL) {
+      a = opacity == 255 ? alpha[x] : led_kernel_scale8(alpha[x], opacity);
+    }
+    matrix_led_color_t *d = &dst[x_offset + (int32_t)x];
+    if (a == 255) {
+      *d = src[x];
+    } else {
+      blend_pixel(d, &src[x], a);
+    }
+  }
+  return count;
+}
+
+/**
+ * @brief 宽度为 n 的左对齐（高位）掩码
+ */
+static inline uint32_t left_mask(int32_t n) {
+  return n >= 32 ? 0xFFFFFFFFu : n <= 0 ? 0 : ~(0xFFFFFFFFu >> n);
+}
+
+/**
+ * @brief 重新计算图层中指定行的非透明像素掩码
+ */
+static void layer_update_coverage(matrix_led_layer_t *layer, uint32_t rows) {
+  const matrix_led_layer_config_t *c = &layer->config;
+  if (c->format == MATRIX_LED_LAYER_OPAQUE) {
+    return;
+  }
+
+  rows &= c->height >= 32 ? 0xFFFFFFFFu : (1u << c->height) - 1;
+  while (rows != 0) {
+    uint32_t row = (uint32_t)__builtin_ctz(rows);
+    rows &= rows - 1;
+
+    uint32_t mask = 0;
+    uint32_t offset = row * c->width;
+    if (c->format == MATRIX_LED_LAYER_ALPHA) {
+      const uint8_t *a = &layer->alpha[offset];
+      for (uint32_t x = 0; x < c->width; x++) {
+        mask |= a[x] ? 0x80000000u >> x : 0;
+      }
+    } else {
+      const matrix_led_color_t *p = &layer->pixels[offset];
+      for (uint32_t x = 0; x < c->width; x++) {
+        mask |= (p[x].r | p[x].g | p[x].b) ? 0x80000000u >> x : 0;
+      }
+    }
+
+    layer->masks[row] = mask;
+    if (mask != 0) {
+      layer->coverage_rows |= 1u << row;
+    } else {
+      layer->coverage_rows &= ~(1u << row);
+    }
+  }
+}
+
+static int compositor_find(const matrix_led_compositor_t *compositor,
+                           const matrix_led_layer_t *layer) {
+  for (int i = 0; i < compositor->count; i++) {
+    if (compositor->layers[i] == layer) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+/**
+ * @brief 按z顺序插入图层（相同z时插在最上方）
+ */
+static void compositor_insert(matrix_led_compositor_t *compositor,
+                              matrix_led_layer_t *layer) {
+  int pos = compositor->count;
+  while (pos > 0 && compositor->layers[pos - 1]->config.z > layer->config.z) {
+    compositor->layers[pos] = compositor->layers[pos - 1];
+    pos--;
+  }
+  compositor->layers[pos] = layer;
+  compositor->count++;
+}
+
+static void compositor_unlink(matrix_led_compositor_t *compositor, int index) {
+  memmove(&compositor->layers[index], &compositor->layers[index + 1],
+          (compositor->count - index - 1) * sizeof(compositor->layers[0]));
+  compositor->count--;
+  compositor->layers[compositor->count] = NULL;
+}
+
+static inline void compositor_damage(matrix_led_compositor_t *compositor,
+                                     uint32_t rows) {
+  if (rows != 0) {
+    __atomic_fetch_or(&compositor->damage_rows, rows, __ATOMIC_RELAXED);
+  }
+}
+
+// ==================== 图层像素操作 ====================
+
+void matrix_led_layer_set_pixel(matrix_led_layer_t *layer, uint8_t x,
+                                uint8_t y, matrix_led_color_t color,
+                                uint8_t alpha) {
+  if (layer == NULL || x >= layer->config.width ||
+      y >= layer->config.height) {
+    return;
+  }
+
+  uint32_t index = (uint32_t)y * layer->config.width + x;
+  layer->pixels[index] = color;
+  if (layer->alpha != NULL) {
+    layer->alpha[index] = alpha;
+  }
+  matrix_led_layer_mark_dirty(layer, 1u << y);
+}
+
+void matrix_led_layer_fill(matrix_led_layer_t *layer, matrix_led_color_t color,
+                           uint8_t alpha) {
+  if (layer == NULL) {
+    return;
+  }
+
+  uint32_t count = (uint32_t)layer->config.width * layer->config.height;
+  for (uint32_t i = 0; i < count; i++) {
+    layer->pixels[i] = color;
+  }
+  if (layer->alpha != NULL) {
+    memset(layer->alpha, alpha, count);
+  }
+  matrix_led_layer_mark_dirty(layer, 0xFFFFFFFFu);
+}
+
+void matrix_led_layer_blit(matrix_led_layer_t *layer, int16_t x, int16_t y,
+                           uint8_t width, uint8_t height,
+                           const matrix_led_color_t *pixels,
+                           const uint8_t *alpha) {
+  if (layer == NULL || pixels == NULL) {
+    return;
+  }
+
+  int32_t x0 = x < 0 ? 0 : x;
+  int32_t y0 = y < 0 ? 0 : y;
+  int32_t x1 = x + width;
+  int32_t y1 = y + height;
+  if (x1 > layer->config.width) {
+    x1 = layer->config.width;
+  }
+  if (y1 > layer->config.height) {
+    y1 = layer->config.height;
+  }
+  if (x0 >= x1 || y0 >= y1) {
+    return;
+  }
+
+  uint32_t n = (uint32_t)(x1 - x0);
+  uint32_t rows = 0;
+  for (int32_t row = y0; row < y1; row++) {
+    uint32_t src = (uint32_t)(row - y) * width + (uint32_t)(x0 - x);
+    uint32_t dst = (uint32_t)row * layer->config.width + (uint32_t)x0;
+    memcpy(&layer->pixels[dst], &pixels[src], n * sizeof(matrix_led_color_t));
+    if (layer->alpha != NULL) {
+      if (alpha != NULL) {
+        memcpy(&layer->alpha[dst], &alpha[src], n);
+      } else {
+        memset(&layer->alpha[dst], 255, n);
+      }
+    }
+    rows |= 1u << row;
+  }
+  matrix_led_layer_mark_dirty(layer, rows);
+}
+
+void matrix_led_layer_mark_dirty(matrix_led_layer_t *layer, uint32_t rows) {
+  if (layer != NULL && rows != 0) {
+    __atomic_fetch_or(&layer->dirty_rows, rows, __ATOMIC_RELEASE);
+  }
+}
+
+// ==================== 合成器 ====================
+
+void matrix_led_compositor_init(matrix_led_compositor_t *compositor,
+                                matrix_led_color_t background) {
+  memset(compositor, 0, sizeof(*compositor));
+  compositor->background = background;
+}
+
+void matrix_led_compositor_deinit(matrix_led_compositor_t *compositor) {
+  for (int i = 0; i < compositor->count; i++) {
+    free(compositor->layers[i]);
+    compositor->layers[i] = NULL;
+  }
+  compositor->count = 0;
+}
+
+esp_err_t matrix_led_compositor_add_layer(
+    matrix_led_compositor_t *compositor,
+    const matrix_led_layer_config_t *config, matrix_led_layer_t **layer) {
+  if (compositor == NULL || config == NULL || layer == NULL ||
+      config->format > MATRIX_LED_LAYER_ALPHA) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (compositor->count >= MATRIX_LED_LAYER_MAX) {
+    return ESP_ERR_NO_MEM;
+  }
+
+  uint8_t width = config->width ? config->width : MATRIX_LED_WIDTH;
+  uint8_t height = config->height ? config->height : MATRIX_LED_HEIGHT;
+  if (width > MATRIX_LED_WIDTH || height > MATRIX_LED_HEIGHT) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // 图层结构、像素和alpha放在同一块内存中
+  size_t count = (size_t)width * height;
+  size_t alpha_size = config->format == MATRIX_LED_LAYER_ALPHA ? count : 0;
+  matrix_led_layer_t *new_layer =
+      calloc(1, sizeof(matrix_led_layer_t) +
+                    count * sizeof(matrix_led_color_t) + alpha_size);
+  if (new_layer == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+  new_layer->pixels = (matrix_led_color_t *)(new_layer + 1);
+  new_layer->alpha =
+      alpha_size ? (uint8_t *)(new_layer->pixels + count) : NULL;
+  new_layer->config = *config;
+  new_layer->config.width = width;
+  new_layer->config.height = height;
+  new_layer->coverage_rows = config->format == MATRIX_LED_LAYER_OPAQUE
+                                 ? 0xFFFFFFFFu
+                                 : 0; // 新图层内容为空（透明）
+
+  compositor_insert(compositor, new_layer);
+  compositor_damage(compositor, layer_screen_rows(new_layer) &
+                                    layer_rows_to_screen(
+                                        new_layer, new_layer->coverage_rows));
+
+  *layer = new_layer;
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_compositor_remove_layer(matrix_led_compositor_t *compositor,
+                                             matrix_led_layer_t *layer) {
+  int index = compositor ? compositor_find(compositor, layer) : -1;
+  if (index < 0) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  compositor_damage(compositor,
+                    layer_screen_rows(layer) &
+                        layer_rows_to_screen(layer, layer->coverage_rows));
+  compositor_unlink(compositor, index);
+  free(layer);
+  return ESP_OK;
+}
+
+esp_err_t matrix_led_compositor_update_layer(
+    matrix_led_compositor_t *compositor, matrix_led_layer_t *layer,
+    const matrix_led_layer_config_t *config) {
+  if (compositor == NULL || config == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  int index = compositor_find(compositor, layer);
+  if (index < 0) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  matrix_led_layer_config_t *c = &layer->config;
+  if (c->x == config->x && c->y == config->y && c->z == config->z &&
+      c->opacity == config->opacity && c->visible == config->visible) {
+    return ESP_OK;
+  }
+
+  // 旧位置和新位置覆盖的行都需要重新合成
+  uint32_t coverage = layer->coverage_rows;
+  uint32_t damage =
+      layer_screen_rows(layer) & layer_rows_to_screen(layer, coverage);
+  c->x = config->x;
+  c->y = config->y;
+  c->opacity = config->opacity;
+  c->visible = config->visible;
+  if (c->z != config->z) {
+    c->z = config->z;
+    compositor_unlink(compositor, index);
+    compositor_insert(compositor, layer);
+  }
+  compositor_damage(compositor,
+                    damage | (layer_screen_rows(layer) &
+                              layer_rows_to_screen(layer, coverage)));
+  return ESP_OK;
+}
+
+uint32_t matrix_led_compositor_compose(matrix_led_compositor_t *compositor,
+                                       matrix_led_color_t *frame) {
+  if (compositor == NULL || frame == NULL) {
+    return 0;
+  }
+
+  // 先取走脏行再读取像素，取走之后的写入会在下一次合成时处理
+  uint32_t rows =
+      __atomic_exchange_n(&compositor->damage_rows, 0, __ATOMIC_ACQUIRE);
+  for (int i = 0; i < compositor->count; i++) {
+    matrix_led_layer_t *layer = compositor->layers[i];
+    uint32_t dirty =
+        __atomic_exchange_n(&layer->dirty_rows, 0, __ATOMIC_ACQUIRE);
+    if (dirty == 0) {
+      continue;
+    }
+    // 修改前后都完全透明的行不影响画面
+    uint32_t coverage = layer->coverage_rows;
+    layer_update_coverage(layer, dirty);
+    dirty &= coverage | layer->coverage_rows;
+    rows |= layer_rows_to_screen(layer, dirty) & layer_screen_rows(layer);
+  }
+  if (rows == 0) {
+    return 0;
+  }
+
+  uint32_t pending = rows;
+  while (pending != 0) {
+    uint32_t row = (uint32_t)__builtin_ctz(pending);
+    pending &= pending - 1;
+    matrix_led_color_t *dst = &frame[row * MATRIX_LED_WIDTH];
+
+    // 从覆盖整行的最上层不透明图层开始，下方图层被完全遮挡
+    int start = compositor->count - 1;
+    while (start >= 0 && !layer_covers_row(compositor->layers[start], row)) {
+      start--;
+    }
+    if (start < 0) {
+      for (uint32_t x = 0; x < MATRIX_LED_WIDTH; x++) {
+        dst[x] = compositor->background;
+      }
+      start = 0;
+    }
+
+    for (int i = start; i < compositor->count; i++) {
+      const matrix_led_layer_t *layer = compositor->layers[i];
+      const matrix_led_layer_config_t *c = &layer->config;
+      int32_t ly = (int32_t)row - c->y;
+      if (!c->visible || c->opacity == 0 || ly < 0 || ly >= c->height ||
+          !(layer->coverage_rows & (1u << ly))) {
+        continue;
+      }
+      int32_t x0 = c->x < 0 ? 0 : c->x;
+      int32_t x1 = c->x + c->width;
+      if (x1 > MATRIX_LED_WIDTH) {
+        x1 = MATRIX_LED_WIDTH;
+      }
+      if (x0 >= x1) {
+        continue;
+      }
+
+      uint32_t offset = (uint32_t)ly * c->width;
+      if (c->format == MATRIX_LED_LAYER_OPAQUE) {
+        blend_span(&dst[x0], &layer->pixels[offset + (x0 - c->x)],
+                   (uint32_t)(x1 - x0), c->opacity);
+        compositor->blended_pixels += (uint32_t)(x1 - x0);
+      } else {
+        // 只混合可见范围内的非透明像素
+        uint32_t visible = left_mask(x1 - c->x) & ~left_mask(x0 - c->x);
+        compositor->blended_pixels += blend_bits(
+            dst, c->x, &layer->pixels[offset],
+            layer->alpha ? &layer->alpha[offset] : NULL,
+            layer->masks[ly] & visible, c->opacity);
+      }
+    }
+  }
+
+  compositor->compositions++;
+  compositor->composed_rows += (uint32_t)__builtin_popcount(rows);
+  return rows;
+}
@@ -0,0 +1,189 @@
+/**
+ * @file matrix_led_output.c
+ * @brief Matrix LED 输出后端公共部分和内存后端
+ */
+
+#include "matrix_led_output.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ==================== 通用接口 ====================
+
+esp_err_t matrix_led_output_write_frame(matrix_led_output_t *output,
+                                        const matrix_led_correction_t *correction,
+                                        const matrix_led_color_t *frame,
+                                        matrix_led_color_t *sent,
+                                        uint32_t dirty_rows,
+                                        matrix_led_output_stats_t *stats,
+                                        bool *changed) {
+  if (output == NULL || correction == NULL || frame == NULL || sent == NULL ||
+      changed == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  matrix_led_color_t corrected_row[MATRIX_LED_WIDTH];
+  *changed = false;
+
+  for (uint32_t y = 0; y < MATRIX_LED_HEIGHT && dirty_rows != 0; y++) {
+    if (!(dirty_rows & (1u << y))) {
+      continue;
+    }
+    dirty_rows &= ~(1u << y);
+
+    uint32_t base = y * MATRIX_LED_WIDTH;
+    matrix_led_correction_apply(correction, &frame[base], corrected_row,
+                                MATRIX_LED_WIDTH);
+    if (stats != NULL) {
+      stats->corrected_pixels += MATRIX_LED_WIDTH;
+    }
+
+    matrix_led_color_t *sent_row = &sent[base];
+    if (memcmp(sent_row, corrected_row, sizeof(corrected_row)) == 0) {
+      continue;
+    }
+
+    // 只把与上次发送结果不同的像素写入后端
+    for (uint32_t x = 0; x < MATRIX_LED_WIDTH; x++) {
+      matrix_led_color_t c = corrected_row[x];
+      if (c.r == sent_row[x].r && c.g == sent_row[x].g &&
+          c.b == sent_row[x].b) {
+        continue;
+      }
+      esp_err_t ret = output->set_pixel(output, base + x, c);
+      if (ret != ESP_OK) {
+        return ret;
+      }
+      sent_row[x] = c;
+      if (stats != NULL) {
+        stats->written_pixels++;
+      }
+    }
+    *changed = true;
+  }
+
+  return ESP_OK;
+}
+
+void matrix_led_output_del(matrix_led_output_t *output) {
+  if (output != NULL && output->del != NULL) {
+    output->del(output);
+  }
+}
+
+// ==================== 内存后端 ====================
+
+typedef struct {
+  matrix_led_output_t base;
+  matrix_led_color_t pending[MATRIX_LED_COUNT]; ///< 发送缓冲区
+  matrix_led_color_t latched[MATRIX_LED_COUNT]; ///< 最近一次输出的帧
+  uint32_t refresh_count;                       ///< 累计输出次数
+} matrix_led_output_memory_t;
+
+static esp_err_t memory_set_pixel(matrix_led_output_t *output, uint32_t index,
+                                  matrix_led_color_t color) {
+  if (index >= MATRIX_LED_COUNT) {
+    return ESP_ERR_INVALID_ARG;
+  }
+  ((matrix_led_output_memory_t *)output)->pending[index] = color;
+  return ESP_OK;
+}
+
+static esp_err_t memory_refresh(matrix_led_output_t *output) {
+  matrix_led_output_memory_t *memory = (matrix_led_output_memory_t *)output;
+  memcpy(memory->latched, memory->pending, sizeof(memory->latched));
+  memory->refresh_count++;
+  return ESP_OK;
+}
+
+static esp_err_t memory_clear(matrix_led_output_t *output) {
+  matrix_led_output_memory_t *memory = (matrix_led_output_memory_t *)output;
+  memset(memory->pending, 0, sizeof(memory->pending));
+  return memory_refresh(output);
+}
+
+static esp_err_t memory_del(matrix_led_output_t *output) {
+  free(output);
+  return ESP_OK;
+}
+
+static const matrix_led_output_memory_t *
+memory_from_output(const matrix_led_output_t *output) {
+  if (output == NULL || output->refresh != memory_refresh) {
+    return NULL;
+  }
+  return (const matrix_led_output_memory_t *)output;
+}
+
+esp_err_t matrix_led_output_new_memory(matrix_led_output_t **output) {
+  if (output == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  matrix_led_output_memory_t *memory =
+      calloc(1, sizeof(matrix_led_output_memory_t));
+  if (memory == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+
+  memory->base.set_pixel = memory_set_pixel;
+  memory->base.refresh = memory_refresh;
+  memory->base.clear = memory_clear;
+  memory->base.del = memory_del;
+  memory->base.name = "memory";
+
+  *output = &memory->base;
+  return ESP_OK;
+}
+
+const matrix_led_color_t *matrix_led_output_memory_get_frame(
+    const matrix_led_output_t *output, uint32_t *refresh_count) {
+  const matrix_led_output_memory_t *memory = memory_from_output(output);
+  if (memory == NULL) {
+    return NULL;
+  }
+  if (refresh_count != NULL) {
+    *refresh_count = memory->refresh_count;
+  }
+  return memory->latched;
+}
+
+esp_err_t matrix_led_output_memory_dump_ppm(const matrix_led_output_t *output,
+                                            const char *filepath,
+                                            uint8_t scale) {
+  const matrix_led_output_memory_t *memory = memory_from_output(output);
+  if (memory == NULL || filepath == NULL || scale == 0 || scale > 32) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  FILE *file = fopen(filepath, "wb");
+  if (file == NULL) {
+    return ESP_FAIL;
+  }
+
+  fprintf(file, "P6\n%u %u\n255\n", MATRIX_LED_WIDTH * scale,
+          MATRIX_LED_HEIGHT * scale);
+
+  uint8_t line[MATRIX_LED_WIDTH * 32 * 3];
+  bool ok = true;
+  for (uint32_t y = 0; y < MATRIX_LED_HEIGHT && ok; y++) {
+    const matrix_led_color_t *row = &memory->latched[y * MATRIX_LED_WIDTH];
+    size_t len = 0;
+    for (uint32_t x = 0; x < MATRIX_LED_WIDTH; x++) {
+      for (uint8_t s = 0; s < scale; s++) {
+        line[len++] = row[x].r;
+        line[len++] = row[x].g;
+        line[len++] = row[x].b;
+      }
+    }
+    for (uint8_t s = 0; s < scale && ok; s++) {
+      ok = fwrite(line, 1, len, file) == len;
+    }
+  }
+
+  if (fclose(file) != 0 || !ok) {
+    return ESP_FAIL;
+  }
+  return ESP_OK;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file matrix_led_output_rmt.c
+ * @brief Matrix LED RMT输出后端（WS2812）
+ */
+
+#include "matrix_led_output.h"
+
+#include <stdlib.h>
+
+#include "esp_log.h"
+#include "led_strip.h"
+
+static const char *TAG = "matrix_led_rmt";
+
+typedef struct {
+  matrix_led_output_t base;
+  led_strip_handle_t strip; ///< LED条带句柄
+} matrix_led_output_rmt_t;
+
+static esp_err_t rmt_set_pixel(matrix_led_output_t *output, uint32_t index,
+                               matrix_led_color_t color) {
+  matrix_led_output_rmt_t *rmt = (matrix_led_output_rmt_t *)output;
+  return led_strip_set_pixel(rmt->strip, index, color.r, color.g, color.b);
+}
+
+static esp_err_t rmt_refresh(matrix_led_output_t *output) {
+  return led_strip_refresh(((matrix_led_output_rmt_t *)output)->strip);
+}
+
+static esp_err_t rmt_clear(matrix_led_output_t *output) {
+  return led_strip_clear(((matrix_led_output_rmt_t *)output)->strip);
+}
+
+static esp_err_t rmt_del(matrix_led_output_t *output) {
+  matrix_led_output_rmt_t *rmt = (matrix_led_output_rmt_t *)output;
+  led_strip_clear(rmt->strip);
+  led_strip_refresh(rmt->strip);
+  esp_err_t ret = led_strip_del(rmt->strip);
+  free(rmt);
+  return ret;
+}
+
+esp_err_t matrix_led_output_new_rmt(int gpio_num, uint32_t resolution_hz,
+                                    matrix_led_output_t **output) {
+  if (output == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  matrix_led_output_rmt_t *rmt = calloc(1, sizeof(matrix_led_output_rmt_t));
+  if (rmt == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+
+  // LED条带配置
+  led_strip_config_t strip_config = {.strip_gpio_num = gpio_num,
+                                     .max_leds = MATRIX_LED_COUNT,
+                                     .led_pixel_format = LED_PIXEL_FORMAT_GRB,
+                                     .led_model = LED_MODEL_WS2812,
+                                     .flags = {
+                                         .invert_out = false,
+                                     }};
+
+  // RMT后端配置 - Matrix LED需要更多资源用于1024个LED
+  led_strip_rmt_config_t rmt_config = {
+      .clk_src = RMT_CLK_SRC_DEFAULT,
+      .resolution_hz = resolution_hz,
+      .mem_block_symbols = 96, // 为Matrix LED分配更多内存(2个通道的内存)
+      .flags = {
+          .with_dma = true, // 使用DMA提高性能
+      }};
+
+  esp_err_t ret =
+      led_strip_new_rmt_device(&strip_config, &rmt_config, &rmt->strip);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to create LED strip: %s", esp_err_to_name(ret));
+    ESP_LOGE(
+        TAG,
+        "This may be due to RMT resource conflicts with other LED components");
+    ESP_LOGE(TAG,
+             "Try adjusting initialization order or RMT channel allocation");
+    free(rmt);
+    return ret;
+  }
+
+  // 清空LED条带
+  ret = led_strip_clear(rmt->strip);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to clear LED strip: %s", esp_err_to_name(ret));
+    led_strip_del(rmt->strip);
+    free(rmt);
+    return ret;
+  }
+
+  rmt->base.set_pixel = rmt_set_pixel;
+  rmt->base.refresh = rmt_refresh;
+  rmt->base.clear = rmt_clear;
+  rmt->base.del = rmt_del;
+  rmt->base.name = "rmt";
+
+  *output = &rmt->base;
+  return ESP_OK;
+}
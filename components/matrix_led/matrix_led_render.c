@@ -0,0 +1,159 @@
+/**
+ * @file matrix_led_render.c
+ * @brief Matrix LED 内置动画渲染实现
+ */
+
+#include "matrix_led_render.h"
+
+#include <string.h>
+
+#include "led_kernel.h"
+
+#define RENDER_ALL_ROWS                                                        \
+  ((uint32_t)(((uint64_t)1 << MATRIX_LED_HEIGHT) - 1))
+
+/**
+ * @brief 动画相位（相位单位数 * speed / divisor）
+ *
+ * 由固定步长的动画时钟计算，与任务实际被调度的时刻无关，
+ * 因此帧间隔抖动不会反映到动画速度上。
+ */
+static uint32_t render_phase(const matrix_led_animation_config_t *config,
+                             uint64_t elapsed_us, uint32_t divisor) {
+  uint64_t scaled = elapsed_us * config->speed;
+  return (uint32_t)(scaled / ((uint64_t)divisor * MATRIX_LED_RENDER_PHASE_US));
+}
+
+static inline matrix_led_color_t render_from_kernel(led_kernel_rgb_t c) {
+  return (matrix_led_color_t){c.r, c.g, c.b};
+}
+
+static inline led_kernel_rgb_t render_to_kernel(matrix_led_color_t c) {
+  return (led_kernel_rgb_t){c.r, c.g, c.b};
+}
+
+static void render_fill(matrix_led_color_t *frame, matrix_led_color_t color) {
+  for (uint32_t i = 0; i < MATRIX_LED_COUNT; i++) {
+    frame[i] = color;
+  }
+}
+
+static void render_rainbow(const matrix_led_animation_config_t *config,
+                           uint64_t elapsed_us, matrix_led_color_t *frame) {
+  uint32_t time_offset = render_phase(config, elapsed_us, 10);
+
+  // 色相只与对角线 (x + y) 有关，每帧只需计算 W + H - 1 个颜色
+  matrix_led_color_t diagonal[MATRIX_LED_WIDTH + MATRIX_LED_HEIGHT - 1];
+  uint32_t hue_offset = LED_KERNEL_DEGREES(time_offset % 360);
+  for (uint32_t d = 0; d < MATRIX_LED_WIDTH + MATRIX_LED_HEIGHT - 1; d++) {
+    uint16_t hue = (uint16_t)(d * LED_KERNEL_ANGLE_FULL /
+                                  (MATRIX_LED_WIDTH + MATRIX_LED_HEIGHT) +
+                              hue_offset);
+    diagonal[d] = render_from_kernel(led_kernel_hsv_to_rgb(hue, 255, 255));
+  }
+
+  matrix_led_color_t *row = frame;
+  for (uint32_t y = 0; y < MATRIX_LED_HEIGHT; y++) {
+    memcpy(row, &diagonal[y], MATRIX_LED_WIDTH * sizeof(matrix_led_color_t));
+    row += MATRIX_LED_WIDTH;
+  }
+}
+
+static void render_wave(const matrix_led_animation_config_t *config,
+                        uint64_t elapsed_us, matrix_led_color_t *frame) {
+  uint32_t time_offset = render_phase(config, elapsed_us, 20);
+
+  led_kernel_rgb_t primary = render_to_kernel(config->primary_color);
+  led_kernel_rgb_t secondary = render_to_kernel(config->secondary_color);
+
+  // 波形只沿X方向变化：计算一行后复制到所有行
+  for (uint32_t x = 0; x < MATRIX_LED_WIDTH; x++) {
+    uint16_t angle = (uint16_t)((x + time_offset) * LED_KERNEL_RADIANS(0.2f));
+    frame[x] = render_from_kernel(
+        led_kernel_lerp_rgb(secondary, primary, led_kernel_wave8(angle)));
+  }
+  for (uint32_t y = 1; y < MATRIX_LED_HEIGHT; y++) {
+    memcpy(frame + y * MATRIX_LED_WIDTH, frame,
+           MATRIX_LED_WIDTH * sizeof(matrix_led_color_t));
+  }
+}
+
+static void render_breathe(const matrix_led_animation_config_t *config,
+                           uint64_t elapsed_us, matrix_led_color_t *frame) {
+  uint32_t time_offset = render_phase(config, elapsed_us, 50);
+  uint8_t level =
+      led_kernel_wave8((uint16_t)(time_offset * LED_KERNEL_RADIANS(0.1f)));
+
+  led_kernel_rgb_t base = render_to_kernel(config->primary_color);
+  render_fill(frame, render_from_kernel(led_kernel_scale_rgb(base, level)));
+}
+
+static void render_rotate(const matrix_led_animation_config_t *config,
+                          uint64_t elapsed_us, matrix_led_color_t *frame) {
+  // 简单的旋转动画实现
+  uint32_t time_offset = render_phase(config, elapsed_us, 30);
+
+  memset(frame, 0, MATRIX_LED_COUNT * sizeof(matrix_led_color_t));
+
+  const int32_t center_x = MATRIX_LED_WIDTH / 2;
+  const int32_t center_y = MATRIX_LED_HEIGHT / 2;
+  const int32_t radius = 12;
+
+  for (uint32_t i = 0; i < 4; i++) {
+    uint16_t angle = LED_KERNEL_DEGREES((time_offset + i * 90) % 360);
+    int32_t x = center_x + led_kernel_mul_sin(led_kernel_cos16(angle), radius);
+    int32_t y = center_y + led_kernel_mul_sin(led_kernel_sin16(angle), radius);
+
+    if (x >= 0 && x < MATRIX_LED_WIDTH && y >= 0 && y < MATRIX_LED_HEIGHT) {
+      frame[y * MATRIX_LED_WIDTH + x] = config->primary_color;
+    }
+  }
+}
+
+static void render_fade(const matrix_led_animation_config_t *config,
+                        uint64_t elapsed_us, matrix_led_color_t *frame) {
+  uint32_t time_offset = render_phase(config, elapsed_us, 40);
+  uint8_t fade =
+      led_kernel_wave8((uint16_t)(time_offset * LED_KERNEL_RADIANS(0.05f)));
+
+  led_kernel_rgb_t color1 = render_to_kernel(config->primary_color);
+  led_kernel_rgb_t color2 = render_to_kernel(config->secondary_color);
+  render_fill(frame,
+              render_from_kernel(led_kernel_lerp_rgb(color1, color2, fade)));
+}
+
+esp_err_t matrix_led_render_builtin(matrix_led_animation_type_t type,
+                                    const matrix_led_animation_config_t *config,
+                                    uint64_t elapsed_us,
+                                    matrix_led_color_t *frame,
+                                    uint32_t *dirty_rows) {
+  if (config == NULL || frame == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  switch (type) {
+  case MATRIX_LED_ANIM_RAINBOW:
+    render_rainbow(config, elapsed_us, frame);
+    break;
+  case MATRIX_LED_ANIM_WAVE:
+    render_wave(config, elapsed_us, frame);
+    break;
+  case MATRIX_LED_ANIM_BREATHE:
+    render_breathe(config, elapsed_us, frame);
+    break;
+  case MATRIX_LED_ANIM_ROTATE:
+    render_rotate(config, elapsed_us, frame);
+    break;
+  case MATRIX_LED_ANIM_FADE:
+    render_fade(config, elapsed_us, frame);
+    break;
+  default:
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+
+  // 内置动画每帧都重绘整个画面
+  if (dirty_rows != NULL) {
+    *dirty_rows = RENDER_ALL_ROWS;
+  }
+  return ESP_OK;
+}
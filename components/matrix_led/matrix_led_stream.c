@@ -0,0 +1,162 @@
+/**
+ * @file matrix_led_stream.c
+ * @brief Matrix LED 动画流式播放实现
+ */
+
+#include "matrix_led_stream.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+static const char *TAG = "matrix_led_stream";
+
+// 缓冲区满时的最长等待，渲染任务取帧后会提前唤醒
+#define MATRIX_LED_STREAM_IDLE_WAIT_MS 100
+
+struct matrix_led_stream {
+  matrix_led_anim_reader_t *reader; ///< 读取器（文件访问由读取任务独占）
+  matrix_led_anim_ring_t ring;      ///< 帧记录预取环
+  TaskHandle_t task;                ///< 读取任务
+  SemaphoreHandle_t ready;          ///< 首次填满或读取结束
+  SemaphoreHandle_t done;           ///< 读取任务已退出
+  volatile bool stop;               ///< 请求读取任务退出
+  volatile esp_err_t status;        ///< 读取错误（ESP_OK表示正常）
+};
+
+static void matrix_led_stream_task(void *arg) {
+  matrix_led_stream_t *stream = (matrix_led_stream_t *)arg;
+  bool primed = false;
+
+  while (!stream->stop) {
+    esp_err_t ret = matrix_led_anim_ring_fill(&stream->ring, stream->reader);
+
+    if (ret == ESP_FAIL) {
+      ESP_LOGE(TAG, "Failed to read frame %u of '%s'",
+               stream->reader->next_frame, stream->reader->info.name);
+      stream->status = ESP_FAIL;
+    }
+    if (!primed) {
+      primed = true;
+      xSemaphoreGive(stream->ready);
+    }
+
+    if (ret == ESP_ERR_NO_MEM) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MATRIX_LED_STREAM_IDLE_WAIT_MS));
+    } else {
+      // 动画已全部读入或出错，等待停止
+      while (!stream->stop) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+      }
+    }
+  }
+
+  xSemaphoreGive(stream->done);
+  vTaskDelete(NULL);
+}
+
+esp_err_t matrix_led_stream_start(matrix_led_anim_reader_t *reader,
+                                  matrix_led_stream_t **stream) {
+  if (reader == NULL || stream == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  matrix_led_stream_t *s = calloc(1, sizeof(matrix_led_stream_t));
+  if (s == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+
+  s->reader = reader;
+  s->status = ESP_OK;
+  matrix_led_anim_ring_init(&s->ring);
+  s->ready = xSemaphoreCreateBinary();
+  s->done = xSemaphoreCreateBinary();
+  if (s->ready == NULL || s->done == NULL) {
+    goto cleanup;
+  }
+
+  if (xTaskCreate(matrix_led_stream_task, "matrix_led_stream",
+                  MATRIX_LED_STREAM_TASK_STACK_SIZE, s,
+                  MATRIX_LED_STREAM_TASK_PRIORITY, &s->task) != pdPASS) {
+    ESP_LOGE(TAG, "Failed to create stream task");
+    goto cleanup;
+  }
+
+  // 等待首次填满，避免开头几帧就欠载
+  if (xSemaphoreTake(s->ready,
+                     pdMS_TO_TICKS(MATRIX_LED_STREAM_PRIME_TIMEOUT_MS)) !=
+      pdTRUE) {
+    ESP_LOGW(TAG, "Stream '%s' not primed after %d ms", reader->info.name,
+             MATRIX_LED_STREAM_PRIME_TIMEOUT_MS);
+  }
+
+  if (s->status != ESP_OK && matrix_led_anim_ring_frames(&s->ring) == 0) {
+    matrix_led_stream_stop(s);
+    return ESP_FAIL;
+  }
+
+  ESP_LOGD(TAG, "Stream '%s' started with %lu frames buffered",
+           reader->info.name,
+           (unsigned long)matrix_led_anim_ring_frames(&s->ring));
+  *stream = s;
+  return ESP_OK;
+
+cleanup:
+  if (s->ready) {
+    vSemaphoreDelete(s->ready);
+  }
+  if (s->done) {
+    vSemaphoreDelete(s->done);
+  }
+  free(s);
+  return ESP_ERR_NO_MEM;
+}
+
+esp_err_t matrix_led_stream_next_frame(matrix_led_stream_t *stream,
+                                       matrix_led_color_t *frame,
+                                       uint16_t *delay_ms,
+                                       uint32_t *dirty_rows) {
+  if (stream == NULL || frame == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // 先读结束标志再查看缓冲区，保证结束前写入的帧都能取到
+  bool finished = __atomic_load_n(&stream->ring.finished, __ATOMIC_ACQUIRE);
+
+  size_t length;
+  const uint8_t *record = matrix_led_anim_ring_peek(&stream->ring, &length);
+  if (record == NULL) {
+    if (stream->status != ESP_OK) {
+      return stream->status;
+    }
+    return finished ? ESP_ERR_NOT_FOUND : ESP_ERR_TIMEOUT;
+  }
+
+  esp_err_t ret = matrix_led_anim_decode_record(stream->reader, record, length,
+                                                frame, delay_ms, dirty_rows);
+  matrix_led_anim_ring_pop(&stream->ring);
+  xTaskNotifyGive(stream->task);
+  return ret;
+}
+
+uint32_t matrix_led_stream_buffered_frames(matrix_led_stream_t *stream) {
+  return stream ? matrix_led_anim_ring_frames(&stream->ring) : 0;
+}
+
+void matrix_led_stream_stop(matrix_led_stream_t *stream) {
+  if (stream == NULL) {
+    return;
+  }
+
+  stream->stop = true;
+  xTaskNotifyGive(stream->task);
+  xSemaphoreTake(stream->done, portMAX_DELAY);
+
+  vSemaphoreDelete(stream->ready);
+  vSemaphoreDelete(stream->done);
+  free(stream);
+}
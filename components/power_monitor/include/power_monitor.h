@@ -8,11 +8,16 @@
  *
  * Features:
  * - Supply voltage monitoring via GPIO 18 (ADC2_CHANNEL_7) with 11.4:1 divider
+ * - Continuous DMA sampling with CIC decimation and a min/max envelope
+ * - Supply transient capture with pre/post-trigger waveform and CSV export
+ * - Mean, spread, range, 1 s/1 min/1 h windows, p50/p95/p99 and energy
+ * - Binary telemetry log of every power chip sample to SD, with rotation
  * - Real-time voltage monitoring with threshold alarms
  * - Background task for continuous monitoring
  * - Power chip data reception via GPIO 47 (UART1_RX)
  * - 9600 baud rate, 8N1 configuration
  * - Data format: [0xFF header][voltage][current][CRC] (4 bytes)
+ * - UART event driven decoding of every frame, with resynchronization
  * - Real-time voltage, current, power data reading
  * - Protocol analysis and debugging support
  * - 10 dedicated console commands
@@ -29,6 +34,10 @@
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
+#include "power_monitor_decoder.h"
+#include "power_monitor_log.h"
+#include "power_monitor_stats.h"
+#include "power_monitor_waveform.h"
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -46,16 +55,6 @@ extern "C" {
  */
 #define POWER_MONITOR_MAX_THRESHOLDS 8
 
-/**
- * @brief Power chip data packet size
- */
-#define POWER_CHIP_PACKET_SIZE 4
-
-/**
- * @brief Power chip header byte
- */
-#define POWER_CHIP_HEADER 0xFF
-
 /**
  * @brief Voltage divider ratio (11.4:1)
  */
@@ -95,12 +94,19 @@ typedef enum {
  * @brief Voltage monitoring configuration
  */
 typedef struct {
-  int gpio_pin;                /**< ADC GPIO pin (GPIO 18) */
-  float divider_ratio;         /**< Voltage divider ratio */
-  uint32_t sample_interval_ms; /**< Sampling interval in ms */
-  float voltage_min_threshold; /**< Minimum voltage threshold */
-  float voltage_max_threshold; /**< Maximum voltage threshold */
-  bool enable_threshold_alarm; /**< Enable threshold alarm */
+  int gpio_pin;                  /**< ADC GPIO pin (GPIO 18) */
+  float divider_ratio;           /**< Voltage divider ratio */
+  uint32_t sample_interval_ms;   /**< Sampling interval in ms */
+  float voltage_min_threshold;   /**< Minimum voltage threshold */
+  float voltage_max_threshold;   /**< Maximum voltage threshold */
+  bool enable_threshold_alarm;   /**< Enable threshold alarm */
+  uint32_t adc_sample_rate_hz;   /**< Continuous ADC rate (0 = oneshot) */
+  uint16_t decimation_ratio;     /**< ADC samples per record */
+  uint8_t decimation_order;      /**< CIC order (1 = moving average) */
+  float transient_dip_v;         /**< Dip trigger below baseline (0 = off) */
+  float transient_spike_v;       /**< Spike trigger above baseline (0 = off) */
+  uint16_t capture_pre_records;  /**< Records kept before a trigger */
+  uint16_t capture_post_records; /**< Records captured after a trigger */
 } voltage_monitor_config_t;
 
 /**
@@ -112,14 +118,47 @@ typedef struct {
   int baud_rate;              /**< Baud rate (9600) */
   uint32_t timeout_ms;        /**< Communication timeout */
   bool enable_protocol_debug; /**< Enable protocol debugging */
+  bool verify_crc;            /**< Drop frames with a bad checksum */
 } power_chip_config_t;
 
+/**
+ * @brief Telemetry log configuration
+ */
+typedef struct {
+  bool enable;                /**< Start logging with the monitor */
+  char directory[32];         /**< Log directory, e.g. /sdcard/power */
+  uint32_t max_file_bytes;    /**< Rotate after this size (0 = no limit) */
+  uint32_t max_file_seconds;  /**< Rotate after this time (0 = no limit) */
+  uint16_t max_files;         /**< Delete the oldest beyond this (0 = keep) */
+  uint32_t flush_interval_ms; /**< Write a partly filled block after this */
+  uint32_t ring_samples;      /**< Ring size, rounded up to a power of 2 */
+} power_monitor_log_config_t;
+
+/**
+ * @brief Telemetry log status
+ */
+typedef struct {
+  bool running;             /**< Writer task active */
+  uint32_t session;         /**< Session number in the block headers */
+  uint32_t file_index;      /**< Current file number */
+  uint32_t file_bytes;      /**< Bytes in the current file */
+  uint32_t files_opened;    /**< Files started this session */
+  uint32_t blocks_written;  /**< Blocks written this session */
+  uint32_t samples_logged;  /**< Samples written this session */
+  uint32_t samples_dropped; /**< Samples lost to a full ring */
+  uint32_t write_errors;    /**< Failed block writes */
+  uint32_t ring_fill;       /**< Samples waiting in the ring */
+  uint32_t ring_high_water; /**< Highest ring fill this session */
+  uint32_t ring_capacity;   /**< Ring size */
+} power_monitor_log_status_t;
+
 /**
  * @brief Power monitor configuration
  */
 typedef struct {
   voltage_monitor_config_t voltage_config; /**< Voltage monitoring config */
   power_chip_config_t power_chip_config;   /**< Power chip config */
+  power_monitor_log_config_t log_config;   /**< Telemetry log config */
   bool auto_start_monitoring;              /**< Auto start monitoring on init */
   uint32_t task_stack_size;                /**< Monitoring task stack size */
   int task_priority;                       /**< Monitoring task priority */
@@ -131,6 +170,8 @@ typedef struct {
 typedef struct {
   float supply_voltage; /**< Supply voltage in volts */
   uint32_t timestamp;   /**< Timestamp in milliseconds */
+  float min_voltage;    /**< Lowest sample since the previous reading */
+  float max_voltage;    /**< Highest sample since the previous reading */
 } voltage_monitor_data_t;
 
 /**
@@ -144,6 +185,8 @@ typedef struct {
   uint8_t raw_data[POWER_CHIP_PACKET_SIZE]; /**< Raw packet data */
   uint32_t timestamp;                       /**< Timestamp in milliseconds */
   bool crc_valid;                           /**< CRC validation result */
+  int64_t timestamp_us;                     /**< Arrival time (esp_timer) */
+  uint32_t sequence;                        /**< Frame number */
 } power_chip_data_t;
 
 /**
@@ -155,10 +198,24 @@ typedef struct {
   uint32_t crc_errors;           /**< CRC error count */
   uint32_t timeout_errors;       /**< Timeout error count */
   uint32_t threshold_violations; /**< Threshold violation count */
+  uint32_t resync_count;         /**< Times the frame boundary was lost */
+  uint32_t skipped_bytes;        /**< Bytes dropped between frames */
+  uint32_t uart_overflows;       /**< UART FIFO/buffer overflows */
+  uint64_t adc_samples;          /**< Continuous ADC samples processed */
+  uint32_t adc_overruns;         /**< ADC DMA pool overflows */
+  uint32_t transient_captures;   /**< Supply transients captured */
   uint64_t uptime_ms;            /**< Uptime in milliseconds */
   float avg_voltage;             /**< Average voltage */
   float avg_current;             /**< Average current */
   float avg_power;               /**< Average power */
+
+  // Statistics engine, filled in by power_monitor_get_stats()
+  double energy_wh;                            /**< Energy since reset (Wh) */
+  uint32_t energy_gaps;                        /**< Gaps left out of energy */
+  uint32_t energy_gap_ms;                      /**< Time in those gaps */
+  power_stats_channel_summary_t voltage_stats; /**< Supply voltage (V) */
+  power_stats_channel_summary_t current_stats; /**< Current (A) */
+  power_stats_channel_summary_t power_stats;   /**< Power (W) */
 } power_monitor_stats_t;
 
 /**
@@ -169,9 +226,34 @@ typedef enum {
   POWER_MONITOR_EVENT_POWER_DATA_RECEIVED, /**< Power data received event */
   POWER_MONITOR_EVENT_CRC_ERROR,           /**< CRC error event */
   POWER_MONITOR_EVENT_TIMEOUT_ERROR,       /**< Timeout error event */
+  POWER_MONITOR_EVENT_VOLTAGE_TRANSIENT,   /**< Supply transient captured */
   POWER_MONITOR_EVENT_MAX,                 /**< Maximum event type */
 } power_monitor_event_type_t;
 
+/**
+ * @brief Supply voltage transient capture
+ */
+typedef struct {
+  uint32_t number;           /**< Capture number (0 = none yet) */
+  int64_t trigger_time_us;   /**< End of the trigger record (esp_timer) */
+  uint32_t record_period_us; /**< Time between records */
+  uint16_t count;            /**< Records in the capture */
+  uint16_t trigger_index;    /**< Index of the trigger record */
+  bool dip;                  /**< true for a dip, false for a spike */
+  float baseline_voltage;    /**< Supply voltage before the transient */
+  float extreme_voltage;     /**< Lowest (dip) or highest (spike) voltage */
+  uint16_t outside_records;  /**< Records outside the trigger band */
+} power_monitor_capture_info_t;
+
+/**
+ * @brief One record of a transient capture
+ */
+typedef struct {
+  float mean_voltage; /**< Decimated voltage */
+  float min_voltage;  /**< Lowest sample in the record */
+  float max_voltage;  /**< Highest sample in the record */
+} power_monitor_capture_record_t;
+
 /**
  * @brief Power monitor event callback function
  */
@@ -189,7 +271,9 @@ esp_err_t power_monitor_init(const power_monitor_config_t *config);
 /**
  * @brief Deinitialize power monitor component
  *
- * @return esp_err_t ESP_OK on success, error code otherwise
+ * @return esp_err_t ESP_OK on success, ESP_ERR_TIMEOUT if the monitor or log
+ *         tasks did not exit in time (nothing is released, call again),
+ *         error code otherwise
  */
 esp_err_t power_monitor_deinit(void);
 
@@ -203,7 +287,11 @@ esp_err_t power_monitor_start(void);
 /**
  * @brief Stop power monitoring
  *
- * @return esp_err_t ESP_OK on success, error code otherwise
+ * Waits for the monitor and continuous ADC tasks to exit before stopping the
+ * ADC.
+ *
+ * @return esp_err_t ESP_OK on success, ESP_ERR_TIMEOUT if a task did not exit
+ *         in time (the next call finishes the stop), error code otherwise
  */
 esp_err_t power_monitor_stop(void);
 
@@ -226,6 +314,11 @@ esp_err_t power_monitor_get_power_chip_data(power_chip_data_t *data);
 /**
  * @brief Get power monitor statistics
  *
+ * Averages and summaries come from the statistics engine (see
+ * power_monitor_stats.h): supply voltage from every decimated record (or
+ * every reading without the DMA stream), current and power from every
+ * power chip frame, windows ending at the time of the call.
+ *
  * @param stats Pointer to store statistics
  * @return esp_err_t ESP_OK on success, error code otherwise
  */
@@ -308,6 +401,84 @@ esp_err_t power_monitor_unregister_callback(void);
  */
 esp_err_t power_monitor_set_debug_mode(bool enable);
 
+/**
+ * @brief Enable/disable power chip checksum verification
+ *
+ * With verification disabled, every frame that starts with a header is
+ * accepted and a checksum mismatch is only counted.
+ *
+ * @param enable True to drop frames with a bad checksum
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t power_monitor_set_crc_check(bool enable);
+
+/**
+ * @brief Set the supply transient trigger levels
+ *
+ * Levels are relative to the slowly tracked supply voltage, so they do not
+ * need to follow the nominal supply. Only used with continuous sampling.
+ *
+ * @param dip_voltage Trigger this far below the baseline (0 = off)
+ * @param spike_voltage Trigger this far above the baseline (0 = off)
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t power_monitor_set_transient_trigger(float dip_voltage,
+                                              float spike_voltage);
+
+/**
+ * @brief Get the last supply transient capture
+ *
+ * Copies up to max_records records, oldest first; the trigger record is at
+ * info->trigger_index.
+ *
+ * @param info Capture description
+ * @param records Output records (may be NULL)
+ * @param max_records Capacity of records
+ * @return esp_err_t ESP_OK, ESP_ERR_NOT_FOUND if nothing was captured yet,
+ *         ESP_ERR_NOT_SUPPORTED without continuous sampling
+ */
+esp_err_t power_monitor_get_capture(power_monitor_capture_info_t *info,
+                                    power_monitor_capture_record_t *records,
+                                    size_t max_records);
+
+/**
+ * @brief Write the last supply transient capture as CSV
+ *
+ * Columns: time relative to the trigger (ms), mean, min and max voltage.
+ *
+ * @param path Output file, e.g. on the SD card
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t power_monitor_export_capture(const char *path);
+
+/**
+ * @brief Start logging every power chip sample to the SD card
+ *
+ * Files are <directory>/pwrNNNNN.bin, numbered on from the highest one
+ * already there. See power_monitor_log.h for the format and
+ * tests/host/power_log_decode.c to turn them into CSV.
+ *
+ * @param config Log configuration, NULL for the one given at init
+ * @return esp_err_t ESP_OK, ESP_ERR_INVALID_STATE if already logging or the
+ *         card is not mounted, ESP_ERR_NO_MEM, or a filesystem error
+ */
+esp_err_t power_monitor_log_start(const power_monitor_log_config_t *config);
+
+/**
+ * @brief Stop logging, writing out the samples still buffered
+ *
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t power_monitor_log_stop(void);
+
+/**
+ * @brief Get the telemetry log status
+ *
+ * @param status Status
+ * @return esp_err_t ESP_OK on success, error code otherwise
+ */
+esp_err_t power_monitor_log_get_status(power_monitor_log_status_t *status);
+
 /**
  * @brief Get component status
  *
@@ -0,0 +1,147 @@
+/**
+ * @file power_monitor_decoder.h
+ * @brief Streaming frame decoder for the power chip UART
+ *
+ * The power chip sends 4-byte frames back to back:
+ * [0xFF header][voltage][current][checksum], where the checksum is the low
+ * byte of the sum of the first three bytes. The payload bytes may also be
+ * 0xFF, so a header byte alone does not mark a frame boundary.
+ *
+ * The decoder is a small state machine over a 4-byte ring. While hunting it
+ * drops bytes until a header arrives, then collects the next three. A full
+ * window with a matching checksum is emitted as a sample and the decoder is
+ * locked to the stream. A mismatch drops only the oldest byte and rescans
+ * the rest of the window for the next header, so a lost or corrupted byte
+ * costs at most the frames it touches and the decoder finds the boundary
+ * again within one frame. Mismatches while locked are counted as checksum
+ * errors; mismatches while hunting are just false headers.
+ *
+ * Every sample is stamped with the arrival time of its last byte, worked
+ * back from the time the chunk was read and the byte time at the baud rate,
+ * so frames read together in one burst keep their spacing.
+ *
+ * Not thread-safe: feed and reset must be called from the task that reads
+ * the UART.
+ *
+ * This module does not depend on FreeRTOS or the UART driver and can be
+ * compiled on the host (see tests/host/bench_power_decoder.c).
+ */
+
+#ifndef POWER_MONITOR_DECODER_H
+#define POWER_MONITOR_DECODER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Power chip data packet size
+ */
+#define POWER_CHIP_PACKET_SIZE 4
+
+/**
+ * @brief Power chip header byte
+ */
+#define POWER_CHIP_HEADER 0xFF
+
+#define POWER_CHIP_VOLTAGE_LSB 1.0f /**< Volts per voltage unit */
+#define POWER_CHIP_CURRENT_LSB 0.1f /**< Amperes per current unit */
+
+/**
+ * @brief One decoded power chip frame
+ */
+typedef struct {
+  uint8_t raw[POWER_CHIP_PACKET_SIZE]; /**< Frame bytes */
+  float voltage;                       /**< Voltage in volts */
+  float current;                       /**< Current in amperes */
+  float power;                         /**< Power in watts */
+  int64_t timestamp_us;                /**< Arrival of the last byte (us) */
+  uint32_t sequence;                   /**< Frame number since reset */
+  bool crc_valid;                      /**< Checksum matched */
+} power_chip_sample_t;
+
+/**
+ * @brief Decoder counters
+ */
+typedef struct {
+  uint32_t frames;        /**< Frames emitted */
+  uint32_t crc_errors;    /**< Checksum mismatches while locked */
+  uint32_t resyncs;       /**< Times the decoder lost the frame boundary */
+  uint32_t skipped_bytes; /**< Bytes dropped while hunting for a header */
+} power_chip_decoder_stats_t;
+
+/**
+ * @brief Decoder state
+ */
+typedef struct {
+  uint8_t window[POWER_CHIP_PACKET_SIZE]; /**< Candidate bytes (ring) */
+  uint8_t head;                           /**< Oldest byte in the ring */
+  uint8_t count;                          /**< Bytes in the ring */
+  bool locked;                            /**< Locked to the frame boundary */
+  bool verify_crc;                        /**< Drop bad checksums */
+  uint32_t byte_time_us;                  /**< Byte time on the wire (8N1) */
+  uint32_t sequence;                      /**< Next sample sequence number */
+  power_chip_decoder_stats_t stats;       /**< Counters */
+} power_chip_decoder_t;
+
+/**
+ * @brief Initialize a decoder
+ *
+ * @param decoder Decoder to initialize
+ * @param baud_rate UART baud rate, used to space sample timestamps
+ * @param verify_crc true to drop frames whose checksum does not match.
+ *        false accepts every frame that starts with a header while locked
+ *        and only flags it through crc_valid (for chips with an unknown
+ *        checksum)
+ */
+void power_chip_decoder_init(power_chip_decoder_t *decoder, int baud_rate,
+                             bool verify_crc);
+
+/**
+ * @brief Drop buffered bytes and the frame lock, keeping the counters
+ *
+ * Call after the UART driver discarded data (FIFO or buffer overflow).
+ *
+ * @param decoder Decoder
+ */
+void power_chip_decoder_reset(power_chip_decoder_t *decoder);
+
+/**
+ * @brief Check the checksum of one frame
+ *
+ * @param frame POWER_CHIP_PACKET_SIZE bytes
+ * @return true if the frame starts with a header and the checksum matches
+ */
+bool power_chip_frame_valid(const uint8_t *frame);
+
+/**
+ * @brief Feed received bytes
+ *
+ * Decodes until the input is used up or max_samples samples were emitted.
+ * In the second case, feed the rest (data + *consumed) again with the same
+ * end_time_us.
+ *
+ * @param decoder Decoder
+ * @param data Received bytes
+ * @param len Number of bytes
+ * @param end_time_us Arrival time of the last byte of data (us)
+ * @param samples Output samples
+ * @param max_samples Capacity of samples
+ * @param consumed Bytes used from data (may be NULL)
+ * @return Number of samples written
+ */
+size_t power_chip_decoder_feed(power_chip_decoder_t *decoder,
+                               const uint8_t *data, size_t len,
+                               int64_t end_time_us,
+                               power_chip_sample_t *samples,
+                               size_t max_samples, size_t *consumed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POWER_MONITOR_DECODER_H
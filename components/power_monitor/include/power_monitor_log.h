@@ -0,0 +1,240 @@
+/**
+ * @file power_monitor_log.h
+ * @brief Power telemetry log: sample ring and binary block format
+ *
+ * The sampling task pushes every power chip sample into a single-producer/
+ * single-consumer ring; it never blocks and never waits for the card. When
+ * the ring is full the sample is dropped and counted, and the next sample
+ * that fits carries POWER_LOG_FLAG_DROPPED.
+ *
+ * A writer task drains the ring into fixed-size blocks of
+ * POWER_LOG_BLOCK_SIZE bytes, so the file grows in whole, aligned blocks:
+ *
+ *     header (32 bytes, little endian)
+ *       u32 magic "PWLG", u16 version, u16 record count, u32 session,
+ *       u32 block sequence, i64 time of the first record (us),
+ *       u32 samples dropped so far, u32 CRC-32 of the block
+ *     records (8 bytes each, POWER_LOG_BLOCK_RECORDS per block)
+ *       u32 time since the previous record (us, low 24 bits) | flags << 24
+ *       u16 voltage (mV), u16 current (mA)
+ *     zero padding up to the block size
+ *
+ * The CRC is computed with its own field set to zero, so a block torn by
+ * a power loss or a card removal is recognized and skipped on decoding.
+ * The session number changes every time the logger starts; within a
+ * session the block sequence has no holes unless a write failed.
+ *
+ * This module does not depend on FreeRTOS or the filesystem and can be
+ * compiled on the host (see tests/host/bench_power_log.c and
+ * tests/host/power_log_decode.c).
+ */
+
+#ifndef POWER_MONITOR_LOG_H
+#define POWER_MONITOR_LOG_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POWER_LOG_MAGIC 0x474C5750u     /**< "PWLG" read as little endian */
+#define POWER_LOG_VERSION 1             /**< Block format version */
+#define POWER_LOG_BLOCK_SIZE 4096       /**< Bytes per block */
+#define POWER_LOG_HEADER_SIZE 32        /**< Bytes of block header */
+#define POWER_LOG_RECORD_SIZE 8         /**< Bytes per record */
+#define POWER_LOG_MAX_DELTA_US 0xFFFFFF /**< Largest time step in a block */
+#define POWER_LOG_BLOCK_RECORDS                                                \
+  ((POWER_LOG_BLOCK_SIZE - POWER_LOG_HEADER_SIZE) / POWER_LOG_RECORD_SIZE)
+
+/**
+ * @brief Sample flags
+ */
+typedef enum {
+  POWER_LOG_FLAG_CRC_INVALID = 0x01, /**< Frame failed its checksum */
+  POWER_LOG_FLAG_FRAME_GAP = 0x02,   /**< Frames lost on the UART before */
+  POWER_LOG_FLAG_TRANSIENT = 0x04,   /**< Supply transient captured before */
+  POWER_LOG_FLAG_THRESHOLD = 0x08,   /**< Supply left its thresholds before */
+  POWER_LOG_FLAG_DROPPED = 0x10,     /**< Samples dropped by a full ring */
+} power_log_flag_t;
+
+/**
+ * @brief One logged sample
+ */
+typedef struct {
+  int64_t time_us;     /**< Sample time (esp_timer) */
+  uint16_t voltage_mv; /**< Voltage */
+  uint16_t current_ma; /**< Current */
+  uint8_t flags;       /**< power_log_flag_t bits */
+} power_log_sample_t;
+
+/**
+ * @brief Single-producer/single-consumer sample ring
+ *
+ * head and tail are free-running counters, each written by one side only.
+ */
+typedef struct {
+  power_log_sample_t *samples; /**< Storage */
+  uint32_t capacity;           /**< Samples (power of two) */
+  uint32_t head;               /**< Next write (producer) */
+  uint32_t tail;               /**< Next read (consumer) */
+  uint32_t dropped;            /**< Samples refused while full (producer) */
+  uint32_t high_water;         /**< Highest fill seen (producer) */
+  bool overflowed;             /**< Flag the next sample (producer) */
+} power_log_ring_t;
+
+/**
+ * @brief Block encoder (writer side)
+ */
+typedef struct {
+  uint8_t *block;    /**< POWER_LOG_BLOCK_SIZE bytes */
+  uint16_t count;    /**< Records in the block */
+  int64_t base_us;   /**< Time of the first record */
+  int64_t last_us;   /**< Time of the last record */
+  uint32_t session;  /**< Session number */
+  uint32_t sequence; /**< Sequence of the block being filled */
+} power_log_encoder_t;
+
+/**
+ * @brief Header of a decoded block
+ */
+typedef struct {
+  uint32_t session;  /**< Session number */
+  uint32_t sequence; /**< Block sequence within the session */
+  uint16_t count;    /**< Records */
+  int64_t base_us;   /**< Time of the first record */
+  uint32_t dropped;  /**< Samples dropped before the block was written */
+} power_log_block_info_t;
+
+/**
+ * @brief Allocate a ring
+ *
+ * @param ring Ring
+ * @param capacity Samples, a power of two
+ * @return ESP_OK, ESP_ERR_INVALID_ARG or ESP_ERR_NO_MEM
+ */
+esp_err_t power_log_ring_init(power_log_ring_t *ring, uint32_t capacity);
+
+/**
+ * @brief Free a ring
+ *
+ * @param ring Ring
+ */
+void power_log_ring_deinit(power_log_ring_t *ring);
+
+/**
+ * @brief Add a sample (producer, never blocks)
+ *
+ * @param ring Ring
+ * @param sample Sample
+ * @return false if the ring was full and the sample was dropped
+ */
+bool power_log_ring_push(power_log_ring_t *ring,
+                         const power_log_sample_t *sample);
+
+/**
+ * @brief Take samples (consumer)
+ *
+ * @param ring Ring
+ * @param samples Output
+ * @param max Capacity of samples
+ * @return Samples taken, oldest first
+ */
+size_t power_log_ring_pop(power_log_ring_t *ring, power_log_sample_t *samples,
+                          size_t max);
+
+/**
+ * @brief Samples waiting in the ring (either side)
+ *
+ * @param ring Ring
+ * @return Fill
+ */
+uint32_t power_log_ring_count(const power_log_ring_t *ring);
+
+/**
+ * @brief Convert a measurement to a sample
+ *
+ * Values are rounded and clamped to 0..65535 mV / mA.
+ *
+ * @param time_us Sample time
+ * @param voltage Voltage (V)
+ * @param current Current (A)
+ * @param flags power_log_flag_t bits
+ * @return Sample
+ */
+power_log_sample_t power_log_make_sample(int64_t time_us, float voltage,
+                                         float current, uint8_t flags);
+
+/**
+ * @brief Start an encoder
+ *
+ * @param encoder Encoder
+ * @param block Block buffer (POWER_LOG_BLOCK_SIZE bytes)
+ * @param session Session number
+ */
+void power_log_encoder_init(power_log_encoder_t *encoder, uint8_t *block,
+                            uint32_t session);
+
+/**
+ * @brief Append a sample to the current block
+ *
+ * @param encoder Encoder
+ * @param sample Sample
+ * @return false if the block is full or the time step does not fit (or
+ *         goes backwards); finish the block and add the sample again
+ */
+bool power_log_encoder_add(power_log_encoder_t *encoder,
+                           const power_log_sample_t *sample);
+
+/**
+ * @brief Seal the current block for writing and start the next one
+ *
+ * Fills the header, zeroes the unused records and computes the CRC. The
+ * block buffer holds the sealed block until the next power_log_encoder_add().
+ *
+ * @param encoder Encoder
+ * @param dropped Samples dropped so far in this session
+ */
+void power_log_encoder_finish(power_log_encoder_t *encoder, uint32_t dropped);
+
+/**
+ * @brief Check and parse a block header
+ *
+ * @param block POWER_LOG_BLOCK_SIZE bytes
+ * @param info Header
+ * @return ESP_OK, ESP_ERR_NOT_FOUND (no block magic, e.g. unwritten space),
+ *         ESP_ERR_NOT_SUPPORTED (other version) or ESP_ERR_INVALID_CRC
+ */
+esp_err_t power_log_block_parse(const uint8_t *block,
+                                power_log_block_info_t *info);
+
+/**
+ * @brief Decode the records of a parsed block
+ *
+ * @param block POWER_LOG_BLOCK_SIZE bytes, checked by power_log_block_parse()
+ * @param info Its header
+ * @param samples Output, at least info->count entries
+ * @return Samples decoded
+ */
+size_t power_log_block_decode(const uint8_t *block,
+                              const power_log_block_info_t *info,
+                              power_log_sample_t *samples);
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected)
+ *
+ * @param crc Previous value (0 to start)
+ * @param data Data
+ * @param length Bytes
+ * @return Updated CRC
+ */
+uint32_t power_log_crc32(uint32_t crc, const uint8_t *data, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POWER_MONITOR_LOG_H
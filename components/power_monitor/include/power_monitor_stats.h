@@ -0,0 +1,261 @@
+/**
+ * @file power_monitor_stats.h
+ * @brief Streaming statistics for supply voltage, current and power
+ *
+ * Every channel keeps, in constant memory:
+ *
+ * - Totals since the last reset: count, mean and variance with Welford's
+ *   update in double precision, plus min and max. The mean does not drift
+ *   however many samples are added.
+ * - Sliding windows of 1 s, 1 min and 1 h. Each window is a ring of
+ *   POWER_STATS_WINDOW_BUCKETS Welford accumulators, one per bucket of
+ *   window / POWER_STATS_WINDOW_BUCKETS; a query merges the buckets that
+ *   are still inside the window (Chan's parallel combination), so a window
+ *   covers the current bucket and the ones before it, between
+ *   (buckets - 1) and buckets bucket lengths of time.
+ * - p50, p95 and p99 since the last reset, with one P-square estimator
+ *   (Jain and Chlamtac) per quantile: five markers each, no sample buffer.
+ *
+ * Energy is the trapezoidal integral of the power samples over their own
+ * timestamps, so bursts and uneven spacing are weighted by the real time
+ * between samples. A gap longer than max_gap_us (or time going backwards)
+ * is not integrated across and is counted instead.
+ *
+ * Not thread-safe: the caller serializes updates and queries.
+ *
+ * This module does not depend on FreeRTOS and can be compiled on the host
+ * (see tests/host/bench_power_stats.c).
+ */
+
+#ifndef POWER_MONITOR_STATS_H
+#define POWER_MONITOR_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POWER_STATS_WINDOW_BUCKETS 10 /**< Buckets per sliding window */
+#define POWER_STATS_P2_MARKERS 5      /**< Markers per P-square estimator */
+
+/**
+ * @brief Measured quantities
+ */
+typedef enum {
+  POWER_STATS_VOLTAGE, /**< Supply voltage (V) */
+  POWER_STATS_CURRENT, /**< Power chip current (A) */
+  POWER_STATS_POWER,   /**< Power chip power (W) */
+  POWER_STATS_CHANNEL_COUNT,
+} power_stats_channel_t;
+
+/**
+ * @brief Sliding windows
+ */
+typedef enum {
+  POWER_STATS_WINDOW_1S, /**< Last second */
+  POWER_STATS_WINDOW_1M, /**< Last minute */
+  POWER_STATS_WINDOW_1H, /**< Last hour */
+  POWER_STATS_WINDOW_COUNT,
+} power_stats_window_t;
+
+/**
+ * @brief Tracked quantiles
+ */
+typedef enum {
+  POWER_STATS_P50, /**< Median */
+  POWER_STATS_P95, /**< 95th percentile */
+  POWER_STATS_P99, /**< 99th percentile */
+  POWER_STATS_QUANTILE_COUNT,
+} power_stats_quantile_t;
+
+/**
+ * @brief Welford accumulator
+ */
+typedef struct {
+  uint64_t count; /**< Samples */
+  double mean;    /**< Running mean */
+  double m2;      /**< Sum of squared deviations from the mean */
+  float min;      /**< Smallest sample */
+  float max;      /**< Largest sample */
+} power_stats_acc_t;
+
+/**
+ * @brief Ring of bucket accumulators behind one sliding window
+ */
+typedef struct {
+  power_stats_acc_t buckets[POWER_STATS_WINDOW_BUCKETS]; /**< Ring */
+
+  int64_t head_id;    /**< Bucket number (time / bucket_us) at head */
+  uint32_t bucket_us; /**< Bucket length */
+  uint8_t head;       /**< Newest bucket */
+} power_stats_ring_t;
+
+/**
+ * @brief P-square estimator of one quantile
+ */
+typedef struct {
+  float p;                                  /**< Quantile (0..1) */
+  float height[POWER_STATS_P2_MARKERS];     /**< Marker heights */
+  int64_t position[POWER_STATS_P2_MARKERS]; /**< Marker positions */
+  uint64_t count;                           /**< Samples seen */
+} power_stats_p2_t;
+
+/**
+ * @brief Everything kept for one channel
+ */
+typedef struct {
+  power_stats_acc_t total;                                /**< Since reset */
+  power_stats_ring_t windows[POWER_STATS_WINDOW_COUNT];   /**< Sliding */
+  power_stats_p2_t quantiles[POWER_STATS_QUANTILE_COUNT]; /**< Since reset */
+} power_stats_series_t;
+
+/**
+ * @brief Statistics engine
+ */
+typedef struct {
+  power_stats_series_t series[POWER_STATS_CHANNEL_COUNT]; /**< Channels */
+
+  // Energy
+  double energy_wh;      /**< Integrated energy */
+  float last_power;      /**< Previous power sample (W) */
+  int64_t last_power_us; /**< Time of the previous power sample */
+  bool have_power;       /**< last_power is valid */
+  uint32_t max_gap_us;   /**< Longest interval integrated across */
+  uint32_t energy_gaps;  /**< Intervals left out of the integral */
+  uint64_t gap_us;       /**< Time left out of the integral */
+} power_stats_engine_t;
+
+/**
+ * @brief Mean, spread and range of a set of samples
+ */
+typedef struct {
+  uint64_t count; /**< Samples */
+  float mean;     /**< Mean */
+  float stddev;   /**< Sample standard deviation */
+  float min;      /**< Smallest sample */
+  float max;      /**< Largest sample */
+} power_stats_summary_t;
+
+/**
+ * @brief Statistics of one channel at a point in time
+ */
+typedef struct {
+  power_stats_summary_t total;                            /**< Since reset */
+  power_stats_summary_t window[POWER_STATS_WINDOW_COUNT]; /**< Sliding */
+  float quantile[POWER_STATS_QUANTILE_COUNT];             /**< Since reset */
+} power_stats_channel_summary_t;
+
+/**
+ * @brief Initialize (or reset) an engine
+ *
+ * @param engine Engine
+ * @param max_gap_us Longest interval between power samples that is still
+ *        integrated into the energy
+ */
+void power_stats_init(power_stats_engine_t *engine, uint32_t max_gap_us);
+
+/**
+ * @brief Add one sample
+ *
+ * Samples older than the newest bucket of a window still count towards the
+ * totals and quantiles, and towards the windows while their bucket is in
+ * range. Non-finite values are ignored.
+ *
+ * @param engine Engine
+ * @param channel Channel
+ * @param value Sample
+ * @param time_us Sample time (us, monotonic)
+ */
+void power_stats_add(power_stats_engine_t *engine,
+                     power_stats_channel_t channel, float value,
+                     int64_t time_us);
+
+/**
+ * @brief Add a power sample and integrate it into the energy
+ *
+ * Same as power_stats_add() on POWER_STATS_POWER, plus the energy update.
+ *
+ * @param engine Engine
+ * @param power_w Power (W)
+ * @param time_us Sample time (us, monotonic)
+ */
+void power_stats_add_power(power_stats_engine_t *engine, float power_w,
+                           int64_t time_us);
+
+/**
+ * @brief Summarize one channel
+ *
+ * @param engine Engine
+ * @param channel Channel
+ * @param now_us Current time; windows end here
+ * @param summary Output
+ */
+void power_stats_summarize(const power_stats_engine_t *engine,
+                           power_stats_channel_t channel, int64_t now_us,
+                           power_stats_channel_summary_t *summary);
+
+/**
+ * @brief Reset an accumulator
+ *
+ * @param acc Accumulator
+ */
+void power_stats_acc_reset(power_stats_acc_t *acc);
+
+/**
+ * @brief Add a sample to an accumulator (Welford)
+ *
+ * @param acc Accumulator
+ * @param value Sample
+ */
+void power_stats_acc_add(power_stats_acc_t *acc, double value);
+
+/**
+ * @brief Merge one accumulator into another (Chan et al.)
+ *
+ * @param acc Destination
+ * @param other Accumulator to merge in
+ */
+void power_stats_acc_merge(power_stats_acc_t *acc,
+                           const power_stats_acc_t *other);
+
+/**
+ * @brief Initialize a P-square estimator
+ *
+ * @param p2 Estimator
+ * @param p Quantile (0..1)
+ */
+void power_stats_p2_init(power_stats_p2_t *p2, float p);
+
+/**
+ * @brief Add a sample to a P-square estimator
+ *
+ * @param p2 Estimator
+ * @param value Sample
+ */
+void power_stats_p2_add(power_stats_p2_t *p2, float value);
+
+/**
+ * @brief Current estimate of a P-square estimator
+ *
+ * Exact (nearest rank) until five samples were seen.
+ *
+ * @param p2 Estimator
+ * @return Estimate, NAN without samples
+ */
+float power_stats_p2_value(const power_stats_p2_t *p2);
+
+/**
+ * @brief Window length
+ *
+ * @param window Window
+ * @return Length in microseconds
+ */
+uint32_t power_stats_window_us(power_stats_window_t window);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POWER_MONITOR_STATS_H
@@ -0,0 +1,288 @@
+/**
+ * @file power_monitor_waveform.h
+ * @brief Supply voltage waveform: decimation, envelope and transient capture
+ *
+ * The ADC runs continuously (DMA) at a few kHz to a few tens of kHz. Each
+ * raw sample goes through a CIC decimator of configurable order and ratio:
+ * order 1 is a plain moving average over one output window, higher orders
+ * suppress more of the noise folded back by decimation. Every output
+ * record carries the decimated mean (1/16 code resolution) and the minimum
+ * and maximum raw sample of its window, so a dip shorter than one window
+ * still shows in the envelope.
+ *
+ * A transient detector follows a slow baseline (exponential average of the
+ * records) and triggers when a record's envelope leaves the band of
+ * baseline - dip .. baseline + spike. The last records are kept in a ring,
+ * so a capture holds pre_trigger records before the trigger record and
+ * post_trigger records after it. The baseline is frozen while a capture is
+ * running, and the detector re-arms once a record is back inside the band.
+ * A completed capture stays available until the next one completes.
+ *
+ * Records are also accumulated into a report window (mean and envelope
+ * since it was last taken), which replaces the single oneshot read per
+ * sample interval, and can be handed one by one to a record callback.
+ *
+ * Everything is kept in raw ADC codes; the caller converts to volts with
+ * power_wave_scale_t. Not thread-safe: the caller serializes feed and the
+ * readers.
+ *
+ * This module does not depend on FreeRTOS or the ADC driver and can be
+ * compiled on the host (see tests/host/bench_power_waveform.c).
+ */
+
+#ifndef POWER_MONITOR_WAVEFORM_H
+#define POWER_MONITOR_WAVEFORM_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POWER_WAVE_MAX_ORDER 3      /**< Highest CIC order */
+#define POWER_WAVE_MEAN_FRAC_BITS 4 /**< Mean resolution (1/16 code) */
+#define POWER_WAVE_MAX_CODE 4095    /**< Largest raw sample (12 bits) */
+
+/**
+ * @brief Pipeline configuration
+ */
+typedef struct {
+  uint32_t sample_rate_hz; /**< Raw ADC sample rate */
+  uint16_t ratio;          /**< Raw samples per record */
+  uint8_t order;           /**< CIC stages (1 = moving average) */
+  uint16_t pre_trigger;    /**< Records kept before the trigger */
+  uint16_t post_trigger;   /**< Records captured after the trigger */
+  float dip_codes;         /**< Trigger below baseline (codes, 0 = off) */
+  float spike_codes;       /**< Trigger above baseline (codes, 0 = off) */
+  float baseline_records;  /**< Baseline time constant (records) */
+} power_wave_config_t;
+
+/**
+ * @brief One decimated record
+ */
+typedef struct {
+  uint16_t mean; /**< Decimated value (1/16 code) */
+  uint16_t min;  /**< Lowest raw sample in the window */
+  uint16_t max;  /**< Highest raw sample in the window */
+} power_wave_record_t;
+
+/**
+ * @brief Transient direction
+ */
+typedef enum {
+  POWER_WAVE_TRIGGER_DIP,   /**< Envelope fell below the band */
+  POWER_WAVE_TRIGGER_SPIKE, /**< Envelope rose above the band */
+} power_wave_trigger_t;
+
+/**
+ * @brief Description of a completed capture
+ */
+typedef struct {
+  uint32_t number;              /**< Capture number (0 = none yet) */
+  int64_t trigger_time_us;      /**< End of the trigger record */
+  uint32_t record_period_us;    /**< Time between records */
+  uint16_t count;               /**< Records in the capture */
+  uint16_t trigger_index;       /**< Index of the trigger record */
+  float baseline;               /**< Baseline at the trigger (codes) */
+  uint16_t extreme;             /**< Lowest (dip) or highest (spike) code */
+  uint16_t outside_records;     /**< Records outside the band */
+  power_wave_trigger_t trigger; /**< Direction */
+} power_wave_capture_info_t;
+
+/**
+ * @brief Mean and envelope of the records since the window was taken
+ */
+typedef struct {
+  float mean;       /**< Mean (codes) */
+  uint16_t min;     /**< Lowest raw sample */
+  uint16_t max;     /**< Highest raw sample */
+  uint32_t records; /**< Records in the window */
+} power_wave_window_t;
+
+/**
+ * @brief Linear conversion from codes to volts
+ */
+typedef struct {
+  float volts_per_code; /**< Slope, including the divider */
+  float offset_v;       /**< Volts at code 0 */
+} power_wave_scale_t;
+
+/**
+ * @brief Called for every record, from power_wave_feed()
+ *
+ * @param record Record
+ * @param time_us End of the record
+ * @param ctx Context given to power_wave_set_record_callback()
+ */
+typedef void (*power_wave_record_cb_t)(const power_wave_record_t *record,
+                                       int64_t time_us, void *ctx);
+
+/**
+ * @brief Pipeline state
+ */
+typedef struct {
+  power_wave_config_t config; /**< Configuration */
+  uint32_t sample_period_ns;  /**< Time between raw samples */
+  float mean_gain;            /**< 16 / ratio^order */
+
+  // Decimator
+  uint32_t integrator[POWER_WAVE_MAX_ORDER]; /**< Integrators (mod 2^32) */
+  uint32_t comb[POWER_WAVE_MAX_ORDER];       /**< Comb delays */
+  uint16_t phase;                            /**< Samples in this window */
+  uint16_t env_min;                          /**< Window minimum */
+  uint16_t env_max;                          /**< Window maximum */
+  uint8_t warmup;                            /**< Records still settling */
+
+  // History and capture
+  power_wave_record_t *history;      /**< Ring of the last records */
+  power_wave_record_t *capture;      /**< Completed capture */
+  uint16_t history_size;             /**< pre_trigger + 1 + post_trigger */
+  uint16_t history_head;             /**< Next write position */
+  uint32_t history_count;            /**< Records written */
+  uint16_t post_left;                /**< Records still to capture */
+  bool capturing;                    /**< Capture in progress */
+  bool armed;                        /**< Detector may trigger */
+  power_wave_capture_info_t pending; /**< Capture in progress */
+  power_wave_capture_info_t info;    /**< Completed capture */
+
+  // Detector
+  float baseline;      /**< Slow average (codes) */
+  bool baseline_valid; /**< A record has been seen */
+
+  // Outputs
+  power_wave_record_t latest; /**< Last record */
+  int64_t latest_time_us;     /**< End of the last record */
+  power_wave_window_t window; /**< Report window */
+  double window_sum;          /**< Sum of record means (codes) */
+  uint64_t samples;           /**< Raw samples fed */
+  uint32_t records;           /**< Records produced */
+
+  // Record callback
+  power_wave_record_cb_t record_cb; /**< Called per record (may be NULL) */
+  void *record_ctx;                 /**< Context of record_cb */
+} power_wave_t;
+
+/**
+ * @brief Get the default configuration
+ *
+ * 20 kHz, second order CIC decimating by 20 (1 ms records), 200 ms before
+ * and 600 ms after a trigger, baseline over 1 s. Trigger levels are off.
+ *
+ * @return Default configuration
+ */
+power_wave_config_t power_wave_get_default_config(void);
+
+/**
+ * @brief Check a configuration
+ *
+ * @param config Configuration
+ * @return true if the rates fit and the decimator cannot overflow
+ */
+bool power_wave_config_valid(const power_wave_config_t *config);
+
+/**
+ * @brief Initialize the pipeline and allocate its buffers
+ *
+ * @param wave Pipeline
+ * @param config Configuration
+ * @return ESP_OK, ESP_ERR_INVALID_ARG or ESP_ERR_NO_MEM
+ */
+esp_err_t power_wave_init(power_wave_t *wave,
+                          const power_wave_config_t *config);
+
+/**
+ * @brief Free the pipeline buffers
+ *
+ * @param wave Pipeline
+ */
+void power_wave_deinit(power_wave_t *wave);
+
+/**
+ * @brief Change the trigger levels without touching the decimator
+ *
+ * @param wave Pipeline
+ * @param dip_codes Trigger below baseline (codes, 0 = off)
+ * @param spike_codes Trigger above baseline (codes, 0 = off)
+ */
+void power_wave_set_trigger(power_wave_t *wave, float dip_codes,
+                            float spike_codes);
+
+/**
+ * @brief Set the per-record callback
+ *
+ * @param wave Pipeline
+ * @param cb Callback, NULL to remove it
+ * @param ctx Passed to the callback
+ */
+void power_wave_set_record_callback(power_wave_t *wave,
+                                    power_wave_record_cb_t cb, void *ctx);
+
+/**
+ * @brief Feed raw samples
+ *
+ * @param wave Pipeline
+ * @param samples Raw 12-bit samples, oldest first
+ * @param count Number of samples
+ * @param end_time_us Time of the last sample (us)
+ * @return Number of captures completed by these samples
+ */
+size_t power_wave_feed(power_wave_t *wave, const uint16_t *samples,
+                       size_t count, int64_t end_time_us);
+
+/**
+ * @brief Take the report window and start a new one
+ *
+ * @param wave Pipeline
+ * @param window Mean and envelope since the last call
+ * @return false if no record was produced since the last call
+ */
+bool power_wave_take_window(power_wave_t *wave, power_wave_window_t *window);
+
+/**
+ * @brief Copy the completed capture
+ *
+ * @param wave Pipeline
+ * @param info Capture description
+ * @param records Output records (may be NULL to get only the description)
+ * @param max_records Capacity of records
+ * @return Number of records copied, 0 if there is no capture yet
+ */
+size_t power_wave_copy_capture(const power_wave_t *wave,
+                               power_wave_capture_info_t *info,
+                               power_wave_record_t *records,
+                               size_t max_records);
+
+/**
+ * @brief Convert codes to volts
+ *
+ * @param scale Conversion
+ * @param codes Value in codes
+ * @return Volts
+ */
+float power_wave_to_volts(const power_wave_scale_t *scale, float codes);
+
+/**
+ * @brief Write a capture as CSV
+ *
+ * One row per record: time relative to the trigger (ms), mean, min and
+ * max (V).
+ *
+ * @param f Output file
+ * @param info Capture description
+ * @param records Capture records
+ * @param scale Conversion to volts
+ * @return ESP_OK or ESP_FAIL on a write error
+ */
+esp_err_t power_wave_write_csv(FILE *f, const power_wave_capture_info_t *info,
+                               const power_wave_record_t *records,
+                               const power_wave_scale_t *scale);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POWER_MONITOR_WAVEFORM_H
@@ -17,28 +17,63 @@
 #include "driver/uart.h"
 #include "esp_adc/adc_cali.h"
 #include "esp_adc/adc_cali_scheme.h"
+#include "esp_adc/adc_continuous.h"
 #include "esp_adc/adc_oneshot.h"
 #include "esp_err.h"
 #include "esp_log.h"
+#include "esp_random.h"
 #include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/queue.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
+#include "storage_fs.h"
+#include "storage_manager.h"
 #include <math.h>
+#include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 
 static const char *TAG = "power_monitor";
 
-// Power chip protocol constants (based on README documentation)
-#define POWER_CHIP_START_BYTE 0xFF // Packet start marker (header byte)
+// Power chip UART reception
+#define POWER_CHIP_READ_CHUNK 64 // Bytes read from the UART driver per call
+#define POWER_CHIP_SAMPLE_BATCH (POWER_CHIP_READ_CHUNK / POWER_CHIP_PACKET_SIZE)
+#define POWER_CHIP_RX_FULL_THRESHOLD 16 // Report data after 4 frames at most
+#define POWER_CHIP_RX_TIMEOUT 2         // or after 2 idle byte times
+
+// Periodic jobs of the monitor task
+#define VOLTAGE_CHECK_INTERVAL_MS 5000 // Voltage change check
+#define HEARTBEAT_INTERVAL_MS 30000    // Debug heartbeat
+
+// Continuous supply voltage sampling
+#define POWER_ADC_FRAME_SIZE 256 // Bytes per DMA conversion frame
+#define POWER_ADC_FRAME_SAMPLES                                                \
+  (POWER_ADC_FRAME_SIZE / SOC_ADC_DIGI_RESULT_BYTES)
+#define POWER_ADC_POOL_SIZE (4 * POWER_ADC_FRAME_SIZE) // Driver result pool
+#define POWER_ADC_READ_TIMEOUT_MS 100
+#define POWER_ADC_TASK_STACK_SIZE 3072
+#define POWER_TASK_STOP_TIMEOUT_MS 1000
+#define POWER_CAPTURE_DEFAULT_PATH "/sdcard/power_capture.csv"
+
+// Statistics engine
+#define POWER_STATS_MAX_GAP_US 1000000 // Longest power gap still integrated
+
+// Telemetry log
+#define POWER_LOG_TASK_STACK_SIZE 4096
+#define POWER_LOG_TASK_PRIORITY 2 // Below the monitor and ADC tasks
+#define POWER_LOG_POLL_MS 100     // Ring drain period of the writer
+#define POWER_LOG_BATCH 32        // Samples taken from the ring at a time
+#define POWER_LOG_STOP_TIMEOUT_MS 1000
+#define POWER_LOG_FILE_PREFIX "pwr"
+#define POWER_LOG_DEFAULT_DIR "/sdcard/power"
 
 /**
  * @brief Power monitor state structure
  */
 typedef struct {
   bool initialized;              /**< Initialization flag */
-  bool running;                  /**< Running flag */
+  volatile bool running;         /**< Running flag, tasks exit when cleared */
   power_monitor_config_t config; /**< Configuration */
 
   // Voltage monitoring
@@ -48,36 +83,71 @@ typedef struct {
   float last_supply_voltage;             /**< Last recorded supply voltage */
   float voltage_threshold;               /**< Voltage change threshold */
 
+  // Continuous sampling (NULL handle: oneshot reads only)
+  adc_continuous_handle_t adc_cont_handle; /**< Continuous ADC handle */
+  power_wave_t wave;                       /**< Decimator and detector */
+  power_wave_scale_t wave_scale;           /**< Codes to supply volts */
+  volatile uint32_t adc_pool_overflows;    /**< Counted in the ADC ISR */
+  uint32_t reported_overflows;             /**< Overflows added to stats */
+
   // Power chip communication
   power_chip_data_t latest_power_data; /**< Latest power chip data */
+  power_chip_decoder_t decoder;        /**< UART frame decoder */
+  power_chip_decoder_stats_t reported; /**< Decoder counters in stats */
 
   // Task handles
   TaskHandle_t monitor_task_handle; /**< Monitor task handle */
+  TaskHandle_t adc_task_handle;     /**< Continuous ADC task handle */
+  SemaphoreHandle_t task_done;      /**< Given by each task as it exits */
+  uint32_t tasks_alive;             /**< Tasks that have not given it yet */
 
   // Synchronization
   SemaphoreHandle_t data_mutex; /**< Data access mutex */
   QueueHandle_t uart_queue;     /**< UART event queue */
 
   // Statistics
-  power_monitor_stats_t stats; /**< Statistics */
-  uint64_t start_time_us;      /**< Start time */
+  power_monitor_stats_t stats;       /**< Statistics */
+  power_stats_engine_t stats_engine; /**< Distributions and energy */
+  uint64_t start_time_us;            /**< Start time */
 
   // Callback
   power_monitor_event_callback_t callback; /**< Event callback */
   void *callback_user_data;                /**< Callback user data */
 
+  // Telemetry log (ring and status are shared without data_mutex)
+  power_log_ring_t log_ring;             /**< Samples for the writer */
+  power_log_encoder_t log_encoder;       /**< Block being filled */
+  power_monitor_log_config_t log_config; /**< Active log configuration */
+  power_monitor_log_status_t log_status; /**< Written by the writer only */
+  TaskHandle_t log_task_handle;          /**< Writer task */
+  SemaphoreHandle_t log_done;            /**< Writer task has exited */
+  bool log_active;                       /**< Producer pushes (data_mutex) */
+  volatile bool log_stop;                /**< Writer should finish */
+  uint32_t log_flags;                    /**< Flags for the next sample */
+  uint32_t log_oldest_index;             /**< Oldest file kept */
+  int64_t log_file_start_us;             /**< Current file opened */
+  int64_t log_block_start_us;            /**< Current block started */
+  bool log_rotate;                       /**< Start a new file next */
+
 } power_monitor_state_t;
 
 static power_monitor_state_t s_power_monitor = {0};
 
 // Forward declarations
 static void power_monitor_task(void *pvParameters);
+static void power_adc_task(void *pvParameters);
+static void power_log_task(void *pvParameters);
+static void power_log_note(uint32_t flags);
 static esp_err_t voltage_monitor_init(void);
+static esp_err_t voltage_stream_init(void);
 static esp_err_t power_chip_init(void);
 static esp_err_t read_voltage_sample(voltage_monitor_data_t *data);
 static bool check_voltage_change(void);
-static esp_err_t read_power_chip_packet(power_chip_data_t *data);
-// Removed unused crc16_ccitt function declaration
+static void power_chip_flush_input(void);
+static void power_chip_handle_event(const uart_event_t *event);
+static void power_chip_read_frames(void);
+static void power_chip_publish(const power_chip_sample_t *samples,
+                               size_t count);
 
 static void update_statistics(void);
 static void trigger_event(power_monitor_event_type_t event_type,
@@ -96,6 +166,9 @@ static int cmd_power_voltage(int argc, char **argv);
 static int cmd_power_chip(int argc, char **argv);
 static int cmd_power_test_adc(int argc, char **argv);
 static int cmd_power_debug_info(int argc, char **argv);
+static int cmd_power_adc(int argc, char **argv);
+static int cmd_power_capture(int argc, char **argv);
+static int cmd_power_log(int argc, char **argv);
 
 esp_err_t power_monitor_get_default_config(power_monitor_config_t *config) {
   if (config == NULL) {
@@ -112,6 +185,13 @@ esp_err_t power_monitor_get_default_config(power_monitor_config_t *config) {
   config->voltage_config.voltage_min_threshold = 10.0f; // 10V minimum
   config->voltage_config.voltage_max_threshold = 30.0f; // 30V maximum
   config->voltage_config.enable_threshold_alarm = true;
+  config->voltage_config.adc_sample_rate_hz = 20000; // 20 kHz DMA sampling
+  config->voltage_config.decimation_ratio = 20;      // 1 ms records
+  config->voltage_config.decimation_order = 2;
+  config->voltage_config.transient_dip_v = 1.0f;
+  config->voltage_config.transient_spike_v = 1.0f;
+  config->voltage_config.capture_pre_records = 200;  // 200 ms before
+  config->voltage_config.capture_post_records = 600; // 600 ms after
 
   // Power chip communication defaults
   config->power_chip_config.uart_num = UART_NUM_1; // UART1
@@ -119,6 +199,17 @@ esp_err_t power_monitor_get_default_config(power_monitor_config_t *config) {
   config->power_chip_config.baud_rate = 9600;      // 9600 baud
   config->power_chip_config.timeout_ms = 1000;     // 1 second timeout
   config->power_chip_config.enable_protocol_debug = false;
+  config->power_chip_config.verify_crc = true;
+
+  // Telemetry log defaults (about 1.9 KB/s at the full frame rate)
+  config->log_config.enable = false;
+  strncpy(config->log_config.directory, POWER_LOG_DEFAULT_DIR,
+          sizeof(config->log_config.directory) - 1);
+  config->log_config.max_file_bytes = 8 * 1024 * 1024; // About 70 minutes
+  config->log_config.max_file_seconds = 3600;
+  config->log_config.max_files = 48;
+  config->log_config.flush_interval_ms = 5000;
+  config->log_config.ring_samples = 1024; // About 4 s of frames
 
   // Task configuration
   config->auto_start_monitoring = true;
@@ -145,14 +236,21 @@ esp_err_t power_monitor_init(const power_monitor_config_t *config) {
   memcpy(&s_power_monitor.config, config, sizeof(power_monitor_config_t));
 
   // Create mutex
+  esp_err_t ret;
   s_power_monitor.data_mutex = xSemaphoreCreateMutex();
   if (s_power_monitor.data_mutex == NULL) {
     ESP_LOGE(TAG, "Failed to create data mutex");
     return ESP_ERR_NO_MEM;
   }
+  s_power_monitor.task_done = xSemaphoreCreateCounting(2, 0);
+  if (s_power_monitor.task_done == NULL) {
+    ESP_LOGE(TAG, "Failed to create task exit semaphore");
+    ret = ESP_ERR_NO_MEM;
+    goto cleanup;
+  }
 
   // Initialize voltage monitoring
-  esp_err_t ret = voltage_monitor_init();
+  ret = voltage_monitor_init();
   if (ret != ESP_OK) {
     ESP_LOGE(TAG, "Failed to initialize voltage monitor: %s",
              esp_err_to_name(ret));
@@ -170,6 +268,7 @@ esp_err_t power_monitor_init(const power_monitor_config_t *config) {
   // Initialize statistics and start time
   s_power_monitor.start_time_us = esp_timer_get_time();
   memset(&s_power_monitor.stats, 0, sizeof(power_monitor_stats_t));
+  power_stats_init(&s_power_monitor.stats_engine, POWER_STATS_MAX_GAP_US);
 
   ESP_LOGI(TAG, "Power monitor initialized with start time: %llu us",
            s_power_monitor.start_time_us);
@@ -189,6 +288,10 @@ esp_err_t power_monitor_init(const power_monitor_config_t *config) {
   return ESP_OK;
 
 cleanup:
+  if (s_power_monitor.task_done) {
+    vSemaphoreDelete(s_power_monitor.task_done);
+    s_power_monitor.task_done = NULL;
+  }
   if (s_power_monitor.data_mutex) {
     vSemaphoreDelete(s_power_monitor.data_mutex);
     s_power_monitor.data_mutex = NULL;
@@ -203,8 +306,17 @@ esp_err_t power_monitor_deinit(void) {
 
   ESP_LOGI(TAG, "Deinitializing power monitor");
 
-  // Stop monitoring
-  power_monitor_stop();
+  // Stop monitoring (the log may also run without the monitor); nothing is
+  // torn down while a task that uses it is still running
+  esp_err_t ret = power_monitor_stop();
+  if (ret == ESP_OK && s_power_monitor.log_task_handle != NULL) {
+    ret = power_monitor_log_stop();
+  }
+  if (ret != ESP_OK) {
+    ESP_LOGW(TAG, "Deinit aborted, tasks still running: %s",
+             esp_err_to_name(ret));
+    return ret;
+  }
 
   // Clean up ADC calibration
   if (s_power_monitor.adc_cali_handle) {
@@ -217,11 +329,20 @@ esp_err_t power_monitor_deinit(void) {
     adc_oneshot_del_unit(s_power_monitor.adc_handle);
     s_power_monitor.adc_handle = NULL;
   }
+  if (s_power_monitor.adc_cont_handle) {
+    adc_continuous_deinit(s_power_monitor.adc_cont_handle);
+    s_power_monitor.adc_cont_handle = NULL;
+  }
+  power_wave_deinit(&s_power_monitor.wave);
 
   // Clean up UART
   uart_driver_delete(s_power_monitor.config.power_chip_config.uart_num);
 
   // Clean up mutex
+  if (s_power_monitor.task_done) {
+    vSemaphoreDelete(s_power_monitor.task_done);
+    s_power_monitor.task_done = NULL;
+  }
   if (s_power_monitor.data_mutex) {
     vSemaphoreDelete(s_power_monitor.data_mutex);
     s_power_monitor.data_mutex = NULL;
@@ -249,6 +370,10 @@ esp_err_t power_monitor_start(void) {
     ESP_LOGW(TAG, "Power monitor already running");
     return ESP_OK;
   }
+  if (s_power_monitor.tasks_alive > 0) {
+    ESP_LOGW(TAG, "Previous monitor tasks have not exited yet");
+    return ESP_ERR_INVALID_STATE;
+  }
 
   ESP_LOGI(TAG, "Starting power monitor");
 
@@ -266,9 +391,37 @@ esp_err_t power_monitor_start(void) {
     s_power_monitor.running = false; // Reset flag on failure
     return ESP_ERR_NO_MEM;
   }
+  s_power_monitor.tasks_alive = 1;
+
+  if (s_power_monitor.adc_cont_handle != NULL) {
+    esp_err_t err = adc_continuous_start(s_power_monitor.adc_cont_handle);
+    if (err == ESP_OK &&
+        xTaskCreate(power_adc_task, "power_adc", POWER_ADC_TASK_STACK_SIZE,
+                    NULL, s_power_monitor.config.task_priority + 1,
+                    &s_power_monitor.adc_task_handle) != pdPASS) {
+      adc_continuous_stop(s_power_monitor.adc_cont_handle);
+      err = ESP_ERR_NO_MEM;
+    } else if (err == ESP_OK) {
+      s_power_monitor.tasks_alive++;
+    }
+    if (err != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to start continuous ADC: %s",
+               esp_err_to_name(err));
+      power_monitor_stop();
+      return err;
+    }
+  }
 
   // start_time_us is already set during initialization, don't reset it here
 
+  if (s_power_monitor.config.log_config.enable &&
+      s_power_monitor.log_task_handle == NULL) {
+    esp_err_t err = power_monitor_log_start(NULL);
+    if (err != ESP_OK) {
+      ESP_LOGW(TAG, "Telemetry log not started: %s", esp_err_to_name(err));
+    }
+  }
+
   ESP_LOGI(TAG, "Power monitor started (task created)");
   return ESP_OK;
 }
@@ -278,18 +431,43 @@ esp_err_t power_monitor_stop(void) {
     return ESP_ERR_INVALID_STATE;
   }
 
-  if (!s_power_monitor.running) {
+  // A stop that timed out is finished by the next one
+  if (!s_power_monitor.running && s_power_monitor.tasks_alive == 0) {
     return ESP_OK;
   }
 
   ESP_LOGI(TAG, "Stopping power monitor");
 
+  // The writer flushes what is still in the ring before it exits
+  if (s_power_monitor.log_task_handle != NULL) {
+    power_monitor_log_stop();
+  }
+
+  // Both tasks leave their loops at the next check of the flag; neither may
+  // be deleted from here, since both hold data_mutex while they work
   s_power_monitor.running = false;
 
-  // Delete monitoring task
+  // Wake the monitor task from the UART queue instead of waiting for its
+  // next job; the ADC task returns from adc_continuous_read within the read
+  // timeout
   if (s_power_monitor.monitor_task_handle) {
-    vTaskDelete(s_power_monitor.monitor_task_handle);
-    s_power_monitor.monitor_task_handle = NULL;
+    uart_event_t wake = {.type = UART_EVENT_MAX};
+    xQueueSend(s_power_monitor.uart_queue, &wake, 0);
+  }
+  while (s_power_monitor.tasks_alive > 0) {
+    if (xSemaphoreTake(s_power_monitor.task_done,
+                       pdMS_TO_TICKS(POWER_TASK_STOP_TIMEOUT_MS)) != pdTRUE) {
+      ESP_LOGW(TAG, "Monitor tasks did not exit in time");
+      return ESP_ERR_TIMEOUT;
+    }
+    s_power_monitor.tasks_alive--;
+  }
+  s_power_monitor.monitor_task_handle = NULL;
+
+  // Nothing reads the driver any more
+  if (s_power_monitor.adc_task_handle) {
+    s_power_monitor.adc_task_handle = NULL;
+    adc_continuous_stop(s_power_monitor.adc_cont_handle);
   }
 
   ESP_LOGI(TAG, "Power monitor stopped");
@@ -300,14 +478,44 @@ static esp_err_t voltage_monitor_init(void) {
   ESP_LOGI(TAG, "Initializing voltage monitor on GPIO %d",
            s_power_monitor.config.voltage_config.gpio_pin);
 
+  // Initialize ADC calibration
+  adc_cali_curve_fitting_config_t cali_config = {
+      .unit_id = ADC_UNIT_2,
+      .chan = ADC_CHANNEL_7,
+      .atten = ADC_ATTEN_DB_12,
+      .bitwidth = ADC_BITWIDTH_12,
+  };
+
+  esp_err_t ret = adc_cali_create_scheme_curve_fitting(
+      &cali_config, &s_power_monitor.adc_cali_handle);
+  if (ret == ESP_OK) {
+    ESP_LOGI(TAG, "ADC calibration curve fitting initialized");
+  } else {
+    ESP_LOGW(TAG, "ADC calibration failed: %s, using linear conversion",
+             esp_err_to_name(ret));
+    s_power_monitor.adc_cali_handle = NULL;
+  }
+
+  // The unit runs either continuously or in oneshot mode, not both
+  if (s_power_monitor.config.voltage_config.adc_sample_rate_hz > 0) {
+    ret = voltage_stream_init();
+    if (ret == ESP_OK) {
+      ESP_LOGI(TAG, "Voltage monitor initialized (continuous, %lu Hz)",
+               (unsigned long)
+                   s_power_monitor.config.voltage_config.adc_sample_rate_hz);
+      return ESP_OK;
+    }
+    ESP_LOGW(TAG, "Continuous ADC unavailable: %s, using oneshot reads",
+             esp_err_to_name(ret));
+  }
+
   // Configure ADC
   adc_oneshot_unit_init_cfg_t init_config = {
       .unit_id = ADC_UNIT_2,
       .ulp_mode = ADC_ULP_MODE_DISABLE,
   };
 
-  esp_err_t ret =
-      adc_oneshot_new_unit(&init_config, &s_power_monitor.adc_handle);
+  ret = adc_oneshot_new_unit(&init_config, &s_power_monitor.adc_handle);
   if (ret != ESP_OK) {
     ESP_LOGE(TAG, "Failed to initialize ADC unit: %s", esp_err_to_name(ret));
     return ret;
@@ -326,26 +534,126 @@ static esp_err_t voltage_monitor_init(void) {
     return ret;
   }
 
-  // Initialize ADC calibration
-  adc_cali_curve_fitting_config_t cali_config = {
-      .unit_id = ADC_UNIT_2,
-      .chan = ADC_CHANNEL_7,
-      .atten = ADC_ATTEN_DB_12,
-      .bitwidth = ADC_BITWIDTH_12,
-  };
+  ESP_LOGI(TAG, "Voltage monitor initialized successfully");
+  return ESP_OK;
+}
 
-  ret = adc_cali_create_scheme_curve_fitting(&cali_config,
-                                             &s_power_monitor.adc_cali_handle);
-  if (ret == ESP_OK) {
-    ESP_LOGI(TAG, "ADC calibration curve fitting initialized");
+static void voltage_stream_scale(power_wave_scale_t *scale) {
+  const float divider = s_power_monitor.config.voltage_config.divider_ratio;
+  const int raw_low = 400;
+  const int raw_high = 3600;
+  int mv_low = 0;
+  int mv_high = 0;
+
+  // Curve fitting is close to linear over the used range, so a line through
+  // two calibrated points keeps the calibration call out of the sample path
+  if (s_power_monitor.adc_cali_handle != NULL &&
+      adc_cali_raw_to_voltage(s_power_monitor.adc_cali_handle, raw_low,
+                              &mv_low) == ESP_OK &&
+      adc_cali_raw_to_voltage(s_power_monitor.adc_cali_handle, raw_high,
+                              &mv_high) == ESP_OK) {
+    float mv_per_code = (float)(mv_high - mv_low) / (raw_high - raw_low);
+    scale->volts_per_code = mv_per_code * divider / 1000.0f;
+    scale->offset_v = (mv_low - mv_per_code * raw_low) * divider / 1000.0f;
   } else {
-    ESP_LOGW(TAG, "ADC calibration failed: %s, using linear conversion",
+    scale->volts_per_code =
+        (float)ADC_REF_VOLTAGE_MV / ADC_MAX_VALUE * divider / 1000.0f;
+    scale->offset_v = 0.0f;
+  }
+}
+
+static bool adc_pool_overflow(adc_continuous_handle_t handle,
+                              const adc_continuous_evt_data_t *edata,
+                              void *user_data) {
+  s_power_monitor.adc_pool_overflows++;
+  return false;
+}
+
+static void voltage_stream_record(const power_wave_record_t *record,
+                                  int64_t time_us, void *ctx) {
+  // Runs inside power_wave_feed(), with data_mutex held
+  float codes = (float)record->mean / (1 << POWER_WAVE_MEAN_FRAC_BITS);
+  power_stats_add(&s_power_monitor.stats_engine, POWER_STATS_VOLTAGE,
+                  power_wave_to_volts(&s_power_monitor.wave_scale, codes),
+                  time_us);
+}
+
+static esp_err_t voltage_stream_init(void) {
+  const voltage_monitor_config_t *vc = &s_power_monitor.config.voltage_config;
+  power_wave_scale_t *scale = &s_power_monitor.wave_scale;
+  adc_continuous_handle_t handle = NULL;
+
+  if (vc->decimation_ratio == 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  voltage_stream_scale(scale);
+
+  power_wave_config_t wave_config = power_wave_get_default_config();
+  wave_config.sample_rate_hz = vc->adc_sample_rate_hz;
+  wave_config.ratio = vc->decimation_ratio;
+  wave_config.order = vc->decimation_order;
+  wave_config.pre_trigger = vc->capture_pre_records;
+  wave_config.post_trigger = vc->capture_post_records;
+  wave_config.dip_codes = vc->transient_dip_v / scale->volts_per_code;
+  wave_config.spike_codes = vc->transient_spike_v / scale->volts_per_code;
+  // Follow the supply with a time constant of about one second
+  wave_config.baseline_records =
+      fmaxf(1.0f, (float)vc->adc_sample_rate_hz / vc->decimation_ratio);
+
+  esp_err_t ret = power_wave_init(&s_power_monitor.wave, &wave_config);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Invalid decimation or capture config: %s",
              esp_err_to_name(ret));
-    s_power_monitor.adc_cali_handle = NULL;
+    return ret;
   }
+  power_wave_set_record_callback(&s_power_monitor.wave, voltage_stream_record,
+                                 NULL);
 
-  ESP_LOGI(TAG, "Voltage monitor initialized successfully");
+  adc_continuous_handle_cfg_t handle_config = {
+      .max_store_buf_size = POWER_ADC_POOL_SIZE,
+      .conv_frame_size = POWER_ADC_FRAME_SIZE,
+  };
+  ret = adc_continuous_new_handle(&handle_config, &handle);
+  if (ret != ESP_OK) {
+    goto cleanup;
+  }
+
+  adc_digi_pattern_config_t pattern = {
+      .atten = ADC_ATTEN_DB_12,
+      .channel = ADC_CHANNEL_7,
+      .unit = ADC_UNIT_2,
+      .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH,
+  };
+  adc_continuous_config_t adc_config = {
+      .pattern_num = 1,
+      .adc_pattern = &pattern,
+      .sample_freq_hz = vc->adc_sample_rate_hz,
+      .conv_mode = ADC_CONV_SINGLE_UNIT_2,
+      .format = ADC_DIGI_OUTPUT_FORMAT_TYPE2,
+  };
+  ret = adc_continuous_config(handle, &adc_config);
+  if (ret != ESP_OK) {
+    goto cleanup;
+  }
+
+  adc_continuous_evt_cbs_t callbacks = {
+      .on_pool_ovf = adc_pool_overflow,
+  };
+  ret = adc_continuous_register_event_callbacks(handle, &callbacks, NULL);
+  if (ret != ESP_OK) {
+    goto cleanup;
+  }
+
+  s_power_monitor.adc_cont_handle = handle;
   return ESP_OK;
+
+cleanup:
+  if (handle != NULL) {
+    adc_continuous_deinit(handle);
+  }
+  power_wave_deinit(&s_power_monitor.wave);
+  return ret;
 }
 
 static esp_err_t power_chip_init(void) {
@@ -386,29 +694,55 @@ static esp_err_t power_chip_init(void) {
     return ret;
   }
 
+  // Wake the task every few frames instead of once per 120-byte FIFO fill
+  ret = uart_set_rx_full_threshold(uart_num, POWER_CHIP_RX_FULL_THRESHOLD);
+  if (ret == ESP_OK) {
+    ret = uart_set_rx_timeout(uart_num, POWER_CHIP_RX_TIMEOUT);
+  }
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to set UART RX thresholds: %s",
+             esp_err_to_name(ret));
+    return ret;
+  }
+
+  power_chip_decoder_init(&s_power_monitor.decoder,
+                          s_power_monitor.config.power_chip_config.baud_rate,
+                          s_power_monitor.config.power_chip_config.verify_crc);
+  memset(&s_power_monitor.reported, 0, sizeof(s_power_monitor.reported));
+
   ESP_LOGI(TAG, "Power chip communication initialized successfully");
   return ESP_OK;
 }
 
+static TickType_t ticks_until(TickType_t last, TickType_t interval,
+                              TickType_t now) {
+  TickType_t elapsed = now - last;
+  return elapsed >= interval ? 0 : interval - elapsed;
+}
+
 static void power_monitor_task(void *pvParameters) {
   voltage_monitor_data_t voltage_data;
-  power_chip_data_t power_data;
   TickType_t last_voltage_time = 0;
+  TickType_t last_voltage_check = xTaskGetTickCount();
+  TickType_t last_debug_time = last_voltage_check;
   uint32_t loop_count = 0;
 
   ESP_LOGI(TAG, "Power monitor task started - Running flag: %s",
            s_power_monitor.running ? "true" : "false");
 
+  // Bytes that piled up while the task was stopped have no usable timestamp
+  power_chip_flush_input();
+
   while (s_power_monitor.running) {
     loop_count++;
     ESP_LOGD(TAG, "Power monitor task loop iteration #%lu",
              (unsigned long)loop_count);
     TickType_t current_time = xTaskGetTickCount();
+    TickType_t voltage_interval = pdMS_TO_TICKS(
+        s_power_monitor.config.voltage_config.sample_interval_ms);
 
     // Read voltage sample at configured interval
-    if (current_time - last_voltage_time >=
-        pdMS_TO_TICKS(
-            s_power_monitor.config.voltage_config.sample_interval_ms)) {
+    if (current_time - last_voltage_time >= voltage_interval) {
       ESP_LOGD(TAG, "Attempting voltage sample (interval: %lu ms)",
                (unsigned long)
                    s_power_monitor.config.voltage_config.sample_interval_ms);
@@ -419,25 +753,26 @@ static void power_monitor_task(void *pvParameters) {
                  sizeof(voltage_monitor_data_t));
           s_power_monitor.stats.voltage_samples++;
 
-          // Update average voltage
-          s_power_monitor.stats.avg_voltage =
-              (s_power_monitor.stats.avg_voltage *
-                   (s_power_monitor.stats.voltage_samples - 1) +
-               voltage_data.supply_voltage) /
-              s_power_monitor.stats.voltage_samples;
+          // The DMA stream adds every record on its own
+          if (s_power_monitor.adc_cont_handle == NULL) {
+            power_stats_add(&s_power_monitor.stats_engine, POWER_STATS_VOLTAGE,
+                            voltage_data.supply_voltage, esp_timer_get_time());
+          }
 
           xSemaphoreGive(s_power_monitor.data_mutex);
         }
 
-        // Check thresholds
+        // Check thresholds against the envelope, so short excursions
+        // between two readings are not averaged away
         if (s_power_monitor.config.voltage_config.enable_threshold_alarm) {
-          if (voltage_data.supply_voltage <
+          if (voltage_data.min_voltage <
                   s_power_monitor.config.voltage_config.voltage_min_threshold ||
-              voltage_data.supply_voltage >
+              voltage_data.max_voltage >
                   s_power_monitor.config.voltage_config.voltage_max_threshold) {
             // Mark as threshold violation (no threshold_alarm field in new
             // struct)
             s_power_monitor.stats.threshold_violations++;
+            power_log_note(POWER_LOG_FLAG_THRESHOLD);
             trigger_event(POWER_MONITOR_EVENT_VOLTAGE_THRESHOLD, &voltage_data);
           }
         }
@@ -445,41 +780,9 @@ static void power_monitor_task(void *pvParameters) {
       last_voltage_time = current_time;
     }
 
-    // Check for power chip data
-    if (read_power_chip_packet(&power_data) == ESP_OK) {
-      if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) ==
-          pdTRUE) {
-        memcpy(&s_power_monitor.latest_power_data, &power_data,
-               sizeof(power_chip_data_t));
-        s_power_monitor.stats.power_chip_packets++;
-
-        if (power_data.crc_valid) {
-          // Update averages
-          s_power_monitor.stats.avg_current =
-              (s_power_monitor.stats.avg_current *
-                   (s_power_monitor.stats.power_chip_packets - 1) +
-               power_data.current) /
-              s_power_monitor.stats.power_chip_packets;
-
-          s_power_monitor.stats.avg_power =
-              (s_power_monitor.stats.avg_power *
-                   (s_power_monitor.stats.power_chip_packets - 1) +
-               power_data.power) /
-              s_power_monitor.stats.power_chip_packets;
-        } else {
-          s_power_monitor.stats.crc_errors++;
-          trigger_event(POWER_MONITOR_EVENT_CRC_ERROR, &power_data);
-        }
-
-        xSemaphoreGive(s_power_monitor.data_mutex);
-      }
-
-      trigger_event(POWER_MONITOR_EVENT_POWER_DATA_RECEIVED, &power_data);
-    }
-
     // Check for significant voltage changes (every 5 seconds)
-    static TickType_t last_voltage_check = 0;
-    if (current_time - last_voltage_check >= pdMS_TO_TICKS(5000)) {
+    if (current_time - last_voltage_check >=
+        pdMS_TO_TICKS(VOLTAGE_CHECK_INTERVAL_MS)) {
       if (check_voltage_change()) {
         ESP_LOGD(TAG, "Significant voltage change detected");
         trigger_event(POWER_MONITOR_EVENT_VOLTAGE_THRESHOLD, NULL);
@@ -491,27 +794,203 @@ static void power_monitor_task(void *pvParameters) {
     update_statistics();
 
     // Log task activity every 30 seconds for debugging
-    static TickType_t last_debug_time = 0;
-    if (current_time - last_debug_time >= pdMS_TO_TICKS(30000)) {
+    if (current_time - last_debug_time >=
+        pdMS_TO_TICKS(HEARTBEAT_INTERVAL_MS)) {
       ESP_LOGD(TAG, "Task heartbeat - uptime: %llu ms, voltage samples: %lu",
                s_power_monitor.stats.uptime_ms,
                (unsigned long)s_power_monitor.stats.voltage_samples);
       last_debug_time = current_time;
     }
 
-    // Small delay to prevent task from hogging CPU
-    vTaskDelay(pdMS_TO_TICKS(100)); // Increased to 100ms to reduce CPU usage
+    // Sleep on the UART event queue until the next periodic job is due, so
+    // power chip frames are decoded as soon as the driver reports them
+    TickType_t wait =
+        ticks_until(last_voltage_time, voltage_interval, current_time);
+    TickType_t check_wait =
+        ticks_until(last_voltage_check,
+                    pdMS_TO_TICKS(VOLTAGE_CHECK_INTERVAL_MS), current_time);
+    if (check_wait < wait) {
+      wait = check_wait;
+    }
+
+    uart_event_t event;
+    if (xQueueReceive(s_power_monitor.uart_queue, &event, wait) == pdTRUE) {
+      power_chip_handle_event(&event);
+    }
   }
 
   ESP_LOGI(TAG, "Power monitor task ended");
+  xSemaphoreGive(s_power_monitor.task_done);
+  vTaskDelete(NULL);
+}
+
+static void capture_info_to_volts(const power_wave_capture_info_t *src,
+                                  power_monitor_capture_info_t *info) {
+  const power_wave_scale_t *scale = &s_power_monitor.wave_scale;
+  info->number = src->number;
+  info->trigger_time_us = src->trigger_time_us;
+  info->record_period_us = src->record_period_us;
+  info->count = src->count;
+  info->trigger_index = src->trigger_index;
+  info->dip = src->trigger == POWER_WAVE_TRIGGER_DIP;
+  info->baseline_voltage = power_wave_to_volts(scale, src->baseline);
+  info->extreme_voltage = power_wave_to_volts(scale, src->extreme);
+  info->outside_records = src->outside_records;
+}
+
+static void power_adc_task(void *pvParameters) {
+  uint8_t frame[POWER_ADC_FRAME_SIZE];
+  uint16_t samples[POWER_ADC_FRAME_SAMPLES];
+
+  ESP_LOGI(TAG, "Continuous ADC task started");
+
+  while (s_power_monitor.running) {
+    uint32_t length = 0;
+    esp_err_t ret =
+        adc_continuous_read(s_power_monitor.adc_cont_handle, frame,
+                            sizeof(frame), &length, POWER_ADC_READ_TIMEOUT_MS);
+    if (ret == ESP_ERR_TIMEOUT) {
+      continue;
+    }
+    if (ret != ESP_OK) {
+      ESP_LOGW(TAG, "Continuous ADC read failed: %s", esp_err_to_name(ret));
+      vTaskDelay(pdMS_TO_TICKS(POWER_ADC_READ_TIMEOUT_MS));
+      continue;
+    }
+
+    // The driver hands out whole frames in order, so the newest result in
+    // this one was converted just before now
+    int64_t now_us = esp_timer_get_time();
+
+    size_t count = 0;
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= length;
+         i += SOC_ADC_DIGI_RESULT_BYTES) {
+      const adc_digi_output_data_t *result =
+          (const adc_digi_output_data_t *)&frame[i];
+      if (result->type2.unit == ADC_UNIT_2 &&
+          result->type2.channel == ADC_CHANNEL_7) {
+        samples[count++] = result->type2.data;
+      }
+    }
+    if (count == 0) {
+      continue;
+    }
+
+    power_wave_capture_info_t wave_info;
+    size_t completed = 0;
+    if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) ==
+        pdTRUE) {
+      completed =
+          power_wave_feed(&s_power_monitor.wave, samples, count, now_us);
+      if (completed > 0) {
+        power_wave_copy_capture(&s_power_monitor.wave, &wave_info, NULL, 0);
+      }
+
+      power_monitor_stats_t *stats = &s_power_monitor.stats;
+      uint32_t overflows = s_power_monitor.adc_pool_overflows;
+      stats->adc_samples += count;
+      stats->adc_overruns += overflows - s_power_monitor.reported_overflows;
+      stats->transient_captures += completed;
+      s_power_monitor.reported_overflows = overflows;
+
+      xSemaphoreGive(s_power_monitor.data_mutex);
+    }
+
+    if (completed > 0) {
+      power_monitor_capture_info_t info;
+      capture_info_to_volts(&wave_info, &info);
+      power_log_note(POWER_LOG_FLAG_TRANSIENT);
+      ESP_LOGW(TAG, "Supply %s captured: %.2fV -> %.2fV (#%lu)",
+               info.dip ? "dip" : "spike", info.baseline_voltage,
+               info.extreme_voltage, (unsigned long)info.number);
+      trigger_event(POWER_MONITOR_EVENT_VOLTAGE_TRANSIENT, &info);
+    }
+  }
+
+  ESP_LOGI(TAG, "Continuous ADC task ended");
+  xSemaphoreGive(s_power_monitor.task_done);
   vTaskDelete(NULL);
 }
 
+static esp_err_t read_voltage_window(voltage_monitor_data_t *data) {
+  power_wave_window_t window;
+  bool have_window = false;
+
+  if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) ==
+      pdTRUE) {
+    have_window = power_wave_take_window(&s_power_monitor.wave, &window);
+    xSemaphoreGive(s_power_monitor.data_mutex);
+  }
+  if (!have_window) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  const power_wave_scale_t *scale = &s_power_monitor.wave_scale;
+  data->supply_voltage = power_wave_to_volts(scale, window.mean);
+  data->min_voltage = power_wave_to_volts(scale, window.min);
+  data->max_voltage = power_wave_to_volts(scale, window.max);
+  data->timestamp = esp_log_timestamp();
+
+  ESP_LOGD(TAG, "Supply voltage: %.2fV (%.2fV..%.2fV over %lu records)",
+           data->supply_voltage, data->min_voltage, data->max_voltage,
+           (unsigned long)window.records);
+  return ESP_OK;
+}
+
+static esp_err_t read_latest_voltage(voltage_monitor_data_t *data) {
+  power_wave_record_t record;
+  int64_t time_us = 0;
+  bool have_record = false;
+
+  if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) ==
+      pdTRUE) {
+    have_record = s_power_monitor.wave.records > 0;
+    record = s_power_monitor.wave.latest;
+    time_us = s_power_monitor.wave.latest_time_us;
+    xSemaphoreGive(s_power_monitor.data_mutex);
+  }
+  if (!have_record) {
+    return ESP_ERR_NOT_FOUND;
+  }
+
+  const power_wave_scale_t *scale = &s_power_monitor.wave_scale;
+  data->supply_voltage = power_wave_to_volts(
+      scale, (float)record.mean / (1 << POWER_WAVE_MEAN_FRAC_BITS));
+  data->min_voltage = power_wave_to_volts(scale, record.min);
+  data->max_voltage = power_wave_to_volts(scale, record.max);
+  data->timestamp = (uint32_t)(time_us / 1000);
+  return ESP_OK;
+}
+
+static esp_err_t read_adc_raw(int *raw_adc) {
+  if (s_power_monitor.adc_cont_handle == NULL) {
+    return adc_oneshot_read(s_power_monitor.adc_handle, ADC_CHANNEL_7, raw_adc);
+  }
+
+  // The unit is owned by the DMA stream; report its newest record
+  esp_err_t ret = ESP_ERR_NOT_FOUND;
+  if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) ==
+      pdTRUE) {
+    if (s_power_monitor.wave.records > 0) {
+      *raw_adc = (s_power_monitor.wave.latest.mean +
+                  (1 << (POWER_WAVE_MEAN_FRAC_BITS - 1))) >>
+                 POWER_WAVE_MEAN_FRAC_BITS;
+      ret = ESP_OK;
+    }
+    xSemaphoreGive(s_power_monitor.data_mutex);
+  }
+  return ret;
+}
+
 static esp_err_t read_voltage_sample(voltage_monitor_data_t *data) {
   if (data == NULL) {
     return ESP_ERR_INVALID_ARG;
   }
 
+  if (s_power_monitor.initialized && s_power_monitor.adc_cont_handle != NULL) {
+    return read_voltage_window(data);
+  }
+
   if (!s_power_monitor.initialized || s_power_monitor.adc_handle == NULL) {
     ESP_LOGW(TAG, "Power monitor not initialized");
     return ESP_ERR_INVALID_STATE;
@@ -556,6 +1035,8 @@ static esp_err_t read_voltage_sample(voltage_monitor_data_t *data) {
 
   data->supply_voltage = actual_voltage;
   data->timestamp = esp_log_timestamp();
+  data->min_voltage = actual_voltage;
+  data->max_voltage = actual_voltage;
 
   ESP_LOGD(TAG, "Supply voltage: raw=%d, mv=%d, actual=%.2fV, divider=%.1f",
            raw_adc, voltage_mv, actual_voltage,
@@ -565,7 +1046,12 @@ static esp_err_t read_voltage_sample(voltage_monitor_data_t *data) {
 
 static bool check_voltage_change(void) {
   voltage_monitor_data_t voltage_data;
-  esp_err_t ret = read_voltage_sample(&voltage_data);
+  bool streaming = s_power_monitor.adc_cont_handle != NULL;
+
+  // With the DMA stream the newest record is at most one record old, so
+  // there is no need for a second conversion
+  esp_err_t ret = streaming ? read_latest_voltage(&voltage_data)
+                            : read_voltage_sample(&voltage_data);
   if (ret != ESP_OK) {
     return false;
   }
@@ -585,9 +1071,10 @@ static bool check_voltage_change(void) {
   // Update stored values
   s_power_monitor.last_supply_voltage = voltage_data.supply_voltage;
 
-  // Update global status
-  if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) ==
-      pdTRUE) {
+  // Update global status (the stream keeps the windowed reading)
+  if (!streaming &&
+      xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) ==
+          pdTRUE) {
     s_power_monitor.latest_voltage = voltage_data;
     xSemaphoreGive(s_power_monitor.data_mutex);
   }
@@ -595,107 +1082,166 @@ static bool check_voltage_change(void) {
   return voltage_changed;
 }
 
-static esp_err_t read_power_chip_packet(power_chip_data_t *data) {
-  if (data == NULL) {
-    return ESP_ERR_INVALID_ARG;
-  }
+static void power_chip_flush_input(void) {
+  uart_flush_input(s_power_monitor.config.power_chip_config.uart_num);
+  xQueueReset(s_power_monitor.uart_queue);
+  power_chip_decoder_reset(&s_power_monitor.decoder);
+}
 
-  uint8_t buffer[POWER_CHIP_PACKET_SIZE];
-  memset(buffer, 0, sizeof(buffer));
-  int uart_num = s_power_monitor.config.power_chip_config.uart_num;
+static void power_chip_handle_event(const uart_event_t *event) {
+  switch (event->type) {
+  case UART_DATA:
+    power_chip_read_frames();
+    break;
+
+  case UART_FIFO_OVF:
+  case UART_BUFFER_FULL:
+    // The driver dropped bytes, so the buffered stream no longer lines up
+    ESP_LOGW(TAG, "Power chip UART %s, flushing input",
+             event->type == UART_FIFO_OVF ? "FIFO overflow" : "buffer full");
+    power_chip_flush_input();
+    power_log_note(POWER_LOG_FLAG_FRAME_GAP);
+    if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) ==
+        pdTRUE) {
+      s_power_monitor.stats.uart_overflows++;
+      xSemaphoreGive(s_power_monitor.data_mutex);
+    }
+    break;
 
-  // Check available data first
-  size_t uart_length = 0;
-  esp_err_t err = uart_get_buffered_data_len(uart_num, &uart_length);
-  if (err != ESP_OK || uart_length < POWER_CHIP_PACKET_SIZE) {
-    ESP_LOGD(TAG, "Insufficient power chip data available: %d bytes",
-             uart_length);
-    return ESP_ERR_NOT_FOUND;
+  default:
+    // Frame and parity errors corrupt single bytes, which the decoder's
+    // checksum catches
+    break;
   }
+}
 
-  // Try to read up to 8 bytes to find a valid 4-byte packet starting with 0xFF
-  const int max_read_size = 8;
-  uint8_t read_buffer[max_read_size];
-
-  int bytes_read =
-      uart_read_bytes(uart_num, read_buffer, max_read_size,
-                      pdMS_TO_TICKS(100)); // Short timeout for available data
+static void power_chip_read_frames(void) {
+  int uart_num = s_power_monitor.config.power_chip_config.uart_num;
+  uint8_t buffer[POWER_CHIP_READ_CHUNK];
+  power_chip_sample_t samples[POWER_CHIP_SAMPLE_BATCH];
 
-  if (bytes_read <= 0) {
-    ESP_LOGD(TAG, "No power chip data available");
-    return ESP_ERR_NOT_FOUND;
+  size_t pending = 0;
+  if (uart_get_buffered_data_len(uart_num, &pending) != ESP_OK) {
+    return;
   }
 
-  // Search for 0xFF header in the received data
-  int packet_start = -1;
-  for (int i = 0; i <= bytes_read - POWER_CHIP_PACKET_SIZE; i++) {
-    if (read_buffer[i] == POWER_CHIP_START_BYTE) {
-      packet_start = i;
+  // The driver reports data once the line goes idle or the RX threshold is
+  // reached, so the last buffered byte arrived about now
+  int64_t now_us = esp_timer_get_time();
+
+  while (pending > 0) {
+    size_t want = pending < sizeof(buffer) ? pending : sizeof(buffer);
+    int bytes_read = uart_read_bytes(uart_num, buffer, want, 0);
+    if (bytes_read <= 0) {
       break;
     }
+    pending -= bytes_read;
+
+    int64_t end_us =
+        now_us - (int64_t)pending * s_power_monitor.decoder.byte_time_us;
+    size_t offset = 0;
+    do {
+      size_t used = 0;
+      size_t count = power_chip_decoder_feed(
+          &s_power_monitor.decoder, buffer + offset, bytes_read - offset,
+          end_us, samples, POWER_CHIP_SAMPLE_BATCH, &used);
+      offset += used;
+      power_chip_publish(samples, count);
+    } while (offset < (size_t)bytes_read);
   }
+}
 
-  if (packet_start == -1) {
-    ESP_LOGD(TAG, "No valid packet header found in %d bytes", bytes_read);
-    return ESP_ERR_INVALID_RESPONSE;
-  }
-
-  // Check if we have enough bytes for a complete packet
-  if (packet_start + POWER_CHIP_PACKET_SIZE > bytes_read) {
-    ESP_LOGD(TAG, "Incomplete packet found at position %d", packet_start);
-    return ESP_ERR_INVALID_SIZE;
-  }
+static void power_chip_sample_to_data(const power_chip_sample_t *sample,
+                                      power_chip_data_t *data) {
+  data->valid = true;
+  data->voltage = sample->voltage;
+  data->current = sample->current;
+  data->power = sample->power;
+  memcpy(data->raw_data, sample->raw, POWER_CHIP_PACKET_SIZE);
+  data->timestamp = (uint32_t)(sample->timestamp_us / 1000);
+  data->crc_valid = sample->crc_valid;
+  data->timestamp_us = sample->timestamp_us;
+  data->sequence = sample->sequence;
+}
 
-  // Copy the valid 4-byte packet to buffer
-  memcpy(buffer, &read_buffer[packet_start], POWER_CHIP_PACKET_SIZE);
-  ESP_LOGD(TAG, "Found valid packet at position %d", packet_start);
+static void power_chip_publish(const power_chip_sample_t *samples,
+                               size_t count) {
+  // Decoder counters are added as deltas so power_monitor_reset_stats()
+  // does not need to touch the decoder
+  const power_chip_decoder_stats_t *decoded = &s_power_monitor.decoder.stats;
+  uint32_t new_crc_errors =
+      decoded->crc_errors - s_power_monitor.reported.crc_errors;
+  power_chip_data_t data;
 
-  // Parse 4-byte packet: [0xFF header][voltage][current][CRC]
-  uint8_t voltage_raw = buffer[1];  // Voltage data
-  uint8_t current_raw = buffer[2];  // Current data
-  uint8_t received_crc = buffer[3]; // CRC byte
+  if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) ==
+      pdTRUE) {
+    power_monitor_stats_t *stats = &s_power_monitor.stats;
+    power_stats_engine_t *engine = &s_power_monitor.stats_engine;
+    bool logging = s_power_monitor.log_active;
+    uint8_t log_flags = 0;
+    if (logging) {
+      log_flags = (uint8_t)__atomic_exchange_n(&s_power_monitor.log_flags, 0,
+                                               __ATOMIC_RELAXED);
+      if (new_crc_errors > 0 ||
+          decoded->resyncs != s_power_monitor.reported.resyncs) {
+        log_flags |= POWER_LOG_FLAG_FRAME_GAP;
+      }
+    }
 
-  // Calculate simple CRC (sum of first 3 bytes)
-  uint8_t calculated_crc = (buffer[0] + buffer[1] + buffer[2]) & 0xFF;
+    for (size_t i = 0; i < count; i++) {
+      stats->power_chip_packets++;
+      // Frame arrival times, so the energy follows the real frame spacing
+      power_stats_add(engine, POWER_STATS_CURRENT, samples[i].current,
+                      samples[i].timestamp_us);
+      power_stats_add_power(engine, samples[i].power, samples[i].timestamp_us);
+
+      if (logging) {
+        // Never waits: a full ring drops the sample and flags the next one
+        power_log_sample_t entry = power_log_make_sample(
+            samples[i].timestamp_us, samples[i].voltage, samples[i].current,
+            log_flags |
+                (samples[i].crc_valid ? 0 : POWER_LOG_FLAG_CRC_INVALID));
+        power_log_ring_push(&s_power_monitor.log_ring, &entry);
+        log_flags = 0;
+      }
+    }
+    if (log_flags != 0) {
+      power_log_note(log_flags);
+    }
+    if (count > 0) {
+      power_chip_sample_to_data(&samples[count - 1],
+                                &s_power_monitor.latest_power_data);
+    }
 
-  // 暂时跳过CRC校验，直接解析数据
-  bool crc_valid = true; // 强制设置为有效，跳过CRC检查
+    stats->crc_errors += new_crc_errors;
+    stats->resync_count += decoded->resyncs - s_power_monitor.reported.resyncs;
+    stats->skipped_bytes +=
+        decoded->skipped_bytes - s_power_monitor.reported.skipped_bytes;
+    s_power_monitor.reported = *decoded;
 
-  if (calculated_crc != received_crc) {
-    // 静默记录CRC错误，不输出警告信息
-    s_power_monitor.stats.crc_errors++;
-    // 继续解析而不返回错误
+    xSemaphoreGive(s_power_monitor.data_mutex);
   }
 
-  // Convert raw data to actual values (adjusted scaling based on actual
-  // measurements)
-  float voltage = voltage_raw * 1.0f; // 1.0V per unit (实际测量校正)
-  float current = current_raw * 0.1f; // 0.1A per unit (实际测量校正)
-  float power = voltage * current;
+  if (new_crc_errors > 0) {
+    trigger_event(POWER_MONITOR_EVENT_CRC_ERROR, NULL);
+  }
 
-  // Fill data structure
-  data->voltage = voltage;
-  data->current = current;
-  data->power = power;
-  data->valid = crc_valid;
-  data->timestamp = esp_log_timestamp();
+  for (size_t i = 0; i < count; i++) {
+    power_chip_sample_to_data(&samples[i], &data);
 
-  // Store raw data for debugging
-  memcpy(data->raw_data, buffer, POWER_CHIP_PACKET_SIZE);
+    if (s_power_monitor.config.power_chip_config.enable_protocol_debug) {
+      ESP_LOGI(TAG,
+               "Power chip #%lu: V=%.1fV, I=%.2fA, P=%.2fW, CRC=%s [raw: "
+               "0x%02X 0x%02X 0x%02X 0x%02X]",
+               (unsigned long)data.sequence, data.voltage, data.current,
+               data.power, data.crc_valid ? "OK" : "FAIL", data.raw_data[0],
+               data.raw_data[1], data.raw_data[2], data.raw_data[3]);
+    }
 
-  if (s_power_monitor.config.power_chip_config.enable_protocol_debug) {
-    ESP_LOGI(TAG,
-             "Power chip: V=%.1fV, I=%.2fA, P=%.2fW, CRC=%s [raw: 0x%02X "
-             "0x%02X 0x%02X 0x%02X]",
-             voltage, current, power, crc_valid ? "OK" : "FAIL", buffer[0],
-             buffer[1], buffer[2], buffer[3]);
+    trigger_event(POWER_MONITOR_EVENT_POWER_DATA_RECEIVED, &data);
   }
-
-  return ESP_OK;
 }
 
-// Removed unused crc16_ccitt function - using simple CRC for 4-byte protocol
-
 static void update_statistics(void) {
   if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(10)) == pdTRUE) {
     s_power_monitor.stats.uptime_ms =
@@ -744,6 +1290,11 @@ esp_err_t power_monitor_get_power_chip_data(power_chip_data_t *data) {
   return ESP_ERR_TIMEOUT;
 }
 
+static float summary_mean(const power_stats_summary_t *summary) {
+  // Keep the old meaning of 0 before the first sample
+  return summary->count > 0 ? summary->mean : 0.0f;
+}
+
 esp_err_t power_monitor_get_stats(power_monitor_stats_t *stats) {
   if (!s_power_monitor.initialized || stats == NULL) {
     return ESP_ERR_INVALID_ARG;
@@ -751,8 +1302,26 @@ esp_err_t power_monitor_get_stats(power_monitor_stats_t *stats) {
 
   if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) ==
       pdTRUE) {
+    int64_t now_us = esp_timer_get_time();
+    const power_stats_engine_t *engine = &s_power_monitor.stats_engine;
+
     memcpy(stats, &s_power_monitor.stats, sizeof(power_monitor_stats_t));
+    power_stats_summarize(engine, POWER_STATS_VOLTAGE, now_us,
+                          &stats->voltage_stats);
+    power_stats_summarize(engine, POWER_STATS_CURRENT, now_us,
+                          &stats->current_stats);
+    power_stats_summarize(engine, POWER_STATS_POWER, now_us,
+                          &stats->power_stats);
+    stats->energy_wh = engine->energy_wh;
+    stats->energy_gaps = engine->energy_gaps;
+    stats->energy_gap_ms = (uint32_t)(engine->gap_us / 1000);
     xSemaphoreGive(s_power_monitor.data_mutex);
+
+    stats->avg_voltage = summary_mean(&stats->voltage_stats.total);
+    stats->avg_current = summary_mean(&stats->current_stats.total);
+    stats->avg_power = summary_mean(&stats->power_stats.total);
+    // The task only wakes for UART data and periodic jobs
+    stats->uptime_ms = (now_us - s_power_monitor.start_time_us) / 1000;
     return ESP_OK;
   }
 
@@ -767,6 +1336,7 @@ esp_err_t power_monitor_reset_stats(void) {
   if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) ==
       pdTRUE) {
     memset(&s_power_monitor.stats, 0, sizeof(power_monitor_stats_t));
+    power_stats_init(&s_power_monitor.stats_engine, POWER_STATS_MAX_GAP_US);
     s_power_monitor.start_time_us = esp_timer_get_time();
     xSemaphoreGive(s_power_monitor.data_mutex);
     return ESP_OK;
@@ -878,6 +1448,482 @@ esp_err_t power_monitor_set_debug_mode(bool enable) {
   return ESP_OK;
 }
 
+esp_err_t power_monitor_set_crc_check(bool enable) {
+  if (!s_power_monitor.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  // Picked up by the decoder on the next received frame
+  s_power_monitor.config.power_chip_config.verify_crc = enable;
+  s_power_monitor.decoder.verify_crc = enable;
+  ESP_LOGI(TAG, "Power chip CRC check %s", enable ? "enabled" : "disabled");
+
+  return ESP_OK;
+}
+
+esp_err_t power_monitor_set_transient_trigger(float dip_voltage,
+                                              float spike_voltage) {
+  if (!s_power_monitor.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  if (!(dip_voltage >= 0.0f) || !(spike_voltage >= 0.0f)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) !=
+      pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+  s_power_monitor.config.voltage_config.transient_dip_v = dip_voltage;
+  s_power_monitor.config.voltage_config.transient_spike_v = spike_voltage;
+  if (s_power_monitor.adc_cont_handle != NULL) {
+    float volts_per_code = s_power_monitor.wave_scale.volts_per_code;
+    power_wave_set_trigger(&s_power_monitor.wave, dip_voltage / volts_per_code,
+                           spike_voltage / volts_per_code);
+  }
+  xSemaphoreGive(s_power_monitor.data_mutex);
+
+  ESP_LOGI(TAG, "Transient trigger set: dip %.2fV, spike %.2fV", dip_voltage,
+           spike_voltage);
+  return ESP_OK;
+}
+
+/**
+ * @brief Copy the last capture out of the pipeline
+ *
+ * Only the copy is done under the data mutex, so slow consumers (console,
+ * SD card) do not hold up the ADC task. Free *records after use.
+ */
+static esp_err_t copy_capture(power_wave_capture_info_t *info,
+                              power_wave_record_t **records) {
+  if (!s_power_monitor.initialized) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (s_power_monitor.adc_cont_handle == NULL) {
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+
+  size_t capacity = s_power_monitor.wave.history_size;
+  *records = malloc(capacity * sizeof(power_wave_record_t));
+  if (*records == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+
+  if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) !=
+      pdTRUE) {
+    free(*records);
+    *records = NULL;
+    return ESP_ERR_TIMEOUT;
+  }
+  power_wave_copy_capture(&s_power_monitor.wave, info, *records, capacity);
+  xSemaphoreGive(s_power_monitor.data_mutex);
+
+  if (info->number == 0) {
+    free(*records);
+    *records = NULL;
+    return ESP_ERR_NOT_FOUND;
+  }
+  return ESP_OK;
+}
+
+esp_err_t power_monitor_get_capture(power_monitor_capture_info_t *info,
+                                    power_monitor_capture_record_t *records,
+                                    size_t max_records) {
+  if (info == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  power_wave_capture_info_t wave_info;
+  power_wave_record_t *wave_records = NULL;
+  esp_err_t ret = copy_capture(&wave_info, &wave_records);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  capture_info_to_volts(&wave_info, info);
+
+  const power_wave_scale_t *scale = &s_power_monitor.wave_scale;
+  size_t count = records == NULL ? 0 : wave_info.count;
+  if (count > max_records) {
+    count = max_records;
+  }
+  for (size_t i = 0; i < count; i++) {
+    records[i].mean_voltage = power_wave_to_volts(
+        scale, (float)wave_records[i].mean / (1 << POWER_WAVE_MEAN_FRAC_BITS));
+    records[i].min_voltage = power_wave_to_volts(scale, wave_records[i].min);
+    records[i].max_voltage = power_wave_to_volts(scale, wave_records[i].max);
+  }
+
+  free(wave_records);
+  return ESP_OK;
+}
+
+esp_err_t power_monitor_export_capture(const char *path) {
+  if (path == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  power_wave_capture_info_t info;
+  power_wave_record_t *records = NULL;
+  esp_err_t ret = copy_capture(&info, &records);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  FILE *f = fopen(path, "w");
+  if (f == NULL) {
+    ESP_LOGE(TAG, "Failed to open %s", path);
+    free(records);
+    return ESP_FAIL;
+  }
+
+  ret = power_wave_write_csv(f, &info, records, &s_power_monitor.wave_scale);
+  if (fclose(f) != 0 && ret == ESP_OK) {
+    ret = ESP_FAIL;
+  }
+  free(records);
+
+  if (ret == ESP_OK) {
+    ESP_LOGI(TAG, "Capture #%lu (%u records) written to %s",
+             (unsigned long)info.number, info.count, path);
+  }
+  return ret;
+}
+
+/* Telemetry log
+ *
+ * power_chip_publish() is the only producer: it pushes into log_ring while
+ * it holds data_mutex anyway, and only while log_active is set. The encoder,
+ * the files and log_status belong to the writer task, which never takes
+ * data_mutex, so a slow card cannot hold up sampling.
+ */
+
+static void power_log_note(uint32_t flags) {
+  // Carried by the next logged sample
+  __atomic_fetch_or(&s_power_monitor.log_flags, flags, __ATOMIC_RELAXED);
+}
+
+static void power_log_file_path(uint32_t index, char *path, size_t size) {
+  snprintf(path, size, "%s/" POWER_LOG_FILE_PREFIX "%05lu.bin",
+           s_power_monitor.log_config.directory, (unsigned long)index);
+}
+
+/**
+ * @brief Find the lowest and highest log file number in the directory
+ *
+ * New files continue after the highest one, rotation deletes from the
+ * lowest one.
+ */
+static esp_err_t power_log_scan_files(const char *directory) {
+  storage_dir_list_t list = {0};
+  size_t prefix = strlen(POWER_LOG_FILE_PREFIX);
+  bool found = false;
+  unsigned long first = 0;
+  unsigned long last = 0;
+
+  esp_err_t ret = storage_fs_list_directory(directory, &list);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+
+  for (size_t i = 0; i < list.count; i++) {
+    const char *name = list.files[i].name;
+    char *end = NULL;
+
+    // FAT may report short names in upper case
+    if (list.files[i].is_directory ||
+        strncasecmp(name, POWER_LOG_FILE_PREFIX, prefix) != 0 ||
+        name[prefix] < '0' || name[prefix] > '9') {
+      continue;
+    }
+    unsigned long index = strtoul(name + prefix, &end, 10);
+    if (strcasecmp(end, ".bin") != 0) {
+      continue;
+    }
+    if (!found || index < first) {
+      first = index;
+    }
+    if (!found || index > last) {
+      last = index;
+    }
+    found = true;
+  }
+  storage_manager_free_dir_list(&list);
+
+  s_power_monitor.log_oldest_index = found ? (uint32_t)first : 0;
+  s_power_monitor.log_status.file_index = found ? (uint32_t)last + 1 : 0;
+  return ESP_OK;
+}
+
+static void power_log_next_file(void) {
+  power_monitor_log_status_t *status = &s_power_monitor.log_status;
+  uint16_t max_files = s_power_monitor.log_config.max_files;
+  char path[64];
+
+  if (status->files_opened > 0) {
+    status->file_index++;
+  }
+  status->files_opened++;
+  status->file_bytes = 0;
+  s_power_monitor.log_file_start_us = esp_timer_get_time();
+  s_power_monitor.log_rotate = false;
+
+  while (max_files > 0 &&
+         status->file_index - s_power_monitor.log_oldest_index >= max_files) {
+    power_log_file_path(s_power_monitor.log_oldest_index++, path,
+                        sizeof(path));
+    storage_fs_delete_file(path);
+  }
+}
+
+static esp_err_t power_log_write_block(void) {
+  power_monitor_log_status_t *status = &s_power_monitor.log_status;
+  const power_monitor_log_config_t *config = &s_power_monitor.log_config;
+  int64_t file_age_us =
+      esp_timer_get_time() - s_power_monitor.log_file_start_us;
+  char path[64];
+
+  if (status->files_opened == 0 || s_power_monitor.log_rotate ||
+      (config->max_file_bytes > 0 &&
+       status->file_bytes + POWER_LOG_BLOCK_SIZE > config->max_file_bytes) ||
+      (config->max_file_seconds > 0 &&
+       file_age_us >= (int64_t)config->max_file_seconds * 1000000)) {
+    power_log_next_file();
+  }
+
+  // One open/append/close per block: every block is on the card once
+  // this returns, and a power loss tears at most the block being written
+  power_log_file_path(status->file_index, path, sizeof(path));
+  esp_err_t ret = storage_fs_append_file(
+      path, s_power_monitor.log_encoder.block, POWER_LOG_BLOCK_SIZE);
+  if (ret != ESP_OK) {
+    // A partial write would shift the blocks after it; start a new file
+    status->write_errors++;
+    s_power_monitor.log_rotate = true;
+    ESP_LOGW(TAG, "Telemetry log write to %s failed: %s", path,
+             esp_err_to_name(ret));
+    return ret;
+  }
+
+  status->file_bytes += POWER_LOG_BLOCK_SIZE;
+  status->blocks_written++;
+  return ESP_OK;
+}
+
+static void power_log_flush(void) {
+  power_log_encoder_t *encoder = &s_power_monitor.log_encoder;
+  uint16_t count = encoder->count;
+
+  if (count == 0) {
+    return;
+  }
+  power_log_encoder_finish(encoder,
+                           __atomic_load_n(&s_power_monitor.log_ring.dropped,
+                                           __ATOMIC_RELAXED));
+  if (power_log_write_block() == ESP_OK) {
+    s_power_monitor.log_status.samples_logged += count;
+  }
+}
+
+static void power_log_append(const power_log_sample_t *sample) {
+  power_log_encoder_t *encoder = &s_power_monitor.log_encoder;
+
+  if (!power_log_encoder_add(encoder, sample)) {
+    // Block full, or a time step the block cannot express
+    power_log_flush();
+    power_log_encoder_add(encoder, sample);
+  }
+  if (encoder->count == 1) {
+    s_power_monitor.log_block_start_us = esp_timer_get_time();
+  }
+}
+
+static void power_log_task(void *pvParameters) {
+  power_log_ring_t *ring = &s_power_monitor.log_ring;
+  power_monitor_log_status_t *status = &s_power_monitor.log_status;
+  int64_t flush_us =
+      (int64_t)s_power_monitor.log_config.flush_interval_ms * 1000;
+  power_log_sample_t batch[POWER_LOG_BATCH];
+
+  ESP_LOGI(TAG, "Telemetry log started, session %08lx",
+           (unsigned long)status->session);
+
+  for (;;) {
+    // Read before draining, so everything pushed before the stop is written
+    bool stopping = s_power_monitor.log_stop;
+
+    size_t count;
+    while ((count = power_log_ring_pop(ring, batch, POWER_LOG_BATCH)) > 0) {
+      for (size_t i = 0; i < count; i++) {
+        power_log_append(&batch[i]);
+      }
+    }
+
+    status->ring_fill = power_log_ring_count(ring);
+    status->ring_high_water =
+        __atomic_load_n(&ring->high_water, __ATOMIC_RELAXED);
+    status->samples_dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+
+    // Partly filled blocks are written after flush_interval_ms, so the card
+    // never lags far behind at low frame rates
+    int64_t block_age_us =
+        esp_timer_get_time() - s_power_monitor.log_block_start_us;
+    if (stopping || block_age_us >= flush_us) {
+      power_log_flush();
+    }
+    if (stopping) {
+      break;
+    }
+
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POWER_LOG_POLL_MS));
+  }
+
+  xSemaphoreGive(s_power_monitor.log_done);
+  vTaskDelete(NULL);
+}
+
+esp_err_t power_monitor_log_start(const power_monitor_log_config_t *config) {
+  if (!s_power_monitor.initialized || s_power_monitor.log_task_handle != NULL) {
+    return ESP_ERR_INVALID_STATE;
+  }
+  if (config == NULL) {
+    config = &s_power_monitor.config.log_config;
+  }
+  if (config->directory[0] == '\0') {
+    return ESP_ERR_INVALID_ARG;
+  }
+  if (storage_manager_get_state() != STORAGE_STATE_MOUNTED) {
+    ESP_LOGW(TAG, "Telemetry log needs a mounted SD card");
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  uint32_t capacity = 2;
+  while (capacity < config->ring_samples && capacity < 0x10000) {
+    capacity <<= 1;
+  }
+
+  esp_err_t ret = ESP_OK;
+  uint8_t *block = NULL;
+  s_power_monitor.log_config = *config;
+  memset(&s_power_monitor.log_status, 0, sizeof(s_power_monitor.log_status));
+
+  if (!storage_fs_is_directory(config->directory)) {
+    ret = storage_fs_create_directory(config->directory, NULL);
+    if (ret != ESP_OK) {
+      ESP_LOGE(TAG, "Failed to create %s", config->directory);
+      return ret;
+    }
+  }
+  ret = power_log_scan_files(config->directory);
+  if (ret != ESP_OK) {
+    ESP_LOGE(TAG, "Failed to list %s", config->directory);
+    return ret;
+  }
+
+  ret = power_log_ring_init(&s_power_monitor.log_ring, capacity);
+  if (ret != ESP_OK) {
+    return ret;
+  }
+  block = malloc(POWER_LOG_BLOCK_SIZE);
+  s_power_monitor.log_done = xSemaphoreCreateBinary();
+  if (block == NULL || s_power_monitor.log_done == NULL) {
+    ret = ESP_ERR_NO_MEM;
+    goto cleanup;
+  }
+
+  power_log_encoder_init(&s_power_monitor.log_encoder, block, esp_random());
+  s_power_monitor.log_status.session = s_power_monitor.log_encoder.session;
+  s_power_monitor.log_status.ring_capacity = capacity;
+  s_power_monitor.log_status.running = true;
+  s_power_monitor.log_stop = false;
+  s_power_monitor.log_rotate = false;
+  s_power_monitor.log_flags = 0;
+
+  if (xTaskCreate(power_log_task, "power_log", POWER_LOG_TASK_STACK_SIZE, NULL,
+                  POWER_LOG_TASK_PRIORITY,
+                  &s_power_monitor.log_task_handle) != pdPASS) {
+    s_power_monitor.log_task_handle = NULL;
+    s_power_monitor.log_status.running = false;
+    ret = ESP_ERR_NO_MEM;
+    goto cleanup;
+  }
+
+  // The producer starts pushing from here
+  if (xSemaphoreTake(s_power_monitor.data_mutex,
+                     pdMS_TO_TICKS(POWER_LOG_STOP_TIMEOUT_MS)) != pdTRUE) {
+    power_monitor_log_stop();
+    return ESP_ERR_TIMEOUT;
+  }
+  s_power_monitor.log_active = true;
+  xSemaphoreGive(s_power_monitor.data_mutex);
+
+  ESP_LOGI(TAG, "Logging to %s/" POWER_LOG_FILE_PREFIX "%05lu.bin",
+           config->directory,
+           (unsigned long)s_power_monitor.log_status.file_index);
+  return ESP_OK;
+
+cleanup:
+  free(block);
+  if (s_power_monitor.log_done != NULL) {
+    vSemaphoreDelete(s_power_monitor.log_done);
+    s_power_monitor.log_done = NULL;
+  }
+  power_log_ring_deinit(&s_power_monitor.log_ring);
+  return ret;
+}
+
+esp_err_t power_monitor_log_stop(void) {
+  if (s_power_monitor.log_task_handle == NULL) {
+    return ESP_ERR_INVALID_STATE;
+  }
+
+  // Once log_active is cleared under the mutex no push is in progress
+  if (xSemaphoreTake(s_power_monitor.data_mutex,
+                     pdMS_TO_TICKS(POWER_LOG_STOP_TIMEOUT_MS)) != pdTRUE) {
+    return ESP_ERR_TIMEOUT;
+  }
+  s_power_monitor.log_active = false;
+  xSemaphoreGive(s_power_monitor.data_mutex);
+
+  s_power_monitor.log_stop = true;
+  xTaskNotifyGive(s_power_monitor.log_task_handle);
+  if (xSemaphoreTake(s_power_monitor.log_done,
+                     pdMS_TO_TICKS(POWER_LOG_STOP_TIMEOUT_MS)) != pdTRUE) {
+    // Still writing to a slow card; its buffers stay until a retry
+    ESP_LOGW(TAG, "Telemetry log writer did not finish in time");
+    return ESP_ERR_TIMEOUT;
+  }
+
+  s_power_monitor.log_task_handle = NULL;
+  vSemaphoreDelete(s_power_monitor.log_done);
+  s_power_monitor.log_done = NULL;
+  free(s_power_monitor.log_encoder.block);
+  s_power_monitor.log_encoder.block = NULL;
+  power_log_ring_deinit(&s_power_monitor.log_ring);
+  s_power_monitor.log_status.running = false;
+
+  power_monitor_log_status_t *status = &s_power_monitor.log_status;
+  ESP_LOGI(TAG,
+           "Telemetry log stopped: %lu samples in %lu blocks, %lu dropped, "
+           "%lu write errors",
+           (unsigned long)status->samples_logged,
+           (unsigned long)status->blocks_written,
+           (unsigned long)status->samples_dropped,
+           (unsigned long)status->write_errors);
+  return ESP_OK;
+}
+
+esp_err_t power_monitor_log_get_status(power_monitor_log_status_t *status) {
+  if (status == NULL) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  // Written by the writer task only; fields are read one by one
+  *status = s_power_monitor.log_status;
+  return ESP_OK;
+}
+
 bool power_monitor_is_running(void) {
   return s_power_monitor.initialized && s_power_monitor.running;
 }
@@ -913,6 +1959,8 @@ static int cmd_power_status(int argc, char **argv) {
   if (power_monitor_get_voltage_data(&voltage_data) == ESP_OK) {
     printf("\nVoltage Monitoring:\n");
     printf("  Current Voltage: %.2fV\n", voltage_data.supply_voltage);
+    printf("  Range: %.2fV - %.2fV\n", voltage_data.min_voltage,
+           voltage_data.max_voltage);
     printf("  Timestamp: %lu ms\n", (unsigned long)voltage_data.timestamp);
 
     float min_thresh, max_thresh;
@@ -1020,6 +2068,19 @@ static int cmd_power_config(int argc, char **argv) {
            s_power_monitor.config.voltage_config.enable_threshold_alarm
                ? "Enabled"
                : "Disabled");
+    printf("  ADC Sample Rate: %lu Hz%s\n",
+           (unsigned long)
+               s_power_monitor.config.voltage_config.adc_sample_rate_hz,
+           s_power_monitor.adc_cont_handle != NULL ? "" : " (oneshot)");
+    printf("  Decimation: ratio %u, order %u\n",
+           s_power_monitor.config.voltage_config.decimation_ratio,
+           s_power_monitor.config.voltage_config.decimation_order);
+    printf("  Transient Trigger: dip %.2fV, spike %.2fV\n",
+           s_power_monitor.config.voltage_config.transient_dip_v,
+           s_power_monitor.config.voltage_config.transient_spike_v);
+    printf("  Capture Records: %u before, %u after\n",
+           s_power_monitor.config.voltage_config.capture_pre_records,
+           s_power_monitor.config.voltage_config.capture_post_records);
 
     printf("\nPower Chip:\n");
     printf("  UART Number: %d\n",
@@ -1034,6 +2095,9 @@ static int cmd_power_config(int argc, char **argv) {
            s_power_monitor.config.power_chip_config.enable_protocol_debug
                ? "Enabled"
                : "Disabled");
+    printf("  CRC Check: %s\n",
+           s_power_monitor.config.power_chip_config.verify_crc ? "Enabled"
+                                                                : "Disabled");
 
     printf("\nTask Configuration:\n");
     printf("  Auto Start: %s\n",
@@ -1117,6 +2181,58 @@ static int cmd_power_debug(int argc, char **argv) {
   }
 }
 
+static int cmd_power_debug_crc(int argc, char **argv) {
+  if (argc < 2 || (strcmp(argv[1], "on") != 0 && strcmp(argv[1], "off") != 0)) {
+    printf("CRC check: %s\n",
+           s_power_monitor.config.power_chip_config.verify_crc ? "on" : "off");
+    printf("Usage: power debug crc on|off\n");
+    return 1;
+  }
+
+  esp_err_t ret = power_monitor_set_crc_check(strcmp(argv[1], "on") == 0);
+  if (ret != ESP_OK) {
+    printf("Failed to set CRC check: %s\n", esp_err_to_name(ret));
+    return 1;
+  }
+
+  printf("CRC check %s\n", argv[1]);
+  return 0;
+}
+
+static void print_summary_row(const char *label,
+                              const power_stats_summary_t *summary,
+                              int decimals) {
+  printf("  %-6s %10llu", label, (unsigned long long)summary->count);
+  if (summary->count == 0) {
+    printf(" %10s %10s %10s %10s\n", "-", "-", "-", "-");
+    return;
+  }
+  printf(" %10.*f %10.*f %10.*f %10.*f\n", decimals, summary->mean,
+         decimals, summary->stddev, decimals, summary->min, decimals,
+         summary->max);
+}
+
+static void print_channel_stats(const char *name,
+                                const power_stats_channel_summary_t *summary,
+                                int decimals) {
+  static const char *const window_labels[POWER_STATS_WINDOW_COUNT] = {
+      "1s", "1min", "1h"};
+
+  printf("\n%s:\n", name);
+  printf("  %-6s %10s %10s %10s %10s %10s\n", "Window", "Count", "Mean",
+         "StdDev", "Min", "Max");
+  for (int w = 0; w < POWER_STATS_WINDOW_COUNT; w++) {
+    print_summary_row(window_labels[w], &summary->window[w], decimals);
+  }
+  print_summary_row("total", &summary->total, decimals);
+  if (summary->total.count > 0) {
+    printf("  p50 %.*f  p95 %.*f  p99 %.*f\n", decimals,
+           summary->quantile[POWER_STATS_P50], decimals,
+           summary->quantile[POWER_STATS_P95], decimals,
+           summary->quantile[POWER_STATS_P99]);
+  }
+}
+
 static int cmd_power_stats(int argc, char **argv) {
   power_monitor_stats_t stats;
 
@@ -1135,12 +2251,25 @@ static int cmd_power_stats(int argc, char **argv) {
          stats.power_chip_packets > 0
              ? (stats.crc_errors * 100.0f / stats.power_chip_packets)
              : 0.0f);
+  printf("Resyncs: %lu\n", (unsigned long)stats.resync_count);
+  printf("Skipped Bytes: %lu\n", (unsigned long)stats.skipped_bytes);
+  printf("UART Overflows: %lu\n", (unsigned long)stats.uart_overflows);
+  printf("ADC Samples: %llu\n", (unsigned long long)stats.adc_samples);
+  printf("ADC Overruns: %lu\n", (unsigned long)stats.adc_overruns);
+  printf("Transient Captures: %lu\n", (unsigned long)stats.transient_captures);
   printf("Timeout Errors: %lu\n", (unsigned long)stats.timeout_errors);
   printf("Threshold Violations: %lu\n",
          (unsigned long)stats.threshold_violations);
   printf("Average Voltage: %.2fV\n", stats.avg_voltage);
   printf("Average Current: %.3fA\n", stats.avg_current);
   printf("Average Power: %.2fW\n", stats.avg_power);
+  printf("Energy: %.4f Wh (%lu gaps, %.1f s not integrated)\n",
+         stats.energy_wh, (unsigned long)stats.energy_gaps,
+         stats.energy_gap_ms / 1000.0f);
+
+  print_channel_stats("Supply Voltage (V)", &stats.voltage_stats, 3);
+  print_channel_stats("Current (A)", &stats.current_stats, 3);
+  print_channel_stats("Power (W)", &stats.power_stats, 2);
 
   return 0;
 }
@@ -1167,6 +2296,8 @@ static int cmd_power_voltage(int argc, char **argv) {
   printf("Voltage Monitoring Data:\n");
   printf("=======================\n");
   printf("Voltage: %.2fV\n", voltage_data.supply_voltage);
+  printf("Min: %.2fV\n", voltage_data.min_voltage);
+  printf("Max: %.2fV\n", voltage_data.max_voltage);
   printf("Timestamp: %lu ms\n", (unsigned long)voltage_data.timestamp);
 
   if (argc > 1 && strcmp(argv[1], "interval") == 0) {
@@ -1206,7 +2337,9 @@ static int cmd_power_chip(int argc, char **argv) {
   printf("Current: %.3fA\n", power_data.current);
   printf("Power: %.2fW\n", power_data.power);
   printf("Valid: %s\n", power_data.valid ? "Yes" : "No");
+  printf("CRC: %s\n", power_data.crc_valid ? "OK" : "FAIL");
   printf("Timestamp: %lu ms\n", (unsigned long)power_data.timestamp);
+  printf("Sequence: %lu\n", (unsigned long)power_data.sequence);
   printf("Raw Data: ");
   for (int i = 0; i < POWER_CHIP_PACKET_SIZE; i++) {
     printf("%02X ", power_data.raw_data[i]);
@@ -1269,8 +2402,7 @@ static int cmd_power_test_adc(int argc, char **argv) {
   // Test multiple readings
   for (int i = 0; i < 10; i++) {
     int raw_adc;
-    esp_err_t ret =
-        adc_oneshot_read(s_power_monitor.adc_handle, ADC_CHANNEL_7, &raw_adc);
+    esp_err_t ret = read_adc_raw(&raw_adc);
     if (ret != ESP_OK) {
       printf("ADC read failed: %s\n", esp_err_to_name(ret));
       return 1;
@@ -1319,6 +2451,8 @@ static int cmd_power_debug_info(int argc, char **argv) {
 
   printf("\nADC Information:\n");
   printf("  ADC Handle: %p\n", s_power_monitor.adc_handle);
+  printf("  Continuous ADC Handle: %p\n", s_power_monitor.adc_cont_handle);
+  printf("  ADC Task Handle: %p\n", s_power_monitor.adc_task_handle);
   printf("  ADC Calibration Handle: %p\n", s_power_monitor.adc_cali_handle);
   printf("  GPIO Pin: %d\n", s_power_monitor.config.voltage_config.gpio_pin);
   printf("  Divider Ratio: %.1f\n",
@@ -1332,10 +2466,10 @@ static int cmd_power_debug_info(int argc, char **argv) {
   printf("  UART Queue: %p\n", s_power_monitor.uart_queue);
 
   printf("\nLive ADC Test:\n");
-  if (s_power_monitor.adc_handle != NULL) {
+  if (s_power_monitor.adc_handle != NULL ||
+      s_power_monitor.adc_cont_handle != NULL) {
     int raw_adc = 0;
-    esp_err_t ret =
-        adc_oneshot_read(s_power_monitor.adc_handle, ADC_CHANNEL_7, &raw_adc);
+    esp_err_t ret = read_adc_raw(&raw_adc);
     if (ret == ESP_OK) {
       int voltage_mv;
       if (s_power_monitor.adc_cali_handle != NULL) {
@@ -1362,11 +2496,218 @@ static int cmd_power_debug_info(int argc, char **argv) {
   return 0;
 }
 
+static int cmd_power_adc(int argc, char **argv) {
+  if (!s_power_monitor.initialized) {
+    printf("Power monitor not initialized\n");
+    return 1;
+  }
+
+  const voltage_monitor_config_t *vc = &s_power_monitor.config.voltage_config;
+  printf("Supply Voltage Sampling:\n");
+  printf("========================\n");
+  if (s_power_monitor.adc_cont_handle == NULL) {
+    printf("Mode: oneshot, every %lu ms\n",
+           (unsigned long)vc->sample_interval_ms);
+    return 0;
+  }
+
+  power_wave_t wave;
+  if (xSemaphoreTake(s_power_monitor.data_mutex, pdMS_TO_TICKS(100)) !=
+      pdTRUE) {
+    printf("Failed to read ADC state\n");
+    return 1;
+  }
+  wave = s_power_monitor.wave; // Only the scalar fields are used below
+  xSemaphoreGive(s_power_monitor.data_mutex);
+
+  const power_wave_scale_t *scale = &s_power_monitor.wave_scale;
+  printf("Mode: continuous DMA, %lu Hz\n",
+         (unsigned long)wave.config.sample_rate_hz);
+  printf("Decimation: CIC order %u, ratio %u (%.3f ms records)\n",
+         wave.config.order, wave.config.ratio,
+         wave.info.record_period_us / 1000.0f);
+  printf("Scale: %.3f mV/code, offset %.3fV\n",
+         scale->volts_per_code * 1000.0f, scale->offset_v);
+  printf("Samples: %llu, Records: %lu\n", (unsigned long long)wave.samples,
+         (unsigned long)wave.records);
+  if (wave.records > 0) {
+    printf("Latest Record: %.2fV (%.2fV - %.2fV)\n",
+           power_wave_to_volts(scale, (float)wave.latest.mean /
+                                          (1 << POWER_WAVE_MEAN_FRAC_BITS)),
+           power_wave_to_volts(scale, wave.latest.min),
+           power_wave_to_volts(scale, wave.latest.max));
+    printf("Baseline: %.2fV\n", power_wave_to_volts(scale, wave.baseline));
+  }
+  printf("Transient Trigger: dip %.2fV, spike %.2fV (%s)\n",
+         vc->transient_dip_v, vc->transient_spike_v,
+         wave.capturing ? "capturing" : wave.armed ? "armed" : "waiting");
+  printf("Captures: %lu\n", (unsigned long)wave.info.number);
+  return 0;
+}
+
+static int cmd_power_capture_dump(int step) {
+  power_monitor_capture_info_t info;
+  esp_err_t ret = power_monitor_get_capture(&info, NULL, 0);
+  if (ret != ESP_OK) {
+    printf("Failed to get capture: %s\n", esp_err_to_name(ret));
+    return 1;
+  }
+
+  power_monitor_capture_record_t *records =
+      malloc(info.count * sizeof(power_monitor_capture_record_t));
+  if (records == NULL) {
+    printf("Out of memory\n");
+    return 1;
+  }
+  ret = power_monitor_get_capture(&info, records, info.count);
+  if (ret != ESP_OK) {
+    printf("Failed to get capture: %s\n", esp_err_to_name(ret));
+    free(records);
+    return 1;
+  }
+
+  // Rows are picked relative to the trigger, so the trigger row is printed
+  printf("%10s %8s %8s %8s\n", "time_ms", "mean_V", "min_V", "max_V");
+  for (int i = info.trigger_index % step; i < info.count; i += step) {
+    float t_ms = (float)(i - info.trigger_index) * info.record_period_us /
+                 1000.0f;
+    printf("%10.3f %8.3f %8.3f %8.3f%s\n", t_ms, records[i].mean_voltage,
+           records[i].min_voltage, records[i].max_voltage,
+           i == info.trigger_index ? "  <- trigger" : "");
+  }
+
+  free(records);
+  return 0;
+}
+
+static int cmd_power_capture(int argc, char **argv) {
+  const char *action = argc > 1 ? argv[1] : "show";
+
+  if (strcmp(action, "trigger") == 0) {
+    if (argc < 4) {
+      printf("Transient trigger: dip %.2fV, spike %.2fV\n",
+             s_power_monitor.config.voltage_config.transient_dip_v,
+             s_power_monitor.config.voltage_config.transient_spike_v);
+      printf("Usage: power capture trigger <dip_V> <spike_V> (0 = off)\n");
+      return 1;
+    }
+    float dip = atof(argv[2]);
+    float spike = atof(argv[3]);
+    esp_err_t ret = power_monitor_set_transient_trigger(dip, spike);
+    if (ret != ESP_OK) {
+      printf("Failed to set transient trigger: %s\n", esp_err_to_name(ret));
+      return 1;
+    }
+    printf("Transient trigger set: dip %.2fV, spike %.2fV\n", dip, spike);
+    return 0;
+  } else if (strcmp(action, "dump") == 0) {
+    int step = argc > 2 ? atoi(argv[2]) : 10;
+    return cmd_power_capture_dump(step > 0 ? step : 1);
+  } else if (strcmp(action, "export") == 0) {
+    const char *path = argc > 2 ? argv[2] : POWER_CAPTURE_DEFAULT_PATH;
+    esp_err_t ret = power_monitor_export_capture(path);
+    if (ret != ESP_OK) {
+      printf("Failed to export capture to %s: %s\n", path,
+             esp_err_to_name(ret));
+      return 1;
+    }
+    printf("Capture written to %s\n", path);
+    return 0;
+  } else if (strcmp(action, "show") != 0) {
+    printf("Usage: power capture [show|dump [step]|export [path]|trigger "
+           "<dip_V> <spike_V>]\n");
+    return 1;
+  }
+
+  power_monitor_capture_info_t info;
+  esp_err_t ret = power_monitor_get_capture(&info, NULL, 0);
+  if (ret == ESP_ERR_NOT_FOUND) {
+    printf("No supply transient captured yet\n");
+    return 0;
+  } else if (ret == ESP_ERR_NOT_SUPPORTED) {
+    printf("Transient capture needs continuous ADC sampling\n");
+    return 1;
+  } else if (ret != ESP_OK) {
+    printf("Failed to get capture: %s\n", esp_err_to_name(ret));
+    return 1;
+  }
+
+  float period_ms = info.record_period_us / 1000.0f;
+  printf("Supply Transient Capture #%lu:\n", (unsigned long)info.number);
+  printf("==============================\n");
+  printf("Type: %s\n", info.dip ? "dip" : "spike");
+  printf("Trigger Time: %lld ms (%lld ms ago)\n",
+         (long long)(info.trigger_time_us / 1000),
+         (long long)((esp_timer_get_time() - info.trigger_time_us) / 1000));
+  printf("Baseline: %.2fV\n", info.baseline_voltage);
+  printf("%s: %.2fV (%+.2fV)\n", info.dip ? "Lowest" : "Highest",
+         info.extreme_voltage, info.extreme_voltage - info.baseline_voltage);
+  printf("Outside Band: %.1f ms after the trigger\n",
+         info.outside_records * period_ms);
+  printf("Records: %u (%.1f ms before, %.1f ms after, %.3f ms each)\n",
+         info.count, info.trigger_index * period_ms,
+         (info.count - 1 - info.trigger_index) * period_ms, period_ms);
+  return 0;
+}
+
+static int cmd_power_log(int argc, char **argv) {
+  const char *action = argc > 1 ? argv[1] : "status";
+
+  if (strcmp(action, "start") == 0) {
+    power_monitor_log_config_t config = s_power_monitor.config.log_config;
+    if (argc > 2) {
+      strncpy(config.directory, argv[2], sizeof(config.directory) - 1);
+      config.directory[sizeof(config.directory) - 1] = '\0';
+    }
+    esp_err_t ret = power_monitor_log_start(&config);
+    if (ret != ESP_OK) {
+      printf("Failed to start telemetry log: %s\n", esp_err_to_name(ret));
+      return 1;
+    }
+    printf("Telemetry log started in %s\n", config.directory);
+    return 0;
+  } else if (strcmp(action, "stop") == 0) {
+    esp_err_t ret = power_monitor_log_stop();
+    if (ret != ESP_OK) {
+      printf("Failed to stop telemetry log: %s\n", esp_err_to_name(ret));
+      return 1;
+    }
+    printf("Telemetry log stopped\n");
+    return 0;
+  } else if (strcmp(action, "status") != 0) {
+    printf("Usage: power log [status|start [directory]|stop]\n");
+    return 1;
+  }
+
+  power_monitor_log_status_t status;
+  power_monitor_log_get_status(&status);
+  printf("Telemetry Log:\n");
+  printf("==============\n");
+  printf("State: %s\n", status.running ? "Running" : "Stopped");
+  if (status.files_opened == 0 && !status.running) {
+    return 0;
+  }
+  printf("Session: %08lx\n", (unsigned long)status.session);
+  printf("File: %s/" POWER_LOG_FILE_PREFIX "%05lu.bin (%lu KB)\n",
+         s_power_monitor.log_config.directory,
+         (unsigned long)status.file_index,
+         (unsigned long)(status.file_bytes / 1024));
+  printf("Files Opened: %lu\n", (unsigned long)status.files_opened);
+  printf("Blocks Written: %lu\n", (unsigned long)status.blocks_written);
+  printf("Samples Logged: %lu\n", (unsigned long)status.samples_logged);
+  printf("Samples Dropped: %lu\n", (unsigned long)status.samples_dropped);
+  printf("Write Errors: %lu\n", (unsigned long)status.write_errors);
+  printf("Ring: %lu/%lu (high water %lu)\n", (unsigned long)status.ring_fill,
+         (unsigned long)status.ring_capacity,
+         (unsigned long)status.ring_high_water);
+  return 0;
+}
+
 // 主 power 命令实现 - 根据参考项目的 cmd_power 函数
 static int cmd_power(int argc, char **argv) {
   if (argc < 2) {
     printf("用法: power status|voltage|read|chip|start|stop|threshold "
-           "<value>|debug|test|analyze|help\n");
+           "<value>|adc|capture|log|debug|test|analyze|help\n");
     printf("使用 'power help' 获取详细帮助信息\n");
     return 1;
   }
@@ -1391,6 +2732,8 @@ static int cmd_power(int argc, char **argv) {
       return cmd_power_debug_info(argc - 2, argv + 2);
     } else if (argc > 2 && strcmp(argv[2], "uart") == 0) {
       return cmd_power_debug_uart(argc - 2, argv + 2);
+    } else if (argc > 2 && strcmp(argv[2], "crc") == 0) {
+      return cmd_power_debug_crc(argc - 2, argv + 2);
     } else if (argc > 2 && strcmp(argv[2], "enable") == 0) {
       return cmd_power_debug(argc - 1, argv + 1);
     } else {
@@ -1402,6 +2745,12 @@ static int cmd_power(int argc, char **argv) {
     } else {
       return cmd_power_test_adc(argc - 1, argv + 1);
     }
+  } else if (strcmp(argv[1], "adc") == 0) {
+    return cmd_power_adc(argc - 1, argv + 1);
+  } else if (strcmp(argv[1], "capture") == 0) {
+    return cmd_power_capture(argc - 1, argv + 1);
+  } else if (strcmp(argv[1], "log") == 0) {
+    return cmd_power_log(argc - 1, argv + 1);
   } else if (strcmp(argv[1], "stats") == 0) {
     return cmd_power_stats(argc - 1, argv + 1);
   } else if (strcmp(argv[1], "reset") == 0) {
@@ -1423,13 +2772,26 @@ static int cmd_power(int argc, char **argv) {
     printf("    说明: 当供电电压变化超过阈值时，自动触发电源芯片数据读取\n");
     printf("    默认: 1.0V，推荐范围: 0.5V-2.0V (较大值可减少干扰误触发)\n");
     printf("\n");
+    printf("波形采集:\n");
+    printf("  power adc                      - 显示连续采样和抽取状态\n");
+    printf("  power capture [show]           - 显示最近一次瞬态捕获\n");
+    printf("  power capture dump [step]      - 打印捕获波形 (每step条记录)\n");
+    printf("  power capture export [path]    - 导出捕获为CSV (默认SD卡)\n");
+    printf("  power capture trigger <跌落V> <尖峰V> - 设置瞬态触发阈值\n");
+    printf("\n");
+    printf("遥测日志:\n");
+    printf("  power log [status]             - 显示SD卡遥测日志状态\n");
+    printf("  power log start [目录]         - 开始记录每帧电源芯片数据\n");
+    printf("  power log stop                 - 停止记录并写出缓冲数据\n");
+    printf("\n");
     printf("调试工具:\n");
     printf("  power debug                    - 显示UART配置和状态信息\n");
     printf("  power debug info               - 显示详细调试信息和内部状态\n");
     printf("  power debug enable             - 启用调试模式\n");
+    printf("  power debug crc on|off         - 开启/关闭电源芯片帧校验\n");
     printf("  power test                     - 执行ADC测试\n");
     printf("  power test adc                 - 直接测试ADC读取\n");
-    printf("  power stats                    - 显示详细统计信息\n");
+    printf("  power stats                    - 显示统计、窗口、分位数和电量\n");
     printf("  power reset                    - 重置统计数据\n");
     printf("  power help                     - 显示此帮助信息\n");
     printf("\n");
@@ -1440,16 +2802,22 @@ static int cmd_power(int argc, char **argv) {
     printf("  power threshold 0.1            - 设置0.1V电压变化阈值\n");
     printf("  power debug info               - 显示内部状态和ADC原始值\n");
     printf("  power test adc                 - 测试ADC功能是否正常\n");
+    printf("  power capture trigger 0.5 0    - 只捕获超过0.5V的跌落\n");
+    printf("  power capture export           - 保存到 "
+           "/sdcard/power_capture.csv\n");
+    printf("  power log start                - 记录到 "
+           "/sdcard/power/pwrNNNNN.bin\n");
     printf("\n");
     printf("硬件配置:\n");
-    printf("  GPIO18: 供电电压监测 (ADC2_CHANNEL_7, 分压比11.4:1)\n");
-    printf("  GPIO47: 电源芯片UART接收 (9600波特率, CRC16校验)\n");
+    printf("  GPIO18: 供电电压监测 (ADC2_CHANNEL_7, 分压比11.4:1, "
+           "DMA连续采样)\n");
+    printf("  GPIO47: 电源芯片UART接收 (9600波特率, 累加和校验)\n");
     printf("\n");
     return 0;
   } else {
     printf("未知命令: %s\n", argv[1]);
     printf("用法: power status|voltage|read|chip|start|stop|threshold "
-           "<value>|debug|test|help\n");
+           "<value>|adc|capture|log|debug|test|help\n");
     printf("使用 'power help' 获取详细帮助信息\n");
     return 1;
   }
@@ -1460,9 +2828,9 @@ static int cmd_power(int argc, char **argv) {
 esp_err_t power_monitor_register_console_commands(void) {
   const console_cmd_t power_cmd = {
       .command = "power",
-      .help = "电源监控: power status|voltage|read|debug|test|help "
+      .help = "电源监控: power status|voltage|read|capture|debug|test|help "
               "(详细帮助请使用 power help)",
-      .hint = "status|voltage|read|debug|test|help",
+      .hint = "status|voltage|read|adc|capture|log|debug|test|help",
       .func = &cmd_power,
       .min_args = 0,
       .max_args = 10};
@@ -0,0 +1,133 @@
+/**
+ * @file power_monitor_decoder.c
+ * @brief Streaming frame decoder for the power chip UART
+ *
+ * @author robOS Team
+ * @date 2025
+ */
+
+#include "power_monitor_decoder.h"
+#include <string.h>
+
+#define WINDOW_MASK (POWER_CHIP_PACKET_SIZE - 1)
+
+/* ============================================================================
+ * Private Helpers
+ * ============================================================================
+ */
+
+static uint8_t window_at(const power_chip_decoder_t *decoder, uint8_t index) {
+  return decoder->window[(decoder->head + index) & WINDOW_MASK];
+}
+
+static void window_drop(power_chip_decoder_t *decoder) {
+  decoder->head = (decoder->head + 1) & WINDOW_MASK;
+  decoder->count--;
+  decoder->stats.skipped_bytes++;
+}
+
+static void lose_lock(power_chip_decoder_t *decoder) {
+  if (decoder->locked) {
+    decoder->locked = false;
+    decoder->stats.resyncs++;
+  }
+}
+
+static void emit_sample(power_chip_decoder_t *decoder, const uint8_t *frame,
+                        bool crc_valid, int64_t timestamp_us,
+                        power_chip_sample_t *sample) {
+  memcpy(sample->raw, frame, POWER_CHIP_PACKET_SIZE);
+  sample->voltage = frame[1] * POWER_CHIP_VOLTAGE_LSB;
+  sample->current = frame[2] * POWER_CHIP_CURRENT_LSB;
+  sample->power = sample->voltage * sample->current;
+  sample->timestamp_us = timestamp_us;
+  sample->sequence = decoder->sequence++;
+  sample->crc_valid = crc_valid;
+  decoder->stats.frames++;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ============================================================================
+ */
+
+void power_chip_decoder_init(power_chip_decoder_t *decoder, int baud_rate,
+                             bool verify_crc) {
+  memset(decoder, 0, sizeof(*decoder));
+  decoder->verify_crc = verify_crc;
+  // 8N1: start bit, 8 data bits and a stop bit per byte
+  if (baud_rate > 0) {
+    decoder->byte_time_us = (10u * 1000000u + baud_rate / 2) / baud_rate;
+  }
+}
+
+void power_chip_decoder_reset(power_chip_decoder_t *decoder) {
+  decoder->head = 0;
+  decoder->count = 0;
+  decoder->locked = false;
+}
+
+bool power_chip_frame_valid(const uint8_t *frame) {
+  return frame[0] == POWER_CHIP_HEADER &&
+         (uint8_t)(frame[0] + frame[1] + frame[2]) == frame[3];
+}
+
+size_t power_chip_decoder_feed(power_chip_decoder_t *decoder,
+                               const uint8_t *data, size_t len,
+                               int64_t end_time_us,
+                               power_chip_sample_t *samples,
+                               size_t max_samples, size_t *consumed) {
+  size_t emitted = 0;
+  size_t i = 0;
+
+  for (; i < len && emitted < max_samples; i++) {
+    uint8_t byte = data[i];
+
+    // Hunting: nothing buffered, wait for a header
+    if (decoder->count == 0 && byte != POWER_CHIP_HEADER) {
+      lose_lock(decoder);
+      decoder->stats.skipped_bytes++;
+      continue;
+    }
+
+    decoder->window[(decoder->head + decoder->count) & WINDOW_MASK] = byte;
+    if (++decoder->count < POWER_CHIP_PACKET_SIZE) {
+      continue;
+    }
+
+    uint8_t frame[POWER_CHIP_PACKET_SIZE];
+    for (uint8_t k = 0; k < POWER_CHIP_PACKET_SIZE; k++) {
+      frame[k] = window_at(decoder, k);
+    }
+
+    bool crc_valid = power_chip_frame_valid(frame);
+    if (crc_valid || !decoder->verify_crc) {
+      int64_t behind = (int64_t)(len - 1 - i) * decoder->byte_time_us;
+      emit_sample(decoder, frame, crc_valid, end_time_us - behind,
+                  &samples[emitted++]);
+      if (!crc_valid) {
+        decoder->stats.crc_errors++;
+      }
+      decoder->head = 0;
+      decoder->count = 0;
+      decoder->locked = true;
+      continue;
+    }
+
+    if (decoder->locked) {
+      decoder->stats.crc_errors++;
+    }
+    lose_lock(decoder);
+
+    // Drop the false header and rescan the rest of the window
+    window_drop(decoder);
+    while (decoder->count > 0 && window_at(decoder, 0) != POWER_CHIP_HEADER) {
+      window_drop(decoder);
+    }
+  }
+
+  if (consumed != NULL) {
+    *consumed = i;
+  }
+  return emitted;
+}
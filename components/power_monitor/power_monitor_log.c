@@ -0,0 +1,270 @@
+/**
+ * @file power_monitor_log.c
+ * @brief Power telemetry log: sample ring and binary block format
+ *
+ * @author robOS Team
+ * @date 2025
+ */
+
+#include "power_monitor_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+_Static_assert(POWER_LOG_HEADER_SIZE + POWER_LOG_BLOCK_RECORDS *
+                                           POWER_LOG_RECORD_SIZE <=
+                   POWER_LOG_BLOCK_SIZE,
+               "records must fit in a block");
+
+// Header field offsets
+#define HDR_MAGIC 0
+#define HDR_VERSION 4
+#define HDR_COUNT 6
+#define HDR_SESSION 8
+#define HDR_SEQUENCE 12
+#define HDR_BASE 16
+#define HDR_DROPPED 24
+#define HDR_CRC 28
+
+/* ============================================================================
+ * Private Helpers
+ * ============================================================================
+ */
+
+static void put_u16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+  put_u16(p, (uint16_t)v);
+  put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static void put_u64(uint8_t *p, uint64_t v) {
+  put_u32(p, (uint32_t)v);
+  put_u32(p + 4, (uint32_t)(v >> 32));
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+  return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+static uint64_t get_u64(const uint8_t *p) {
+  return get_u32(p) | ((uint64_t)get_u32(p + 4) << 32);
+}
+
+static uint16_t to_milli(float value) {
+  if (!(value > 0.0f)) {
+    return 0; // Negative or NaN
+  }
+  float milli = value * 1000.0f + 0.5f;
+  return milli >= (float)UINT16_MAX ? UINT16_MAX : (uint16_t)milli;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ============================================================================
+ */
+
+uint32_t power_log_crc32(uint32_t crc, const uint8_t *data, size_t length) {
+  // Half-byte table: 16 entries, two lookups per byte
+  static const uint32_t table[16] = {
+      0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4,
+      0x4DB26158, 0x5005713C, 0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+      0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+  };
+
+  crc = ~crc;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    crc = (crc >> 4) ^ table[crc & 0x0F];
+    crc = (crc >> 4) ^ table[crc & 0x0F];
+  }
+  return ~crc;
+}
+
+esp_err_t power_log_ring_init(power_log_ring_t *ring, uint32_t capacity) {
+  if (ring == NULL || capacity < 2 || (capacity & (capacity - 1)) != 0) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(ring, 0, sizeof(*ring));
+  ring->samples = calloc(capacity, sizeof(*ring->samples));
+  if (ring->samples == NULL) {
+    return ESP_ERR_NO_MEM;
+  }
+  ring->capacity = capacity;
+  return ESP_OK;
+}
+
+void power_log_ring_deinit(power_log_ring_t *ring) {
+  if (ring == NULL) {
+    return;
+  }
+  free(ring->samples);
+  ring->samples = NULL;
+  ring->capacity = 0;
+}
+
+bool power_log_ring_push(power_log_ring_t *ring,
+                         const power_log_sample_t *sample) {
+  uint32_t head = ring->head;
+  uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+  uint32_t fill = head - tail;
+
+  if (fill >= ring->capacity) {
+    __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+    ring->overflowed = true;
+    return false;
+  }
+
+  power_log_sample_t *slot = &ring->samples[head & (ring->capacity - 1)];
+  *slot = *sample;
+  if (ring->overflowed) {
+    slot->flags |= POWER_LOG_FLAG_DROPPED;
+    ring->overflowed = false;
+  }
+  if (fill + 1 > ring->high_water) {
+    __atomic_store_n(&ring->high_water, fill + 1, __ATOMIC_RELAXED);
+  }
+  __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+size_t power_log_ring_pop(power_log_ring_t *ring, power_log_sample_t *samples,
+                          size_t max) {
+  uint32_t tail = ring->tail;
+  uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+  size_t count = head - tail;
+  if (count > max) {
+    count = max;
+  }
+
+  for (size_t i = 0; i < count; i++) {
+    samples[i] = ring->samples[(tail + i) & (ring->capacity - 1)];
+  }
+  __atomic_store_n(&ring->tail, tail + (uint32_t)count, __ATOMIC_RELEASE);
+  return count;
+}
+
+uint32_t power_log_ring_count(const power_log_ring_t *ring) {
+  uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+  uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+  return head - tail;
+}
+
+power_log_sample_t power_log_make_sample(int64_t time_us, float voltage,
+                                         float current, uint8_t flags) {
+  power_log_sample_t sample = {
+      .time_us = time_us,
+      .voltage_mv = to_milli(voltage),
+      .current_ma = to_milli(current),
+      .flags = flags,
+  };
+  return sample;
+}
+
+void power_log_encoder_init(power_log_encoder_t *encoder, uint8_t *block,
+                            uint32_t session) {
+  memset(encoder, 0, sizeof(*encoder));
+  encoder->block = block;
+  encoder->session = session;
+}
+
+bool power_log_encoder_add(power_log_encoder_t *encoder,
+                           const power_log_sample_t *sample) {
+  uint32_t delta = 0;
+
+  if (encoder->count >= POWER_LOG_BLOCK_RECORDS) {
+    return false;
+  }
+  if (encoder->count == 0) {
+    encoder->base_us = sample->time_us;
+  } else {
+    int64_t step = sample->time_us - encoder->last_us;
+    if (step < 0 || step > POWER_LOG_MAX_DELTA_US) {
+      return false; // The next block starts from an absolute time
+    }
+    delta = (uint32_t)step;
+  }
+
+  uint8_t *record = encoder->block + POWER_LOG_HEADER_SIZE +
+                    encoder->count * POWER_LOG_RECORD_SIZE;
+  put_u32(record, delta | ((uint32_t)sample->flags << 24));
+  put_u16(record + 4, sample->voltage_mv);
+  put_u16(record + 6, sample->current_ma);
+  encoder->last_us = sample->time_us;
+  encoder->count++;
+  return true;
+}
+
+void power_log_encoder_finish(power_log_encoder_t *encoder, uint32_t dropped) {
+  uint8_t *block = encoder->block;
+  size_t used = POWER_LOG_HEADER_SIZE + encoder->count * POWER_LOG_RECORD_SIZE;
+
+  memset(block + used, 0, POWER_LOG_BLOCK_SIZE - used);
+  put_u32(block + HDR_MAGIC, POWER_LOG_MAGIC);
+  put_u16(block + HDR_VERSION, POWER_LOG_VERSION);
+  put_u16(block + HDR_COUNT, encoder->count);
+  put_u32(block + HDR_SESSION, encoder->session);
+  put_u32(block + HDR_SEQUENCE, encoder->sequence);
+  put_u64(block + HDR_BASE, (uint64_t)encoder->base_us);
+  put_u32(block + HDR_DROPPED, dropped);
+  put_u32(block + HDR_CRC, 0);
+  put_u32(block + HDR_CRC, power_log_crc32(0, block, POWER_LOG_BLOCK_SIZE));
+
+  encoder->sequence++;
+  encoder->count = 0;
+}
+
+esp_err_t power_log_block_parse(const uint8_t *block,
+                                power_log_block_info_t *info) {
+  if (get_u32(block + HDR_MAGIC) != POWER_LOG_MAGIC) {
+    return ESP_ERR_NOT_FOUND;
+  }
+  if (get_u16(block + HDR_VERSION) != POWER_LOG_VERSION) {
+    return ESP_ERR_NOT_SUPPORTED;
+  }
+
+  // CRC of the block with its CRC field read as zero
+  static const uint8_t zero[4] = {0};
+  uint32_t crc = power_log_crc32(0, block, HDR_CRC);
+  crc = power_log_crc32(crc, zero, sizeof(zero));
+  crc = power_log_crc32(crc, block + HDR_CRC + 4,
+                        POWER_LOG_BLOCK_SIZE - HDR_CRC - 4);
+  if (crc != get_u32(block + HDR_CRC)) {
+    return ESP_ERR_INVALID_CRC;
+  }
+
+  info->count = get_u16(block + HDR_COUNT);
+  if (info->count > POWER_LOG_BLOCK_RECORDS) {
+    return ESP_ERR_INVALID_CRC;
+  }
+  info->session = get_u32(block + HDR_SESSION);
+  info->sequence = get_u32(block + HDR_SEQUENCE);
+  info->base_us = (int64_t)get_u64(block + HDR_BASE);
+  info->dropped = get_u32(block + HDR_DROPPED);
+  return ESP_OK;
+}
+
+size_t power_log_block_decode(const uint8_t *block,
+                              const power_log_block_info_t *info,
+                              power_log_sample_t *samples) {
+  int64_t time_us = info->base_us;
+
+  for (uint16_t i = 0; i < info->count; i++) {
+    const uint8_t *record =
+        block + POWER_LOG_HEADER_SIZE + i * POWER_LOG_RECORD_SIZE;
+    uint32_t word = get_u32(record);
+    time_us += word & POWER_LOG_MAX_DELTA_US;
+    samples[i].time_us = time_us;
+    samples[i].flags = (uint8_t)(word >> 24);
+    samples[i].voltage_mv = get_u16(record + 4);
+    samples[i].current_ma = get_u16(record + 6);
+  }
+  return info->count;
+}
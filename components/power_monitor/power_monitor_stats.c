@@ -0,0 +1,344 @@
+/**
+ * @file power_monitor_stats.c
+ * @brief Streaming statistics for supply voltage, current and power
+ *
+ * @author robOS Team
+ * @date 2025
+ */
+
+#include "power_monitor_stats.h"
+#include <math.h>
+#include <string.h>
+
+#define US_PER_HOUR 3600000000.0
+
+static const uint32_t s_window_us[POWER_STATS_WINDOW_COUNT] = {
+    1000000,    // 1 s
+    60000000,   // 1 min
+    3600000000u // 1 h
+};
+
+static const float s_quantiles[POWER_STATS_QUANTILE_COUNT] = {0.50f, 0.95f,
+                                                              0.99f};
+
+/* ============================================================================
+ * Private Helpers
+ * ============================================================================
+ */
+
+static int64_t bucket_id(const power_stats_ring_t *ring, int64_t time_us) {
+  // Floor division, so times before 0 do not share bucket 0
+  int64_t id = time_us / ring->bucket_us;
+  return (time_us < 0 && time_us % ring->bucket_us != 0) ? id - 1 : id;
+}
+
+static void ring_init(power_stats_ring_t *ring, uint32_t window_us) {
+  memset(ring, 0, sizeof(*ring));
+  ring->bucket_us = window_us / POWER_STATS_WINDOW_BUCKETS;
+  ring->head_id = INT64_MIN;
+  for (int i = 0; i < POWER_STATS_WINDOW_BUCKETS; i++) {
+    power_stats_acc_reset(&ring->buckets[i]);
+  }
+}
+
+static void ring_add(power_stats_ring_t *ring, double value,
+                     int64_t time_us) {
+  int64_t id = bucket_id(ring, time_us);
+
+  if (ring->head_id == INT64_MIN || id - ring->head_id >=
+                                        POWER_STATS_WINDOW_BUCKETS) {
+    // First sample, or the whole ring has expired
+    for (int i = 0; i < POWER_STATS_WINDOW_BUCKETS; i++) {
+      power_stats_acc_reset(&ring->buckets[i]);
+    }
+    ring->head = 0;
+    ring->head_id = id;
+  } else {
+    // Advance, clearing the buckets skipped over
+    while (ring->head_id < id) {
+      ring->head = (ring->head + 1) % POWER_STATS_WINDOW_BUCKETS;
+      ring->head_id++;
+      power_stats_acc_reset(&ring->buckets[ring->head]);
+    }
+  }
+
+  int64_t age = ring->head_id - id;
+  if (age >= POWER_STATS_WINDOW_BUCKETS) {
+    return; // Older than the window
+  }
+  int slot = (ring->head + POWER_STATS_WINDOW_BUCKETS - (int)age) %
+             POWER_STATS_WINDOW_BUCKETS;
+  power_stats_acc_add(&ring->buckets[slot], value);
+}
+
+static void ring_collect(const power_stats_ring_t *ring, int64_t now_us,
+                         power_stats_acc_t *acc) {
+  power_stats_acc_reset(acc);
+  if (ring->head_id == INT64_MIN) {
+    return;
+  }
+
+  int64_t now_id = bucket_id(ring, now_us);
+  for (int age = 0; age < POWER_STATS_WINDOW_BUCKETS; age++) {
+    int64_t id = ring->head_id - age;
+    if (now_id - id >= POWER_STATS_WINDOW_BUCKETS) {
+      break;
+    }
+    int slot = (ring->head + POWER_STATS_WINDOW_BUCKETS - age) %
+               POWER_STATS_WINDOW_BUCKETS;
+    power_stats_acc_merge(acc, &ring->buckets[slot]);
+  }
+}
+
+static void summarize_acc(const power_stats_acc_t *acc,
+                          power_stats_summary_t *summary) {
+  summary->count = acc->count;
+  if (acc->count == 0) {
+    summary->mean = NAN;
+    summary->stddev = NAN;
+    summary->min = NAN;
+    summary->max = NAN;
+    return;
+  }
+  summary->mean = (float)acc->mean;
+  summary->stddev =
+      acc->count > 1 ? (float)sqrt(acc->m2 / (double)(acc->count - 1)) : 0.0f;
+  summary->min = acc->min;
+  summary->max = acc->max;
+}
+
+static void sort_floats(float *values, int count) {
+  for (int i = 1; i < count; i++) {
+    float v = values[i];
+    int j = i - 1;
+    while (j >= 0 && values[j] > v) {
+      values[j + 1] = values[j];
+      j--;
+    }
+    values[j + 1] = v;
+  }
+}
+
+/**
+ * @brief Piecewise-parabolic prediction of marker i moved by d (+1 or -1)
+ */
+static float p2_parabolic(const power_stats_p2_t *p2, int i, int d) {
+  const float *q = p2->height;
+  const int64_t *n = p2->position;
+  double left = (double)(n[i] - n[i - 1]);
+  double right = (double)(n[i + 1] - n[i]);
+  return (float)(q[i] + d / (double)(n[i + 1] - n[i - 1]) *
+                            ((left + d) * (q[i + 1] - q[i]) / right +
+                             (right - d) * (q[i] - q[i - 1]) / left));
+}
+
+/* ============================================================================
+ * Public Functions
+ * ============================================================================
+ */
+
+uint32_t power_stats_window_us(power_stats_window_t window) {
+  return s_window_us[window];
+}
+
+void power_stats_acc_reset(power_stats_acc_t *acc) {
+  acc->count = 0;
+  acc->mean = 0.0;
+  acc->m2 = 0.0;
+  acc->min = INFINITY;
+  acc->max = -INFINITY;
+}
+
+void power_stats_acc_add(power_stats_acc_t *acc, double value) {
+  acc->count++;
+  double delta = value - acc->mean;
+  acc->mean += delta / (double)acc->count;
+  acc->m2 += delta * (value - acc->mean);
+  if (value < acc->min) {
+    acc->min = (float)value;
+  }
+  if (value > acc->max) {
+    acc->max = (float)value;
+  }
+}
+
+void power_stats_acc_merge(power_stats_acc_t *acc,
+                           const power_stats_acc_t *other) {
+  if (other->count == 0) {
+    return;
+  }
+  if (acc->count == 0) {
+    *acc = *other;
+    return;
+  }
+
+  double na = (double)acc->count;
+  double nb = (double)other->count;
+  double n = na + nb;
+  double delta = other->mean - acc->mean;
+  acc->mean += delta * nb / n;
+  acc->m2 += other->m2 + delta * delta * na * nb / n;
+  acc->count += other->count;
+  if (other->min < acc->min) {
+    acc->min = other->min;
+  }
+  if (other->max > acc->max) {
+    acc->max = other->max;
+  }
+}
+
+void power_stats_p2_init(power_stats_p2_t *p2, float p) {
+  memset(p2, 0, sizeof(*p2));
+  p2->p = p;
+}
+
+void power_stats_p2_add(power_stats_p2_t *p2, float value) {
+  float *q = p2->height;
+  int64_t *n = p2->position;
+
+  // The first five samples become the initial markers
+  if (p2->count < POWER_STATS_P2_MARKERS) {
+    q[p2->count++] = value;
+    if (p2->count == POWER_STATS_P2_MARKERS) {
+      sort_floats(q, POWER_STATS_P2_MARKERS);
+      for (int i = 0; i < POWER_STATS_P2_MARKERS; i++) {
+        n[i] = i;
+      }
+    }
+    return;
+  }
+
+  // Cell of the new sample; the extreme markers follow min and max
+  int k;
+  if (value < q[0]) {
+    q[0] = value;
+    k = 0;
+  } else if (value >= q[4]) {
+    q[4] = value;
+    k = 3;
+  } else {
+    k = 0;
+    while (k < 3 && value >= q[k + 1]) {
+      k++;
+    }
+  }
+  for (int i = k + 1; i < POWER_STATS_P2_MARKERS; i++) {
+    n[i]++;
+  }
+  p2->count++;
+
+  // Desired marker positions (0-based) are linear in the sample count, so
+  // they are recomputed instead of accumulated
+  const double p = p2->p;
+  const double last = (double)(p2->count - 1);
+  const double desired[POWER_STATS_P2_MARKERS] = {
+      0.0, last * p / 2.0, last * p, last * (1.0 + p) / 2.0, last};
+
+  for (int i = 1; i < POWER_STATS_P2_MARKERS - 1; i++) {
+    double offset = desired[i] - (double)n[i];
+    if ((offset >= 1.0 && n[i + 1] - n[i] > 1) ||
+        (offset <= -1.0 && n[i - 1] - n[i] < -1)) {
+      int d = offset > 0 ? 1 : -1;
+      float candidate = p2_parabolic(p2, i, d);
+      if (q[i - 1] < candidate && candidate < q[i + 1]) {
+        q[i] = candidate;
+      } else {
+        // Linear prediction keeps the heights ordered
+        q[i] += d * (q[i + d] - q[i]) / (float)(n[i + d] - n[i]);
+      }
+      n[i] += d;
+    }
+  }
+}
+
+float power_stats_p2_value(const power_stats_p2_t *p2) {
+  if (p2->count == 0) {
+    return NAN;
+  }
+  if (p2->count >= POWER_STATS_P2_MARKERS) {
+    return p2->height[2];
+  }
+
+  float sorted[POWER_STATS_P2_MARKERS];
+  int count = (int)p2->count;
+  memcpy(sorted, p2->height, count * sizeof(float));
+  sort_floats(sorted, count);
+  int rank = (int)ceilf(p2->p * count) - 1;
+  return sorted[rank < 0 ? 0 : rank];
+}
+
+void power_stats_init(power_stats_engine_t *engine, uint32_t max_gap_us) {
+  memset(engine, 0, sizeof(*engine));
+  engine->max_gap_us = max_gap_us;
+
+  for (int c = 0; c < POWER_STATS_CHANNEL_COUNT; c++) {
+    power_stats_series_t *series = &engine->series[c];
+    power_stats_acc_reset(&series->total);
+    for (int w = 0; w < POWER_STATS_WINDOW_COUNT; w++) {
+      ring_init(&series->windows[w], s_window_us[w]);
+    }
+    for (int q = 0; q < POWER_STATS_QUANTILE_COUNT; q++) {
+      power_stats_p2_init(&series->quantiles[q], s_quantiles[q]);
+    }
+  }
+}
+
+void power_stats_add(power_stats_engine_t *engine,
+                     power_stats_channel_t channel, float value,
+                     int64_t time_us) {
+  if (!isfinite(value)) {
+    return;
+  }
+
+  power_stats_series_t *series = &engine->series[channel];
+  power_stats_acc_add(&series->total, value);
+  for (int w = 0; w < POWER_STATS_WINDOW_COUNT; w++) {
+    ring_add(&series->windows[w], value, time_us);
+  }
+  for (int q = 0; q < POWER_STATS_QUANTILE_COUNT; q++) {
+    power_stats_p2_add(&series->quantiles[q], value);
+  }
+}
+
+void power_stats_add_power(power_stats_engine_t *engine, float power_w,
+                           int64_t time_us) {
+  if (!isfinite(power_w)) {
+    return;
+  }
+
+  power_stats_add(engine, POWER_STATS_POWER, power_w, time_us);
+
+  if (engine->have_power) {
+    int64_t dt_us = time_us - engine->last_power_us;
+    if (dt_us > 0 && dt_us <= (int64_t)engine->max_gap_us) {
+      // Trapezoid over the real interval between the two samples
+      engine->energy_wh +=
+          0.5 * ((double)engine->last_power + power_w) * dt_us / US_PER_HOUR;
+    } else {
+      engine->energy_gaps++;
+      if (dt_us > 0) {
+        engine->gap_us += (uint64_t)dt_us;
+      }
+    }
+  }
+
+  engine->last_power = power_w;
+  engine->last_power_us = time_us;
+  engine->have_power = true;
+}
+
+void power_stats_summarize(const power_stats_engine_t *engine,
+                           power_stats_channel_t channel, int64_t now_us,
+                           power_stats_channel_summary_t *summary) {
+  const power_stats_series_t *series = &engine->series[channel];
+
+  summarize_acc(&series->total, &summary->total);
+  for (int w = 0; w < POWER_STATS_WINDOW_COUNT; w++) {
+    power_stats_acc_t acc;
+    ring_collect(&series->windows[w], now_us, &acc);
+    summarize_acc(&acc, &summary->window[w]);
+  }
+  for (int q = 0; q < POWER_STATS_QUANTILE_COUNT; q++) {
+    summary->quantile[q] = power_stats_p2_value(&series->quantiles[q]);
+  }
+}
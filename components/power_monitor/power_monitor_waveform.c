@@ -0,0 +1,363 @@
+/**
+ * @file power_monitor_waveform.c
+ * @brief Supply voltage waveform: decimation, envelope and transient capture
+ *
+ * @author robOS Team
+ * @date 2025
+ */
+
+#include "power_monitor_waveform.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MEAN_SCALE (1 << POWER_WAVE_MEAN_FRAC_BITS)
+
+/* ============================================================================
+ * Private Helpers
+ * ============================================================================
+ */
+
+static uint64_t ipow(uint32_t base, uint8_t exp) {
+  uint64_t result = 1;
+  while (exp-- > 0) {
+    result *= base;
+  }
+  return result;
+}
+
+static void reset_envelope(power_wave_t *wave) {
+  wave->env_min = UINT16_MAX;
+  wave->env_max = 0;
+}
+
+static void reset_window(power_wave_t *wave) {
+  wave->window.mean = 0.0f;
+  wave->window.min = UINT16_MAX;
+  wave->window.max = 0;
+  wave->window.records = 0;
+  wave->window_sum = 0.0;
+}
+
+/**
+ * @brief Whether a record's envelope leaves the trigger band
+ */
+static bool outside_band(const power_wave_t *wave,
+                         const power_wave_record_t *record,
+                         power_wave_trigger_t *direction) {
+  const power_wave_config_t *c = &wave->config;
+  if (c->dip_codes > 0.0f && record->min < wave->baseline - c->dip_codes) {
+    *direction = POWER_WAVE_TRIGGER_DIP;
+    return true;
+  }
+  if (c->spike_codes > 0.0f && record->max > wave->baseline + c->spike_codes) {
+    *direction = POWER_WAVE_TRIGGER_SPIKE;
+    return true;
+  }
+  return false;
+}
+
+/**
+ * @brief Copy the last count records of the ring into the capture buffer
+ */
+static void finish_capture(power_wave_t *wave) {
+  uint16_t size = wave->history_size;
+  uint16_t count = wave->history_count < size ? wave->history_count : size;
+  uint16_t start = (wave->history_head + size - count) % size;
+
+  // The ring may wrap once
+  uint16_t first = size - start < count ? size - start : count;
+  memcpy(wave->capture, wave->history + start, first * sizeof(*wave->capture));
+  memcpy(wave->capture + first, wave->history,
+         (count - first) * sizeof(*wave->capture));
+
+  wave->pending.count = count;
+  wave->pending.trigger_index = count - 1 - wave->config.post_trigger;
+  wave->info = wave->pending;
+  wave->capturing = false;
+}
+
+/**
+ * @brief Store a record and run the detector on it
+ * @return true if the record completed a capture
+ */
+static bool process_record(power_wave_t *wave,
+                           const power_wave_record_t *record,
+                           int64_t time_us) {
+  bool completed = false;
+  float mean = (float)record->mean / MEAN_SCALE;
+
+  wave->history[wave->history_head] = *record;
+  wave->history_head = (wave->history_head + 1) % wave->history_size;
+  wave->history_count++;
+
+  wave->latest = *record;
+  wave->latest_time_us = time_us;
+  wave->records++;
+  if (wave->record_cb != NULL) {
+    wave->record_cb(record, time_us, wave->record_ctx);
+  }
+
+  wave->window_sum += mean;
+  wave->window.records++;
+  if (record->min < wave->window.min) {
+    wave->window.min = record->min;
+  }
+  if (record->max > wave->window.max) {
+    wave->window.max = record->max;
+  }
+
+  if (!wave->baseline_valid) {
+    wave->baseline = mean;
+    wave->baseline_valid = true;
+  }
+
+  power_wave_trigger_t direction = POWER_WAVE_TRIGGER_DIP;
+  bool outside = outside_band(wave, record, &direction);
+
+  if (wave->capturing) {
+    power_wave_capture_info_t *p = &wave->pending;
+    if (p->trigger == POWER_WAVE_TRIGGER_DIP && record->min < p->extreme) {
+      p->extreme = record->min;
+    } else if (p->trigger == POWER_WAVE_TRIGGER_SPIKE &&
+               record->max > p->extreme) {
+      p->extreme = record->max;
+    }
+    p->outside_records += outside;
+    if (--wave->post_left == 0) {
+      finish_capture(wave);
+      completed = true;
+    }
+    return completed;
+  }
+
+  if (outside && wave->armed) {
+    power_wave_capture_info_t *p = &wave->pending;
+    p->number = wave->info.number + 1;
+    p->trigger_time_us = time_us;
+    p->baseline = wave->baseline;
+    p->trigger = direction;
+    p->extreme = direction == POWER_WAVE_TRIGGER_DIP ? record->min
+                                                     : record->max;
+    p->outside_records = 1;
+    wave->armed = false;
+    wave->post_left = wave->config.post_trigger;
+    wave->capturing = true;
+    if (wave->post_left == 0) {
+      finish_capture(wave);
+      completed = true;
+    }
+    return completed;
+  }
+
+  if (!outside) {
+    // Re-arm once the signal is back, and follow it only while it is calm
+    wave->armed = true;
+    wave->baseline += (mean - wave->baseline) / wave->config.baseline_records;
+  }
+  return completed;
+}
+
+/* ============================================================================
+ * Public Functions
+ * ============================================================================
+ */
+
+power_wave_config_t power_wave_get_default_config(void) {
+  power_wave_config_t config = {
+      .sample_rate_hz = 20000,
+      .ratio = 20,
+      .order = 2,
+      .pre_trigger = 200,
+      .post_trigger = 600,
+      .dip_codes = 0.0f,
+      .spike_codes = 0.0f,
+      .baseline_records = 1000.0f,
+  };
+  return config;
+}
+
+bool power_wave_config_valid(const power_wave_config_t *config) {
+  if (config == NULL || config->sample_rate_hz == 0 ||
+      config->sample_rate_hz > 1000000 || config->ratio == 0 ||
+      config->order == 0 || config->order > POWER_WAVE_MAX_ORDER ||
+      !(config->baseline_records >= 1.0f) || !isfinite(config->dip_codes) ||
+      !isfinite(config->spike_codes) || config->dip_codes < 0.0f ||
+      config->spike_codes < 0.0f) {
+    return false;
+  }
+
+  // The integrators wrap; the decimated sum of one window must fit in 32 bits
+  if (ipow(config->ratio, config->order) * POWER_WAVE_MAX_CODE > UINT32_MAX) {
+    return false;
+  }
+
+  return (uint32_t)config->pre_trigger + config->post_trigger + 1 <= UINT16_MAX;
+}
+
+esp_err_t power_wave_init(power_wave_t *wave,
+                          const power_wave_config_t *config) {
+  if (wave == NULL || !power_wave_config_valid(config)) {
+    return ESP_ERR_INVALID_ARG;
+  }
+
+  memset(wave, 0, sizeof(*wave));
+  wave->config = *config;
+  wave->sample_period_ns = 1000000000u / config->sample_rate_hz;
+  wave->mean_gain =
+      (float)MEAN_SCALE / (float)ipow(config->ratio, config->order);
+  wave->warmup = config->order - 1;
+  wave->pending.record_period_us =
+      (uint32_t)(((uint64_t)wave->sample_period_ns * config->ratio + 500) /
+                 1000);
+  wave->info = wave->pending;
+  wave->history_size = config->pre_trigger + 1 + config->post_trigger;
+  wave->armed = true;
+  reset_envelope(wave);
+  reset_window(wave);
+
+  wave->history = calloc(wave->history_size, sizeof(*wave->history));
+  wave->capture = calloc(wave->history_size, sizeof(*wave->capture));
+  if (wave->history == NULL || wave->capture == NULL) {
+    power_wave_deinit(wave);
+    return ESP_ERR_NO_MEM;
+  }
+
+  return ESP_OK;
+}
+
+void power_wave_deinit(power_wave_t *wave) {
+  if (wave == NULL) {
+    return;
+  }
+  free(wave->history);
+  free(wave->capture);
+  wave->history = NULL;
+  wave->capture = NULL;
+}
+
+void power_wave_set_trigger(power_wave_t *wave, float dip_codes,
+                            float spike_codes) {
+  wave->config.dip_codes = dip_codes;
+  wave->config.spike_codes = spike_codes;
+}
+
+void power_wave_set_record_callback(power_wave_t *wave,
+                                    power_wave_record_cb_t cb, void *ctx) {
+  wave->record_cb = cb;
+  wave->record_ctx = ctx;
+}
+
+size_t power_wave_feed(power_wave_t *wave, const uint16_t *samples,
+                       size_t count, int64_t end_time_us) {
+  const uint8_t order = wave->config.order;
+  const uint16_t ratio = wave->config.ratio;
+  size_t completed = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    uint16_t x = samples[i];
+
+    // Integrators run at the input rate; wrapping is harmless because the
+    // combs take differences and the true output fits in 32 bits
+    wave->integrator[0] += x;
+    for (uint8_t k = 1; k < order; k++) {
+      wave->integrator[k] += wave->integrator[k - 1];
+    }
+    if (x < wave->env_min) {
+      wave->env_min = x;
+    }
+    if (x > wave->env_max) {
+      wave->env_max = x;
+    }
+
+    if (++wave->phase < ratio) {
+      continue;
+    }
+    wave->phase = 0;
+
+    // Combs run at the output rate
+    uint32_t value = wave->integrator[order - 1];
+    for (uint8_t k = 0; k < order; k++) {
+      uint32_t diff = value - wave->comb[k];
+      wave->comb[k] = value;
+      value = diff;
+    }
+
+    power_wave_record_t record = {
+        .mean = (uint16_t)((float)value * wave->mean_gain + 0.5f),
+        .min = wave->env_min,
+        .max = wave->env_max,
+    };
+    reset_envelope(wave);
+
+    // The first order - 1 outputs see the zero state of the filter
+    if (wave->warmup > 0) {
+      wave->warmup--;
+      continue;
+    }
+
+    uint64_t behind_ns = (uint64_t)(count - 1 - i) * wave->sample_period_ns;
+    completed += process_record(wave, &record,
+                                end_time_us - (int64_t)(behind_ns / 1000));
+  }
+
+  wave->samples += count;
+  return completed;
+}
+
+bool power_wave_take_window(power_wave_t *wave, power_wave_window_t *window) {
+  if (wave->window.records == 0) {
+    return false;
+  }
+
+  *window = wave->window;
+  window->mean = (float)(wave->window_sum / wave->window.records);
+  reset_window(wave);
+  return true;
+}
+
+size_t power_wave_copy_capture(const power_wave_t *wave,
+                               power_wave_capture_info_t *info,
+                               power_wave_record_t *records,
+                               size_t max_records) {
+  *info = wave->info;
+  if (wave->info.number == 0) {
+    return 0;
+  }
+
+  size_t count = wave->info.count;
+  if (records == NULL) {
+    return count;
+  }
+  if (count > max_records) {
+    count = max_records;
+  }
+  memcpy(records, wave->capture, count * sizeof(*records));
+  return count;
+}
+
+float power_wave_to_volts(const power_wave_scale_t *scale, float codes) {
+  return scale->offset_v + codes * scale->volts_per_code;
+}
+
+esp_err_t power_wave_write_csv(FILE *f, const power_wave_capture_info_t *info,
+                               const power_wave_record_t *records,
+                               const power_wave_scale_t *scale) {
+  if (fprintf(f, "time_ms,mean_v,min_v,max_v\n") < 0) {
+    return ESP_FAIL;
+  }
+
+  for (uint16_t i = 0; i < info->count; i++) {
+    float t_ms =
+        ((int32_t)i - info->trigger_index) * (info->record_period_us / 1000.0f);
+    float mean =
+        power_wave_to_volts(scale, (float)records[i].mean / MEAN_SCALE);
+    if (fprintf(f, "%.3f,%.3f,%.3f,%.3f\n", t_ms, mean,
+                power_wave_to_volts(scale, records[i].min),
+                power_wave_to_volts(scale, records[i].max)) < 0) {
+      return ESP_FAIL;
+    }
+  }
+
+  return ESP_OK;
+}
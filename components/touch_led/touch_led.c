@@ -17,6 +17,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "freertos/task.h"
+#include "led_kernel.h"
 #include <math.h>
 #include <string.h>
 
@@ -81,7 +82,6 @@ static touch_led_state_t s_touch_led = {0};
 static void animation_task(void *arg);
 static void touch_detection_task(void *arg);
 static esp_err_t apply_brightness(rgb_color_t *color, uint8_t brightness);
-static rgb_color_t hsv_to_rgb(float h, float s, float v);
 
 esp_err_t touch_led_init(const touch_led_config_t *config) {
   if (!config || config->led_count == 0) {
@@ -487,59 +487,13 @@ static esp_err_t apply_brightness(rgb_color_t *color, uint8_t brightness) {
     return ESP_ERR_INVALID_ARG;
   }
 
-  color->red = (color->red * brightness) / 255;
-  color->green = (color->green * brightness) / 255;
-  color->blue = (color->blue * brightness) / 255;
+  color->red = led_kernel_scale8(color->red, brightness);
+  color->green = led_kernel_scale8(color->green, brightness);
+  color->blue = led_kernel_scale8(color->blue, brightness);
 
   return ESP_OK;
 }
 
-// Convert HSV to RGB
-static rgb_color_t hsv_to_rgb(float h, float s, float v) {
-  rgb_color_t rgb = {0, 0, 0};
-
-  int i = (int)(h / 60.0f) % 6;
-  float f = (h / 60.0f) - i;
-  float p = v * (1.0f - s);
-  float q = v * (1.0f - s * f);
-  float t = v * (1.0f - s * (1.0f - f));
-
-  switch (i) {
-  case 0:
-    rgb.red = (uint8_t)(v * 255);
-    rgb.green = (uint8_t)(t * 255);
-    rgb.blue = (uint8_t)(p * 255);
-    break;
-  case 1:
-    rgb.red = (uint8_t)(q * 255);
-    rgb.green = (uint8_t)(v * 255);
-    rgb.blue = (uint8_t)(p * 255);
-    break;
-  case 2:
-    rgb.red = (uint8_t)(p * 255);
-    rgb.green = (uint8_t)(v * 255);
-    rgb.blue = (uint8_t)(t * 255);
-    break;
-  case 3:
-    rgb.red = (uint8_t)(p * 255);
-    rgb.green = (uint8_t)(q * 255);
-    rgb.blue = (uint8_t)(v * 255);
-    break;
-  case 4:
-    rgb.red = (uint8_t)(t * 255);
-    rgb.green = (uint8_t)(p * 255);
-    rgb.blue = (uint8_t)(v * 255);
-    break;
-  case 5:
-    rgb.red = (uint8_t)(v * 255);
-    rgb.green = (uint8_t)(p * 255);
-    rgb.blue = (uint8_t)(q * 255);
-    break;
-  }
-
-  return rgb;
-}
-
 // Animation task implementation
 static void animation_task(void *arg) {
   TickType_t last_wake_time = xTaskGetTickCount();
@@ -549,12 +503,13 @@ static void animation_task(void *arg) {
 
     switch (s_touch_led.current_animation) {
     case TOUCH_LED_ANIM_RAINBOW: {
-      float hue = (s_touch_led.animation_step * 360.0f) / 255.0f;
+      uint32_t hue = s_touch_led.animation_step * LED_KERNEL_ANGLE_FULL / 255;
 
       for (uint16_t i = 0; i < s_touch_led.config.led_count; i++) {
-        float led_hue =
-            fmodf(hue + (i * 360.0f / s_touch_led.config.led_count), 360.0f);
-        rgb_color_t led_color = hsv_to_rgb(led_hue, 1.0f, 1.0f);
+        uint16_t led_hue = (uint16_t)(
+            hue + i * LED_KERNEL_ANGLE_FULL / s_touch_led.config.led_count);
+        led_kernel_rgb_t rgb = led_kernel_hsv_to_rgb(led_hue, 255, 255);
+        rgb_color_t led_color = {rgb.r, rgb.g, rgb.b};
         apply_brightness(&led_color, s_touch_led.current_brightness);
         led_strip_set_pixel(s_touch_led.led_strip, i, led_color.red,
                             led_color.green, led_color.blue);
@@ -564,12 +519,11 @@ static void animation_task(void *arg) {
     }
 
     case TOUCH_LED_ANIM_BREATHE: {
-      float brightness_factor =
-          (sinf(s_touch_led.animation_step * 2.0f * M_PI / 255.0f) + 1.0f) /
-          2.0f;
+      uint8_t brightness_factor = led_kernel_wave8((uint16_t)(
+          s_touch_led.animation_step * LED_KERNEL_ANGLE_FULL / 255));
       rgb_color_t color = s_touch_led.animation_primary_color;
       uint8_t brightness =
-          (uint8_t)(s_touch_led.current_brightness * brightness_factor);
+          led_kernel_scale8(s_touch_led.current_brightness, brightness_factor);
       apply_brightness(&color, brightness);
 
       for (uint16_t i = 0; i < s_touch_led.config.led_count; i++) {
@@ -0,0 +1,156 @@
+/**
+ * @file agx_history_replay.c
+ * @brief 把设备保存的 AGX 指标历史（agx_monitor history save）转成 CSV
+ *
+ *   agx_history_replay <文件>                      各层级概况
+ *   agx_history_replay <文件> <raw|1m|10m>         该层级所有通道，每行一个时刻
+ *   agx_history_replay <文件> <raw|1m|10m> <通道>  该通道的 min/avg/max
+ *
+ * 时间为设备启动后的秒数，温度单位 °C，功耗 mW。聚合层级不带通道时输出
+ * 平均值。
+ */
+
+#include "agx_monitor_history.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *const k_tier_names[AGX_HISTORY_TIER_COUNT] = {"raw", "1m",
+                                                                 "10m"};
+
+static void print_value(int32_t value, agx_history_channel_t channel) {
+  int scale = agx_monitor_history_channel_scale(channel);
+  if (scale == 1) {
+    printf("%d", value);
+  } else {
+    printf("%.2f", (double)value / scale);
+  }
+}
+
+static void print_summary(const agx_monitor_history_t *history,
+                          uint32_t saved_at) {
+  printf("saved at %u s, %u samples\n", saved_at, history->samples);
+  for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+    agx_history_tier_stats_t stats;
+    agx_monitor_history_get_stats(history, t, &stats);
+    printf("%-4s %6u records, %6u/%6u bytes, %u..%u s\n", k_tier_names[t],
+           stats.records, stats.bytes_used, stats.capacity, stats.oldest_time,
+           stats.newest_time);
+  }
+}
+
+static int print_channel(const agx_monitor_history_t *history,
+                         agx_history_tier_t tier,
+                         agx_history_channel_t channel) {
+  agx_history_tier_stats_t stats;
+  agx_monitor_history_get_stats(history, tier, &stats);
+  if (stats.records == 0) {
+    return 0;
+  }
+
+  agx_history_point_t *points = malloc(stats.records * sizeof(*points));
+  if (points == NULL) {
+    return 1;
+  }
+  size_t n = agx_monitor_history_query(history, tier, channel, 0, points,
+                                       stats.records);
+  printf(tier == AGX_HISTORY_TIER_RAW ? "time,value\n" : "time,min,avg,max\n");
+  for (size_t i = 0; i < n; i++) {
+    printf("%u,", points[i].time);
+    if (tier == AGX_HISTORY_TIER_RAW) {
+      print_value(points[i].avg, channel);
+    } else {
+      print_value(points[i].min, channel);
+      printf(",");
+      print_value(points[i].avg, channel);
+      printf(",");
+      print_value(points[i].max, channel);
+    }
+    printf("\n");
+  }
+  free(points);
+  return 0;
+}
+
+static int print_tier(const agx_monitor_history_t *history,
+                      agx_history_tier_t tier) {
+  agx_history_tier_stats_t stats;
+  agx_monitor_history_get_stats(history, tier, &stats);
+  if (stats.records == 0) {
+    return 0;
+  }
+
+  // 同一层级所有通道的记录时刻相同，按通道分别查询后按行拼接
+  agx_history_point_t *points =
+      malloc((size_t)stats.records * AGX_HISTORY_CHANNELS * sizeof(*points));
+  if (points == NULL) {
+    return 1;
+  }
+  size_t n = 0;
+  char name[16];
+  printf("time");
+  for (int ch = 0; ch < AGX_HISTORY_CHANNELS; ch++) {
+    n = agx_monitor_history_query(history, tier, ch, 0,
+                                  points + (size_t)ch * stats.records,
+                                  stats.records);
+    printf(",%s", agx_monitor_history_channel_name(ch, name, sizeof(name)));
+  }
+  printf("\n");
+  for (size_t i = 0; i < n; i++) {
+    printf("%u", points[i].time);
+    for (int ch = 0; ch < AGX_HISTORY_CHANNELS; ch++) {
+      printf(",");
+      print_value(points[(size_t)ch * stats.records + i].avg, ch);
+    }
+    printf("\n");
+  }
+  free(points);
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  agx_monitor_history_t history;
+  agx_history_tier_t tier = AGX_HISTORY_TIER_COUNT;
+  agx_history_channel_t channel;
+  uint32_t saved_at = 0;
+  int ret = 0;
+
+  if (argc < 2 || argc > 4) {
+    fprintf(stderr, "usage: %s <file> [raw|1m|10m] [channel]\n", argv[0]);
+    return 2;
+  }
+  if (argc > 2) {
+    for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+      if (strcmp(argv[2], k_tier_names[t]) == 0) {
+        tier = (agx_history_tier_t)t;
+      }
+    }
+    if (tier == AGX_HISTORY_TIER_COUNT) {
+      fprintf(stderr, "unknown tier: %s\n", argv[2]);
+      return 2;
+    }
+  }
+  if (argc > 3 &&
+      agx_monitor_history_channel_from_name(argv[3], &channel) != ESP_OK) {
+    fprintf(stderr, "unknown channel: %s\n", argv[3]);
+    return 2;
+  }
+
+  esp_err_t err = agx_monitor_history_load(&history, argv[1], &saved_at);
+  if (err != ESP_OK) {
+    fprintf(stderr, "%s: cannot load history (0x%x)\n", argv[1], err);
+    return 1;
+  }
+
+  if (argc == 2) {
+    print_summary(&history, saved_at);
+  } else if (argc == 3) {
+    ret = print_tier(&history, tier);
+  } else {
+    ret = print_channel(&history, tier, channel);
+  }
+
+  agx_monitor_history_deinit(&history);
+  return ret;
+}
@@ -0,0 +1,1017 @@
+/**
+ * @file agx_replay.c
+ * @brief 主机端 AGX Socket.IO 替身服务器
+ */
+
+#define _GNU_SOURCE
+
+#include "agx_replay.h"
+
+#include "agx_monitor_binary.h"
+#include "agx_monitor_parser.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define WS_GUID "258EAFA5-E914-47DA-95CA-C5AB0DC11B65"
+#define SID "robos-replay"
+#define HANDSHAKE_TIMEOUT_MS 2000
+#define CLOSE_DRAIN_MS 500
+#define STOP_POLL_MS 50
+#define MAX_CLIENT_MESSAGE 256
+
+struct agx_replay_server {
+  agx_replay_config_t config;
+  int listen_fd;
+  uint16_t port;
+  pthread_t thread;
+  bool stopping;
+  uint32_t rng;
+
+  char **lines; ///< 录制的帧
+  size_t *line_lens;
+  size_t line_count;
+  uint32_t seq; ///< 下一帧的序号（合成）或行号（回放）
+
+  pthread_mutex_t stats_mutex;
+  agx_replay_stats_t stats;
+};
+
+/** 一个客户端连接 */
+typedef struct {
+  int fd;
+  agx_ws_decoder_t decoder;
+  char message[MAX_CLIENT_MESSAGE];
+  size_t message_len;
+  bool closed;        ///< 收到 close 帧或 EOF
+  bool namespace_req; ///< 收到 "40"
+  bool format_req;    ///< 收到 telemetry_format 请求
+  uint16_t fields;    ///< 请求的二进制字段
+  uint32_t pongs;     ///< 收到的 "3"
+} conn_t;
+
+static uint64_t now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint32_t next_rng(agx_replay_server_t *s) {
+  uint32_t x = s->rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  s->rng = x;
+  return x;
+}
+
+static bool chance(agx_replay_server_t *s, int percent) {
+  return (int)(next_rng(s) % 100) < percent;
+}
+
+static bool is_stopping(agx_replay_server_t *s) {
+  return __atomic_load_n(&s->stopping, __ATOMIC_ACQUIRE);
+}
+
+#define STAT_ADD(s, field, n)                                                  \
+  do {                                                                         \
+    pthread_mutex_lock(&(s)->stats_mutex);                                     \
+    (s)->stats.field += (n);                                                   \
+    pthread_mutex_unlock(&(s)->stats_mutex);                                   \
+  } while (0)
+
+/* ============================================================================
+ * SHA-1 / base64（仅用于握手）
+ * ============================================================================
+ */
+
+static uint32_t rol(uint32_t x, int n) { return (x << n) | (x >> (32 - n)); }
+
+static void sha1_block(uint32_t h[5], const uint8_t *block) {
+  uint32_t w[80];
+  for (int i = 0; i < 16; i++) {
+    w[i] = (uint32_t)block[i * 4] << 24 | (uint32_t)block[i * 4 + 1] << 16 |
+           (uint32_t)block[i * 4 + 2] << 8 | block[i * 4 + 3];
+  }
+  for (int i = 16; i < 80; i++) {
+    w[i] = rol(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+  }
+
+  uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+  for (int i = 0; i < 80; i++) {
+    uint32_t f, k;
+    if (i < 20) {
+      f = (b & c) | (~b & d);
+      k = 0x5A827999;
+    } else if (i < 40) {
+      f = b ^ c ^ d;
+      k = 0x6ED9EBA1;
+    } else if (i < 60) {
+      f = (b & c) | (b & d) | (c & d);
+      k = 0x8F1BBCDC;
+    } else {
+      f = b ^ c ^ d;
+      k = 0xCA62C1D6;
+    }
+    uint32_t t = rol(a, 5) + f + e + k + w[i];
+    e = d;
+    d = c;
+    c = rol(b, 30);
+    b = a;
+    a = t;
+  }
+  h[0] += a;
+  h[1] += b;
+  h[2] += c;
+  h[3] += d;
+  h[4] += e;
+}
+
+static void sha1(const uint8_t *data, size_t len, uint8_t digest[20]) {
+  uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476,
+                   0xC3D2E1F0};
+  uint8_t block[64];
+  size_t pos = 0;
+
+  for (; pos + 64 <= len; pos += 64) {
+    sha1_block(h, data + pos);
+  }
+  size_t rest = len - pos;
+  memset(block, 0, sizeof(block));
+  memcpy(block, data + pos, rest);
+  block[rest] = 0x80;
+  if (rest >= 56) {
+    sha1_block(h, block);
+    memset(block, 0, sizeof(block));
+  }
+  uint64_t bits = (uint64_t)len * 8;
+  for (int i = 0; i < 8; i++) {
+    block[63 - i] = (uint8_t)(bits >> (i * 8));
+  }
+  sha1_block(h, block);
+
+  for (int i = 0; i < 20; i++) {
+    digest[i] = (uint8_t)(h[i / 4] >> (24 - (i % 4) * 8));
+  }
+}
+
+static void base64(const uint8_t *data, size_t len, char *out) {
+  static const char table[] =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  size_t o = 0;
+  for (size_t i = 0; i < len; i += 3) {
+    uint32_t v = (uint32_t)data[i] << 16;
+    if (i + 1 < len) {
+      v |= (uint32_t)data[i + 1] << 8;
+    }
+    if (i + 2 < len) {
+      v |= data[i + 2];
+    }
+    out[o++] = table[(v >> 18) & 63];
+    out[o++] = table[(v >> 12) & 63];
+    out[o++] = i + 1 < len ? table[(v >> 6) & 63] : '=';
+    out[o++] = i + 2 < len ? table[v & 63] : '=';
+  }
+  out[o] = '\0';
+}
+
+void agx_ws_accept_key(const char *key, char *accept) {
+  char buf[128];
+  uint8_t digest[20];
+  int n = snprintf(buf, sizeof(buf), "%s%s", key, WS_GUID);
+  sha1((const uint8_t *)buf, (size_t)n, digest);
+  base64(digest, sizeof(digest), accept);
+}
+
+/* ============================================================================
+ * WebSocket 分帧
+ * ============================================================================
+ */
+
+size_t agx_ws_header(uint8_t *header, uint8_t opcode, bool fin, size_t len,
+                     const uint8_t *mask) {
+  size_t n = 0;
+  header[n++] = (uint8_t)((fin ? 0x80 : 0) | opcode);
+  uint8_t mask_bit = mask != NULL ? 0x80 : 0;
+  if (len < 126) {
+    header[n++] = (uint8_t)(mask_bit | len);
+  } else if (len <= 0xFFFF) {
+    header[n++] = mask_bit | 126;
+    header[n++] = (uint8_t)(len >> 8);
+    header[n++] = (uint8_t)len;
+  } else {
+    header[n++] = mask_bit | 127;
+    for (int i = 7; i >= 0; i--) {
+      header[n++] = (uint8_t)((uint64_t)len >> (i * 8));
+    }
+  }
+  if (mask != NULL) {
+    memcpy(header + n, mask, 4);
+    n += 4;
+  }
+  return n;
+}
+
+void agx_ws_decoder_reset(agx_ws_decoder_t *d) {
+  memset(d, 0, sizeof(*d));
+  d->header_need = 2;
+}
+
+bool agx_ws_decode(agx_ws_decoder_t *d, uint8_t *data, size_t len,
+                   agx_ws_chunk_cb_t cb, void *ctx) {
+  size_t pos = 0;
+
+  while (pos < len || (d->in_payload && d->payload_len == 0)) {
+    if (!d->in_payload) {
+      while (d->header_len < d->header_need && pos < len) {
+        d->header[d->header_len++] = data[pos++];
+        if (d->header_len == 2) {
+          uint8_t l = d->header[1] & 0x7F;
+          d->header_need = 2 + (l == 126 ? 2 : l == 127 ? 8 : 0) +
+                           ((d->header[1] & 0x80) ? 4 : 0);
+        }
+      }
+      if (d->header_len < d->header_need) {
+        return true;
+      }
+
+      const uint8_t *h = d->header;
+      size_t n = 2;
+      uint64_t plen = h[1] & 0x7F;
+      if (plen == 126) {
+        plen = (uint64_t)h[2] << 8 | h[3];
+        n = 4;
+      } else if (plen == 127) {
+        plen = 0;
+        for (int i = 0; i < 8; i++) {
+          plen = plen << 8 | h[2 + i];
+        }
+        n = 10;
+        if (plen > UINT32_MAX) {
+          return false;
+        }
+      }
+      d->opcode = h[0] & 0x0F;
+      d->fin = (h[0] & 0x80) != 0;
+      d->masked = (h[1] & 0x80) != 0;
+      if (d->masked) {
+        memcpy(d->mask, h + n, 4);
+      }
+      d->payload_len = (size_t)plen;
+      d->offset = 0;
+      d->in_payload = true;
+    }
+
+    size_t n = len - pos;
+    if (n > d->payload_len - d->offset) {
+      n = d->payload_len - d->offset;
+    }
+    if (d->masked) {
+      for (size_t i = 0; i < n; i++) {
+        data[pos + i] ^= d->mask[(d->offset + i) & 3];
+      }
+    }
+    cb(ctx, (const char *)data + pos, n, d->opcode, d->fin, d->payload_len,
+       d->offset);
+    pos += n;
+    d->offset += n;
+    if (d->offset == d->payload_len) {
+      d->in_payload = false;
+      d->header_len = 0;
+      d->header_need = 2;
+    }
+  }
+  return true;
+}
+
+/* ============================================================================
+ * 合成数据
+ * ============================================================================
+ */
+
+static uint32_t mix(uint32_t seq, uint32_t salt) {
+  uint32_t x = seq * 0x9E3779B1u + salt * 0x85EBCA77u;
+  x ^= x >> 15;
+  x *= 0x2C1B3C6Du;
+  x ^= x >> 12;
+  return x;
+}
+
+/* 缓慢变化的值：每 100 帧一个台阶，模拟真实负载 */
+static uint32_t drift(uint32_t seq, uint32_t salt, uint32_t range) {
+  uint32_t step = mix(seq / 100, salt) % range;
+  uint32_t noise = mix(seq, salt + 1) % (range / 10 + 1);
+  return (step + noise) % range;
+}
+
+static void set_unit(char *unit, const char *text) {
+  memset(unit, 0, 4);
+  strncpy(unit, text, 3);
+}
+
+size_t agx_replay_synth(uint32_t seq, char *frame, size_t size,
+                        agx_monitor_data_t *expected) {
+  agx_monitor_data_t d;
+  memset(&d, 0, sizeof(d));
+
+  uint32_t ms = seq;
+  snprintf(d.timestamp, sizeof(d.timestamp),
+           "2025-10-%02uT%02u:%02u:%02u.%03u000Z", 1 + ms / 86400000,
+           ms / 3600000 % 24, ms / 60000 % 60, ms / 1000 % 60, ms % 1000);
+
+  d.cpu.core_count = AGX_REPLAY_CORES;
+  for (int i = 0; i < AGX_REPLAY_CORES; i++) {
+    d.cpu.cores[i].id = (uint8_t)i;
+    d.cpu.cores[i].usage = (uint8_t)drift(seq, 10 + i, 101);
+    d.cpu.cores[i].freq = (uint16_t)(729 + drift(seq, 30 + i, 1473));
+  }
+  d.memory.ram.used = 4000 + drift(seq, 50, 20000);
+  d.memory.ram.total = 62841;
+  set_unit(d.memory.ram.unit, "MB");
+  d.memory.swap.used = drift(seq, 51, 100);
+  d.memory.swap.total = 31420;
+  d.memory.swap.cached = drift(seq, 52, 10);
+  set_unit(d.memory.swap.unit, "MB");
+
+  int32_t temps[5];
+  for (int i = 0; i < 5; i++) {
+    temps[i] = 3500 + (int32_t)drift(seq, 60 + i, 4000); // 0.01 °C
+  }
+  d.temperature.cpu = (float)(temps[0] / 100.0);
+  d.temperature.soc0 = (float)(temps[1] / 100.0);
+  d.temperature.soc1 = (float)(temps[2] / 100.0);
+  d.temperature.soc2 = (float)(temps[3] / 100.0);
+  d.temperature.tj = (float)(temps[4] / 100.0);
+
+  agx_power_info_t *rails[] = {&d.power.gpu_soc, &d.power.cpu_cv,
+                               &d.power.sys_5v, &d.power.ram, &d.power.swap};
+  static const uint32_t max_mw[] = {30000, 15000, 12000, 3000, 500};
+  for (int i = 0; i < 5; i++) {
+    rails[i]->current = drift(seq, 70 + i, max_mw[i]);
+    rails[i]->average = drift(seq / 10, 80 + i, max_mw[i]);
+    set_unit(rails[i]->unit, "mW");
+  }
+  d.gpu.gr3d_freq = (uint8_t)drift(seq, 90, 100);
+
+  // 与 tegrastats 服务的输出相同的成员顺序
+  size_t n = (size_t)snprintf(
+      frame, size, "42[\"tegrastats_update\",{\"timestamp\":\"%s\",\"cpu\":"
+                   "{\"cores\":[",
+      d.timestamp);
+  for (int i = 0; i < AGX_REPLAY_CORES && n < size; i++) {
+    n += (size_t)snprintf(frame + n, size - n,
+                          "%s{\"id\":%u,\"usage\":%u,\"freq\":%u}",
+                          i ? "," : "", d.cpu.cores[i].id,
+                          d.cpu.cores[i].usage, d.cpu.cores[i].freq);
+  }
+  if (n < size) {
+    n += (size_t)snprintf(
+        frame + n, size - n,
+        "]},\"memory\":{\"ram\":{\"used\":%u,\"total\":%u,\"unit\":\"MB\"},"
+        "\"swap\":{\"used\":%u,\"total\":%u,\"cached\":%u,\"unit\":\"MB\"}},"
+        "\"temperature\":{\"cpu\":%d.%02d,\"soc0\":%d.%02d,\"soc1\":%d.%02d,"
+        "\"soc2\":%d.%02d,\"tj\":%d.%02d},\"power\":{",
+        d.memory.ram.used, d.memory.ram.total, d.memory.swap.used,
+        d.memory.swap.total, d.memory.swap.cached, temps[0] / 100,
+        temps[0] % 100, temps[1] / 100, temps[1] % 100, temps[2] / 100,
+        temps[2] % 100, temps[3] / 100, temps[3] % 100, temps[4] / 100,
+        temps[4] % 100);
+  }
+  static const char *const rail_names[] = {"gpu_soc", "cpu_cv", "sys_5v",
+                                           "ram", "swap"};
+  for (int i = 0; i < 5 && n < size; i++) {
+    n += (size_t)snprintf(
+        frame + n, size - n,
+        "%s\"%s\":{\"current\":%u,\"average\":%u,\"unit\":\"mW\"}",
+        i ? "," : "", rail_names[i], rails[i]->current, rails[i]->average);
+  }
+  if (n < size) {
+    n += (size_t)snprintf(frame + n, size - n, "},\"gpu\":{\"gr3d_freq\":%u}}]",
+                          d.gpu.gr3d_freq);
+  }
+
+  if (expected != NULL) {
+    memcpy(expected, &d, sizeof(d)); // 包括填充字节，可以直接 memcmp
+  }
+  return n < size ? n : 0;
+}
+
+bool agx_replay_seq(const char *timestamp, uint32_t *seq) {
+  unsigned day, h, m, s, ms;
+  int end = 0;
+  if (sscanf(timestamp, "2025-10-%2uT%2u:%2u:%2u.%3u000Z%n", &day, &h, &m, &s,
+             &ms, &end) != 5 ||
+      end != (int)strlen(timestamp) || day < 1) {
+    return false;
+  }
+  *seq = (day - 1) * 86400000u + h * 3600000u + m * 60000u + s * 1000u + ms;
+  return true;
+}
+
+/* ============================================================================
+ * 录制的会话
+ * ============================================================================
+ */
+
+static bool load_recording(agx_replay_server_t *s, const char *path) {
+  FILE *f = fopen(path, "r");
+  if (f == NULL) {
+    return false;
+  }
+
+  size_t capacity = 0;
+  char line[AGX_REPLAY_MAX_FRAME];
+  while (fgets(line, sizeof(line), f) != NULL) {
+    size_t len = strcspn(line, "\r\n");
+    line[len] = '\0';
+    if (len == 0) {
+      continue;
+    }
+
+    char frame[AGX_REPLAY_MAX_FRAME];
+    int n;
+    if (line[0] == '{') {
+      n = snprintf(frame, sizeof(frame), "42[\"tegrastats_update\",%s]", line);
+    } else if (strncmp(line, "42", 2) == 0) {
+      n = snprintf(frame, sizeof(frame), "%s", line);
+    } else {
+      continue;
+    }
+    if (n <= 0 || (size_t)n >= sizeof(frame)) {
+      continue;
+    }
+
+    if (s->line_count == capacity) {
+      capacity = capacity ? capacity * 2 : 64;
+      s->lines = realloc(s->lines, capacity * sizeof(*s->lines));
+      s->line_lens = realloc(s->line_lens, capacity * sizeof(*s->line_lens));
+    }
+    s->lines[s->line_count] = strdup(frame);
+    s->line_lens[s->line_count] = (size_t)n;
+    s->line_count++;
+  }
+  fclose(f);
+  return s->line_count > 0;
+}
+
+static void free_recording(agx_replay_server_t *s) {
+  for (size_t i = 0; i < s->line_count; i++) {
+    free(s->lines[i]);
+  }
+  free(s->lines);
+  free(s->line_lens);
+}
+
+/* ============================================================================
+ * 发送
+ * ============================================================================
+ */
+
+static bool send_all(agx_replay_server_t *s, int fd, const void *data,
+                     size_t len) {
+  const uint8_t *p = data;
+  while (len > 0) {
+    ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= (size_t)n;
+    STAT_ADD(s, bytes_sent, (uint64_t)n);
+  }
+  return true;
+}
+
+/* 一个 WebSocket 帧，split 时分几次写入，让客户端分段读到 */
+static bool send_frame(agx_replay_server_t *s, int fd, uint8_t opcode,
+                       bool fin, const char *payload, size_t len, bool split) {
+  uint8_t buf[14 + AGX_REPLAY_MAX_FRAME];
+  if (len > AGX_REPLAY_MAX_FRAME) {
+    return false;
+  }
+  size_t n = agx_ws_header(buf, opcode, fin, len, NULL);
+  memcpy(buf + n, payload, len);
+  n += len;
+
+  if (!split || n < 8) {
+    return send_all(s, fd, buf, n);
+  }
+  int pieces = 2 + (int)(next_rng(s) % 3);
+  size_t pos = 0;
+  for (int i = 0; i < pieces && pos < n; i++) {
+    size_t piece = i == pieces - 1 ? n - pos : 1 + next_rng(s) % (n - pos);
+    if (!send_all(s, fd, buf + pos, piece)) {
+      return false;
+    }
+    pos += piece;
+    usleep(200);
+  }
+  return true;
+}
+
+static bool send_text(agx_replay_server_t *s, int fd, const char *text) {
+  return send_frame(s, fd, 0x1, true, text, strlen(text), false);
+}
+
+/**
+ * @brief 把帧改成一定无法解析的形式
+ *
+ * 要么在 JSON 对象结束之前截断，要么把对象中字符串之外的一个结构字符
+ * 换成 '#'。
+ */
+static size_t corrupt(agx_replay_server_t *s, char *frame, size_t len) {
+  char *open = memchr(frame, '{', len);
+  if (open == NULL) {
+    return len / 2;
+  }
+  size_t start = (size_t)(open - frame);
+  size_t end = len;
+  while (end > start && frame[end - 1] != '}') {
+    end--;
+  }
+  if (end <= start + 2) {
+    return start + 1;
+  }
+
+  if (chance(s, 50)) {
+    return start + 1 + next_rng(s) % (end - 1 - start - 1);
+  }
+
+  size_t structural[AGX_REPLAY_MAX_FRAME];
+  size_t count = 0;
+  bool in_string = false;
+  for (size_t i = start; i < end; i++) {
+    char c = frame[i];
+    if (in_string) {
+      if (c == '\\') {
+        i++;
+      } else if (c == '"') {
+        in_string = false;
+      }
+    } else if (c == '"') {
+      in_string = true;
+    } else if (strchr("{}[]:,", c) != NULL) {
+      structural[count++] = i;
+    }
+  }
+  if (count == 0) {
+    return end - 1;
+  }
+  frame[structural[next_rng(s) % count]] = '#';
+  return len;
+}
+
+/* 把 JSON 帧换成二进制记录，返回记录长度 */
+static size_t to_record(char *frame, size_t len, uint16_t fields) {
+  agx_monitor_data_t data;
+  if (agx_monitor_parse_frame(frame, len, &data, NULL) != ESP_OK) {
+    return 0;
+  }
+  return agx_monitor_binary_encode(&data, fields, (uint8_t *)frame,
+                                   AGX_REPLAY_MAX_FRAME);
+}
+
+/**
+ * @brief 发出下一帧 tegrastats_update
+ *
+ * @param fields 协商的二进制字段，0 = 发 JSON
+ * @param cut 只写出一半后返回 false（中途断开）
+ */
+static bool send_update(agx_replay_server_t *s, int fd, uint16_t fields,
+                        bool cut) {
+  char frame[AGX_REPLAY_MAX_FRAME];
+  size_t len;
+
+  if (s->line_count > 0) {
+    len = s->line_lens[s->seq % s->line_count];
+    memcpy(frame, s->lines[s->seq % s->line_count], len);
+  } else {
+    len = agx_replay_synth(s->seq, frame, sizeof(frame), NULL);
+  }
+  s->seq++;
+
+  uint8_t opcode = 0x1;
+  if (fields != 0) {
+    size_t record_len = to_record(frame, len, fields);
+    if (record_len > 0) {
+      len = record_len;
+      opcode = 0x2;
+    }
+  }
+
+  bool malformed = chance(s, s->config.malformed_percent);
+  if (malformed) {
+    // 截断的记录与其字段不符，一定被拒绝
+    len = opcode == 0x2 ? len / 2 : corrupt(s, frame, len);
+  }
+
+  // python-socketio 的 emit 发出二进制数据时先发占位的文本帧
+  if (opcode == 0x2 && s->config.binary == 2 &&
+      !send_text(s, fd,
+                 "451-[\"tegrastats_update\",{\"_placeholder\":true,"
+                 "\"num\":0}]")) {
+    return false;
+  }
+
+  if (cut) {
+    uint8_t header[14];
+    size_t n = agx_ws_header(header, opcode, true, len, NULL);
+    send_all(s, fd, header, n);
+    send_all(s, fd, frame, len / 2);
+    STAT_ADD(s, frames_cut, 1);
+    return false;
+  }
+
+  bool ok = true;
+  if (len >= 4 && chance(s, s->config.fragment_percent)) {
+    int frames = 2 + (int)(next_rng(s) % 3);
+    size_t pos = 0;
+    for (int i = 0; i < frames && ok && pos < len; i++) {
+      size_t n = i == frames - 1 ? len - pos : 1 + next_rng(s) % (len - pos);
+      bool fin = pos + n == len;
+      ok = send_frame(s, fd, i == 0 ? opcode : 0x0, fin, frame + pos, n,
+                      chance(s, 50));
+      pos += n;
+      // 分片之间允许夹带控制帧
+      if (ok && !fin && chance(s, 30)) {
+        ok = send_frame(s, fd, 0x9, true, SID, strlen(SID), false);
+      }
+    }
+    STAT_ADD(s, fragmented, 1);
+  } else {
+    ok = send_frame(s, fd, opcode, true, frame, len,
+                    chance(s, s->config.fragment_percent));
+  }
+
+  if (ok) {
+    pthread_mutex_lock(&s->stats_mutex);
+    s->stats.frames_sent++;
+    if (opcode == 0x2) {
+      s->stats.binary_sent++;
+    }
+    if (malformed) {
+      s->stats.malformed_sent++;
+    } else {
+      s->stats.valid_sent++;
+    }
+    pthread_mutex_unlock(&s->stats_mutex);
+  }
+  return ok;
+}
+
+/* ============================================================================
+ * 连接
+ * ============================================================================
+ */
+
+static void on_client_chunk(void *ctx, const char *data, size_t len,
+                            uint8_t opcode, bool fin, size_t payload_len,
+                            size_t payload_offset) {
+  conn_t *c = ctx;
+  if (opcode == 0x8) {
+    c->closed = true;
+    return;
+  }
+  if (opcode != 0x1 && opcode != 0x0) {
+    return; // 客户端的 pong 控制帧
+  }
+  if (opcode == 0x1 && payload_offset == 0) {
+    c->message_len = 0;
+  }
+  if (c->message_len + len <= sizeof(c->message)) {
+    memcpy(c->message + c->message_len, data, len);
+    c->message_len += len;
+  }
+  if (!fin || payload_offset + len < payload_len) {
+    return;
+  }
+
+  agx_binary_ack_t request;
+  if (c->message_len >= 2 && c->message[0] == '4' && c->message[1] == '0') {
+    c->namespace_req = true;
+  } else if (agx_monitor_binary_parse_ack(c->message, c->message_len,
+                                          &request) == ESP_OK) {
+    // 请求与应答的格式相同
+    c->format_req = request.binary && request.version == AGX_BINARY_VERSION;
+    c->fields = request.fields & AGX_BINARY_FIELDS_ALL;
+  } else if (c->message_len >= 1 && c->message[0] == '3') {
+    c->pongs++;
+  }
+  c->message_len = 0;
+}
+
+/* 读客户端发来的数据，连接已关闭时返回 false */
+static bool read_client(conn_t *c) {
+  uint8_t buf[1024];
+  ssize_t n = recv(c->fd, buf, sizeof(buf), 0);
+  if (n < 0 && (errno == EINTR || errno == EAGAIN)) {
+    return true;
+  }
+  if (n <= 0 ||
+      !agx_ws_decode(&c->decoder, buf, (size_t)n, on_client_chunk, c)) {
+    return false;
+  }
+  return !c->closed;
+}
+
+static bool handshake(agx_replay_server_t *s, int fd) {
+  char request[2048] = "";
+  size_t len = 0;
+  uint64_t deadline = now_ms() + HANDSHAKE_TIMEOUT_MS;
+
+  while (strstr(request, "\r\n\r\n") == NULL) {
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+    uint64_t now = now_ms();
+    if (now >= deadline || len + 1 >= sizeof(request) ||
+        poll(&pfd, 1, (int)(deadline - now)) <= 0) {
+      return false;
+    }
+    ssize_t n = recv(fd, request + len, sizeof(request) - 1 - len, 0);
+    if (n <= 0) {
+      return false;
+    }
+    len += (size_t)n;
+    request[len] = '\0';
+  }
+
+  char key[64] = "";
+  for (char *line = strstr(request, "\r\n"); line != NULL;
+       line = strstr(line + 2, "\r\n")) {
+    if (strncasecmp(line + 2, "Sec-WebSocket-Key:", 18) == 0) {
+      sscanf(line + 20, " %63s", key);
+      break;
+    }
+  }
+  if (key[0] == '\0' || strncmp(request, "GET /socket.io/", 15) != 0) {
+    const char *bad = "HTTP/1.1 400 Bad Request\r\nContent-Length: 0\r\n\r\n";
+    send_all(s, fd, bad, strlen(bad));
+    return false;
+  }
+
+  char accept[32];
+  char response[256];
+  agx_ws_accept_key(key, accept);
+  int n = snprintf(response, sizeof(response),
+                   "HTTP/1.1 101 Switching Protocols\r\n"
+                   "Upgrade: websocket\r\n"
+                   "Connection: Upgrade\r\n"
+                   "Sec-WebSocket-Accept: %s\r\n\r\n",
+                   accept);
+  return send_all(s, fd, response, (size_t)n);
+}
+
+/* 正常关闭：停止写入，读完客户端剩下的数据后再 close，避免 RST 丢数据 */
+static void close_gracefully(int fd) {
+  shutdown(fd, SHUT_WR);
+  uint64_t deadline = now_ms() + CLOSE_DRAIN_MS;
+  for (;;) {
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+    uint64_t now = now_ms();
+    char buf[256];
+    if (now >= deadline || poll(&pfd, 1, (int)(deadline - now)) <= 0 ||
+        recv(fd, buf, sizeof(buf), 0) <= 0) {
+      break;
+    }
+  }
+}
+
+static void serve(agx_replay_server_t *s, int fd) {
+  const agx_replay_config_t *cfg = &s->config;
+  conn_t c = {.fd = fd};
+  agx_ws_decoder_reset(&c.decoder);
+
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  if (!handshake(s, fd)) {
+    return;
+  }
+  STAT_ADD(s, connections, 1);
+
+  char open[192];
+  snprintf(open, sizeof(open),
+           "0{\"sid\":\"" SID "\",\"upgrades\":[],\"pingInterval\":%u,"
+           "\"pingTimeout\":%u,\"maxPayload\":1000000}",
+           cfg->ping_interval_ms, cfg->ping_timeout_ms);
+  if (!send_text(s, fd, open)) {
+    return;
+  }
+
+  uint64_t period_us = cfg->rate > 0 ? 1000000 / cfg->rate : 0;
+  bool streaming = false;
+  uint64_t stream_start = 0;
+  uint64_t next_frame_us = 0;
+  uint64_t next_ping = now_ms() + cfg->ping_interval_ms;
+  uint64_t ping_deadline = UINT64_MAX;
+  uint32_t pongs_seen = 0;
+  uint16_t fields = 0;
+
+  for (;;) {
+    uint64_t now = now_ms();
+    int timeout = STOP_POLL_MS;
+    if (streaming) {
+      uint64_t due = next_frame_us / 1000;
+      timeout = due <= now                 ? 0
+                : due - now < STOP_POLL_MS ? (int)(due - now)
+                                           : STOP_POLL_MS;
+    }
+
+    struct pollfd pfd = {.fd = fd, .events = POLLIN};
+    int ready = poll(&pfd, 1, timeout);
+    if (ready > 0 && !read_client(&c)) {
+      return;
+    }
+    if (is_stopping(s)) {
+      close_gracefully(fd);
+      return;
+    }
+
+    now = now_ms();
+    if (c.namespace_req) {
+      c.namespace_req = false;
+      if (!send_text(s, fd, "40{\"sid\":\"" SID "\"}")) {
+        return;
+      }
+      streaming = true;
+      stream_start = now;
+      next_frame_us = now * 1000;
+    }
+
+    // 不支持二进制记录时不应答，客户端继续接收 JSON
+    if (c.format_req) {
+      c.format_req = false;
+      if (cfg->binary != 0 && c.fields != 0) {
+        char ack[96];
+        snprintf(ack, sizeof(ack),
+                 "42[\"" AGX_BINARY_EVENT "\",{\"format\":\"binary\","
+                 "\"version\":%d,\"fields\":%u}]",
+                 AGX_BINARY_VERSION, c.fields);
+        if (!send_text(s, fd, ack)) {
+          return;
+        }
+        fields = c.fields;
+      }
+    }
+
+    if (c.pongs != pongs_seen) {
+      STAT_ADD(s, pongs, c.pongs - pongs_seen);
+      pongs_seen = c.pongs;
+      ping_deadline = UINT64_MAX;
+    }
+    if (now >= ping_deadline) {
+      STAT_ADD(s, ping_timeouts, 1);
+      return;
+    }
+    if (now >= next_ping) {
+      if (!send_text(s, fd, "2")) {
+        return;
+      }
+      STAT_ADD(s, pings, 1);
+      next_ping = now + cfg->ping_interval_ms;
+      if (ping_deadline == UINT64_MAX) {
+        ping_deadline = now + cfg->ping_timeout_ms;
+      }
+    }
+
+    if (!streaming) {
+      continue;
+    }
+    if (cfg->disconnect_ms > 0 && now - stream_start >= cfg->disconnect_ms) {
+      // 一半的断开发生在帧的中间
+      if (chance(s, 50)) {
+        send_update(s, fd, fields, true);
+      }
+      STAT_ADD(s, disconnects, 1);
+      return;
+    }
+
+    uint64_t now_us = now * 1000;
+    if (period_us == 0) {
+      if (!send_update(s, fd, fields, false)) {
+        return;
+      }
+    } else if (now_us >= next_frame_us) {
+      if (!send_update(s, fd, fields, false)) {
+        return;
+      }
+      next_frame_us += period_us;
+      // 落后超过一秒时不再补发
+      if (now_us > next_frame_us + 1000000) {
+        next_frame_us = now_us;
+      }
+    }
+  }
+}
+
+static void *server_main(void *arg) {
+  agx_replay_server_t *s = arg;
+
+  while (!is_stopping(s)) {
+    struct pollfd pfd = {.fd = s->listen_fd, .events = POLLIN};
+    if (poll(&pfd, 1, STOP_POLL_MS) <= 0) {
+      continue;
+    }
+    int fd = accept(s->listen_fd, NULL, NULL);
+    if (fd < 0) {
+      continue;
+    }
+    serve(s, fd);
+    close(fd);
+  }
+  return NULL;
+}
+
+/* ============================================================================
+ * 公共接口
+ * ============================================================================
+ */
+
+agx_replay_server_t *agx_replay_start(const agx_replay_config_t *config) {
+  agx_replay_server_t *s = calloc(1, sizeof(*s));
+  if (s == NULL) {
+    return NULL;
+  }
+  s->config = *config;
+  if (s->config.ping_interval_ms == 0) {
+    s->config.ping_interval_ms = 25000;
+  }
+  if (s->config.ping_timeout_ms == 0) {
+    s->config.ping_timeout_ms = 20000;
+  }
+  s->rng = config->seed != 0 ? config->seed : 0x1234567u;
+  s->listen_fd = -1;
+  pthread_mutex_init(&s->stats_mutex, NULL);
+
+  if (config->recording != NULL && !load_recording(s, config->recording)) {
+    goto fail;
+  }
+
+  s->listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (s->listen_fd < 0) {
+    goto fail;
+  }
+  int one = 1;
+  setsockopt(s->listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  struct sockaddr_in addr = {
+      .sin_family = AF_INET,
+      .sin_port = htons(config->port),
+      .sin_addr.s_addr = htonl(INADDR_ANY),
+  };
+  socklen_t addr_len = sizeof(addr);
+  if (bind(s->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      listen(s->listen_fd, 4) != 0 ||
+      getsockname(s->listen_fd, (struct sockaddr *)&addr, &addr_len) != 0) {
+    goto fail;
+  }
+  s->port = ntohs(addr.sin_port);
+
+  if (pthread_create(&s->thread, NULL, server_main, s) != 0) {
+    goto fail;
+  }
+  return s;
+
+fail:
+  if (s->listen_fd >= 0) {
+    close(s->listen_fd);
+  }
+  free_recording(s);
+  pthread_mutex_destroy(&s->stats_mutex);
+  free(s);
+  return NULL;
+}
+
+uint16_t agx_replay_port(const agx_replay_server_t *server) {
+  return server->port;
+}
+
+void agx_replay_get_stats(agx_replay_server_t *server,
+                          agx_replay_stats_t *stats) {
+  pthread_mutex_lock(&server->stats_mutex);
+  *stats = server->stats;
+  pthread_mutex_unlock(&server->stats_mutex);
+}
+
+void agx_replay_stop(agx_replay_server_t *server, agx_replay_stats_t *stats) {
+  __atomic_store_n(&server->stopping, true, __ATOMIC_RELEASE);
+  pthread_join(server->thread, NULL);
+  close(server->listen_fd);
+  if (stats != NULL) {
+    agx_replay_get_stats(server, stats);
+  }
+  free_recording(server);
+  pthread_mutex_destroy(&server->stats_mutex);
+  free(server);
+}
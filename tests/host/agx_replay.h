@@ -0,0 +1,173 @@
+/**
+ * @file agx_replay.h
+ * @brief 主机端 AGX Socket.IO 替身服务器
+ *
+ * 在 Linux 上代替 AGX 的 tegrastats 推送服务（默认 10.10.99.98:58090）：
+ *
+ * - 实现 agx_monitor 用到的那部分协议：WebSocket 握手和分帧、Engine.IO
+ *   open/ping、Socket.IO 命名空间连接，然后以给定速率推送
+ *   42["tegrastats_update",{...}]
+ * - 数据来自录制的会话文件（每行一个 tegrastats 对象或完整的 42 帧，
+ *   循环回放），或由序号合成：合成帧的 timestamp 编码了序号，接收方可以
+ *   用 agx_replay_synth 重新生成期望值逐字段核对
+ * - 可注入格式错误的帧、拆成多个 WebSocket 帧并夹带 ping 控制帧、按小段
+ *   写入 TCP，以及定时中途断开连接
+ * - 可选支持 telemetry_format 协商（agx_monitor_binary.h），之后以二进制
+ *   记录推送；不支持时不应答客户端的请求，与旧的 AGX 服务相同
+ *
+ * 同一时间只服务一个客户端（与 AGX 上只连一个 robOS 相同）。服务器在自己
+ * 的线程中运行，可以嵌入测试程序（bench_agx_load），也可以单独运行
+ * （agx_replay_server）。
+ *
+ * WebSocket 分帧函数也供 bench_agx_load 的客户端使用。
+ */
+
+#ifndef AGX_REPLAY_H
+#define AGX_REPLAY_H
+
+#include "agx_monitor.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define AGX_REPLAY_MAX_FRAME 4096 ///< 回放帧的最大长度
+#define AGX_REPLAY_CORES 12       ///< 合成帧的 CPU 核数（AGX Orin）
+
+/**
+ * @brief 服务器参数
+ */
+typedef struct {
+  uint16_t port;             ///< 监听端口，0 = 由系统分配
+  uint32_t rate;             ///< 每秒推送的帧数，0 = 尽快推送
+  uint8_t malformed_percent; ///< 格式错误的帧的比例
+  uint8_t fragment_percent;  ///< 拆成多个 WebSocket 帧的比例
+  uint32_t disconnect_ms;    ///< 开始推送后多久中途断开，0 = 不断开
+  uint32_t ping_interval_ms; ///< Engine.IO pingInterval
+  uint32_t ping_timeout_ms;  ///< 收不到 pong 多久后断开
+  const char *recording;     ///< 录制的会话文件，NULL = 合成数据
+  uint32_t seed;             ///< 注入用的随机种子
+  uint8_t binary;            ///< 二进制记录：0 = 不支持，1 = 二进制消息，
+                             ///< 2 = Socket.IO 二进制事件（占位 + 附件）
+} agx_replay_config_t;
+
+/**
+ * @brief 服务器计数
+ */
+typedef struct {
+  uint32_t connections;    ///< 完成 WebSocket 握手的连接
+  uint32_t frames_sent;    ///< 发出的 tegrastats_update 帧
+  uint32_t valid_sent;     ///< 其中格式正确的
+  uint32_t malformed_sent; ///< 其中格式错误的
+  uint32_t fragmented;     ///< 拆成多个 WebSocket 帧的
+  uint32_t binary_sent;    ///< 以二进制记录发出的
+  uint32_t disconnects;    ///< 主动中途断开的连接
+  uint32_t frames_cut;     ///< 断开时只发出一半的帧
+  uint32_t pings;          ///< 发出的 Engine.IO ping
+  uint32_t pongs;          ///< 收到的 pong
+  uint32_t ping_timeouts;  ///< 因收不到 pong 断开的连接
+  uint64_t bytes_sent;     ///< 发出的字节数
+} agx_replay_stats_t;
+
+typedef struct agx_replay_server agx_replay_server_t;
+
+/**
+ * @brief 启动服务器线程
+ *
+ * @return 服务器，端口被占用或录制文件无法读取时为 NULL
+ */
+agx_replay_server_t *agx_replay_start(const agx_replay_config_t *config);
+
+/**
+ * @brief 实际监听的端口
+ */
+uint16_t agx_replay_port(const agx_replay_server_t *server);
+
+/**
+ * @brief 读取计数（可在运行中调用）
+ */
+void agx_replay_get_stats(agx_replay_server_t *server,
+                          agx_replay_stats_t *stats);
+
+/**
+ * @brief 停止推送，正常关闭当前连接（已发出的帧都能收到）并结束线程
+ *
+ * @param stats 可选，最终计数
+ */
+void agx_replay_stop(agx_replay_server_t *server, agx_replay_stats_t *stats);
+
+/**
+ * @brief 生成序号为 seq 的合成帧
+ *
+ * @param expected 可选，agx_monitor_parse_frame 应得到的结果
+ * @return 帧长度
+ */
+size_t agx_replay_synth(uint32_t seq, char *frame, size_t size,
+                        agx_monitor_data_t *expected);
+
+/**
+ * @brief 从合成帧的 timestamp 取回序号
+ *
+ * @return timestamp 不是合成帧的格式时为 false
+ */
+bool agx_replay_seq(const char *timestamp, uint32_t *seq);
+
+/* ============================================================================
+ * WebSocket 分帧
+ * ============================================================================
+ */
+
+/**
+ * @brief Sec-WebSocket-Accept：base64(SHA-1(key + GUID))
+ *
+ * @param accept 输出，至少 29 字节
+ */
+void agx_ws_accept_key(const char *key, char *accept);
+
+/**
+ * @brief 写帧头
+ *
+ * @param header 输出，至少 14 字节
+ * @param mask 客户端发出的帧必须带掩码，NULL = 不加掩码
+ * @return 帧头长度
+ */
+size_t agx_ws_header(uint8_t *header, uint8_t opcode, bool fin, size_t len,
+                     const uint8_t *mask);
+
+/**
+ * @brief 流式帧解码器
+ *
+ * 与 esp_websocket_client 一样，把一次读到的数据中属于同一帧负载的部分作为
+ * 一个数据事件交出（payload_offset 递增），带掩码的负载就地去掩码。
+ */
+typedef struct {
+  uint8_t header[14]; ///< 正在接收的帧头
+  size_t header_len;  ///< 已收到的帧头字节
+  size_t header_need; ///< 帧头总长度（收到前两字节后确定）
+  uint8_t opcode;     ///< 当前帧的操作码
+  bool fin;           ///< 当前帧是消息的最后一帧
+  bool masked;        ///< 当前帧带掩码
+  uint8_t mask[4];    ///< 掩码
+  size_t payload_len; ///< 当前帧的负载长度
+  size_t offset;      ///< 已交出的负载字节
+  bool in_payload;    ///< 正在接收负载
+} agx_ws_decoder_t;
+
+/**
+ * @brief 数据事件回调，参数与 agx_ws_chunk_t 的字段相同
+ */
+typedef void (*agx_ws_chunk_cb_t)(void *ctx, const char *data, size_t len,
+                                  uint8_t opcode, bool fin, size_t payload_len,
+                                  size_t payload_offset);
+
+void agx_ws_decoder_reset(agx_ws_decoder_t *d);
+
+/**
+ * @brief 解码一次读到的数据
+ *
+ * @return 帧头非法（负载超过 2^32 字节）时为 false
+ */
+bool agx_ws_decode(agx_ws_decoder_t *d, uint8_t *data, size_t len,
+                   agx_ws_chunk_cb_t cb, void *ctx);
+
+#endif /* AGX_REPLAY_H */
@@ -0,0 +1,105 @@
+/**
+ * @file agx_replay_server.c
+ * @brief 在 Linux 上代替 AGX 推送 tegrastats_update 的 Socket.IO 服务器
+ *
+ *   agx_replay_server [-p 端口] [-r 帧/秒] [-f 录制文件] [-m 错误%]
+ *                     [-s 分片%] [-d 断开间隔ms] [-i ping间隔ms]
+ *                     [-b 1|2]
+ *
+ * 默认在 58090 端口以 1 帧/秒推送合成数据。把设备的 AGX 服务器地址指向运行
+ * 本程序的主机（agx_monitor config），或用 bench_agx_load -c 连接。录制文件
+ * 每行一个 tegrastats 对象或完整的 42 帧，可用 bench_agx_load -o 从真实的
+ * AGX 录制。-b 接受客户端的 telemetry_format 请求，之后以二进制记录推送
+ * （1 = 二进制消息，2 = Socket.IO 二进制事件）。每 5 秒打印一次计数，
+ * Ctrl+C 退出。
+ */
+
+#include "agx_replay.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static volatile sig_atomic_t s_stop;
+
+static void on_signal(int sig) {
+  (void)sig;
+  s_stop = 1;
+}
+
+static void print_stats(const agx_replay_stats_t *s) {
+  printf("%u 连接, %u 帧 (错误 %u, 分片 %u, 二进制 %u), %u 次断开, "
+         "ping %u/pong %u, %llu 字节\n",
+         s->connections, s->frames_sent, s->malformed_sent, s->fragmented,
+         s->binary_sent, s->disconnects, s->pings, s->pongs,
+         (unsigned long long)s->bytes_sent);
+}
+
+int main(int argc, char **argv) {
+  agx_replay_config_t config = {
+      .port = AGX_MONITOR_DEFAULT_SERVER_PORT,
+      .rate = 1,
+  };
+  int opt;
+
+  while ((opt = getopt(argc, argv, "p:r:f:m:s:d:i:b:")) != -1) {
+    switch (opt) {
+    case 'p':
+      config.port = (uint16_t)atoi(optarg);
+      break;
+    case 'r':
+      config.rate = (uint32_t)atoi(optarg);
+      break;
+    case 'f':
+      config.recording = optarg;
+      break;
+    case 'm':
+      config.malformed_percent = (uint8_t)atoi(optarg);
+      break;
+    case 's':
+      config.fragment_percent = (uint8_t)atoi(optarg);
+      break;
+    case 'd':
+      config.disconnect_ms = (uint32_t)atoi(optarg);
+      break;
+    case 'i':
+      config.ping_interval_ms = (uint32_t)atoi(optarg);
+      break;
+    case 'b':
+      config.binary = (uint8_t)atoi(optarg);
+      break;
+    default:
+      printf("usage: %s [-p port] [-r rate] [-f recording] [-m malformed%%] "
+             "[-s fragment%%] [-d disconnect_ms] [-i ping_ms] [-b 1|2]\n",
+             argv[0]);
+      return 1;
+    }
+  }
+
+  agx_replay_server_t *server = agx_replay_start(&config);
+  if (server == NULL) {
+    printf("cannot start server on port %u%s%s\n", config.port,
+           config.recording ? " with " : "",
+           config.recording ? config.recording : "");
+    return 1;
+  }
+  printf("listening on port %u, %u frames/s, %s\n", agx_replay_port(server),
+         config.rate, config.recording ? config.recording : "synthetic data");
+
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+  for (int tick = 1; !s_stop; tick++) {
+    sleep(1);
+    if (tick % 5 == 0) {
+      agx_replay_stats_t stats;
+      agx_replay_get_stats(server, &stats);
+      print_stats(&stats);
+    }
+  }
+
+  agx_replay_stats_t stats;
+  agx_replay_stop(server, &stats);
+  print_stats(&stats);
+  return 0;
+}
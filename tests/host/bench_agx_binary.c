@@ -0,0 +1,411 @@
+/**
+ * @file bench_agx_binary.c
+ * @brief 二进制 tegrastats 记录的正确性、健壮性与耗时
+ *
+ * 1. 文档中的示例帧经 JSON 解析后编码成记录再解码，除温度按 0.01 °C 取整
+ *    外与 JSON 的结果一致，记录长度与文档相同。
+ * 2. 随机数据（时间覆盖 1970-9999 年、0-16 个核、任意字段组合）编码后
+ *    解码，与原数据和 parsed 位逐字节比较。
+ * 3. 错误记录：每个截断、多余字节、错误的魔数和版本、核数过多、超出范围的
+ *    时间；缺失的温度传感器；带未知字段的新记录跳过其尾部。
+ * 4. telemetry_format 应答的解析。
+ * 5. 随机字节变异不得崩溃（可用 -DCMAKE_C_FLAGS=-fsanitize=address 构建
+ *    检查越界）。
+ * 6. 报告每条记录与 JSON 帧的字节数和解码耗时。
+ */
+
+#define _GNU_SOURCE
+
+#include "agx_monitor_binary.h"
+#include "agx_monitor_parser.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RANDOM_RECORDS 100000
+#define MUTATION_ROUNDS 500000
+#define TIMING_ROUNDS 1000000
+
+static const char GOLDEN[] =
+    "42[\"tegrastats_update\",{\"timestamp\":\"2025-10-03T06:33:49.223455Z\","
+    "\"cpu\":{\"cores\":["
+    "{\"id\":0,\"usage\":3,\"freq\":1574},{\"id\":1,\"usage\":7,\"freq\":1574},"
+    "{\"id\":2,\"usage\":0,\"freq\":1574},{\"id\":3,\"usage\":12,\"freq\":1574},"
+    "{\"id\":4,\"usage\":1,\"freq\":729},{\"id\":5,\"usage\":0,\"freq\":729},"
+    "{\"id\":6,\"usage\":2,\"freq\":729},{\"id\":7,\"usage\":0,\"freq\":729},"
+    "{\"id\":8,\"usage\":4,\"freq\":2201},{\"id\":9,\"usage\":0,\"freq\":2201},"
+    "{\"id\":10,\"usage\":0,\"freq\":2201},{\"id\":11,\"usage\":99,\"freq\":2201}"
+    "]},"
+    "\"memory\":{\"ram\":{\"used\":1997,\"total\":62841,\"unit\":\"MB\"},"
+    "\"swap\":{\"used\":0,\"total\":31421,\"cached\":0,\"unit\":\"MB\"}},"
+    "\"temperature\":{\"cpu\":47.125,\"soc0\":45.0,\"soc1\":46.062,"
+    "\"soc2\":45.562,\"tj\":47.125},"
+    "\"power\":{\"gpu_soc\":{\"current\":2468,\"average\":2468,\"unit\":\"mW\"},"
+    "\"cpu_cv\":{\"current\":246,\"average\":246,\"unit\":\"mW\"},"
+    "\"sys_5v\":{\"current\":3383,\"average\":3383,\"unit\":\"mW\"},"
+    "\"ram\":{\"current\":512,\"average\":62841,\"unit\":\"mW\"},"
+    "\"swap\":{\"current\":12,\"average\":11,\"unit\":\"mW\"}},"
+    "\"gpu\":{\"gr3d_freq\":0}}]";
+
+static uint32_t s_rng = 0x2468ace0;
+
+static uint32_t rng(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void set_unit(char *unit, const char *text) {
+  memset(unit, 0, 4);
+  strncpy(unit, text, 3);
+}
+
+static int check_golden(size_t *record_len) {
+  agx_monitor_data_t json, data;
+  uint32_t json_parsed, parsed;
+  uint8_t record[AGX_BINARY_MAX_SIZE];
+  int failed = 0;
+
+  agx_monitor_parse_frame(GOLDEN, sizeof(GOLDEN) - 1, &json, &json_parsed);
+  size_t len = agx_monitor_binary_encode(&json, AGX_BINARY_FIELDS_ALL, record,
+                                         sizeof(record));
+  esp_err_t ret = agx_monitor_binary_decode(record, len, &data, &parsed);
+  *record_len = len;
+
+  if (len != 120 || ret != ESP_OK || parsed != json_parsed) {
+    printf("golden: len %zu, ret 0x%x, parsed 0x%x/0x%x\n", len, ret,
+           (unsigned)parsed, (unsigned)json_parsed);
+    failed = 1;
+  }
+  // 温度只保留 0.01 °C
+  float *a = &json.temperature.cpu;
+  float *b = &data.temperature.cpu;
+  for (int i = 0; i < 5; i++) {
+    if (fabsf(a[i] - b[i]) > 0.0051f) {
+      printf("golden: temperature %d %.3f -> %.3f\n", i, a[i], b[i]);
+      failed = 1;
+    }
+    b[i] = a[i];
+  }
+  if (memcmp(&json, &data, sizeof(data)) != 0) {
+    printf("golden: decoded record differs from the JSON frame\n");
+    failed = 1;
+  }
+  return failed;
+}
+
+/* 随机数据，温度取 0.01 °C 的整数倍（与 JSON 解析器相同的转换） */
+static uint16_t random_data(agx_monitor_data_t *d, uint32_t *parsed) {
+  memset(d, 0, sizeof(*d));
+  uint16_t fields = (uint16_t)(rng() & AGX_BINARY_FIELDS_ALL);
+  *parsed = 0;
+
+  if (fields & AGX_BINARY_FIELD_TIMESTAMP) {
+    time_t secs = (time_t)(((uint64_t)rng() << 32 | rng()) % 253402300800ull);
+    struct tm tm;
+    gmtime_r(&secs, &tm);
+    char date[24];
+    strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", &tm);
+    snprintf(d->timestamp, sizeof(d->timestamp), "%s.%06uZ", date,
+             rng() % 1000000);
+    *parsed |= AGX_MONITOR_PARSED_TIMESTAMP;
+  }
+  if (fields & AGX_BINARY_FIELD_CPU) {
+    d->cpu.core_count = (uint8_t)(rng() % (AGX_MONITOR_MAX_CPU_CORES + 1));
+    for (int i = 0; i < d->cpu.core_count; i++) {
+      d->cpu.cores[i].id = (uint8_t)i;
+      d->cpu.cores[i].usage = (uint8_t)rng();
+      d->cpu.cores[i].freq = (uint16_t)rng();
+    }
+    *parsed |= AGX_MONITOR_PARSED_CPU;
+  }
+  if (fields & AGX_BINARY_FIELD_MEMORY) {
+    d->memory.ram.used = rng();
+    d->memory.ram.total = rng();
+    set_unit(d->memory.ram.unit, "MB");
+    d->memory.swap.used = rng();
+    d->memory.swap.total = rng();
+    d->memory.swap.cached = rng();
+    set_unit(d->memory.swap.unit, "MB");
+    *parsed |= AGX_MONITOR_PARSED_MEMORY;
+  }
+  if (fields & AGX_BINARY_FIELD_TEMPERATURE) {
+    float *t = &d->temperature.cpu;
+    for (int i = 0; i < 5; i++) {
+      t[i] = (float)(((int32_t)(rng() % 65535) - 32767) / 100.0);
+    }
+    *parsed |= AGX_MONITOR_PARSED_TEMPERATURE | AGX_MONITOR_PARSED_CPU_TEMP;
+  }
+  if (fields & AGX_BINARY_FIELD_POWER) {
+    agx_power_info_t *rails[] = {&d->power.gpu_soc, &d->power.cpu_cv,
+                                 &d->power.sys_5v, &d->power.ram,
+                                 &d->power.swap};
+    for (int i = 0; i < 5; i++) {
+      rails[i]->current = rng();
+      rails[i]->average = rng();
+      set_unit(rails[i]->unit, "mW");
+    }
+    *parsed |= AGX_MONITOR_PARSED_POWER;
+  }
+  if (fields & AGX_BINARY_FIELD_GPU) {
+    d->gpu.gr3d_freq = (uint8_t)rng();
+    *parsed |= AGX_MONITOR_PARSED_GPU;
+  }
+  return fields;
+}
+
+static int check_random(void) {
+  agx_monitor_data_t expected, data;
+  uint8_t record[AGX_BINARY_MAX_SIZE];
+  for (int i = 0; i < RANDOM_RECORDS; i++) {
+    uint32_t expected_parsed, parsed;
+    uint16_t fields = random_data(&expected, &expected_parsed);
+    size_t len =
+        agx_monitor_binary_encode(&expected, fields, record, sizeof(record));
+    memset(&data, 0xA5, sizeof(data));
+    esp_err_t ret = agx_monitor_binary_decode(record, len, &data, &parsed);
+
+    if (ret != ESP_OK || parsed != expected_parsed ||
+        memcmp(&data, &expected, sizeof(data)) != 0) {
+      printf("random record %d mismatch (fields 0x%02x, ret 0x%x, parsed "
+             "0x%x/0x%x, timestamp %s/%s)\n",
+             i, fields, ret, (unsigned)parsed, (unsigned)expected_parsed,
+             data.timestamp, expected.timestamp);
+      return 1;
+    }
+    if (agx_monitor_binary_encode(&expected, fields, record, len - 1) != 0) {
+      printf("random record %d: encoded into a short buffer\n", i);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int check_errors(void) {
+  agx_monitor_data_t golden, expected, data;
+  uint8_t record[AGX_BINARY_MAX_SIZE + 8];
+  uint32_t parsed;
+  int failed = 0;
+
+  agx_monitor_parse_frame(GOLDEN, sizeof(GOLDEN) - 1, &golden, NULL);
+  size_t len = agx_monitor_binary_encode(&golden, AGX_BINARY_FIELDS_ALL,
+                                         record, sizeof(record));
+  agx_monitor_binary_decode(record, len, &expected, NULL);
+
+  // 每个前缀都必须被拒绝（放在刚好等长的堆缓冲区中）
+  for (size_t n = 0; n < len; n++) {
+    uint8_t *copy = malloc(n ? n : 1);
+    memcpy(copy, record, n);
+    esp_err_t ret = agx_monitor_binary_decode(copy, n, &data, NULL);
+    free(copy);
+    if (ret != ESP_ERR_INVALID_SIZE) {
+      printf("truncated record (%zu of %zu bytes): 0x%x\n", n, len, ret);
+      failed = 1;
+    }
+  }
+
+  static const struct {
+    size_t offset;
+    uint8_t value;
+    esp_err_t expected;
+  } patches[] = {
+      {0, 0x42, ESP_ERR_NOT_SUPPORTED},     // 魔数，例如文本帧
+      {1, 2, ESP_ERR_NOT_SUPPORTED},        // 版本
+      {12, 17, ESP_ERR_INVALID_RESPONSE},   // 核数
+      {11, 0x80, ESP_ERR_INVALID_RESPONSE}, // 时间为负
+      {11, 0x7f, ESP_ERR_INVALID_RESPONSE}, // 时间超过 9999 年
+  };
+  for (size_t i = 0; i < sizeof(patches) / sizeof(patches[0]); i++) {
+    uint8_t copy[AGX_BINARY_MAX_SIZE];
+    memcpy(copy, record, len);
+    copy[patches[i].offset] = patches[i].value;
+    esp_err_t ret = agx_monitor_binary_decode(copy, len, &data, NULL);
+    if (ret != patches[i].expected) {
+      printf("patch %zu: got 0x%x, expected 0x%x\n", i, ret,
+             patches[i].expected);
+      failed = 1;
+    }
+  }
+
+  // 多余的字节
+  record[len] = 0;
+  if (agx_monitor_binary_decode(record, len + 1, &data, NULL) !=
+      ESP_ERR_INVALID_SIZE) {
+    printf("record with a trailing byte accepted\n");
+    failed = 1;
+  }
+
+  // 缺失的 CPU 温度传感器：解码为 0，没有 CPU_TEMP 位
+  uint8_t missing[AGX_BINARY_MAX_SIZE];
+  memcpy(missing, record, len);
+  size_t cpu_temp = AGX_BINARY_HEADER_SIZE + 8 + 1 + 12 * 3 + 20;
+  missing[cpu_temp] = 0x00;
+  missing[cpu_temp + 1] = 0x80;
+  if (agx_monitor_binary_decode(missing, len, &data, &parsed) != ESP_OK ||
+      parsed != (0x7F & ~AGX_MONITOR_PARSED_CPU_TEMP) ||
+      data.temperature.cpu != 0.0f ||
+      data.temperature.soc0 != expected.temperature.soc0) {
+    printf("missing CPU sensor: parsed 0x%x, cpu %.2f\n", (unsigned)parsed,
+           data.temperature.cpu);
+    failed = 1;
+  }
+
+  // 新版本服务器增加的字段：已知部分照常解码，其后的数据跳过
+  memcpy(record + len, "\x01\x02\x03\x04\x05", 5);
+  record[3] |= 0x40;
+  esp_err_t ret = agx_monitor_binary_decode(record, len + 5, &data, &parsed);
+  if (ret != ESP_OK || parsed != 0x7F ||
+      memcmp(&data, &expected, sizeof(data)) != 0) {
+    printf("record with an unknown field: 0x%x, parsed 0x%x\n", ret,
+           (unsigned)parsed);
+    failed = 1;
+  }
+
+  // 不是 ISO 8601 UTC 时间的 timestamp 不编码
+  static const char *const bad_times[] = {
+      "", "2025-10-03", "2025-10-03T06:33:49+08:00", "2025-13-03T06:33:49Z",
+      "1969-12-31T23:59:59Z", "2025-10-03T06:33:49.Z"};
+  for (size_t i = 0; i < sizeof(bad_times) / sizeof(bad_times[0]); i++) {
+    agx_monitor_data_t d = golden;
+    snprintf(d.timestamp, sizeof(d.timestamp), "%s", bad_times[i]);
+    uint8_t out[AGX_BINARY_MAX_SIZE];
+    size_t n = agx_monitor_binary_encode(&d, AGX_BINARY_FIELDS_ALL, out,
+                                         sizeof(out));
+    if (n != len - 8 || (out[2] & AGX_BINARY_FIELD_TIMESTAMP)) {
+      printf("timestamp \"%s\" encoded\n", bad_times[i]);
+      failed = 1;
+    }
+  }
+  return failed;
+}
+
+static int check_ack(void) {
+  static const struct {
+    const char *frame;
+    esp_err_t expected;
+    bool binary;
+    uint8_t version;
+    uint16_t fields;
+  } cases[] = {
+      {"42[\"telemetry_format\",{\"format\":\"binary\",\"version\":1,"
+       "\"fields\":63}]",
+       ESP_OK, true, 1, 63},
+      {"42[ \"telemetry_format\" , { \"fields\" : 7 , \"version\" : 1 , "
+       "\"format\" : \"binary\" } ]",
+       ESP_OK, true, 1, 7},
+      {"42[\"telemetry_format\",{\"format\":\"json\"}]", ESP_OK, false, 0, 0},
+      {"42[\"telemetry_format\",{\"format\":\"binary\",\"version\":2}]", ESP_OK,
+       true, 2, 0},
+      {"42[\"telemetry_format\",{\"format\":\"binary\",\"fields\":70000}]",
+       ESP_OK, true, 0, 0},
+      {"42[\"telemetry_format\",{}]", ESP_ERR_INVALID_RESPONSE, false, 0, 0},
+      {"42[\"telemetry_format\",{\"format\":1}]", ESP_ERR_INVALID_RESPONSE,
+       false, 0, 0},
+      {"42[\"telemetry_format\",{\"format\"", ESP_ERR_INVALID_RESPONSE, false,
+       0, 0},
+      {"42[\"tegrastats_update\",{\"format\":\"binary\"}]", ESP_ERR_NOT_FOUND,
+       false, 0, 0},
+      {"42[\"telemetry_formats\",{}]", ESP_ERR_NOT_FOUND, false, 0, 0},
+      {"40", ESP_ERR_NOT_FOUND, false, 0, 0},
+      {"451-[\"telemetry_format\",{\"_placeholder\":true,\"num\":0}]",
+       ESP_ERR_NOT_FOUND, false, 0, 0},
+  };
+  int failed = 0;
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    agx_binary_ack_t ack = {0};
+    esp_err_t ret = agx_monitor_binary_parse_ack(
+        cases[i].frame, strlen(cases[i].frame), &ack);
+    if (ret != cases[i].expected ||
+        (ret == ESP_OK &&
+         (ack.binary != cases[i].binary || ack.version != cases[i].version ||
+          ack.fields != cases[i].fields))) {
+      printf("ack case %zu: got 0x%x (%d, %u, %u): %s\n", i, ret, ack.binary,
+             ack.version, ack.fields, cases[i].frame);
+      failed = 1;
+    }
+  }
+  return failed;
+}
+
+static void fuzz_mutations(int *accepted, int *rejected) {
+  agx_monitor_data_t golden;
+  uint8_t record[AGX_BINARY_MAX_SIZE];
+  agx_monitor_parse_frame(GOLDEN, sizeof(GOLDEN) - 1, &golden, NULL);
+  size_t len = agx_monitor_binary_encode(&golden, AGX_BINARY_FIELDS_ALL,
+                                         record, sizeof(record));
+  *accepted = 0;
+  *rejected = 0;
+  for (int i = 0; i < MUTATION_ROUNDS; i++) {
+    size_t n = len + 8 - rng() % 16;
+    uint8_t *copy = malloc(n);
+    for (size_t j = 0; j < n; j++) {
+      copy[j] = j < len ? record[j] : (uint8_t)rng();
+    }
+    int flips = 1 + (int)(rng() % 4);
+    for (int f = 0; f < flips; f++) {
+      // 多半落在帧头（字段掩码、核数）上
+      size_t at = rng() % 2 ? rng() % 16 % n : rng() % n;
+      copy[at] = (uint8_t)rng();
+    }
+    agx_monitor_data_t data;
+    esp_err_t ret = agx_monitor_binary_decode(copy, n, &data, NULL);
+    free(copy);
+    if (ret == ESP_OK) {
+      (*accepted)++;
+    } else {
+      (*rejected)++;
+    }
+  }
+}
+
+int main(void) {
+  int failed = 0;
+  size_t record_len = 0;
+
+  failed |= check_golden(&record_len);
+  failed |= check_random();
+  failed |= check_errors();
+  failed |= check_ack();
+  printf("random records: %d round-tripped\n", RANDOM_RECORDS);
+
+  int accepted, rejected;
+  fuzz_mutations(&accepted, &rejected);
+  printf("mutations: %d accepted, %d rejected, no crash\n", accepted, rejected);
+
+  agx_monitor_data_t data;
+  uint8_t record[AGX_BINARY_MAX_SIZE];
+  agx_monitor_parse_frame(GOLDEN, sizeof(GOLDEN) - 1, &data, NULL);
+  agx_monitor_binary_encode(&data, AGX_BINARY_FIELDS_ALL, record,
+                            sizeof(record));
+  size_t json_len = sizeof(GOLDEN) - 1;
+
+  double start = now_ns();
+  for (int i = 0; i < TIMING_ROUNDS / 10; i++) {
+    agx_monitor_parse_frame(GOLDEN, json_len, &data, NULL);
+  }
+  double json_ns = (now_ns() - start) / (TIMING_ROUNDS / 10);
+  start = now_ns();
+  for (int i = 0; i < TIMING_ROUNDS; i++) {
+    agx_monitor_binary_decode(record, record_len, &data, NULL);
+    __asm__ volatile("" : : "r"(&data) : "memory");
+  }
+  double binary_ns = (now_ns() - start) / TIMING_ROUNDS;
+
+  printf("golden frame: JSON %zu bytes %.0f ns, record %zu bytes %.0f ns "
+         "(%.1fx smaller, %.1fx faster)\n",
+         json_len, json_ns, record_len, binary_ns,
+         (double)json_len / record_len, json_ns / binary_ns);
+
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
@@ -0,0 +1,399 @@
+/**
+ * @file bench_agx_history.c
+ * @brief AGX 指标历史存储的正确性、压缩率与耗时
+ *
+ * 1. 按设备默认容量喂入一天的模拟数据（随机游走，偶尔丢样），逐通道查询
+ *    三个层级，与直接由原始样本计算的期望值（原始值、每分钟和每十分钟的
+ *    最小/平均/最大值）比较，并检查每层保留的是最新的连续数据。
+ * 2. 报告各层记录数和压缩率（相对每个值 4 字节）。
+ * 3. 保存到文件再加载，所有查询结果与保存前一致；损坏、截断文件被拒绝。
+ * 4. 参数错误、时间回退、monitor 数据转换。
+ * 5. 每个样本的写入耗时和整层查询耗时。
+ */
+
+#include "agx_monitor_history.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DAY_SECONDS (24 * 3600)
+#define START_TIME 1000
+#define CORES 12
+#define FILE_PATH "bench_agx_history.bin"
+
+static const size_t k_tier_bytes[AGX_HISTORY_TIER_COUNT] = {32 * 1024,
+                                                            24 * 1024,
+                                                            16 * 1024};
+static const uint32_t k_period[AGX_HISTORY_TIER_COUNT] = {1, 60, 600};
+
+static int32_t (*s_samples)[AGX_HISTORY_CHANNELS];
+static uint32_t *s_times;
+static size_t s_count;
+static int s_failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("FAIL: " __VA_ARGS__);                                            \
+      printf("\n");                                                            \
+      s_failures++;                                                            \
+    }                                                                          \
+  } while (0)
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int32_t walk(int32_t v, int step, int32_t lo, int32_t hi) {
+  v += rand() % (2 * step + 1) - step;
+  return v < lo ? lo : v > hi ? hi : v;
+}
+
+/**
+ * 模拟数据：CPU 占用和 GPU 负载抖动大，温度缓慢漂移，功耗中等抖动，
+ * 内存偶尔变化，未使用的核心恒为 0
+ */
+static void generate(void) {
+  int32_t v[AGX_HISTORY_CHANNELS] = {0};
+
+  for (int ch = AGX_HISTORY_CH_TEMP_CPU; ch <= AGX_HISTORY_CH_TEMP_TJ; ch++) {
+    v[ch] = 4500 + ch * 10;
+  }
+  v[AGX_HISTORY_CH_POWER_GPU_SOC] = 8000;
+  v[AGX_HISTORY_CH_POWER_CPU_CV] = 3000;
+  v[AGX_HISTORY_CH_POWER_SYS_5V] = 5000;
+  v[AGX_HISTORY_CH_RAM_USED] = 12000;
+
+  s_count = 0;
+  for (uint32_t t = START_TIME; t < START_TIME + DAY_SECONDS; t++) {
+    if (rand() % 100 < 2) {
+      continue; // 丢样
+    }
+    for (int c = 0; c < CORES; c++) {
+      v[c] = rand() % 4 ? walk(v[c], 3, 0, 100) : v[c];
+    }
+    for (int ch = AGX_HISTORY_CH_TEMP_CPU; ch <= AGX_HISTORY_CH_TEMP_TJ;
+         ch++) {
+      v[ch] = rand() % 8 ? v[ch] : walk(v[ch], 25, 3000, 9000);
+    }
+    for (int ch = AGX_HISTORY_CH_POWER_GPU_SOC;
+         ch <= AGX_HISTORY_CH_POWER_SYS_5V; ch++) {
+      v[ch] = walk(v[ch], 40, 500, 40000);
+    }
+    v[AGX_HISTORY_CH_GPU_LOAD] = walk(v[AGX_HISTORY_CH_GPU_LOAD], 10, 0, 99);
+    v[AGX_HISTORY_CH_RAM_USED] = rand() % 30 ? v[AGX_HISTORY_CH_RAM_USED]
+                                             : walk(v[AGX_HISTORY_CH_RAM_USED],
+                                                    50, 2000, 60000);
+    memcpy(s_samples[s_count], v, sizeof(v));
+    s_times[s_count++] = t;
+  }
+}
+
+static int32_t div_round(int64_t sum, int64_t n) {
+  return (int32_t)(sum >= 0 ? (sum + n / 2) / n : -((-sum + n / 2) / n));
+}
+
+/**
+ * 由原始样本计算某层级最近 max 个已完成周期的期望值
+ */
+static size_t expected(agx_history_tier_t tier, int ch,
+                       agx_history_point_t *out, size_t max) {
+  size_t n = 0;
+
+  if (tier == AGX_HISTORY_TIER_RAW) {
+    size_t first = s_count > max ? s_count - max : 0;
+    for (size_t i = first; i < s_count; i++) {
+      out[n].time = s_times[i];
+      out[n].min = out[n].avg = out[n].max = s_samples[i][ch];
+      n++;
+    }
+    return n;
+  }
+
+  // 最后一个周期尚未结束，不会写入
+  uint32_t period = k_period[tier];
+  uint32_t pending = s_times[s_count - 1] / period;
+  agx_history_point_t *all = malloc(s_count * sizeof(*all));
+  size_t i = 0;
+  while (i < s_count && s_times[i] / period < pending) {
+    uint32_t bucket = s_times[i] / period;
+    int32_t lo = s_samples[i][ch], hi = lo;
+    int64_t sum = 0, count = 0;
+    for (; i < s_count && s_times[i] / period == bucket; i++) {
+      int32_t x = s_samples[i][ch];
+      lo = x < lo ? x : lo;
+      hi = x > hi ? x : hi;
+      sum += x;
+      count++;
+    }
+    all[n].time = bucket * period;
+    all[n].min = lo;
+    all[n].avg = div_round(sum, count);
+    all[n].max = hi;
+    n++;
+  }
+  size_t first = n > max ? n - max : 0;
+  memcpy(out, all + first, (n - first) * sizeof(*out));
+  free(all);
+  return n - first;
+}
+
+static void check_against_reference(const agx_monitor_history_t *history) {
+  size_t max = s_count;
+  agx_history_point_t *got = malloc(max * sizeof(*got));
+  agx_history_point_t *want = malloc(max * sizeof(*want));
+
+  for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+    agx_history_tier_stats_t stats;
+    agx_monitor_history_get_stats(history, t, &stats);
+    CHECK(stats.records > 0, "tier %d empty", t);
+
+    for (int ch = 0; ch < AGX_HISTORY_CHANNELS; ch++) {
+      size_t n = agx_monitor_history_query(history, t, ch, 0, got, max);
+      size_t m = expected(t, ch, want, n);
+      CHECK(n == stats.records, "tier %d ch %d: %zu points, %u records", t,
+            ch, n, stats.records);
+      CHECK(n == m && memcmp(got, want, n * sizeof(*got)) == 0,
+            "tier %d ch %d differs from reference", t, ch);
+    }
+
+    // since 过滤和 max_points 截断
+    if (stats.records > 10) {
+      size_t n = agx_monitor_history_query(history, t, AGX_HISTORY_CH_TEMP_TJ,
+                                           0, want, max);
+      uint32_t since = want[n - 10].time;
+      size_t k = agx_monitor_history_query(history, t, AGX_HISTORY_CH_TEMP_TJ,
+                                           since, got, max);
+      CHECK(k == 10 && memcmp(got, want + n - 10, 10 * sizeof(*got)) == 0,
+            "tier %d since filter", t);
+      k = agx_monitor_history_query(history, t, AGX_HISTORY_CH_TEMP_TJ, 0, got,
+                                    3);
+      CHECK(k == 3 && memcmp(got, want + n - 3, 3 * sizeof(*got)) == 0,
+            "tier %d max_points", t);
+    }
+  }
+  free(got);
+  free(want);
+}
+
+static void report(const agx_monitor_history_t *history) {
+  static const char *const names[] = {"raw", "1m", "10m"};
+  for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+    agx_history_tier_stats_t stats;
+    agx_monitor_history_get_stats(history, t, &stats);
+    size_t values = t == 0 ? AGX_HISTORY_CHANNELS : AGX_HISTORY_CHANNELS * 3;
+    double plain = (double)stats.records * (4 + values * 4);
+    printf("%-4s %5u records (%5.1f h), %5u/%5u bytes, %5.1f bytes/record, "
+           "%4.1fx vs int32\n",
+           names[t], stats.records,
+           (stats.newest_time - stats.oldest_time + k_period[t]) / 3600.0,
+           stats.bytes_used, stats.capacity,
+           (double)stats.bytes_used / stats.records, plain / stats.bytes_used);
+  }
+}
+
+static int same_contents(const agx_monitor_history_t *a,
+                         const agx_monitor_history_t *b) {
+  agx_history_point_t *pa = malloc(s_count * sizeof(*pa));
+  agx_history_point_t *pb = malloc(s_count * sizeof(*pb));
+  int same = 1;
+
+  for (int t = 0; t < AGX_HISTORY_TIER_COUNT && same; t++) {
+    for (int ch = 0; ch < AGX_HISTORY_CHANNELS && same; ch++) {
+      size_t na = agx_monitor_history_query(a, t, ch, 0, pa, s_count);
+      size_t nb = agx_monitor_history_query(b, t, ch, 0, pb, s_count);
+      same = na == nb && memcmp(pa, pb, na * sizeof(*pa)) == 0;
+    }
+  }
+  free(pa);
+  free(pb);
+  return same;
+}
+
+static void test_file(const agx_monitor_history_t *history) {
+  agx_monitor_history_t loaded;
+  uint32_t time = 0;
+
+  CHECK(agx_monitor_history_save(history, FILE_PATH, 12345) == ESP_OK,
+        "save");
+  CHECK(agx_monitor_history_load(&loaded, FILE_PATH, &time) == ESP_OK,
+        "load");
+  CHECK(time == 12345 && loaded.samples == history->samples, "file header");
+  CHECK(same_contents(history, &loaded), "loaded history differs");
+
+  // 加载后继续追加，与原存储追加同样的样本结果一致
+  agx_monitor_history_t copy;
+  CHECK(agx_monitor_history_load(&copy, FILE_PATH, NULL) == ESP_OK, "reload");
+  uint32_t t = s_times[s_count - 1] + 1;
+  CHECK(agx_monitor_history_add(&loaded, t, s_samples[0]) == ESP_OK &&
+            agx_monitor_history_add(&copy, t, s_samples[0]) == ESP_OK &&
+            same_contents(&loaded, &copy),
+        "append after load");
+  agx_monitor_history_deinit(&copy);
+  agx_monitor_history_deinit(&loaded);
+
+  FILE *f = fopen(FILE_PATH, "r+b");
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fseek(f, 4, SEEK_SET);
+  fputc(9, f); // 版本号
+  fclose(f);
+  CHECK(agx_monitor_history_load(&loaded, FILE_PATH, NULL) ==
+            ESP_ERR_INVALID_VERSION,
+        "bad version accepted");
+
+  agx_monitor_history_save(history, FILE_PATH, 0);
+  CHECK(truncate(FILE_PATH, size - 100) == 0, "truncate");
+  CHECK(agx_monitor_history_load(&loaded, FILE_PATH, NULL) ==
+            ESP_ERR_INVALID_SIZE,
+        "truncated file accepted");
+
+  // 块内随机字节损坏：加载成功或报错都可以，但不能越界
+  for (int i = 0; i < 200; i++) {
+    agx_monitor_history_save(history, FILE_PATH, 0);
+    f = fopen(FILE_PATH, "r+b");
+    for (int k = 0; k < 8; k++) {
+      fseek(f, 40 + rand() % (size - 40), SEEK_SET);
+      fputc(rand() & 0xff, f);
+    }
+    fclose(f);
+    if (agx_monitor_history_load(&loaded, FILE_PATH, NULL) == ESP_OK) {
+      agx_history_point_t p[64];
+      for (int t = 0; t < AGX_HISTORY_TIER_COUNT; t++) {
+        agx_monitor_history_query(&loaded, t, AGX_HISTORY_CH_CPU_USAGE, 0, p,
+                                  64);
+      }
+      agx_monitor_history_add(&loaded, UINT32_MAX, s_samples[0]);
+      agx_monitor_history_deinit(&loaded);
+    }
+  }
+
+  CHECK(agx_monitor_history_load(&loaded, "no/such/file", NULL) ==
+            ESP_ERR_NOT_FOUND,
+        "missing file");
+  remove(FILE_PATH);
+}
+
+static void test_edge_cases(void) {
+  agx_monitor_history_t h;
+  size_t small[AGX_HISTORY_TIER_COUNT] = {1024, 1024, 1000};
+  int32_t v[AGX_HISTORY_CHANNELS] = {0};
+
+  CHECK(agx_monitor_history_init(&h, small) == ESP_ERR_INVALID_ARG,
+        "tier under two blocks accepted");
+  small[2] = 1024;
+  CHECK(agx_monitor_history_init(&h, small) == ESP_OK, "init");
+  CHECK(agx_monitor_history_add(&h, 0, v) == ESP_OK, "first sample at 0");
+  CHECK(agx_monitor_history_add(&h, 0, v) == ESP_ERR_INVALID_STATE,
+        "same second accepted");
+  CHECK(agx_monitor_history_add(&h, 10, v) == ESP_OK, "add");
+  CHECK(agx_monitor_history_add(&h, 5, v) == ESP_ERR_INVALID_STATE,
+        "time went backwards");
+
+  // 极值：相邻记录的差值超出 int32
+  v[AGX_HISTORY_CH_RAM_USED] = INT32_MAX;
+  v[AGX_HISTORY_CH_TEMP_CPU] = INT32_MIN;
+  CHECK(agx_monitor_history_add(&h, 11, v) == ESP_OK, "extremes");
+  v[AGX_HISTORY_CH_RAM_USED] = INT32_MIN;
+  v[AGX_HISTORY_CH_TEMP_CPU] = INT32_MAX;
+  CHECK(agx_monitor_history_add(&h, 12, v) == ESP_OK, "extremes");
+  agx_history_point_t p[8];
+  size_t n =
+      agx_monitor_history_query(&h, AGX_HISTORY_TIER_RAW,
+                                AGX_HISTORY_CH_RAM_USED, 11, p, 8);
+  CHECK(n == 2 && p[0].avg == INT32_MAX && p[1].avg == INT32_MIN,
+        "extreme deltas");
+  n = agx_monitor_history_query(&h, AGX_HISTORY_TIER_RAW,
+                                AGX_HISTORY_CH_TEMP_CPU, 11, p, 8);
+  CHECK(n == 2 && p[0].avg == INT32_MIN && p[1].avg == INT32_MAX,
+        "extreme deltas");
+
+  agx_monitor_history_clear(&h);
+  CHECK(agx_monitor_history_query(&h, AGX_HISTORY_TIER_RAW, 0, 0, p, 8) == 0,
+        "clear");
+  CHECK(agx_monitor_history_add(&h, 1, v) == ESP_OK, "add after clear");
+  agx_monitor_history_deinit(&h);
+
+  char name[16];
+  agx_history_channel_t ch;
+  for (int i = 0; i < AGX_HISTORY_CHANNELS; i++) {
+    agx_monitor_history_channel_name(i, name, sizeof(name));
+    CHECK(agx_monitor_history_channel_from_name(name, &ch) == ESP_OK &&
+              ch == (agx_history_channel_t)i,
+          "channel name %s", name);
+  }
+  CHECK(agx_monitor_history_channel_from_name("cpu99", &ch) ==
+            ESP_ERR_NOT_FOUND,
+        "unknown channel");
+
+  agx_monitor_data_t data;
+  memset(&data, 0, sizeof(data));
+  data.cpu.core_count = 2;
+  data.cpu.cores[1].usage = 42;
+  data.temperature.tj = 51.234f;
+  data.temperature.soc0 = -3.456f;
+  data.power.sys_5v.current = 4000000000u;
+  data.gpu.gr3d_freq = 77;
+  data.memory.ram.used = 30000;
+  agx_monitor_history_sample(&data, v);
+  CHECK(v[1] == 42 && v[AGX_HISTORY_CH_TEMP_TJ] == 5123 &&
+            v[AGX_HISTORY_CH_TEMP_SOC0] == -346 &&
+            v[AGX_HISTORY_CH_POWER_SYS_5V] == INT32_MAX &&
+            v[AGX_HISTORY_CH_GPU_LOAD] == 77 &&
+            v[AGX_HISTORY_CH_RAM_USED] == 30000,
+        "sample conversion");
+}
+
+int main(void) {
+  agx_monitor_history_t history;
+
+  srand(1);
+  s_samples = malloc(DAY_SECONDS * sizeof(*s_samples));
+  s_times = malloc(DAY_SECONDS * sizeof(*s_times));
+  generate();
+
+  if (agx_monitor_history_init(&history, k_tier_bytes) != ESP_OK) {
+    printf("init failed\n");
+    return 1;
+  }
+
+  double start = now_ns();
+  for (size_t i = 0; i < s_count; i++) {
+    if (agx_monitor_history_add(&history, s_times[i], s_samples[i]) !=
+        ESP_OK) {
+      CHECK(0, "add %zu", i);
+    }
+  }
+  double add_ns = (now_ns() - start) / s_count;
+
+  printf("%zu samples over %d h, %d channels, tiers %zu/%zu/%zu KB\n",
+         s_count, DAY_SECONDS / 3600, AGX_HISTORY_CHANNELS,
+         k_tier_bytes[0] / 1024, k_tier_bytes[1] / 1024,
+         k_tier_bytes[2] / 1024);
+  report(&history);
+  check_against_reference(&history);
+
+  agx_history_point_t *points = malloc(s_count * sizeof(*points));
+  start = now_ns();
+  size_t n = agx_monitor_history_query(&history, AGX_HISTORY_TIER_RAW,
+                                       AGX_HISTORY_CH_TEMP_CPU, 0, points,
+                                       s_count);
+  double query_us = (now_ns() - start) / 1e3;
+  free(points);
+  printf("add: %.0f ns/sample, query raw tier (%zu points): %.0f us\n",
+         add_ns, n, query_us);
+
+  test_file(&history);
+  test_edge_cases();
+  agx_monitor_history_deinit(&history);
+
+  free(s_samples);
+  free(s_times);
+  printf(s_failures ? "FAILED\n" : "OK\n");
+  return s_failures != 0;
+}
@@ -0,0 +1,615 @@
+/**
+ * @file bench_agx_link.c
+ * @brief AGX 连接状态机的正确性与重连耗时
+ *
+ * 1. 单步检查：退避延时的上下界和抖动分布、稳定连接断开后立即重连、
+ *    以太网恢复时跳过等待、旧连接的迟到事件被忽略、任意状态下 STOP。
+ * 2. 离散时间仿真：用一个模拟的 Socket.IO 服务器（1 Hz 推送，可拒绝连接、
+ *    接受连接但不发数据、进程重启、整机重启导致以太网掉线）驱动状态机，
+ *    每次恢复都核对重连耗时和数据中断两项指标，并检查掉线期间从不发起
+ *    连接。
+ * 3. 报告服务器可用后到数据恢复的 p50/p95 以及每次中断的连接次数。
+ *
+ * 与设备上相同，仿真把同一连接的客户端事件按连接序号过滤：断开后才到达
+ * 的事件被丢弃。
+ */
+
+#include "agx_monitor_link.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_PENDING 64
+#define DATA_INTERVAL_MS 1000
+#define WS_OPEN_MS 20  ///< TCP + WebSocket 握手
+#define REFUSE_MS 5    ///< 服务器未监听时 RST 的往返
+#define OUTAGES 2000   ///< 每种场景的中断次数
+
+static int s_failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("FAIL: " __VA_ARGS__);                                            \
+      printf("\n");                                                            \
+      s_failures++;                                                            \
+    }                                                                          \
+  } while (0)
+
+/** 与 agx_monitor_get_default_config 和 agx_monitor_start 一致 */
+static agx_link_config_t default_config(void) {
+  agx_link_config_t config = {
+      .startup_delay_ms = 45000,
+      .connect_timeout_ms = 10000,
+      .liveness_timeout_ms = 10000,
+      .fast_retry_count = 3,
+      .fast_retry_interval_ms = 1000,
+      .backoff_initial_ms = 3000,
+      .backoff_max_ms = 10000,
+      .stable_ms = 30000,
+      .jitter_percent = 25,
+  };
+  return config;
+}
+
+/* ============================================================================
+ * 单步检查
+ * ============================================================================
+ */
+
+/** 第 failures 次失败后的名义延时（不含抖动） */
+static uint32_t nominal_delay(const agx_link_config_t *c, uint32_t failures) {
+  if (failures <= c->fast_retry_count) {
+    return c->fast_retry_interval_ms;
+  }
+  uint64_t delay = c->backoff_initial_ms;
+  for (uint32_t n = c->fast_retry_count + 1; n < failures; n++) {
+    delay *= 2;
+    if (delay >= c->backoff_max_ms) {
+      return c->backoff_max_ms;
+    }
+  }
+  return delay > c->backoff_max_ms ? c->backoff_max_ms : (uint32_t)delay;
+}
+
+static void test_backoff(void) {
+  agx_link_config_t config = default_config();
+  config.startup_delay_ms = 0;
+  const int failures = 12;
+  uint32_t lo[12], hi[12];
+
+  for (int i = 0; i < failures; i++) {
+    lo[i] = UINT32_MAX;
+    hi[i] = 0;
+  }
+
+  // 服务器一直拒绝连接：每次失败进入 BACKOFF，延时落在 [名义*(1-抖动), 名义]
+  for (uint32_t seed = 1; seed <= 1000; seed++) {
+    agx_monitor_link_t link;
+    uint64_t now = 1000;
+    agx_monitor_link_init(&link, &config, seed);
+    uint32_t actions =
+        agx_monitor_link_handle(&link, AGX_LINK_EVENT_START, now);
+    CHECK(actions == AGX_LINK_ACTION_CONNECT, "start without delay connects");
+
+    for (int i = 0; i < failures; i++) {
+      now += REFUSE_MS;
+      actions = agx_monitor_link_handle(&link, AGX_LINK_EVENT_WS_ERROR, now);
+      CHECK(actions == AGX_LINK_ACTION_DISCONNECT, "failure %d actions %u",
+            i + 1, actions);
+      CHECK(link.state == AGX_LINK_STATE_BACKOFF, "failure %d state %s", i + 1,
+            agx_monitor_link_state_name(link.state));
+
+      uint32_t delay = agx_monitor_link_timeout(&link, now);
+      uint32_t nominal = nominal_delay(&config, i + 1);
+      CHECK(delay <= nominal && delay >= nominal - nominal * 25 / 100,
+            "failure %d delay %u outside %u-25%%", i + 1, delay, nominal);
+      lo[i] = delay < lo[i] ? delay : lo[i];
+      hi[i] = delay > hi[i] ? delay : hi[i];
+
+      CHECK(agx_monitor_link_handle(&link, AGX_LINK_EVENT_TIMER, now + 1) ==
+                AGX_LINK_ACTION_NONE,
+            "timer fired early");
+      now += delay;
+      actions = agx_monitor_link_handle(&link, AGX_LINK_EVENT_TIMER, now);
+      CHECK(actions == AGX_LINK_ACTION_CONNECT, "no reconnect after backoff");
+    }
+    CHECK(link.stats.attempts == (uint32_t)failures + 1 &&
+              link.stats.failures == (uint32_t)failures,
+          "attempt counters %u/%u", link.stats.attempts, link.stats.failures);
+  }
+
+  // 抖动要真正分散各客户端：1000 个种子的延时覆盖大部分区间
+  printf("Backoff (1000 seeds, ms):");
+  for (int i = 0; i < failures; i++) {
+    uint32_t nominal = nominal_delay(&config, i + 1);
+    CHECK(hi[i] - lo[i] >= nominal * 20 / 100, "failure %d jitter %u..%u",
+          i + 1, lo[i], hi[i]);
+    printf(" %u-%u", lo[i], hi[i]);
+  }
+  printf("\n");
+
+  // 无抖动时完全按名义延时
+  config.jitter_percent = 0;
+  agx_monitor_link_t link;
+  uint64_t now = 1;
+  agx_monitor_link_init(&link, &config, 1);
+  agx_monitor_link_handle(&link, AGX_LINK_EVENT_START, now);
+  for (int i = 0; i < failures; i++) {
+    agx_monitor_link_handle(&link, AGX_LINK_EVENT_WS_ERROR, now);
+    uint32_t delay = agx_monitor_link_timeout(&link, now);
+    CHECK(delay == nominal_delay(&config, i + 1),
+          "failure %d without jitter: %u ms", i + 1, delay);
+    now += delay;
+    agx_monitor_link_handle(&link, AGX_LINK_EVENT_TIMER, now);
+  }
+}
+
+/** 从 STOPPED 走到指定状态，返回当前时间 */
+static uint64_t drive_to(agx_monitor_link_t *link, agx_link_state_t target) {
+  agx_link_config_t config = default_config();
+  uint64_t now = 100;
+
+  agx_monitor_link_init(link, &config, 7);
+  if (target == AGX_LINK_STATE_STOPPED) {
+    return now;
+  }
+  if (target == AGX_LINK_STATE_NO_LINK) {
+    agx_monitor_link_handle(link, AGX_LINK_EVENT_START, now);
+    agx_monitor_link_handle(link, AGX_LINK_EVENT_LINK_DOWN, now);
+    return now;
+  }
+  agx_monitor_link_handle(link, AGX_LINK_EVENT_START, now);
+  if (target == AGX_LINK_STATE_STARTUP) {
+    return now;
+  }
+  now += config.startup_delay_ms;
+  agx_monitor_link_handle(link, AGX_LINK_EVENT_TIMER, now);
+  if (target == AGX_LINK_STATE_CONNECTING) {
+    return now;
+  }
+  if (target == AGX_LINK_STATE_BACKOFF) {
+    agx_monitor_link_handle(link, AGX_LINK_EVENT_WS_ERROR, now);
+    return now;
+  }
+  agx_monitor_link_handle(link, AGX_LINK_EVENT_WS_CONNECTED, now);
+  if (target == AGX_LINK_STATE_ONLINE) {
+    agx_monitor_link_handle(link, AGX_LINK_EVENT_DATA, now);
+  }
+  return now;
+}
+
+static void test_transitions(void) {
+  agx_monitor_link_t link;
+  uint32_t actions;
+
+  // 任意状态下 STOP：回到 STOPPED、无定时器，只在客户端运行时断开
+  for (int s = 0; s < AGX_LINK_STATE_COUNT; s++) {
+    uint64_t now = drive_to(&link, (agx_link_state_t)s);
+    CHECK(link.state == (agx_link_state_t)s, "could not reach %s",
+          agx_monitor_link_state_name((agx_link_state_t)s));
+    actions = agx_monitor_link_handle(&link, AGX_LINK_EVENT_STOP, now + 1);
+    bool active = s == AGX_LINK_STATE_CONNECTING ||
+                  s == AGX_LINK_STATE_HANDSHAKE || s == AGX_LINK_STATE_ONLINE;
+    CHECK(link.state == AGX_LINK_STATE_STOPPED, "STOP from %s",
+          agx_monitor_link_state_name((agx_link_state_t)s));
+    CHECK(!(actions & AGX_LINK_ACTION_CONNECT) &&
+              !!(actions & AGX_LINK_ACTION_DISCONNECT) == active,
+          "STOP from %s actions %u",
+          agx_monitor_link_state_name((agx_link_state_t)s), actions);
+    CHECK(agx_monitor_link_timeout(&link, now + 1) == AGX_LINK_NO_TIMEOUT,
+          "timer left after STOP from %s",
+          agx_monitor_link_state_name((agx_link_state_t)s));
+
+    // 停止后除 START 外的事件都没有动作
+    for (int e = AGX_LINK_EVENT_STOP; e < AGX_LINK_EVENT_COUNT; e++) {
+      actions =
+          agx_monitor_link_handle(&link, (agx_link_event_t)e, now + 100000);
+      CHECK(actions == AGX_LINK_ACTION_NONE &&
+                link.state == AGX_LINK_STATE_STOPPED,
+            "%s after STOP", agx_monitor_link_event_name(e));
+    }
+  }
+
+  // 稳定连接断开：立即重连且退避清零；刚建立就断开：进入退避
+  uint64_t now = drive_to(&link, AGX_LINK_STATE_ONLINE);
+  link.failures = 5;
+  actions = agx_monitor_link_handle(&link, AGX_LINK_EVENT_WS_DISCONNECTED,
+                                    now + 30000);
+  CHECK(actions == (AGX_LINK_ACTION_DISCONNECT | AGX_LINK_ACTION_INVALIDATE |
+                    AGX_LINK_ACTION_CONNECT) &&
+            link.failures == 0,
+        "stable connection not retried at once (actions %u)", actions);
+
+  now = drive_to(&link, AGX_LINK_STATE_ONLINE);
+  actions =
+      agx_monitor_link_handle(&link, AGX_LINK_EVENT_WS_DISCONNECTED, now + 10);
+  CHECK(actions == (AGX_LINK_ACTION_DISCONNECT | AGX_LINK_ACTION_INVALIDATE) &&
+            link.state == AGX_LINK_STATE_BACKOFF,
+        "unstable connection not backed off (actions %u)", actions);
+
+  // 旧连接的迟到事件不影响退避
+  actions =
+      agx_monitor_link_handle(&link, AGX_LINK_EVENT_WS_DISCONNECTED, now + 20);
+  CHECK(actions == AGX_LINK_ACTION_NONE &&
+            link.state == AGX_LINK_STATE_BACKOFF && link.failures == 1,
+        "stale disconnect changed the backoff");
+  actions = agx_monitor_link_handle(&link, AGX_LINK_EVENT_DATA, now + 30);
+  CHECK(actions == AGX_LINK_ACTION_NONE && link.state == AGX_LINK_STATE_BACKOFF,
+        "stale data in backoff");
+
+  // 以太网恢复跳过启动延时和退避
+  now = drive_to(&link, AGX_LINK_STATE_STARTUP);
+  actions = agx_monitor_link_handle(&link, AGX_LINK_EVENT_LINK_UP, now + 5);
+  CHECK(actions == AGX_LINK_ACTION_CONNECT, "link up during startup delay");
+  now = drive_to(&link, AGX_LINK_STATE_BACKOFF);
+  actions = agx_monitor_link_handle(&link, AGX_LINK_EVENT_LINK_UP, now + 5);
+  CHECK(actions == AGX_LINK_ACTION_CONNECT && link.failures == 0,
+        "link up during backoff");
+  now = drive_to(&link, AGX_LINK_STATE_NO_LINK);
+  CHECK(agx_monitor_link_handle(&link, AGX_LINK_EVENT_TIMER, now + 1000000) ==
+            AGX_LINK_ACTION_NONE,
+        "timer while link down");
+  actions = agx_monitor_link_handle(&link, AGX_LINK_EVENT_LINK_UP, now + 5);
+  CHECK(actions == AGX_LINK_ACTION_CONNECT, "link up from NO_LINK");
+
+  // 启动时链路已断：等到链路恢复
+  agx_link_config_t config = default_config();
+  agx_monitor_link_init(&link, &config, 1);
+  agx_monitor_link_handle(&link, AGX_LINK_EVENT_LINK_DOWN, 1);
+  CHECK(agx_monitor_link_handle(&link, AGX_LINK_EVENT_START, 2) ==
+                AGX_LINK_ACTION_NONE &&
+            link.state == AGX_LINK_STATE_NO_LINK,
+        "start with link down");
+
+  // 在线时数据中断：liveness 超时后断开
+  now = drive_to(&link, AGX_LINK_STATE_ONLINE);
+  CHECK(agx_monitor_link_timeout(&link, now) == 10000, "liveness timer");
+  agx_monitor_link_handle(&link, AGX_LINK_EVENT_DATA, now + 5000);
+  CHECK(agx_monitor_link_handle(&link, AGX_LINK_EVENT_TIMER, now + 10000) ==
+            AGX_LINK_ACTION_NONE,
+        "data did not restart the liveness timer");
+  actions = agx_monitor_link_handle(&link, AGX_LINK_EVENT_TIMER, now + 15000);
+  CHECK((actions & AGX_LINK_ACTION_DISCONNECT) &&
+            (actions & AGX_LINK_ACTION_INVALIDATE) &&
+            link.stats.liveness_timeouts == 1,
+        "liveness timeout (actions %u)", actions);
+
+  // 握手后一直没有数据：连接超时
+  now = drive_to(&link, AGX_LINK_STATE_HANDSHAKE);
+  actions = agx_monitor_link_handle(&link, AGX_LINK_EVENT_TIMER, now + 10000);
+  CHECK((actions & AGX_LINK_ACTION_DISCONNECT) &&
+            link.stats.connect_timeouts == 1 && link.stats.failures == 1,
+        "connect timeout (actions %u)", actions);
+}
+
+/* ============================================================================
+ * 仿真
+ * ============================================================================
+ */
+
+typedef enum {
+  SCENARIO_SERVER_RESTART, ///< 服务进程重启，连接被关闭，随后一段时间拒绝连接
+  SCENARIO_AGX_REBOOT, ///< 整机重启：以太网掉线，DHCP 重新分配，服务晚些启动
+  SCENARIO_STALL,      ///< 连接保持但数据停止（服务卡住后恢复）
+  SCENARIO_HUNG_ACCEPT, ///< 重启后一段时间接受连接但不发送数据
+  SCENARIO_COUNT
+} scenario_t;
+
+static const char *const k_scenario_names[SCENARIO_COUNT] = {
+    "server restart", "AGX reboot", "data stall", "hung accept"};
+
+typedef struct {
+  uint64_t at;
+  agx_link_event_t event;
+  uint32_t conn; ///< 客户端事件所属连接，0 为网络事件
+} sim_event_t;
+
+typedef struct {
+  agx_monitor_link_t link;
+  uint64_t now;
+  sim_event_t pending[MAX_PENDING];
+  int count;
+
+  // 客户端
+  uint32_t conn;    ///< 当前连接序号，每次 CONNECT 加一
+  bool client_open; ///< CONNECT 之后、DISCONNECT 之前
+
+  // 服务器和网络
+  bool link_up;
+  uint64_t accept_at; ///< 之后接受连接
+  uint64_t data_at;   ///< 之后接受的连接会推送数据
+  bool serving;       ///< 当前连接正在推送
+
+  // 指标核对
+  uint64_t last_data;
+  uint64_t offline_since; ///< 离开 ONLINE 的时刻
+} sim_t;
+
+static void sim_post(sim_t *sim, uint64_t at, agx_link_event_t event,
+                     uint32_t conn) {
+  if (sim->count == MAX_PENDING) {
+    printf("FAIL: simulator queue full\n");
+    s_failures++;
+    return;
+  }
+  sim->pending[sim->count++] = (sim_event_t){at, event, conn};
+}
+
+/** 丢弃某连接尚未送达的事件（服务器断开推送时） */
+static void sim_drop_conn(sim_t *sim, uint32_t conn) {
+  int n = 0;
+  for (int i = 0; i < sim->count; i++) {
+    if (sim->pending[i].conn != conn) {
+      sim->pending[n++] = sim->pending[i];
+    }
+  }
+  sim->count = n;
+}
+
+static void sim_dispatch(sim_t *sim, agx_link_event_t event);
+
+static void sim_connect(sim_t *sim) {
+  CHECK(sim->link_up, "CONNECT at %llu ms while the link is down",
+        (unsigned long long)sim->now);
+  sim->conn++;
+  sim->client_open = true;
+  sim->serving = false;
+
+  if (!sim->link_up) {
+    // ARP 无应答，客户端网络超时
+    sim_post(sim, sim->now + sim->link.config.connect_timeout_ms,
+             AGX_LINK_EVENT_WS_ERROR, sim->conn);
+  } else if (sim->now < sim->accept_at) {
+    sim_post(sim, sim->now + REFUSE_MS, AGX_LINK_EVENT_WS_ERROR, sim->conn);
+  } else {
+    sim_post(sim, sim->now + WS_OPEN_MS, AGX_LINK_EVENT_WS_CONNECTED,
+             sim->conn);
+    if (sim->now >= sim->data_at) {
+      // 服务器在自己的 1 Hz 节拍上推送
+      uint64_t first = sim->now + WS_OPEN_MS + 1;
+      first += DATA_INTERVAL_MS - first % DATA_INTERVAL_MS;
+      sim->serving = true;
+      sim_post(sim, first, AGX_LINK_EVENT_DATA, sim->conn);
+    }
+  }
+}
+
+static void sim_dispatch(sim_t *sim, agx_link_event_t event) {
+  agx_link_state_t old_state = sim->link.state;
+  uint32_t reconnects = sim->link.stats.reconnects;
+  uint32_t actions = agx_monitor_link_handle(&sim->link, event, sim->now);
+
+  if (actions & AGX_LINK_ACTION_DISCONNECT) {
+    CHECK(sim->client_open, "DISCONNECT without a client");
+    sim->client_open = false;
+    sim->serving = false;
+  }
+  if (actions & AGX_LINK_ACTION_INVALIDATE) {
+    CHECK(old_state == AGX_LINK_STATE_ONLINE, "INVALIDATE from %s",
+          agx_monitor_link_state_name(old_state));
+  }
+  if (actions & AGX_LINK_ACTION_CONNECT) {
+    CHECK(!sim->client_open || (actions & AGX_LINK_ACTION_DISCONNECT),
+          "CONNECT while a client is open");
+    sim_connect(sim);
+  }
+
+  if (old_state == AGX_LINK_STATE_ONLINE &&
+      sim->link.state != AGX_LINK_STATE_ONLINE) {
+    sim->offline_since = sim->now;
+  }
+
+  if (sim->link.stats.reconnects != reconnects) {
+    const agx_link_stats_t *s = &sim->link.stats;
+    CHECK(s->last_reconnect_ms == sim->now - sim->offline_since,
+          "reconnect metric %u ms, expected %llu", s->last_reconnect_ms,
+          (unsigned long long)(sim->now - sim->offline_since));
+    CHECK(s->last_gap_ms == sim->now - sim->last_data,
+          "gap metric %u ms, expected %llu", s->last_gap_ms,
+          (unsigned long long)(sim->now - sim->last_data));
+  }
+  if (event == AGX_LINK_EVENT_DATA &&
+      sim->link.state == AGX_LINK_STATE_ONLINE) {
+    sim->last_data = sim->now;
+  }
+}
+
+/** 推进到 until，依次送达到期的事件和状态机定时器 */
+static void sim_run(sim_t *sim, uint64_t until) {
+  for (;;) {
+    int next = -1;
+    for (int i = 0; i < sim->count; i++) {
+      if (next < 0 || sim->pending[i].at < sim->pending[next].at) {
+        next = i;
+      }
+    }
+    uint32_t timeout = agx_monitor_link_timeout(&sim->link, sim->now);
+    uint64_t timer_at = timeout == AGX_LINK_NO_TIMEOUT
+                            ? UINT64_MAX
+                            : sim->now + timeout;
+    uint64_t event_at = next < 0 ? UINT64_MAX : sim->pending[next].at;
+
+    if (timer_at > until && event_at > until) {
+      sim->now = until;
+      return;
+    }
+    if (timer_at < event_at) {
+      sim->now = timer_at;
+      sim_dispatch(sim, AGX_LINK_EVENT_TIMER);
+      continue;
+    }
+
+    sim_event_t ev = sim->pending[next];
+    sim->pending[next] = sim->pending[--sim->count];
+    sim->now = ev.at;
+    if (ev.conn != 0 && (ev.conn != sim->conn || !sim->client_open)) {
+      continue; // 已关闭连接的迟到事件，设备上按连接序号丢弃
+    }
+    if (ev.event == AGX_LINK_EVENT_DATA) {
+      if (!sim->serving) {
+        continue;
+      }
+      sim_post(sim, ev.at + DATA_INTERVAL_MS, AGX_LINK_EVENT_DATA, ev.conn);
+    }
+    sim_dispatch(sim, ev.event);
+  }
+}
+
+static void sim_set_link(sim_t *sim, bool up) {
+  sim->link_up = up;
+  sim_post(sim, sim->now,
+           up ? AGX_LINK_EVENT_LINK_UP : AGX_LINK_EVENT_LINK_DOWN, 0);
+  sim_run(sim, sim->now);
+}
+
+static uint32_t rand_range(uint32_t lo, uint32_t hi) {
+  return lo + (uint32_t)rand() % (hi - lo + 1);
+}
+
+/**
+ * 制造一次中断，运行到数据恢复后再稳定运行一段时间
+ *
+ * @return 服务器可用（accept 且推送）之后到数据恢复的毫秒数
+ */
+static uint64_t sim_outage(sim_t *sim, scenario_t scenario) {
+  uint64_t ready;
+
+  CHECK(sim->link.state == AGX_LINK_STATE_ONLINE, "not online before outage");
+  switch (scenario) {
+  case SCENARIO_SERVER_RESTART:
+    sim->serving = false;
+    sim_drop_conn(sim, sim->conn);
+    sim_post(sim, sim->now, AGX_LINK_EVENT_WS_DISCONNECTED, sim->conn);
+    sim->accept_at = sim->now + rand_range(500, 15000);
+    sim->data_at = sim->accept_at;
+    ready = sim->accept_at;
+    sim_run(sim, sim->now);
+    break;
+
+  case SCENARIO_AGX_REBOOT: {
+    // 整机断电：连接不会收到关闭帧，只有以太网掉线
+    uint64_t t0 = sim->now;
+    sim->serving = false;
+    sim_drop_conn(sim, sim->conn);
+    sim->accept_at = t0 + rand_range(25000, 60000);
+    sim->data_at = sim->accept_at;
+    ready = sim->accept_at;
+    sim_set_link(sim, false);
+    sim_run(sim, t0 + rand_range(1000, 4000));
+    sim_set_link(sim, true); // PHY 链路恢复
+    sim_run(sim, sim->now + rand_range(2000, 6000));
+    sim_post(sim, sim->now, AGX_LINK_EVENT_LINK_UP, 0); // DHCP 租约
+    break;
+  }
+
+  case SCENARIO_STALL:
+    // 连接仍在但不再推送，直到客户端超时断开；服务随后恢复
+    sim->serving = false;
+    sim->accept_at = sim->now + rand_range(0, 20000);
+    sim->data_at = sim->accept_at;
+    ready = sim->accept_at;
+    break;
+
+  case SCENARIO_HUNG_ACCEPT:
+  default:
+    sim->serving = false;
+    sim_drop_conn(sim, sim->conn);
+    sim_post(sim, sim->now, AGX_LINK_EVENT_WS_DISCONNECTED, sim->conn);
+    sim->accept_at = sim->now + 500;
+    sim->data_at = sim->now + rand_range(5000, 40000);
+    ready = sim->data_at;
+    break;
+  }
+
+  uint32_t reconnects = sim->link.stats.reconnects;
+  uint64_t deadline = ready + 120000;
+  while (sim->link.stats.reconnects == reconnects && sim->now < deadline) {
+    sim_run(sim, sim->now + 100);
+  }
+  CHECK(sim->link.stats.reconnects == reconnects + 1,
+        "%s: not reconnected 120 s after the server was ready",
+        k_scenario_names[scenario]);
+  CHECK(sim->now >= ready, "%s: online before the server was ready",
+        k_scenario_names[scenario]);
+
+  uint64_t restored = sim->now - ready;
+  // 稳定运行，下一次中断从稳定连接开始
+  sim_run(sim, sim->now + sim->link.config.stable_ms + rand_range(0, 5000));
+  return restored;
+}
+
+static int compare_u32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static void simulate(void) {
+  static uint32_t restore_ms[OUTAGES];
+  static uint32_t attempts[OUTAGES];
+
+  printf("\n%-16s %10s %10s %10s %12s\n", "scenario", "p50 ms", "p95 ms",
+         "max ms", "attempts/out");
+  for (int sc = 0; sc < SCENARIO_COUNT; sc++) {
+    sim_t sim;
+    agx_link_config_t config = default_config();
+    memset(&sim, 0, sizeof(sim));
+    agx_monitor_link_init(&sim.link, &config, 12345 + sc);
+    srand(1000 + sc);
+    sim.link_up = true;
+    sim.now = 1000;
+
+    sim_dispatch(&sim, AGX_LINK_EVENT_START);
+    sim_run(&sim, sim.now + config.startup_delay_ms + 5000);
+    CHECK(sim.link.state == AGX_LINK_STATE_ONLINE, "%s: not online at start",
+          k_scenario_names[sc]);
+    sim_run(&sim, sim.now + config.stable_ms);
+
+    uint64_t sum_attempts = 0;
+    for (int i = 0; i < OUTAGES; i++) {
+      uint32_t before = sim.link.stats.attempts;
+      restore_ms[i] = (uint32_t)sim_outage(&sim, (scenario_t)sc);
+      attempts[i] = sim.link.stats.attempts - before;
+      sum_attempts += attempts[i];
+    }
+
+    const agx_link_stats_t *s = &sim.link.stats;
+    CHECK(s->reconnects == OUTAGES, "%s: %u reconnects", k_scenario_names[sc],
+          s->reconnects);
+    if (sc == SCENARIO_AGX_REBOOT) {
+      CHECK(s->link_losses == OUTAGES, "link losses %u", s->link_losses);
+    }
+    if (sc == SCENARIO_STALL) {
+      CHECK(s->liveness_timeouts == OUTAGES, "liveness timeouts %u",
+            s->liveness_timeouts);
+    }
+    if (sc == SCENARIO_HUNG_ACCEPT) {
+      CHECK(s->connect_timeouts > 0, "no connect timeouts");
+    }
+
+    qsort(restore_ms, OUTAGES, sizeof(restore_ms[0]), compare_u32);
+    printf("%-16s %10u %10u %10u %12.1f\n", k_scenario_names[sc],
+           restore_ms[OUTAGES / 2], restore_ms[OUTAGES * 95 / 100],
+           restore_ms[OUTAGES - 1], (double)sum_attempts / OUTAGES);
+    printf("%-16s reconnect avg %llu ms max %u ms, gap avg %llu ms max %u ms\n",
+           "", (unsigned long long)(s->total_reconnect_ms / s->reconnects),
+           s->max_reconnect_ms,
+           (unsigned long long)(s->total_gap_ms / s->reconnects),
+           s->max_gap_ms);
+  }
+  printf("(p50/p95: from the server being ready to the first update)\n");
+}
+
+int main(void) {
+  test_backoff();
+  test_transitions();
+  simulate();
+
+  if (s_failures > 0) {
+    printf("\n%d check(s) FAILED\n", s_failures);
+    return 1;
+  }
+  printf("\nOK\n");
+  return 0;
+}
@@ -0,0 +1,823 @@
+/**
+ * @file bench_agx_load.c
+ * @brief AGX 接收路径在替身服务器下的吞吐、解析延迟和堆峰值
+ *
+ * 客户端按设备上的方式组装：连接由 agx_monitor_link 状态机驱动（与
+ * agx_monitor_start 相同的参数，只去掉启动延时），收到的数据按
+ * esp_websocket_client 的方式拆成不超过 4096 字节的数据事件交给
+ * agx_monitor_reassembly，完整消息按 agx_monitor_handle_message 的规则处理
+ * （连接后发 "40"、命名空间连上后请求二进制记录、ping 回 "3"、42 帧交给
+ * agx_monitor_parse_frame、协商成功后二进制消息交给
+ * agx_monitor_binary_decode）。
+ *
+ * 不带参数时在进程内启动 agx_replay 服务器，依次运行：
+ * 1. 10/25/50/100 帧/秒的干净数据：收到的帧数等于发出的，内容与合成值
+ *    逐字段一致
+ * 2. 100 帧/秒，5% 格式错误、20% 分片（夹带 ping 控制帧、TCP 分段写入）：
+ *    解析错误数等于注入数，其余帧全部正确，没有丢弃的消息
+ * 3. 50 帧/秒，每 1.5 秒中途断开：状态机自行重连，只丢失断开时的帧
+ * 4. 尽快推送：接收路径的吞吐上限
+ * 5. 服务器接受二进制记录时重复 100 帧/秒（含错误和分片，以 Socket.IO
+ *    二进制事件发出）和尽快推送；前面的阶段服务器不应答请求，验证回退到
+ *    JSON
+ * 每个阶段报告帧/秒、解析耗时分位数、客户端 CPU 占用、堆峰值和每帧字节数。
+ *
+ *   bench_agx_load -c 主机:端口 [-t 秒] [-o 文件]
+ *
+ * 连接外部服务器（agx_replay_server 或真实的 AGX），-o 把收到的
+ * tegrastats_update 帧逐行保存，可用 agx_replay_server -f 回放。
+ *
+ * 堆峰值统计客户端线程经 malloc/calloc/realloc/free 的分配（链接时用
+ * --wrap 包装），即重组缓冲池和模拟客户端的接收缓冲区，不含服务器线程。
+ * 设备上 esp_websocket_client 自身的收发缓冲区另计。
+ */
+
+#define _GNU_SOURCE
+
+#include "agx_monitor_binary.h"
+#include "agx_monitor_link.h"
+#include "agx_monitor_parser.h"
+#include "agx_monitor_reassembly.h"
+#include "agx_replay.h"
+
+#include <errno.h>
+#include <malloc.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define RX_BUFFER_SIZE 4096      ///< esp_websocket_client buffer_size
+#define MESSAGE_BUFFER_SIZE 4096 ///< CONFIG_AGX_MONITOR_MESSAGE_BUFFER_SIZE
+#define MESSAGE_BUFFERS 2        ///< CONFIG_AGX_MONITOR_MESSAGE_BUFFERS
+#define MAX_SAMPLES (1 << 20)
+#define MAX_PENDING 16
+#define DRAIN_TIMEOUT_MS 3000
+#define WS_KEY "dGhlIHNhbXBsZSBub25jZQ=="
+
+static int s_failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("FAIL: " __VA_ARGS__);                                            \
+      printf("\n");                                                            \
+      s_failures++;                                                            \
+    }                                                                          \
+  } while (0)
+
+static uint64_t now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint64_t thread_cpu_us(void) {
+  struct rusage ru;
+  getrusage(RUSAGE_THREAD, &ru);
+  return (uint64_t)(ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 +
+         ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+}
+
+/* ============================================================================
+ * 堆统计（-Wl,--wrap）
+ * ============================================================================
+ */
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void __real_free(void *ptr);
+
+static __thread bool t_track_heap;
+static size_t s_heap_now;
+static size_t s_heap_peak;
+
+static void heap_add(void *p) {
+  s_heap_now += malloc_usable_size(p);
+  if (s_heap_now > s_heap_peak) {
+    s_heap_peak = s_heap_now;
+  }
+}
+
+static void heap_sub(void *p) { s_heap_now -= malloc_usable_size(p); }
+
+void *__wrap_malloc(size_t size) {
+  void *p = __real_malloc(size);
+  if (t_track_heap && p != NULL) {
+    heap_add(p);
+  }
+  return p;
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+  void *p = __real_calloc(n, size);
+  if (t_track_heap && p != NULL) {
+    heap_add(p);
+  }
+  return p;
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+  if (t_track_heap && ptr != NULL) {
+    heap_sub(ptr);
+  }
+  void *p = __real_realloc(ptr, size);
+  if (t_track_heap) {
+    if (p != NULL) {
+      heap_add(p);
+    } else if (ptr != NULL) {
+      heap_add(ptr);
+    }
+  }
+  return p;
+}
+
+void __wrap_free(void *ptr) {
+  if (t_track_heap && ptr != NULL) {
+    heap_sub(ptr);
+  }
+  __real_free(ptr);
+}
+
+/* ============================================================================
+ * 客户端
+ * ============================================================================
+ */
+
+typedef struct {
+  agx_link_event_t event;
+  uint32_t attempt;
+} pending_t;
+
+typedef struct {
+  struct sockaddr_storage addr;
+  socklen_t addr_len;
+  char host[64];
+  FILE *record;
+
+  int fd;
+  bool connecting; ///< TCP 连接进行中
+  bool upgraded;   ///< WebSocket 握手完成
+  char http[1024];
+  size_t http_len;
+  uint32_t attempt;
+  agx_monitor_link_t link;
+  agx_monitor_reassembly_t reassembly;
+  agx_ws_decoder_t decoder;
+  uint8_t *rx;
+  pending_t pending[MAX_PENDING];
+  int pending_count;
+
+  bool binary;           ///< 服务器同意发二进制记录
+  uint32_t messages;     ///< 解析成功的 tegrastats_update
+  uint32_t records;      ///< 其中以二进制记录收到的
+  uint32_t parse_errors; ///< 解析失败
+  uint32_t ignored;      ///< 其他事件
+  uint32_t pings;        ///< Engine.IO ping
+  uint32_t verified;     ///< 与合成值核对过的帧
+  uint32_t mismatches;   ///< 内容与合成值不一致
+  uint32_t out_of_order; ///< 序号不递增
+  uint32_t gaps;         ///< 序号间缺失的帧（含格式错误的）
+  uint32_t invalidations;
+  bool have_seq;
+  uint32_t last_seq;
+  uint32_t samples;
+} client_t;
+
+static uint32_t s_parse_ns[MAX_SAMPLES];
+
+static void post(client_t *c, agx_link_event_t event) {
+  if (c->pending_count < MAX_PENDING) {
+    c->pending[c->pending_count++] = (pending_t){event, c->attempt};
+  }
+}
+
+static void send_text(client_t *c, const char *text) {
+  static const uint8_t mask[4] = {0x12, 0x34, 0x56, 0x78};
+  uint8_t frame[128];
+  size_t len = strlen(text);
+  size_t n = agx_ws_header(frame, 0x1, true, len, mask);
+  for (size_t i = 0; i < len; i++) {
+    frame[n + i] = (uint8_t)text[i] ^ mask[i & 3];
+  }
+  send(c->fd, frame, n + len, MSG_NOSIGNAL);
+}
+
+static void verify(client_t *c, const agx_monitor_data_t *data) {
+  uint32_t seq;
+  if (!agx_replay_seq(data->timestamp, &seq)) {
+    return;
+  }
+  if (c->have_seq) {
+    if (seq <= c->last_seq) {
+      c->out_of_order++;
+    } else {
+      c->gaps += seq - c->last_seq - 1;
+    }
+  }
+  c->have_seq = true;
+  c->last_seq = seq;
+
+  char frame[AGX_REPLAY_MAX_FRAME];
+  agx_monitor_data_t expected;
+  agx_replay_synth(seq, frame, sizeof(frame), &expected);
+  if (memcmp(data, &expected, sizeof(expected)) != 0) {
+    c->mismatches++;
+  }
+  c->verified++;
+}
+
+/* 与 agx_monitor_handle_message 相同的分派 */
+static void handle_message(client_t *c, const char *message, size_t len,
+                           uint8_t opcode) {
+  if (len == 0) {
+    return;
+  }
+  bool as_record = opcode == AGX_WS_OPCODE_BINARY && c->binary;
+  if (as_record || (len >= 2 && message[0] == '4' && message[1] == '2')) {
+    agx_monitor_data_t data;
+    uint64_t t0 = now_ns();
+    esp_err_t ret =
+        as_record ? agx_monitor_binary_decode((const uint8_t *)message, len,
+                                              &data, NULL)
+                  : agx_monitor_parse_frame(message, len, &data, NULL);
+    uint64_t t1 = now_ns();
+    if (c->samples < MAX_SAMPLES) {
+      s_parse_ns[c->samples++] = (uint32_t)(t1 - t0);
+    }
+
+    agx_binary_ack_t ack;
+    if (ret == ESP_OK) {
+      c->messages++;
+      c->records += as_record;
+      post(c, AGX_LINK_EVENT_DATA);
+      verify(c, &data);
+      // 录制文件是 JSON 帧，二进制记录不保存
+      if (c->record != NULL && !as_record) {
+        fwrite(message, 1, len, c->record);
+        fputc('\n', c->record);
+      }
+    } else if (ret == ESP_ERR_NOT_FOUND && !as_record &&
+               agx_monitor_binary_parse_ack(message, len, &ack) == ESP_OK) {
+      c->binary = ack.binary && ack.version == AGX_BINARY_VERSION;
+    } else if (ret == ESP_ERR_NOT_FOUND) {
+      c->ignored++;
+    } else {
+      c->parse_errors++;
+    }
+  } else if (len >= 2 && message[0] == '4' && message[1] == '0') {
+    char request[96];
+    snprintf(request, sizeof(request),
+             "42[\"" AGX_BINARY_EVENT "\",{\"format\":\"binary\","
+             "\"version\":%d,\"fields\":%d}]",
+             AGX_BINARY_VERSION, AGX_BINARY_FIELDS_ALL);
+    send_text(c, request);
+  } else if (message[0] == '2') {
+    c->pings++;
+    send_text(c, "3");
+  }
+}
+
+static void on_chunk(void *ctx, const char *data, size_t len, uint8_t opcode,
+                     bool fin, size_t payload_len, size_t payload_offset) {
+  client_t *c = ctx;
+  agx_ws_chunk_t chunk = {
+      .data = data,
+      .len = len,
+      .opcode = opcode,
+      .fin = fin,
+      .payload_len = payload_len,
+      .payload_offset = payload_offset,
+  };
+
+  // esp_websocket_client 自动回复 WebSocket ping
+  if (opcode == AGX_WS_OPCODE_PING && payload_offset + len == payload_len) {
+    uint8_t pong[6];
+    static const uint8_t mask[4] = {0};
+    size_t n = agx_ws_header(pong, AGX_WS_OPCODE_PONG, true, 0, mask);
+    send(c->fd, pong, n, MSG_NOSIGNAL);
+  }
+
+  agx_ws_message_t message;
+  esp_err_t ret = agx_monitor_reassembly_feed(&c->reassembly, &chunk, &message);
+  if (ret == ESP_OK) {
+    handle_message(c, message.data, message.len, message.opcode);
+    agx_monitor_reassembly_release(&c->reassembly, &message);
+  }
+}
+
+static void client_close(client_t *c) {
+  if (c->fd >= 0) {
+    close(c->fd);
+    c->fd = -1;
+  }
+  c->connecting = false;
+  c->upgraded = false;
+  c->binary = false;
+  agx_monitor_reassembly_reset(&c->reassembly);
+}
+
+static void client_connect(client_t *c) {
+  client_close(c);
+  c->attempt++;
+  c->http_len = 0;
+  agx_ws_decoder_reset(&c->decoder);
+
+  c->fd = socket(c->addr.ss_family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+  if (c->fd < 0 ||
+      (connect(c->fd, (struct sockaddr *)&c->addr, c->addr_len) != 0 &&
+       errno != EINPROGRESS)) {
+    post(c, AGX_LINK_EVENT_WS_ERROR);
+    return;
+  }
+  c->connecting = true;
+}
+
+static void dispatch(client_t *c, agx_link_event_t event) {
+  uint32_t actions = agx_monitor_link_handle(&c->link, event, now_ms());
+  if (actions & AGX_LINK_ACTION_DISCONNECT) {
+    client_close(c);
+  }
+  if (actions & AGX_LINK_ACTION_INVALIDATE) {
+    c->invalidations++;
+  }
+  if (actions & AGX_LINK_ACTION_CONNECT) {
+    client_connect(c);
+  }
+}
+
+static void process_pending(client_t *c) {
+  for (int i = 0; i < c->pending_count; i++) {
+    pending_t p = c->pending[i];
+    bool client_event = p.event == AGX_LINK_EVENT_WS_CONNECTED ||
+                        p.event == AGX_LINK_EVENT_WS_DISCONNECTED ||
+                        p.event == AGX_LINK_EVENT_WS_ERROR ||
+                        p.event == AGX_LINK_EVENT_DATA;
+    // 与设备上相同，已停止的连接迟到的事件被丢弃
+    if (!client_event || p.attempt == c->attempt) {
+      dispatch(c, p.event);
+    }
+  }
+  c->pending_count = 0;
+}
+
+static void tcp_connected(client_t *c) {
+  int err = 0;
+  socklen_t len = sizeof(err);
+  getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &err, &len);
+  c->connecting = false;
+  if (err != 0) {
+    close(c->fd);
+    c->fd = -1;
+    post(c, AGX_LINK_EVENT_WS_ERROR);
+    return;
+  }
+
+  int one = 1;
+  setsockopt(c->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  char request[256];
+  int n = snprintf(request, sizeof(request),
+                   "GET /socket.io/?EIO=4&transport=websocket HTTP/1.1\r\n"
+                   "Host: %s\r\n"
+                   "Upgrade: websocket\r\n"
+                   "Connection: Upgrade\r\n"
+                   "Sec-WebSocket-Key: " WS_KEY "\r\n"
+                   "Sec-WebSocket-Version: 13\r\n\r\n",
+                   c->host);
+  send(c->fd, request, (size_t)n, MSG_NOSIGNAL);
+}
+
+/* 握手响应；返回响应之后已读到的 WebSocket 数据的偏移，未完成时为 -1 */
+static ssize_t upgrade(client_t *c, const uint8_t *data, size_t len) {
+  size_t copy = len < sizeof(c->http) - 1 - c->http_len
+                    ? len
+                    : sizeof(c->http) - 1 - c->http_len;
+  memcpy(c->http + c->http_len, data, copy);
+  size_t before = c->http_len;
+  c->http_len += copy;
+  c->http[c->http_len] = '\0';
+
+  char *end = strstr(c->http, "\r\n\r\n");
+  if (end == NULL) {
+    return -1;
+  }
+  char accept[32];
+  agx_ws_accept_key(WS_KEY, accept);
+  if (strncmp(c->http, "HTTP/1.1 101", 12) != 0 ||
+      strstr(c->http, accept) == NULL) {
+    close(c->fd);
+    c->fd = -1;
+    post(c, AGX_LINK_EVENT_WS_ERROR);
+    return -1;
+  }
+
+  c->upgraded = true;
+  post(c, AGX_LINK_EVENT_WS_CONNECTED);
+  send_text(c, "40");
+  return (ssize_t)(end + 4 - c->http) - (ssize_t)before;
+}
+
+static void client_read(client_t *c) {
+  ssize_t n = recv(c->fd, c->rx, RX_BUFFER_SIZE, 0);
+  if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+    return;
+  }
+  if (n <= 0) {
+    close(c->fd);
+    c->fd = -1;
+    agx_monitor_reassembly_reset(&c->reassembly);
+    post(c, AGX_LINK_EVENT_WS_DISCONNECTED);
+    return;
+  }
+
+  size_t pos = 0;
+  if (!c->upgraded) {
+    ssize_t body = upgrade(c, c->rx, (size_t)n);
+    if (body < 0) {
+      return;
+    }
+    pos = (size_t)body;
+  }
+  if (!agx_ws_decode(&c->decoder, c->rx + pos, (size_t)n - pos, on_chunk, c)) {
+    post(c, AGX_LINK_EVENT_WS_ERROR);
+  }
+}
+
+static void client_start(client_t *c) {
+  t_track_heap = true;
+  s_heap_now = 0;
+  s_heap_peak = 0;
+
+  c->fd = -1;
+  c->rx = malloc(RX_BUFFER_SIZE);
+  if (c->rx == NULL || agx_monitor_reassembly_init(&c->reassembly,
+                                                   MESSAGE_BUFFER_SIZE,
+                                                   MESSAGE_BUFFERS) != ESP_OK) {
+    printf("FAIL: client allocation\n");
+    exit(1);
+  }
+
+  // agx_monitor_start 的默认参数，不等待 AGX 启动
+  const agx_link_config_t config = {
+      .startup_delay_ms = 0,
+      .connect_timeout_ms = AGX_MONITOR_DEFAULT_HEARTBEAT_TIMEOUT_MS,
+      .liveness_timeout_ms = AGX_MONITOR_DEFAULT_HEARTBEAT_TIMEOUT_MS,
+      .fast_retry_count = AGX_MONITOR_DEFAULT_FAST_RETRY_COUNT,
+      .fast_retry_interval_ms = AGX_MONITOR_DEFAULT_FAST_RETRY_INTERVAL_MS,
+      .backoff_initial_ms = AGX_MONITOR_DEFAULT_RECONNECT_INTERVAL_MS,
+      .backoff_max_ms = AGX_MONITOR_DEFAULT_RECONNECT_MAX_INTERVAL_MS,
+      .stable_ms = 30000,
+      .jitter_percent = AGX_MONITOR_DEFAULT_RECONNECT_JITTER_PERCENT,
+  };
+  agx_monitor_link_init(&c->link, &config, 0x5eed);
+  post(c, AGX_LINK_EVENT_START);
+}
+
+/**
+ * @brief 运行事件循环，直到 deadline 或 done(c) 为真
+ */
+static void client_poll(client_t *c, uint64_t deadline,
+                        bool (*done)(client_t *c, void *arg), void *arg) {
+  for (;;) {
+    process_pending(c);
+    uint64_t now = now_ms();
+    if (now >= deadline || (done != NULL && done(c, arg))) {
+      return;
+    }
+
+    uint32_t timeout = agx_monitor_link_timeout(&c->link, now);
+    if (timeout > deadline - now) {
+      timeout = (uint32_t)(deadline - now);
+    }
+    if (done != NULL && timeout > 10) {
+      timeout = 10;
+    }
+    struct pollfd pfd = {
+        .fd = c->fd,
+        .events = c->connecting ? POLLOUT : POLLIN,
+    };
+    int ready = poll(&pfd, c->fd >= 0 ? 1 : 0, (int)timeout);
+
+    if (ready > 0 && c->connecting) {
+      tcp_connected(c);
+    } else if (ready > 0) {
+      client_read(c);
+    }
+    if (agx_monitor_link_timeout(&c->link, now_ms()) == 0) {
+      post(c, AGX_LINK_EVENT_TIMER);
+    }
+  }
+}
+
+static void client_finish(client_t *c) {
+  post(c, AGX_LINK_EVENT_STOP);
+  process_pending(c);
+  client_close(c);
+  agx_monitor_reassembly_deinit(&c->reassembly);
+  free(c->rx);
+  c->rx = NULL;
+  t_track_heap = false;
+}
+
+/* ============================================================================
+ * 报告
+ * ============================================================================
+ */
+
+static int compare_u32(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static double percentile_us(const uint32_t *sorted, uint32_t n, double p) {
+  if (n == 0) {
+    return 0;
+  }
+  uint32_t i = (uint32_t)(p * (n - 1));
+  return sorted[i] / 1000.0;
+}
+
+static void report(const client_t *c, const agx_monitor_reassembly_t *r,
+                   uint64_t elapsed_ms, uint64_t cpu_us) {
+  qsort(s_parse_ns, c->samples, sizeof(s_parse_ns[0]), compare_u32);
+  const agx_link_stats_t *ls = &c->link.stats;
+
+  printf("  %.1f 帧/秒: %u 帧 (二进制 %u), %u 解析错误, %u 其他事件, %u ping"
+         "\n",
+         c->messages * 1000.0 / elapsed_ms, c->messages, c->records,
+         c->parse_errors, c->ignored, c->pings);
+  printf("  解析 p50 %.2f / p99 %.2f / p99.9 %.2f / max %.2f us\n",
+         percentile_us(s_parse_ns, c->samples, 0.50),
+         percentile_us(s_parse_ns, c->samples, 0.99),
+         percentile_us(s_parse_ns, c->samples, 0.999),
+         percentile_us(s_parse_ns, c->samples, 1.0));
+  printf("  重组 %u / 超长 %u / 丢弃 %u, 连接 %u 次, 重连 %u 次 (平均 %u ms)"
+         "\n",
+         r->frames_reassembled, r->frames_oversized, r->frames_dropped,
+         ls->attempts, ls->reconnects,
+         ls->reconnects ? (uint32_t)(ls->total_reconnect_ms / ls->reconnects)
+                        : 0);
+  printf("  客户端 CPU %.1f%% (每帧 %.1f us), 堆峰值 %zu 字节",
+         cpu_us / 10.0 / elapsed_ms,
+         c->messages ? (double)cpu_us / c->messages : 0.0, s_heap_peak);
+  if (c->verified > 0) {
+    printf(", 核对 %u 帧 (不一致 %u, 乱序 %u, 缺失 %u)", c->verified,
+           c->mismatches, c->out_of_order, c->gaps);
+  }
+  printf("\n");
+}
+
+/* ============================================================================
+ * 内置服务器上的各阶段
+ * ============================================================================
+ */
+
+typedef struct {
+  const char *name;
+  uint32_t rate;
+  uint8_t malformed_percent;
+  uint8_t fragment_percent;
+  uint32_t disconnect_ms;
+  uint32_t duration_ms;
+  bool exact;     ///< 没有断线：收到的帧数必须等于发出的
+  uint8_t binary; ///< agx_replay_config_t.binary
+} phase_t;
+
+typedef struct {
+  agx_replay_server_t *server;
+  agx_replay_stats_t stats;
+  bool done;
+} stopper_t;
+
+static void *stop_server(void *arg) {
+  stopper_t *st = arg;
+  agx_replay_stop(st->server, &st->stats);
+  __atomic_store_n(&st->done, true, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+/* 服务器已停止，最后一个连接的数据也已读完 */
+static bool drained(client_t *c, void *arg) {
+  stopper_t *st = arg;
+  return __atomic_load_n(&st->done, __ATOMIC_ACQUIRE) && c->fd < 0;
+}
+
+static void run_phase(const phase_t *phase) {
+  agx_replay_config_t config = {
+      .rate = phase->rate,
+      .malformed_percent = phase->malformed_percent,
+      .fragment_percent = phase->fragment_percent,
+      .disconnect_ms = phase->disconnect_ms,
+      .ping_interval_ms = 1000,
+      .ping_timeout_ms = 1000,
+      .seed = 0xa6c0 + phase->rate,
+      .binary = phase->binary,
+  };
+  agx_replay_server_t *server = agx_replay_start(&config);
+  if (server == NULL) {
+    printf("FAIL: %s: server did not start\n", phase->name);
+    s_failures++;
+    return;
+  }
+
+  client_t c = {0};
+  struct sockaddr_in *addr = (struct sockaddr_in *)&c.addr;
+  addr->sin_family = AF_INET;
+  addr->sin_port = htons(agx_replay_port(server));
+  addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  c.addr_len = sizeof(*addr);
+  snprintf(c.host, sizeof(c.host), "127.0.0.1:%u", agx_replay_port(server));
+
+  printf("\n%s\n", phase->name);
+  uint64_t start = now_ms();
+  uint64_t cpu_start = thread_cpu_us();
+  client_start(&c);
+  client_poll(&c, start + phase->duration_ms, NULL, NULL);
+  uint64_t elapsed = now_ms() - start;
+
+  // 服务器正常关闭连接，客户端读完已发出的帧
+  stopper_t st = {.server = server};
+  pthread_t stopper;
+  pthread_create(&stopper, NULL, stop_server, &st);
+  client_poll(&c, now_ms() + DRAIN_TIMEOUT_MS, drained, &st);
+  pthread_join(stopper, NULL);
+  uint64_t cpu = thread_cpu_us() - cpu_start;
+  const agx_monitor_reassembly_t r = c.reassembly;
+  client_finish(&c);
+
+  const agx_replay_stats_t *ss = &st.stats;
+  report(&c, &r, elapsed, cpu);
+  printf("  服务器: 发出 %u 帧 (错误 %u, 分片 %u, 二进制 %u), 断开 %u 次 (%u 帧"
+         "只发出一半), 平均 %llu 字节/帧\n",
+         ss->frames_sent, ss->malformed_sent, ss->fragmented, ss->binary_sent,
+         ss->disconnects, ss->frames_cut,
+         ss->frames_sent ? (unsigned long long)ss->bytes_sent / ss->frames_sent
+                         : 0ull);
+
+  CHECK(c.messages > 0, "%s: no data", phase->name);
+  CHECK(c.verified == c.messages, "%s: %u of %u frames not synthetic",
+        phase->name, c.messages - c.verified, c.messages);
+  CHECK(c.mismatches == 0, "%s: %u frames differ from the synthesized values",
+        phase->name, c.mismatches);
+  CHECK(c.out_of_order == 0, "%s: %u frames out of order", phase->name,
+        c.out_of_order);
+  CHECK(ss->ping_timeouts == 0, "%s: %u ping timeouts", phase->name,
+        ss->ping_timeouts);
+  CHECK(r.frames_oversized == 0, "%s: %u oversized messages",
+        phase->name, r.frames_oversized);
+  // 协商在命名空间连上之后，之前已发出的几帧仍是 JSON；不支持时全部是 JSON
+  if (phase->binary != 0) {
+    CHECK(c.records > 0 && c.records == ss->binary_sent - ss->malformed_sent,
+          "%s: %u of %u records received", phase->name, c.records,
+          ss->binary_sent);
+  } else {
+    CHECK(c.records == 0 && ss->binary_sent == 0,
+          "%s: %u records without binary support", phase->name, c.records);
+  }
+  if (phase->exact) {
+    CHECK(c.messages == ss->valid_sent, "%s: received %u of %u frames",
+          phase->name, c.messages, ss->valid_sent);
+    CHECK(c.parse_errors == ss->malformed_sent,
+          "%s: %u parse errors for %u malformed frames", phase->name,
+          c.parse_errors, ss->malformed_sent);
+    CHECK(r.frames_dropped == 0, "%s: %u messages dropped",
+          phase->name, r.frames_dropped);
+    CHECK(r.frames_reassembled >= ss->fragmented,
+          "%s: %u reassembled for %u fragmented", phase->name,
+          r.frames_reassembled, ss->fragmented);
+  }
+  if (phase->disconnect_ms > 0) {
+    CHECK(c.link.stats.reconnects >= 2, "%s: only %u reconnects", phase->name,
+          c.link.stats.reconnects);
+    // 只丢失断开时正在发送的帧
+    uint32_t lost = c.gaps - c.parse_errors;
+    CHECK(lost <= ss->frames_cut + ss->disconnects,
+          "%s: %u frames lost in %u disconnects", phase->name, lost,
+          ss->disconnects);
+  }
+}
+
+static void run_phases(void) {
+  static const phase_t phases[] = {
+      {"10 帧/秒", 10, 0, 0, 0, 2000, true, 0},
+      {"25 帧/秒", 25, 0, 0, 0, 2000, true, 0},
+      {"50 帧/秒", 50, 0, 0, 0, 2000, true, 0},
+      {"100 帧/秒", 100, 0, 0, 0, 2000, true, 0},
+      {"100 帧/秒, 5% 格式错误, 20% 分片", 100, 5, 20, 0, 4000, true, 0},
+      {"50 帧/秒, 每 1.5 秒中途断开", 50, 0, 0, 1500, 6000, false, 0},
+      {"尽快推送", 0, 0, 0, 0, 2000, true, 0},
+      {"100 帧/秒, 二进制记录", 100, 0, 0, 0, 2000, true, 1},
+      {"100 帧/秒, Socket.IO 二进制事件, 5% 格式错误, 20% 分片", 100, 5, 20, 0,
+       4000, true, 2},
+      {"尽快推送, 二进制记录", 0, 0, 0, 0, 2000, true, 1},
+  };
+  for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); i++) {
+    run_phase(&phases[i]);
+  }
+}
+
+/* ============================================================================
+ * 外部服务器
+ * ============================================================================
+ */
+
+static int run_external(const char *target, uint32_t seconds,
+                        const char *record_path) {
+  client_t c = {0};
+  char host[64];
+  const char *colon = strrchr(target, ':');
+  if (colon == NULL || (size_t)(colon - target) >= sizeof(host)) {
+    printf("bad server address: %s\n", target);
+    return 1;
+  }
+  memcpy(host, target, (size_t)(colon - target));
+  host[colon - target] = '\0';
+
+  struct addrinfo hints = {.ai_family = AF_INET, .ai_socktype = SOCK_STREAM};
+  struct addrinfo *info;
+  if (getaddrinfo(host, colon + 1, &hints, &info) != 0) {
+    printf("cannot resolve %s\n", target);
+    return 1;
+  }
+  memcpy(&c.addr, info->ai_addr, info->ai_addrlen);
+  c.addr_len = info->ai_addrlen;
+  freeaddrinfo(info);
+  snprintf(c.host, sizeof(c.host), "%s", target);
+
+  if (record_path != NULL) {
+    c.record = fopen(record_path, "w");
+    if (c.record == NULL) {
+      printf("cannot write %s\n", record_path);
+      return 1;
+    }
+  }
+
+  printf("%s, %u 秒\n", target, seconds);
+  uint64_t start = now_ms();
+  uint64_t cpu_start = thread_cpu_us();
+  client_start(&c);
+  client_poll(&c, start + seconds * 1000ull, NULL, NULL);
+  uint64_t elapsed = now_ms() - start;
+  uint64_t cpu = thread_cpu_us() - cpu_start;
+  const agx_monitor_reassembly_t r = c.reassembly;
+  client_finish(&c);
+  report(&c, &r, elapsed, cpu);
+
+  if (c.record != NULL) {
+    fclose(c.record);
+    printf("  已保存 %u 帧到 %s\n", c.messages, record_path);
+  }
+  return c.messages > 0 ? 0 : 1;
+}
+
+int main(int argc, char **argv) {
+  const char *target = NULL;
+  const char *record_path = NULL;
+  uint32_t seconds = 10;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "c:t:o:")) != -1) {
+    switch (opt) {
+    case 'c':
+      target = optarg;
+      break;
+    case 't':
+      seconds = (uint32_t)atoi(optarg);
+      break;
+    case 'o':
+      record_path = optarg;
+      break;
+    default:
+      printf("usage: %s [-c host:port [-t seconds] [-o record_file]]\n",
+             argv[0]);
+      return 1;
+    }
+  }
+  if (target != NULL) {
+    return run_external(target, seconds, record_path);
+  }
+
+  run_phases();
+  if (s_failures > 0) {
+    printf("\n%d check(s) FAILED\n", s_failures);
+    return 1;
+  }
+  printf("\nOK\n");
+  return 0;
+}
@@ -0,0 +1,703 @@
+/**
+ * @file bench_agx_parser.c
+ * @brief tegrastats_update 流式解析器的正确性、健壮性与耗时
+ *
+ * 1. 文档中的示例帧逐字段检查。
+ * 2. 随机生成帧（成员乱序、随机空白、键名大小写和 \u 转义、未知嵌套成员、
+ *    类型错误的字段、重复键、各种数字写法），期望值按 cJSON 的语义计算
+ *    （数字用 strtod 转换，valueint 饱和截断，重复键取第一个），与解析结果
+ *    逐字节比较。
+ * 3. 错误帧表：非目标事件、结构错误、缺少 cores 数组、嵌套过深等。
+ * 4. 示例帧的每个前缀（放在刚好等长的堆缓冲区中）都必须被拒绝；
+ *    随机字节变异不得崩溃（可用 -DCMAKE_C_FLAGS=-fsanitize=address 构建检查越界）。
+ * 5. 报告每帧解析耗时和吞吐量。
+ */
+
+#include "agx_monitor_parser.h"
+
+#include <limits.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RANDOM_FRAMES 20000
+#define MUTATION_ROUNDS 200000
+#define TIMING_ROUNDS 100000
+#define FRAME_SIZE 16384
+#define MEMBER_SIZE 4096
+#define MAX_MEMBERS 24
+
+static const char GOLDEN[] =
+    "42[\"tegrastats_update\",{\"timestamp\":\"2025-10-03T06:33:49.223455Z\","
+    "\"cpu\":{\"cores\":["
+    "{\"id\":0,\"usage\":3,\"freq\":1574},{\"id\":1,\"usage\":7,\"freq\":1574},"
+    "{\"id\":2,\"usage\":0,\"freq\":1574},{\"id\":3,\"usage\":12,\"freq\":1574},"
+    "{\"id\":4,\"usage\":1,\"freq\":729},{\"id\":5,\"usage\":0,\"freq\":729},"
+    "{\"id\":6,\"usage\":2,\"freq\":729},{\"id\":7,\"usage\":0,\"freq\":729},"
+    "{\"id\":8,\"usage\":4,\"freq\":2201},{\"id\":9,\"usage\":0,\"freq\":2201},"
+    "{\"id\":10,\"usage\":0,\"freq\":2201},{\"id\":11,\"usage\":99,\"freq\":2201}"
+    "]},"
+    "\"memory\":{\"ram\":{\"used\":1997,\"total\":62841,\"unit\":\"MB\"},"
+    "\"swap\":{\"used\":0,\"total\":31421,\"cached\":0,\"unit\":\"MB\"}},"
+    "\"temperature\":{\"cpu\":47.125,\"soc0\":45.0,\"soc1\":46.062,"
+    "\"soc2\":45.562,\"tj\":47.125},"
+    "\"power\":{\"gpu_soc\":{\"current\":2468,\"average\":2468,\"unit\":\"mW\"},"
+    "\"cpu_cv\":{\"current\":246,\"average\":246,\"unit\":\"mW\"},"
+    "\"sys_5v\":{\"current\":3383,\"average\":3383,\"unit\":\"mW\"},"
+    "\"ram\":{\"current\":512,\"average\":62841,\"unit\":\"mW\"},"
+    "\"swap\":{\"current\":12,\"average\":11,\"unit\":\"mW\"}},"
+    "\"gpu\":{\"gr3d_freq\":0}}]";
+
+static uint32_t s_rng = 0x12345678;
+
+static uint32_t rng(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+static int chance(int percent) { return (int)(rng() % 100) < percent; }
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// ==================== cJSON 语义参考 ====================
+
+static int cjson_valueint(double value) {
+  if (value >= INT_MAX) {
+    return INT_MAX;
+  }
+  if (value <= (double)INT_MIN) {
+    return INT_MIN;
+  }
+  return (int)value;
+}
+
+// ==================== 随机帧生成 ====================
+
+typedef struct {
+  int count;
+  char text[MAX_MEMBERS][MEMBER_SIZE];
+  int dup_count;
+  char dups[MAX_MEMBERS][MEMBER_SIZE];
+} members_t;
+
+static int s_overflow; // 生成的文本超出缓冲区，该帧需要重新生成
+
+static void append(char *buf, size_t size, const char *fmt, ...) {
+  size_t len = strlen(buf);
+  va_list args;
+  va_start(args, fmt);
+  if (vsnprintf(buf + len, size - len, fmt, args) >= (int)(size - len)) {
+    s_overflow = 1;
+  }
+  va_end(args);
+}
+
+static const char *ws(void) {
+  static const char *const options[] = {"", "", "", " ", "\n  ", "\t", "\r\n"};
+  return options[rng() % 7];
+}
+
+/* 键名：随机大小写和 \u 转义（cJSON 按不区分大小写匹配解码后的键） */
+static void mangle_key(char *out, size_t size, const char *key) {
+  out[0] = '\0';
+  for (const char *p = key; *p; p++) {
+    char ch = *p;
+    if (ch >= 'a' && ch <= 'z' && chance(10)) {
+      ch = (char)(ch - 'a' + 'A');
+    }
+    if (chance(5)) {
+      append(out, size, "\\u%04X", (unsigned char)ch);
+    } else {
+      append(out, size, "%c", ch);
+    }
+  }
+}
+
+static void add_member(members_t *m, int duplicate, const char *key,
+                       const char *value) {
+  char mangled[128];
+  mangle_key(mangled, sizeof(mangled), key);
+  char *text = duplicate ? m->dups[m->dup_count++] : m->text[m->count++];
+  text[0] = '\0';
+  append(text, MEMBER_SIZE, "\"%s\"%s:%s%s", mangled, ws(), ws(), value);
+}
+
+static void random_value(char *out, size_t size, int depth);
+
+/* 任意类型的随机值（用于未知成员和类型错误的字段） */
+static void random_value(char *out, size_t size, int depth) {
+  out[0] = '\0';
+  switch (rng() % (depth < 3 ? 8 : 6)) {
+  case 0:
+    append(out, size, "\"s\\\"tr\\\\\\/\\b\\f\\n\\r\\t\\u00e9\\uD83D\\uDE00\"");
+    break;
+  case 1:
+    append(out, size, "%d", (int)(rng() % 2000) - 1000);
+    break;
+  case 2:
+    append(out, size, "-%u.%ue-%u", rng() % 100, rng() % 1000, rng() % 5);
+    break;
+  case 3:
+    append(out, size, "true");
+    break;
+  case 4:
+    append(out, size, "false");
+    break;
+  case 5:
+    append(out, size, "null");
+    break;
+  case 6: {
+    int n = (int)(rng() % 4);
+    append(out, size, "[%s", ws());
+    for (int i = 0; i < n; i++) {
+      char item[1024];
+      random_value(item, sizeof(item), depth + 1);
+      append(out, size, "%s%s%s%s", i ? "," : "", ws(), item, ws());
+    }
+    append(out, size, "]");
+    break;
+  }
+  default: {
+    int n = (int)(rng() % 4);
+    append(out, size, "{%s", ws());
+    for (int i = 0; i < n; i++) {
+      char item[1024];
+      random_value(item, sizeof(item), depth + 1);
+      append(out, size, "%s\"k%d\"%s:%s%s", i ? "," : "", i, ws(), ws(),
+             item);
+    }
+    append(out, size, "}");
+    break;
+  }
+  }
+}
+
+static void wrong_type_value(char *out, size_t size) {
+  do {
+    random_value(out, size, 0);
+  } while (out[0] == '-' || (out[0] >= '0' && out[0] <= '9') ||
+           out[0] == '"');
+}
+
+/* 整数字段的随机写法，返回 cJSON 的 valueint */
+static int int_text(char *out, size_t size, int value) {
+  switch (rng() % 8) {
+  case 0:
+    snprintf(out, size, "%d.%u", value, rng() % 100);
+    break;
+  case 1:
+    snprintf(out, size, "%de0", value);
+    break;
+  case 2:
+    snprintf(out, size, "%.4fE+1", value / 10.0);
+    break;
+  case 3:
+    snprintf(out, size, "%d", value - 70000);
+    break;
+  case 4:
+    snprintf(out, size, "%.1f", value + 0.5);
+    break;
+  case 5:
+    snprintf(out, size, "%d000000000000", value);
+    break;
+  default:
+    snprintf(out, size, "%d", value);
+    break;
+  }
+  return cjson_valueint(strtod(out, NULL));
+}
+
+static float float_text(char *out, size_t size) {
+  switch (rng() % 4) {
+  case 0:
+    snprintf(out, size, "%d", (int)(rng() % 120));
+    break;
+  case 1:
+    snprintf(out, size, "%.6g", (rng() % 1200000) / 10000.0);
+    break;
+  case 2:
+    snprintf(out, size, "%ue-%u", rng() % 100000, rng() % 6);
+    break;
+  default:
+    snprintf(out, size, "%u.%03u", rng() % 120, rng() % 1000);
+    break;
+  }
+  return (float)strtod(out, NULL);
+}
+
+/* 字符串字段：可能超长或带转义，返回按 strncpy 截断后的期望值 */
+static void string_text(char *out, size_t size, char *expected,
+                        size_t expected_size, const char *base) {
+  out[0] = '\0';
+  append(out, size, "\"");
+  for (const char *p = base; *p; p++) {
+    if (*p == '/' && chance(50)) {
+      append(out, size, "\\/");
+    } else if (chance(5)) {
+      append(out, size, "\\u%04x", (unsigned char)*p);
+    } else {
+      append(out, size, "%c", *p);
+    }
+  }
+  append(out, size, "\"");
+  memset(expected, 0, expected_size);
+  for (size_t i = 0; i + 1 < expected_size && base[i] != '\0'; i++) {
+    expected[i] = base[i];
+  }
+}
+
+/* 可能出现的一个数字成员：缺失、类型错误或数字，可能跟一个重复键 */
+static void number_member(members_t *m, const char *key, int *out_int,
+                          float *out_float, int value) {
+  char text[256];
+  if (!chance(90)) {
+    return;
+  }
+  if (chance(5)) {
+    wrong_type_value(text, sizeof(text));
+    add_member(m, 0, key, text);
+  } else if (out_float) {
+    *out_float = float_text(text, sizeof(text));
+    add_member(m, 0, key, text);
+  } else {
+    *out_int = int_text(text, sizeof(text), value);
+    add_member(m, 0, key, text);
+  }
+  if (chance(5)) {
+    snprintf(text, sizeof(text), "%d", value + 1);
+    add_member(m, 1, key, text);
+  }
+}
+
+static void add_unknown_members(members_t *m) {
+  while (chance(15) && m->count < MAX_MEMBERS - 8) {
+    char key[32];
+    char value[MEMBER_SIZE / 2];
+    snprintf(key, sizeof(key), "extra_%u", rng() % 100);
+    random_value(value, sizeof(value), 0);
+    add_member(m, 0, key, value);
+  }
+}
+
+static void emit_object(char *out, size_t size, members_t *m) {
+  int order[MAX_MEMBERS];
+  add_unknown_members(m);
+  for (int i = 0; i < m->count; i++) {
+    order[i] = i;
+  }
+  for (int i = m->count - 1; i > 0; i--) {
+    int j = (int)(rng() % (uint32_t)(i + 1));
+    int tmp = order[i];
+    order[i] = order[j];
+    order[j] = tmp;
+  }
+  out[0] = '\0';
+  append(out, size, "{%s", ws());
+  int n = 0;
+  for (int i = 0; i < m->count; i++, n++) {
+    append(out, size, "%s%s%s%s", n ? "," : "", ws(), m->text[order[i]],
+           ws());
+  }
+  for (int i = 0; i < m->dup_count; i++, n++) {
+    append(out, size, "%s%s%s%s", n ? "," : "", ws(), m->dups[i], ws());
+  }
+  append(out, size, "}");
+}
+
+static void gen_cpu(char *out, size_t size, agx_monitor_data_t *expected) {
+  static members_t core;
+  static members_t cpu;
+  char cores[MEMBER_SIZE] = "[";
+  int count = (int)(rng() % 21);
+  for (int i = 0; i < count; i++) {
+    char item[512];
+    agx_cpu_core_t value = {0};
+    if (chance(3)) {
+      wrong_type_value(item, sizeof(item));
+    } else {
+      int id = 0, usage = 0, freq = 0;
+      memset(&core, 0, sizeof(core));
+      number_member(&core, "id", &id, NULL, i);
+      number_member(&core, "usage", &usage, NULL, (int)(rng() % 101));
+      number_member(&core, "freq", &freq, NULL, (int)(rng() % 3000));
+      emit_object(item, sizeof(item), &core);
+      value.id = (uint8_t)id;
+      value.usage = (uint8_t)usage;
+      value.freq = (uint16_t)freq;
+    }
+    if (i < AGX_MONITOR_MAX_CPU_CORES) {
+      expected->cpu.cores[i] = value;
+    }
+    append(cores, sizeof(cores), "%s%s%s", i ? "," : "", ws(), item);
+  }
+  append(cores, sizeof(cores), "%s]", ws());
+  expected->cpu.core_count =
+      (uint8_t)(count < AGX_MONITOR_MAX_CPU_CORES ? count
+                                                  : AGX_MONITOR_MAX_CPU_CORES);
+
+  memset(&cpu, 0, sizeof(cpu));
+  add_member(&cpu, 0, "cores", cores);
+  emit_object(out, size, &cpu);
+}
+
+static void gen_memory_info(char *out, size_t size, agx_memory_info_t *info,
+                            int with_cached) {
+  members_t *m = calloc(1, sizeof(members_t));
+  int used = 0, total = 0, cached = 0;
+  number_member(m, "used", &used, NULL, (int)(rng() % 65536));
+  number_member(m, "total", &total, NULL, 62841);
+  number_member(m, "cached", &cached, NULL, (int)(rng() % 1000));
+  info->used = (uint32_t)used;
+  info->total = (uint32_t)total;
+  info->cached = with_cached ? (uint32_t)cached : 0;
+  if (chance(90)) {
+    char text[64];
+    string_text(text, sizeof(text), info->unit, sizeof(info->unit),
+                chance(80) ? "MB" : "MBytes");
+    add_member(m, 0, "unit", text);
+  }
+  emit_object(out, size, m);
+  free(m);
+}
+
+static void gen_power_info(char *out, size_t size, agx_power_info_t *info,
+                           int average_limit) {
+  members_t *m = calloc(1, sizeof(members_t));
+  int current = 0, average = 0;
+  bool has_average;
+  number_member(m, "current", &current, NULL, (int)(rng() % 20000));
+  average = INT_MIN;
+  number_member(m, "average", &average, NULL,
+                chance(20) ? 62841 : (int)(rng() % 20000));
+  has_average = average != INT_MIN;
+  info->current = (uint32_t)current;
+  if (has_average) {
+    info->average = (average_limit > 0 && average > average_limit)
+                        ? info->current
+                        : (uint32_t)average;
+  }
+  if (chance(90)) {
+    char text[64];
+    string_text(text, sizeof(text), info->unit, sizeof(info->unit), "mW");
+    add_member(m, 0, "unit", text);
+  }
+  emit_object(out, size, m);
+  free(m);
+}
+
+/* 生成一帧有效的随机帧，同时给出期望的解析结果 */
+static size_t gen_frame(char *frame, size_t size, agx_monitor_data_t *expected,
+                        uint32_t *expected_parsed) {
+  members_t *root = calloc(1, sizeof(members_t));
+  members_t *section = calloc(1, sizeof(members_t));
+  char *value = malloc(MEMBER_SIZE);
+  memset(expected, 0, sizeof(*expected));
+  *expected_parsed = 0;
+
+  if (chance(90)) {
+    string_text(value, MEMBER_SIZE, expected->timestamp,
+                sizeof(expected->timestamp),
+                chance(80) ? "2025-10-03T06:33:49.223455Z"
+                           : "2025/10/03 06:33:49.223455 +0000 (UTC)");
+    add_member(root, 0, "timestamp", value);
+    *expected_parsed |= AGX_MONITOR_PARSED_TIMESTAMP;
+  }
+  if (chance(90)) {
+    gen_cpu(value, MEMBER_SIZE, expected);
+    add_member(root, 0, "cpu", value);
+    *expected_parsed |= AGX_MONITOR_PARSED_CPU;
+  }
+  if (chance(90)) {
+    char sub[MEMBER_SIZE];
+    memset(section, 0, sizeof(*section));
+    if (chance(90)) {
+      gen_memory_info(sub, sizeof(sub), &expected->memory.ram, 0);
+      add_member(section, 0, "ram", sub);
+    }
+    if (chance(90)) {
+      gen_memory_info(sub, sizeof(sub), &expected->memory.swap, 1);
+      add_member(section, 0, "swap", sub);
+    }
+    emit_object(value, MEMBER_SIZE, section);
+    add_member(root, 0, "memory", value);
+    *expected_parsed |= AGX_MONITOR_PARSED_MEMORY;
+  }
+  if (chance(90)) {
+    static const char *const names[] = {"cpu", "soc0", "soc1", "soc2", "tj"};
+    float *targets[] = {&expected->temperature.cpu, &expected->temperature.soc0,
+                        &expected->temperature.soc1, &expected->temperature.soc2,
+                        &expected->temperature.tj};
+    memset(section, 0, sizeof(*section));
+    for (int i = 0; i < 5; i++) {
+      float before = -1000.0f;
+      *targets[i] = before;
+      number_member(section, names[i], NULL, targets[i], 0);
+      if (*targets[i] == before) {
+        *targets[i] = 0.0f;
+      } else if (i == 0) {
+        *expected_parsed |= AGX_MONITOR_PARSED_CPU_TEMP;
+      }
+    }
+    emit_object(value, MEMBER_SIZE, section);
+    add_member(root, 0, "temperature", value);
+    *expected_parsed |= AGX_MONITOR_PARSED_TEMPERATURE;
+  }
+  if (chance(90)) {
+    static const char *const names[] = {"gpu_soc", "cpu_cv", "sys_5v", "ram",
+                                        "swap"};
+    static const int limits[] = {0, 0, 0, 50000, 30000};
+    agx_power_info_t *targets[] = {
+        &expected->power.gpu_soc, &expected->power.cpu_cv,
+        &expected->power.sys_5v, &expected->power.ram, &expected->power.swap};
+    memset(section, 0, sizeof(*section));
+    for (int i = 0; i < 5; i++) {
+      if (chance(90)) {
+        char sub[MEMBER_SIZE];
+        gen_power_info(sub, sizeof(sub), targets[i], limits[i]);
+        add_member(section, 0, names[i], sub);
+      }
+    }
+    emit_object(value, MEMBER_SIZE, section);
+    add_member(root, 0, "power", value);
+    *expected_parsed |= AGX_MONITOR_PARSED_POWER;
+  }
+  if (chance(90)) {
+    int freq = 0;
+    memset(section, 0, sizeof(*section));
+    number_member(section, "gr3d_freq", &freq, NULL, (int)(rng() % 100));
+    expected->gpu.gr3d_freq = (uint8_t)freq;
+    emit_object(value, MEMBER_SIZE, section);
+    add_member(root, 0, "gpu", value);
+    *expected_parsed |= AGX_MONITOR_PARSED_GPU;
+  }
+
+  char *object = malloc(FRAME_SIZE);
+  emit_object(object, FRAME_SIZE, root);
+  frame[0] = '\0';
+  append(frame, size, "42[%s\"tegrastats_update\"%s,%s%s%s%s]%s", ws(),
+           ws(), ws(), object, ws(), chance(10) ? ",{\"extra\":[1,2]}" : "",
+           chance(10) ? "\n" : "");
+  free(object);
+  free(value);
+  free(section);
+  free(root);
+  return strlen(frame);
+}
+
+// ==================== 检查 ====================
+
+static int check_golden(void) {
+  agx_monitor_data_t data;
+  uint32_t parsed = 0;
+  esp_err_t ret = agx_monitor_parse_frame(GOLDEN, sizeof(GOLDEN) - 1, &data,
+                                          &parsed);
+  int failed = 0;
+#define EXPECT(cond)                                                           \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("golden: %s failed\n", #cond);                                    \
+      failed = 1;                                                              \
+    }                                                                          \
+  } while (0)
+  EXPECT(ret == ESP_OK);
+  EXPECT(parsed == 0x7F);
+  EXPECT(strcmp(data.timestamp, "2025-10-03T06:33:49.223455Z") == 0);
+  EXPECT(data.cpu.core_count == 12);
+  EXPECT(data.cpu.cores[3].id == 3 && data.cpu.cores[3].usage == 12 &&
+         data.cpu.cores[3].freq == 1574);
+  EXPECT(data.cpu.cores[11].usage == 99 && data.cpu.cores[11].freq == 2201);
+  EXPECT(data.memory.ram.used == 1997 && data.memory.ram.total == 62841);
+  EXPECT(strcmp(data.memory.ram.unit, "MB") == 0);
+  EXPECT(data.memory.swap.total == 31421 && data.memory.swap.cached == 0);
+  EXPECT(data.temperature.cpu == 47.125f && data.temperature.soc1 == 46.062f);
+  EXPECT(data.temperature.soc2 == 45.562f && data.temperature.tj == 47.125f);
+  EXPECT(data.power.gpu_soc.current == 2468 && data.power.sys_5v.average == 3383);
+  EXPECT(strcmp(data.power.cpu_cv.unit, "mW") == 0);
+  // RAM average 62841 是服务器把内存大小填进了功率字段，用 current 代替
+  EXPECT(data.power.ram.current == 512 && data.power.ram.average == 512);
+  EXPECT(data.power.swap.average == 11);
+  EXPECT(data.gpu.gr3d_freq == 0);
+#undef EXPECT
+  return failed;
+}
+
+static int check_random(size_t *total_bytes) {
+  static char frame[FRAME_SIZE];
+  agx_monitor_data_t expected;
+  agx_monitor_data_t data;
+  *total_bytes = 0;
+  for (int i = 0; i < RANDOM_FRAMES; i++) {
+    uint32_t expected_parsed;
+    uint32_t parsed;
+    size_t len;
+    do {
+      s_overflow = 0;
+      len = gen_frame(frame, sizeof(frame), &expected, &expected_parsed);
+    } while (s_overflow);
+    *total_bytes += len;
+    memset(&data, 0xA5, sizeof(data));
+    esp_err_t ret = agx_monitor_parse_frame(frame, len, &data, &parsed);
+    if (ret != ESP_OK || parsed != expected_parsed ||
+        memcmp(&data, &expected, sizeof(data)) != 0) {
+      printf("random frame %d mismatch (ret=0x%x parsed=0x%x/0x%x):\n%s\n", i,
+             ret, (unsigned)parsed, (unsigned)expected_parsed, frame);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static int check_errors(void) {
+  static const struct {
+    const char *frame;
+    esp_err_t expected;
+  } cases[] = {
+      {"40", ESP_ERR_NOT_FOUND},
+      {"3", ESP_ERR_NOT_FOUND},
+      {"42", ESP_ERR_NOT_FOUND},
+      {"42[\"other_event\",{}]", ESP_ERR_NOT_FOUND},
+      {"42[\"tegrastats_update_v2\",{}]", ESP_ERR_NOT_FOUND},
+      {"42[1,{}]", ESP_ERR_NOT_FOUND},
+      {"42[\"tegrastats_update\"]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",[]]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{}", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"cpu\":{}}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"cpu\":5}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"cpu\":{\"cores\":{},\"cores\":[]}}]",
+       ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":1,}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":[1,]}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\" 1}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{a:1}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":-}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":1e}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":+1}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":0x10}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":tru}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":\"\\q\"}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":\"\\uDC00\"}]",
+       ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":\"\\uD800x\"}]",
+       ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":\"abc}]", ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":[[[[[[[[[[[[[[[[[]]]]]]]]]]]]]]]]]}]",
+       ESP_ERR_INVALID_RESPONSE},
+      {"42[\"tegrastats_update\",{\"a\":[[[[[[[[[[[[[[]]]]]]]]]]]]]]}]",
+       ESP_OK},
+      {"42[\"tegrastats_update\",{}]trailing", ESP_OK},
+      {"42/agx,[\"tegrastats_update\",{}]", ESP_OK},
+      {"4217[\"tegrastats_update\",{}]", ESP_OK},
+      {"42[\"tegrastats_update\",{\"cpu\":{\"cores\":[]}}]", ESP_OK},
+      {"42[\"tegra\\u0073tats_update\",{}]", ESP_OK},
+  };
+  int failed = 0;
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    agx_monitor_data_t data;
+    esp_err_t ret = agx_monitor_parse_frame(cases[i].frame,
+                                            strlen(cases[i].frame), &data, NULL);
+    if (ret != cases[i].expected) {
+      printf("error case %zu: got 0x%x, expected 0x%x: %s\n", i, ret,
+             cases[i].expected, cases[i].frame);
+      failed = 1;
+    }
+  }
+
+  // 数字转换：负数截断、饱和、-0 和指数
+  agx_monitor_data_t data;
+  const char *numbers =
+      "42[\"tegrastats_update\",{\"gpu\":{\"gr3d_freq\":-.5e1},"
+      "\"temperature\":{\"cpu\":-0,\"soc0\":1.e1,\"soc1\":125e-3,"
+      "\"soc2\":0.0000000000000000000000000123456789e25},"
+      "\"memory\":{\"ram\":{\"used\":1e40,\"total\":-1e40}}}]";
+  if (agx_monitor_parse_frame(numbers, strlen(numbers), &data, NULL) !=
+          ESP_OK ||
+      data.gpu.gr3d_freq != (uint8_t)-5 ||
+      memcmp(&data.temperature.cpu, &(float){-0.0f}, sizeof(float)) != 0 ||
+      data.temperature.soc0 != 10.0f || data.temperature.soc1 != 0.125f ||
+      data.temperature.soc2 != (float)strtod("0.0000000000000000000000000123456789e25", NULL) ||
+      data.memory.ram.used != (uint32_t)INT_MAX ||
+      data.memory.ram.total != (uint32_t)INT_MIN) {
+    printf("number conversion mismatch\n");
+    failed = 1;
+  }
+  return failed;
+}
+
+static int check_truncation(void) {
+  size_t len = sizeof(GOLDEN) - 1;
+  for (size_t n = 0; n < len; n++) {
+    char *copy = malloc(n ? n : 1);
+    memcpy(copy, GOLDEN, n);
+    agx_monitor_data_t data;
+    esp_err_t ret = agx_monitor_parse_frame(copy, n, &data, NULL);
+    free(copy);
+    if (ret == ESP_OK) {
+      printf("truncated frame (%zu of %zu bytes) accepted\n", n, len);
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static void fuzz_mutations(int *accepted, int *rejected) {
+  size_t len = sizeof(GOLDEN) - 1;
+  static const char alphabet[] = "{}[]\",:\\u0123456789-+.eEtrfalsn \x01\xff";
+  *accepted = 0;
+  *rejected = 0;
+  for (int i = 0; i < MUTATION_ROUNDS; i++) {
+    size_t n = len - (rng() % 4 == 0 ? rng() % len : 0);
+    char *copy = malloc(n ? n : 1);
+    memcpy(copy, GOLDEN, n);
+    int flips = 1 + (int)(rng() % 4);
+    for (int f = 0; f < flips && n > 0; f++) {
+      copy[rng() % n] = alphabet[rng() % (sizeof(alphabet) - 1)];
+    }
+    agx_monitor_data_t data;
+    esp_err_t ret = agx_monitor_parse_frame(copy, n, &data, NULL);
+    free(copy);
+    if (ret == ESP_OK) {
+      (*accepted)++;
+    } else {
+      (*rejected)++;
+    }
+  }
+}
+
+int main(void) {
+  int failed = 0;
+
+  failed |= check_golden();
+  failed |= check_errors();
+  failed |= check_truncation();
+
+  size_t random_bytes = 0;
+  failed |= check_random(&random_bytes);
+  printf("random frames: %d (avg %zu bytes) checked against cJSON semantics\n",
+         RANDOM_FRAMES, random_bytes / RANDOM_FRAMES);
+
+  int accepted, rejected;
+  fuzz_mutations(&accepted, &rejected);
+  printf("mutations: %d accepted, %d rejected, no crash\n", accepted, rejected);
+
+  agx_monitor_data_t data;
+  size_t len = sizeof(GOLDEN) - 1;
+  double start = now_ns();
+  for (int i = 0; i < TIMING_ROUNDS; i++) {
+    agx_monitor_parse_frame(GOLDEN, len, &data, NULL);
+  }
+  double ns = (now_ns() - start) / TIMING_ROUNDS;
+  printf("golden frame (%zu bytes, 12 cores): %.0f ns/frame, %.0f MB/s, "
+         "0 heap allocations\n",
+         len, ns, len / ns * 1e3);
+
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
@@ -0,0 +1,432 @@
+/**
+ * @file bench_agx_reassembly.c
+ * @brief WebSocket 消息重组的正确性与耗时
+ *
+ * 1. 随机消息（长度 1 ~ 6000 字节）随机拆成若干 WebSocket 帧，每帧再按随机
+ *    偏移拆成若干数据事件，中间穿插 ping/pong 控制帧。不超过缓冲区的消息必须
+ *    逐字节还原；单个事件送达的消息必须原地交出（不复制）；分片送达且超过
+ *    缓冲区的消息必须计入 oversized。
+ * 2. 每条分片消息随机丢掉一个数据事件：该消息计入 dropped 且不交出，
+ *    之后的消息不受影响。
+ * 3. 缓冲池耗尽、断线重置、孤立的续帧。
+ * 4. 按 1460 字节（TCP MSS）拆开的 tegrastats_update 帧，重组后交给流式
+ *    解析器必须解析成功；逐个事件直接解析（原来的行为）则全部失败。
+ * 5. 报告每个数据事件的处理耗时。
+ */
+
+#include "agx_monitor_parser.h"
+#include "agx_monitor_reassembly.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BUFFER_SIZE 4096
+#define BUFFER_COUNT 2
+#define MAX_MESSAGE 6000
+#define MAX_CHUNKS 64
+#define RANDOM_MESSAGES 20000
+#define TIMING_ROUNDS 200000
+#define TCP_MSS 1460
+
+static uint32_t s_rng = 0x2468ace1;
+
+static uint32_t rng(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+static int chance(int percent) { return (int)(rng() % 100) < percent; }
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* ============================================================================
+ * 消息拆分
+ * ============================================================================
+ */
+
+typedef struct {
+  agx_ws_chunk_t chunks[MAX_CHUNKS];
+  int frame_of[MAX_CHUNKS];     // 事件所属的帧序号
+  int frame_chunks[MAX_CHUNKS]; // 每帧的事件数
+  int count;
+} split_t;
+
+/**
+ * @brief 把 len 字节的消息拆成最多 frames 帧，每帧最多 pieces 个事件
+ */
+static void split_message(const char *msg, size_t len, int frames, int pieces,
+                          split_t *out) {
+  out->count = 0;
+  size_t pos = 0;
+  for (int f = 0; f < frames && pos < len; f++) {
+    size_t frame_len = (f == frames - 1) ? len - pos : 1 + rng() % (len - pos);
+    int last = pos + frame_len == len;
+    out->frame_chunks[f] = 0;
+    size_t off = 0;
+    for (int p = 0; p < pieces && off < frame_len; p++) {
+      size_t n = (p == pieces - 1) ? frame_len - off
+                                   : 1 + rng() % (frame_len - off);
+      agx_ws_chunk_t *c = &out->chunks[out->count];
+      c->data = msg + pos + off;
+      c->len = n;
+      c->opcode = f == 0 ? AGX_WS_OPCODE_TEXT : AGX_WS_OPCODE_CONTINUATION;
+      c->fin = last;
+      c->payload_len = frame_len;
+      c->payload_offset = off;
+      out->frame_of[out->count++] = f;
+      out->frame_chunks[f]++;
+      off += n;
+    }
+    pos += frame_len;
+    if (last) {
+      break;
+    }
+  }
+}
+
+static void fill_random(char *buf, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    buf[i] = (char)(32 + rng() % 95);
+  }
+}
+
+/* ============================================================================
+ * 检查
+ * ============================================================================
+ */
+
+static int check_random(void) {
+  static char msg[MAX_MESSAGE];
+  static const char ping[] = "ping";
+  agx_monitor_reassembly_t r;
+  split_t sp;
+  uint32_t exp_reassembled = 0, exp_oversized = 0, delivered = 0;
+
+  agx_monitor_reassembly_init(&r, BUFFER_SIZE, BUFFER_COUNT);
+  for (int m = 0; m < RANDOM_MESSAGES; m++) {
+    size_t len = 1 + rng() % MAX_MESSAGE;
+    fill_random(msg, len);
+    int single = chance(30);
+    split_message(msg, len, single ? 1 : 1 + (int)(rng() % 4),
+                  single ? 1 : 1 + (int)(rng() % 6), &sp);
+
+    int out_count = 0;
+    agx_ws_message_t out = {0};
+    esp_err_t last_ret = ESP_OK;
+    for (int i = 0; i < sp.count; i++) {
+      if (chance(5)) {
+        agx_ws_chunk_t ctl = {ping, sizeof(ping) - 1, AGX_WS_OPCODE_PING, true,
+                              sizeof(ping) - 1, 0};
+        agx_ws_message_t pm;
+        if (agx_monitor_reassembly_feed(&r, &ctl, &pm) != ESP_OK ||
+            pm.data != ping || pm.buffer != -1) {
+          printf("random: control frame not passed through\n");
+          return 1;
+        }
+      }
+      agx_ws_message_t tmp;
+      esp_err_t ret = agx_monitor_reassembly_feed(&r, &sp.chunks[i], &tmp);
+      if (ret == ESP_OK) {
+        out = tmp;
+        out_count++;
+      } else if (ret != ESP_ERR_NOT_FINISHED) {
+        last_ret = ret;
+      }
+    }
+
+    if (sp.count == 1) {
+      // 单个事件：原地交出，长度不受缓冲区限制
+      if (out_count != 1 || out.data != msg || out.len != len ||
+          out.buffer != -1) {
+        printf("random: single-chunk message %d not passed in place\n", m);
+        return 1;
+      }
+    } else if (len > BUFFER_SIZE) {
+      exp_oversized++;
+      if (out_count != 0 || last_ret != ESP_ERR_INVALID_SIZE) {
+        printf("random: oversized message %d (%zu bytes) not rejected\n", m,
+               len);
+        return 1;
+      }
+    } else {
+      exp_reassembled++;
+      if (out_count != 1 || out.len != len || memcmp(out.data, msg, len) ||
+          out.buffer < 0 || out.opcode != AGX_WS_OPCODE_TEXT) {
+        printf("random: message %d (%zu bytes, %d chunks) corrupted\n", m, len,
+               sp.count);
+        return 1;
+      }
+    }
+    if (out_count) {
+      delivered++;
+      agx_monitor_reassembly_release(&r, &out);
+    }
+  }
+
+  int failed = r.frames_reassembled != exp_reassembled ||
+               r.frames_oversized != exp_oversized || r.frames_dropped != 0 ||
+               r.free_mask != (1U << BUFFER_COUNT) - 1;
+  printf("random messages: %d, delivered %u, reassembled %u, oversized %u, "
+         "dropped %u\n",
+         RANDOM_MESSAGES, delivered, r.frames_reassembled, r.frames_oversized,
+         r.frames_dropped);
+  agx_monitor_reassembly_deinit(&r);
+  return failed;
+}
+
+static int check_loss(void) {
+  static char msg[BUFFER_SIZE];
+  static char next[64];
+  agx_monitor_reassembly_t r;
+  split_t sp;
+  int rounds = 0;
+
+  agx_monitor_reassembly_init(&r, BUFFER_SIZE, BUFFER_COUNT);
+  for (int m = 0; m < RANDOM_MESSAGES; m++) {
+    size_t len = 2 + rng() % (BUFFER_SIZE - 1);
+    fill_random(msg, len);
+    split_message(msg, len, 1 + (int)(rng() % 4), 2 + (int)(rng() % 5), &sp);
+
+    // 只丢多事件帧中的事件：整帧丢失在 WebSocket 层无法察觉
+    int candidates[MAX_CHUNKS], n = 0;
+    for (int i = 0; i < sp.count; i++) {
+      if (sp.frame_chunks[sp.frame_of[i]] > 1) {
+        candidates[n++] = i;
+      }
+    }
+    if (n == 0) {
+      continue;
+    }
+    int lost = candidates[rng() % n];
+    uint32_t dropped_before = r.frames_dropped;
+
+    for (int i = 0; i < sp.count; i++) {
+      agx_ws_message_t out;
+      if (i != lost && agx_monitor_reassembly_feed(&r, &sp.chunks[i], &out) ==
+                           ESP_OK) {
+        printf("loss: message %d delivered without chunk %d/%d\n", m, lost,
+               sp.count);
+        return 1;
+      }
+    }
+
+    // 紧接着的一条完整消息必须正常交出
+    fill_random(next, sizeof(next));
+    agx_ws_chunk_t c = {next, sizeof(next), AGX_WS_OPCODE_TEXT, true,
+                        sizeof(next), 0};
+    agx_ws_message_t out;
+    if (agx_monitor_reassembly_feed(&r, &c, &out) != ESP_OK ||
+        out.data != next) {
+      printf("loss: message after loss %d not delivered\n", m);
+      return 1;
+    }
+    if (r.frames_dropped != dropped_before + 1) {
+      printf("loss: message %d counted %u drops\n", m,
+             r.frames_dropped - dropped_before);
+      return 1;
+    }
+    rounds++;
+  }
+
+  int failed = r.frames_reassembled != 0 || r.frames_oversized != 0 ||
+               r.free_mask != (1U << BUFFER_COUNT) - 1;
+  printf("lost chunks: %d messages dropped, following message intact\n",
+         rounds);
+  agx_monitor_reassembly_deinit(&r);
+  return failed;
+}
+
+static int check_edge_cases(void) {
+  static const char text[] = "0123456789abcdef";
+  agx_monitor_reassembly_t r;
+  agx_ws_message_t held[BUFFER_COUNT + 1], out;
+  int failed = 0;
+
+  if (agx_monitor_reassembly_init(&r, 16, 0) != ESP_ERR_INVALID_ARG ||
+      agx_monitor_reassembly_init(&r, 16,
+                                  AGX_MONITOR_REASSEMBLY_MAX_BUFFERS + 1) !=
+          ESP_ERR_INVALID_ARG) {
+    printf("edge: invalid pool size accepted\n");
+    failed = 1;
+  }
+
+  agx_monitor_reassembly_init(&r, BUFFER_SIZE, BUFFER_COUNT);
+
+  // 缓冲池耗尽：持有全部已完成消息，下一条分片消息被丢弃
+  agx_ws_chunk_t head = {text, 8, AGX_WS_OPCODE_TEXT, true, 16, 0};
+  agx_ws_chunk_t tail = {text + 8, 8, AGX_WS_OPCODE_TEXT, true, 16, 8};
+  for (int i = 0; i < BUFFER_COUNT; i++) {
+    agx_monitor_reassembly_feed(&r, &head, &held[i]);
+    if (agx_monitor_reassembly_feed(&r, &tail, &held[i]) != ESP_OK ||
+        held[i].buffer != i || memcmp(held[i].data, text, 16)) {
+      printf("edge: message %d not assembled into buffer %d\n", i, i);
+      failed = 1;
+    }
+  }
+  if (agx_monitor_reassembly_feed(&r, &head, &out) != ESP_ERR_NO_MEM ||
+      agx_monitor_reassembly_feed(&r, &tail, &out) != ESP_ERR_NOT_FINISHED ||
+      r.frames_dropped != 1) {
+    printf("edge: pool exhaustion not reported\n");
+    failed = 1;
+  }
+  agx_monitor_reassembly_release(&r, &held[0]);
+  agx_monitor_reassembly_feed(&r, &head, &out);
+  if (agx_monitor_reassembly_feed(&r, &tail, &out) != ESP_OK ||
+      out.buffer != 0) {
+    printf("edge: released buffer not reused\n");
+    failed = 1;
+  }
+  agx_monitor_reassembly_release(&r, &out);
+  agx_monitor_reassembly_release(&r, &held[1]);
+
+  // 断线重置：半条消息计入 dropped，之后从新消息开始
+  agx_monitor_reassembly_feed(&r, &head, &out);
+  agx_monitor_reassembly_reset(&r);
+  if (r.frames_dropped != 2 || r.free_mask != (1U << BUFFER_COUNT) - 1 ||
+      agx_monitor_reassembly_feed(&r, &tail, &out) != ESP_ERR_INVALID_STATE) {
+    printf("edge: reset mid-message not handled\n");
+    failed = 1;
+  }
+
+  // 孤立的续帧（丢失了消息开头）
+  agx_ws_chunk_t orphan = {text, 16, AGX_WS_OPCODE_CONTINUATION, true, 16, 0};
+  if (agx_monitor_reassembly_feed(&r, &orphan, &out) != ESP_ERR_INVALID_STATE ||
+      r.frames_dropped != 4) {
+    printf("edge: orphan continuation accepted\n");
+    failed = 1;
+  }
+
+  // 分片消息在后续帧中才超过缓冲区
+  agx_monitor_reassembly_t small;
+  agx_monitor_reassembly_init(&small, 16, 1);
+  agx_ws_chunk_t first = {text, 10, AGX_WS_OPCODE_TEXT, false, 10, 0};
+  agx_ws_chunk_t cont = {text, 10, AGX_WS_OPCODE_CONTINUATION, true, 10, 0};
+  agx_ws_chunk_t whole = {text, 4, AGX_WS_OPCODE_TEXT, true, 4, 0};
+  if (agx_monitor_reassembly_feed(&small, &first, &out) !=
+          ESP_ERR_NOT_FINISHED ||
+      agx_monitor_reassembly_feed(&small, &cont, &out) !=
+          ESP_ERR_INVALID_SIZE ||
+      small.frames_oversized != 1 || small.free_mask != 1 ||
+      agx_monitor_reassembly_feed(&small, &whole, &out) != ESP_OK) {
+    printf("edge: fragmented oversized message not rejected\n");
+    failed = 1;
+  }
+  agx_monitor_reassembly_deinit(&small);
+
+  agx_monitor_reassembly_deinit(&r);
+  printf("edge cases: %s\n", failed ? "FAILED" : "ok");
+  return failed;
+}
+
+static size_t build_tegrastats(char *frame, size_t size) {
+  size_t len = (size_t)snprintf(frame, size,
+                                "42[\"tegrastats_update\",{\"timestamp\":"
+                                "\"2025-10-03T06:33:49.223455Z\",\"cpu\":{"
+                                "\"cores\":[");
+  for (int i = 0; i < 12; i++) {
+    len += (size_t)snprintf(frame + len, size - len,
+                            "%s{\"id\":%d,\"usage\":%d,\"freq\":%d}",
+                            i ? "," : "", i, i * 7 % 100, 729 + i * 131);
+  }
+  len += (size_t)snprintf(
+      frame + len, size - len,
+      "]},\"memory\":{\"ram\":{\"used\":1997,\"total\":62841,\"unit\":\"MB\"},"
+      "\"swap\":{\"used\":0,\"total\":31421,\"cached\":0,\"unit\":\"MB\"}},"
+      "\"temperature\":{\"cpu\":47.125,\"soc0\":45.0,\"soc1\":46.062,"
+      "\"soc2\":45.562,\"tj\":47.125},\"gpu\":{\"gr3d_freq\":0},"
+      "\"padding\":\"");
+  // 填充到三个 TCP 分段
+  while (len < 2 * TCP_MSS + 400 && len + 1 < size) {
+    frame[len++] = 'x';
+  }
+  len += (size_t)snprintf(frame + len, size - len, "\"}]");
+  return len;
+}
+
+static int check_tegrastats(void) {
+  static char frame[BUFFER_SIZE];
+  agx_monitor_reassembly_t r;
+  agx_monitor_data_t data;
+  size_t len = build_tegrastats(frame, sizeof(frame));
+  int chunk_ok = 0, chunks = 0, parsed = 0;
+
+  agx_monitor_reassembly_init(&r, BUFFER_SIZE, BUFFER_COUNT);
+  for (size_t off = 0; off < len; off += TCP_MSS) {
+    size_t n = len - off < TCP_MSS ? len - off : TCP_MSS;
+    agx_ws_chunk_t c = {frame + off, n, AGX_WS_OPCODE_TEXT, true, len, off};
+    agx_ws_message_t out;
+
+    // 原来的行为：每个事件当作完整消息解析
+    chunks++;
+    if (agx_monitor_parse_frame(c.data, c.len, &data, NULL) == ESP_OK) {
+      chunk_ok++;
+    }
+    if (agx_monitor_reassembly_feed(&r, &c, &out) == ESP_OK) {
+      uint32_t bits = 0;
+      if (agx_monitor_parse_frame(out.data, out.len, &data, &bits) == ESP_OK &&
+          data.cpu.core_count == 12 && (bits & AGX_MONITOR_PARSED_CPU_TEMP)) {
+        parsed++;
+      }
+      agx_monitor_reassembly_release(&r, &out);
+    }
+  }
+  agx_monitor_reassembly_deinit(&r);
+
+  printf("tegrastats frame (%zu bytes) in %d TCP segments: per-chunk parse %d "
+         "ok, reassembled parse %s\n",
+         len, chunks, chunk_ok, parsed == 1 ? "ok" : "FAILED");
+  return parsed != 1 || chunk_ok != 0;
+}
+
+static void timing(void) {
+  static char msg[BUFFER_SIZE];
+  agx_monitor_reassembly_t r;
+  agx_ws_message_t out;
+  fill_random(msg, sizeof(msg));
+  agx_monitor_reassembly_init(&r, BUFFER_SIZE, BUFFER_COUNT);
+
+  agx_ws_chunk_t whole = {msg, 1200, AGX_WS_OPCODE_TEXT, true, 1200, 0};
+  double start = now_ns();
+  for (int i = 0; i < TIMING_ROUNDS; i++) {
+    agx_monitor_reassembly_feed(&r, &whole, &out);
+    agx_monitor_reassembly_release(&r, &out);
+  }
+  double in_place = (now_ns() - start) / TIMING_ROUNDS;
+
+  agx_ws_chunk_t a = {msg, TCP_MSS, AGX_WS_OPCODE_TEXT, true, 2 * TCP_MSS, 0};
+  agx_ws_chunk_t b = {msg + TCP_MSS, TCP_MSS, AGX_WS_OPCODE_TEXT, true,
+                      2 * TCP_MSS, TCP_MSS};
+  start = now_ns();
+  for (int i = 0; i < TIMING_ROUNDS; i++) {
+    agx_monitor_reassembly_feed(&r, &a, &out);
+    agx_monitor_reassembly_feed(&r, &b, &out);
+    agx_monitor_reassembly_release(&r, &out);
+  }
+  double joined = (now_ns() - start) / TIMING_ROUNDS;
+  agx_monitor_reassembly_deinit(&r);
+
+  printf("single chunk: %.0f ns/message (in place), 2 x %d bytes: %.0f "
+         "ns/message, 0 heap allocations per message\n",
+         in_place, TCP_MSS, joined);
+}
+
+int main(void) {
+  int failed = 0;
+
+  failed |= check_edge_cases();
+  failed |= check_random();
+  failed |= check_loss();
+  failed |= check_tegrastats();
+  timing();
+
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
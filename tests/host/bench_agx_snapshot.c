@@ -0,0 +1,162 @@
+/**
+ * @file bench_agx_snapshot.c
+ * @brief AGX 数据无锁快照发布的一致性与读取延迟
+ *
+ * 1. 一个写线程不停发布（每次发布把整个结构填成同一个字节，模拟解析），
+ *    多个读线程同时读取，检查每份拷贝都来自同一次发布（没有撕裂），
+ *    代数单调不减。
+ * 2. 写线程每次"解析"耗时 PARSE_US 微秒，比较读取等待超过 PARSE_US / 2 的
+ *    比例：快照读取与原来的互斥锁方式（写线程在锁内解析）。
+ */
+
+#include "agx_monitor_snapshot.h"
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define READERS 3
+#define RUN_MS 1000
+#define PARSE_US 200
+
+#define PATTERN_BYTES offsetof(agx_monitor_data_t, generation)
+
+static agx_monitor_snapshot_t s_snapshot;
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+static agx_monitor_data_t s_locked_data;
+static volatile int s_stop;
+static int s_use_mutex;
+static int s_parse_us;
+
+typedef struct {
+  unsigned long reads;
+  unsigned long torn;
+  unsigned long backwards;
+  unsigned long slow; // 等待超过 PARSE_US / 2 的读取
+} reader_result_t;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void spin_us(int us) {
+  double end = now_ns() + us * 1e3;
+  while (now_ns() < end) {
+  }
+}
+
+static void *writer(void *arg) {
+  uint32_t value = 0;
+  while (!s_stop) {
+    value++;
+    if (s_use_mutex) {
+      // 原来的方式：在锁内解析
+      pthread_mutex_lock(&s_mutex);
+      memset(&s_locked_data, (int)(value & 0xff), PATTERN_BYTES);
+      spin_us(s_parse_us);
+      s_locked_data.generation = value;
+      pthread_mutex_unlock(&s_mutex);
+    } else {
+      agx_monitor_data_t *back =
+          agx_monitor_snapshot_begin(&s_snapshot, false);
+      uint32_t next = agx_monitor_snapshot_generation(&s_snapshot) + 1;
+      memset(back, (int)(next & 0xff), PATTERN_BYTES);
+      spin_us(s_parse_us);
+      agx_monitor_snapshot_publish(&s_snapshot);
+    }
+  }
+  return arg;
+}
+
+static void *reader(void *arg) {
+  reader_result_t *result = arg;
+  agx_monitor_data_t copy;
+  uint32_t last = 0;
+
+  while (!s_stop) {
+    double start = now_ns();
+    uint32_t generation;
+    if (s_use_mutex) {
+      pthread_mutex_lock(&s_mutex);
+      memcpy(&copy, &s_locked_data, sizeof(copy));
+      pthread_mutex_unlock(&s_mutex);
+      generation = copy.generation;
+    } else {
+      generation = agx_monitor_snapshot_read(&s_snapshot, &copy);
+    }
+    if (now_ns() - start > PARSE_US * 500.0) {
+      result->slow++;
+    }
+
+    const uint8_t *bytes = (const uint8_t *)&copy;
+    for (size_t i = 0; i < PATTERN_BYTES; i++) {
+      if (bytes[i] != (uint8_t)generation) {
+        result->torn++;
+        break;
+      }
+    }
+    if (copy.generation != generation || generation < last) {
+      result->backwards++;
+    }
+    last = generation;
+    result->reads++;
+  }
+  return NULL;
+}
+
+static int run(const char *name, int use_mutex, int parse_us) {
+  pthread_t w, r[READERS];
+  reader_result_t results[READERS];
+
+  agx_monitor_snapshot_init(&s_snapshot);
+  memset(&s_locked_data, 0, sizeof(s_locked_data));
+  memset(results, 0, sizeof(results));
+  s_use_mutex = use_mutex;
+  s_parse_us = parse_us;
+  s_stop = 0;
+
+  pthread_create(&w, NULL, writer, NULL);
+  for (int i = 0; i < READERS; i++) {
+    pthread_create(&r[i], NULL, reader, &results[i]);
+  }
+  spin_us(RUN_MS * 1000);
+  s_stop = 1;
+  pthread_join(w, NULL);
+  for (int i = 0; i < READERS; i++) {
+    pthread_join(r[i], NULL);
+  }
+
+  unsigned long reads = 0, torn = 0, backwards = 0, slow = 0;
+  for (int i = 0; i < READERS; i++) {
+    reads += results[i].reads;
+    torn += results[i].torn;
+    backwards += results[i].backwards;
+    slow += results[i].slow;
+  }
+  uint32_t generation = use_mutex
+                            ? s_locked_data.generation
+                            : agx_monitor_snapshot_generation(&s_snapshot);
+  printf("%-26s %7u publications, %8lu reads, %lu retried, torn %lu, "
+         "out of order %lu, waited > %d us: %.3f%%\n",
+         name, generation, reads,
+         use_mutex ? 0UL : (unsigned long)s_snapshot.retries, torn, backwards,
+         PARSE_US / 2, reads ? 100.0 * slow / reads : 0.0);
+  return torn != 0 || backwards != 0;
+}
+
+int main(void) {
+  int failed = 0;
+
+  printf("agx_monitor_data_t: %zu bytes, %d readers, %d ms per run\n",
+         sizeof(agx_monitor_data_t), READERS, RUN_MS);
+  failed |= run("snapshot, no parse delay", 0, 0);
+  failed |= run("snapshot, 200 us parse", 0, PARSE_US);
+  failed |= run("mutex, 200 us parse", 1, PARSE_US);
+
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
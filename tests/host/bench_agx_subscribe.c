@@ -0,0 +1,456 @@
+/**
+ * @file bench_agx_subscribe.c
+ * @brief AGX 变化订阅的正确性、唤醒次数与耗时
+ *
+ * 1. 随机订阅（CHANGE/THRESHOLD、随机通道、死区、保活间隔）在一天的模拟
+ *    1 Hz 数据（含断线失效）上运行，每次回调的触发通道、阈值状态和有效
+ *    标志都与不用变化掩码、逐通道判断的参考实现比较。
+ * 2. 典型订阅（风扇：CPU 温度 0.5 °C；LED：5V 功耗超过 15 W，回差 1 W；
+ *    console_core 温度转交：0.1 °C + 5 s 保活）一小时的回调次数，与每帧
+ *    都回调的原方式比较。
+ * 3. 参数错误、槽位用尽、取消订阅。
+ * 4. 8 个订阅者时每帧的处理耗时。
+ */
+
+#include "agx_monitor_subscribe.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DAY_SECONDS (24 * 3600)
+#define CORES 12
+
+static int s_failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("FAIL: " __VA_ARGS__);                                            \
+      printf("\n");                                                            \
+      s_failures++;                                                            \
+    }                                                                          \
+  } while (0)
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int32_t walk(int32_t v, int step, int32_t lo, int32_t hi) {
+  v += rand() % (2 * step + 1) - step;
+  return v < lo ? lo : v > hi ? hi : v;
+}
+
+static void init_values(int32_t *v) {
+  memset(v, 0, AGX_HISTORY_CHANNELS * sizeof(int32_t));
+  for (int ch = AGX_HISTORY_CH_TEMP_CPU; ch <= AGX_HISTORY_CH_TEMP_TJ; ch++) {
+    v[ch] = 4500 + ch * 10;
+  }
+  v[AGX_HISTORY_CH_POWER_GPU_SOC] = 8000;
+  v[AGX_HISTORY_CH_POWER_CPU_CV] = 3000;
+  v[AGX_HISTORY_CH_POWER_SYS_5V] = 14000;
+  v[AGX_HISTORY_CH_RAM_USED] = 12000;
+}
+
+/** 下一秒的 tegrastats 数据：与 bench_agx_history 相同的随机游走 */
+static void next_values(int32_t *v) {
+  for (int c = 0; c < CORES; c++) {
+    v[c] = rand() % 4 ? walk(v[c], 3, 0, 100) : v[c];
+  }
+  for (int ch = AGX_HISTORY_CH_TEMP_CPU; ch <= AGX_HISTORY_CH_TEMP_TJ; ch++) {
+    v[ch] = rand() % 8 ? v[ch] : walk(v[ch], 25, 3000, 9000);
+  }
+  for (int ch = AGX_HISTORY_CH_POWER_GPU_SOC; ch <= AGX_HISTORY_CH_POWER_SYS_5V;
+       ch++) {
+    v[ch] = walk(v[ch], 40, 500, 40000);
+  }
+  v[AGX_HISTORY_CH_GPU_LOAD] = walk(v[AGX_HISTORY_CH_GPU_LOAD], 10, 0, 99);
+  if (rand() % 30 == 0) {
+    v[AGX_HISTORY_CH_RAM_USED] =
+        walk(v[AGX_HISTORY_CH_RAM_USED], 50, 2000, 60000);
+  }
+}
+
+/* ============================================================================
+ * 参考实现：每帧逐通道判断，不用变化掩码
+ * ============================================================================
+ */
+
+typedef struct {
+  agx_subscription_t sub;
+  int32_t delivered[AGX_HISTORY_CHANNELS];
+  uint32_t above;
+  uint64_t notified_ms;
+  bool primed;
+} ref_sub_t;
+
+typedef struct {
+  bool called;
+  uint32_t changed;
+  uint32_t above;
+  uint32_t generation;
+  bool valid;
+  int32_t temp_cpu;
+} record_t;
+
+static bool ref_update(ref_sub_t *r, const int32_t *v, uint64_t now,
+                       record_t *out) {
+  uint32_t fired = 0;
+  bool keep_alive = r->sub.max_interval_ms > 0 &&
+                    now - r->notified_ms >= r->sub.max_interval_ms;
+
+  for (int ch = 0; ch < AGX_HISTORY_CHANNELS; ch++) {
+    uint32_t bit = AGX_SUBSCRIBE_CHANNEL(ch);
+    if (!(r->sub.channels & bit)) {
+      continue;
+    }
+    if (!r->primed) {
+      r->delivered[ch] = v[ch];
+      r->above = v[ch] >= r->sub.threshold ? r->above | bit : r->above & ~bit;
+      fired |= bit;
+    } else if (r->sub.trigger == AGX_SUBSCRIBE_CHANGE) {
+      int64_t d = (int64_t)v[ch] - r->delivered[ch];
+      if (d != 0 && (d >= r->sub.deadband || -d >= r->sub.deadband)) {
+        r->delivered[ch] = v[ch];
+        fired |= bit;
+      }
+    } else if ((r->above & bit) &&
+               (int64_t)v[ch] < (int64_t)r->sub.threshold - r->sub.deadband) {
+      r->above &= ~bit;
+      fired |= bit;
+    } else if (!(r->above & bit) && v[ch] >= r->sub.threshold) {
+      r->above |= bit;
+      fired |= bit;
+    }
+  }
+  r->primed = true;
+
+  if (fired == 0 && !keep_alive) {
+    return false;
+  }
+  r->notified_ms = now;
+  out->changed = fired;
+  out->above = r->sub.trigger == AGX_SUBSCRIBE_THRESHOLD ? r->above : 0;
+  out->valid = true;
+  return true;
+}
+
+static bool ref_invalidate(ref_sub_t *r, uint64_t now, record_t *out) {
+  if (!r->primed) {
+    return false;
+  }
+  r->primed = false;
+  r->above = 0;
+  r->notified_ms = now;
+  out->changed = 0;
+  out->above = 0;
+  out->valid = false;
+  return true;
+}
+
+/* ============================================================================
+ * 正确性
+ * ============================================================================
+ */
+
+static void record_callback(const agx_monitor_notification_t *n,
+                            void *user_data) {
+  record_t *r = user_data;
+  CHECK(!r->called, "subscriber called twice for one update");
+  r->called = true;
+  r->changed = n->changed;
+  r->above = n->above;
+  r->generation = n->generation;
+  r->valid = n->valid;
+  r->temp_cpu = n->values[AGX_HISTORY_CH_TEMP_CPU];
+}
+
+static agx_subscription_t random_subscription(void) {
+  agx_subscription_t sub = {0};
+  static const uint32_t groups[] = {
+      AGX_SUBSCRIBE_CPU_USAGE, AGX_SUBSCRIBE_TEMPERATURES, AGX_SUBSCRIBE_POWER,
+      AGX_SUBSCRIBE_CHANNEL(AGX_HISTORY_CH_GPU_LOAD) |
+          AGX_SUBSCRIBE_CHANNEL(AGX_HISTORY_CH_RAM_USED)};
+
+  do {
+    sub.channels = (uint32_t)rand() & groups[rand() % 4];
+  } while (sub.channels == 0);
+  sub.trigger = rand() % 2 ? AGX_SUBSCRIBE_THRESHOLD : AGX_SUBSCRIBE_CHANGE;
+  sub.deadband = rand() % 3 == 0 ? 0 : rand() % 200;
+  sub.threshold = rand() % 3 == 0 ? 50 : rand() % 3 == 0 ? 4600 : 14000;
+  sub.max_interval_ms = rand() % 3 == 0 ? 1000u * (1 + rand() % 10) : 0;
+  return sub;
+}
+
+static void test_against_reference(void) {
+  agx_monitor_subscribers_t set;
+  ref_sub_t ref[AGX_SUBSCRIBE_MAX_SUBSCRIBERS];
+  record_t got[AGX_SUBSCRIBE_MAX_SUBSCRIBERS];
+  int32_t v[AGX_HISTORY_CHANNELS], prev[AGX_HISTORY_CHANNELS];
+  int handle;
+  uint32_t generation = 0, calls = 0, updates = 0;
+
+  srand(42);
+  agx_monitor_subscribers_init(&set);
+  memset(ref, 0, sizeof(ref));
+  for (int i = 0; i < AGX_SUBSCRIBE_MAX_SUBSCRIBERS; i++) {
+    ref[i].sub = random_subscription();
+    CHECK(agx_monitor_subscribers_add(&set, &ref[i].sub, record_callback,
+                                      &got[i], &handle) == ESP_OK &&
+              handle == i,
+          "add %d", i);
+  }
+
+  init_values(v);
+  memset(prev, 0, sizeof(prev));
+  for (uint64_t t = 1; t <= DAY_SECONDS; t++) {
+    uint64_t now = t * 1000 + rand() % 50;
+    memset(got, 0, sizeof(got));
+    generation++;
+
+    if (rand() % 5000 == 0) {
+      // 断线：数据失效，重连后通常要几秒
+      agx_monitor_subscribers_invalidate(&set, generation, now);
+      for (int i = 0; i < AGX_SUBSCRIBE_MAX_SUBSCRIBERS; i++) {
+        record_t want = {0};
+        bool call = ref_invalidate(&ref[i], now, &want);
+        calls += call;
+        CHECK(got[i].called == call && (!call || !got[i].valid),
+              "invalidate %d at %llu", i, (unsigned long long)t);
+      }
+      t += rand() % 20;
+      continue;
+    }
+
+    next_values(v);
+    uint32_t changed =
+        agx_monitor_subscribers_update(&set, v, generation, now);
+    updates++;
+
+    uint32_t want_changed = 0;
+    for (int ch = 0; ch < AGX_HISTORY_CHANNELS; ch++) {
+      want_changed |= v[ch] != prev[ch] ? AGX_SUBSCRIBE_CHANNEL(ch) : 0;
+    }
+    CHECK(changed == want_changed, "changed mask 0x%x, expected 0x%x",
+          changed, want_changed);
+    memcpy(prev, v, sizeof(v));
+
+    for (int i = 0; i < AGX_SUBSCRIBE_MAX_SUBSCRIBERS; i++) {
+      record_t want = {0};
+      bool call = ref_update(&ref[i], v, now, &want);
+      calls += call;
+      CHECK(got[i].called == call, "subscriber %d at %llu: called %d, want %d",
+            i, (unsigned long long)t, got[i].called, call);
+      if (call && got[i].called) {
+        CHECK(got[i].changed == want.changed && got[i].above == want.above &&
+                  got[i].valid && got[i].generation == generation &&
+                  got[i].temp_cpu == v[AGX_HISTORY_CH_TEMP_CPU],
+              "subscriber %d at %llu: changed 0x%x/0x%x above 0x%x/0x%x", i,
+              (unsigned long long)t, got[i].changed, want.changed,
+              got[i].above, want.above);
+      }
+    }
+  }
+
+  CHECK(set.notifications == calls, "notification counter %u, expected %u",
+        set.notifications, calls);
+  printf("Reference: %u updates x %d random subscribers, %u callbacks, "
+         "%u skipped by mask\n",
+         updates, AGX_SUBSCRIBE_MAX_SUBSCRIBERS, calls, set.skipped);
+}
+
+/* ============================================================================
+ * 唤醒次数
+ * ============================================================================
+ */
+
+typedef struct {
+  const char *name;
+  agx_subscription_t sub;
+  uint32_t calls;
+} typical_t;
+
+static void count_callback(const agx_monitor_notification_t *n,
+                           void *user_data) {
+  ((typical_t *)user_data)->calls++;
+}
+
+static void test_wakeups(void) {
+  typical_t typical[] = {
+      {.name = "fan: temp_cpu 0.5 C",
+       .sub = {.channels = AGX_SUBSCRIBE_CHANNEL(AGX_HISTORY_CH_TEMP_CPU),
+               .trigger = AGX_SUBSCRIBE_CHANGE,
+               .deadband = 50}},
+      {.name = "console: temp_cpu 0.1 C, 5 s",
+       .sub = {.channels = AGX_SUBSCRIBE_CHANNEL(AGX_HISTORY_CH_TEMP_CPU),
+               .trigger = AGX_SUBSCRIBE_CHANGE,
+               .deadband = 10,
+               .max_interval_ms = 5000}},
+      {.name = "led: sys_5v > 15 W",
+       .sub = {.channels = AGX_SUBSCRIBE_CHANNEL(AGX_HISTORY_CH_POWER_SYS_5V),
+               .trigger = AGX_SUBSCRIBE_THRESHOLD,
+               .deadband = 1000,
+               .threshold = 15000}},
+      {.name = "led: any temperature 1 C",
+       .sub = {.channels = AGX_SUBSCRIBE_TEMPERATURES,
+               .trigger = AGX_SUBSCRIBE_CHANGE,
+               .deadband = 100}},
+  };
+  const int n = sizeof(typical) / sizeof(typical[0]);
+  const uint32_t seconds = 3600;
+  agx_monitor_subscribers_t set;
+  int32_t v[AGX_HISTORY_CHANNELS];
+  int handle;
+
+  srand(7);
+  agx_monitor_subscribers_init(&set);
+  for (int i = 0; i < n; i++) {
+    agx_monitor_subscribers_add(&set, &typical[i].sub, count_callback,
+                                &typical[i], &handle);
+  }
+  init_values(v);
+  for (uint32_t t = 1; t <= seconds; t++) {
+    next_values(v);
+    agx_monitor_subscribers_update(&set, v, t, (uint64_t)t * 1000);
+  }
+
+  printf("\nOne hour at 1 Hz (%u updates; every update was a callback "
+         "before):\n",
+         seconds);
+  for (int i = 0; i < n; i++) {
+    printf("  %-30s %5u callbacks (%.1f%%)\n", typical[i].name,
+           typical[i].calls, 100.0 * typical[i].calls / seconds);
+    CHECK(typical[i].calls < seconds / 2, "%s: too many callbacks",
+          typical[i].name);
+  }
+  CHECK(typical[1].calls >= seconds / 5, "keep-alive missing");
+}
+
+/* ============================================================================
+ * 接口
+ * ============================================================================
+ */
+
+static void test_api(void) {
+  agx_monitor_subscribers_t set;
+  typical_t counter = {0};
+  agx_subscription_t sub = {
+      .channels = AGX_SUBSCRIBE_CHANNEL(AGX_HISTORY_CH_GPU_LOAD),
+      .trigger = AGX_SUBSCRIBE_CHANGE,
+  };
+  int handle = -1;
+  int32_t v[AGX_HISTORY_CHANNELS] = {0};
+
+  agx_monitor_subscribers_init(&set);
+  agx_subscription_t bad = sub;
+  bad.channels = 0;
+  CHECK(agx_monitor_subscribers_add(&set, &bad, count_callback, &counter,
+                                    &handle) == ESP_ERR_INVALID_ARG,
+        "empty channel mask accepted");
+  bad = sub;
+  bad.channels = 1UL << AGX_HISTORY_CHANNELS;
+  CHECK(agx_monitor_subscribers_add(&set, &bad, count_callback, &counter,
+                                    &handle) == ESP_ERR_INVALID_ARG,
+        "unknown channel accepted");
+  bad = sub;
+  bad.deadband = -1;
+  CHECK(agx_monitor_subscribers_add(&set, &bad, count_callback, &counter,
+                                    &handle) == ESP_ERR_INVALID_ARG,
+        "negative deadband accepted");
+  CHECK(agx_monitor_subscribers_add(&set, &sub, NULL, &counter, &handle) ==
+            ESP_ERR_INVALID_ARG,
+        "NULL callback accepted");
+
+  for (int i = 0; i < AGX_SUBSCRIBE_MAX_SUBSCRIBERS; i++) {
+    CHECK(agx_monitor_subscribers_add(&set, &sub, count_callback, &counter,
+                                      &handle) == ESP_OK,
+          "slot %d", i);
+  }
+  CHECK(agx_monitor_subscribers_add(&set, &sub, count_callback, &counter,
+                                    &handle) == ESP_ERR_NO_MEM,
+        "more subscribers than slots");
+  CHECK(agx_monitor_subscribers_remove(&set, 3) == ESP_OK &&
+            agx_monitor_subscribers_remove(&set, 3) == ESP_ERR_NOT_FOUND &&
+            agx_monitor_subscribers_remove(&set, -1) == ESP_ERR_NOT_FOUND &&
+            agx_monitor_subscribers_remove(
+                &set, AGX_SUBSCRIBE_MAX_SUBSCRIBERS) == ESP_ERR_NOT_FOUND,
+        "remove");
+  CHECK(agx_monitor_subscribers_add(&set, &sub, count_callback, &counter,
+                                    &handle) == ESP_OK &&
+            handle == 3,
+        "freed slot not reused");
+
+  // 第一帧通知所有订阅者；值不变时不再回调；失效只通知已收到数据的订阅者
+  agx_monitor_subscribers_update(&set, v, 1, 1000);
+  CHECK(counter.calls == AGX_SUBSCRIBE_MAX_SUBSCRIBERS, "first update %u",
+        counter.calls);
+  agx_monitor_subscribers_update(&set, v, 2, 2000);
+  CHECK(counter.calls == AGX_SUBSCRIBE_MAX_SUBSCRIBERS &&
+            set.skipped == AGX_SUBSCRIBE_MAX_SUBSCRIBERS,
+        "unchanged update woke subscribers");
+  agx_monitor_subscribers_invalidate(&set, 3, 3000);
+  agx_monitor_subscribers_invalidate(&set, 4, 3000);
+  CHECK(counter.calls == 2 * AGX_SUBSCRIBE_MAX_SUBSCRIBERS,
+        "invalidate %u", counter.calls);
+  agx_monitor_subscribers_update(&set, v, 5, 4000);
+  CHECK(counter.calls == 3 * AGX_SUBSCRIBE_MAX_SUBSCRIBERS,
+        "update after invalidation %u", counter.calls);
+}
+
+/* ============================================================================
+ * 耗时
+ * ============================================================================
+ */
+
+static void noop_callback(const agx_monitor_notification_t *n,
+                          void *user_data) {
+  (void)n;
+  (void)user_data;
+}
+
+static void bench_update(void) {
+  const int updates = 200000;
+  agx_monitor_subscribers_t set;
+  int32_t(*values)[AGX_HISTORY_CHANNELS] =
+      malloc(updates * sizeof(*values));
+  int handle;
+
+  srand(3);
+  agx_monitor_subscribers_init(&set);
+  for (int i = 0; i < AGX_SUBSCRIBE_MAX_SUBSCRIBERS; i++) {
+    agx_subscription_t sub = random_subscription();
+    agx_monitor_subscribers_add(&set, &sub, noop_callback, NULL, &handle);
+  }
+  init_values(values[0]);
+  for (int i = 1; i < updates; i++) {
+    memcpy(values[i], values[i - 1], sizeof(values[i]));
+    next_values(values[i]);
+  }
+
+  double t0 = now_ns();
+  for (int i = 0; i < updates; i++) {
+    agx_monitor_subscribers_update(&set, values[i], i, (uint64_t)i * 1000);
+  }
+  double t1 = now_ns();
+  printf("\nUpdate with %d subscribers: %.0f ns, %.2f callbacks per update\n",
+         AGX_SUBSCRIBE_MAX_SUBSCRIBERS, (t1 - t0) / updates,
+         (double)set.notifications / updates);
+  free(values);
+}
+
+int main(void) {
+  test_against_reference();
+  test_wakeups();
+  test_api();
+  bench_update();
+
+  if (s_failures > 0) {
+    printf("\n%d check(s) FAILED\n", s_failures);
+    return 1;
+  }
+  printf("\nOK\n");
+  return 0;
+}
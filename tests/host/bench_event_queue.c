@@ -0,0 +1,401 @@
+/**
+ * @file bench_event_queue.c
+ * @brief 事件管理器优先级通道：无锁多生产者队列的正确性、溢出策略和耗时
+ *
+ * 1. 单线程：先进先出、数据完整、深度和最高水位，三种溢出策略在队列满时
+ *    的行为（合并时覆盖最新的同 ID 事件，不打乱顺序），参数检查和清零统计。
+ * 2. 4 个生产者线程 + 1 个消费者线程，每种溢出策略各跑一遍：
+ *    - 每个生产者的事件按发送顺序到达，数据未被撕裂；
+ *    - 丢弃最新：取出数 + 丢弃数 = 发送数；
+ *    - 丢弃最旧：取出数 + 丢弃数 = 发送数；
+ *    - 合并：取出数 + 丢弃数 + 合并数 = 发送数；
+ *    - 最高水位不超过容量。
+ * 3. 单线程每个事件的推入 + 取出耗时，与互斥锁保护的环形队列比较。
+ */
+
+#include "event_manager_queue.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PRODUCERS 4
+#define EVENTS_PER_PRODUCER 200000
+#define THREAD_CAPACITY 64
+#define TIMING_EVENTS 5000000
+
+ESP_EVENT_DEFINE_BASE(BENCH_EVENTS);
+ESP_EVENT_DEFINE_BASE(OTHER_EVENTS);
+
+typedef struct {
+  uint32_t producer;
+  uint32_t sequence;
+  uint32_t check;
+} bench_payload_t;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint32_t payload_check(uint32_t producer, uint32_t sequence) {
+  return producer * 2654435761u ^ sequence ^ 0xA5A5A5A5u;
+}
+
+static esp_err_t push_value(event_queue_t *queue, int32_t id, uint32_t value) {
+  bench_payload_t payload = {0, value, payload_check(0, value)};
+  return event_queue_push(queue, BENCH_EVENTS, id, &payload, sizeof(payload));
+}
+
+static uint32_t event_value(const event_queue_event_t *event) {
+  bench_payload_t payload;
+  memcpy(&payload, event->data.bytes, sizeof(payload));
+  return payload.sequence;
+}
+
+/* ============================================================================
+ * 单线程
+ * ============================================================================
+ */
+
+static int check_fifo(void) {
+  event_queue_t queue;
+  event_queue_event_t event;
+  event_manager_lane_stats_t stats;
+  int failed = 0;
+
+  event_queue_init(&queue, 8, EVENT_MANAGER_OVERFLOW_DROP_NEWEST);
+
+  // 绕圈多次，检查序号回绕
+  uint32_t next_out = 0;
+  for (uint32_t i = 0; i < 100; i++) {
+    failed |= push_value(&queue, 1, i) != ESP_OK;
+    if (i % 3 == 2) {
+      failed |= push_value(&queue, 1, ++i) != ESP_OK;
+    }
+    while (event_queue_depth(&queue) > 2) {
+      failed |= event_queue_pop(&queue, &event) != ESP_OK;
+      failed |= event_value(&event) != next_out++;
+    }
+  }
+  while (event_queue_pop(&queue, &event) == ESP_OK) {
+    failed |= event_value(&event) != next_out++;
+    failed |= event.base != BENCH_EVENTS || event.id != 1 ||
+              event.size != sizeof(bench_payload_t);
+  }
+  failed |= next_out != 100;
+
+  // 不带数据的事件，以及最大长度的数据
+  uint8_t big[EVENT_MANAGER_EVENT_DATA_MAX];
+  for (size_t i = 0; i < sizeof(big); i++) {
+    big[i] = (uint8_t)(i * 7);
+  }
+  failed |= event_queue_push(&queue, OTHER_EVENTS, 9, NULL, 0) != ESP_OK;
+  failed |= event_queue_push(&queue, BENCH_EVENTS, 2, big, sizeof(big)) != ESP_OK;
+  failed |= event_queue_pop(&queue, &event) != ESP_OK;
+  failed |= event.base != OTHER_EVENTS || event.id != 9 || event.size != 0;
+  failed |= event_queue_pop(&queue, &event) != ESP_OK;
+  failed |= event.size != sizeof(big) || memcmp(event.data.bytes, big, sizeof(big));
+  failed |= event_queue_pop(&queue, &event) != ESP_ERR_NOT_FOUND;
+
+  // 参数检查
+  uint8_t too_big[EVENT_MANAGER_EVENT_DATA_MAX + 1] = {0};
+  failed |= event_queue_push(&queue, BENCH_EVENTS, 1, too_big, sizeof(too_big)) !=
+            ESP_ERR_INVALID_SIZE;
+  failed |= event_queue_push(&queue, BENCH_EVENTS, 1, NULL, 4) !=
+            ESP_ERR_INVALID_ARG;
+  event_queue_t bad;
+  failed |= event_queue_init(&bad, 6, EVENT_MANAGER_OVERFLOW_DROP_NEWEST) !=
+            ESP_ERR_INVALID_ARG;
+  failed |= event_queue_init(&bad, 1, EVENT_MANAGER_OVERFLOW_DROP_NEWEST) !=
+            ESP_ERR_INVALID_ARG;
+
+  event_queue_get_stats(&queue, &stats);
+  failed |= stats.posted != 102 || stats.delivered != 102 ||
+            stats.dropped != 0 || stats.depth != 0 || stats.high_water != 4;
+
+  event_queue_deinit(&queue);
+  printf("fifo: %u posted, %u delivered, high water %u/%u\n", stats.posted,
+         stats.delivered, stats.high_water, stats.capacity);
+  return failed;
+}
+
+static int check_policies(void) {
+  event_queue_t queue;
+  event_queue_event_t event;
+  event_manager_lane_stats_t stats;
+  int failed = 0;
+
+  // 丢弃最新：第 5 个被拒绝，队列内容不变
+  event_queue_init(&queue, 4, EVENT_MANAGER_OVERFLOW_DROP_NEWEST);
+  for (uint32_t i = 0; i < 5; i++) {
+    failed |= push_value(&queue, 1, i) != (i < 4 ? ESP_OK : ESP_ERR_TIMEOUT);
+  }
+  for (uint32_t i = 0; i < 4; i++) {
+    failed |= event_queue_pop(&queue, &event) != ESP_OK ||
+              event_value(&event) != i;
+  }
+  event_queue_get_stats(&queue, &stats);
+  failed |= stats.dropped != 1 || stats.high_water != 4;
+  event_queue_deinit(&queue);
+
+  // 丢弃最旧：最后 4 个留下
+  event_queue_init(&queue, 4, EVENT_MANAGER_OVERFLOW_DROP_OLDEST);
+  for (uint32_t i = 0; i < 10; i++) {
+    failed |= push_value(&queue, 1, i) != ESP_OK;
+  }
+  for (uint32_t i = 6; i < 10; i++) {
+    failed |= event_queue_pop(&queue, &event) != ESP_OK ||
+              event_value(&event) != i;
+  }
+  event_queue_get_stats(&queue, &stats);
+  failed |= stats.dropped != 6 || stats.posted != 10 || stats.delivered != 4;
+  event_queue_deinit(&queue);
+
+  // 合并：覆盖最新的同 ID 事件；没有同 ID 事件时拒绝
+  event_queue_init(&queue, 4, EVENT_MANAGER_OVERFLOW_COALESCE);
+  failed |= push_value(&queue, 1, 10) != ESP_OK;
+  failed |= push_value(&queue, 2, 20) != ESP_OK;
+  failed |= push_value(&queue, 1, 11) != ESP_OK;
+  failed |= push_value(&queue, 3, 30) != ESP_OK;
+  failed |= push_value(&queue, 1, 12) != ESP_OK; // 覆盖 11，不是 10
+  failed |= push_value(&queue, 1, 13) != ESP_OK; // 覆盖 12
+  failed |= push_value(&queue, 4, 40) != ESP_ERR_TIMEOUT;
+  failed |= event_queue_push(&queue, OTHER_EVENTS, 1, NULL, 0) !=
+            ESP_ERR_TIMEOUT; // ID 相同、base 不同
+  static const struct {
+    int32_t id;
+    uint32_t value;
+  } expected[] = {{1, 10}, {2, 20}, {1, 13}, {3, 30}};
+  for (size_t i = 0; i < 4; i++) {
+    failed |= event_queue_pop(&queue, &event) != ESP_OK ||
+              event.id != expected[i].id ||
+              event_value(&event) != expected[i].value;
+  }
+  event_queue_get_stats(&queue, &stats);
+  failed |= stats.coalesced != 2 || stats.dropped != 2 || stats.posted != 4;
+
+  // 合并后长度变化
+  failed |= push_value(&queue, 5, 1) != ESP_OK;
+  failed |= event_queue_push(&queue, BENCH_EVENTS, 6, NULL, 0) != ESP_OK;
+  failed |= push_value(&queue, 7, 1) != ESP_OK;
+  failed |= push_value(&queue, 8, 1) != ESP_OK;
+  failed |= push_value(&queue, 6, 99) != ESP_OK;
+  failed |= event_queue_pop(&queue, &event) != ESP_OK;
+  failed |= event_queue_pop(&queue, &event) != ESP_OK ||
+            event.size != sizeof(bench_payload_t) || event_value(&event) != 99;
+
+  // 清零统计：最高水位从当前深度重新开始
+  event_queue_reset_stats(&queue);
+  event_queue_get_stats(&queue, &stats);
+  failed |= stats.posted != 0 || stats.coalesced != 0 || stats.dropped != 0 ||
+            stats.depth != 2 || stats.high_water != 2;
+  event_queue_deinit(&queue);
+
+  printf("policies: drop newest, drop oldest and coalesce %s\n",
+         failed ? "FAILED" : "ok");
+  return failed;
+}
+
+/* ============================================================================
+ * 多线程
+ * ============================================================================
+ */
+
+static event_queue_t s_queue;
+static uint32_t s_producers_done;
+static uint32_t s_sent[PRODUCERS];
+
+static void *producer_thread(void *arg) {
+  uint32_t producer = (uint32_t)(uintptr_t)arg;
+  for (uint32_t i = 0; i < EVENTS_PER_PRODUCER; i++) {
+    bench_payload_t payload = {producer, i, payload_check(producer, i)};
+    event_queue_push(&s_queue, BENCH_EVENTS, (int32_t)producer, &payload,
+                     sizeof(payload));
+    if (i % 16 == 0) {
+      sched_yield(); // 单核机器上也让各线程交替运行
+    }
+  }
+  s_sent[producer] = EVENTS_PER_PRODUCER;
+  __atomic_fetch_add(&s_producers_done, 1, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+static int check_threads(event_manager_overflow_t overflow, const char *name) {
+  pthread_t producers[PRODUCERS];
+  int64_t last[PRODUCERS];
+  uint64_t popped = 0;
+  size_t out_of_order = 0;
+  size_t torn = 0;
+  size_t busy = 0;
+  event_queue_event_t event;
+  event_manager_lane_stats_t stats;
+
+  event_queue_init(&s_queue, THREAD_CAPACITY, overflow);
+  s_producers_done = 0;
+  for (uint32_t p = 0; p < PRODUCERS; p++) {
+    last[p] = -1;
+    pthread_create(&producers[p], NULL, producer_thread, (void *)(uintptr_t)p);
+  }
+
+  for (;;) {
+    bool done =
+        __atomic_load_n(&s_producers_done, __ATOMIC_ACQUIRE) == PRODUCERS;
+    esp_err_t ret = event_queue_pop(&s_queue, &event);
+    if (ret == ESP_ERR_NOT_FINISHED) {
+      busy++;
+      sched_yield();
+      continue;
+    }
+    if (ret != ESP_OK) {
+      if (done) {
+        break;
+      }
+      sched_yield();
+      continue;
+    }
+
+    bench_payload_t payload;
+    memcpy(&payload, event.data.bytes, sizeof(payload));
+    if (event.size != sizeof(payload) || payload.producer >= PRODUCERS ||
+        event.id != (int32_t)payload.producer ||
+        payload.check != payload_check(payload.producer, payload.sequence)) {
+      torn++;
+      continue;
+    }
+    // 合并只会把待取事件换成同一生产者更新的值，顺序仍然递增
+    if ((int64_t)payload.sequence <= last[payload.producer]) {
+      out_of_order++;
+    }
+    last[payload.producer] = payload.sequence;
+    popped++;
+
+    if (popped % 2048 == 0) {
+      struct timespec pause = {0, 200000}; // 消费者偶尔停顿，让队列溢出
+      nanosleep(&pause, NULL);
+    }
+  }
+  for (uint32_t p = 0; p < PRODUCERS; p++) {
+    pthread_join(producers[p], NULL);
+  }
+
+  event_queue_get_stats(&s_queue, &stats);
+  uint64_t sent = 0;
+  for (uint32_t p = 0; p < PRODUCERS; p++) {
+    sent += s_sent[p];
+  }
+
+  printf("threads (%s): %llu sent, %llu popped + %u dropped + %u coalesced, "
+         "high water %u/%u, %zu busy retries, %zu out of order, %zu torn\n",
+         name, (unsigned long long)sent, (unsigned long long)popped,
+         stats.dropped, stats.coalesced, stats.high_water, stats.capacity,
+         busy, out_of_order, torn);
+
+  int failed = popped + stats.dropped + stats.coalesced != sent ||
+               stats.delivered != popped || out_of_order > 0 || torn > 0 ||
+               stats.high_water > stats.capacity || stats.depth != 0;
+  if (overflow != EVENT_MANAGER_OVERFLOW_DROP_OLDEST) {
+    failed |= stats.posted != popped; // 丢弃最旧时被挤掉的也算 posted
+  }
+  event_queue_deinit(&s_queue);
+  return failed;
+}
+
+/* ============================================================================
+ * 耗时
+ * ============================================================================
+ */
+
+typedef struct {
+  pthread_mutex_t lock;
+  event_queue_event_t *events;
+  uint32_t capacity;
+  uint32_t head;
+  uint32_t tail;
+} locked_ring_t;
+
+static bool locked_push(locked_ring_t *ring, esp_event_base_t base, int32_t id,
+                        const void *data, size_t size) {
+  bool ok = false;
+  pthread_mutex_lock(&ring->lock);
+  if (ring->head - ring->tail < ring->capacity) {
+    event_queue_event_t *event =
+        &ring->events[ring->head++ & (ring->capacity - 1)];
+    event->base = base;
+    event->id = id;
+    event->size = (uint32_t)size;
+    memcpy(event->data.bytes, data, size);
+    ok = true;
+  }
+  pthread_mutex_unlock(&ring->lock);
+  return ok;
+}
+
+static bool locked_pop(locked_ring_t *ring, event_queue_event_t *event) {
+  bool ok = false;
+  pthread_mutex_lock(&ring->lock);
+  if (ring->head != ring->tail) {
+    const event_queue_event_t *src =
+        &ring->events[ring->tail++ & (ring->capacity - 1)];
+    event->base = src->base;
+    event->id = src->id;
+    event->size = src->size;
+    memcpy(event->data.bytes, src->data.bytes, src->size);
+    ok = true;
+  }
+  pthread_mutex_unlock(&ring->lock);
+  return ok;
+}
+
+static void timing(void) {
+  event_queue_event_t event;
+  bench_payload_t payload = {0, 0, 0};
+  volatile uint32_t sink = 0;
+
+  event_queue_init(&s_queue, 32, EVENT_MANAGER_OVERFLOW_DROP_NEWEST);
+  double start = now_ns();
+  for (uint32_t i = 0; i < TIMING_EVENTS; i++) {
+    payload.sequence = i;
+    event_queue_push(&s_queue, BENCH_EVENTS, 1, &payload, sizeof(payload));
+    event_queue_pop(&s_queue, &event);
+    sink += event.size;
+  }
+  double queue_ns = (now_ns() - start) / TIMING_EVENTS;
+  event_queue_deinit(&s_queue);
+
+  locked_ring_t ring = {.capacity = 32};
+  pthread_mutex_init(&ring.lock, NULL);
+  ring.events = calloc(ring.capacity, sizeof(*ring.events));
+  start = now_ns();
+  for (uint32_t i = 0; i < TIMING_EVENTS; i++) {
+    payload.sequence = i;
+    locked_push(&ring, BENCH_EVENTS, 1, &payload, sizeof(payload));
+    locked_pop(&ring, &event);
+    sink += event.size;
+  }
+  double locked_ns = (now_ns() - start) / TIMING_EVENTS;
+  free(ring.events);
+  pthread_mutex_destroy(&ring.lock);
+
+  printf("timing: push + pop %.1f ns lock-free, %.1f ns with a mutex "
+         "(%zu-byte payload, uncontended)\n",
+         queue_ns, locked_ns, sizeof(payload));
+}
+
+int main(void) {
+  int failed = 0;
+
+  failed |= check_fifo();
+  failed |= check_policies();
+  failed |= check_threads(EVENT_MANAGER_OVERFLOW_DROP_NEWEST, "drop newest");
+  failed |= check_threads(EVENT_MANAGER_OVERFLOW_DROP_OLDEST, "drop oldest");
+  failed |= check_threads(EVENT_MANAGER_OVERFLOW_COALESCE, "coalesce");
+  timing();
+
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
@@ -0,0 +1,476 @@
+/**
+ * @file bench_fan_thermal.c
+ * @brief 风扇控制律的热仿真：曲线模式与预测 PID 对比
+ *
+ * 集总参数热模型：芯片 → 散热器 → 环境，散热器对环境的热导随风量增加；
+ * 风量以一阶滞后跟随 PWM，风扇功耗与风量的三次方成正比。CPU 温度由热区
+ * 传感器（一阶滞后）按 1/32 °C 量化，和功耗、GPU 负载一起每秒上报一次，
+ * 控制器按 fan_controller 任务的 1 秒周期读取上一次上报的数据。
+ *
+ * 1. 控制律检查：积分抗饱和、无扰启动、输出限幅、参数校验，以及曲线的
+ *    回差和最小间隔；查找表与浮点插值逐点比较，并测量两者的每次耗时。
+ * 2. 负载阶跃、周期突发和随机负载三种场景下，分别用 fan config curve 的
+ *    示例曲线（3 °C 回差、2 秒间隔）、不带前馈的 PID 和默认 PID 运行，
+ *    报告峰值温度、平均温度、波动、风扇能耗和转速变化次数；阶跃场景另外
+ *    报告超调和调节时间（进入并保持在最终温度 ±1 °C 内）。
+ */
+
+#include "fan_controller_thermal.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SIM_DT 0.05f       // 仿真步长（秒）
+#define SIM_WARMUP 1800    // 每个场景前以起始负载预热（秒）
+#define CONTROL_PERIOD 1.0 // fan_controller 任务周期（秒）
+
+// 热模型参数
+#define AMBIENT 28.0f      // 环境温度（°C）
+#define C_DIE 60.0f        // 芯片热容（J/K）
+#define R_DIE 0.30f        // 芯片到散热器热阻（K/W）
+#define C_SINK 400.0f      // 散热器热容（J/K）
+#define G_NATURAL 0.3f     // 风扇停转时散热器对环境的热导（W/K）
+#define G_FORCED 3.2f      // 满转时增加的热导（W/K）
+#define TAU_ZONE 2.0f      // 热区传感器滞后（秒）
+#define TAU_FAN 2.0f       // 风量跟随 PWM 的滞后（秒）
+#define FAN_POWER_MAX 4.0f // 满转风扇功耗（W）
+#define SETTLE_BAND 1.0f   // 调节时间的误差带（°C）
+
+// 曲线在 50 W 下稳定在约 70 °C，PID 用同一温度作设定值，以便在相同的稳态
+// 温度下比较超调、调节时间和能耗
+#define PID_SETPOINT 70.0f
+
+static int s_failures;
+
+#define CHECK(cond, ...)                                                       \
+  do {                                                                         \
+    if (!(cond)) {                                                             \
+      printf("FAIL: " __VA_ARGS__);                                            \
+      printf("\n");                                                            \
+      s_failures++;                                                            \
+    }                                                                          \
+  } while (0)
+
+static uint32_t s_rng = 0x13579bdf;
+
+static uint32_t rng(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+static float frand(float lo, float hi) {
+  return lo + (hi - lo) * (float)(rng() % 100001) / 100000.0f;
+}
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* ============================================================================
+ * 控制律检查
+ * ============================================================================
+ */
+
+static void check_pid_law(void) {
+  fan_pid_gains_t gains = fan_pid_get_default_gains();
+  fan_pid_state_t state;
+  fan_pid_feedforward_t ff = {.power_w = 30.0f, .gpu_load = 50.0f};
+
+  // 无扰启动：第一步输出等于复位时的转速
+  fan_pid_reset(&state, 47.0f);
+  float out = fan_pid_step(&gains, &state, gains.setpoint + 1.5f, &ff, 1.0f);
+  CHECK(fabsf(out - 47.0f) < 1e-3f, "bumpless start: %.3f", out);
+
+  // 抗饱和：过热 10 分钟（输出饱和）后降到设定值以下，输出应立即离开上限
+  fan_pid_reset(&state, gains.min_speed);
+  for (int i = 0; i < 600; i++) {
+    out = fan_pid_step(&gains, &state, gains.setpoint + 20.0f, &ff, 1.0f);
+  }
+  CHECK(out == gains.max_speed, "saturated output %.1f", out);
+  float held = state.integral;
+  int steps = 0;
+  while (steps < 60 && out >= gains.max_speed) {
+    out = fan_pid_step(&gains, &state, gains.setpoint - 3.0f, &ff, 1.0f);
+    steps++;
+  }
+  CHECK(steps <= 10, "output left saturation after %d s", steps);
+  CHECK(held <= gains.max_speed, "integral wound up to %.1f", held);
+
+  // 任意输入下输出有限且在限幅内，dt 为 0 或没有前馈也可以
+  gains.min_speed = 15;
+  gains.max_speed = 90;
+  fan_pid_reset(&state, 0.0f);
+  int bad = 0;
+  for (int i = 0; i < 1000000; i++) {
+    fan_pid_feedforward_t f = {frand(0, 80), frand(0, 100)};
+    float dt = rng() % 10 == 0 ? 0.0f : frand(0.0f, 5.0f);
+    out = fan_pid_step(&gains, &state, frand(-20, 150), rng() % 4 ? &f : NULL,
+                       dt);
+    if (!isfinite(out) || out < 15.0f || out > 90.0f ||
+        !isfinite(state.integral)) {
+      bad++;
+    }
+    if (rng() % 1000 == 0) {
+      fan_pid_reset(&state, frand(0, 100));
+    }
+  }
+  CHECK(bad == 0, "%d outputs outside limits", bad);
+
+  // 参数校验
+  fan_pid_gains_t g = fan_pid_get_default_gains();
+  CHECK(fan_pid_gains_valid(&g), "default gains rejected");
+  g.kp = NAN;
+  CHECK(!fan_pid_gains_valid(&g), "NaN kp accepted");
+  g = fan_pid_get_default_gains();
+  g.min_speed = 60;
+  g.max_speed = 50;
+  CHECK(!fan_pid_gains_valid(&g), "min > max accepted");
+  g = fan_pid_get_default_gains();
+  g.max_speed = 101;
+  CHECK(!fan_pid_gains_valid(&g), "max 101 accepted");
+  g = fan_pid_get_default_gains();
+  g.ki = -0.1f;
+  CHECK(!fan_pid_gains_valid(&g), "negative ki accepted");
+  CHECK(!fan_pid_gains_valid(NULL), "NULL gains accepted");
+}
+
+static const fan_curve_point_t CURVE[] = {
+    {30.0f, 20}, {50.0f, 30}, {70.0f, 40}, {80.0f, 100}};
+#define CURVE_POINTS (sizeof(CURVE) / sizeof(CURVE[0]))
+
+static fan_curve_lut_t s_lut;
+
+// 查找表取不高于当前温度的表项：上升曲线上不超过浮点插值，且不低于
+// 一个表项间距之前的插值
+static void check_lut(const fan_curve_point_t *curve, uint8_t n,
+                      uint8_t shift) {
+  fan_curve_lut_t lut;
+  fan_curve_compile(curve, n, &lut);
+  CHECK(lut.shift == shift, "shift %d, expected %d", lut.shift, shift);
+  float spacing = (float)(1 << lut.shift) / (1 << FAN_CURVE_LUT_FRAC_BITS);
+  float lo = curve[0].temperature - 10.0f;
+  float hi = curve[n - 1].temperature + 10.0f;
+  for (float t = lo; t <= hi; t += 0.01f) {
+    uint8_t got = fan_curve_lookup(&lut, t);
+    uint8_t exact = fan_curve_interpolate(curve, n, t);
+    uint8_t behind = fan_curve_interpolate(curve, n, t - spacing);
+    if (got > exact || got < behind) {
+      CHECK(0, "lookup %.2f °C: %d, interpolate %d..%d", t, got, behind,
+            exact);
+      return;
+    }
+  }
+  for (uint16_t i = 0; i <= lut.last; i++) {
+    float t = lut.base / 16.0f + i * spacing;
+    CHECK(fan_curve_lookup(&lut, t) == fan_curve_interpolate(curve, n, t),
+          "entry %d differs", i);
+  }
+}
+
+static void check_curve_law(void) {
+  CHECK(fan_curve_interpolate(CURVE, CURVE_POINTS, 10.0f) == 20, "below");
+  CHECK(fan_curve_interpolate(CURVE, CURVE_POINTS, 60.0f) == 35, "middle");
+  CHECK(fan_curve_interpolate(CURVE, CURVE_POINTS, 75.0f) == 70, "steep");
+  CHECK(fan_curve_interpolate(CURVE, CURVE_POINTS, 99.0f) == 100, "above");
+  CHECK(fan_curve_interpolate(NULL, 0, 50.0f) == 0, "empty curve");
+
+  check_lut(CURVE, CURVE_POINTS, 2); // 30-80 °C：1/4 °C 一项
+  const fan_curve_point_t wide[] = {{-50.0f, 0}, {40.0f, 25}, {150.0f, 100}};
+  check_lut(wide, 3, 4); // -50-150 °C：1 °C 一项
+  const fan_curve_point_t narrow[] = {{60.0f, 30}, {62.5f, 90}};
+  check_lut(narrow, 2, 0);
+  const fan_curve_point_t single[] = {{50.0f, 40}};
+  check_lut(single, 1, 0);
+
+  fan_curve_compile(NULL, 0, &s_lut);
+  CHECK(fan_curve_lookup(&s_lut, 50.0f) == 0, "empty table");
+  fan_curve_compile(CURVE, CURVE_POINTS, &s_lut);
+  CHECK(fan_curve_lookup(&s_lut, NAN) == 20, "NaN");
+  CHECK(fan_curve_lookup(&s_lut, 1e30f) == 100, "huge temperature");
+  CHECK(fan_curve_lookup(&s_lut, -1e30f) == 20, "huge negative temperature");
+
+  // 每次调用耗时（4 个风扇每秒各查一次，这里只看相对开销）
+  enum { CALLS = 4000000 };
+  volatile uint32_t sink = 0;
+  double t0 = now_ns();
+  for (int i = 0; i < CALLS; i++) {
+    sink += fan_curve_interpolate(CURVE, CURVE_POINTS, 25.0f + (i & 63));
+  }
+  double t1 = now_ns();
+  for (int i = 0; i < CALLS; i++) {
+    sink += fan_curve_lookup(&s_lut, 25.0f + (i & 63));
+  }
+  double t2 = now_ns();
+  printf("curve: interpolate %.1f ns, lookup %.1f ns per call\n",
+         (t1 - t0) / CALLS, (t2 - t1) / CALLS);
+
+  fan_curve_state_t st = {.last_stable_temperature = 50.0f,
+                          .last_applied_speed = 30,
+                          .last_speed_change_time = 0,
+                          .temperature_hysteresis = 3.0f,
+                          .min_speed_change_interval = 2000};
+  // 回差内不变
+  CHECK(fan_curve_step(&s_lut, &st, 52.5f, 5000) == 30,
+        "followed inside the dead zone");
+  CHECK(st.target_speed_percent == 31, "target %d", st.target_speed_percent);
+  // 超出回差后跟随
+  CHECK(fan_curve_step(&s_lut, &st, 74.0f, 6000) == 64,
+        "did not follow the curve");
+  // 最小间隔内不变，间隔到了再跟随
+  CHECK(fan_curve_step(&s_lut, &st, 80.0f, 7000) == 64,
+        "changed within the minimum interval");
+  CHECK(fan_curve_step(&s_lut, &st, 80.0f, 8000) == 100,
+        "did not change after the interval");
+}
+
+/* ============================================================================
+ * 热仿真
+ * ============================================================================
+ */
+
+typedef enum { CTRL_CURVE, CTRL_PID_NO_FF, CTRL_PID } controller_t;
+
+static const char *const CTRL_NAMES[] = {"曲线 (3 °C 回差)", "PID 无前馈",
+                                         "PID + 前馈"};
+
+typedef enum { SCEN_STEP, SCEN_BURST, SCEN_RANDOM } scenario_t;
+
+static const char *const SCEN_NAMES[] = {
+    "阶跃: 30 W 10 分钟 → 50 W 20 分钟 → 30 W 10 分钟",
+    "突发: 25 W 基础负载，每 60 秒 20 秒 55 W，共 20 分钟",
+    "随机: 10-60 W，每段 10-120 秒，共 2 小时"};
+
+static const int SCEN_LENGTH[] = {2400, 1200, 7200};
+
+#define STEP_UP_AT 600
+#define STEP_DOWN_AT 1800
+
+/** 随机场景的分段负载，各控制器使用同一序列 */
+typedef struct {
+  int until;
+  float power;
+  float gpu;
+} segment_t;
+
+static segment_t s_segments[256];
+static int s_segment_count;
+
+static void make_random_segments(void) {
+  int t = 0;
+  s_segment_count = 0;
+  while (t < SCEN_LENGTH[SCEN_RANDOM] && s_segment_count < 256) {
+    t += 10 + (int)(rng() % 111);
+    segment_t *s = &s_segments[s_segment_count++];
+    s->until = t;
+    s->power = frand(10.0f, 60.0f);
+    s->gpu = s->power > 25.0f ? frand(30.0f, 99.0f) : frand(0.0f, 20.0f);
+  }
+}
+
+/* 预热期间（t < 0）保持场景开始时的负载 */
+static void load_at(scenario_t scen, float t, float *power, float *gpu) {
+  t = fmaxf(t, 0.0f);
+  bool heavy = scen == SCEN_STEP ? t >= STEP_UP_AT && t < STEP_DOWN_AT
+                                 : fmodf(t, 60.0f) < 20.0f;
+  switch (scen) {
+  case SCEN_STEP:
+    *power = heavy ? 50.0f : 30.0f;
+    *gpu = heavy ? 99.0f : 40.0f;
+    break;
+  case SCEN_BURST:
+    *power = heavy ? 55.0f : 25.0f;
+    *gpu = heavy ? 99.0f : 30.0f;
+    break;
+  case SCEN_RANDOM:
+    *power = s_segments[s_segment_count - 1].power;
+    *gpu = s_segments[s_segment_count - 1].gpu;
+    for (int i = 0; i < s_segment_count; i++) {
+      if (t < s_segments[i].until) {
+        *power = s_segments[i].power;
+        *gpu = s_segments[i].gpu;
+        break;
+      }
+    }
+    break;
+  }
+}
+
+typedef struct {
+  float peak;       // 峰值温度
+  float mean;       // 平均温度
+  float stddev;     // 温度标准差
+  float energy_wh;  // 风扇能耗
+  float mean_speed; // 平均转速
+  int changes;      // 转速变化次数
+  float overshoot;  // 阶跃：峰值高出最终温度
+  float settling;   // 阶跃：调节时间（秒）
+  float final_temp; // 阶跃：负载段最后 60 秒的平均温度
+} result_t;
+
+static result_t simulate(controller_t ctrl, scenario_t scen) {
+  result_t r = {0};
+  fan_pid_gains_t gains = fan_pid_get_default_gains();
+  gains.setpoint = PID_SETPOINT;
+  if (ctrl == CTRL_PID_NO_FF) {
+    gains.kff_power = 0.0f;
+    gains.kff_gpu = 0.0f;
+  }
+  fan_pid_state_t pid;
+  fan_pid_reset(&pid, 50.0f);
+  // 与 fan_controller_init 相同的初始状态
+  fan_curve_state_t curve = {.last_stable_temperature = 25.0f,
+                             .target_speed_percent = 50,
+                             .last_applied_speed = 50,
+                             .last_speed_change_time = 0,
+                             .temperature_hysteresis = 3.0f,
+                             .min_speed_change_interval = 2000};
+
+  float t_die = AMBIENT + 20.0f;
+  float t_sink = AMBIENT + 15.0f;
+  float t_zone = t_die;
+  float airflow = 0.5f;
+  uint8_t speed = 50;
+
+  // 上一次 AGX 上报（每秒一次，比控制器早半秒）
+  float reported_temp = t_zone, reported_power = 0.0f;
+  float reported_gpu = 0.0f;
+  double next_report = -SIM_WARMUP + 0.5;
+  double next_control = -SIM_WARMUP + 1.0;
+
+  int length = SCEN_LENGTH[scen];
+  int samples = (int)(length / SIM_DT);
+  float *trace = malloc(sizeof(float) * (size_t)samples);
+  double sum = 0, sum_sq = 0, speed_sum = 0, energy_j = 0;
+  int n = 0;
+
+  for (double t = -SIM_WARMUP; t < length; t += SIM_DT) {
+    float power, gpu;
+    load_at(scen, (float)t, &power, &gpu);
+
+    if (t >= next_report) {
+      reported_temp = roundf(t_zone * 32.0f) / 32.0f;
+      reported_power = power;
+      reported_gpu = gpu;
+      next_report += 1.0;
+    }
+    if (t >= next_control) {
+      uint8_t prev = speed;
+      if (ctrl == CTRL_CURVE) {
+        uint32_t now_ms = (uint32_t)((t + SIM_WARMUP) * 1000.0);
+        speed = fan_curve_step(&s_lut, &curve, reported_temp, now_ms);
+      } else {
+        fan_pid_feedforward_t ff = {reported_power, reported_gpu};
+        speed = (uint8_t)lroundf(
+            fan_pid_step(&gains, &pid, reported_temp, &ff, CONTROL_PERIOD));
+      }
+      if (t >= 0 && speed != prev) {
+        r.changes++;
+      }
+      next_control += CONTROL_PERIOD;
+    }
+
+    // 热模型
+    airflow += (speed / 100.0f - airflow) * SIM_DT / TAU_FAN;
+    float g_sink = G_NATURAL + G_FORCED * powf(airflow, 0.8f);
+    float q_die = (t_die - t_sink) / R_DIE;
+    t_die += (power - q_die) * SIM_DT / C_DIE;
+    t_sink += (q_die - (t_sink - AMBIENT) * g_sink) * SIM_DT / C_SINK;
+    t_zone += (t_die - t_zone) * SIM_DT / TAU_ZONE;
+
+    if (t >= 0 && n < samples) {
+      float fan_w = FAN_POWER_MAX * airflow * airflow * airflow;
+      trace[n++] = t_zone;
+      sum += t_zone;
+      sum_sq += (double)t_zone * t_zone;
+      speed_sum += speed;
+      energy_j += fan_w * SIM_DT;
+      if (t_zone > r.peak) {
+        r.peak = t_zone;
+      }
+    }
+  }
+
+  r.mean = (float)(sum / n);
+  r.stddev = (float)sqrt(fmax(sum_sq / n - (sum / n) * (sum / n), 0.0));
+  r.mean_speed = (float)(speed_sum / n);
+  r.energy_wh = (float)(energy_j / 3600.0);
+
+  if (scen == SCEN_STEP) {
+    int up = (int)(STEP_UP_AT / SIM_DT);
+    int down = (int)(STEP_DOWN_AT / SIM_DT);
+    int tail = (int)(60 / SIM_DT);
+    double final = 0;
+    float peak = 0;
+    for (int i = down - tail; i < down; i++) {
+      final += trace[i];
+    }
+    r.final_temp = (float)(final / tail);
+    int last_out = up;
+    for (int i = up; i < down; i++) {
+      peak = fmaxf(peak, trace[i]);
+      if (fabsf(trace[i] - r.final_temp) > SETTLE_BAND) {
+        last_out = i;
+      }
+    }
+    r.overshoot = peak - r.final_temp;
+    r.settling = (last_out - up) * SIM_DT;
+  }
+  free(trace);
+  return r;
+}
+
+int main(void) {
+  check_pid_law();
+  check_curve_law();
+  printf("control law checks done\n");
+
+  fan_pid_gains_t gains = fan_pid_get_default_gains();
+  printf("PID: 设定 %.0f °C (默认 %.0f °C), kp %.2f, ki %.3f, kd %.1f, "
+         "前馈 %.2f %%/W + %.2f %%/%%GPU\n",
+         PID_SETPOINT, gains.setpoint, gains.kp, gains.ki, gains.kd,
+         gains.kff_power, gains.kff_gpu);
+
+  make_random_segments();
+  result_t results[3][3];
+  for (int s = 0; s < 3; s++) {
+    printf("\n%s\n", SCEN_NAMES[s]);
+    for (int c = 0; c < 3; c++) {
+      result_t r = simulate((controller_t)c, (scenario_t)s);
+      results[c][s] = r;
+      printf("  %s: 峰值 %.1f°C, 平均 %.1f°C, 波动 %.2f°C, 风扇 %.2f Wh, "
+             "平均转速 %.1f%%, 变化 %d 次\n",
+             CTRL_NAMES[c], r.peak, r.mean, r.stddev, r.energy_wh,
+             r.mean_speed, r.changes);
+      if (s == SCEN_STEP) {
+        printf("    超调 %.1f°C, 调节时间 %.0f 秒 (最终 %.1f°C)\n",
+               r.overshoot, r.settling, r.final_temp);
+      }
+    }
+  }
+
+  // 相同稳态温度下，预测 PID 更快稳定、基本不超调，前馈减小超调；突发负载
+  // 下温度波动比曲线小
+  result_t curve = results[CTRL_CURVE][SCEN_STEP];
+  result_t pid = results[CTRL_PID][SCEN_STEP];
+  result_t no_ff = results[CTRL_PID_NO_FF][SCEN_STEP];
+  CHECK(pid.settling < curve.settling, "settling %.0f vs %.0f s",
+        pid.settling, curve.settling);
+  CHECK(pid.overshoot < SETTLE_BAND, "step overshoot %.2f", pid.overshoot);
+  CHECK(pid.overshoot < no_ff.overshoot,
+        "feed-forward did not reduce the overshoot (%.2f vs %.2f)",
+        pid.overshoot, no_ff.overshoot);
+  CHECK(results[CTRL_PID][SCEN_BURST].stddev <
+            results[CTRL_CURVE][SCEN_BURST].stddev,
+        "burst swing %.2f vs %.2f", results[CTRL_PID][SCEN_BURST].stddev,
+        results[CTRL_CURVE][SCEN_BURST].stddev);
+
+  printf(s_failures ? "\nFAILED (%d)\n" : "\nOK\n", s_failures);
+  return s_failures != 0;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file bench_led_kernel.c
+ * @brief 对比旧的浮点动画内核与定点内核 (led_kernel) 渲染整帧的速度
+ *
+ * 旧路径按 matrix_led_animate_* 的原实现复刻：逐像素浮点 HSV、
+ * 逐像素 sinf、cosf/sinf 计算旋转点；新路径与当前 matrix_led.c
+ * 中的动画实现一致。
+ */
+
+#include "led_kernel.h"
+#include "matrix_led.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FRAMES 2000
+#define BENCH_SPEED 50
+
+static matrix_led_color_t s_legacy[MATRIX_LED_COUNT];
+static matrix_led_color_t s_fixed[MATRIX_LED_COUNT];
+
+static const matrix_led_color_t PRIMARY = {0, 0, 255};
+static const matrix_led_color_t SECONDARY = {255, 0, 0};
+
+// ==================== 旧实现（参考） ====================
+
+static void legacy_hsv_to_rgb(uint16_t hue, uint8_t sat, uint8_t val,
+                              matrix_led_color_t *rgb) {
+  float h = hue;
+  float s = sat / 100.0f;
+  float v = val / 100.0f;
+  float c = v * s;
+  float x = c * (1 - fabsf(fmodf(h / 60.0f, 2) - 1));
+  float m = v - c;
+  float r, g, b;
+
+  if (h < 60) {
+    r = c, g = x, b = 0;
+  } else if (h < 120) {
+    r = x, g = c, b = 0;
+  } else if (h < 180) {
+    r = 0, g = c, b = x;
+  } else if (h < 240) {
+    r = 0, g = x, b = c;
+  } else if (h < 300) {
+    r = x, g = 0, b = c;
+  } else {
+    r = c, g = 0, b = x;
+  }
+
+  rgb->r = (uint8_t)((r + m) * 255);
+  rgb->g = (uint8_t)((g + m) * 255);
+  rgb->b = (uint8_t)((b + m) * 255);
+}
+
+static void legacy_interpolate(matrix_led_color_t c1, matrix_led_color_t c2,
+                               float ratio, matrix_led_color_t *out) {
+  out->r = (uint8_t)(c1.r + (c2.r - c1.r) * ratio);
+  out->g = (uint8_t)(c1.g + (c2.g - c1.g) * ratio);
+  out->b = (uint8_t)(c1.b + (c2.b - c1.b) * ratio);
+}
+
+// 两条路径共用同一个填充函数，只比较内核本身的差异
+static void __attribute__((noinline))
+fill_buffer(matrix_led_color_t *buffer, matrix_led_color_t c) {
+  for (int i = 0; i < MATRIX_LED_COUNT; i++) {
+    buffer[i] = c;
+  }
+}
+
+static void legacy_rainbow(uint32_t ticks) {
+  uint32_t t = ticks * BENCH_SPEED / 10;
+  for (int y = 0; y < MATRIX_LED_HEIGHT; y++) {
+    for (int x = 0; x < MATRIX_LED_WIDTH; x++) {
+      uint16_t hue =
+          ((x + y) * 360 / (MATRIX_LED_WIDTH + MATRIX_LED_HEIGHT) + t) % 360;
+      legacy_hsv_to_rgb(hue, 100, 100, &s_legacy[y * MATRIX_LED_WIDTH + x]);
+    }
+  }
+}
+
+static void legacy_wave(uint32_t ticks) {
+  uint32_t t = ticks * BENCH_SPEED / 20;
+  for (int y = 0; y < MATRIX_LED_HEIGHT; y++) {
+    for (int x = 0; x < MATRIX_LED_WIDTH; x++) {
+      float wave = sinf((x + t) * 0.2f) * 0.5f + 0.5f;
+      legacy_interpolate(SECONDARY, PRIMARY, wave,
+                         &s_legacy[y * MATRIX_LED_WIDTH + x]);
+    }
+  }
+}
+
+static void legacy_breathe(uint32_t ticks) {
+  uint32_t t = ticks * BENCH_SPEED / 50;
+  float breathe = (sinf(t * 0.1f) + 1.0f) / 2.0f;
+  float factor = (uint8_t)(breathe * 100) / 100.0f;
+  matrix_led_color_t c = {(uint8_t)(PRIMARY.r * factor),
+                          (uint8_t)(PRIMARY.g * factor),
+                          (uint8_t)(PRIMARY.b * factor)};
+  fill_buffer(s_legacy, c);
+}
+
+static void legacy_rotate(uint32_t ticks) {
+  uint32_t t = ticks * BENCH_SPEED / 30;
+  memset(s_legacy, 0, sizeof(s_legacy));
+  for (int i = 0; i < 4; i++) {
+    float angle = (t + i * 90) * (float)M_PI / 180.0f;
+    int x = MATRIX_LED_WIDTH / 2 + (int)(cosf(angle) * 12);
+    int y = MATRIX_LED_HEIGHT / 2 + (int)(sinf(angle) * 12);
+    if (x >= 0 && x < MATRIX_LED_WIDTH && y >= 0 && y < MATRIX_LED_HEIGHT) {
+      s_legacy[y * MATRIX_LED_WIDTH + x] = PRIMARY;
+    }
+  }
+}
+
+static void legacy_fade(uint32_t ticks) {
+  uint32_t t = ticks * BENCH_SPEED / 40;
+  float fade = (sinf(t * 0.05f) + 1.0f) / 2.0f;
+  matrix_led_color_t c;
+  legacy_interpolate(PRIMARY, SECONDARY, fade, &c);
+  fill_buffer(s_legacy, c);
+}
+
+// ==================== 定点实现 ====================
+
+static inline led_kernel_rgb_t to_kernel(matrix_led_color_t c) {
+  return (led_kernel_rgb_t){c.r, c.g, c.b};
+}
+
+static inline matrix_led_color_t from_kernel(led_kernel_rgb_t c) {
+  return (matrix_led_color_t){c.r, c.g, c.b};
+}
+
+static void fixed_rainbow(uint32_t ticks) {
+  uint32_t t = ticks * BENCH_SPEED / 10;
+  matrix_led_color_t diagonal[MATRIX_LED_WIDTH + MATRIX_LED_HEIGHT - 1];
+  uint32_t hue_offset = LED_KERNEL_DEGREES(t % 360);
+  for (uint32_t d = 0; d < MATRIX_LED_WIDTH + MATRIX_LED_HEIGHT - 1; d++) {
+    uint16_t hue = (uint16_t)(d * LED_KERNEL_ANGLE_FULL /
+                                  (MATRIX_LED_WIDTH + MATRIX_LED_HEIGHT) +
+                              hue_offset);
+    diagonal[d] = from_kernel(led_kernel_hsv_to_rgb(hue, 255, 255));
+  }
+  for (int y = 0; y < MATRIX_LED_HEIGHT; y++) {
+    memcpy(&s_fixed[y * MATRIX_LED_WIDTH], &diagonal[y],
+           MATRIX_LED_WIDTH * sizeof(matrix_led_color_t));
+  }
+}
+
+static void fixed_wave(uint32_t ticks) {
+  uint32_t t = ticks * BENCH_SPEED / 20;
+  led_kernel_rgb_t primary = to_kernel(PRIMARY);
+  led_kernel_rgb_t secondary = to_kernel(SECONDARY);
+  for (uint32_t x = 0; x < MATRIX_LED_WIDTH; x++) {
+    uint16_t angle = (uint16_t)((x + t) * LED_KERNEL_RADIANS(0.2f));
+    s_fixed[x] = from_kernel(
+        led_kernel_lerp_rgb(secondary, primary, led_kernel_wave8(angle)));
+  }
+  for (int y = 1; y < MATRIX_LED_HEIGHT; y++) {
+    memcpy(&s_fixed[y * MATRIX_LED_WIDTH], s_fixed,
+           MATRIX_LED_WIDTH * sizeof(matrix_led_color_t));
+  }
+}
+
+static void fixed_breathe(uint32_t ticks) {
+  uint32_t t = ticks * BENCH_SPEED / 50;
+  uint8_t level = led_kernel_wave8((uint16_t)(t * LED_KERNEL_RADIANS(0.1f)));
+  fill_buffer(s_fixed,
+              from_kernel(led_kernel_scale_rgb(to_kernel(PRIMARY), level)));
+}
+
+static void fixed_rotate(uint32_t ticks) {
+  uint32_t t = ticks * BENCH_SPEED / 30;
+  memset(s_fixed, 0, sizeof(s_fixed));
+  for (uint32_t i = 0; i < 4; i++) {
+    uint16_t angle = LED_KERNEL_DEGREES((t + i * 90) % 360);
+    int32_t x =
+        MATRIX_LED_WIDTH / 2 + led_kernel_mul_sin(led_kernel_cos16(angle), 12);
+    int32_t y =
+        MATRIX_LED_HEIGHT / 2 + led_kernel_mul_sin(led_kernel_sin16(angle), 12);
+    if (x >= 0 && x < MATRIX_LED_WIDTH && y >= 0 && y < MATRIX_LED_HEIGHT) {
+      s_fixed[y * MATRIX_LED_WIDTH + x] = PRIMARY;
+    }
+  }
+}
+
+static void fixed_fade(uint32_t ticks) {
+  uint32_t t = ticks * BENCH_SPEED / 40;
+  uint8_t fade = led_kernel_wave8((uint16_t)(t * LED_KERNEL_RADIANS(0.05f)));
+  fill_buffer(s_fixed, from_kernel(led_kernel_lerp_rgb(
+                           to_kernel(PRIMARY), to_kernel(SECONDARY), fade)));
+}
+
+// ==================== 基准测试 ====================
+
+typedef void (*render_fn_t)(uint32_t ticks);
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double measure(render_fn_t fn, const matrix_led_color_t *buffer) {
+  volatile uint32_t sink = 0;
+  double t0 = now_ns();
+  for (uint32_t f = 0; f < BENCH_FRAMES; f++) {
+    fn(f);
+    sink += buffer[f % MATRIX_LED_COUNT].r;
+  }
+  (void)sink;
+  return (now_ns() - t0) / BENCH_FRAMES;
+}
+
+static int max_error(render_fn_t legacy, render_fn_t fixed) {
+  int max_err = 0;
+  for (uint32_t f = 0; f < 200; f++) {
+    legacy(f);
+    fixed(f);
+    for (int i = 0; i < MATRIX_LED_COUNT; i++) {
+      int e = abs(s_legacy[i].r - s_fixed[i].r);
+      int eg = abs(s_legacy[i].g - s_fixed[i].g);
+      int eb = abs(s_legacy[i].b - s_fixed[i].b);
+      e = e > eg ? e : eg;
+      e = e > eb ? e : eb;
+      max_err = e > max_err ? e : max_err;
+    }
+  }
+  return max_err;
+}
+
+static void run_case(const char *name, render_fn_t legacy, render_fn_t fixed,
+                     int compare) {
+  double legacy_ns = measure(legacy, s_legacy);
+  double fixed_ns = measure(fixed, s_fixed);
+
+  printf("%-8s legacy %8.0f fps (%7.1f us) | fixed %9.0f fps (%6.1f us) | "
+         "speedup %6.1fx | ",
+         name, 1e9 / legacy_ns, legacy_ns / 1000.0, 1e9 / fixed_ns,
+         fixed_ns / 1000.0, legacy_ns / fixed_ns);
+  if (compare) {
+    printf("max err %d\n", max_error(legacy, fixed));
+  } else {
+    // 旧实现截断坐标（负数还依赖未定义的浮点转换），新实现四舍五入
+    printf("positions rounded\n");
+  }
+}
+
+int main(void) {
+  printf("Matrix animation kernel benchmark (%d pixels, %d frames)\n",
+         MATRIX_LED_COUNT, BENCH_FRAMES);
+
+  run_case("rainbow", legacy_rainbow, fixed_rainbow, 1);
+  run_case("wave", legacy_wave, fixed_wave, 1);
+  run_case("breathe", legacy_breathe, fixed_breathe, 1);
+  run_case("rotate", legacy_rotate, fixed_rotate, 0);
+  run_case("fade", legacy_fade, fixed_fade, 1);
+
+  return 0;
+}
@@ -0,0 +1,234 @@
+/**
+ * @file bench_matrix_anim.c
+ * @brief 二进制动画容器的体积、解码速度和往返一致性
+ *
+ * 生成几类典型内容（单帧图标、移动精灵、全屏彩虹、超出调色板的渐变），写入容器后逐帧
+ * 解码并与原始帧逐像素比较。JSON体积按 sdcard/matrix.json 实测的每个
+ * 点约103字节估算。
+ */
+
+#include "led_kernel.h"
+#include "matrix_led_anim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define JSON_BYTES_PER_POINT 103
+#define SPRITE_FRAMES 256
+#define RAINBOW_FRAMES 120
+#define GRADIENT_FRAMES 60
+
+typedef void (*generate_fn_t)(uint32_t frame, matrix_led_color_t *out);
+
+static const matrix_led_color_t RED = {255, 0, 0};
+static const matrix_led_color_t YELLOW = {255, 255, 0};
+
+static matrix_led_anim_writer_t s_writer;
+static matrix_led_anim_reader_t s_reader;
+static matrix_led_color_t s_frame[MATRIX_LED_COUNT];
+static matrix_led_color_t s_decoded[MATRIX_LED_COUNT];
+
+// ==================== 测试内容 ====================
+
+static void generate_logo(uint32_t frame, matrix_led_color_t *out) {
+  (void)frame;
+  memset(out, 0, MATRIX_LED_COUNT * sizeof(*out));
+  // 与 matrix.json 中的图标类似：约170个点、少量渐变色
+  for (int y = 8; y < 24; y++) {
+    for (int x = 9; x < 25; x++) {
+      if (((x - 16) * (x - 16) + (y - 16) * (y - 16)) < 60 &&
+          ((x + y) % 3) != 0) {
+        out[y * MATRIX_LED_WIDTH + x] = (matrix_led_color_t){
+            (uint8_t)(140 + x * 3), (uint8_t)(150 + y * 2), 240};
+      }
+    }
+  }
+}
+
+static void generate_sprite(uint32_t frame, matrix_led_color_t *out) {
+  memset(out, 0, MATRIX_LED_COUNT * sizeof(*out));
+  int ox = (int)(frame % (MATRIX_LED_WIDTH - 8));
+  int oy = (int)((frame / 3) % (MATRIX_LED_HEIGHT - 8));
+  for (int y = 0; y < 8; y++) {
+    for (int x = 0; x < 8; x++) {
+      if ((x + y) % 2 == 0 || x == 0 || y == 7) {
+        out[(oy + y) * MATRIX_LED_WIDTH + ox + x] =
+            (x + y) % 4 == 0 ? YELLOW : RED;
+      }
+    }
+  }
+}
+
+static void generate_rainbow(uint32_t frame, matrix_led_color_t *out) {
+  for (int y = 0; y < MATRIX_LED_HEIGHT; y++) {
+    for (int x = 0; x < MATRIX_LED_WIDTH; x++) {
+      uint16_t hue = (uint16_t)((x + y) * LED_KERNEL_ANGLE_FULL /
+                                    (MATRIX_LED_WIDTH + MATRIX_LED_HEIGHT) +
+                                frame * 512);
+      led_kernel_rgb_t c = led_kernel_hsv_to_rgb(hue, 255, 255);
+      out[y * MATRIX_LED_WIDTH + x] = (matrix_led_color_t){c.r, c.g, c.b};
+    }
+  }
+}
+
+static void generate_gradient(uint32_t frame, matrix_led_color_t *out) {
+  // 每帧上千种颜色，超出调色板容量
+  for (int y = 0; y < MATRIX_LED_HEIGHT; y++) {
+    for (int x = 0; x < MATRIX_LED_WIDTH; x++) {
+      out[y * MATRIX_LED_WIDTH + x] = (matrix_led_color_t){
+          (uint8_t)(x * 8), (uint8_t)(y * 8), (uint8_t)(frame * 4)};
+    }
+  }
+}
+
+// ==================== 基准测试 ====================
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static long file_size(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    return -1;
+  }
+  fseek(f, 0, SEEK_END);
+  long size = ftell(f);
+  fclose(f);
+  return size;
+}
+
+static int run_case(const char *name, generate_fn_t generate,
+                    uint32_t frames) {
+  char path[64];
+  snprintf(path, sizeof(path), "bench_anim_%s.mla", name);
+
+  // 颜色不超过256种时使用调色板
+  uint16_t palette_count = 0;
+  bool use_palette = true;
+  long json_bytes = 0;
+  for (uint32_t f = 0; f < frames; f++) {
+    generate(f, s_frame);
+    for (int i = 0; i < MATRIX_LED_COUNT; i++) {
+      if (s_frame[i].r || s_frame[i].g || s_frame[i].b) {
+        json_bytes += JSON_BYTES_PER_POINT;
+      }
+      if (use_palette) {
+        use_palette = matrix_led_anim_palette_add(
+                          s_writer.palette, &palette_count,
+                          s_frame[i]) >= 0;
+      }
+    }
+  }
+
+  if (matrix_led_anim_writer_open(&s_writer, path,
+                                  use_palette ? s_writer.palette : NULL,
+                                  palette_count) != ESP_OK ||
+      matrix_led_anim_writer_begin(&s_writer, name, 40, true) != ESP_OK) {
+    printf("%s: failed to create %s\n", name, path);
+    return 1;
+  }
+  for (uint32_t f = 0; f < frames; f++) {
+    generate(f, s_frame);
+    if (matrix_led_anim_writer_add_frame(&s_writer, s_frame, 0) != ESP_OK) {
+      printf("%s: failed to encode frame %u\n", name, f);
+      return 1;
+    }
+  }
+  if (matrix_led_anim_writer_end(&s_writer) != ESP_OK ||
+      matrix_led_anim_writer_close(&s_writer) != ESP_OK) {
+    printf("%s: failed to finish %s\n", name, path);
+    return 1;
+  }
+
+  // 往返一致性
+  if (matrix_led_anim_open(&s_reader, path) != ESP_OK ||
+      matrix_led_anim_select(&s_reader, name) != ESP_OK) {
+    printf("%s: failed to open %s\n", name, path);
+    return 1;
+  }
+  for (uint32_t f = 0; f < frames; f++) {
+    generate(f, s_frame);
+    if (matrix_led_anim_read_frame(&s_reader, s_decoded, NULL, NULL) !=
+            ESP_OK ||
+        memcmp(s_frame, s_decoded, sizeof(s_frame)) != 0) {
+      printf("%s: frame %u mismatch\n", name, f);
+      return 1;
+    }
+  }
+  if (matrix_led_anim_read_frame(&s_reader, s_decoded, NULL, NULL) !=
+      ESP_ERR_NOT_FOUND) {
+    printf("%s: expected end of animation\n", name);
+    return 1;
+  }
+
+  // 解码速度（循环播放10遍）
+  double t0 = now_ns();
+  for (int pass = 0; pass < 10; pass++) {
+    matrix_led_anim_rewind(&s_reader);
+    while (matrix_led_anim_read_frame(&s_reader, s_decoded, NULL, NULL) ==
+           ESP_OK) {
+    }
+  }
+  double decode_ns = (now_ns() - t0) / (10.0 * frames);
+  matrix_led_anim_close(&s_reader);
+
+  long bin_bytes = file_size(path);
+  printf("%-8s %4u frames | %-7s | json ~%8ld B | bin %7ld B (%6.1f B/frame) "
+         "| %5.1fx smaller | decode %6.1f us/frame\n",
+         name, frames, use_palette ? "palette" : "rgb", json_bytes, bin_bytes,
+         (double)bin_bytes / frames,
+         bin_bytes > 0 ? (double)json_bytes / bin_bytes : 0.0,
+         decode_ns / 1000.0);
+
+  remove(path);
+  return 0;
+}
+
+static int check_truncated(void) {
+  const char *path = "bench_anim_truncated.mla";
+  matrix_led_anim_writer_open(&s_writer, path, NULL, 0);
+  matrix_led_anim_writer_begin(&s_writer, "cut", 40, true);
+  generate_rainbow(0, s_frame);
+  matrix_led_anim_writer_add_frame(&s_writer, s_frame, 0);
+  matrix_led_anim_writer_end(&s_writer);
+  matrix_led_anim_writer_close(&s_writer);
+
+  long size = file_size(path);
+  FILE *f = fopen(path, "r+b");
+  char *data = malloc((size_t)size);
+  fread(data, 1, (size_t)size, f);
+  fclose(f);
+  f = fopen(path, "wb");
+  fwrite(data, 1, (size_t)size / 2, f);
+  fclose(f);
+  free(data);
+
+  esp_err_t ret = matrix_led_anim_open(&s_reader, path);
+  remove(path);
+  if (ret == ESP_OK) {
+    printf("truncated file was accepted\n");
+    matrix_led_anim_close(&s_reader);
+    return 1;
+  }
+  return 0;
+}
+
+int main(void) {
+  printf("Matrix animation container (%dx%d, reader state %zu bytes)\n",
+         MATRIX_LED_WIDTH, MATRIX_LED_HEIGHT, sizeof(matrix_led_anim_reader_t));
+
+  int failed = 0;
+  failed |= run_case("logo", generate_logo, 1);
+  failed |= run_case("sprite", generate_sprite, SPRITE_FRAMES);
+  failed |= run_case("rainbow", generate_rainbow, RAINBOW_FRAMES);
+  failed |= run_case("gradient", generate_gradient, GRADIENT_FRAMES);
+  failed |= check_truncated();
+
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
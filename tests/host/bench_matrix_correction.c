@@ -0,0 +1,209 @@
+/**
+ * @file bench_matrix_correction.c
+ * @brief 对比旧的逐像素浮点校正与融合查找表校正的每帧开销
+ *
+ * 旧路径按 matrix_led_apply_all_corrections 的原实现复刻：
+ * 浮点亮度 -> 浮点白点 -> Gamma查找表 -> RGB/HSL往返。
+ */
+
+#include "matrix_led_correction.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FRAMES 2000
+
+// ==================== 旧实现（参考） ====================
+
+typedef struct {
+  float h, s, l;
+} legacy_hsl_t;
+
+static uint8_t s_legacy_gamma[256];
+
+static inline float legacy_clamp_float(float v) {
+  return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+}
+
+static inline uint8_t legacy_clamp_u8(int v) {
+  return v < 0 ? 0 : (v > 255 ? 255 : (uint8_t)v);
+}
+
+static void legacy_rgb_to_hsl(const matrix_led_color_t *rgb, legacy_hsl_t *hsl) {
+  float r = rgb->r / 255.0f, g = rgb->g / 255.0f, b = rgb->b / 255.0f;
+  float max_val = fmaxf(r, fmaxf(g, b));
+  float min_val = fminf(r, fminf(g, b));
+  float delta = max_val - min_val;
+
+  hsl->l = (max_val + min_val) / 2.0f;
+  if (delta < 0.0001f) {
+    hsl->h = 0.0f;
+    hsl->s = 0.0f;
+    return;
+  }
+  hsl->s = hsl->l < 0.5f ? delta / (max_val + min_val)
+                         : delta / (2.0f - max_val - min_val);
+  if (max_val == r) {
+    hsl->h = ((g - b) / delta) * 60.0f;
+    if (g < b) {
+      hsl->h += 360.0f;
+    }
+  } else if (max_val == g) {
+    hsl->h = ((b - r) / delta + 2.0f) * 60.0f;
+  } else {
+    hsl->h = ((r - g) / delta + 4.0f) * 60.0f;
+  }
+}
+
+static float legacy_hue_to_rgb(float p, float q, float t) {
+  if (t < 0.0f) t += 1.0f;
+  if (t > 1.0f) t -= 1.0f;
+  if (t < 1.0f / 6.0f) return p + (q - p) * 6.0f * t;
+  if (t < 1.0f / 2.0f) return q;
+  if (t < 2.0f / 3.0f) return p + (q - p) * (2.0f / 3.0f - t) * 6.0f;
+  return p;
+}
+
+static void legacy_hsl_to_rgb(const legacy_hsl_t *hsl, matrix_led_color_t *rgb) {
+  float h = hsl->h / 360.0f;
+  float s = legacy_clamp_float(hsl->s);
+  float l = legacy_clamp_float(hsl->l);
+  if (s < 0.0001f) {
+    rgb->r = rgb->g = rgb->b = (uint8_t)(l * 255.0f + 0.5f);
+    return;
+  }
+  float q = l < 0.5f ? l * (1.0f + s) : l + s - l * s;
+  float p = 2.0f * l - q;
+  rgb->r = (uint8_t)(legacy_hue_to_rgb(p, q, h + 1.0f / 3.0f) * 255.0f + 0.5f);
+  rgb->g = (uint8_t)(legacy_hue_to_rgb(p, q, h) * 255.0f + 0.5f);
+  rgb->b = (uint8_t)(legacy_hue_to_rgb(p, q, h - 1.0f / 3.0f) * 255.0f + 0.5f);
+}
+
+static matrix_led_color_t
+legacy_apply(const matrix_led_correction_params_t *p, matrix_led_color_t in) {
+  float factor = p->brightness / 100.0f;
+  matrix_led_color_t w = {(uint8_t)(in.r * factor), (uint8_t)(in.g * factor),
+                          (uint8_t)(in.b * factor)};
+  if (!p->enabled) {
+    return w;
+  }
+  if (p->white_point_enabled) {
+    w.r = legacy_clamp_u8((int)(w.r * p->red_scale + 0.5f));
+    w.g = legacy_clamp_u8((int)(w.g * p->green_scale + 0.5f));
+    w.b = legacy_clamp_u8((int)(w.b * p->blue_scale + 0.5f));
+  }
+  if (p->gamma_enabled) {
+    w.r = s_legacy_gamma[w.r];
+    w.g = s_legacy_gamma[w.g];
+    w.b = s_legacy_gamma[w.b];
+  }
+  if (p->lightness_enabled || p->saturation_enabled) {
+    legacy_hsl_t hsl;
+    legacy_rgb_to_hsl(&w, &hsl);
+    if (p->lightness_enabled) {
+      hsl.l = legacy_clamp_float(hsl.l * p->lightness_factor);
+    }
+    if (p->saturation_enabled) {
+      hsl.s = legacy_clamp_float(hsl.s * p->saturation_factor);
+    }
+    legacy_hsl_to_rgb(&hsl, &w);
+  }
+  return w;
+}
+
+// ==================== 基准测试 ====================
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void run_case(const char *name, const matrix_led_correction_params_t *p,
+                     const matrix_led_color_t *frame) {
+  static matrix_led_color_t out_legacy[MATRIX_LED_COUNT];
+  static matrix_led_color_t out_lut[MATRIX_LED_COUNT];
+  volatile uint32_t sink = 0;
+
+  for (int i = 0; i < 256; i++) {
+    s_legacy_gamma[i] =
+        (uint8_t)(powf(i / 255.0f, 1.0f / p->gamma) * 255.0f + 0.5f);
+  }
+
+  double t0 = now_ns();
+  for (int f = 0; f < BENCH_FRAMES; f++) {
+    for (int i = 0; i < MATRIX_LED_COUNT; i++) {
+      out_legacy[i] = legacy_apply(p, frame[i]);
+    }
+    sink += out_legacy[f % MATRIX_LED_COUNT].r;
+  }
+  double legacy_ns = (now_ns() - t0) / BENCH_FRAMES;
+
+  matrix_led_correction_t corr = {0};
+  t0 = now_ns();
+  matrix_led_correction_build(&corr, p);
+  double build_ns = now_ns() - t0;
+
+  t0 = now_ns();
+  for (int f = 0; f < BENCH_FRAMES; f++) {
+    matrix_led_correction_apply(&corr, frame, out_lut, MATRIX_LED_COUNT);
+    sink += out_lut[f % MATRIX_LED_COUNT].r;
+  }
+  double lut_ns = (now_ns() - t0) / BENCH_FRAMES;
+
+  int max_err = 0;
+  for (int i = 0; i < MATRIX_LED_COUNT; i++) {
+    int e = abs(out_legacy[i].r - out_lut[i].r);
+    e = e > abs(out_legacy[i].g - out_lut[i].g) ? e
+                                                : abs(out_legacy[i].g - out_lut[i].g);
+    e = e > abs(out_legacy[i].b - out_lut[i].b) ? e
+                                                : abs(out_legacy[i].b - out_lut[i].b);
+    max_err = e > max_err ? e : max_err;
+  }
+
+  printf("%-22s legacy %9.1f us/frame | lut %7.1f us/frame | speedup %5.1fx "
+         "| build %6.1f us | max err %d\n",
+         name, legacy_ns / 1000.0, lut_ns / 1000.0, legacy_ns / lut_ns,
+         build_ns / 1000.0, max_err);
+  (void)sink;
+}
+
+int main(void) {
+  static matrix_led_color_t frame[MATRIX_LED_COUNT];
+  srand(1234);
+  for (int i = 0; i < MATRIX_LED_COUNT; i++) {
+    frame[i].r = (uint8_t)rand();
+    frame[i].g = (uint8_t)rand();
+    frame[i].b = (uint8_t)rand();
+  }
+
+  matrix_led_correction_params_t base = {
+      .brightness = 50,
+      .red_scale = 1.0f,
+      .green_scale = 0.9f,
+      .blue_scale = 0.8f,
+      .gamma = 2.2f,
+      .lightness_factor = 1.2f,
+      .saturation_factor = 1.3f,
+  };
+
+  printf("Matrix correction benchmark (%d pixels, %d frames)\n",
+         MATRIX_LED_COUNT, BENCH_FRAMES);
+
+  matrix_led_correction_params_t p = base;
+  run_case("brightness only", &p, frame);
+
+  p.enabled = true;
+  p.white_point_enabled = true;
+  p.gamma_enabled = true;
+  run_case("white point + gamma", &p, frame);
+
+  p.lightness_enabled = true;
+  p.saturation_enabled = true;
+  run_case("full pipeline (HSL)", &p, frame);
+
+  return 0;
+}
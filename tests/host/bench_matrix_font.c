@@ -0,0 +1,234 @@
+/**
+ * @file bench_matrix_font.c
+ * @brief 点阵字体绘制和增量滚动的正确性与耗时
+ *
+ * 1. 字形数据检查：每个字形的置位列不超过字形宽度。
+ * 2. 行写入与逐像素参考实现逐像素比较（含负坐标和裁剪区域）。
+ * 3. 文本对象逐步滚动完整的两个周期，每一步增量结果都与整体重绘比较。
+ * 4. 报告逐像素绘制、行写入、整体重绘和增量滚动的耗时以及每步脏行数。
+ */
+
+#include "matrix_led_font.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define TIMING_ROUNDS 20000
+#define SCROLL_TEXT "CPU 42" MATRIX_LED_FONT_DEGREE "C  GPU 57% 1.2GHz  robOS"
+
+static const matrix_led_color_t FG = {255, 200, 0};
+static const matrix_led_color_t BG = {0, 0, 40};
+
+static matrix_led_color_t s_frame[MATRIX_LED_COUNT];
+static matrix_led_color_t s_reference[MATRIX_LED_COUNT];
+static matrix_led_text_t s_text;
+static matrix_led_text_t s_full;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// ==================== 参考实现 ====================
+
+static void reference_set_pixel(matrix_led_color_t *frame, int x, int y,
+                                matrix_led_color_t color,
+                                const matrix_led_rect_t *clip) {
+  int x0 = clip ? clip->x : 0, y0 = clip ? clip->y : 0;
+  int x1 = clip ? clip->x + clip->width : MATRIX_LED_WIDTH;
+  int y1 = clip ? clip->y + clip->height : MATRIX_LED_HEIGHT;
+  if (x >= x0 && x < x1 && y >= y0 && y < y1 && x < MATRIX_LED_WIDTH &&
+      y < MATRIX_LED_HEIGHT) {
+    frame[y * MATRIX_LED_WIDTH + x] = color;
+  }
+}
+
+/**
+ * @brief 逐字形逐像素绘制（与改造前 set_pixel 循环的访问方式相同）
+ */
+static void reference_draw(matrix_led_color_t *frame,
+                           const matrix_led_font_t *font, int x, int y,
+                           const char *text, matrix_led_color_t color,
+                           const matrix_led_rect_t *clip) {
+  for (const char *p = text; *p != '\0'; p++) {
+    uint8_t ch = (uint8_t)*p;
+    if (ch < font->first || ch > font->last) {
+      ch = '?';
+    }
+    uint32_t index = ch - font->first;
+    uint8_t width = font->widths ? font->widths[index] : font->width;
+    const uint8_t *glyph = &font->bitmap[index * font->height];
+    for (int r = 0; r < font->height; r++) {
+      for (int c = 0; c < width; c++) {
+        if (glyph[r] & (0x80 >> c)) {
+          reference_set_pixel(frame, x + c, y + r, color, clip);
+        }
+      }
+    }
+    x += width + font->spacing;
+  }
+}
+
+// ==================== 检查 ====================
+
+static int check_glyphs(const matrix_led_font_t *font) {
+  for (int ch = font->first; ch <= font->last; ch++) {
+    uint32_t index = ch - font->first;
+    uint8_t width = font->widths ? font->widths[index] : font->width;
+    uint8_t allowed = width >= 8 ? 0xFF : (uint8_t)~(0xFF >> width);
+    for (int r = 0; r < font->height; r++) {
+      if (font->bitmap[index * font->height + r] & ~allowed) {
+        printf("%s: glyph 0x%02X row %d exceeds width %u\n", font->name, ch, r,
+               width);
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+static int check_draw(const matrix_led_font_t *font) {
+  static const struct {
+    int x, y;
+    matrix_led_rect_t clip;
+    bool use_clip;
+  } CASES[] = {
+      {0, 0, {0}, false},          {-7, 3, {0}, false},
+      {25, 28, {0}, false},        {-40, -3, {0}, false},
+      {3, 10, {5, 11, 17, 4}, true}, {-2, 20, {0, 20, 32, 12}, true},
+  };
+
+  for (size_t i = 0; i < sizeof(CASES) / sizeof(CASES[0]); i++) {
+    const matrix_led_rect_t *clip = CASES[i].use_clip ? &CASES[i].clip : NULL;
+    memset(s_frame, 0, sizeof(s_frame));
+    memset(s_reference, 0, sizeof(s_reference));
+    uint32_t dirty = matrix_led_font_draw(s_frame, font, CASES[i].x,
+                                          CASES[i].y, SCROLL_TEXT, FG, clip);
+    reference_draw(s_reference, font, CASES[i].x, CASES[i].y, SCROLL_TEXT, FG,
+                   clip);
+    if (memcmp(s_frame, s_reference, sizeof(s_frame)) != 0) {
+      printf("%s: draw case %zu mismatch\n", font->name, i);
+      return 1;
+    }
+    for (int y = 0; y < MATRIX_LED_HEIGHT; y++) {
+      bool lit = false;
+      for (int x = 0; x < MATRIX_LED_WIDTH; x++) {
+        const matrix_led_color_t *c = &s_reference[y * MATRIX_LED_WIDTH + x];
+        lit |= c->r || c->g || c->b;
+      }
+      if (lit && !(dirty & (1u << y))) {
+        printf("%s: draw case %zu row %d not marked dirty\n", font->name, i, y);
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+static int check_scroll(const matrix_led_font_t *font, uint16_t step,
+                        double *dirty_per_step) {
+  const matrix_led_rect_t area = {2, 12, 28, 9};
+  matrix_led_text_init(&s_text, font, &area, FG, BG);
+  matrix_led_text_init(&s_full, font, &area, FG, BG);
+  matrix_led_text_set(&s_text, SCROLL_TEXT);
+  matrix_led_text_set(&s_full, SCROLL_TEXT);
+
+  memset(s_frame, 0, sizeof(s_frame));
+  matrix_led_text_render(&s_text, s_frame);
+
+  uint32_t steps = 2u * s_text.period / step + 1;
+  uint64_t dirty_total = 0;
+  for (uint32_t i = 0; i < steps; i++) {
+    uint32_t dirty = matrix_led_text_scroll(&s_text, s_frame, step);
+    dirty_total += (uint64_t)__builtin_popcount(dirty);
+
+    s_full.offset = s_text.offset;
+    memset(s_reference, 0, sizeof(s_reference));
+    matrix_led_text_render(&s_full, s_reference);
+    if (memcmp(s_frame, s_reference, sizeof(s_frame)) != 0) {
+      printf("%s: scroll step %u (offset %u) mismatch\n", font->name, i,
+             s_text.offset);
+      return 1;
+    }
+  }
+
+  // 内容不变时重复设置不会触发重绘
+  uint16_t offset = s_text.offset;
+  matrix_led_text_set(&s_text, SCROLL_TEXT);
+  if (s_text.offset != offset || !s_text.drawn) {
+    printf("%s: setting identical text reset the layout\n", font->name);
+    return 1;
+  }
+
+  *dirty_per_step = (double)dirty_total / steps;
+  return 0;
+}
+
+// ==================== 耗时 ====================
+
+static void time_font(const matrix_led_font_t *font) {
+  const matrix_led_rect_t area = {0, 12, MATRIX_LED_WIDTH, font->height};
+  volatile uint32_t sink = 0;
+
+  double t0 = now_ns();
+  for (int i = 0; i < TIMING_ROUNDS; i++) {
+    reference_draw(s_frame, font, -(i % 64), 12, SCROLL_TEXT, FG, &area);
+  }
+  double reference_ns = (now_ns() - t0) / TIMING_ROUNDS;
+
+  t0 = now_ns();
+  for (int i = 0; i < TIMING_ROUNDS; i++) {
+    sink += matrix_led_font_draw(s_frame, font, -(i % 64), 12, SCROLL_TEXT, FG,
+                                 &area);
+  }
+  double draw_ns = (now_ns() - t0) / TIMING_ROUNDS;
+
+  matrix_led_text_init(&s_text, font, &area, FG, BG);
+  matrix_led_text_set(&s_text, SCROLL_TEXT);
+  t0 = now_ns();
+  for (int i = 0; i < TIMING_ROUNDS; i++) {
+    s_text.offset = (uint16_t)((s_text.offset + 1) % s_text.period);
+    sink += matrix_led_text_render(&s_text, s_frame);
+  }
+  double render_ns = (now_ns() - t0) / TIMING_ROUNDS;
+
+  matrix_led_text_render(&s_text, s_frame);
+  t0 = now_ns();
+  for (int i = 0; i < TIMING_ROUNDS; i++) {
+    sink += matrix_led_text_scroll(&s_text, s_frame, 1);
+  }
+  double scroll_ns = (now_ns() - t0) / TIMING_ROUNDS;
+  (void)sink;
+
+  printf("%-4s text %3u px | per-pixel %6.0f ns | row blit %6.0f ns | "
+         "full redraw %6.0f ns | incremental scroll %6.0f ns\n",
+         font->name, s_text.text_width, reference_ns, draw_ns, render_ns,
+         scroll_ns);
+}
+
+int main(void) {
+  const matrix_led_font_t *fonts[] = {&matrix_led_font_5x7,
+                                      &matrix_led_font_8x8};
+  printf("Matrix font engine (%dx%d, text object %zu bytes)\n",
+         MATRIX_LED_WIDTH, MATRIX_LED_HEIGHT, sizeof(matrix_led_text_t));
+
+  int failed = 0;
+  for (size_t i = 0; i < 2; i++) {
+    failed |= check_glyphs(fonts[i]);
+    failed |= check_draw(fonts[i]);
+    for (uint16_t step = 1; step <= 3; step++) {
+      double dirty_per_step = 0;
+      failed |= check_scroll(fonts[i], step, &dirty_per_step);
+      printf("%-4s scroll step %u: %.2f dirty rows/step (area %u rows)\n",
+             fonts[i]->name, step, dirty_per_step, s_text.area.height);
+    }
+  }
+  for (size_t i = 0; i < 2; i++) {
+    time_font(fonts[i]);
+  }
+
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
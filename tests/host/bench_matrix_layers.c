@@ -0,0 +1,323 @@
+/**
+ * @file bench_matrix_layers.c
+ * @brief 图层合成的正确性与耗时
+ *
+ * 场景为全屏彩虹动画层、带文字的KEYED叠加层和一个移动的半透明ALPHA精灵。
+ * 每一帧的合成结果都与独立的逐像素参考合成（每帧全部图层、全部像素从底色开始
+ * 混合）逐像素比较。耗时部分对比没有图层时每帧重画整个画面（动画 + 文字 +
+ * 精灵混合）与使用合成器（只更新变化的图层、只合成脏行）的开销：
+ *   - anim:   动画每帧变化，文字静止，精灵移动
+ *   - sprite: 背景和文字静止，只有精灵移动
+ *   - clock:  只有右上角的时钟文字每秒变化一次
+ */
+
+#include "led_kernel.h"
+#include "matrix_led_font.h"
+#include "matrix_led_layer.h"
+#include "matrix_led_render.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define FRAMES 3000
+#define FRAME_PERIOD_US 20000 // 50fps 动画时钟
+#define SPRITE_SIZE 8
+
+static const matrix_led_color_t WHITE = {255, 255, 255};
+static const matrix_led_color_t BLACK = {0, 0, 0};
+static const matrix_led_color_t CYAN = {0, 255, 255};
+
+static matrix_led_color_t s_frame[MATRIX_LED_COUNT];
+static matrix_led_color_t s_reference[MATRIX_LED_COUNT];
+static matrix_led_color_t s_sprite[SPRITE_SIZE * SPRITE_SIZE];
+static uint8_t s_sprite_alpha[SPRITE_SIZE * SPRITE_SIZE];
+
+typedef enum { SCENE_ANIM, SCENE_SPRITE, SCENE_CLOCK } scene_t;
+
+static const char *SCENE_NAMES[] = {"anim", "sprite", "clock"};
+
+/**
+ * @brief 合成器场景：底层动画、文字叠加层、精灵层
+ */
+typedef struct {
+  matrix_led_compositor_t compositor;
+  matrix_led_layer_t *anim;
+  matrix_led_layer_t *text;
+  matrix_led_layer_t *sprite;
+  matrix_led_animation_config_t config;
+} scene_layers_t;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void make_sprite(void) {
+  // 圆形精灵，边缘半透明
+  for (int y = 0; y < SPRITE_SIZE; y++) {
+    for (int x = 0; x < SPRITE_SIZE; x++) {
+      int dx = 2 * x - (SPRITE_SIZE - 1), dy = 2 * y - (SPRITE_SIZE - 1);
+      int d2 = dx * dx + dy * dy;
+      int i = y * SPRITE_SIZE + x;
+      s_sprite[i] = (matrix_led_color_t){255, (uint8_t)(x * 30), 40};
+      s_sprite_alpha[i] = d2 < 25 ? 255 : d2 < 50 ? 128 : 0;
+    }
+  }
+}
+
+static void sprite_position(uint32_t frame, int16_t *x, int16_t *y) {
+  *x = (int16_t)((int32_t)(frame % 44) - 6);
+  *y = (int16_t)(8 + (frame / 3) % 12);
+}
+
+static void clock_text(uint32_t frame, char *text, size_t size) {
+  uint32_t seconds = frame * FRAME_PERIOD_US / 1000000;
+  snprintf(text, size, "%02u", seconds % 60);
+}
+
+// ==================== 参考实现 ====================
+
+/**
+ * @brief 逐像素合成全部图层（无脏行、无遮挡剔除）
+ */
+static void reference_compose(const matrix_led_compositor_t *compositor,
+                              matrix_led_color_t *out) {
+  for (int sy = 0; sy < MATRIX_LED_HEIGHT; sy++) {
+    for (int sx = 0; sx < MATRIX_LED_WIDTH; sx++) {
+      matrix_led_color_t c = compositor->background;
+      for (int i = 0; i < compositor->count; i++) {
+        const matrix_led_layer_t *layer = compositor->layers[i];
+        const matrix_led_layer_config_t *cfg = &layer->config;
+        int lx = sx - cfg->x, ly = sy - cfg->y;
+        if (!cfg->visible || lx < 0 || ly < 0 || lx >= cfg->width ||
+            ly >= cfg->height) {
+          continue;
+        }
+        int index = ly * cfg->width + lx;
+        matrix_led_color_t src = layer->pixels[index];
+        uint8_t a = cfg->opacity;
+        if (cfg->format == MATRIX_LED_LAYER_KEYED &&
+            (src.r | src.g | src.b) == 0) {
+          a = 0;
+        } else if (cfg->format == MATRIX_LED_LAYER_ALPHA) {
+          a = led_kernel_scale8(layer->alpha[index], cfg->opacity);
+        }
+        c.r = led_kernel_lerp8(c.r, src.r, a);
+        c.g = led_kernel_lerp8(c.g, src.g, a);
+        c.b = led_kernel_lerp8(c.b, src.b, a);
+      }
+      out[sy * MATRIX_LED_WIDTH + sx] = c;
+    }
+  }
+}
+
+/**
+ * @brief 不使用图层时每帧重画整个画面
+ */
+static void redraw_flat(const matrix_led_animation_config_t *config,
+                        uint32_t frame, matrix_led_color_t *out) {
+  char clock[8];
+  clock_text(frame, clock, sizeof(clock));
+  matrix_led_render_builtin(MATRIX_LED_ANIM_RAINBOW, config,
+                            (uint64_t)frame * FRAME_PERIOD_US, out, NULL);
+  matrix_led_font_draw(out, &matrix_led_font_5x7, 1, 24, "robOS", WHITE, NULL);
+  matrix_led_font_draw(out, &matrix_led_font_5x7, 20, 1, clock, CYAN, NULL);
+
+  int16_t px, py;
+  sprite_position(frame, &px, &py);
+  for (int y = 0; y < SPRITE_SIZE; y++) {
+    for (int x = 0; x < SPRITE_SIZE; x++) {
+      int sx = px + x, sy = py + y;
+      int i = y * SPRITE_SIZE + x;
+      if (sx < 0 || sx >= MATRIX_LED_WIDTH || sy < 0 ||
+          sy >= MATRIX_LED_HEIGHT || s_sprite_alpha[i] == 0) {
+        continue;
+      }
+      matrix_led_color_t *d = &out[sy * MATRIX_LED_WIDTH + sx];
+      uint8_t a = led_kernel_scale8(s_sprite_alpha[i], 200);
+      d->r = led_kernel_lerp8(d->r, s_sprite[i].r, a);
+      d->g = led_kernel_lerp8(d->g, s_sprite[i].g, a);
+      d->b = led_kernel_lerp8(d->b, s_sprite[i].b, a);
+    }
+  }
+}
+
+// ==================== 合成器场景 ====================
+
+static int scene_init(scene_layers_t *s) {
+  memset(s, 0, sizeof(*s));
+  s->config.speed = 50;
+  s->config.primary_color = WHITE;
+  matrix_led_compositor_init(&s->compositor, BLACK);
+
+  // 故意按与z顺序不同的顺序创建
+  matrix_led_layer_config_t sprite = {.width = SPRITE_SIZE,
+                                      .height = SPRITE_SIZE,
+                                      .format = MATRIX_LED_LAYER_ALPHA,
+                                      .z = 2,
+                                      .opacity = 200,
+                                      .visible = true};
+  matrix_led_layer_config_t anim = {.format = MATRIX_LED_LAYER_OPAQUE,
+                                    .z = 0,
+                                    .opacity = 255,
+                                    .visible = true};
+  matrix_led_layer_config_t text = {.format = MATRIX_LED_LAYER_KEYED,
+                                    .z = 1,
+                                    .opacity = 255,
+                                    .visible = true};
+  if (matrix_led_compositor_add_layer(&s->compositor, &sprite, &s->sprite) !=
+          ESP_OK ||
+      matrix_led_compositor_add_layer(&s->compositor, &anim, &s->anim) !=
+          ESP_OK ||
+      matrix_led_compositor_add_layer(&s->compositor, &text, &s->text) !=
+          ESP_OK) {
+    return 1;
+  }
+
+  matrix_led_layer_blit(s->sprite, 0, 0, SPRITE_SIZE, SPRITE_SIZE, s_sprite,
+                        s_sprite_alpha);
+  matrix_led_layer_mark_dirty(
+      s->text, matrix_led_font_draw(s->text->pixels, &matrix_led_font_5x7, 1,
+                                    24, "robOS", WHITE, NULL));
+  matrix_led_layer_mark_dirty(
+      s->anim, matrix_led_render_builtin(MATRIX_LED_ANIM_RAINBOW, &s->config,
+                                         0, s->anim->pixels, NULL) == ESP_OK
+                   ? 0xFFFFFFFFu
+                   : 0);
+  return 0;
+}
+
+/**
+ * @brief 推进一帧：按场景更新图层，返回合成的脏行
+ */
+static uint32_t scene_step(scene_layers_t *s, scene_t scene, uint32_t frame) {
+  if (scene == SCENE_ANIM) {
+    uint32_t dirty = 0;
+    matrix_led_render_builtin(MATRIX_LED_ANIM_RAINBOW, &s->config,
+                              (uint64_t)frame * FRAME_PERIOD_US,
+                              s->anim->pixels, &dirty);
+    matrix_led_layer_mark_dirty(s->anim, dirty);
+  }
+
+  if (scene != SCENE_CLOCK) {
+    matrix_led_layer_config_t c = s->sprite->config;
+    sprite_position(frame, &c.x, &c.y);
+    matrix_led_compositor_update_layer(&s->compositor, s->sprite, &c);
+  }
+
+  // 时钟区域：文字变化时先擦除旧内容
+  char clock[8], previous[8];
+  clock_text(frame, clock, sizeof(clock));
+  clock_text(frame ? frame - 1 : 0, previous, sizeof(previous));
+  if (frame == 0 || strcmp(clock, previous) != 0) {
+    for (int y = 1; y < 8; y++) {
+      memset(&s->text->pixels[y * MATRIX_LED_WIDTH + 20], 0,
+             11 * sizeof(matrix_led_color_t));
+    }
+    matrix_led_layer_mark_dirty(s->text, 0xFEu);
+    matrix_led_font_draw(s->text->pixels, &matrix_led_font_5x7, 20, 1, clock,
+                         CYAN, NULL);
+  }
+
+  return matrix_led_compositor_compose(&s->compositor, s_frame);
+}
+
+static int check_scene(scene_t scene) {
+  scene_layers_t s;
+  if (scene_init(&s) != 0) {
+    printf("%s: failed to create layers\n", SCENE_NAMES[scene]);
+    return 1;
+  }
+
+  int failed = 0;
+  memset(s_frame, 0, sizeof(s_frame));
+  for (uint32_t f = 0; f < 400 && !failed; f++) {
+    scene_step(&s, scene, f);
+    reference_compose(&s.compositor, s_reference);
+    if (memcmp(s_frame, s_reference, sizeof(s_frame)) != 0) {
+      printf("%s: frame %u differs from reference composition\n",
+             SCENE_NAMES[scene], f);
+      failed = 1;
+    }
+  }
+
+  // 隐藏、改变不透明度、调整z顺序和删除图层后结果仍与参考一致
+  matrix_led_layer_config_t c = s.text->config;
+  c.opacity = 96;
+  c.z = 5;
+  matrix_led_compositor_update_layer(&s.compositor, s.text, &c);
+  matrix_led_compositor_compose(&s.compositor, s_frame);
+  reference_compose(&s.compositor, s_reference);
+  failed |= memcmp(s_frame, s_reference, sizeof(s_frame)) != 0;
+
+  c = s.anim->config;
+  c.visible = false;
+  matrix_led_compositor_update_layer(&s.compositor, s.anim, &c);
+  matrix_led_compositor_compose(&s.compositor, s_frame);
+  reference_compose(&s.compositor, s_reference);
+  failed |= memcmp(s_frame, s_reference, sizeof(s_frame)) != 0;
+
+  matrix_led_compositor_remove_layer(&s.compositor, s.sprite);
+  matrix_led_compositor_compose(&s.compositor, s_frame);
+  reference_compose(&s.compositor, s_reference);
+  failed |= memcmp(s_frame, s_reference, sizeof(s_frame)) != 0;
+  if (failed) {
+    printf("%s: layer property change mismatch\n", SCENE_NAMES[scene]);
+  }
+
+  matrix_led_compositor_deinit(&s.compositor);
+  return failed;
+}
+
+static void time_scene(scene_t scene) {
+  scene_layers_t s;
+  matrix_led_animation_config_t config = {.speed = 50, .primary_color = WHITE};
+  if (scene_init(&s) != 0) {
+    return;
+  }
+
+  double t0 = now_ns();
+  for (uint32_t f = 0; f < FRAMES; f++) {
+    redraw_flat(&config, scene == SCENE_ANIM ? f : 0, s_reference);
+  }
+  double flat_ns = (now_ns() - t0) / FRAMES;
+
+  memset(s_frame, 0, sizeof(s_frame));
+  matrix_led_compositor_compose(&s.compositor, s_frame);
+  uint32_t rows_before = s.compositor.composed_rows;
+  uint32_t blended_before = s.compositor.blended_pixels;
+  t0 = now_ns();
+  for (uint32_t f = 1; f <= FRAMES; f++) {
+    scene_step(&s, scene, f);
+  }
+  double layered_ns = (now_ns() - t0) / FRAMES;
+
+  printf("%-6s | full redraw %7.0f ns/frame | layers %7.0f ns/frame (%5.1fx) "
+         "| %5.2f rows, %6.1f layer px composed/frame\n",
+         SCENE_NAMES[scene], flat_ns, layered_ns,
+         layered_ns > 0 ? flat_ns / layered_ns : 0.0,
+         (double)(s.compositor.composed_rows - rows_before) / FRAMES,
+         (double)(s.compositor.blended_pixels - blended_before) / FRAMES);
+  matrix_led_compositor_deinit(&s.compositor);
+}
+
+int main(void) {
+  printf("Matrix layer compositor (%dx%d, %d layers max, layer struct %zu "
+         "bytes)\n",
+         MATRIX_LED_WIDTH, MATRIX_LED_HEIGHT, MATRIX_LED_LAYER_MAX,
+         sizeof(matrix_led_layer_t));
+  make_sprite();
+
+  int failed = 0;
+  for (int scene = SCENE_ANIM; scene <= SCENE_CLOCK; scene++) {
+    failed |= check_scene((scene_t)scene);
+  }
+  for (int scene = SCENE_ANIM; scene <= SCENE_CLOCK; scene++) {
+    time_scene((scene_t)scene);
+  }
+
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
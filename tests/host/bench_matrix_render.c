@@ -0,0 +1,317 @@
+/**
+ * @file bench_matrix_render.c
+ * @brief 无硬件的矩阵渲染路径基准测试
+ *
+ * 按 matrix_led 动画任务和刷新任务的流程逐帧执行：绘制（内置动画渲染或自定义
+ * 动画解码）→ 提交（三缓冲翻页时的整帧复制）→ 校正并写入输出后端 → 输出。
+ * 输出后端为内存后端，每种 matrix_led_animation_type_t 渲染N帧，报告帧率、
+ * 各阶段耗时、每帧写入后端的像素数和渲染路径占用的堆内存。
+ *
+ * 用法: bench_matrix_render [帧数] [PPM输出目录]
+ */
+
+#include "led_kernel.h"
+#include "matrix_led_anim.h"
+#include "matrix_led_correction.h"
+#include "matrix_led_output.h"
+#include "matrix_led_render.h"
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_FRAMES 2000
+#define FRAME_PERIOD_US 20000 // 50fps 动画时钟
+#define CUSTOM_FRAMES 64
+#define CUSTOM_PATH "bench_render_custom.mla"
+
+enum { STAGE_RENDER, STAGE_PRESENT, STAGE_CORRECT, STAGE_OUTPUT, STAGE_COUNT };
+
+static const char *STAGE_NAMES[STAGE_COUNT] = {"render", "present", "correct",
+                                               "output"};
+
+static const struct {
+  matrix_led_animation_type_t type;
+  const char *name;
+} ANIMATIONS[] = {
+    {MATRIX_LED_ANIM_STATIC, "static"}, {MATRIX_LED_ANIM_RAINBOW, "rainbow"},
+    {MATRIX_LED_ANIM_WAVE, "wave"},     {MATRIX_LED_ANIM_BREATHE, "breathe"},
+    {MATRIX_LED_ANIM_ROTATE, "rotate"}, {MATRIX_LED_ANIM_FADE, "fade"},
+    {MATRIX_LED_ANIM_CUSTOM, "custom"},
+};
+
+/**
+ * @brief 模拟组件运行时的渲染路径状态
+ */
+typedef struct {
+  matrix_led_color_t *framebuffers[3]; ///< 三缓冲
+  matrix_led_color_t *sent;            ///< 上次发送的校正后像素
+  uint8_t back;                        ///< 后台缓冲索引
+  matrix_led_output_t *output;         ///< 内存后端
+  matrix_led_correction_t correction;  ///< 校正查找表
+  matrix_led_anim_reader_t *reader;    ///< 自定义动画读取器
+  matrix_led_anim_ring_t *ring;        ///< 自定义动画预取环
+} pipeline_t;
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static size_t heap_in_use(void) {
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks + info.hblkhd;
+}
+
+// ==================== 自定义动画素材 ====================
+
+static int create_custom_file(void) {
+  matrix_led_anim_writer_t *writer = malloc(sizeof(*writer));
+  matrix_led_color_t *frame = malloc(MATRIX_LED_COUNT * sizeof(*frame));
+  if (writer == NULL || frame == NULL) {
+    free(writer);
+    free(frame);
+    return 1;
+  }
+
+  int failed =
+      matrix_led_anim_writer_open(writer, CUSTOM_PATH, NULL, 0) != ESP_OK ||
+      matrix_led_anim_writer_begin(writer, "custom", FRAME_PERIOD_US / 1000,
+                                   true) != ESP_OK;
+  for (uint32_t f = 0; f < CUSTOM_FRAMES && !failed; f++) {
+    // 8x8 方块沿对角线移动，每帧只有少数几行变化
+    memset(frame, 0, MATRIX_LED_COUNT * sizeof(*frame));
+    uint32_t o = f % (MATRIX_LED_WIDTH - 8);
+    for (uint32_t y = 0; y < 8; y++) {
+      for (uint32_t x = 0; x < 8; x++) {
+        frame[(o + y) * MATRIX_LED_WIDTH + o + x] =
+            (matrix_led_color_t){(uint8_t)(x * 32), 128, (uint8_t)(y * 32)};
+      }
+    }
+    failed = matrix_led_anim_writer_add_frame(writer, frame, 0) != ESP_OK;
+  }
+  failed |= matrix_led_anim_writer_end(writer) != ESP_OK;
+  failed |= matrix_led_anim_writer_close(writer) != ESP_OK;
+
+  free(writer);
+  free(frame);
+  return failed;
+}
+
+// ==================== 渲染路径 ====================
+
+static int pipeline_init(pipeline_t *p, bool custom) {
+  memset(p, 0, sizeof(*p));
+  for (int i = 0; i < 3; i++) {
+    p->framebuffers[i] = calloc(MATRIX_LED_COUNT, sizeof(matrix_led_color_t));
+  }
+  p->sent = calloc(MATRIX_LED_COUNT, sizeof(matrix_led_color_t));
+  if (matrix_led_output_new_memory(&p->output) != ESP_OK) {
+    return 1;
+  }
+
+  // 与默认色彩校正配置相近：50% 亮度、白点和 Gamma 2.2
+  matrix_led_correction_params_t params = {
+      .brightness = 50,
+      .enabled = true,
+      .white_point_enabled = true,
+      .red_scale = 1.0f,
+      .green_scale = 0.9f,
+      .blue_scale = 0.8f,
+      .gamma_enabled = true,
+      .gamma = 2.2f,
+  };
+  matrix_led_correction_build(&p->correction, &params);
+
+  if (custom) {
+    p->reader = malloc(sizeof(matrix_led_anim_reader_t));
+    p->ring = malloc(sizeof(matrix_led_anim_ring_t));
+    if (p->reader == NULL || p->ring == NULL ||
+        matrix_led_anim_open(p->reader, CUSTOM_PATH) != ESP_OK ||
+        matrix_led_anim_select(p->reader, NULL) != ESP_OK) {
+      return 1;
+    }
+    matrix_led_anim_ring_init(p->ring);
+  }
+  return 0;
+}
+
+static void pipeline_deinit(pipeline_t *p) {
+  if (p->reader != NULL) {
+    matrix_led_anim_close(p->reader);
+  }
+  free(p->reader);
+  free(p->ring);
+  matrix_led_output_del(p->output);
+  free(p->sent);
+  for (int i = 0; i < 3; i++) {
+    free(p->framebuffers[i]);
+  }
+}
+
+/**
+ * @brief 绘制一帧到后台缓冲区，返回脏行
+ */
+static uint32_t pipeline_render(pipeline_t *p, matrix_led_animation_type_t type,
+                                const matrix_led_animation_config_t *config,
+                                uint64_t elapsed_us) {
+  matrix_led_color_t *back = p->framebuffers[p->back];
+  uint32_t dirty_rows = 0;
+
+  if (type == MATRIX_LED_ANIM_CUSTOM) {
+    size_t length;
+    const uint8_t *record = matrix_led_anim_ring_peek(p->ring, &length);
+    if (record != NULL) {
+      matrix_led_anim_decode_record(p->reader, record, length, back, NULL,
+                                    &dirty_rows);
+      matrix_led_anim_ring_pop(p->ring);
+    }
+  } else if (type != MATRIX_LED_ANIM_STATIC) {
+    matrix_led_render_builtin(type, config, elapsed_us, back, &dirty_rows);
+  }
+  return dirty_rows;
+}
+
+static int run_animation(matrix_led_animation_type_t type, const char *name,
+                         uint32_t frames, const char *ppm_dir) {
+  size_t heap_before = heap_in_use();
+
+  pipeline_t p;
+  if (pipeline_init(&p, type == MATRIX_LED_ANIM_CUSTOM) != 0) {
+    printf("%s: failed to set up pipeline\n", name);
+    pipeline_deinit(&p);
+    return 1;
+  }
+  size_t heap_pipeline = heap_in_use() - heap_before;
+
+  matrix_led_animation_config_t config = {
+      .type = type,
+      .frame_delay_ms = FRAME_PERIOD_US / 1000,
+      .loop = true,
+      .primary_color = {0, 0, 255},
+      .secondary_color = {255, 0, 0},
+      .speed = 50,
+  };
+
+  double stage_ns[STAGE_COUNT] = {0};
+  double stage_max_ns[STAGE_COUNT] = {0};
+  matrix_led_output_stats_t stats = {0};
+  uint32_t refreshed = 0;
+  size_t heap_peak = heap_pipeline;
+
+  double t_start = now_ns();
+  for (uint32_t f = 0; f < frames; f++) {
+    double t[STAGE_COUNT + 1];
+
+    // 读取任务的预取在设备上与渲染并行进行，不计入渲染时间
+    if (p.ring != NULL) {
+      matrix_led_anim_ring_fill(p.ring, p.reader);
+    }
+
+    t[0] = now_ns();
+    uint32_t dirty_rows =
+        pipeline_render(&p, type, &config, (uint64_t)f * FRAME_PERIOD_US);
+
+    // 提交：翻页后新的后台缓冲区继承刚提交的内容
+    t[1] = now_ns();
+    const matrix_led_color_t *front = p.framebuffers[p.back];
+    uint8_t next = (uint8_t)((p.back + 1) % 3);
+    memcpy(p.framebuffers[next], front,
+           MATRIX_LED_COUNT * sizeof(matrix_led_color_t));
+    p.back = next;
+
+    // 刷新任务：脏行校正并写入后端（首帧整帧发送）
+    t[2] = now_ns();
+    bool changed = false;
+    matrix_led_output_write_frame(p.output, &p.correction, front, p.sent,
+                                  f == 0 ? 0xFFFFFFFFu : dirty_rows, &stats,
+                                  &changed);
+
+    t[3] = now_ns();
+    if (changed) {
+      p.output->refresh(p.output);
+      refreshed++;
+    }
+    t[4] = now_ns();
+
+    for (int s = 0; s < STAGE_COUNT; s++) {
+      double d = t[s + 1] - t[s];
+      stage_ns[s] += d;
+      if (d > stage_max_ns[s]) {
+        stage_max_ns[s] = d;
+      }
+    }
+
+    size_t heap = heap_in_use() - heap_before;
+    if (heap > heap_peak) {
+      heap_peak = heap;
+    }
+  }
+  double total_ns = now_ns() - t_start;
+
+  printf("%-8s %6.0f fps |", name, frames / (total_ns / 1e9));
+  for (int s = 0; s < STAGE_COUNT; s++) {
+    printf(" %s %5.2f/%6.2f us |", STAGE_NAMES[s], stage_ns[s] / frames / 1000,
+           stage_max_ns[s] / 1000);
+  }
+  printf(" %6.1f px/frame | %5u refresh | heap %zu B (peak %zu B)\n",
+         (double)stats.written_pixels / frames, refreshed, heap_pipeline,
+         heap_peak);
+
+  int failed = 0;
+  if (ppm_dir != NULL) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s.ppm", ppm_dir, name);
+    if (matrix_led_output_memory_dump_ppm(p.output, path, 8) != ESP_OK) {
+      printf("%s: failed to write %s\n", name, path);
+      failed = 1;
+    }
+  }
+
+  // 内存后端锁存的帧必须与逐像素校正最后一帧的结果一致
+  uint32_t count = 0;
+  const matrix_led_color_t *latched =
+      matrix_led_output_memory_get_frame(p.output, &count);
+  const matrix_led_color_t *last = p.framebuffers[(p.back + 2) % 3];
+  for (uint32_t i = 0; i < MATRIX_LED_COUNT && !failed; i++) {
+    matrix_led_color_t expect =
+        matrix_led_correction_apply_pixel(&p.correction, last[i]);
+    if (memcmp(&expect, &latched[i], sizeof(expect)) != 0) {
+      printf("%s: output mismatch at pixel %u\n", name, i);
+      failed = 1;
+    }
+  }
+
+  pipeline_deinit(&p);
+  return failed;
+}
+
+int main(int argc, char **argv) {
+  uint32_t frames = argc > 1 ? (uint32_t)strtoul(argv[1], NULL, 10) : 0;
+  if (frames == 0) {
+    frames = DEFAULT_FRAMES;
+  }
+  const char *ppm_dir = argc > 2 ? argv[2] : NULL;
+
+  if (create_custom_file() != 0) {
+    printf("failed to create %s\n", CUSTOM_PATH);
+    return 1;
+  }
+
+  printf("Matrix render pipeline (%dx%d, %u frames, memory output, "
+         "stage avg/max)\n",
+         MATRIX_LED_WIDTH, MATRIX_LED_HEIGHT, frames);
+
+  int failed = 0;
+  for (size_t i = 0; i < sizeof(ANIMATIONS) / sizeof(ANIMATIONS[0]); i++) {
+    failed |= run_animation(ANIMATIONS[i].type, ANIMATIONS[i].name, frames,
+                            ppm_dir);
+  }
+
+  remove(CUSTOM_PATH);
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
@@ -0,0 +1,268 @@
+/**
+ * @file bench_matrix_stream.c
+ * @brief 流式动画播放在SD卡延迟尖峰下的欠载次数
+ *
+ * 按50fps的帧截止时间消费动画，同时按固定时间表注入SD卡访问停顿（模拟FAT
+ * 簇链查找、卡内部擦除等造成的长尾延迟）。对比两种方式：
+ * - direct: 渲染线程在截止时间直接从文件解码（原实现）
+ * - ring:   读取线程通过预取环提前读入帧记录，渲染线程只做内存解码
+ * 每帧解码结果都与生成的原始帧逐像素比较。
+ */
+
+#include "led_kernel.h"
+#include "matrix_led_anim.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define FRAME_PERIOD_US 20000 // 50fps
+#define PLAY_FRAMES 150
+
+typedef void (*generate_fn_t)(uint32_t frame, matrix_led_color_t *out);
+
+/** SD卡停顿时间表（相对播放开始） */
+static const struct {
+  int64_t start_us;
+  int64_t duration_us;
+} STALLS[] = {
+    {500000, 120000},
+    {1500000, 250000},
+    {2300000, 60000},
+};
+
+static const matrix_led_color_t RED = {255, 0, 0};
+static const matrix_led_color_t YELLOW = {255, 255, 0};
+
+static matrix_led_anim_writer_t s_writer;
+static matrix_led_anim_reader_t s_reader;
+static matrix_led_anim_ring_t s_ring;
+static matrix_led_color_t s_frame[MATRIX_LED_COUNT];
+static matrix_led_color_t s_expected[MATRIX_LED_COUNT];
+
+static int64_t s_start_us;
+static volatile bool s_stop;
+
+// ==================== 测试内容 ====================
+
+static void generate_sprite(uint32_t frame, matrix_led_color_t *out) {
+  memset(out, 0, MATRIX_LED_COUNT * sizeof(*out));
+  int ox = (int)(frame % (MATRIX_LED_WIDTH - 8));
+  int oy = (int)((frame / 3) % (MATRIX_LED_HEIGHT - 8));
+  for (int y = 0; y < 8; y++) {
+    for (int x = 0; x < 8; x++) {
+      if ((x + y) % 2 == 0 || x == 0 || y == 7) {
+        out[(oy + y) * MATRIX_LED_WIDTH + ox + x] =
+            (x + y) % 4 == 0 ? YELLOW : RED;
+      }
+    }
+  }
+}
+
+static void generate_rainbow(uint32_t frame, matrix_led_color_t *out) {
+  for (int y = 0; y < MATRIX_LED_HEIGHT; y++) {
+    for (int x = 0; x < MATRIX_LED_WIDTH; x++) {
+      uint16_t hue = (uint16_t)((x + y) * LED_KERNEL_ANGLE_FULL /
+                                    (MATRIX_LED_WIDTH + MATRIX_LED_HEIGHT) +
+                                frame * 512);
+      led_kernel_rgb_t c = led_kernel_hsv_to_rgb(hue, 255, 255);
+      out[y * MATRIX_LED_WIDTH + x] = (matrix_led_color_t){c.r, c.g, c.b};
+    }
+  }
+}
+
+// ==================== 模拟SD卡 ====================
+
+static int64_t now_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+static void sleep_until(int64_t deadline_us) {
+  int64_t wait = deadline_us - now_us();
+  if (wait > 0) {
+    usleep((useconds_t)wait);
+  }
+}
+
+/** 访问SD卡前调用：处于停顿区间时阻塞到区间结束 */
+static void sd_access(void) {
+  int64_t t = now_us() - s_start_us;
+  for (size_t i = 0; i < sizeof(STALLS) / sizeof(STALLS[0]); i++) {
+    if (t >= STALLS[i].start_us &&
+        t < STALLS[i].start_us + STALLS[i].duration_us) {
+      sleep_until(s_start_us + STALLS[i].start_us + STALLS[i].duration_us);
+      return;
+    }
+  }
+}
+
+static void *producer_thread(void *arg) {
+  (void)arg;
+  while (!s_stop) {
+    sd_access();
+    esp_err_t ret = matrix_led_anim_ring_fill(&s_ring, &s_reader);
+    if (ret != ESP_ERR_NO_MEM) {
+      break;
+    }
+    usleep(1000); // 对应读取任务等待渲染任务取帧后的通知
+  }
+  return NULL;
+}
+
+// ==================== 基准测试 ====================
+
+static int create_file(const char *path, generate_fn_t generate) {
+  if (matrix_led_anim_writer_open(&s_writer, path, NULL, 0) != ESP_OK ||
+      matrix_led_anim_writer_begin(&s_writer, "stream", FRAME_PERIOD_US / 1000,
+                                   false) != ESP_OK) {
+    return 1;
+  }
+  for (uint32_t f = 0; f < PLAY_FRAMES; f++) {
+    generate(f, s_frame);
+    if (matrix_led_anim_writer_add_frame(&s_writer, s_frame, 0) != ESP_OK) {
+      return 1;
+    }
+  }
+  return matrix_led_anim_writer_end(&s_writer) != ESP_OK ||
+         matrix_led_anim_writer_close(&s_writer) != ESP_OK;
+}
+
+/**
+ * @brief 按帧截止时间播放，返回欠载次数（连续欠载计一次），出错返回-1
+ */
+static int play(const char *path, generate_fn_t generate, bool use_ring,
+                uint32_t *max_buffered, double *worst_late_ms) {
+  if (matrix_led_anim_open(&s_reader, path) != ESP_OK ||
+      matrix_led_anim_select(&s_reader, NULL) != ESP_OK) {
+    return -1;
+  }
+
+  pthread_t producer;
+  matrix_led_anim_ring_init(&s_ring);
+  s_stop = false;
+  s_start_us = now_us();
+  if (use_ring) {
+    // 与 matrix_led_stream_start 一样先预填缓冲区
+    matrix_led_anim_ring_fill(&s_ring, &s_reader);
+    pthread_create(&producer, NULL, producer_thread, NULL);
+  }
+
+  int underruns = 0;
+  bool starved = false;
+  int64_t worst_late = 0;
+  *max_buffered = 0;
+  memset(s_frame, 0, sizeof(s_frame));
+
+  uint32_t f = 0;
+  int64_t deadline = s_start_us;
+  while (f < PLAY_FRAMES) {
+    sleep_until(deadline);
+
+    // 动画时钟落后时连续解码多帧，与 matrix_led_animate_custom 相同
+    int64_t tick = now_us();
+    while (f < PLAY_FRAMES && s_start_us + (int64_t)f * FRAME_PERIOD_US <= tick) {
+      esp_err_t ret;
+      if (use_ring) {
+        uint32_t buffered = matrix_led_anim_ring_frames(&s_ring);
+        if (buffered > *max_buffered) {
+          *max_buffered = buffered;
+        }
+        size_t length;
+        const uint8_t *record = matrix_led_anim_ring_peek(&s_ring, &length);
+        if (record == NULL) {
+          if (!starved) {
+            starved = true;
+            underruns++;
+          }
+          break;
+        }
+        ret = matrix_led_anim_decode_record(&s_reader, record, length,
+                                            s_frame, NULL, NULL);
+        matrix_led_anim_ring_pop(&s_ring);
+      } else {
+        int64_t before = now_us();
+        sd_access();
+        if (now_us() - before > FRAME_PERIOD_US && !starved) {
+          starved = true;
+          underruns++;
+        }
+        ret = matrix_led_anim_read_frame(&s_reader, s_frame, NULL, NULL);
+      }
+
+      generate(f, s_expected);
+      if (ret != ESP_OK || memcmp(s_frame, s_expected, sizeof(s_frame)) != 0) {
+        printf("frame %u mismatch\n", f);
+        s_stop = true;
+        if (use_ring) {
+          pthread_join(producer, NULL);
+        }
+        matrix_led_anim_close(&s_reader);
+        return -1;
+      }
+
+      int64_t late = now_us() - (s_start_us + (int64_t)f * FRAME_PERIOD_US);
+      if (late > worst_late) {
+        worst_late = late;
+      }
+      if (late <= FRAME_PERIOD_US) {
+        starved = false;
+      }
+      f++;
+    }
+    deadline += FRAME_PERIOD_US;
+  }
+
+  s_stop = true;
+  if (use_ring) {
+    pthread_join(producer, NULL);
+  }
+  matrix_led_anim_close(&s_reader);
+  *worst_late_ms = worst_late / 1000.0;
+  return underruns;
+}
+
+static int run_case(const char *name, generate_fn_t generate) {
+  char path[64];
+  snprintf(path, sizeof(path), "bench_stream_%s.mla", name);
+  if (create_file(path, generate) != 0) {
+    printf("%s: failed to create %s\n", name, path);
+    return 1;
+  }
+
+  int failed = 0;
+  for (int mode = 0; mode < 2; mode++) {
+    uint32_t max_buffered = 0;
+    double worst_late_ms = 0;
+    int underruns = play(path, generate, mode == 1, &max_buffered,
+                         &worst_late_ms);
+    if (underruns < 0) {
+      printf("%s: playback failed\n", name);
+      failed = 1;
+      break;
+    }
+    printf("%-8s %-6s | %3d frames @ 50fps | underruns %d | worst late "
+           "%6.1f ms | max buffered %3u frames\n",
+           name, mode ? "ring" : "direct", PLAY_FRAMES, underruns,
+           worst_late_ms, max_buffered);
+  }
+
+  remove(path);
+  return failed;
+}
+
+int main(void) {
+  printf("Matrix animation streaming (ring %d bytes, %zu SD stalls)\n",
+         MATRIX_LED_ANIM_RING_SIZE, sizeof(STALLS) / sizeof(STALLS[0]));
+
+  int failed = 0;
+  failed |= run_case("sprite", generate_sprite);
+  failed |= run_case("rainbow", generate_rainbow);
+
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
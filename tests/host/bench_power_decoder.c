@@ -0,0 +1,461 @@
+/**
+ * @file bench_power_decoder.c
+ * @brief 电源芯片 UART 帧解码器的正确性、重同步和耗时
+ *
+ * 1. 连续帧流（载荷和校验和可能是 0xFF）按随机长度分块送入：必须逐帧按顺序
+ *    解出，时间戳等于每帧最后一个字节的到达时间；一次送入、随机分块和每次
+ *    只取一个样本三种方式结果完全相同。
+ * 2. 在帧流中插入噪声字节、丢字节和翻转比特，按字节位置对照原始帧：统计
+ *    完好帧的解出率、每次损坏丢失的帧数和误收帧（校验和碰撞）。
+ * 3. 随机字节模糊测试：输出的帧必须通过校验，且每个输入字节都恰好计入
+ *    已解出的帧、丢弃字节或窗口中的一项。
+ * 4. 与原来的轮询方式对比：每 100ms 读 8 字节找帧头，能看到的帧占比。
+ * 5. 报告每字节解码耗时。
+ *
+ * 可选参数为抓取的原始字节流文件，逐块解码并输出统计：
+ *   ./bench_power_decoder [抓取文件]
+ */
+
+#include "power_monitor_decoder.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BAUD_RATE 9600
+#define FRAMES 200000
+#define MAX_STREAM (FRAMES * POWER_CHIP_PACKET_SIZE * 2)
+#define MAX_CHUNK 120 // UART FIFO 满阈值的默认值
+#define FUZZ_BYTES 4000000
+#define TIMING_ROUNDS 50
+#define POLL_PERIOD_US 100000
+#define POLL_READ 8
+#define UART_BUFFER 1024
+
+static uint32_t s_rng = 0x13579bdf;
+
+static uint32_t rng(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 17;
+  s_rng ^= s_rng << 5;
+  return s_rng;
+}
+
+static int chance_per_mille(int per_mille) {
+  return (int)(rng() % 1000) < per_mille;
+}
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* ============================================================================
+ * 字节流
+ * ============================================================================
+ */
+
+typedef struct {
+  uint8_t *bytes;
+  int32_t *frame_end; // 字节是完好帧的最后一个字节时为帧序号，否则为 -1
+  size_t len;
+  uint32_t frames;    // 写入的帧数
+  uint32_t intact;    // 未损坏的帧数
+  uint32_t damaged;   // 损坏事件数
+} stream_t;
+
+static void stream_alloc(stream_t *s) {
+  s->bytes = malloc(MAX_STREAM);
+  s->frame_end = malloc(MAX_STREAM * sizeof(int32_t));
+  s->len = 0;
+  s->frames = s->intact = s->damaged = 0;
+}
+
+static void stream_free(stream_t *s) {
+  free(s->bytes);
+  free(s->frame_end);
+}
+
+static void stream_put(stream_t *s, uint8_t byte, int32_t frame_end) {
+  s->bytes[s->len] = byte;
+  s->frame_end[s->len] = frame_end;
+  s->len++;
+}
+
+static void make_frame(uint8_t *frame) {
+  frame[0] = POWER_CHIP_HEADER;
+  // 偏向 0xFF 附近的载荷，让帧头字节也出现在数据里
+  frame[1] = (rng() & 3) == 0 ? 0xFF : 20 + rng() % 10;
+  frame[2] = (rng() & 3) == 0 ? 0xFF - (rng() & 1) : rng() % 60;
+  frame[3] = (uint8_t)(frame[0] + frame[1] + frame[2]);
+}
+
+/**
+ * @brief 生成帧流，按千分比注入噪声字节、丢字节和翻转比特
+ */
+static void build_stream(stream_t *s, uint32_t frames, int noise, int drop,
+                         int flip) {
+  s->len = 0;
+  s->frames = s->intact = s->damaged = 0;
+  for (uint32_t f = 0; f < frames; f++) {
+    uint8_t frame[POWER_CHIP_PACKET_SIZE];
+    make_frame(frame);
+    s->frames++;
+
+    if (chance_per_mille(noise)) {
+      int n = 1 + rng() % 6;
+      for (int k = 0; k < n; k++) {
+        stream_put(s, (rng() & 1) ? POWER_CHIP_HEADER : (uint8_t)rng(), -1);
+      }
+      s->damaged++;
+    }
+
+    int dropped = chance_per_mille(drop) ? (int)(rng() % 4) : -1;
+    int flipped = chance_per_mille(flip) ? (int)(rng() % 4) : -1;
+    bool intact = dropped < 0 && flipped < 0;
+    s->damaged += !intact;
+    s->intact += intact;
+    for (int k = 0; k < POWER_CHIP_PACKET_SIZE; k++) {
+      if (k == dropped) {
+        continue;
+      }
+      uint8_t byte = frame[k];
+      if (k == flipped) {
+        byte ^= 1u << (rng() % 8);
+      }
+      bool last = intact && k == POWER_CHIP_PACKET_SIZE - 1;
+      stream_put(s, byte, last ? (int32_t)f : -1);
+    }
+  }
+}
+
+static int64_t byte_time_us(const power_chip_decoder_t *d, size_t index) {
+  return 1000000 + (int64_t)index * d->byte_time_us;
+}
+
+/**
+ * @brief 按随机分块解码整个流，max_batch 为每次调用可取的样本数
+ */
+static size_t decode_stream(power_chip_decoder_t *d, const stream_t *s,
+                            size_t max_chunk, size_t max_batch,
+                            power_chip_sample_t *out) {
+  power_chip_sample_t batch[MAX_CHUNK];
+  size_t count = 0;
+  size_t pos = 0;
+  while (pos < s->len) {
+    size_t n = max_chunk >= s->len ? s->len : 1 + rng() % max_chunk;
+    if (n > s->len - pos) {
+      n = s->len - pos;
+    }
+    int64_t end = byte_time_us(d, pos + n - 1);
+    size_t off = 0;
+    while (off < n) {
+      size_t used = 0;
+      size_t got = power_chip_decoder_feed(d, s->bytes + pos + off, n - off,
+                                           end, batch, max_batch, &used);
+      memcpy(out + count, batch, got * sizeof(*batch));
+      count += got;
+      off += used;
+    }
+    pos += n;
+  }
+  return count;
+}
+
+/* ============================================================================
+ * 检查
+ * ============================================================================
+ */
+
+static int samples_equal(const power_chip_sample_t *a,
+                         const power_chip_sample_t *b, size_t count) {
+  for (size_t i = 0; i < count; i++) {
+    if (memcmp(a[i].raw, b[i].raw, POWER_CHIP_PACKET_SIZE) != 0 ||
+        a[i].timestamp_us != b[i].timestamp_us ||
+        a[i].sequence != b[i].sequence || a[i].crc_valid != b[i].crc_valid) {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+static int check_clean(power_chip_sample_t *a, power_chip_sample_t *b) {
+  stream_t s;
+  power_chip_decoder_t d;
+  int failed = 0;
+  stream_alloc(&s);
+  build_stream(&s, FRAMES, 0, 0, 0);
+
+  power_chip_decoder_init(&d, BAUD_RATE, true);
+  size_t whole = decode_stream(&d, &s, s.len, MAX_CHUNK, a);
+  for (size_t i = 0; i < whole && !failed; i++) {
+    size_t last = (i + 1) * POWER_CHIP_PACKET_SIZE - 1;
+    if (a[i].sequence != i || a[i].timestamp_us != byte_time_us(&d, last) ||
+        memcmp(a[i].raw, s.bytes + last - 3, POWER_CHIP_PACKET_SIZE) != 0) {
+      printf("clean stream: frame %zu mismatch\n", i);
+      failed = 1;
+    }
+  }
+  if (whole != FRAMES || d.stats.crc_errors || d.stats.skipped_bytes ||
+      d.stats.resyncs) {
+    printf("clean stream: %zu/%d frames, crc %u, skipped %u, resyncs %u\n",
+           whole, FRAMES, d.stats.crc_errors, d.stats.skipped_bytes,
+           d.stats.resyncs);
+    failed = 1;
+  }
+
+  // 随机分块、每次只取一个样本必须得到同样的结果
+  const size_t batches[] = {MAX_CHUNK, 1};
+  for (int k = 0; k < 2; k++) {
+    power_chip_decoder_init(&d, BAUD_RATE, true);
+    size_t split = decode_stream(&d, &s, MAX_CHUNK, batches[k], b);
+    if (split != whole || !samples_equal(a, b, whole)) {
+      printf("clean stream: chunked decode (batch %zu) differs\n", batches[k]);
+      failed = 1;
+    }
+  }
+
+  printf("clean stream: %zu frames, %zu bytes, split/whole decode %s\n", whole,
+         s.len, failed ? "DIFFER" : "identical");
+  stream_free(&s);
+  return failed;
+}
+
+static int check_damaged(power_chip_sample_t *out) {
+  stream_t s;
+  power_chip_decoder_t d;
+  stream_alloc(&s);
+  build_stream(&s, FRAMES, 5, 5, 5);
+
+  power_chip_decoder_init(&d, BAUD_RATE, true);
+  size_t count = decode_stream(&d, &s, MAX_CHUNK, MAX_CHUNK, out);
+
+  uint32_t recovered = 0;
+  uint32_t false_accepts = 0;
+  for (size_t i = 0; i < count; i++) {
+    size_t last = (size_t)((out[i].timestamp_us - byte_time_us(&d, 0)) /
+                           d.byte_time_us);
+    if (last < s.len && s.frame_end[last] >= 0) {
+      recovered++;
+    } else {
+      false_accepts++;
+    }
+  }
+
+  uint32_t lost = s.intact - recovered;
+  double rate = 100.0 * recovered / s.intact;
+  printf("damaged stream: %u damage events, intact frames %u/%u (%.2f%%), "
+         "%.2f lost per event, %u false accepts (%.3f%% of output)\n",
+         s.damaged, recovered, s.intact, rate, (double)lost / s.damaged,
+         false_accepts, 100.0 * false_accepts / count);
+  printf("                crc errors %u, resyncs %u, skipped bytes %u\n",
+         d.stats.crc_errors, d.stats.resyncs, d.stats.skipped_bytes);
+
+  // 每次损坏最多牵连相邻的一帧；8 位和校验下误收率约为 1/256 的损坏窗口
+  int failed = (double)lost / s.damaged > 1.0 || false_accepts > s.damaged / 8;
+  stream_free(&s);
+  return failed;
+}
+
+static int check_fuzz(void) {
+  static uint8_t buf[MAX_CHUNK];
+  power_chip_sample_t batch[MAX_CHUNK];
+  power_chip_decoder_t d;
+  int failed = 0;
+  size_t total = 0;
+
+  for (int mode = 0; mode < 2 && !failed; mode++) {
+    power_chip_decoder_init(&d, BAUD_RATE, mode == 0);
+    total = 0;
+    while (total < FUZZ_BYTES) {
+      size_t n = 1 + rng() % MAX_CHUNK;
+      for (size_t k = 0; k < n; k++) {
+        uint32_t r = rng();
+        buf[k] = (r & 3) == 0 ? POWER_CHIP_HEADER : (uint8_t)(r >> 8);
+      }
+      size_t used = 0;
+      size_t max = 1 + rng() % MAX_CHUNK;
+      size_t got = power_chip_decoder_feed(&d, buf, n, 0, batch, max, &used);
+      for (size_t k = 0; k < got; k++) {
+        if (batch[k].raw[0] != POWER_CHIP_HEADER ||
+            (mode == 0 && !power_chip_frame_valid(batch[k].raw))) {
+          failed = 1;
+        }
+      }
+      total += used;
+      if (rng() % 1000 == 0) {
+        power_chip_decoder_reset(&d);
+      }
+    }
+    if (failed) {
+      printf("fuzz: invalid frame emitted (verify_crc=%d)\n", mode == 0);
+    }
+  }
+
+  // 最后一轮不做重置，检查字节计数
+  power_chip_decoder_init(&d, BAUD_RATE, true);
+  total = 0;
+  for (int round = 0; round < 10000; round++) {
+    size_t n = 1 + rng() % MAX_CHUNK;
+    for (size_t k = 0; k < n; k++) {
+      uint32_t r = rng();
+      buf[k] = (r & 1) ? POWER_CHIP_HEADER : (uint8_t)(r >> 8);
+    }
+    size_t used = 0;
+    power_chip_decoder_feed(&d, buf, n, 0, batch, MAX_CHUNK, &used);
+    total += used;
+  }
+  size_t accounted = (size_t)d.stats.frames * POWER_CHIP_PACKET_SIZE +
+                     d.stats.skipped_bytes + d.count;
+  if (accounted != total) {
+    printf("fuzz: %zu bytes in, %zu accounted\n", total, accounted);
+    failed = 1;
+  }
+
+  printf("fuzz: %d random bytes per mode, %u frames from %zu header-heavy "
+         "bytes, byte accounting %s\n",
+         FUZZ_BYTES, d.stats.frames, total, failed ? "FAILED" : "ok");
+  return failed;
+}
+
+/**
+ * @brief 模拟原来的轮询：每 100ms 从 UART 缓冲区读 8 字节，取第一个帧头
+ */
+static void compare_polling(void) {
+  stream_t s;
+  stream_alloc(&s);
+  build_stream(&s, 24000, 0, 0, 0); // 9600 波特率下满速约 100 秒
+
+  power_chip_decoder_t d;
+  power_chip_decoder_init(&d, BAUD_RATE, true);
+
+  size_t fifo_head = 0; // 缓冲区中最早的字节
+  size_t arrived = 0;
+  uint32_t seen = 0;
+  uint32_t overflowed = 0;
+  for (int64_t t = POLL_PERIOD_US; arrived < s.len; t += POLL_PERIOD_US) {
+    arrived = (size_t)(t / d.byte_time_us);
+    if (arrived > s.len) {
+      arrived = s.len;
+    }
+    if (arrived - fifo_head > UART_BUFFER) {
+      overflowed += arrived - fifo_head - UART_BUFFER;
+      fifo_head = arrived - UART_BUFFER;
+    }
+    if (arrived - fifo_head < POWER_CHIP_PACKET_SIZE) {
+      continue;
+    }
+    size_t n = arrived - fifo_head < POLL_READ ? arrived - fifo_head
+                                                : POLL_READ;
+    for (size_t k = 0; k + POWER_CHIP_PACKET_SIZE <= n; k++) {
+      if (s.bytes[fifo_head + k] == POWER_CHIP_HEADER) {
+        seen++;
+        break;
+      }
+    }
+    fifo_head += n;
+  }
+
+  printf("100 ms polling at %d baud: %u of %u frames seen (%.1f%%), %u bytes "
+         "lost to buffer overflow; event decoder: all frames\n",
+         BAUD_RATE, seen, s.frames, 100.0 * seen / s.frames, overflowed);
+  stream_free(&s);
+}
+
+static void timing(void) {
+  stream_t s;
+  power_chip_sample_t batch[MAX_CHUNK];
+  power_chip_decoder_t d;
+  stream_alloc(&s);
+  build_stream(&s, FRAMES, 5, 5, 5);
+  power_chip_decoder_init(&d, BAUD_RATE, true);
+
+  double start = now_ns();
+  for (int r = 0; r < TIMING_ROUNDS; r++) {
+    for (size_t pos = 0; pos < s.len; pos += 64) {
+      size_t n = s.len - pos < 64 ? s.len - pos : 64;
+      size_t off = 0;
+      while (off < n) {
+        size_t used = 0;
+        power_chip_decoder_feed(&d, s.bytes + pos + off, n - off, 0, batch,
+                                MAX_CHUNK, &used);
+        off += used;
+      }
+    }
+  }
+  double ns = (now_ns() - start) / ((double)TIMING_ROUNDS * s.len);
+
+  printf("decode: %.2f ns/byte (%.0f MB/s), 9600 baud needs 960 bytes/s\n",
+         ns, 1e3 / ns);
+  stream_free(&s);
+}
+
+/**
+ * @brief 解码抓取的原始字节流文件
+ */
+static int decode_capture(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    perror(path);
+    return 1;
+  }
+
+  uint8_t buf[MAX_CHUNK];
+  power_chip_sample_t batch[MAX_CHUNK];
+  power_chip_decoder_t d;
+  power_chip_decoder_init(&d, BAUD_RATE, true);
+
+  size_t total = 0;
+  float v_min = 1e9f, v_max = 0.0f, i_min = 1e9f, i_max = 0.0f;
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    size_t off = 0;
+    while (off < n) {
+      size_t used = 0;
+      size_t got = power_chip_decoder_feed(&d, buf + off, n - off, 0, batch,
+                                           MAX_CHUNK, &used);
+      for (size_t k = 0; k < got; k++) {
+        v_min = batch[k].voltage < v_min ? batch[k].voltage : v_min;
+        v_max = batch[k].voltage > v_max ? batch[k].voltage : v_max;
+        i_min = batch[k].current < i_min ? batch[k].current : i_min;
+        i_max = batch[k].current > i_max ? batch[k].current : i_max;
+      }
+      off += used;
+    }
+    total += n;
+  }
+  fclose(f);
+
+  printf("%s: %zu bytes, %u frames, crc errors %u, resyncs %u, skipped "
+         "bytes %u\n",
+         path, total, d.stats.frames, d.stats.crc_errors, d.stats.resyncs,
+         d.stats.skipped_bytes);
+  if (d.stats.frames > 0) {
+    printf("voltage %.1f-%.1f V, current %.1f-%.1f A\n", v_min, v_max, i_min,
+           i_max);
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1) {
+    return decode_capture(argv[1]);
+  }
+
+  int failed = 0;
+  power_chip_sample_t *a = malloc(FRAMES * 2 * sizeof(*a));
+  power_chip_sample_t *b = malloc(FRAMES * 2 * sizeof(*b));
+
+  failed |= check_clean(a, b);
+  failed |= check_damaged(a);
+  failed |= check_fuzz();
+  compare_polling();
+  timing();
+
+  free(a);
+  free(b);
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
@@ -0,0 +1,535 @@
+/**
+ * @file bench_power_log.c
+ * @brief 电源遥测日志：块格式往返、损坏检测、无锁环和SD卡停顿下的丢样
+ *
+ * 1. CRC-32 与标准校验值比较。
+ * 2. 模拟 240 帧/秒的电源芯片数据（成批到达、偶尔断线超过 16.7 秒、时间
+ *    倒退、超量程值）：编码成块后逐块解码，与输入逐样本比较，并检查块
+ *    序号连续、文件按块对齐。
+ * 3. 翻转一个字节、全零块、写到一半断电的块：都被识别，扫描解码跳过坏块
+ *    后其余样本完整。
+ * 4. 生产者/消费者两个线程：弹出数 + 丢弃数 = 推入数，顺序不乱，丢样
+ *    之后的第一个样本带 DROPPED 标志。
+ * 5. 虚拟时间模拟写入任务（100ms 轮询、每块写入几毫秒、按时间表注入
+ *    0.3~3 秒的SD卡停顿）：不同环大小下的丢样数和最高水位。
+ * 6. 与同样内容的 CSV 文本比较体积，以及每个样本的编码/解码耗时。
+ */
+
+#include "power_monitor_log.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FRAME_US 4167 // 9600 波特率下满速约 240 帧/秒
+#define STREAM_SAMPLES 200000
+#define THREAD_SAMPLES 2000000
+#define SIM_SECONDS 600
+#define TIMING_SAMPLES 5000000
+
+static uint64_t s_rng = 0x9e3779b97f4a7c15ull;
+
+static uint32_t rng(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 7;
+  s_rng ^= s_rng << 17;
+  return (uint32_t)(s_rng >> 32);
+}
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+/* ============================================================================
+ * 日志文件（内存中）
+ * ============================================================================
+ */
+
+typedef struct {
+  uint8_t *data;
+  size_t size;
+  size_t capacity;
+} log_file_t;
+
+static void file_append(log_file_t *file, const uint8_t *block) {
+  if (file->size + POWER_LOG_BLOCK_SIZE > file->capacity) {
+    file->capacity = file->capacity ? file->capacity * 2 : 1 << 20;
+    file->data = realloc(file->data, file->capacity);
+  }
+  memcpy(file->data + file->size, block, POWER_LOG_BLOCK_SIZE);
+  file->size += POWER_LOG_BLOCK_SIZE;
+}
+
+/** 与 power_monitor.c 中写入任务相同：块满或时间差放不下时写出再重试 */
+static void encode_all(const power_log_sample_t *samples, size_t count,
+                       uint32_t session, log_file_t *file) {
+  uint8_t block[POWER_LOG_BLOCK_SIZE];
+  power_log_encoder_t encoder;
+
+  power_log_encoder_init(&encoder, block, session);
+  for (size_t i = 0; i < count; i++) {
+    if (!power_log_encoder_add(&encoder, &samples[i])) {
+      power_log_encoder_finish(&encoder, 0);
+      file_append(file, block);
+      power_log_encoder_add(&encoder, &samples[i]);
+    }
+  }
+  if (encoder.count > 0) {
+    power_log_encoder_finish(&encoder, 0);
+    file_append(file, block);
+  }
+}
+
+typedef struct {
+  size_t blocks;
+  size_t bad_blocks;
+  size_t sequence_gaps;
+} scan_result_t;
+
+/**
+ * @brief 与 power_log_decode 相同的扫描：按块对齐读取，坏块之后逐字节找
+ *        下一个有效块
+ */
+static size_t decode_all(const log_file_t *file, power_log_sample_t *out,
+                         size_t max, scan_result_t *result) {
+  power_log_sample_t block_samples[POWER_LOG_BLOCK_RECORDS];
+  power_log_block_info_t info;
+  bool have_last = false;
+  uint32_t last_sequence = 0;
+  size_t count = 0;
+  size_t offset = 0;
+  bool in_bad = false;
+
+  memset(result, 0, sizeof(*result));
+  while (offset + POWER_LOG_BLOCK_SIZE <= file->size) {
+    if (power_log_block_parse(file->data + offset, &info) != ESP_OK) {
+      if (!in_bad) {
+        result->bad_blocks++;
+        in_bad = true;
+      }
+      offset++;
+      continue;
+    }
+    in_bad = false;
+    result->blocks++;
+    if (have_last && info.sequence != last_sequence + 1) {
+      result->sequence_gaps++;
+    }
+    have_last = true;
+    last_sequence = info.sequence;
+
+    size_t n = power_log_block_decode(file->data + offset, &info,
+                                      block_samples);
+    for (size_t i = 0; i < n && count < max; i++) {
+      out[count++] = block_samples[i];
+    }
+    offset += POWER_LOG_BLOCK_SIZE;
+  }
+  if (offset < file->size) {
+    result->bad_blocks++; // 末尾不足一块
+  }
+  return count;
+}
+
+static bool same_sample(const power_log_sample_t *a,
+                        const power_log_sample_t *b) {
+  return a->time_us == b->time_us && a->voltage_mv == b->voltage_mv &&
+         a->current_ma == b->current_ma && a->flags == b->flags;
+}
+
+/** 模拟的电源芯片数据：成批到达，偶尔断线、时间倒退和超量程 */
+static size_t generate_stream(power_log_sample_t *samples, size_t count) {
+  int64_t t = 1000000;
+  size_t gaps = 0;
+
+  for (size_t i = 0; i < count; i++) {
+    uint32_t r = rng() % 10000;
+    if (r == 0) {
+      t += 20000000 + rng() % 40000000; // 断线超过 24 位时间差
+      gaps++;
+    } else if (r == 1) {
+      t -= 50000; // 时间倒退
+    } else if (r < 300) {
+      t += rng() % 50; // 同一批读出的帧
+    } else {
+      t += FRAME_US - 200 + rng() % 400;
+    }
+
+    float voltage = 24.0f + (float)(rng() % 2000) / 1000.0f - 1.0f;
+    float current = (float)(rng() % 8000) / 1000.0f;
+    if (r == 2) {
+      voltage = 80.0f; // 超出 65535 mV
+      current = -1.0f;
+    }
+    uint8_t flags = 0;
+    if (rng() % 500 == 0) {
+      flags |= POWER_LOG_FLAG_CRC_INVALID;
+    }
+    if (rng() % 2000 == 0) {
+      flags |= POWER_LOG_FLAG_TRANSIENT;
+    }
+    samples[i] = power_log_make_sample(t, voltage, current, flags);
+  }
+  return gaps;
+}
+
+/* ============================================================================
+ * CRC、往返和损坏
+ * ============================================================================
+ */
+
+static int check_crc(void) {
+  const char *text = "123456789";
+  uint32_t crc = power_log_crc32(0, (const uint8_t *)text, strlen(text));
+  // 分段计算结果相同
+  uint32_t split = power_log_crc32(0, (const uint8_t *)text, 4);
+  split = power_log_crc32(split, (const uint8_t *)text + 4, 5);
+
+  printf("crc: %08X (expected CBF43926), split %08X\n", crc, split);
+  return crc != 0xCBF43926u || split != crc;
+}
+
+static int check_round_trip(void) {
+  power_log_sample_t *samples = malloc(STREAM_SAMPLES * sizeof(*samples));
+  power_log_sample_t *decoded = malloc(STREAM_SAMPLES * sizeof(*decoded));
+  log_file_t file = {0};
+  scan_result_t scan;
+  int failed = 0;
+
+  size_t gaps = generate_stream(samples, STREAM_SAMPLES);
+  encode_all(samples, STREAM_SAMPLES, 0x12345678, &file);
+  size_t n = decode_all(&file, decoded, STREAM_SAMPLES, &scan);
+
+  size_t mismatches = 0;
+  for (size_t i = 0; i < n && i < STREAM_SAMPLES; i++) {
+    mismatches += !same_sample(&samples[i], &decoded[i]);
+  }
+  power_log_sample_t clamped =
+      power_log_make_sample(0, 80.0f, -1.0f, POWER_LOG_FLAG_DROPPED);
+  power_log_sample_t rounded = power_log_make_sample(0, 23.9996f, 0.0004f, 0);
+
+  printf("round trip: %d samples (%zu gaps > 16.7 s), %zu blocks, "
+         "%zu decoded, %zu mismatches, %zu sequence gaps\n",
+         STREAM_SAMPLES, gaps, scan.blocks, n, mismatches, scan.sequence_gaps);
+  printf("            %.2f samples per block (%d max), file %zu bytes "
+         "(%zu %% %d = %zu)\n",
+         (double)STREAM_SAMPLES / scan.blocks, (int)POWER_LOG_BLOCK_RECORDS,
+         file.size, file.size, POWER_LOG_BLOCK_SIZE,
+         file.size % POWER_LOG_BLOCK_SIZE);
+
+  failed = n != STREAM_SAMPLES || mismatches > 0 || scan.bad_blocks > 0 ||
+           scan.sequence_gaps > 0 || file.size % POWER_LOG_BLOCK_SIZE != 0 ||
+           clamped.voltage_mv != 65535 || clamped.current_ma != 0 ||
+           rounded.voltage_mv != 24000 || rounded.current_ma != 0;
+
+  free(file.data);
+  free(samples);
+  free(decoded);
+  return failed;
+}
+
+static int check_corruption(void) {
+  const size_t count = 20 * POWER_LOG_BLOCK_RECORDS;
+  power_log_sample_t *samples = malloc(count * sizeof(*samples));
+  power_log_sample_t *decoded = malloc(count * sizeof(*decoded));
+  power_log_block_info_t info;
+  log_file_t file = {0};
+  scan_result_t scan;
+  int failed = 0;
+
+  int64_t t = 0;
+  for (size_t i = 0; i < count; i++) {
+    t += FRAME_US;
+    samples[i] = power_log_make_sample(t, 24.0f, 1.0f, 0);
+  }
+  encode_all(samples, count, 1, &file);
+
+  // 单个块：翻转一位、全零、版本不同
+  uint8_t block[POWER_LOG_BLOCK_SIZE];
+  memcpy(block, file.data, sizeof(block));
+  block[100] ^= 0x04;
+  esp_err_t flipped = power_log_block_parse(block, &info);
+  memset(block, 0, sizeof(block));
+  esp_err_t zero = power_log_block_parse(block, &info);
+  memcpy(block, file.data, sizeof(block));
+  block[4] = POWER_LOG_VERSION + 1;
+  esp_err_t version = power_log_block_parse(block, &info);
+  printf("corruption: bit flip 0x%x, zero block 0x%x, other version 0x%x\n",
+         flipped, zero, version);
+  failed |= flipped != ESP_ERR_INVALID_CRC || zero != ESP_ERR_NOT_FOUND ||
+            version != ESP_ERR_NOT_SUPPORTED;
+
+  // 文件中间翻转一个字节，再把最后一块截成半块（写到一半断电）
+  file.data[5 * POWER_LOG_BLOCK_SIZE + 1000] ^= 0xFF;
+  file.size -= POWER_LOG_BLOCK_SIZE / 2;
+  size_t n = decode_all(&file, decoded, count, &scan);
+  size_t expected = count - 2 * POWER_LOG_BLOCK_RECORDS;
+  size_t mismatches = 0;
+  for (size_t i = 0, j = 0; i < n; i++, j++) {
+    if (j == 5 * POWER_LOG_BLOCK_RECORDS) {
+      j += POWER_LOG_BLOCK_RECORDS; // 跳过坏块
+    }
+    mismatches += !same_sample(&samples[j], &decoded[i]);
+  }
+  printf("            damaged file: %zu blocks good, %zu bad, %zu/%zu samples "
+         "recovered, %zu mismatches\n",
+         scan.blocks, scan.bad_blocks, n, expected, mismatches);
+  failed |= scan.bad_blocks != 2 || n != expected || mismatches > 0;
+
+  free(file.data);
+  free(samples);
+  free(decoded);
+  return failed;
+}
+
+/* ============================================================================
+ * 两线程无锁环
+ * ============================================================================
+ */
+
+static power_log_ring_t s_ring;
+static volatile bool s_producer_done;
+
+static void *producer_thread(void *arg) {
+  (void)arg;
+  for (uint32_t i = 0; i < THREAD_SAMPLES; i++) {
+    power_log_sample_t sample = power_log_make_sample(i, 24.0f, 1.0f, 0);
+    power_log_ring_push(&s_ring, &sample);
+    if (i % 16 == 0) {
+      sched_yield(); // 单核机器上也让两个线程交替运行
+    }
+  }
+  __atomic_store_n(&s_producer_done, true, __ATOMIC_RELEASE);
+  return NULL;
+}
+
+static int check_threads(void) {
+  power_log_sample_t batch[32];
+  uint64_t popped = 0;
+  size_t out_of_order = 0;
+  size_t flag_errors = 0;
+  int64_t last = -1;
+  pthread_t producer;
+
+  power_log_ring_init(&s_ring, 256);
+  s_producer_done = false;
+  pthread_create(&producer, NULL, producer_thread, NULL);
+
+  for (;;) {
+    bool done = __atomic_load_n(&s_producer_done, __ATOMIC_ACQUIRE);
+    size_t n = power_log_ring_pop(&s_ring, batch, 32);
+    for (size_t i = 0; i < n; i++) {
+      if (batch[i].time_us <= last) {
+        out_of_order++;
+      }
+      // 前面有样本被丢弃时，当且仅当这一个带 DROPPED 标志
+      bool skipped = batch[i].time_us != last + 1;
+      bool flagged = (batch[i].flags & POWER_LOG_FLAG_DROPPED) != 0;
+      flag_errors += skipped != flagged;
+      last = batch[i].time_us;
+    }
+    popped += n;
+    if (n == 0 && done) {
+      break;
+    }
+    if (rng() % 4096 == 0) {
+      struct timespec pause = {0, 20000}; // 消费者偶尔停顿
+      nanosleep(&pause, NULL);
+    }
+  }
+  pthread_join(producer, NULL);
+
+  printf("threads: %d pushed, %llu popped + %u dropped, high water %u/%u, "
+         "%zu out of order, %zu flag errors\n",
+         THREAD_SAMPLES, (unsigned long long)popped, s_ring.dropped,
+         s_ring.high_water, s_ring.capacity, out_of_order, flag_errors);
+
+  int failed = popped + s_ring.dropped != THREAD_SAMPLES || out_of_order > 0 ||
+               flag_errors > 0 || s_ring.high_water > s_ring.capacity;
+  power_log_ring_deinit(&s_ring);
+  return failed;
+}
+
+/* ============================================================================
+ * SD卡停顿模拟
+ * ============================================================================
+ */
+
+/** SD卡停顿时间表（秒）：该时刻之后的第一次块写入耗时 duration */
+static const struct {
+  double start_s;
+  double duration_s;
+} STALLS[] = {
+    {30.0, 0.3}, {95.0, 0.8}, {180.0, 1.5}, {300.0, 2.5}, {450.0, 3.0},
+};
+
+#define WRITE_US 6000 // 一次打开/追加 4KB/关闭
+#define POLL_US 100000
+
+/** 在 start 开始的一次块写入何时结束，next_stall 为下一个未发生的停顿 */
+static int64_t write_done_us(int64_t start, size_t *next_stall) {
+  if (*next_stall < sizeof(STALLS) / sizeof(STALLS[0]) &&
+      start >= (int64_t)(STALLS[*next_stall].start_s * 1e6)) {
+    // 卡内部擦除等：停在写块的过程中，写入任务阻塞
+    return start + (int64_t)(STALLS[(*next_stall)++].duration_s * 1e6);
+  }
+  return start + WRITE_US;
+}
+
+typedef struct {
+  uint32_t dropped;
+  uint32_t high_water;
+  uint32_t blocks;
+} sim_result_t;
+
+/**
+ * @brief 1 毫秒步长的虚拟时间：生产者按帧推入，写入任务按轮询周期取出，
+ *        写块期间不取
+ */
+static void simulate(uint32_t ring_samples, sim_result_t *result) {
+  power_log_ring_t ring;
+  power_log_encoder_t encoder;
+  uint8_t block[POWER_LOG_BLOCK_SIZE];
+  power_log_sample_t batch[32];
+  int64_t next_frame = 0;
+  int64_t busy_until = 0;
+  int64_t next_poll = 0;
+  size_t next_stall = 0;
+
+  power_log_ring_init(&ring, ring_samples);
+  power_log_encoder_init(&encoder, block, 0);
+  memset(result, 0, sizeof(*result));
+
+  for (int64_t t = 0; t < (int64_t)SIM_SECONDS * 1000000; t += 1000) {
+    while (next_frame <= t) {
+      power_log_sample_t sample =
+          power_log_make_sample(next_frame, 24.0f, 1.0f, 0);
+      power_log_ring_push(&ring, &sample);
+      next_frame += FRAME_US;
+    }
+    if (t < busy_until || t < next_poll) {
+      continue;
+    }
+
+    // 写入任务醒来：取到块满就写，写完继续取，取空后等下一个轮询周期
+    bool wrote = false;
+    size_t n;
+    while (!wrote && (n = power_log_ring_pop(&ring, batch, 1)) > 0) {
+      if (!power_log_encoder_add(&encoder, &batch[0])) {
+        power_log_encoder_finish(&encoder, ring.dropped);
+        power_log_encoder_add(&encoder, &batch[0]);
+        busy_until = write_done_us(t, &next_stall);
+        result->blocks++;
+        wrote = true;
+      }
+    }
+    if (!wrote) {
+      next_poll = t + POLL_US;
+    }
+  }
+
+  result->dropped = ring.dropped;
+  result->high_water = ring.high_water;
+  power_log_ring_deinit(&ring);
+}
+
+static int check_stalls(void) {
+  static const uint32_t sizes[] = {128, 256, 512, 1024, 2048};
+  double stalled = 0.0;
+  int failed = 0;
+
+  for (size_t i = 0; i < sizeof(STALLS) / sizeof(STALLS[0]); i++) {
+    stalled += STALLS[i].duration_s;
+  }
+  printf("sd stalls: %d s at %.0f frames/s, %zu stalls (%.1f s in total, "
+         "longest %.1f s), poll %d ms, block write %d ms\n",
+         SIM_SECONDS, 1e6 / FRAME_US, sizeof(STALLS) / sizeof(STALLS[0]),
+         stalled, STALLS[sizeof(STALLS) / sizeof(STALLS[0]) - 1].duration_s,
+         POLL_US / 1000, WRITE_US / 1000);
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+    sim_result_t result;
+    simulate(sizes[i], &result);
+    printf("  ring %4u (%5.2f s): %6u dropped, high water %4u, %u blocks\n",
+           sizes[i], sizes[i] * FRAME_US / 1e6, result.dropped,
+           result.high_water, result.blocks);
+    // 默认的 1024 要扛住 3 秒的停顿
+    if (sizes[i] >= 1024 && result.dropped > 0) {
+      failed = 1;
+    }
+  }
+  return failed;
+}
+
+/* ============================================================================
+ * 体积和耗时
+ * ============================================================================
+ */
+
+static void timing(void) {
+  power_log_sample_t *samples = malloc(TIMING_SAMPLES * sizeof(*samples));
+  log_file_t file = {0};
+
+  int64_t t = 0;
+  for (uint32_t i = 0; i < TIMING_SAMPLES; i++) {
+    t += FRAME_US - 200 + rng() % 400;
+    samples[i] = power_log_make_sample(t, 24.0f + (rng() % 100) / 100.0f,
+                                       (rng() % 8000) / 1000.0f, 0);
+  }
+
+  double start = now_ns();
+  encode_all(samples, TIMING_SAMPLES, 1, &file);
+  double encode_ns = (now_ns() - start) / TIMING_SAMPLES;
+
+  power_log_sample_t block_samples[POWER_LOG_BLOCK_RECORDS];
+  power_log_block_info_t info;
+  size_t decoded = 0;
+  start = now_ns();
+  for (size_t off = 0; off < file.size; off += POWER_LOG_BLOCK_SIZE) {
+    if (power_log_block_parse(file.data + off, &info) == ESP_OK) {
+      decoded += power_log_block_decode(file.data + off, &info, block_samples);
+    }
+  }
+  double decode_ns = (now_ns() - start) / decoded;
+
+  // 与 power_log_decode 输出的 CSV 比较
+  size_t csv = 0;
+  char line[96];
+  for (uint32_t i = 0; i < TIMING_SAMPLES; i++) {
+    const power_log_sample_t *s = &samples[i];
+    csv += snprintf(line, sizeof(line), "%08X,%.6f,%.3f,%.3f,%.3f,%u\n", 1u,
+                    s->time_us / 1e6, s->voltage_mv / 1000.0,
+                    s->current_ma / 1000.0,
+                    s->voltage_mv / 1000.0 * s->current_ma / 1000.0, s->flags);
+  }
+
+  printf("size: %.2f bytes per sample (CSV %.2f, %.1fx), %.1f KB/h at %.0f "
+         "frames/s\n",
+         (double)file.size / TIMING_SAMPLES, (double)csv / TIMING_SAMPLES,
+         (double)csv / file.size,
+         (double)file.size / TIMING_SAMPLES * 3600e6 / FRAME_US / 1024,
+         1e6 / FRAME_US);
+  printf("timing: encode %.1f ns, decode %.1f ns per sample (CRC included)\n",
+         encode_ns, decode_ns);
+
+  free(file.data);
+  free(samples);
+}
+
+int main(void) {
+  int failed = 0;
+
+  failed |= check_crc();
+  failed |= check_round_trip();
+  failed |= check_corruption();
+  failed |= check_threads();
+  failed |= check_stalls();
+  timing();
+
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
@@ -0,0 +1,435 @@
+/**
+ * @file bench_power_stats.c
+ * @brief 电源统计引擎：精度、滑动窗口、分位数估计和能量积分
+ *
+ * 1. 1000 万个 24V 附近的样本：Welford 均值/方差与高精度参考值比较，并与
+ *    原来的 float 递推平均 (avg*(n-1)+x)/n 对比。随机拆分后合并的结果与
+ *    顺序累加一致。
+ * 2. 带抖动的时间戳和随机查询时刻：1s/1min/1h 窗口与按相同分桶规则逐样本
+ *    计算的参考值比较。
+ * 3. 正态、均匀、双峰（带跌落的供电）、量化（芯片整数伏）、长尾（电流）
+ *    和单调漂移：P² 估计的 p50/p95/p99 与排序后的精确值比较，按秩误差
+ *    评价。
+ * 4. 功率按不均匀间隔到达（成批读出、偶尔断线）：梯形积分与解析能量比较，
+ *    并与平均功率×运行时间、样本数×标称间隔两种做法对比。
+ * 5. 每个样本的更新耗时。
+ */
+
+#include "power_monitor_stats.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define PRECISION_SAMPLES 10000000
+#define WINDOW_SAMPLES 400000
+#define WINDOW_QUERIES 200
+#define QUANTILE_SAMPLES 200000
+#define ENERGY_SECONDS 7200
+#define TIMING_SAMPLES 5000000
+
+static uint64_t s_rng = 0x9e3779b97f4a7c15ull;
+
+static uint32_t rng(void) {
+  s_rng ^= s_rng << 13;
+  s_rng ^= s_rng >> 7;
+  s_rng ^= s_rng << 17;
+  return (uint32_t)(s_rng >> 32);
+}
+
+static double drand(void) { return (rng() + 0.5) / 4294967296.0; }
+
+static double gauss(void) {
+  return sqrt(-2.0 * log(drand())) * cos(2.0 * M_PI * drand());
+}
+
+static double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static int cmp_float(const void *a, const void *b) {
+  float x = *(const float *)a, y = *(const float *)b;
+  return (x > y) - (x < y);
+}
+
+/* ============================================================================
+ * 精度
+ * ============================================================================
+ */
+
+static int check_precision(void) {
+  power_stats_acc_t acc;
+  power_stats_acc_reset(&acc);
+  float naive = 0.0f;
+  long double sum = 0.0L;
+
+  float *x = malloc(PRECISION_SAMPLES * sizeof(float));
+  for (uint32_t i = 0; i < PRECISION_SAMPLES; i++) {
+    x[i] = (float)(24.0 + 0.05 * gauss() + 0.5 * sin(i * 1e-5));
+    sum += x[i];
+  }
+  long double mean = sum / PRECISION_SAMPLES;
+  long double m2 = 0.0L;
+  for (uint32_t i = 0; i < PRECISION_SAMPLES; i++) {
+    long double d = x[i] - mean;
+    m2 += d * d;
+  }
+  double stddev = (double)sqrtl(m2 / (PRECISION_SAMPLES - 1));
+
+  for (uint32_t i = 0; i < PRECISION_SAMPLES; i++) {
+    power_stats_acc_add(&acc, x[i]);
+    naive = (naive * (i) + x[i]) / (i + 1); // 原来的写法
+  }
+
+  // 随机拆成若干段后合并
+  power_stats_acc_t merged, part;
+  power_stats_acc_reset(&merged);
+  uint32_t pos = 0;
+  while (pos < PRECISION_SAMPLES) {
+    uint32_t len = 1 + rng() % 300000;
+    if (len > PRECISION_SAMPLES - pos) {
+      len = PRECISION_SAMPLES - pos;
+    }
+    power_stats_acc_reset(&part);
+    for (uint32_t i = pos; i < pos + len; i++) {
+      power_stats_acc_add(&part, x[i]);
+    }
+    power_stats_acc_merge(&merged, &part);
+    pos += len;
+  }
+
+  double welford_err = fabs(acc.mean - (double)mean);
+  double naive_err = fabs(naive - (double)mean);
+  double sd = sqrt(acc.m2 / (acc.count - 1));
+  double sd_err = fabs(sd - stddev) / stddev;
+  double merged_err = fabs(merged.mean - acc.mean);
+  double merged_sd_err =
+      fabs(sqrt(merged.m2 / (merged.count - 1)) - sd) / stddev;
+
+  printf("precision: %d samples, mean %.6f V, stddev %.6f V\n",
+         PRECISION_SAMPLES, (double)mean, stddev);
+  printf("           Welford mean error %.2e V, stddev error %.2e (rel); "
+         "float (avg*(n-1)+x)/n error %.2e V\n",
+         welford_err, sd_err, naive_err);
+  printf("           merged from random parts: mean %.2e V, stddev %.2e "
+         "(rel) from sequential\n",
+         merged_err, merged_sd_err);
+
+  free(x);
+  return welford_err > 1e-9 || sd_err > 1e-9 || merged_err > 1e-9 ||
+         merged_sd_err > 1e-9 || merged.count != acc.count;
+}
+
+/* ============================================================================
+ * 滑动窗口
+ * ============================================================================
+ */
+
+typedef struct {
+  int64_t t;
+  float v;
+} sample_t;
+
+static int64_t floor_div(int64_t a, int64_t b) {
+  int64_t q = a / b;
+  return (a < 0 && a % b != 0) ? q - 1 : q;
+}
+
+static int check_windows(void) {
+  power_stats_engine_t engine;
+  power_stats_init(&engine, 1000000);
+
+  sample_t *samples = malloc(WINDOW_SAMPLES * sizeof(sample_t));
+  int64_t t = -5000000; // 也覆盖负时间
+  int next_query = WINDOW_SAMPLES / WINDOW_QUERIES;
+  int errors = 0, queries = 0;
+  double worst = 0.0;
+
+  for (int i = 0; i < WINDOW_SAMPLES; i++) {
+    // 多数间隔 ~10ms，偶尔长时间无数据
+    uint32_t r = rng() % 1000;
+    t += r == 0 ? (int64_t)(rng() % 600) * 1000000 : 5000 + rng() % 10000;
+    float v = (float)(12.0 + 3.0 * sin(t * 1e-8) + 0.2 * gauss());
+    samples[i] = (sample_t){t, v};
+    power_stats_add(&engine, POWER_STATS_VOLTAGE, v, t);
+
+    if (i < next_query) {
+      continue;
+    }
+    next_query += 1 + rng() % (2 * WINDOW_SAMPLES / WINDOW_QUERIES);
+    queries++;
+
+    int64_t now = t + (rng() % 3 == 0 ? (int64_t)(rng() % 120) * 1000000 : 0);
+    power_stats_channel_summary_t summary;
+    power_stats_summarize(&engine, POWER_STATS_VOLTAGE, now, &summary);
+
+    for (int w = 0; w < POWER_STATS_WINDOW_COUNT; w++) {
+      int64_t bucket = power_stats_window_us(w) / POWER_STATS_WINDOW_BUCKETS;
+      int64_t first = floor_div(now, bucket) - (POWER_STATS_WINDOW_BUCKETS - 1);
+      power_stats_acc_t ref;
+      power_stats_acc_reset(&ref);
+      for (int j = i; j >= 0 && floor_div(samples[j].t, bucket) >= first;
+           j--) {
+        power_stats_acc_add(&ref, samples[j].v);
+      }
+      const power_stats_summary_t *s = &summary.window[w];
+      if (s->count != ref.count) {
+        if (errors++ < 3) {
+          printf("window %d at %lld: %llu samples, expected %llu\n", w,
+                 (long long)now, (unsigned long long)s->count,
+                 (unsigned long long)ref.count);
+        }
+        continue;
+      }
+      if (ref.count == 0) {
+        continue;
+      }
+      double sd = ref.count > 1 ? sqrt(ref.m2 / (ref.count - 1)) : 0.0;
+      double err = fmax(fabs(s->mean - ref.mean), fabs(s->stddev - sd));
+      worst = fmax(worst, err);
+      if (err > 1e-4 || s->min != ref.min || s->max != ref.max) {
+        if (errors++ < 3) {
+          printf("window %d: mean %f/%f sd %f/%f min %f/%f max %f/%f\n", w,
+                 s->mean, ref.mean, s->stddev, sd, s->min, ref.min, s->max,
+                 ref.max);
+        }
+      }
+    }
+  }
+
+  printf("windows: %d queries over %.1f h of jittered samples with gaps, "
+         "worst mean/stddev difference %.1e, %s\n",
+         queries, (t + 5000000) / 3.6e9, worst, errors ? "FAILED" : "ok");
+  free(samples);
+  return errors != 0;
+}
+
+/* ============================================================================
+ * 分位数
+ * ============================================================================
+ */
+
+typedef enum {
+  DIST_NORMAL,
+  DIST_UNIFORM,
+  DIST_DIPS,
+  DIST_QUANTIZED,
+  DIST_HEAVY,
+  DIST_DRIFT,
+  DIST_COUNT,
+} dist_t;
+
+static const char *s_dist_names[DIST_COUNT] = {
+    "normal", "uniform", "supply dips", "quantized", "heavy tail", "drift"};
+
+static float draw(dist_t dist, int i) {
+  switch (dist) {
+  case DIST_NORMAL:
+    return (float)(24.0 + 0.1 * gauss());
+  case DIST_UNIFORM:
+    return (float)(10.0 * drand());
+  case DIST_DIPS:
+    // 3% 的时间在 19V 附近
+    return (float)((rng() % 100 < 3 ? 19.0 : 24.0) + 0.05 * gauss());
+  case DIST_QUANTIZED:
+    // 芯片电压 1V 分辨率
+    return (float)floor(24.0 + 0.7 * gauss() + 0.5);
+  case DIST_HEAVY:
+    return (float)(0.5 * exp(0.8 * gauss())); // 对数正态电流
+  case DIST_DRIFT:
+  default:
+    return (float)(24.0 - 2.0 * i / QUANTILE_SAMPLES + 0.05 * gauss());
+  }
+}
+
+static int check_quantiles(void) {
+  static const float ps[POWER_STATS_QUANTILE_COUNT] = {0.50f, 0.95f, 0.99f};
+  float *x = malloc(QUANTILE_SAMPLES * sizeof(float));
+  int failed = 0;
+
+  printf("quantiles: P-square rank error (estimate rank - p), %d samples\n",
+         QUANTILE_SAMPLES);
+  for (int d = 0; d < DIST_COUNT; d++) {
+    power_stats_p2_t p2[POWER_STATS_QUANTILE_COUNT];
+    for (int q = 0; q < POWER_STATS_QUANTILE_COUNT; q++) {
+      power_stats_p2_init(&p2[q], ps[q]);
+    }
+    for (int i = 0; i < QUANTILE_SAMPLES; i++) {
+      x[i] = draw(d, i);
+      for (int q = 0; q < POWER_STATS_QUANTILE_COUNT; q++) {
+        power_stats_p2_add(&p2[q], x[i]);
+      }
+    }
+    qsort(x, QUANTILE_SAMPLES, sizeof(float), cmp_float);
+
+    printf("  %-12s", s_dist_names[d]);
+    for (int q = 0; q < POWER_STATS_QUANTILE_COUNT; q++) {
+      float est = power_stats_p2_value(&p2[q]);
+      // 估计值所在的秩区间：[小于 est 的个数, 不大于 est 的个数]
+      size_t lo = 0, hi = QUANTILE_SAMPLES;
+      while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (x[mid] < est) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      size_t below = lo;
+      hi = QUANTILE_SAMPLES;
+      while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (x[mid] <= est) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      double rank_lo = (double)below / QUANTILE_SAMPLES;
+      double rank_hi = (double)lo / QUANTILE_SAMPLES;
+      float exact = x[(size_t)ceil(ps[q] * QUANTILE_SAMPLES) - 1];
+      double err = ps[q] < rank_lo   ? rank_lo - ps[q]
+                   : ps[q] > rank_hi ? ps[q] - rank_hi
+                                     : 0.0;
+      if (fabsf(est - exact) < 1e-3f) {
+        err = 0.0; // 量化数据里估计值落在并列值上
+      }
+      printf("  p%02d %8.4f/%8.4f (%+.4f)", (int)lroundf(ps[q] * 100), est,
+             exact, err);
+      // P² 的标记只能逐步移动，单调漂移的输入（近似排好序）跟不上
+      double limit = d == DIST_DRIFT ? 0.06 : 0.005;
+      if (err > limit) {
+        failed = 1;
+      }
+    }
+    printf("\n");
+  }
+
+  free(x);
+  return failed;
+}
+
+/* ============================================================================
+ * 能量积分
+ * ============================================================================
+ */
+
+static double load_power(double t) {
+  // 基础负载、周期性波动和每 10 分钟 5 分钟的高负载
+  return 60.0 + 15.0 * sin(2.0 * M_PI * t / 97.0) +
+         (fmod(t, 600.0) < 300.0 ? 40.0 : 0.0);
+}
+
+static double load_energy_wh(double t0, double t1) {
+  // 分段数值积分作为参考（步长 1ms）
+  double e = 0.0;
+  const double h = 0.001;
+  for (double t = t0; t < t1; t += h) {
+    double b = fmin(t + h, t1);
+    e += 0.5 * (load_power(t) + load_power(b)) * (b - t);
+  }
+  return e / 3600.0;
+}
+
+static int check_energy(void) {
+  power_stats_engine_t engine;
+  const uint32_t max_gap_us = 2000000;
+  power_stats_init(&engine, max_gap_us);
+
+  const double nominal_s = 0.1; // 标称 10Hz
+  double t = 0.0;
+  double covered_wh = 0.0; // 采样覆盖区间的解析能量
+  double prev_t = -1.0;
+  uint64_t n = 0;
+  double naive_mean = 0.0;
+  int gaps = 0;
+
+  while (t < ENERGY_SECONDS) {
+    // 正常间隔抖动 ±50%，偶尔成批（间隔很短）或断线 5~30 秒
+    uint32_t r = rng() % 10000;
+    double dt = r < 5     ? 5.0 + 25.0 * drand()
+                : r < 800 ? 0.004
+                          : nominal_s * (0.5 + drand());
+    t += dt;
+    if (t >= ENERGY_SECONDS) {
+      break;
+    }
+    float p = (float)load_power(t);
+    power_stats_add_power(&engine, p, (int64_t)llround(t * 1e6));
+    n++;
+    naive_mean += (p - naive_mean) / n;
+    if (prev_t >= 0.0) {
+      if (t - prev_t <= max_gap_us / 1e6) {
+        covered_wh += load_energy_wh(prev_t, t);
+      } else {
+        gaps++;
+      }
+    }
+    prev_t = t;
+  }
+
+  double trapezoid_err = fabs(engine.energy_wh - covered_wh) / covered_wh;
+  double mean_uptime = naive_mean * ENERGY_SECONDS / 3600.0;
+  double mean_uptime_err =
+      fabs(mean_uptime - load_energy_wh(0.0, ENERGY_SECONDS)) /
+      load_energy_wh(0.0, ENERGY_SECONDS);
+  double count_nominal = naive_mean * n * nominal_s / 3600.0;
+  double count_nominal_err = fabs(count_nominal - covered_wh) / covered_wh;
+
+  printf("energy: %.0f s, %llu samples, %d gaps (%.0f s uncovered): "
+         "trapezoid %.3f Wh vs %.3f Wh (%.3f%%)\n",
+         (double)ENERGY_SECONDS, (unsigned long long)n, gaps,
+         engine.gap_us / 1e6, engine.energy_wh, covered_wh,
+         100.0 * trapezoid_err);
+  printf("        average x uptime %.2f%% off, samples x nominal 100 ms "
+         "%.2f%% off\n",
+         100.0 * mean_uptime_err, 100.0 * count_nominal_err);
+
+  return trapezoid_err > 1e-3 || (int)engine.energy_gaps != gaps;
+}
+
+static void timing(void) {
+  power_stats_engine_t engine;
+  power_stats_init(&engine, 1000000);
+  float *x = malloc(4096 * sizeof(float));
+  for (int i = 0; i < 4096; i++) {
+    x[i] = (float)(24.0 + 0.1 * gauss());
+  }
+
+  double start = now_ns();
+  for (int i = 0; i < TIMING_SAMPLES; i++) {
+    power_stats_add(&engine, POWER_STATS_VOLTAGE, x[i & 4095],
+                    (int64_t)i * 1000);
+  }
+  double ns = (now_ns() - start) / TIMING_SAMPLES;
+
+  power_stats_channel_summary_t summary;
+  start = now_ns();
+  for (int i = 0; i < 10000; i++) {
+    power_stats_summarize(&engine, POWER_STATS_VOLTAGE,
+                          (int64_t)TIMING_SAMPLES * 1000, &summary);
+  }
+  double query_ns = (now_ns() - start) / 10000;
+
+  printf("timing: %.1f ns per sample, %.0f ns per channel summary, "
+         "engine %zu bytes\n",
+         ns, query_ns, sizeof(power_stats_engine_t));
+  free(x);
+}
+
+int main(void) {
+  int failed = 0;
+
+  failed |= check_precision();
+  failed |= check_windows();
+  failed |= check_quantiles();
+  failed |= check_energy();
+  timing();
+
+  printf(failed ? "FAILED\n" : "OK\n");
+  return failed;
+}
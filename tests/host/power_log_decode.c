@@ -0,0 +1,152 @@
+/**
+ * @file power_log_decode.c
+ * @brief 把设备记录的电源遥测日志（power log start）转成 CSV
+ *
+ *   power_log_decode <日志文件>... > power.csv
+ *
+ * 按参数顺序读取文件（pwr00000.bin pwr00001.bin ...），每个样本输出一行：
+ *
+ *   session,time_s,voltage_v,current_a,power_w,flags
+ *
+ * 时间为设备启动后的秒数，每次开始记录时 session 都会变化。flags 为
+ * power_log_flag_t 各位的组合（1 校验失败，2 之前有帧丢失，4 之前有瞬态
+ * 捕获，8 之前电压越限，16 之前有样本因缓冲满被丢弃）。
+ *
+ * 校验失败的块（写到一半断电、拔卡）被跳过，之后逐字节查找下一个有效块。
+ * 块数、坏块数、块序号的缺口和设备端丢弃的样本数输出到 stderr。
+ */
+
+#include "power_monitor_log.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+  size_t blocks;
+  size_t bad_blocks;
+  size_t sequence_gaps;
+  size_t samples;
+  size_t sessions;
+  size_t unreadable;
+  uint64_t dropped;         // 之前各会话丢弃的样本
+  uint32_t session_dropped; // 当前会话到目前为止
+  bool have_last;
+  uint32_t last_session;
+  uint32_t last_sequence;
+} decode_stats_t;
+
+static uint8_t *read_file(const char *path, size_t *size) {
+  FILE *f = fopen(path, "rb");
+  if (f == NULL) {
+    return NULL;
+  }
+
+  uint8_t *data = NULL;
+  size_t capacity = 0;
+  *size = 0;
+  for (;;) {
+    if (*size == capacity) {
+      capacity = capacity ? capacity * 2 : 1 << 20;
+      uint8_t *grown = realloc(data, capacity);
+      if (grown == NULL) {
+        free(data);
+        fclose(f);
+        return NULL;
+      }
+      data = grown;
+    }
+    size_t n = fread(data + *size, 1, capacity - *size, f);
+    if (n == 0) {
+      break;
+    }
+    *size += n;
+  }
+  fclose(f);
+  return data;
+}
+
+static void print_block(const uint8_t *block,
+                        const power_log_block_info_t *info,
+                        decode_stats_t *stats) {
+  power_log_sample_t samples[POWER_LOG_BLOCK_RECORDS];
+
+  if (!stats->have_last || info->session != stats->last_session) {
+    stats->sessions++;
+    stats->dropped += stats->session_dropped;
+  } else if (info->sequence != stats->last_sequence + 1) {
+    stats->sequence_gaps++;
+  }
+  stats->have_last = true;
+  stats->last_session = info->session;
+  stats->last_sequence = info->sequence;
+  stats->blocks++;
+  stats->session_dropped = info->dropped; // 会话内累计值
+
+  size_t n = power_log_block_decode(block, info, samples);
+  for (size_t i = 0; i < n; i++) {
+    double voltage = samples[i].voltage_mv / 1000.0;
+    double current = samples[i].current_ma / 1000.0;
+    printf("%08X,%.6f,%.3f,%.3f,%.3f,%u\n", info->session,
+           samples[i].time_us / 1e6, voltage, current, voltage * current,
+           samples[i].flags);
+  }
+  stats->samples += n;
+}
+
+static void decode_file(const char *path, decode_stats_t *stats) {
+  power_log_block_info_t info;
+  size_t size = 0;
+  uint8_t *data = read_file(path, &size);
+  if (data == NULL) {
+    fprintf(stderr, "%s: cannot read\n", path);
+    stats->unreadable++;
+    return;
+  }
+
+  size_t offset = 0;
+  bool in_bad = false;
+  while (offset + POWER_LOG_BLOCK_SIZE <= size) {
+    esp_err_t err = power_log_block_parse(data + offset, &info);
+    if (err != ESP_OK) {
+      if (!in_bad) {
+        fprintf(stderr, "%s: bad block at offset %zu (0x%x)\n", path, offset,
+                err);
+        stats->bad_blocks++;
+        in_bad = true;
+      }
+      offset++; // 逐字节找下一个块头
+      continue;
+    }
+    in_bad = false;
+    print_block(data + offset, &info, stats);
+    offset += POWER_LOG_BLOCK_SIZE;
+  }
+  if (offset < size && !in_bad) {
+    fprintf(stderr, "%s: %zu trailing bytes\n", path, size - offset);
+    stats->bad_blocks++;
+  }
+  free(data);
+}
+
+int main(int argc, char **argv) {
+  decode_stats_t stats = {0};
+
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s <log file>... > power.csv\n", argv[0]);
+    return 2;
+  }
+
+  printf("session,time_s,voltage_v,current_a,power_w,flags\n");
+  for (int i = 1; i < argc; i++) {
+    decode_file(argv[i], &stats);
+  }
+
+  stats.dropped += stats.session_dropped;
+  fprintf(stderr,
+          "%zu blocks, %zu samples, %zu sessions, %zu bad blocks, "
+          "%zu sequence gaps, %llu samples dropped on the device\n",
+          stats.blocks, stats.samples, stats.sessions, stats.bad_blocks,
+          stats.sequence_gaps, (unsigned long long)stats.dropped);
+  return stats.unreadable > 0 ? 1 : 0;
+}
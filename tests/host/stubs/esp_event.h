@@ -0,0 +1,11 @@
+/**
+ * @file esp_event.h
+ * @brief 主机构建用的 esp_event.h 最小替身
+ */
+
+#pragma once
+
+typedef const char *esp_event_base_t;
+
+#define ESP_EVENT_DECLARE_BASE(id) extern esp_event_base_t const id
+#define ESP_EVENT_DEFINE_BASE(id) esp_event_base_t const id = #id
@@ -0,0 +1,14 @@
+/**
+ * @file FreeRTOS.h
+ * @brief 主机构建用的 freertos/FreeRTOS.h 最小替身
+ *
+ * 只提供组件公共头文件中出现的类型，主机上编译的模块不调用FreeRTOS API。
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
@@ -0,0 +1,10 @@
+/**
+ * @file semphr.h
+ * @brief 主机构建用的 freertos/semphr.h 最小替身
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *SemaphoreHandle_t;
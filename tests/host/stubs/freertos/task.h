@@ -0,0 +1,10 @@
+/**
+ * @file task.h
+ * @brief 主机构建用的 freertos/task.h 最小替身
+ */
+
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+typedef void *TaskHandle_t;
@@ -9,6 +9,7 @@
 #include "unity.h"
 #include "event_manager.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
@@ -23,8 +24,11 @@ enum {
     TEST_EVENT_1,
     TEST_EVENT_2,
     TEST_EVENT_WITH_DATA,
+    TEST_EVENT_BLOCK,
 };
 
+#define TEST_MAX_RECORDED 16
+
 // Test data structure
 typedef struct {
     int value;
@@ -37,6 +41,15 @@ static struct {
     int last_event_id;
     test_event_data_t last_event_data;
     SemaphoreHandle_t event_received_sem;
+    
+    // Delivery order, recorded by test_recording_handler
+    int32_t received_ids[TEST_MAX_RECORDED];
+    int received_values[TEST_MAX_RECORDED];
+    int received_total;
+    
+    // Hold the dispatch task inside test_blocking_handler
+    SemaphoreHandle_t dispatch_blocked;
+    SemaphoreHandle_t dispatch_release;
 } test_state;
 
 /**
@@ -59,6 +72,71 @@ static void test_event_handler(void *handler_args, esp_event_base_t event_base,
     ESP_LOGI(TAG, "Test event handler called - ID: %" PRId32, event_id);
 }
 
+/**
+ * @brief Handler recording the order and values of delivered events
+ */
+static void test_recording_handler(void *handler_args, esp_event_base_t event_base,
+                                   int32_t event_id, void *event_data)
+{
+    if (test_state.received_total < TEST_MAX_RECORDED) {
+        test_state.received_ids[test_state.received_total] = event_id;
+        test_state.received_values[test_state.received_total] =
+            event_data ? ((test_event_data_t *)event_data)->value : 0;
+        test_state.received_total++;
+    }
+    
+    xSemaphoreGive(test_state.event_received_sem);
+}
+
+/**
+ * @brief Handler keeping the dispatch task busy until released
+ */
+static void test_blocking_handler(void *handler_args, esp_event_base_t event_base,
+                                  int32_t event_id, void *event_data)
+{
+    xSemaphoreGive(test_state.dispatch_blocked);
+    xSemaphoreTake(test_state.dispatch_release, portMAX_DELAY);
+}
+
+/**
+ * @brief Register the recording and blocking handlers, then block dispatching
+ *
+ * Posted after the registrations on the normal lane, the blocking event is
+ * delivered after their HANDLER_ADDED events, so every lane is empty once
+ * the dispatch task is held.
+ */
+static void block_dispatch(void)
+{
+    test_state.dispatch_blocked = xSemaphoreCreateBinary();
+    test_state.dispatch_release = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(test_state.dispatch_blocked);
+    TEST_ASSERT_NOT_NULL(test_state.dispatch_release);
+    
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_register_handler(TEST_EVENTS, TEST_EVENT_1,
+                                                             test_recording_handler, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_register_handler(TEST_EVENTS, TEST_EVENT_2,
+                                                             test_recording_handler, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_register_handler(TEST_EVENTS, TEST_EVENT_WITH_DATA,
+                                                             test_recording_handler, NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_register_handler(TEST_EVENTS, TEST_EVENT_BLOCK,
+                                                             test_blocking_handler, NULL));
+    
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_post_event(TEST_EVENTS, TEST_EVENT_BLOCK, NULL, 0, 0));
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(test_state.dispatch_blocked, pdMS_TO_TICKS(1000)));
+}
+
+/**
+ * @brief Post an event carrying a value
+ */
+static esp_err_t post_value(event_manager_priority_t priority, int value)
+{
+    test_event_data_t data = {
+        .value = value,
+    };
+    return event_manager_post_event_with_priority(TEST_EVENTS, TEST_EVENT_WITH_DATA,
+                                                  &data, sizeof(data), priority);
+}
+
 /**
  * @brief Setup function called before each test
  */
@@ -66,7 +144,7 @@ void setUp(void)
 {
     // Reset test state
     memset(&test_state, 0, sizeof(test_state));
-    test_state.event_received_sem = xSemaphoreCreateCounting(10, 0);  // Max 10 events, initial count 0
+    test_state.event_received_sem = xSemaphoreCreateCounting(TEST_MAX_RECORDED, 0);  // Initial count 0
     TEST_ASSERT_NOT_NULL(test_state.event_received_sem);
 }
 
@@ -75,6 +153,11 @@ void setUp(void)
  */
 void tearDown(void)
 {
+    // Let a held dispatch task go, even if the test failed while holding it
+    if (test_state.dispatch_release) {
+        xSemaphoreGive(test_state.dispatch_release);
+    }
+    
     if (test_state.event_received_sem) {
         vSemaphoreDelete(test_state.event_received_sem);
         test_state.event_received_sem = NULL;
@@ -84,6 +167,15 @@ void tearDown(void)
     if (event_manager_is_initialized()) {
         event_manager_deinit();
     }
+    
+    if (test_state.dispatch_blocked) {
+        vSemaphoreDelete(test_state.dispatch_blocked);
+        test_state.dispatch_blocked = NULL;
+    }
+    if (test_state.dispatch_release) {
+        vSemaphoreDelete(test_state.dispatch_release);
+        test_state.dispatch_release = NULL;
+    }
 }
 
 /**
@@ -322,6 +414,149 @@ void test_event_manager_multiple_events(void)
     TEST_ASSERT_EQUAL(3, test_state.event_received_count);
 }
 
+/**
+ * @brief Test that lanes are delivered in priority order
+ */
+void test_event_manager_priority_lanes(void)
+{
+    ESP_LOGI(TAG, "Testing priority lanes");
+    
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_init(NULL));
+    block_dispatch();
+    
+    // Posted lowest priority first while the dispatch task is busy
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_post_event_with_priority(TEST_EVENTS, TEST_EVENT_1,
+                                                                     NULL, 0, EVENT_MANAGER_PRIORITY_LOW));
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_post_event_with_priority(TEST_EVENTS, TEST_EVENT_2,
+                                                                     NULL, 0, EVENT_MANAGER_PRIORITY_NORMAL));
+    TEST_ASSERT_EQUAL(ESP_OK, post_value(EVENT_MANAGER_PRIORITY_HIGH, 7));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG,
+                      event_manager_post_event_with_priority(TEST_EVENTS, TEST_EVENT_1, NULL, 0,
+                                                             EVENT_MANAGER_PRIORITY_COUNT));
+    
+    event_manager_status_t status;
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_get_status(&status));
+    TEST_ASSERT_EQUAL(1, status.lanes[EVENT_MANAGER_PRIORITY_HIGH].depth);
+    TEST_ASSERT_EQUAL(1, status.lanes[EVENT_MANAGER_PRIORITY_NORMAL].depth);
+    TEST_ASSERT_EQUAL(1, status.lanes[EVENT_MANAGER_PRIORITY_LOW].depth);
+    
+    xSemaphoreGive(test_state.dispatch_release);
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(test_state.event_received_sem, pdMS_TO_TICKS(1000)));
+    }
+    
+    TEST_ASSERT_EQUAL(3, test_state.received_total);
+    TEST_ASSERT_EQUAL(TEST_EVENT_WITH_DATA, test_state.received_ids[0]);
+    TEST_ASSERT_EQUAL(7, test_state.received_values[0]);
+    TEST_ASSERT_EQUAL(TEST_EVENT_2, test_state.received_ids[1]);
+    TEST_ASSERT_EQUAL(TEST_EVENT_1, test_state.received_ids[2]);
+    
+    // Per-event statistics remember the lane
+    event_manager_stats_t stats[16];
+    size_t count = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_get_statistics(stats, 16, &count));
+    bool found = false;
+    for (size_t i = 0; i < count; i++) {
+        if (stats[i].event_base == TEST_EVENTS && stats[i].event_id == TEST_EVENT_1) {
+            TEST_ASSERT_EQUAL(1, stats[i].send_count);
+            TEST_ASSERT_EQUAL(EVENT_MANAGER_PRIORITY_LOW, stats[i].priority);
+            found = true;
+        }
+    }
+    TEST_ASSERT_TRUE(found);
+    
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_reset_statistics());
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_get_statistics(stats, 16, &count));
+    TEST_ASSERT_EQUAL(0, count);
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_get_status(&status));
+    TEST_ASSERT_EQUAL(0, status.lanes[EVENT_MANAGER_PRIORITY_NORMAL].posted);
+    TEST_ASSERT_EQUAL(0, status.lanes[EVENT_MANAGER_PRIORITY_NORMAL].high_water);
+}
+
+/**
+ * @brief Test the overflow policies of full lanes
+ */
+void test_event_manager_overflow_policies(void)
+{
+    ESP_LOGI(TAG, "Testing lane overflow policies");
+    
+    event_manager_config_t config = event_manager_get_default_config();
+    config.lanes[EVENT_MANAGER_PRIORITY_HIGH].capacity = 4;
+    config.lanes[EVENT_MANAGER_PRIORITY_HIGH].overflow = EVENT_MANAGER_OVERFLOW_DROP_NEWEST;
+    config.lanes[EVENT_MANAGER_PRIORITY_NORMAL].capacity = 4;
+    config.lanes[EVENT_MANAGER_PRIORITY_NORMAL].overflow = EVENT_MANAGER_OVERFLOW_COALESCE;
+    config.lanes[EVENT_MANAGER_PRIORITY_LOW].capacity = 4;
+    config.lanes[EVENT_MANAGER_PRIORITY_LOW].overflow = EVENT_MANAGER_OVERFLOW_DROP_OLDEST;
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_init(&config));
+    block_dispatch();
+    
+    // Drop newest: the fifth post is refused at once
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, event_manager_post_event_with_priority(TEST_EVENTS, TEST_EVENT_1,
+                                                                         NULL, 0, EVENT_MANAGER_PRIORITY_HIGH));
+    }
+    int64_t start = esp_timer_get_time();
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, event_manager_post_event_with_priority(TEST_EVENTS, TEST_EVENT_1,
+                                                                              NULL, 0, EVENT_MANAGER_PRIORITY_HIGH));
+    TEST_ASSERT_TRUE(esp_timer_get_time() - start < 1000);
+    
+    // Coalesce: the fifth value replaces the newest pending one
+    for (int value = 1; value <= 5; value++) {
+        TEST_ASSERT_EQUAL(ESP_OK, post_value(EVENT_MANAGER_PRIORITY_NORMAL, value));
+    }
+    
+    // Drop oldest: the first value makes room for the fifth
+    for (int value = 11; value <= 15; value++) {
+        TEST_ASSERT_EQUAL(ESP_OK, post_value(EVENT_MANAGER_PRIORITY_LOW, value));
+    }
+    
+    // Too large for a lane slot
+    static uint8_t large[EVENT_MANAGER_EVENT_DATA_MAX + 1];
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, event_manager_post_event(TEST_EVENTS, TEST_EVENT_1,
+                                                                     large, sizeof(large), 0));
+    
+    event_manager_status_t status;
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_get_status(&status));
+    const event_manager_lane_stats_t *high = &status.lanes[EVENT_MANAGER_PRIORITY_HIGH];
+    const event_manager_lane_stats_t *normal = &status.lanes[EVENT_MANAGER_PRIORITY_NORMAL];
+    const event_manager_lane_stats_t *low = &status.lanes[EVENT_MANAGER_PRIORITY_LOW];
+    TEST_ASSERT_EQUAL(4, high->capacity);
+    TEST_ASSERT_EQUAL(4, high->depth);
+    TEST_ASSERT_EQUAL(4, high->high_water);
+    TEST_ASSERT_EQUAL(1, high->dropped);
+    TEST_ASSERT_EQUAL(4, normal->depth);
+    TEST_ASSERT_EQUAL(1, normal->coalesced);
+    TEST_ASSERT_EQUAL(0, normal->dropped);
+    TEST_ASSERT_EQUAL(4, low->depth);
+    TEST_ASSERT_EQUAL(5, low->posted);
+    TEST_ASSERT_EQUAL(1, low->dropped);
+    
+    xSemaphoreGive(test_state.dispatch_release);
+    for (int i = 0; i < 12; i++) {
+        TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(test_state.event_received_sem, pdMS_TO_TICKS(1000)));
+    }
+    
+    static const int32_t expected_ids[12] = {
+        TEST_EVENT_1, TEST_EVENT_1, TEST_EVENT_1, TEST_EVENT_1,
+        TEST_EVENT_WITH_DATA, TEST_EVENT_WITH_DATA, TEST_EVENT_WITH_DATA, TEST_EVENT_WITH_DATA,
+        TEST_EVENT_WITH_DATA, TEST_EVENT_WITH_DATA, TEST_EVENT_WITH_DATA, TEST_EVENT_WITH_DATA,
+    };
+    static const int expected_values[12] = {
+        0, 0, 0, 0,
+        1, 2, 3, 5,
+        12, 13, 14, 15,
+    };
+    TEST_ASSERT_EQUAL(12, test_state.received_total);
+    for (int i = 0; i < 12; i++) {
+        TEST_ASSERT_EQUAL(expected_ids[i], test_state.received_ids[i]);
+        TEST_ASSERT_EQUAL(expected_values[i], test_state.received_values[i]);
+    }
+    
+    TEST_ASSERT_EQUAL(ESP_OK, event_manager_get_status(&status));
+    TEST_ASSERT_EQUAL(0, status.lanes[EVENT_MANAGER_PRIORITY_HIGH].depth);
+    TEST_ASSERT_EQUAL(4, status.lanes[EVENT_MANAGER_PRIORITY_LOW].delivered);
+}
+
 /**
  * @brief Test error conditions
  */
@@ -396,6 +631,8 @@ void app_main(void)
     RUN_TEST(test_event_manager_post_and_handle);
     RUN_TEST(test_event_manager_post_with_data);
     RUN_TEST(test_event_manager_multiple_events);
+    RUN_TEST(test_event_manager_priority_lanes);
+    RUN_TEST(test_event_manager_overflow_policies);
     RUN_TEST(test_event_manager_error_conditions);
     RUN_TEST(test_event_manager_deinit);
     
@@ -127,6 +127,54 @@ void test_fan_controller_set_curve(void) {
     TEST_ASSERT_EQUAL(ESP_OK, fan_controller_update_temperature(TEST_FAN_ID, 30.0f));
 }
 
+void test_fan_controller_pid_gains(void) {
+    fan_pid_gains_t gains;
+    fan_mode_t mode;
+    
+    // Defaults until configured
+    TEST_ASSERT_EQUAL(ESP_OK, fan_controller_get_pid_gains(TEST_FAN_ID, &gains));
+    TEST_ASSERT_EQUAL_FLOAT(FAN_PID_DEFAULT_SETPOINT, gains.setpoint);
+    
+    // Set and read back
+    gains.setpoint = 60.0f;
+    gains.kp = 8.0f;
+    TEST_ASSERT_EQUAL(ESP_OK, fan_controller_set_pid_gains(TEST_FAN_ID, &gains));
+    TEST_ASSERT_EQUAL(ESP_OK, fan_controller_get_pid_gains(TEST_FAN_ID, &gains));
+    TEST_ASSERT_EQUAL_FLOAT(60.0f, gains.setpoint);
+    TEST_ASSERT_EQUAL_FLOAT(8.0f, gains.kp);
+    
+    // Out of range values are rejected
+    gains.min_speed = 90;
+    gains.max_speed = 50;
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, fan_controller_set_pid_gains(TEST_FAN_ID, &gains));
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, fan_controller_set_pid_gains(TEST_FAN_ID, NULL));
+    
+    // PID mode
+    TEST_ASSERT_EQUAL(ESP_OK, fan_controller_set_mode(TEST_FAN_ID, FAN_MODE_AUTO_PID));
+    TEST_ASSERT_EQUAL(ESP_OK, fan_controller_get_mode(TEST_FAN_ID, &mode));
+    TEST_ASSERT_EQUAL(FAN_MODE_AUTO_PID, mode);
+}
+
+void test_fan_controller_temp_source(void) {
+    fan_temp_source_t source;
+    
+    // Shared temperature until bound
+    TEST_ASSERT_EQUAL(ESP_OK, fan_controller_get_temp_source(TEST_FAN_ID, &source));
+    TEST_ASSERT_EQUAL(FAN_TEMP_SOURCE_GLOBAL, source);
+    
+    TEST_ASSERT_EQUAL(ESP_OK, fan_controller_set_temp_source(TEST_FAN_ID, FAN_TEMP_SOURCE_AGX_TJ));
+    TEST_ASSERT_EQUAL(ESP_OK, fan_controller_get_temp_source(TEST_FAN_ID, &source));
+    TEST_ASSERT_EQUAL(FAN_TEMP_SOURCE_AGX_TJ, source);
+    
+    // Each fan keeps its own binding
+    TEST_ASSERT_EQUAL(ESP_OK, fan_controller_get_temp_source(1, &source));
+    TEST_ASSERT_EQUAL(FAN_TEMP_SOURCE_GLOBAL, source);
+    
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, fan_controller_set_temp_source(TEST_FAN_ID, FAN_TEMP_SOURCE_MAX));
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, fan_controller_set_temp_source(99, FAN_TEMP_SOURCE_AGX_CPU));
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, fan_controller_get_temp_source(TEST_FAN_ID, NULL));
+}
+
 void test_fan_controller_configure_gpio(void) {
     // Configure GPIO
     TEST_ASSERT_EQUAL(ESP_OK, fan_controller_configure_gpio(TEST_FAN_ID, 5, 1));
@@ -219,6 +267,8 @@ int app_main(void) {
     RUN_TEST(test_fan_controller_get_all_status);
     RUN_TEST(test_fan_controller_update_temperature);
     RUN_TEST(test_fan_controller_set_curve);
+    RUN_TEST(test_fan_controller_pid_gains);
+    RUN_TEST(test_fan_controller_temp_source);
     RUN_TEST(test_fan_controller_configure_gpio);
     RUN_TEST(test_fan_controller_save_load_config);
     RUN_TEST(test_fan_controller_invalid_parameters);
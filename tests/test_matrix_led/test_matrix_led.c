@@ -5,9 +5,13 @@
 
 #include "unity.h"
 #include "matrix_led.h"
+#include "matrix_led_font.h"
+#include "matrix_led_layer.h"
+#include "matrix_led_output.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include <stdio.h>
 
 static const char *TAG = "test_matrix_led";
 
@@ -173,6 +177,85 @@ void test_matrix_led_bulk_operations(void)
     TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
 }
 
+void test_matrix_led_present(void)
+{
+    ESP_LOGI(TAG, "Testing matrix LED double-buffered present");
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());
+    
+    // 提交后新的后台缓冲区应保留已提交的内容
+    matrix_led_color_t green = {0, 255, 0};
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_pixel(3, 4, green));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_present());
+    
+    matrix_led_color_t color;
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_pixel(3, 4, &color));
+    TEST_ASSERT_EQUAL(green.g, color.g);
+    
+    // 连续提交不应阻塞绘制
+    for (int i = 0; i < 10; i++) {
+        matrix_led_color_t c = {(uint8_t)(i * 20), 0, 0};
+        TEST_ASSERT_EQUAL(ESP_OK, matrix_led_fill(c));
+        TEST_ASSERT_EQUAL(ESP_OK, matrix_led_present());
+    }
+    vTaskDelay(pdMS_TO_TICKS(100));
+    
+    matrix_led_status_t status;
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_status(&status));
+    TEST_ASSERT_TRUE(status.presented_frames >= 11);
+    TEST_ASSERT_TRUE(status.frame_count + status.dropped_frames >= 1);
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+}
+
+void test_matrix_led_dirty_tracking(void)
+{
+    ESP_LOGI(TAG, "Testing matrix LED dirty row tracking");
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());
+    
+    matrix_led_color_t blue = {0, 0, 255};
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_pixel(1, 1, blue));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_present());
+    vTaskDelay(pdMS_TO_TICKS(50));
+    
+    matrix_led_status_t before;
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_status(&before));
+    
+    // 没有绘制的提交应被跳过，不再发送或校正
+    for (int i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, matrix_led_present());
+    }
+    vTaskDelay(pdMS_TO_TICKS(50));
+    
+    matrix_led_status_t after;
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_status(&after));
+    TEST_ASSERT_EQUAL(before.skipped_frames + 5, after.skipped_frames);
+    TEST_ASSERT_EQUAL(before.frame_count, after.frame_count);
+    TEST_ASSERT_EQUAL(before.corrected_pixels, after.corrected_pixels);
+    
+    // 修改单个像素只校正所在行
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_pixel(2, 7, blue));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_present());
+    vTaskDelay(pdMS_TO_TICKS(50));
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_status(&after));
+    TEST_ASSERT_EQUAL(before.frame_count + 1, after.frame_count);
+    TEST_ASSERT_EQUAL(before.corrected_pixels + MATRIX_LED_WIDTH,
+                      after.corrected_pixels);
+    
+    // 重写相同内容会校正该行，但不会重新发送
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_pixel(2, 7, blue));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_present());
+    vTaskDelay(pdMS_TO_TICKS(50));
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_status(&after));
+    TEST_ASSERT_EQUAL(before.frame_count + 1, after.frame_count);
+    TEST_ASSERT_EQUAL(before.skipped_frames + 6, after.skipped_frames);
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+}
+
 // ==================== 亮度控制测试 ====================
 
 void test_matrix_led_brightness(void)
@@ -289,6 +372,249 @@ void test_matrix_led_animations(void)
     TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
 }
 
+void test_matrix_led_frame_scheduler(void)
+{
+    ESP_LOGI(TAG, "Testing matrix LED frame scheduler");
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());
+    TEST_ASSERT_EQUAL(MATRIX_LED_DEFAULT_FPS, matrix_led_get_target_fps());
+    
+    // 帧率范围检查
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, matrix_led_set_target_fps(0));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, matrix_led_set_target_fps(MATRIX_LED_MAX_FPS + 1));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_target_fps(25));
+    TEST_ASSERT_EQUAL(25, matrix_led_get_target_fps());
+    
+    // 以固定帧率运行一秒，渲染帧数加跳过帧数应接近目标帧率
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_reset_timing_stats());
+    matrix_led_animation_config_t config = {
+        .name = "Scheduler",
+        .type = MATRIX_LED_ANIM_RAINBOW,
+        .frame_delay_ms = 40,
+        .loop = true,
+        .speed = 50,
+    };
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_play_animation(MATRIX_LED_ANIM_RAINBOW, &config));
+    vTaskDelay(pdMS_TO_TICKS(1000));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_stop_animation());
+    
+    matrix_led_timing_stats_t timing;
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_timing_stats(&timing));
+    TEST_ASSERT_EQUAL(25, timing.target_fps);
+    TEST_ASSERT_UINT32_WITHIN(3, 25, timing.rendered_frames + timing.missed_frames);
+    TEST_ASSERT_EQUAL(timing.rendered_frames, timing.render_samples);
+    TEST_ASSERT_TRUE(timing.render_p50_us <= timing.render_p99_us);
+    TEST_ASSERT_TRUE(timing.render_p99_us <= timing.render_max_us);
+    TEST_ASSERT_TRUE(timing.transmit_samples > 0);
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+}
+
+// ==================== 二进制动画容器测试 ====================
+
+void test_matrix_led_anim_container(void)
+{
+    ESP_LOGI(TAG, "Testing matrix LED binary animation container");
+
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());
+    if (!matrix_led_storage_available()) {
+        TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+        TEST_IGNORE_MESSAGE("SD card not available");
+    }
+
+    const char *path = "/sdcard/test_anim.mla";
+    matrix_led_color_t purple = {128, 0, 128};
+
+    // 导出当前画面为单帧动画
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_clear());
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_pixel(1, 2, MATRIX_LED_COLOR_RED));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_pixel(31, 31, purple));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_export_animation("TestImage", path));
+
+    // 通过JSON导入入口加载二进制文件，内容应完全一致
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_clear());
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_import_image_by_name(path, "TestImage"));
+    matrix_led_color_t color;
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_pixel(1, 2, &color));
+    TEST_ASSERT_EQUAL(255, color.r);
+    TEST_ASSERT_EQUAL(0, color.g);
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_pixel(31, 31, &color));
+    TEST_ASSERT_EQUAL(128, color.r);
+    TEST_ASSERT_EQUAL(128, color.b);
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_pixel(0, 0, &color));
+    TEST_ASSERT_EQUAL(0, color.r + color.g + color.b);
+
+    // 不存在的动画名称
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, matrix_led_import_animation(path, "Missing"));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, matrix_led_play_custom_animation("Missing"));
+
+    remove(path);
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+}
+
+void test_matrix_led_memory_output(void)
+{
+    ESP_LOGI(TAG, "Testing matrix LED memory output backend");
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());
+    
+    // 静态画面先在RMT后端上显示，切换后端后不再绘制也要整帧重发
+    matrix_led_color_t white = {255, 255, 255};
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_clear());
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_pixel(5, 6, white));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_present());
+    vTaskDelay(pdMS_TO_TICKS(50));
+    
+    matrix_led_output_t *memory = NULL;
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_output_new_memory(&memory));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_output(memory));
+    TEST_ASSERT_EQUAL_PTR(memory, matrix_led_get_output());
+    vTaskDelay(pdMS_TO_TICKS(50));
+    
+    uint32_t refresh_count = 0;
+    const matrix_led_color_t *frame =
+        matrix_led_output_memory_get_frame(memory, &refresh_count);
+    TEST_ASSERT_NOT_NULL(frame);
+    TEST_ASSERT_TRUE(refresh_count >= 1);
+    matrix_led_color_t lit = frame[6 * MATRIX_LED_WIDTH + 5];
+    TEST_ASSERT_TRUE(lit.r + lit.g + lit.b > 0);
+    TEST_ASSERT_EQUAL(0, frame[0].r + frame[0].g + frame[0].b);
+    
+    // 切换后的绘制同样写入内存后端
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_pixel(0, 0, white));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_present());
+    vTaskDelay(pdMS_TO_TICKS(50));
+    frame = matrix_led_output_memory_get_frame(memory, NULL);
+    TEST_ASSERT_TRUE(frame[0].r + frame[0].g + frame[0].b > 0);
+    lit = frame[6 * MATRIX_LED_WIDTH + 5];
+    TEST_ASSERT_TRUE(lit.r + lit.g + lit.b > 0);
+    
+    // set_output 返回后刷新任务不再访问旧后端，可以立即释放
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_output(NULL));
+    TEST_ASSERT_NULL(matrix_led_output_memory_get_frame(matrix_led_get_output(), NULL));
+    matrix_led_output_del(memory);
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+}
+
+void test_matrix_led_text(void)
+{
+    ESP_LOGI(TAG, "Testing matrix LED text rendering and scrolling");
+    
+    matrix_led_color_t white = {255, 255, 255};
+    matrix_led_color_t pixel;
+    
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, matrix_led_draw_text(0, 0, "A", white));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, matrix_led_draw_text(0, 0, NULL, white));
+    
+    // 'I' 的第0行在5x7字体中是满行，部分超出屏幕时被裁剪
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_clear());
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_draw_text(0, 0, "I", white));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_pixel(0, 0, &pixel));
+    TEST_ASSERT_EQUAL(255, pixel.r);
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_draw_text_font(-40, 30, "Hello", &matrix_led_font_8x8, white, NULL));
+    
+    TEST_ASSERT_EQUAL(3, matrix_led_font_text_width(&matrix_led_font_5x7, "I"));
+    TEST_ASSERT_EQUAL(11, matrix_led_font_text_width(&matrix_led_font_5x7, "42"));
+    TEST_ASSERT_EQUAL(16, matrix_led_font_text_width(&matrix_led_font_8x8, "42"));
+    
+    // 滚动文本：增量结果与整体重绘一致
+    static matrix_led_text_t scroll;
+    static matrix_led_text_t full;
+    matrix_led_rect_t area = {0, 24, 32, 8};
+    matrix_led_color_t black = {0, 0, 0};
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_text_init(&scroll, &matrix_led_font_5x7, &area, white, black));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_text_init(&full, &matrix_led_font_5x7, &area, white, black));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_text_set(&scroll, "robOS 42" MATRIX_LED_FONT_DEGREE "C"));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_text_set(&full, "robOS 42" MATRIX_LED_FONT_DEGREE "C"));
+    
+    static matrix_led_color_t a[MATRIX_LED_COUNT];
+    static matrix_led_color_t b[MATRIX_LED_COUNT];
+    matrix_led_text_render(&scroll, a);
+    for (int i = 0; i < 80; i++) {
+        matrix_led_text_scroll(&scroll, a, 1);
+        full.offset = scroll.offset;
+        matrix_led_text_render(&full, b);
+        TEST_ASSERT_EQUAL_MEMORY(&b[24 * MATRIX_LED_WIDTH], &a[24 * MATRIX_LED_WIDTH],
+                                 8 * MATRIX_LED_WIDTH * sizeof(matrix_led_color_t));
+    }
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_draw_text_layout(&scroll));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_scroll_text(&scroll, 2));
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+}
+
+void test_matrix_led_layers(void)
+{
+    ESP_LOGI(TAG, "Testing matrix LED layer compositor");
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());
+    
+    matrix_led_color_t red = {255, 0, 0};
+    matrix_led_color_t white = {255, 255, 255};
+    matrix_led_color_t pixel;
+    
+    // 底层不透明红色，上层KEYED叠加层
+    matrix_led_layer_t *background = NULL;
+    matrix_led_layer_t *overlay = NULL;
+    matrix_led_layer_t *sprite = NULL;
+    matrix_led_layer_config_t config = {
+        .format = MATRIX_LED_LAYER_OPAQUE, .z = 0, .opacity = 255, .visible = true};
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_add_layer(&config, &background));
+    config.format = MATRIX_LED_LAYER_KEYED;
+    config.z = 1;
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_add_layer(&config, &overlay));
+    config = (matrix_led_layer_config_t){
+        .x = 10, .y = 10, .width = 4, .height = 4,
+        .format = MATRIX_LED_LAYER_ALPHA, .z = 2, .opacity = 255, .visible = true};
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_add_layer(&config, &sprite));
+    
+    // 只有全屏图层可以作为绘制目标或动画目标
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, matrix_led_select_layer(sprite));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, matrix_led_set_animation_layer(sprite));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_animation_layer(background));
+    
+    matrix_led_layer_fill(background, red, 255);
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_select_layer(overlay));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_set_pixel(3, 4, white));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_present());
+    
+    // 提交后的后台缓冲区保存合成结果
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_select_layer(NULL));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_pixel(3, 4, &pixel));
+    TEST_ASSERT_EQUAL(255, pixel.g);
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_pixel(0, 0, &pixel));
+    TEST_ASSERT_EQUAL(255, pixel.r);
+    TEST_ASSERT_EQUAL(0, pixel.g);
+    
+    // 半透明精灵与底层混合
+    matrix_led_layer_set_pixel(sprite, 0, 0, white, 128);
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_present());
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_pixel(10, 10, &pixel));
+    TEST_ASSERT_EQUAL(255, pixel.r);
+    TEST_ASSERT_TRUE(pixel.g > 100 && pixel.g < 160);
+    
+    // 隐藏精灵后恢复底层颜色
+    config.visible = false;
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_update_layer(sprite, &config));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_present());
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_pixel(10, 10, &pixel));
+    TEST_ASSERT_EQUAL(0, pixel.g);
+    
+    matrix_led_status_t status;
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_get_status(&status));
+    TEST_ASSERT_EQUAL(3, status.layer_count);
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_remove_layer(sprite));
+    TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, matrix_led_remove_layer(sprite));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_remove_layer(overlay));
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_remove_layer(background));
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+}
+
 // ==================== 颜色工具测试 ====================
 
 void test_matrix_led_color_tools(void)
@@ -313,4 +639,196 @@ void test_matrix_led_color_tools(void)
     TEST_ASSERT_EQUAL(0, rgb.g);
     TEST_ASSERT_EQUAL(255, rgb.b);
     
-    // 测试颜色插值\n    matrix_led_color_t color1 = {0, 0, 0};\n    matrix_led_color_t color2 = {255, 255, 255};\n    matrix_led_color_t result;\n    ret = matrix_led_color_interpolate(color1, color2, 0.5f, &result);\n    TEST_ASSERT_EQUAL(ESP_OK, ret);\n    TEST_ASSERT_UINT8_WITHIN(5, 127, result.r);\n    TEST_ASSERT_UINT8_WITHIN(5, 127, result.g);\n    TEST_ASSERT_UINT8_WITHIN(5, 127, result.b);\n    \n    // 测试亮度应用\n    matrix_led_color_t bright_color = {200, 150, 100};\n    ret = matrix_led_apply_brightness(bright_color, 50, &result);\n    TEST_ASSERT_EQUAL(ESP_OK, ret);\n    TEST_ASSERT_EQUAL(100, result.r);\n    TEST_ASSERT_EQUAL(75, result.g);\n    TEST_ASSERT_EQUAL(50, result.b);\n    \n    // 测试空指针\n    ret = matrix_led_rgb_to_hsv(red, NULL);\n    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);\n    \n    ret = matrix_led_hsv_to_rgb(blue_hsv, NULL);\n    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);\n}\n\n// ==================== 特效测试 ====================\n\nvoid test_matrix_led_effects(void)\n{\n    ESP_LOGI(TAG, \"Testing matrix LED effects\");\n    \n    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());\n    \n    // 测试测试图案\n    esp_err_t ret = matrix_led_show_test_pattern();\n    TEST_ASSERT_EQUAL(ESP_OK, ret);\n    \n    vTaskDelay(pdMS_TO_TICKS(200));  // 让效果显示一段时间\n    \n    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());\n}\n\n// ==================== 配置管理测试 ====================\n\nvoid test_matrix_led_config(void)\n{\n    ESP_LOGI(TAG, \"Testing matrix LED configuration management\");\n    \n    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());\n    \n    // 修改一些设置\n    matrix_led_set_brightness(75);\n    matrix_led_set_mode(MATRIX_LED_MODE_ANIMATION);\n    matrix_led_set_enable(false);\n    \n    // 保存配置\n    esp_err_t ret = matrix_led_save_config();\n    TEST_ASSERT_EQUAL(ESP_OK, ret);\n    \n    // 重置为默认值\n    ret = matrix_led_reset_config();\n    TEST_ASSERT_EQUAL(ESP_OK, ret);\n    \n    TEST_ASSERT_EQUAL(MATRIX_LED_DEFAULT_BRIGHTNESS, matrix_led_get_brightness());\n    TEST_ASSERT_EQUAL(MATRIX_LED_MODE_STATIC, matrix_led_get_mode());\n    TEST_ASSERT_TRUE(matrix_led_is_enabled());\n    \n    // 加载之前保存的配置\n    ret = matrix_led_load_config();\n    TEST_ASSERT_EQUAL(ESP_OK, ret);\n    \n    TEST_ASSERT_EQUAL(75, matrix_led_get_brightness());\n    TEST_ASSERT_EQUAL(MATRIX_LED_MODE_ANIMATION, matrix_led_get_mode());\n    TEST_ASSERT_FALSE(matrix_led_is_enabled());\n    \n    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());\n}\n\n// ==================== 错误条件测试 ====================\n\nvoid test_matrix_led_error_conditions(void)\n{\n    ESP_LOGI(TAG, \"Testing matrix LED error conditions\");\n    \n    // 测试未初始化状态下的调用\n    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, matrix_led_set_pixel(0, 0, MATRIX_LED_COLOR_RED));\n    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, matrix_led_clear());\n    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, matrix_led_set_brightness(50));\n    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, matrix_led_set_mode(MATRIX_LED_MODE_STATIC));\n    TEST_ASSERT_FALSE(matrix_led_is_enabled());\n    TEST_ASSERT_EQUAL(0, matrix_led_get_brightness());\n    \n    // 初始化后测试边界条件\n    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());\n    \n    // 测试无效参数\n    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, matrix_led_set_pixels(NULL, 1));\n    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, matrix_led_color_interpolate(\n        MATRIX_LED_COLOR_RED, MATRIX_LED_COLOR_BLUE, 1.5f, NULL));\n    \n    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());\n}\n\n// ==================== 性能测试 ====================\n\nvoid test_matrix_led_performance(void)\n{\n    ESP_LOGI(TAG, \"Testing matrix LED performance\");\n    \n    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());\n    \n    // 测试大量像素设置的性能\n    TickType_t start_time = xTaskGetTickCount();\n    \n    matrix_led_color_t colors[] = {\n        {255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {255, 255, 0}\n    };\n    \n    for (int i = 0; i < 100; i++) {\n        for (uint8_t y = 0; y < MATRIX_LED_HEIGHT; y++) {\n            for (uint8_t x = 0; x < MATRIX_LED_WIDTH; x++) {\n                matrix_led_set_pixel(x, y, colors[i % 4]);\n            }\n        }\n        matrix_led_refresh();\n    }\n    \n    TickType_t end_time = xTaskGetTickCount();\n    uint32_t duration_ms = (end_time - start_time) * portTICK_PERIOD_MS;\n    \n    ESP_LOGI(TAG, \"Performance test completed in %lu ms\", duration_ms);\n    ESP_LOGI(TAG, \"Average frame time: %.2f ms\", duration_ms / 100.0f);\n    \n    // 性能不应该太差（每帧不超过100ms）\n    TEST_ASSERT_LESS_THAN(10000, duration_ms);  // 总时间不超过10秒\n    \n    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());\n}\n\n// ==================== 测试运行器 ====================\n\nvoid app_main(void)\n{\n    ESP_LOGI(TAG, \"Starting Matrix LED component tests\");\n    \n    UNITY_BEGIN();\n    \n    // 基础功能测试\n    RUN_TEST(test_matrix_led_init_deinit);\n    RUN_TEST(test_matrix_led_enable_disable);\n    RUN_TEST(test_matrix_led_status);\n    \n    // 像素控制测试\n    RUN_TEST(test_matrix_led_pixel_operations);\n    RUN_TEST(test_matrix_led_bulk_operations);\n    \n    // 亮度控制测试\n    RUN_TEST(test_matrix_led_brightness);\n    \n    // 图形绘制测试\n    RUN_TEST(test_matrix_led_drawing);\n    \n    // 模式和动画测试\n    RUN_TEST(test_matrix_led_modes);\n    RUN_TEST(test_matrix_led_animations);\n    \n    // 颜色工具测试\n    RUN_TEST(test_matrix_led_color_tools);\n    \n    // 特效测试\n    RUN_TEST(test_matrix_led_effects);\n    \n    // 配置管理测试\n    RUN_TEST(test_matrix_led_config);\n    \n    // 错误条件测试\n    RUN_TEST(test_matrix_led_error_conditions);\n    \n    // 性能测试\n    RUN_TEST(test_matrix_led_performance);\n    \n    UNITY_END();\n    \n    ESP_LOGI(TAG, \"All Matrix LED tests completed\");\n}
\ No newline at end of file
+    // 测试颜色插值
+    matrix_led_color_t color1 = {0, 0, 0};
+    matrix_led_color_t color2 = {255, 255, 255};
+    matrix_led_color_t result;
+    ret = matrix_led_color_interpolate(color1, color2, 0.5f, &result);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_UINT8_WITHIN(5, 127, result.r);
+    TEST_ASSERT_UINT8_WITHIN(5, 127, result.g);
+    TEST_ASSERT_UINT8_WITHIN(5, 127, result.b);
+    
+    // 测试亮度应用
+    matrix_led_color_t bright_color = {200, 150, 100};
+    ret = matrix_led_apply_brightness(bright_color, 50, &result);
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    TEST_ASSERT_EQUAL(100, result.r);
+    TEST_ASSERT_EQUAL(75, result.g);
+    TEST_ASSERT_EQUAL(50, result.b);
+    
+    // 测试空指针
+    ret = matrix_led_rgb_to_hsv(red, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+    
+    ret = matrix_led_hsv_to_rgb(blue_hsv, NULL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, ret);
+}
+
+// ==================== 特效测试 ====================
+
+void test_matrix_led_effects(void)
+{
+    ESP_LOGI(TAG, "Testing matrix LED effects");
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());
+    
+    // 测试测试图案
+    esp_err_t ret = matrix_led_show_test_pattern();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    
+    vTaskDelay(pdMS_TO_TICKS(200));  // 让效果显示一段时间
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+}
+
+// ==================== 配置管理测试 ====================
+
+void test_matrix_led_config(void)
+{
+    ESP_LOGI(TAG, "Testing matrix LED configuration management");
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());
+    
+    // 修改一些设置
+    matrix_led_set_brightness(75);
+    matrix_led_set_mode(MATRIX_LED_MODE_ANIMATION);
+    matrix_led_set_enable(false);
+    
+    // 保存配置
+    esp_err_t ret = matrix_led_save_config();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    
+    // 重置为默认值
+    ret = matrix_led_reset_config();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    
+    TEST_ASSERT_EQUAL(MATRIX_LED_DEFAULT_BRIGHTNESS, matrix_led_get_brightness());
+    TEST_ASSERT_EQUAL(MATRIX_LED_MODE_STATIC, matrix_led_get_mode());
+    TEST_ASSERT_TRUE(matrix_led_is_enabled());
+    
+    // 加载之前保存的配置
+    ret = matrix_led_load_config();
+    TEST_ASSERT_EQUAL(ESP_OK, ret);
+    
+    TEST_ASSERT_EQUAL(75, matrix_led_get_brightness());
+    TEST_ASSERT_EQUAL(MATRIX_LED_MODE_ANIMATION, matrix_led_get_mode());
+    TEST_ASSERT_FALSE(matrix_led_is_enabled());
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+}
+
+// ==================== 错误条件测试 ====================
+
+void test_matrix_led_error_conditions(void)
+{
+    ESP_LOGI(TAG, "Testing matrix LED error conditions");
+    
+    // 测试未初始化状态下的调用
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, matrix_led_set_pixel(0, 0, MATRIX_LED_COLOR_RED));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, matrix_led_clear());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, matrix_led_set_brightness(50));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, matrix_led_set_mode(MATRIX_LED_MODE_STATIC));
+    TEST_ASSERT_FALSE(matrix_led_is_enabled());
+    TEST_ASSERT_EQUAL(0, matrix_led_get_brightness());
+    
+    // 初始化后测试边界条件
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());
+    
+    // 测试无效参数
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, matrix_led_set_pixels(NULL, 1));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, matrix_led_color_interpolate(
+        MATRIX_LED_COLOR_RED, MATRIX_LED_COLOR_BLUE, 1.5f, NULL));
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+}
+
+// ==================== 性能测试 ====================
+
+void test_matrix_led_performance(void)
+{
+    ESP_LOGI(TAG, "Testing matrix LED performance");
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_init());
+    
+    // 测试大量像素设置的性能
+    TickType_t start_time = xTaskGetTickCount();
+    
+    matrix_led_color_t colors[] = {
+        {255, 0, 0}, {0, 255, 0}, {0, 0, 255}, {255, 255, 0}
+    };
+    
+    for (int i = 0; i < 100; i++) {
+        for (uint8_t y = 0; y < MATRIX_LED_HEIGHT; y++) {
+            for (uint8_t x = 0; x < MATRIX_LED_WIDTH; x++) {
+                matrix_led_set_pixel(x, y, colors[i % 4]);
+            }
+        }
+        matrix_led_refresh();
+    }
+    
+    TickType_t end_time = xTaskGetTickCount();
+    uint32_t duration_ms = (end_time - start_time) * portTICK_PERIOD_MS;
+    
+    ESP_LOGI(TAG, "Performance test completed in %lu ms", duration_ms);
+    ESP_LOGI(TAG, "Average frame time: %.2f ms", duration_ms / 100.0f);
+    
+    // 性能不应该太差（每帧不超过100ms）
+    TEST_ASSERT_LESS_THAN(10000, duration_ms);  // 总时间不超过10秒
+    
+    TEST_ASSERT_EQUAL(ESP_OK, matrix_led_deinit());
+}
+
+// ==================== 测试运行器 ====================
+
+void app_main(void)
+{
+    ESP_LOGI(TAG, "Starting Matrix LED component tests");
+    
+    UNITY_BEGIN();
+    
+    // 基础功能测试
+    RUN_TEST(test_matrix_led_init_deinit);
+    RUN_TEST(test_matrix_led_enable_disable);
+    RUN_TEST(test_matrix_led_status);
+    
+    // 像素控制测试
+    RUN_TEST(test_matrix_led_pixel_operations);
+    RUN_TEST(test_matrix_led_bulk_operations);
+    RUN_TEST(test_matrix_led_present);
+    RUN_TEST(test_matrix_led_dirty_tracking);
+    
+    // 亮度控制测试
+    RUN_TEST(test_matrix_led_brightness);
+    
+    // 图形绘制测试
+    RUN_TEST(test_matrix_led_drawing);
+    RUN_TEST(test_matrix_led_text);
+    RUN_TEST(test_matrix_led_layers);
+    
+    // 模式和动画测试
+    RUN_TEST(test_matrix_led_modes);
+    RUN_TEST(test_matrix_led_animations);
+    RUN_TEST(test_matrix_led_frame_scheduler);
+    RUN_TEST(test_matrix_led_anim_container);
+    RUN_TEST(test_matrix_led_memory_output);
+    
+    // 颜色工具测试
+    RUN_TEST(test_matrix_led_color_tools);
+    
+    // 特效测试
+    RUN_TEST(test_matrix_led_effects);
+    
+    // 配置管理测试
+    RUN_TEST(test_matrix_led_config);
+    
+    // 错误条件测试
+    RUN_TEST(test_matrix_led_error_conditions);
+    
+    // 性能测试
+    RUN_TEST(test_matrix_led_performance);
+    
+    UNITY_END();
+    
+    ESP_LOGI(TAG, "All Matrix LED tests completed");
+}
\ No newline at end of file
@@ -18,6 +18,7 @@
 #include "unity.h"
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 static const char *TAG = "power_monitor_test";
@@ -456,6 +457,240 @@ void test_power_monitor_state_validation(void) {
   TEST_ASSERT_FALSE(power_monitor_is_running());
 }
 
+/**
+ * @brief Test 13: Power chip frame decoder
+ */
+void test_power_monitor_frame_decoder(void) {
+  ESP_LOGI(TAG, "Testing power chip frame decoder");
+
+  // Noise, a valid frame, a frame with a bad checksum, a truncated frame
+  // and a valid frame whose payload contains header bytes
+  const uint8_t stream[] = {0x12, 0xFF, 0xFF, 0x18, 0x0A, 0x21,
+                            0xFF, 0x18, 0x0A, 0x00, 0xFF, 0x18,
+                            0xFF, 0xFF, 0xFF, 0xFD};
+  power_chip_sample_t samples[4];
+  power_chip_decoder_t decoder;
+  power_chip_decoder_init(&decoder, 9600, true);
+
+  size_t consumed = 0;
+  size_t count = power_chip_decoder_feed(&decoder, stream, sizeof(stream),
+                                         1000000, samples, 4, &consumed);
+  TEST_ASSERT_EQUAL(sizeof(stream), consumed);
+  TEST_ASSERT_EQUAL(2, count);
+
+  TEST_ASSERT_EQUAL_UINT8(0x18, samples[0].raw[1]);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 24.0f, samples[0].voltage);
+  TEST_ASSERT_FLOAT_WITHIN(0.01f, 1.0f, samples[0].current);
+  TEST_ASSERT_TRUE(samples[0].crc_valid);
+  TEST_ASSERT_EQUAL(0, samples[0].sequence);
+
+  // The last frame ends with the last byte of the chunk
+  TEST_ASSERT_EQUAL_UINT8(0xFF, samples[1].raw[1]);
+  TEST_ASSERT_EQUAL(1000000, samples[1].timestamp_us);
+  TEST_ASSERT_EQUAL(1000000 - 10 * (int64_t)decoder.byte_time_us,
+                    samples[0].timestamp_us);
+  TEST_ASSERT_EQUAL(1, decoder.stats.crc_errors);
+
+  // Without verification the bad frame is passed on, flagged
+  power_chip_decoder_init(&decoder, 9600, false);
+  count = power_chip_decoder_feed(&decoder, stream + 6, 4, 0, samples, 4,
+                                  NULL);
+  TEST_ASSERT_EQUAL(1, count);
+  TEST_ASSERT_FALSE(samples[0].crc_valid);
+}
+
+/**
+ * @brief Test 14: Supply waveform decimation and transient capture
+ */
+void test_power_monitor_waveform_capture(void) {
+  ESP_LOGI(TAG, "Testing supply waveform decimation and transient capture");
+
+  power_wave_config_t config = power_wave_get_default_config();
+  config.ratio = 4;
+  config.order = 1;
+  config.pre_trigger = 2;
+  config.post_trigger = 3;
+  config.dip_codes = 100.0f;
+  power_wave_t wave;
+  TEST_ASSERT_EQUAL(ESP_OK, power_wave_init(&wave, &config));
+
+  // 10 calm records, one record dipping by 500 codes, 10 calm records
+  uint16_t samples[84];
+  for (int i = 0; i < 84; i++) {
+    samples[i] = (i >= 40 && i < 44) ? 1500 : 2000;
+  }
+  TEST_ASSERT_EQUAL(1, power_wave_feed(&wave, samples, 84, 1000000));
+  TEST_ASSERT_EQUAL(21, wave.records);
+
+  power_wave_window_t window;
+  TEST_ASSERT_TRUE(power_wave_take_window(&wave, &window));
+  TEST_ASSERT_EQUAL(21, window.records);
+  TEST_ASSERT_EQUAL(1500, window.min);
+  TEST_ASSERT_EQUAL(2000, window.max);
+  TEST_ASSERT_FALSE(power_wave_take_window(&wave, &window));
+
+  power_wave_capture_info_t info;
+  power_wave_record_t records[6];
+  TEST_ASSERT_EQUAL(6, power_wave_copy_capture(&wave, &info, records, 6));
+  TEST_ASSERT_EQUAL(1, info.number);
+  TEST_ASSERT_EQUAL(POWER_WAVE_TRIGGER_DIP, info.trigger);
+  TEST_ASSERT_EQUAL(2, info.trigger_index);
+  TEST_ASSERT_EQUAL(1500, info.extreme);
+  TEST_ASSERT_EQUAL(200, info.record_period_us);
+  // The trigger record ends 40 samples (50 us each) before the last one
+  TEST_ASSERT_EQUAL(1000000 - 40 * 50, info.trigger_time_us);
+  TEST_ASSERT_EQUAL(2000 * 16, records[1].mean);
+  TEST_ASSERT_EQUAL(1500 * 16, records[2].mean);
+  TEST_ASSERT_EQUAL(1500, records[2].min);
+
+  // A ratio whose decimated sum overflows 32 bits is rejected
+  config.order = 3;
+  config.ratio = 128;
+  TEST_ASSERT_FALSE(power_wave_config_valid(&config));
+
+  power_wave_deinit(&wave);
+}
+
+/**
+ * @brief Test 15: Statistics engine (Welford, windows, quantiles, energy)
+ */
+void test_power_monitor_stats_engine(void) {
+  ESP_LOGI(TAG, "Testing statistics engine");
+
+  power_stats_engine_t *engine = malloc(sizeof(*engine));
+  TEST_ASSERT_NOT_NULL(engine);
+  power_stats_init(engine, 1000000);
+  power_stats_channel_summary_t summary;
+
+  // 1..100 every 10 ms
+  for (int i = 0; i < 100; i++) {
+    power_stats_add(engine, POWER_STATS_VOLTAGE, i + 1, i * 10000);
+  }
+  power_stats_summarize(engine, POWER_STATS_VOLTAGE, 990000, &summary);
+  TEST_ASSERT_EQUAL(100, summary.total.count);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 50.5f, summary.total.mean);
+  TEST_ASSERT_FLOAT_WITHIN(1e-3f, 29.0115f, summary.total.stddev);
+  TEST_ASSERT_EQUAL_FLOAT(1.0f, summary.total.min);
+  TEST_ASSERT_EQUAL_FLOAT(100.0f, summary.total.max);
+  TEST_ASSERT_EQUAL(100, summary.window[POWER_STATS_WINDOW_1S].count);
+
+  // Half a second later the 1 s window keeps its last four 100 ms buckets
+  power_stats_summarize(engine, POWER_STATS_VOLTAGE, 1500000, &summary);
+  TEST_ASSERT_EQUAL(40, summary.window[POWER_STATS_WINDOW_1S].count);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 80.5f,
+                           summary.window[POWER_STATS_WINDOW_1S].mean);
+  TEST_ASSERT_EQUAL(100, summary.window[POWER_STATS_WINDOW_1M].count);
+  TEST_ASSERT_EQUAL(100, summary.total.count);
+
+  // A permutation of 1..1000
+  for (int i = 0; i < 1000; i++) {
+    power_stats_add(engine, POWER_STATS_CURRENT, (i * 367) % 1000 + 1,
+                    i * 1000);
+  }
+  power_stats_summarize(engine, POWER_STATS_CURRENT, 1000000, &summary);
+  TEST_ASSERT_FLOAT_WITHIN(20.0f, 500.0f, summary.quantile[POWER_STATS_P50]);
+  TEST_ASSERT_FLOAT_WITHIN(20.0f, 950.0f, summary.quantile[POWER_STATS_P95]);
+  TEST_ASSERT_FLOAT_WITHIN(20.0f, 990.0f, summary.quantile[POWER_STATS_P99]);
+
+  // 10 W over uneven intervals, a gap longer than max_gap_us, then a step
+  // to 20 W integrated as a trapezoid: 10 W * 1.6 s + 15 W * 0.5 s
+  power_stats_add_power(engine, 10.0f, 0);
+  power_stats_add_power(engine, 10.0f, 500000);
+  power_stats_add_power(engine, 10.0f, 600000);
+  power_stats_add_power(engine, 10.0f, 1600000);
+  power_stats_add_power(engine, 10.0f, 3000000);
+  power_stats_add_power(engine, 20.0f, 3500000);
+  TEST_ASSERT_FLOAT_WITHIN(1e-4f, 23.5f, (float)(engine->energy_wh * 3600.0));
+  TEST_ASSERT_EQUAL(1, engine->energy_gaps);
+  TEST_ASSERT_EQUAL(1400000, engine->gap_us);
+
+  // No samples: summaries are NAN, not 0
+  power_stats_init(engine, 1000000);
+  power_stats_summarize(engine, POWER_STATS_POWER, 0, &summary);
+  TEST_ASSERT_EQUAL(0, summary.total.count);
+  TEST_ASSERT_TRUE(isnan(summary.total.mean));
+  TEST_ASSERT_TRUE(isnan(summary.quantile[POWER_STATS_P50]));
+
+  free(engine);
+}
+
+/**
+ * @brief Test 16: Telemetry log ring, block encoding and CRC
+ */
+void test_power_monitor_log_format(void) {
+  ESP_LOGI(TAG, "Testing telemetry log format");
+
+  const char *check = "123456789";
+  TEST_ASSERT_EQUAL(0xCBF43926,
+                    power_log_crc32(0, (const uint8_t *)check, strlen(check)));
+
+  // A full ring refuses the sample and flags the next one that fits
+  power_log_ring_t ring;
+  power_log_sample_t out[8];
+  TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, power_log_ring_init(&ring, 6));
+  TEST_ASSERT_EQUAL(ESP_OK, power_log_ring_init(&ring, 4));
+  for (int i = 0; i < 5; i++) {
+    power_log_sample_t sample = power_log_make_sample(i, 24.0f, 1.0f, 0);
+    TEST_ASSERT_EQUAL(i < 4, power_log_ring_push(&ring, &sample));
+  }
+  TEST_ASSERT_EQUAL(1, ring.dropped);
+  TEST_ASSERT_EQUAL(4, power_log_ring_pop(&ring, out, 8));
+  TEST_ASSERT_EQUAL(3, out[3].time_us);
+  power_log_sample_t next = power_log_make_sample(5, 24.0f, 1.0f, 0);
+  TEST_ASSERT_TRUE(power_log_ring_push(&ring, &next));
+  TEST_ASSERT_EQUAL(1, power_log_ring_pop(&ring, out, 8));
+  TEST_ASSERT_EQUAL(POWER_LOG_FLAG_DROPPED, out[0].flags);
+  TEST_ASSERT_EQUAL(0, power_log_ring_count(&ring));
+  power_log_ring_deinit(&ring);
+
+  // Millivolts and milliamps, rounded and clamped
+  power_log_sample_t sample = power_log_make_sample(0, 24.0004f, -0.5f, 0);
+  TEST_ASSERT_EQUAL(24000, sample.voltage_mv);
+  TEST_ASSERT_EQUAL(0, sample.current_ma);
+  sample = power_log_make_sample(0, 70.0f, 1.2346f, 0);
+  TEST_ASSERT_EQUAL(65535, sample.voltage_mv);
+  TEST_ASSERT_EQUAL(1235, sample.current_ma);
+
+  // A block rejects time steps beyond 24 bits and going backwards
+  uint8_t *block = malloc(POWER_LOG_BLOCK_SIZE);
+  TEST_ASSERT_NOT_NULL(block);
+  power_log_encoder_t encoder;
+  power_log_encoder_init(&encoder, block, 0x1234);
+  power_log_sample_t first = power_log_make_sample(1000, 24.0f, 2.0f, 0);
+  power_log_sample_t second =
+      power_log_make_sample(5167, 23.5f, 2.5f, POWER_LOG_FLAG_TRANSIENT);
+  power_log_sample_t late =
+      power_log_make_sample(5167 + POWER_LOG_MAX_DELTA_US + 1, 24.0f, 0, 0);
+  power_log_sample_t early = power_log_make_sample(0, 24.0f, 0, 0);
+  TEST_ASSERT_TRUE(power_log_encoder_add(&encoder, &first));
+  TEST_ASSERT_TRUE(power_log_encoder_add(&encoder, &second));
+  TEST_ASSERT_FALSE(power_log_encoder_add(&encoder, &late));
+  TEST_ASSERT_FALSE(power_log_encoder_add(&encoder, &early));
+  power_log_encoder_finish(&encoder, 3);
+  TEST_ASSERT_EQUAL(1, encoder.sequence);
+  TEST_ASSERT_EQUAL(0, encoder.count);
+
+  power_log_block_info_t info;
+  TEST_ASSERT_EQUAL(ESP_OK, power_log_block_parse(block, &info));
+  TEST_ASSERT_EQUAL(0x1234, info.session);
+  TEST_ASSERT_EQUAL(0, info.sequence);
+  TEST_ASSERT_EQUAL(2, info.count);
+  TEST_ASSERT_EQUAL(3, info.dropped);
+  TEST_ASSERT_EQUAL(2, power_log_block_decode(block, &info, out));
+  TEST_ASSERT_EQUAL(5167, out[1].time_us);
+  TEST_ASSERT_EQUAL(23500, out[1].voltage_mv);
+  TEST_ASSERT_EQUAL(2500, out[1].current_ma);
+  TEST_ASSERT_EQUAL(POWER_LOG_FLAG_TRANSIENT, out[1].flags);
+
+  // One flipped bit anywhere in the block is detected
+  block[POWER_LOG_BLOCK_SIZE - 1] ^= 0x01;
+  TEST_ASSERT_EQUAL(ESP_ERR_INVALID_CRC, power_log_block_parse(block, &info));
+  memset(block, 0, POWER_LOG_BLOCK_SIZE);
+  TEST_ASSERT_EQUAL(ESP_ERR_NOT_FOUND, power_log_block_parse(block, &info));
+
+  free(block);
+}
+
 /**
  * @brief Run all power monitor tests
  */
@@ -482,6 +717,10 @@ void app_main(void) {
   RUN_TEST(test_power_monitor_config_persistence);
   RUN_TEST(test_power_monitor_auto_start);
   RUN_TEST(test_power_monitor_state_validation);
+  RUN_TEST(test_power_monitor_frame_decoder);
+  RUN_TEST(test_power_monitor_waveform_capture);
+  RUN_TEST(test_power_monitor_stats_engine);
+  RUN_TEST(test_power_monitor_log_format);
 
   UNITY_END();
 